@@ -35,6 +35,7 @@
 // Includes
 //-----------------------------------------------------------------------------
 #include <stdio.h>
+#include <stdint.h>
 
 #ifdef __cplusplus
 extern "C"
@@ -120,6 +121,16 @@ void OICFreeAndSetToNull(void **ptr);
  */
 void OICFree(void *ptr);
 
+/**
+ * Number of successful OICMalloc, OICCalloc and OICRealloc calls so far.
+ *
+ * Tests compare it before and after an operation to count the allocations
+ * the operation made. The count wraps around on overflow.
+ *
+ * @return number of allocations.
+ */
+uint32_t OICGetAllocationCount(void);
+
 /**
  * Securely zero the contents of a memory buffer in a way that won't be
  * optimized out by the compiler. Do not use memset for this purpose, because
@@ -23,6 +23,7 @@
 //-----------------------------------------------------------------------------
 #include <stdlib.h>
 #include "oic_malloc.h"
+#include "ocatomic.h"
 
 #include "iotivity_config.h"
 
@@ -43,6 +44,7 @@
 //-----------------------------------------------------------------------------
 // Private variables
 //-----------------------------------------------------------------------------
+static volatile int32_t g_allocationCount = 0;
 
 //-----------------------------------------------------------------------------
 // Macros
@@ -70,17 +72,18 @@ void *OICMalloc(size_t size)
         return NULL;
     }
 
-#ifdef ENABLE_MALLOC_DEBUG
     void *ptr = malloc(size);
     if (ptr)
     {
+        oc_atomic_increment(&g_allocationCount);
+#ifdef ENABLE_MALLOC_DEBUG
         count++;
+#endif
     }
+#ifdef ENABLE_MALLOC_DEBUG
     OIC_LOG_V(INFO, TAG, "malloc: ptr=%p, size=%u, count=%u", ptr, size, count);
-    return ptr;
-#else
-    return malloc(size);
 #endif
+    return ptr;
 }
 
 void *OICCalloc(size_t num, size_t size)
@@ -90,17 +93,18 @@ void *OICCalloc(size_t num, size_t size)
         return NULL;
     }
 
-#ifdef ENABLE_MALLOC_DEBUG
     void *ptr = calloc(num, size);
     if (ptr)
     {
+        oc_atomic_increment(&g_allocationCount);
+#ifdef ENABLE_MALLOC_DEBUG
         count++;
+#endif
     }
+#ifdef ENABLE_MALLOC_DEBUG
     OIC_LOG_V(INFO, TAG, "calloc: ptr=%p, num=%u, size=%u, count=%u", ptr, num, size, count);
-    return ptr;
-#else
-    return calloc(num, size);
 #endif
+    return ptr;
 }
 
 void *OICRealloc(void* ptr, size_t size)
@@ -114,16 +118,17 @@ void *OICRealloc(void* ptr, size_t size)
     }
 
     // Otherwise leave the behavior up to realloc() itself:
-
-#ifdef ENABLE_MALLOC_DEBUG
     void* newptr = realloc(ptr, size);
+    if (newptr)
+    {
+        oc_atomic_increment(&g_allocationCount);
+    }
+#ifdef ENABLE_MALLOC_DEBUG
     OIC_LOG_V(INFO, TAG, "realloc: ptr=%p, newptr=%p, size=%u", ptr, newptr, size);
+#endif
     // Very important to return the correct pointer here, as it only *somtimes*
     // differs and thus can be hard to notice/test:
     return newptr;
-#else
-    return realloc(ptr, size);
-#endif
 }
 
 void OICFreeAndSetToNull(void **ptr)
@@ -150,6 +155,11 @@ void OICFree(void *ptr)
     free(ptr);
 }
 
+uint32_t OICGetAllocationCount(void)
+{
+    return (uint32_t)oc_atomic_add(&g_allocationCount, 0);
+}
+
 void OICClearMemory(void *buf, size_t n)
 {
     if (NULL != buf)
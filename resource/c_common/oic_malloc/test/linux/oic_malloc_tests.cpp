@@ -175,3 +175,22 @@ TEST(OICFreeAndSetToNull, FreeAndSetToNullPass2)
     OICFreeAndSetToNull((void**)&pBuffer);
     EXPECT_TRUE(NULL == pBuffer);
 }
+
+TEST(OICGetAllocationCount, CountsSuccessfulAllocations)
+{
+    uint32_t before = OICGetAllocationCount();
+
+    void *pMalloc = OICMalloc(1);
+    void *pCalloc = OICCalloc(1, 1);
+    pMalloc = OICRealloc(pMalloc, 2);
+    EXPECT_EQ(before + 3, OICGetAllocationCount());
+
+    // failed allocations are not counted
+    EXPECT_TRUE(NULL == OICMalloc(0));
+    EXPECT_TRUE(NULL == OICCalloc(0, 1));
+    EXPECT_EQ(before + 3, OICGetAllocationCount());
+
+    OICFree(pMalloc);
+    OICFree(pCalloc);
+    EXPECT_EQ(before + 3, OICGetAllocationCount());
+}
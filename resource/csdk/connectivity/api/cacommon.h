@@ -636,6 +636,7 @@ typedef struct
         bool ipv6enabled;           /**< IPv6 enabled by OCInit flags */
         bool ipv4enabled;           /**< IPv4 enabled by OCInit flags */
         bool dualstack;             /**< IPv6 and IPv4 enabled */
+        bool sendBatching;          /**< queued unicast datagrams are sent together */
 #if defined (_WIN32)
         LPFN_WSARECVMSG wsaRecvMsg; /**< Win32 function pointer to WSARecvMsg() */
 #endif
@@ -231,6 +231,20 @@ CATransportAdapter_t CAGetSelectedNetwork();
  */
 CAResult_t CAHandleRequestResponse();
 
+/**
+ * Wait until ::CAHandleRequestResponse has a received message to handle, the wait is
+ * cancelled with ::CACancelWaitRequestResponse, or the timeout elapsed.
+ * @param[in]   timeoutUs   longest wait in microseconds, 0 to return at once.
+ * @return   ::CA_STATUS_OK if a message is waiting, ::CA_STATUS_FAILED if none is,
+ *           or ::CA_STATUS_NOT_INITIALIZED
+ */
+CAResult_t CAWaitRequestResponse(uint64_t timeoutUs);
+
+/**
+ * Make the current or next ::CAWaitRequestResponse call return at once.
+ */
+void CACancelWaitRequestResponse();
+
 #ifdef RA_ADAPTER
 /**
  * Set Remote Access information for XMPP Client.
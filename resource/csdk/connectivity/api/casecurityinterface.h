@@ -291,6 +291,13 @@ CAResult_t CAcloseSslConnection(const CAEndpoint_t *endpoint);
  */
 void CAcloseSslConnectionAll(CATransportAdapter_t transportType);
 
+/**
+ * Forget the sessions kept for resumption, in both roles, so that the next handshake with
+ * any peer is a full one. To be called when credentials, trust anchors or the CRL change.
+ * Established sessions are not closed.
+ */
+void CAflushSslSessionCache(void);
+
 #ifdef __cplusplus
 } /* extern "C" */
 #endif
@@ -124,6 +124,15 @@ CAResult_t CAUnsetAutoConnectionDeviceInfo(const char* address);
 CAResult_t CASetPortNumberToAssign(CATransportAdapter_t adapter,
                                    CATransportFlags_t flag, uint16_t port);
 
+/**
+ * Set whether the IP adapter sends the unicast datagrams waiting in its send
+ * queue together, with one system call per socket where the platform allows
+ * it (sendmmsg() on Linux). This lowers the cost of notifying many observers.
+ * Secured and multicast datagrams are always sent one by one.
+ * @param[in]   enable      true to batch unicast sends, false to send them one by one.
+ */
+void CAUtilSetIPSendBatching(bool enable);
+
 /**
  * Get the assigned port number currently.
  * @param[in]   adapter     Transport adapter information.
@@ -34,6 +34,17 @@ extern "C"
 {
 #endif
 
+/**
+ * Creates the pool that remote endpoints are taken from and given back to.
+ * Until it is created, endpoints are allocated with OICMalloc.
+ */
+void CAInitializeEndpointPool(void);
+
+/**
+ * Frees the endpoints kept in the pool. The pool itself stays usable.
+ */
+void CATerminateEndpointPool(void);
+
 /**
  * Creates a new remote endpoint from the input endpoint.
  * @param[in]   endpoint           endpoint information where the data has to be sent.
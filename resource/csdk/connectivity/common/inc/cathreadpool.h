@@ -52,9 +52,31 @@ typedef struct ca_thread_pool
     struct ca_thread_pool_details_t* details;
 }*ca_thread_pool_t;
 
+/**
+ * Thread pool statistics.
+ */
+typedef struct ca_thread_pool_stats
+{
+    size_t workers;             /**< Number of worker threads started so far. */
+    size_t busy_workers;        /**< Number of workers running a task. */
+    size_t queue_depth;         /**< Number of tasks waiting for a worker. */
+    size_t dedicated_threads;   /**< Number of long-running tasks on their own thread. */
+    size_t max_queue_depth;     /**< Highest queue_depth seen. */
+    uint64_t tasks_completed;   /**< Number of tasks, long-running ones too, which returned. */
+    uint64_t tasks_stolen;      /**< Completed tasks taken from the queue of another worker. */
+    uint64_t total_wait_us;     /**< Sum of the queueing latency of completed tasks, in us. */
+    uint64_t max_wait_us;       /**< Highest queueing latency of a completed task, in us. */
+} ca_thread_pool_stats_t;
+
 /**
  * This function creates a newly allocated thread pool.
  *
+ * Worker threads are started on demand, up to num_of_threads.  Each worker has its own
+ * task queue and idle workers steal tasks queued on busy workers.  The workers are meant
+ * for short tasks only: a task which loops or blocks for a long time (e.g. a receive
+ * loop) must be added with ca_thread_pool_add_long_running_task() instead, otherwise it
+ * holds its worker and the queued tasks may never run.
+ *
  * @param num_of_threads The number of worker thread used in this pool.
  * @param thread_pool_handle Handle to newly create thread pool.
  * @return Error code, CA_STATUS_OK if success, else error number.
@@ -63,6 +85,7 @@ CAResult_t ca_thread_pool_init(int32_t num_of_threads, ca_thread_pool_t *thread_
 
 /**
  * This function adds a routine to be executed by the thread pool at some future time.
+ * The routine runs on one of the bounded workers and must not loop or block for long.
  *
  * @param thread_pool The thread pool structure.
  * @param method The routine to be executed.
@@ -74,9 +97,37 @@ CAResult_t ca_thread_pool_init(int32_t num_of_threads, ca_thread_pool_t *thread_
 CAResult_t ca_thread_pool_add_task(ca_thread_pool_t thread_pool, ca_thread_func method,
                     void *data);
 
+/**
+ * This function runs a long-running routine, e.g. a receive or queueing loop, on its own
+ * thread.  The thread is joined once the routine returned, at the latest by
+ * ca_thread_pool_free(), so the routine must be told to return before the pool is freed.
+ *
+ * @param thread_pool The thread pool structure.
+ * @param method The routine to be executed.
+ * @param data The data to be passed to the routine.
+ *
+ * @return CA_STATUS_OK on success.
+ * @return Error on failure.
+ */
+CAResult_t ca_thread_pool_add_long_running_task(ca_thread_pool_t thread_pool,
+                                                ca_thread_func method, void *data);
+
+/**
+ * This function gets a snapshot of the statistics of the thread pool.
+ *
+ * @param thread_pool The thread pool structure.
+ * @param stats The statistics of the thread pool.
+ *
+ * @return CA_STATUS_OK on success.
+ * @return Error on failure.
+ */
+CAResult_t ca_thread_pool_get_stats(ca_thread_pool_t thread_pool, ca_thread_pool_stats_t *stats);
+
 /**
  * This function stops all the worker threads (stop & exit). And frees all the allocated memory.
  * Function will return only after joining all threads executing the currently scheduled tasks.
+ * Tasks which are still queued are run before the workers exit, and the threads of the
+ * long-running tasks are joined.
  *
  * @param thread_pool The thread pool structure.
  */
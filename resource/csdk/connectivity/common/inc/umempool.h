@@ -0,0 +1,113 @@
+/* ****************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************/
+
+/**
+ * @file
+ *
+ * This file contains the APIs for a cache of fixed-size memory blocks.
+ *
+ * Freed blocks are kept for the next allocation instead of going back to the
+ * heap. Every block is an ordinary OICMalloc block of the pool's block size,
+ * so a block taken from the pool may still be released with OICFree, and any
+ * OICMalloc block of that size may be given to the pool.
+ */
+
+#ifndef U_MEM_POOL_H_
+#define U_MEM_POOL_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "octhread.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif /* __cplusplus */
+
+/**
+ * Pool structure.
+ */
+typedef struct u_mem_pool_t
+{
+    /** Size of every block. */
+    size_t blockSize;
+    /** Most blocks kept in the pool. */
+    uint32_t capacity;
+    /** Number of blocks kept in the pool. */
+    uint32_t count;
+    /** Blocks kept in the pool. */
+    void **blocks;
+    /** Protects count and blocks. */
+    oc_mutex mutex;
+} u_mem_pool_t;
+
+/**
+ * API to create pool.
+ * @param blockSize size of every block.
+ * @param capacity most blocks kept in the pool.
+ * @return  u_mem_pool_t pointer if Success, NULL otherwise.
+ */
+u_mem_pool_t *u_mem_pool_create(size_t blockSize, uint32_t capacity);
+
+/**
+ * Deletes the pool and the blocks kept in it.
+ * @param pool pointer to pool.
+ */
+void u_mem_pool_delete(u_mem_pool_t *pool);
+
+/**
+ * Frees the blocks kept in the pool. The pool stays usable.
+ * @param pool pointer to pool.
+ */
+void u_mem_pool_trim(u_mem_pool_t *pool);
+
+/**
+ * Takes a block from the pool, or allocates one if the pool is empty.
+ * @param pool pointer to pool.
+ * @return uninitialized block of the pool's block size, NULL on failure.
+ */
+void *u_mem_pool_alloc(u_mem_pool_t *pool);
+
+/**
+ * Same as u_mem_pool_alloc, but the block is zeroed.
+ * @param pool pointer to pool.
+ * @return zeroed block of the pool's block size, NULL on failure.
+ */
+void *u_mem_pool_calloc(u_mem_pool_t *pool);
+
+/**
+ * Gives a block back to the pool, or frees it if the pool is full.
+ * @param pool pointer to pool.
+ * @param block block of the pool's block size. NULL is ignored.
+ */
+void u_mem_pool_free(u_mem_pool_t *pool, void *block);
+
+/**
+ * @param pool pointer to pool.
+ * @return number of blocks kept in the pool.
+ */
+uint32_t u_mem_pool_get_count(u_mem_pool_t *pool);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif /* __cplusplus */
+
+#endif /* U_MEM_POOL_H_ */
@@ -0,0 +1,117 @@
+/* ****************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************/
+
+/**
+ * @file
+ *
+ * This file contains the APIs for a bounded lock-free queue with many
+ * producers and a single consumer.
+ *
+ * Messages are stored in a ring of preallocated cells, so adding a message
+ * does not allocate. Every cell carries a sequence number telling whether it
+ * is free for the producer claiming that position or ready for the consumer.
+ */
+
+#ifndef U_MPSC_QUEUE_H_
+#define U_MPSC_QUEUE_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "uqueue.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif /* __cplusplus */
+
+/**
+ * Queue cell format.
+ */
+typedef struct u_mpsc_queue_cell_t
+{
+    /** Position the cell is ready for, see umpscqueue.c. */
+    volatile int32_t sequence;
+    /** message stored in the cell. */
+    u_queue_message_t message;
+} u_mpsc_queue_cell_t;
+
+/**
+ * Queue structure.
+ */
+typedef struct u_mpsc_queue_t
+{
+    /** Ring of cells. */
+    u_mpsc_queue_cell_t *cells;
+    /** Number of cells minus one; the number of cells is a power of two. */
+    uint32_t mask;
+    /** Next position claimed by a producer. */
+    volatile int32_t enqueuePos;
+    /** Next position read by the consumer. Only the consumer changes it. */
+    volatile int32_t dequeuePos;
+} u_mpsc_queue_t;
+
+/**
+ * API to create queue and initializes the cells.
+ * @param capacity maximum number of messages, rounded up to a power of two.
+ * @return  u_mpsc_queue_t pointer if Success, NULL otherwise.
+ */
+u_mpsc_queue_t *u_mpsc_queue_create(uint32_t capacity);
+
+/**
+ * Deletes the queue. Messages still queued are not freed.
+ * @param queue pointer to queue.
+ */
+void u_mpsc_queue_delete(u_mpsc_queue_t *queue);
+
+/**
+ * Adds message at the end of the queue. Any thread may call it.
+ * @param queue pointer to queue.
+ * @param msg pointer to message.
+ * @param size message size.
+ * @return true if added, false if the queue is full.
+ */
+bool u_mpsc_queue_push(u_mpsc_queue_t *queue, void *msg, uint32_t size);
+
+/**
+ * Removes the first message of the queue. Only the consumer may call it.
+ * @param queue pointer to queue.
+ * @param message first message of the queue.
+ * @return true if a message was removed, false if the queue is empty.
+ */
+bool u_mpsc_queue_pop(u_mpsc_queue_t *queue, u_queue_message_t *message);
+
+/**
+ * @param queue pointer to queue.
+ * @return number of elements in queue. Producers still writing their message are counted.
+ */
+uint32_t u_mpsc_queue_get_size(u_mpsc_queue_t *queue);
+
+/**
+ * @param queue pointer to queue.
+ * @return maximum number of elements in queue.
+ */
+uint32_t u_mpsc_queue_get_capacity(const u_mpsc_queue_t *queue);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif /* __cplusplus */
+
+#endif /* U_MPSC_QUEUE_H_ */
@@ -23,10 +23,36 @@
 #include "oic_malloc.h"
 #include "oic_string.h"
 #include "caremotehandler.h"
+#include "umempool.h"
 #include "experimental/logger.h"
 
 #define TAG "OIC_CA_REMOTE_HANDLER"
 
+/**
+ * Most freed endpoints kept for reuse.
+ */
+#define ENDPOINT_POOL_CAPACITY 64
+
+/**
+ * Endpoints cloned for every message come from here once the message handler
+ * is initialized. It is never deleted, so endpoints freed by other threads
+ * after termination are still safe to give back.
+ */
+static u_mem_pool_t *g_endpointPool = NULL;
+
+void CAInitializeEndpointPool(void)
+{
+    if (NULL == g_endpointPool)
+    {
+        g_endpointPool = u_mem_pool_create(sizeof(CAEndpoint_t), ENDPOINT_POOL_CAPACITY);
+    }
+}
+
+void CATerminateEndpointPool(void)
+{
+    u_mem_pool_trim(g_endpointPool);
+}
+
 CAEndpoint_t *CACloneEndpoint(const CAEndpoint_t *rep)
 {
     if (NULL == rep)
@@ -36,7 +62,8 @@ CAEndpoint_t *CACloneEndpoint(const CAEndpoint_t *rep)
     }
 
     // allocate the remote end point structure.
-    CAEndpoint_t *clone = (CAEndpoint_t *)OICMalloc(sizeof (CAEndpoint_t));
+    CAEndpoint_t *clone = g_endpointPool ? (CAEndpoint_t *)u_mem_pool_alloc(g_endpointPool)
+                                         : (CAEndpoint_t *)OICMalloc(sizeof (CAEndpoint_t));
     if (NULL == clone)
     {
         OIC_LOG(ERROR, TAG, "CACloneRemoteEndpoint Out of memory");
@@ -156,7 +183,8 @@ CAEndpoint_t *CACreateEndpointObject(CATransportFlags_t flags,
                                      const char *address,
                                      uint16_t port)
 {
-    CAEndpoint_t *info = (CAEndpoint_t *)OICCalloc(1, sizeof(CAEndpoint_t));
+    CAEndpoint_t *info = g_endpointPool ? (CAEndpoint_t *)u_mem_pool_calloc(g_endpointPool)
+                                        : (CAEndpoint_t *)OICCalloc(1, sizeof(CAEndpoint_t));
     if (NULL == info)
     {
         OIC_LOG(ERROR, TAG, "Memory allocation failed !");
@@ -177,7 +205,7 @@ CAEndpoint_t *CACreateEndpointObject(CATransportFlags_t flags,
 
 void CAFreeEndpoint(CAEndpoint_t *rep)
 {
-    OICFree(rep);
+    u_mem_pool_free(g_endpointPool, rep);
 }
 
 static void CADestroyInfoInternal(CAInfo_t *info)
@@ -35,51 +35,255 @@
 #include "cathreadpool.h"
 #include "experimental/logger.h"
 #include "oic_malloc.h"
-#include "uarraylist.h"
 #include "octhread.h"
+#include "oic_time.h"
 #include "platform_features.h"
 
 #define TAG PCF("OIC_CA_UTHREADPOOL")
 
 /**
- * empty struct to represent the details.  This implementation has no data
- * that it needs to keep track of, so it only uses NULL for the internal value.
+ * A task waiting in the queue of a worker.
+ */
+typedef struct ca_thread_pool_task_t
+{
+    ca_thread_func func;
+    void *data;
+    uint64_t enqueue_time;                  /**< Time the task was added in microseconds. */
+    struct ca_thread_pool_task_t *next;
+} ca_thread_pool_task_t;
+
+/**
+ * A worker thread and its task queue.  The owner takes tasks from the head of its queue,
+ * idle workers steal from the head of the other queues.
+ */
+typedef struct ca_thread_pool_worker_t
+{
+    oc_thread thread;
+    oc_mutex queue_lock;
+    ca_thread_pool_task_t *head;
+    ca_thread_pool_task_t *tail;
+    size_t index;
+    struct ca_thread_pool_details_t *pool;
+} ca_thread_pool_worker_t;
+
+/**
+ * A thread which runs one long-running task outside of the workers.
+ */
+typedef struct ca_thread_pool_dedicated_t
+{
+    oc_thread thread;
+    ca_thread_func func;
+    void *data;
+    bool done;                              /**< Set by the thread once func returned. */
+    struct ca_thread_pool_details_t *pool;
+    struct ca_thread_pool_dedicated_t *next;
+} ca_thread_pool_dedicated_t;
+
+/**
+ * Details of the pool.  Workers are started on demand, up to max_workers, when a task is
+ * added and no worker is idle.  Long-running tasks get a dedicated thread each, so they
+ * never hold a worker.
  */
 typedef struct ca_thread_pool_details_t
 {
-    u_arraylist_t* threads_list;
-    oc_mutex list_lock;
+    oc_mutex lock;                          /**< Protects everything below. */
+    oc_cond cond;                           /**< Signalled when a task is added or on stop. */
+    ca_thread_pool_worker_t *workers;
+    size_t max_workers;
+    size_t started_workers;
+    size_t idle_workers;
+    size_t next_worker;                     /**< Round robin target of ca_thread_pool_add_task. */
+    ca_thread_pool_dedicated_t *dedicated;  /**< Threads of ca_thread_pool_add_long_running_task. */
+    bool stop;
+    ca_thread_pool_stats_t stats;
 } ca_thread_pool_details_t;
 
+static ca_thread_pool_task_t *ca_thread_pool_pop_task(ca_thread_pool_worker_t *worker)
+{
+    oc_mutex_lock(worker->queue_lock);
+    ca_thread_pool_task_t *task = worker->head;
+    if (task)
+    {
+        worker->head = task->next;
+        if (!worker->head)
+        {
+            worker->tail = NULL;
+        }
+    }
+    oc_mutex_unlock(worker->queue_lock);
+    return task;
+}
+
+static void ca_thread_pool_push_task(ca_thread_pool_worker_t *worker, ca_thread_pool_task_t *task)
+{
+    task->next = NULL;
+    oc_mutex_lock(worker->queue_lock);
+    if (worker->tail)
+    {
+        worker->tail->next = task;
+    }
+    else
+    {
+        worker->head = task;
+    }
+    worker->tail = task;
+    oc_mutex_unlock(worker->queue_lock);
+}
+
 /**
- * struct to wrap the pthreads callback properly.  The function pointer for
- * pthreads requires a void* return value, however u_thread_func is a void.
+ * Take the next task for the worker: from its own queue first, else steal one from
+ * the queue of another worker.
  */
-typedef struct ca_thread_pool_callback_info_t
+static ca_thread_pool_task_t *ca_thread_pool_next_task(ca_thread_pool_worker_t *worker,
+                                                       bool *stolen)
 {
-    ca_thread_func func;
-    void* data;
-} ca_thread_pool_callback_info_t;
+    ca_thread_pool_details_t *pool = worker->pool;
 
-typedef struct ca_thread_pool_thread_info_t
+    *stolen = false;
+    ca_thread_pool_task_t *task = ca_thread_pool_pop_task(worker);
+    for (size_t i = 1; !task && i < pool->max_workers; ++i)
+    {
+        ca_thread_pool_worker_t *victim = &pool->workers[(worker->index + i) % pool->max_workers];
+        task = ca_thread_pool_pop_task(victim);
+        *stolen = (NULL != task);
+    }
+    return task;
+}
+
+static void *ca_thread_pool_worker_routine(void *data)
 {
-    oc_thread thread;
-} ca_thread_pool_thread_info_t;
+    ca_thread_pool_worker_t *worker = (ca_thread_pool_worker_t *)data;
+    ca_thread_pool_details_t *pool = worker->pool;
+
+    oc_mutex_lock(pool->lock);
+    while (true)
+    {
+        if (0 == pool->stats.queue_depth)
+        {
+            if (pool->stop)
+            {
+                break;
+            }
+            pool->idle_workers++;
+            oc_cond_wait(pool->cond, pool->lock);
+            pool->idle_workers--;
+            continue;
+        }
+
+        // Claim one of the queued tasks.  Every claim matches a task in some queue, so the
+        // search below always ends even when other workers pop from the same queues.
+        pool->stats.queue_depth--;
+        pool->stats.busy_workers++;
+        oc_mutex_unlock(pool->lock);
 
-// passthrough function to convert the pthreads call to a u_thread_func call
-void* ca_thread_pool_pthreads_delegate(void* data)
+        bool stolen = false;
+        ca_thread_pool_task_t *task = NULL;
+        while (!task)
+        {
+            task = ca_thread_pool_next_task(worker, &stolen);
+        }
+
+        uint64_t wait_time = OICGetCurrentTime(TIME_IN_US) - task->enqueue_time;
+        task->func(task->data);
+        OICFree(task);
+
+        oc_mutex_lock(pool->lock);
+        pool->stats.busy_workers--;
+        pool->stats.tasks_completed++;
+        pool->stats.total_wait_us += wait_time;
+        if (wait_time > pool->stats.max_wait_us)
+        {
+            pool->stats.max_wait_us = wait_time;
+        }
+        if (stolen)
+        {
+            pool->stats.tasks_stolen++;
+        }
+    }
+    oc_mutex_unlock(pool->lock);
+
+    return NULL;
+}
+
+static void *ca_thread_pool_dedicated_routine(void *data)
 {
-    ca_thread_pool_callback_info_t* info = (ca_thread_pool_callback_info_t*)data;
-    info->func(info->data);
-    OICFree(info);
+    ca_thread_pool_dedicated_t *dedicated = (ca_thread_pool_dedicated_t *)data;
+    ca_thread_pool_details_t *pool = dedicated->pool;
+
+    dedicated->func(dedicated->data);
+
+    oc_mutex_lock(pool->lock);
+    dedicated->done = true;
+    pool->stats.dedicated_threads--;
+    pool->stats.tasks_completed++;
+    oc_mutex_unlock(pool->lock);
+
     return NULL;
 }
 
-// this implementation doesn't do a thread pool, so this function is essentially
-// a no-op besides creating a valid ca_thread_pool_t object.  It was determined after
-// reading through the existing implementation that the thread-pooling was unnecessary
-// for the posix platforms.  Behavior shouldn't be changed since previously num_of_threads
-// was greater than the number of requested threads.
+/**
+ * Join and free the given list of dedicated threads.  Must be called without the pool lock.
+ */
+static void ca_thread_pool_join_dedicated(ca_thread_pool_dedicated_t *list)
+{
+    while (list)
+    {
+        ca_thread_pool_dedicated_t *next = list->next;
+        oc_thread_wait(list->thread);
+        oc_thread_free(list->thread);
+        OICFree(list);
+        list = next;
+    }
+}
+
+/**
+ * Unlink the dedicated threads whose task has returned.  Must be called with the pool lock.
+ */
+static ca_thread_pool_dedicated_t *ca_thread_pool_take_finished(ca_thread_pool_details_t *pool)
+{
+    ca_thread_pool_dedicated_t *finished = NULL;
+    ca_thread_pool_dedicated_t **link = &pool->dedicated;
+    while (*link)
+    {
+        ca_thread_pool_dedicated_t *dedicated = *link;
+        if (dedicated->done)
+        {
+            *link = dedicated->next;
+            dedicated->next = finished;
+            finished = dedicated;
+        }
+        else
+        {
+            link = &dedicated->next;
+        }
+    }
+    return finished;
+}
+
+static void ca_thread_pool_free_details(ca_thread_pool_details_t *details)
+{
+    if (details->workers)
+    {
+        for (size_t i = 0; i < details->max_workers; ++i)
+        {
+            if (details->workers[i].queue_lock)
+            {
+                oc_mutex_free(details->workers[i].queue_lock);
+            }
+        }
+        OICFree(details->workers);
+    }
+    if (details->cond)
+    {
+        oc_cond_free(details->cond);
+    }
+    if (details->lock)
+    {
+        oc_mutex_free(details->lock);
+    }
+    OICFree(details);
+}
+
 CAResult_t ca_thread_pool_init(int32_t num_of_threads, ca_thread_pool_t *thread_pool)
 {
     OIC_LOG(DEBUG, TAG, "IN");
@@ -104,40 +308,49 @@ CAResult_t ca_thread_pool_init(int32_t num_of_threads, ca_thread_pool_t *thread_
         return CA_MEMORY_ALLOC_FAILED;
     }
 
-    (*thread_pool)->details = OICMalloc(sizeof(struct ca_thread_pool_details_t));
-    if(!(*thread_pool)->details)
+    ca_thread_pool_details_t *details = OICCalloc(1, sizeof(ca_thread_pool_details_t));
+    if(!details)
     {
         OIC_LOG(ERROR, TAG, "Failed to allocate for thread-pool details");
         OICFree(*thread_pool);
         *thread_pool=NULL;
         return CA_MEMORY_ALLOC_FAILED;
     }
+    (*thread_pool)->details = details;
+    details->max_workers = (size_t)num_of_threads;
 
-    (*thread_pool)->details->list_lock = oc_mutex_new();
-
-    if(!(*thread_pool)->details->list_lock)
+    details->lock = oc_mutex_new();
+    details->cond = oc_cond_new();
+    if(!details->lock || !details->cond)
     {
         OIC_LOG(ERROR, TAG, "Failed to create thread-pool mutex");
         goto exit;
     }
 
-    (*thread_pool)->details->threads_list = u_arraylist_create();
+    details->workers = OICCalloc(details->max_workers, sizeof(ca_thread_pool_worker_t));
+    if(!details->workers)
+    {
+        OIC_LOG(ERROR, TAG, "Failed to create thread-pool workers");
+        goto exit;
+    }
 
-    if(!(*thread_pool)->details->threads_list)
+    for (size_t i = 0; i < details->max_workers; ++i)
     {
-        OIC_LOG(ERROR, TAG, "Failed to create thread-pool list");
-        if(!oc_mutex_free((*thread_pool)->details->list_lock))
+        details->workers[i].index = i;
+        details->workers[i].pool = details;
+        details->workers[i].queue_lock = oc_mutex_new();
+        if (!details->workers[i].queue_lock)
         {
-            OIC_LOG(ERROR, TAG, "Failed to free thread-pool mutex");
+            OIC_LOG(ERROR, TAG, "Failed to create thread-pool queue mutex");
+            goto exit;
         }
-        goto exit;
     }
 
     OIC_LOG(DEBUG, TAG, "OUT");
     return CA_STATUS_OK;
 
 exit:
-    OICFree((*thread_pool)->details);
+    ca_thread_pool_free_details(details);
     OICFree(*thread_pool);
     *thread_pool = NULL;
     return CA_STATUS_FAILED;
@@ -154,56 +367,146 @@ CAResult_t ca_thread_pool_add_task(ca_thread_pool_t thread_pool, ca_thread_func
         return CA_STATUS_INVALID_PARAM;
     }
 
-    ca_thread_pool_callback_info_t* info = OICMalloc(sizeof(ca_thread_pool_callback_info_t));
-    if(!info)
+    ca_thread_pool_task_t *task = OICMalloc(sizeof(ca_thread_pool_task_t));
+    if(!task)
     {
         OIC_LOG(ERROR, TAG, "Failed to allocate for memory wrapper");
         return CA_MEMORY_ALLOC_FAILED;
     }
 
-    info->func = method;
-    info->data = data;
+    task->func = method;
+    task->data = data;
+    task->enqueue_time = OICGetCurrentTime(TIME_IN_US);
 
-    ca_thread_pool_thread_info_t *threadInfo =
-            (ca_thread_pool_thread_info_t *) OICCalloc(1, sizeof(ca_thread_pool_thread_info_t));
-    if (!threadInfo)
+    ca_thread_pool_details_t *pool = thread_pool->details;
+    oc_mutex_lock(pool->lock);
+    if (pool->stop)
     {
-        OIC_LOG(ERROR, TAG, "Memory allocation failed");
-        OICFree(info);
+        oc_mutex_unlock(pool->lock);
+        OIC_LOG(ERROR, TAG, "Thread pool is stopping");
+        OICFree(task);
         return CA_STATUS_FAILED;
     }
 
-    oc_mutex_lock(thread_pool->details->list_lock);
-    bool addResult = u_arraylist_add(thread_pool->details->threads_list, (void*) threadInfo);
-    if (!addResult)
+    // Start another worker unless enough idle workers are left for the queued tasks.
+    if (pool->idle_workers <= pool->stats.queue_depth &&
+        pool->started_workers < pool->max_workers)
     {
-        // Note that this is considered non-fatal.
-        oc_mutex_unlock(thread_pool->details->list_lock);
-        OIC_LOG(ERROR, TAG, "Arraylist add failed");
-        OICFree(info);
-        OICFree(threadInfo);
+        ca_thread_pool_worker_t *worker = &pool->workers[pool->started_workers];
+        OCThreadResult_t thrRet = oc_thread_new(&worker->thread, ca_thread_pool_worker_routine,
+                                                worker);
+        if (OC_THREAD_SUCCESS == thrRet)
+        {
+            pool->started_workers++;
+        }
+        else if (0 == pool->started_workers)
+        {
+            oc_mutex_unlock(pool->lock);
+            OIC_LOG_V(ERROR, TAG, "Thread start failed with error %d", thrRet);
+            OICFree(task);
+            return CA_STATUS_FAILED;
+        }
+        else
+        {
+            // Note that this is considered non-fatal, the running workers take the task.
+            OIC_LOG_V(ERROR, TAG, "Thread start failed with error %d", thrRet);
+        }
+    }
+    else if (pool->idle_workers <= pool->stats.queue_depth)
+    {
+        OIC_LOG_V(DEBUG, TAG, "All %u workers busy, task queued",
+                  (unsigned int)pool->max_workers);
+    }
+
+    ca_thread_pool_worker_t *worker = &pool->workers[pool->next_worker];
+    pool->next_worker = (pool->next_worker + 1) % pool->started_workers;
+    pool->stats.queue_depth++;
+    if (pool->stats.queue_depth > pool->stats.max_queue_depth)
+    {
+        pool->stats.max_queue_depth = pool->stats.queue_depth;
+    }
+    ca_thread_pool_push_task(worker, task);
+    oc_cond_signal(pool->cond);
+    oc_mutex_unlock(pool->lock);
+
+    OIC_LOG(DEBUG, TAG, "OUT");
+    return CA_STATUS_OK;
+}
+
+CAResult_t ca_thread_pool_add_long_running_task(ca_thread_pool_t thread_pool,
+                                                ca_thread_func method, void *data)
+{
+    OIC_LOG(DEBUG, TAG, "IN");
+
+    if(NULL == thread_pool || NULL == method)
+    {
+        OIC_LOG(ERROR, TAG, "thread_pool or method was NULL");
+        return CA_STATUS_INVALID_PARAM;
+    }
+
+    ca_thread_pool_dedicated_t *dedicated = OICCalloc(1, sizeof(ca_thread_pool_dedicated_t));
+    if(!dedicated)
+    {
+        OIC_LOG(ERROR, TAG, "Failed to allocate for dedicated thread");
+        return CA_MEMORY_ALLOC_FAILED;
+    }
+
+    dedicated->func = method;
+    dedicated->data = data;
+
+    ca_thread_pool_details_t *pool = thread_pool->details;
+    dedicated->pool = pool;
+
+    oc_mutex_lock(pool->lock);
+    if (pool->stop)
+    {
+        oc_mutex_unlock(pool->lock);
+        OIC_LOG(ERROR, TAG, "Thread pool is stopping");
+        OICFree(dedicated);
         return CA_STATUS_FAILED;
     }
 
-    int thrRet = oc_thread_new(&threadInfo->thread, ca_thread_pool_pthreads_delegate, info);
-    if (thrRet != 0)
+    ca_thread_pool_dedicated_t *finished = ca_thread_pool_take_finished(pool);
+
+    OCThreadResult_t thrRet = oc_thread_new(&dedicated->thread, ca_thread_pool_dedicated_routine,
+                                            dedicated);
+    if (OC_THREAD_SUCCESS == thrRet)
+    {
+        dedicated->next = pool->dedicated;
+        pool->dedicated = dedicated;
+        pool->stats.dedicated_threads++;
+    }
+    oc_mutex_unlock(pool->lock);
+
+    ca_thread_pool_join_dedicated(finished);
+
+    if (OC_THREAD_SUCCESS != thrRet)
     {
-        size_t index = 0;
-        if (u_arraylist_get_index(thread_pool->details->threads_list, threadInfo, &index))
-        {
-            u_arraylist_remove(thread_pool->details->threads_list, index);
-        }
-        oc_mutex_unlock(thread_pool->details->list_lock);
         OIC_LOG_V(ERROR, TAG, "Thread start failed with error %d", thrRet);
-        OICFree(info);
+        OICFree(dedicated);
         return CA_STATUS_FAILED;
     }
-    oc_mutex_unlock(thread_pool->details->list_lock);
 
     OIC_LOG(DEBUG, TAG, "OUT");
     return CA_STATUS_OK;
 }
 
+CAResult_t ca_thread_pool_get_stats(ca_thread_pool_t thread_pool, ca_thread_pool_stats_t *stats)
+{
+    if (NULL == thread_pool || NULL == stats)
+    {
+        OIC_LOG(ERROR, TAG, "thread_pool or stats was NULL");
+        return CA_STATUS_INVALID_PARAM;
+    }
+
+    oc_mutex_lock(thread_pool->details->lock);
+    *stats = thread_pool->details->stats;
+    stats->workers = thread_pool->details->started_workers;
+    oc_mutex_unlock(thread_pool->details->lock);
+
+    return CA_STATUS_OK;
+}
+
 void ca_thread_pool_free(ca_thread_pool_t thread_pool)
 {
     OIC_LOG(DEBUG, TAG, "IN");
@@ -214,29 +517,25 @@ void ca_thread_pool_free(ca_thread_pool_t thread_pool)
         return;
     }
 
-    oc_mutex_lock(thread_pool->details->list_lock);
+    ca_thread_pool_details_t *pool = thread_pool->details;
+
+    // Workers finish the tasks which are already queued before they exit.
+    oc_mutex_lock(pool->lock);
+    pool->stop = true;
+    oc_cond_broadcast(pool->cond);
+    size_t started_workers = pool->started_workers;
+    ca_thread_pool_dedicated_t *dedicated = pool->dedicated;
+    pool->dedicated = NULL;
+    oc_mutex_unlock(pool->lock);
 
-    for (size_t i = 0; i < u_arraylist_length(thread_pool->details->threads_list); ++i)
+    for (size_t i = 0; i < started_workers; ++i)
     {
-        ca_thread_pool_thread_info_t *threadInfo = (ca_thread_pool_thread_info_t *)
-                u_arraylist_get(thread_pool->details->threads_list, i);
-        if (threadInfo)
-        {
-            if (threadInfo->thread)
-            {
-                oc_thread_wait(threadInfo->thread);
-                oc_thread_free(threadInfo->thread);
-            }
-            OICFree(threadInfo);
-        }
+        oc_thread_wait(pool->workers[i].thread);
+        oc_thread_free(pool->workers[i].thread);
     }
+    ca_thread_pool_join_dedicated(dedicated);
 
-    u_arraylist_free(&(thread_pool->details->threads_list));
-
-    oc_mutex_unlock(thread_pool->details->list_lock);
-    oc_mutex_free(thread_pool->details->list_lock);
-
-    OICFree(thread_pool->details);
+    ca_thread_pool_free_details(pool);
     OICFree(thread_pool);
 
     OIC_LOG(DEBUG, TAG, "OUT");
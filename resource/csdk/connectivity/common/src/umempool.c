@@ -0,0 +1,155 @@
+/******************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************/
+
+#include "umempool.h"
+
+#include <string.h>
+#include "experimental/logger.h"
+#include "oic_malloc.h"
+
+/**
+ * @def TAG
+ * @brief Logging tag for module name
+ */
+#define TAG "OIC_UMEMPOOL"
+
+u_mem_pool_t *u_mem_pool_create(size_t blockSize, uint32_t capacity)
+{
+    if (0 == blockSize || 0 == capacity)
+    {
+        OIC_LOG(ERROR, TAG, "invalid block size or capacity");
+        return NULL;
+    }
+
+    u_mem_pool_t *pool = (u_mem_pool_t *) OICCalloc(1, sizeof(u_mem_pool_t));
+    if (NULL == pool)
+    {
+        OIC_LOG(ERROR, TAG, "PoolCreate FAIL");
+        return NULL;
+    }
+
+    pool->blocks = (void **) OICCalloc(capacity, sizeof(void *));
+    pool->mutex = oc_mutex_new();
+    if (NULL == pool->blocks || NULL == pool->mutex)
+    {
+        OIC_LOG(ERROR, TAG, "PoolCreate FAIL");
+        OICFree(pool->blocks);
+        oc_mutex_free(pool->mutex);
+        OICFree(pool);
+        return NULL;
+    }
+    pool->blockSize = blockSize;
+    pool->capacity = capacity;
+
+    return pool;
+}
+
+void u_mem_pool_delete(u_mem_pool_t *pool)
+{
+    if (NULL == pool)
+    {
+        return;
+    }
+    u_mem_pool_trim(pool);
+    oc_mutex_free(pool->mutex);
+    OICFree(pool->blocks);
+    OICFree(pool);
+}
+
+void u_mem_pool_trim(u_mem_pool_t *pool)
+{
+    if (NULL == pool)
+    {
+        return;
+    }
+
+    oc_mutex_lock(pool->mutex);
+    while (0 < pool->count)
+    {
+        OICFree(pool->blocks[--pool->count]);
+    }
+    oc_mutex_unlock(pool->mutex);
+}
+
+void *u_mem_pool_alloc(u_mem_pool_t *pool)
+{
+    if (NULL == pool)
+    {
+        OIC_LOG(ERROR, TAG, "PoolAlloc FAIL, Invalid Pool");
+        return NULL;
+    }
+
+    void *block = NULL;
+    oc_mutex_lock(pool->mutex);
+    if (0 < pool->count)
+    {
+        block = pool->blocks[--pool->count];
+    }
+    oc_mutex_unlock(pool->mutex);
+
+    return block ? block : OICMalloc(pool->blockSize);
+}
+
+void *u_mem_pool_calloc(u_mem_pool_t *pool)
+{
+    void *block = u_mem_pool_alloc(pool);
+    if (block)
+    {
+        memset(block, 0, pool->blockSize);
+    }
+    return block;
+}
+
+void u_mem_pool_free(u_mem_pool_t *pool, void *block)
+{
+    if (NULL == block)
+    {
+        return;
+    }
+    if (NULL == pool)
+    {
+        OICFree(block);
+        return;
+    }
+
+    oc_mutex_lock(pool->mutex);
+    if (pool->count < pool->capacity)
+    {
+        pool->blocks[pool->count++] = block;
+        block = NULL;
+    }
+    oc_mutex_unlock(pool->mutex);
+
+    // the pool is full
+    OICFree(block);
+}
+
+uint32_t u_mem_pool_get_count(u_mem_pool_t *pool)
+{
+    if (NULL == pool)
+    {
+        return 0;
+    }
+
+    oc_mutex_lock(pool->mutex);
+    uint32_t count = pool->count;
+    oc_mutex_unlock(pool->mutex);
+    return count;
+}
@@ -0,0 +1,183 @@
+/******************************************************************
+ *
+ * Copyright 2017 Samsung Electronics All Rights Reserved.
+ *
+ *
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ ******************************************************************/
+
+/*
+ * Cell i of the ring starts with sequence i. A producer claims position pos
+ * when the sequence of its cell equals pos, writes the message and publishes
+ * it by setting the sequence to pos + 1. The consumer reads the cell once the
+ * sequence is pos + 1 and frees it for the next round by setting the sequence
+ * to pos + capacity. Positions wrap around, so they are only ever compared by
+ * their difference.
+ *
+ * Sequence updates go through ocatomic, whose operations are full barriers:
+ * the message is written before it is published and read before the cell is
+ * freed again.
+ */
+
+#include "umpscqueue.h"
+
+#include <stddef.h>
+#include "ocatomic.h"
+#include "experimental/logger.h"
+#include "oic_malloc.h"
+
+/**
+ * @def TAG
+ * @brief Logging tag for module name
+ */
+#define TAG "OIC_UMPSCQUEUE"
+
+/**
+ * @def MAX_CAPACITY
+ * @brief Largest ring, so that positions stay comparable by their difference
+ */
+#define MAX_CAPACITY (1u << 30)
+
+static int32_t LoadPosition(volatile int32_t *position)
+{
+    return oc_atomic_add(position, 0);
+}
+
+static int32_t PositionDiff(int32_t a, int32_t b)
+{
+    return (int32_t)((uint32_t)a - (uint32_t)b);
+}
+
+u_mpsc_queue_t *u_mpsc_queue_create(uint32_t capacity)
+{
+    if (0 == capacity || MAX_CAPACITY < capacity)
+    {
+        OIC_LOG_V(ERROR, TAG, "invalid capacity %u", capacity);
+        return NULL;
+    }
+
+    uint32_t cellCount = 1;
+    while (cellCount < capacity)
+    {
+        cellCount <<= 1;
+    }
+
+    u_mpsc_queue_t *queue = (u_mpsc_queue_t *) OICCalloc(1, sizeof(u_mpsc_queue_t));
+    if (NULL == queue)
+    {
+        OIC_LOG(ERROR, TAG, "QueueCreate FAIL");
+        return NULL;
+    }
+
+    queue->cells = (u_mpsc_queue_cell_t *) OICCalloc(cellCount, sizeof(u_mpsc_queue_cell_t));
+    if (NULL == queue->cells)
+    {
+        OIC_LOG(ERROR, TAG, "QueueCreate FAIL");
+        OICFree(queue);
+        return NULL;
+    }
+
+    for (uint32_t i = 0; i < cellCount; i++)
+    {
+        queue->cells[i].sequence = (int32_t)i;
+    }
+    queue->mask = cellCount - 1;
+    queue->enqueuePos = 0;
+    queue->dequeuePos = 0;
+
+    return queue;
+}
+
+void u_mpsc_queue_delete(u_mpsc_queue_t *queue)
+{
+    if (NULL == queue)
+    {
+        return;
+    }
+    OICFree(queue->cells);
+    OICFree(queue);
+}
+
+bool u_mpsc_queue_push(u_mpsc_queue_t *queue, void *msg, uint32_t size)
+{
+    if (NULL == queue)
+    {
+        OIC_LOG(ERROR, TAG, "QueueAddElement FAIL, Invalid Queue");
+        return false;
+    }
+
+    u_mpsc_queue_cell_t *cell = NULL;
+    int32_t pos = LoadPosition(&queue->enqueuePos);
+    for (;;)
+    {
+        cell = &queue->cells[(uint32_t)pos & queue->mask];
+        int32_t diff = PositionDiff(LoadPosition(&cell->sequence), pos);
+        if (0 == diff)
+        {
+            if (oc_atomic_cmpxchg(&queue->enqueuePos, pos, (int32_t)((uint32_t)pos + 1)))
+            {
+                break;
+            }
+        }
+        else if (0 > diff)
+        {
+            // the consumer has not freed the cell of the previous round yet
+            return false;
+        }
+        pos = LoadPosition(&queue->enqueuePos);
+    }
+
+    cell->message.msg = msg;
+    cell->message.size = size;
+    oc_atomic_increment(&cell->sequence);
+    return true;
+}
+
+bool u_mpsc_queue_pop(u_mpsc_queue_t *queue, u_queue_message_t *message)
+{
+    if (NULL == queue || NULL == message)
+    {
+        return false;
+    }
+
+    int32_t pos = queue->dequeuePos;
+    u_mpsc_queue_cell_t *cell = &queue->cells[(uint32_t)pos & queue->mask];
+    if (0 > PositionDiff(LoadPosition(&cell->sequence), (int32_t)((uint32_t)pos + 1)))
+    {
+        // empty, or the producer of this position is still writing
+        return false;
+    }
+
+    *message = cell->message;
+    queue->dequeuePos = (int32_t)((uint32_t)pos + 1);
+    oc_atomic_add(&cell->sequence, (int32_t)queue->mask);
+    return true;
+}
+
+uint32_t u_mpsc_queue_get_size(u_mpsc_queue_t *queue)
+{
+    if (NULL == queue)
+    {
+        return 0;
+    }
+    int32_t size = PositionDiff(LoadPosition(&queue->enqueuePos),
+                                LoadPosition(&queue->dequeuePos));
+    return (0 < size) ? (uint32_t)size : 0;
+}
+
+uint32_t u_mpsc_queue_get_capacity(const u_mpsc_queue_t *queue)
+{
+    return (NULL == queue) ? 0 : queue->mask + 1;
+}
@@ -150,6 +150,26 @@ void CAIPSendData(CAEndpoint_t *endpoint,
                   size_t dataLength,
                   bool isMulticast);
 
+/**
+ * Unicast UDP datagram sent by ::CAIPSendDataBatch.
+ */
+typedef struct
+{
+    CAEndpoint_t *endpoint;     /**< complete network address to send to */
+    const void *data;           /**< data to be sent */
+    size_t dataLength;          /**< length of data in bytes */
+} CAIPDatagram_t;
+
+/**
+ * API to send several unicast UDP datagrams. Where the platform allows it, the
+ * plain datagrams going out of the same socket are sent with one system call;
+ * the others are sent one by one as by ::CAIPSendData.
+ *
+ * @param[in]  datagrams         Datagrams to be sent.
+ * @param[in]  count             Number of datagrams.
+ */
+void CAIPSendDataBatch(CAIPDatagram_t *datagrams, size_t count);
+
 /**
  * Get IP adapter connection state.
  *
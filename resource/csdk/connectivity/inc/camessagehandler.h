@@ -91,6 +91,18 @@ void CATerminateMessageHandler();
  */
 void CAHandleRequestResponseCallbacks();
 
+/**
+ * Wait until ::CAHandleRequestResponseCallbacks has a received message to handle.
+ * @param[in]   timeoutUs   longest wait in microseconds, 0 to return at once.
+ * @return   true if a message is waiting.
+ */
+bool CAWaitRequestResponseCallbacks(uint64_t timeoutUs);
+
+/**
+ * Make the current or next ::CAWaitRequestResponseCallbacks call return at once.
+ */
+void CACancelWaitRequestResponseCallbacks();
+
 /**
  * Setting the Callback funtion for network state change callback.
  * @param[in] nwMonitorHandler    callback for network state change.
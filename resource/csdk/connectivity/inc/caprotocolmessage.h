@@ -201,6 +201,24 @@ uint32_t CAGetOptionData(uint16_t key, const uint8_t *data, uint32_t len,
 CAResult_t CAGetInfoFromPDU(const coap_pdu_t *pdu, const CAEndpoint_t *endpoint,
                             uint32_t *outCode, CAInfo_t *outInfo);
 
+/**
+ * Creates the pool that UDP PDUs are taken from and given back to.
+ * Until it is created, PDUs are allocated by libcoap.
+ */
+void CAInitializePDUPool(void);
+
+/**
+ * Frees the PDUs kept in the pool. The pool itself stays usable.
+ */
+void CATerminatePDUPool(void);
+
+/**
+ * Deletes a pdu made by CAGeneratePDU, CAParsePDU or libcoap, giving it back
+ * to the pool when it has the pooled size.
+ * @param[in]   pdu                 pdu to delete.
+ */
+void CADeletePDU(coap_pdu_t *pdu);
+
 /**
  * create pdu from received data.
  * @param[in]   data                received data.
@@ -32,6 +32,7 @@
 #include "cathreadpool.h"
 #include "octhread.h"
 #include "uqueue.h"
+#include "umpscqueue.h"
 #include "cacommon.h"
 #ifdef __cplusplus
 extern "C"
@@ -60,6 +61,20 @@ typedef struct
     bool isStop;
     /** Que on which the thread is operating. **/
     u_queue_t *dataQueue;
+    /** Bounded que used instead of dataQueue, see CAQueueingThreadInitializeBounded(). **/
+    u_mpsc_queue_t *ringQueue;
+    /** conditional for producers waiting until ringQueue has room. **/
+    oc_cond spaceCond;
+    /** Time a producer waits for room in ringQueue before its data is dropped. **/
+    uint64_t fullWaitUs;
+    /** Non-zero while the thread waits for data; changed atomically. **/
+    volatile int32_t consumerWaiting;
+    /** Number of producers waiting on spaceCond; changed atomically. **/
+    volatile int32_t producersWaiting;
+    /** Number of data dropped because ringQueue stayed full. **/
+    volatile int32_t droppedCount;
+    /** Set by CAQueueingThreadCancelWait() until CAQueueingThreadWaitData() returns. **/
+    bool waitCancelled;
 } CAQueueingThread_t;
 
 /**
@@ -73,6 +88,23 @@ typedef struct
 CAResult_t CAQueueingThreadInitialize(CAQueueingThread_t *thread, ca_thread_pool_t handle,
                                       CAThreadTask task, CADataDestroyFunction destroy);
 
+/**
+ * Initializes the queuing thread with a bounded lock-free queue.
+ * Adding data neither allocates nor takes a lock unless the thread is waiting for data.
+ * When the queue is full, producers wait up to fullWaitUs for room; after that the data
+ * is dropped.
+ * @param[in]   thread       thread data for each thread.
+ * @param[in]   handle       thread pool handle created.
+ * @param[in]   task         function to be called for each data.
+ * @param[in]   destroy      function to data destroy.
+ * @param[in]   capacity     maximum number of queued data, rounded up to a power of two.
+ * @param[in]   fullWaitUs   microseconds to wait for room in a full queue, 0 to drop at once.
+ * @return  CA_STATUS_OK or ERROR CODES (CAResult_t error codes in cacommon.h).
+ */
+CAResult_t CAQueueingThreadInitializeBounded(CAQueueingThread_t *thread, ca_thread_pool_t handle,
+                                             CAThreadTask task, CADataDestroyFunction destroy,
+                                             uint32_t capacity, uint64_t fullWaitUs);
+
 /**
  * Start the queuing thread.
  * @param[in]   thread        thread data that needs to be started.
@@ -82,6 +114,7 @@ CAResult_t CAQueueingThreadStart(CAQueueingThread_t *thread);
 
 /**
  * Add queuing thread data for new thread.
+ * If a bounded queue stays full, data is destroyed and CA_SEND_FAILED is returned.
  * @param[in]   thread       thread data for new thread control.
  * @param[in]   data         data that needs to be given for each thread.
  * @param[in]   size         length of the data.
@@ -89,6 +122,17 @@ CAResult_t CAQueueingThreadStart(CAQueueingThread_t *thread);
  */
 CAResult_t CAQueueingThreadAddData(CAQueueingThread_t *thread, void *data, uint32_t size);
 
+/**
+ * Removes the first data of the queue without waiting. Only the thread task of a
+ * started queue, or the owner of a queue whose thread is not started, calls it.
+ * The caller owns the data afterwards.
+ * @param[in]   thread       thread data.
+ * @param[out]  data         first data of the queue.
+ * @param[out]  size         length of the data.
+ * @return  true if data was removed, false if the queue is empty.
+ */
+bool CAQueueingThreadGetData(CAQueueingThread_t *thread, void **data, uint32_t *size);
+
 /**
  * Stop the queuing thread.
  * @param[in]   thread       thread data that needs to be started.
@@ -97,6 +141,22 @@ CAResult_t CAQueueingThreadAddData(CAQueueingThread_t *thread, void *data, uint3
 
 CAResult_t CAQueueingThreadStop(CAQueueingThread_t *thread);
 
+/**
+ * Waits until the queue has data, the wait is cancelled, or the timeout elapsed.
+ * Only the owner of a queue whose thread is not started, which takes the data with
+ * CAQueueingThreadGetData(), calls it.
+ * @param[in]   thread       thread data.
+ * @param[in]   timeoutUs    longest wait in microseconds, 0 to return at once.
+ * @return  true if the queue has data.
+ */
+bool CAQueueingThreadWaitData(CAQueueingThread_t *thread, uint64_t timeoutUs);
+
+/**
+ * Makes the current or next CAQueueingThreadWaitData() call return at once.
+ * @param[in]   thread       thread data.
+ */
+void CAQueueingThreadCancelWait(CAQueueingThread_t *thread);
+
 /**
  * Terminate the queuing thread.
  * @param[in]   thread       thread data for each thread.
@@ -47,6 +47,12 @@
 /** check period is 1 sec. **/
 #define RETRANSMISSION_CHECK_PERIOD_SEC     1
 
+/** retransmission data, indexed by adapter and message id. **/
+struct CARetransmissionData;
+
+/** timer wheel ordering retransmission data by next send time. **/
+struct CARetransmissionWheel;
+
 /** retransmission data send method type. **/
 typedef CAResult_t (*CADataSendMethod_t)(const CAEndpoint_t *endpoint,
                                          const void *pdu,
@@ -91,8 +97,14 @@ typedef struct
     /** Variable to inform the thread to stop. **/
     bool isStop;
 
-    /** array list on which the thread is operating. **/
-    u_arraylist_t *dataList;
+    /** retransmission data hashed by adapter and message id. **/
+    struct CARetransmissionData *dataTable;
+
+    /** timer wheel on which the thread is operating. **/
+    struct CARetransmissionWheel *wheel;
+
+    /** number of retransmission data waiting for ACK. **/
+    size_t dataCount;
 
 } CARetransmission_t;
 
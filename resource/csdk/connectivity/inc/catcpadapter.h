@@ -29,6 +29,7 @@
 #include "caadapterinterface.h"
 #include "cathreadpool.h"
 #include "cainterface.h"
+#include "uthash.h"
 #include <coap/pdu.h>
 
 #ifdef __cplusplus
@@ -54,6 +55,15 @@ typedef enum
     DISCONNECTED
 } CATCPConnectionState_t;
 
+/**
+ * Key of the session index by remote address and port.
+ */
+typedef struct
+{
+    char addr[MAX_ADDR_STR_SIZE_CA];    /**< remote address, zero padded */
+    uint16_t port;                      /**< remote port */
+} CATCPSessionKey_t;
+
 /**
  * TCP Session Information for IPv4/IPv6 TCP transport
  */
@@ -64,12 +74,21 @@ typedef struct CATCPSessionInfo_t
     unsigned char* data;                /**< received data from remote device */
     size_t len;                         /**< received data length */
     size_t totalLen;                    /**< total coap data length required to receive */
-    unsigned char tlsdata[18437];       /**< tls data(rfc5246: TLSCiphertext max (2^14+2048+5)) */
+    unsigned char *tlsdata;             /**< partial tls record, allocated on first use */
     size_t tlsLen;                      /**< received tls data length */
     CAProtocol_t protocol;              /**< application-level protocol */
     CATCPConnectionState_t state;       /**< current tcp session state */
     bool isClient;                      /**< Host Mode of Operation. */
     struct CATCPSessionInfo_t *next;    /**< Linked list; for multiple session list. */
+    unsigned char *sendBuf;             /**< data not yet accepted by a non-blocking socket */
+    size_t sendBufSize;                 /**< allocated size of sendBuf */
+    size_t sendBufStart;                /**< offset of the first unsent byte in sendBuf */
+    size_t sendBufLen;                  /**< number of unsent bytes in sendBuf */
+    CATCPSessionKey_t key;              /**< key in the index by address and port */
+    struct CATCPSessionInfo_t *nextSameKey; /**< other sessions with the same key */
+    bool fdIndexed;                     /**< session is in the index by fd */
+    UT_hash_handle hhFd;                /**< index by fd */
+    UT_hash_handle hhKey;               /**< index by address and port */
 } CATCPSessionInfo_t;
 
 /**
@@ -29,10 +29,13 @@
 #include <stdbool.h>
 #include <assert.h>
 #include <inttypes.h>
+#include "uthash.h"
 #include "ca_adapter_net_ssl.h"
 #include "cacommon.h"
 #include "caipinterface.h"
 #include "oic_malloc.h"
+#include "oic_string.h"
+#include "oic_time.h"
 #include "experimental/ocrandom.h"
 #include "experimental/byte_array.h"
 #include "octhread.h"
@@ -47,6 +50,10 @@
 #include "mbedtls/ssl_internal.h"
 #include "mbedtls/net_sockets.h"
 #include "mbedtls/oid.h"
+#include "mbedtls/ssl_cache.h"
+#if defined(MBEDTLS_SSL_SESSION_TICKETS) && defined(MBEDTLS_SSL_TICKET_C)
+#include "mbedtls/ssl_ticket.h"
+#endif
 #ifdef __WITH_DTLS__
 #include "mbedtls/timing.h"
 #include "mbedtls/ssl_cookie.h"
@@ -176,6 +183,18 @@
  */
 #define RETRANSMISSION_TIME 1
 
+/**
+ * @def SSL_SESSION_TIMEOUT_SEC
+ * @brief Lifetime (in seconds) of a cached session. Resuming it skips the full handshake.
+ */
+#define SSL_SESSION_TIMEOUT_SEC (60 * 60)
+
+/**
+ * @def SSL_SESSION_CACHE_MAX
+ * @brief Maximum number of cached sessions on each of the client and server sides.
+ */
+#define SSL_SESSION_CACHE_MAX (64)
+
 /**@def SSL_CLOSE_NOTIFY(peer, ret)
  *
  * Notifies of existing \a peer about closing TLS connection.
@@ -342,6 +361,42 @@ static void DebugSsl(void *ctx, int level, const char *file, int line, const cha
  */
 typedef ByteArray_t SslCacheMessage_t;
 
+/**
+ * Key of the peer index and of the client session cache.
+ * The port is zero for BLE, where the peer is identified by its address only.
+ */
+typedef struct SslPeerKey
+{
+    CATransportAdapter_t adapter;
+    uint16_t port;
+    char addr[MAX_ADDR_STR_SIZE_CA];
+} SslPeerKey_t;
+
+/**
+ * Session kept by the client role to resume the next handshake with the same peer.
+ */
+typedef struct SslClientSession
+{
+    SslPeerKey_t key;
+    mbedtls_ssl_session session;
+    uint64_t timeStamp;              /**< milliseconds, when the session was stored */
+    UT_hash_handle hh;
+} SslClientSession_t;
+
+/**
+ * PSK identity of a session kept by the server role. mbedTLS does not call the PSK
+ * callback for a resumed session, so the identity is restored from here.
+ */
+typedef struct SslServerIdentity
+{
+    unsigned char sessionId[32];
+    CARemoteId_t identity;
+    uint64_t timeStamp;              /**< milliseconds, when the identity was stored */
+    UT_hash_handle hh;
+} SslServerIdentity_t;
+
+struct SslEndPoint;
+
 
 /**
  * Data structure for holding the send and recv callbacks.
@@ -360,8 +415,10 @@ typedef struct SslContext
 {
     u_arraylist_t *peerList;         /**< peer list which holds the mapping between
                                               peer id, it's n/w address and mbedTLS context. */
+    struct SslEndPoint *peerIndex;   /**< peers of peerList hashed by SslPeerKey_t. */
     mbedtls_entropy_context entropy;
     mbedtls_ctr_drbg_context rnd;
+    oc_mutex rndMutex;               /**< serializes rnd, which sessions share for record IVs. */
     mbedtls_x509_crt ca;
     mbedtls_x509_crt crt;
     mbedtls_pk_context pkey;
@@ -382,6 +439,13 @@ typedef struct SslContext
     int timerId;
 #endif
 
+    mbedtls_ssl_cache_context sessionCache;   /**< server sessions for resumption. */
+#if defined(MBEDTLS_SSL_SESSION_TICKETS) && defined(MBEDTLS_SSL_TICKET_C)
+    mbedtls_ssl_ticket_context ticketCtx;     /**< server session ticket keys. */
+#endif
+    SslClientSession_t *clientSessions;       /**< client sessions for resumption. */
+    SslServerIdentity_t *serverIdentities;    /**< PSK identities of server sessions. */
+
 } SslContext_t;
 
 /**
@@ -410,6 +474,11 @@ static CAgetPkixInfoHandler g_getPkixInfoCallback = NULL;
 /**
  * @var g_dtlsContextMutex
  * @brief Mutex to synchronize access to g_caSslContext and g_sslCallback.
+ *
+ * Handshakes hold it, because they reconfigure the shared mbedTLS configs. Records of
+ * established sessions are only processed under the mutex of their peer, so sessions
+ * proceed in parallel; the mutex is only held to look them up and release them. Lock
+ * order: g_sslContextMutex, then a peer mutex.
  */
 static oc_mutex g_sslContextMutex = NULL;
 
@@ -450,6 +519,12 @@ typedef struct SslEndPoint
 #ifdef __WITH_DTLS__
     mbedtls_timing_delay_context timer;
 #endif // __WITH_DTLS__
+    SslPeerKey_t key;
+    UT_hash_handle hh;
+    oc_mutex mutex;                  /**< serializes ssl, recBuf and cacheList */
+    uint32_t refCount;               /**< one for peerList plus one per user not holding
+                                          g_sslContextMutex, guarded by g_sslContextMutex */
+    bool removed;                    /**< set under mutex when the peer leaves peerList */
 } SslEndPoint_t;
 
 void CAsetPskCredentialsCallback(CAgetPskCredentialsHandler credCallback)
@@ -556,6 +631,28 @@ static int GetAdapterIndex(CATransportAdapter_t adapter)
     }
 }
 
+/**
+ * Copies the callbacks of an adapter under g_sslContextMutex, for the records which are
+ * delivered without it. Must not be called under the mutex of a peer.
+ *
+ * @param[in]  adapterIndex    index of the adapter, see GetAdapterIndex()
+ * @param[out] callbacks       callbacks of the adapter
+ *
+ * @return  false if the context is gone
+ */
+static bool GetAdapterCallbacks(int adapterIndex, SslCallbacks_t *callbacks)
+{
+    bool found = false;
+    oc_mutex_lock(g_sslContextMutex);
+    if (NULL != g_caSslContext)
+    {
+        *callbacks = g_caSslContext->adapterCallbacks[adapterIndex];
+        found = true;
+    }
+    oc_mutex_unlock(g_sslContextMutex);
+    return found;
+}
+
 static void SendCacheMessages(SslEndPoint_t * tep, CAResult_t errorCode);
 
 /**
@@ -579,6 +676,8 @@ static int SendCallBack(void * tep, const unsigned char * data, size_t dataLen)
     int adapterIndex = GetAdapterIndex(((SslEndPoint_t * )tep)->sep.endpoint.adapter);
     if (0 <= adapterIndex && MAX_SUPPORTED_ADAPTERS > adapterIndex)
     {
+        // Runs under the mutex of the peer, which CAdeinitSslAdapter() waits for before
+        // the context is freed, so g_sslContextMutex is not needed (nor allowed) here.
         size_t dataToSend = (dataLen > INT_MAX) ? INT_MAX : dataLen;
         CAPacketSendCallback sendCallback = g_caSslContext->adapterCallbacks[adapterIndex].sendCallback;
         sentLen = sendCallback(&(((SslEndPoint_t * )tep)->sep.endpoint), (const void *) data, dataToSend);
@@ -868,6 +967,21 @@ static int GetPskCredentialsCallback(void * notUsed, mbedtls_ssl_context * ssl,
     OIC_LOG_V(WARNING, NET_SSL_TAG, "Out %s", __func__);
     return -1;
 }
+/**
+ * Fills the key of the peer index and of the session caches for endpoint.
+ *
+ * @param[in]  endpoint    remote address
+ * @param[out] key    key to fill
+ */
+static void MakeSslPeerKey(const CAEndpoint_t *endpoint, SslPeerKey_t *key)
+{
+    // zero the padding and the tail of addr, the whole struct is hashed
+    memset(key, 0, sizeof(*key));
+    key->adapter = endpoint->adapter;
+    key->port = (CA_ADAPTER_GATT_BTLE == endpoint->adapter) ? 0 : endpoint->port;
+    OICStrcpy(key->addr, sizeof(key->addr), endpoint->addr);
+}
+
 /**
  * Gets session corresponding for endpoint.
  *
@@ -877,8 +991,6 @@ static int GetPskCredentialsCallback(void * notUsed, mbedtls_ssl_context * ssl,
  */
 static SslEndPoint_t *GetSslPeer(const CAEndpoint_t *peer)
 {
-    size_t listIndex = 0;
-    size_t listLength = 0;
     OIC_LOG_V(DEBUG, NET_SSL_TAG, "In %s", __func__);
 
     oc_mutex_assert_owner(g_sslContextMutex, true);
@@ -886,31 +998,369 @@ static SslEndPoint_t *GetSslPeer(const CAEndpoint_t *peer)
     VERIFY_NON_NULL_RET(peer, NET_SSL_TAG, "TLS peer is NULL", NULL);
     VERIFY_NON_NULL_RET(g_caSslContext, NET_SSL_TAG, "SSL Context is NULL", NULL);
 
+    SslPeerKey_t key;
+    MakeSslPeerKey(peer, &key);
+
     SslEndPoint_t *tep = NULL;
-    listLength = u_arraylist_length(g_caSslContext->peerList);
-    for (listIndex = 0; listIndex < listLength; listIndex++)
+    HASH_FIND(hh, g_caSslContext->peerIndex, &key, sizeof(key), tep);
+    if (NULL == tep)
     {
-        tep = (SslEndPoint_t *) u_arraylist_get(g_caSslContext->peerList, listIndex);
-        if (NULL == tep)
+        OIC_LOG(DEBUG, NET_SSL_TAG, "Return NULL");
+    }
+    OIC_LOG_V(DEBUG, NET_SSL_TAG, "Out %s", __func__);
+    return tep;
+}
+
+/**
+ * Adds endpoint session to the peer list and to the peer index.
+ *
+ * @param[in]  tep    endpoint with session info
+ *
+ * @return  true on success or false on error
+ */
+static bool AddPeerToList(SslEndPoint_t *tep)
+{
+    oc_mutex_assert_owner(g_sslContextMutex, true);
+
+    VERIFY_NON_NULL_RET(g_caSslContext, NET_SSL_TAG, "SSL Context is NULL", false);
+    VERIFY_NON_NULL_RET(tep, NET_SSL_TAG, "tep", false);
+
+    if (!u_arraylist_add(g_caSslContext->peerList, (void *) tep))
+    {
+        OIC_LOG(ERROR, NET_SSL_TAG, "u_arraylist_add failed!");
+        return false;
+    }
+    MakeSslPeerKey(&tep->sep.endpoint, &tep->key);
+    tep->refCount = 1;
+    HASH_ADD(hh, g_caSslContext->peerIndex, key, sizeof(tep->key), tep);
+    return true;
+}
+
+/**
+ * Gets session corresponding for endpoint and takes a reference on it, so that its
+ * records can be processed after g_sslContextMutex is released. The reference keeps the
+ * peer allocated until ReleaseSslPeer().
+ *
+ * @param[in]  endpoint    remote address
+ *
+ * @return  TLS session or NULL
+ */
+static SslEndPoint_t *AcquireSslPeer(const CAEndpoint_t *endpoint)
+{
+    SslPeerKey_t key;
+    MakeSslPeerKey(endpoint, &key);
+
+    SslEndPoint_t *tep = NULL;
+    oc_mutex_lock(g_sslContextMutex);
+    if (NULL == g_caSslContext)
+    {
+        OIC_LOG(ERROR, NET_SSL_TAG, "SSL Context is NULL");
+        oc_mutex_unlock(g_sslContextMutex);
+        return NULL;
+    }
+    HASH_FIND(hh, g_caSslContext->peerIndex, &key, sizeof(key), tep);
+    if (NULL != tep)
+    {
+        tep->refCount++;
+    }
+    oc_mutex_unlock(g_sslContextMutex);
+    return tep;
+}
+
+/**
+ * Takes another reference on a peer found under g_sslContextMutex.
+ *
+ * @param[in]  tep    endpoint with session info
+ */
+static void RetainSslPeer(SslEndPoint_t *tep)
+{
+    oc_mutex_assert_owner(g_sslContextMutex, true);
+    tep->refCount++;
+}
+
+static void DeleteSslEndPoint(SslEndPoint_t * tep);
+
+/**
+ * Drops a reference on a peer and deletes it with the last one.
+ *
+ * @param[in]  tep    endpoint with session info
+ */
+static void ReleaseSslPeer(SslEndPoint_t *tep)
+{
+    // The session refers to the configs of the context, so it is freed before those.
+    oc_mutex_lock(g_sslContextMutex);
+    if (0 == --tep->refCount)
+    {
+        DeleteSslEndPoint(tep);
+    }
+    oc_mutex_unlock(g_sslContextMutex);
+}
+
+/**
+ * Checks whether a session was negotiated with the anonymous ciphersuite.
+ * Such sessions are only used for ownership transfer and are never resumed.
+ *
+ * @param[in]  session    negotiated session
+ *
+ * @return  true if the session is anonymous
+ */
+static bool IsAnonSession(const mbedtls_ssl_session *session)
+{
+    return MBEDTLS_TLS_ECDH_ANON_WITH_AES_128_CBC_SHA256 == session->ciphersuite;
+}
+
+/**
+ * Checks whether a cached session or identity stored at timeStamp has expired.
+ *
+ * @param[in]  timeStamp    milliseconds, when the entry was stored
+ *
+ * @return  true if the entry is too old to be used
+ */
+static bool IsSessionExpired(uint64_t timeStamp)
+{
+    return OICGetCurrentTime(TIME_IN_MS) - timeStamp > (uint64_t)SSL_SESSION_TIMEOUT_SEC * 1000;
+}
+
+/**
+ * Server side session cache callback. Refuses anonymous sessions and
+ * stores the others in the mbedTLS session cache.
+ *
+ * @param[in]  data    mbedtls_ssl_cache_context
+ * @param[in]  session    negotiated session
+ *
+ * @return  0 on success
+ */
+static int SetServerSessionCache(void *data, const mbedtls_ssl_session *session)
+{
+    if (IsAnonSession(session))
+    {
+        return 0;
+    }
+    return mbedtls_ssl_cache_set(data, session);
+}
+
+/**
+ * Frees a cached client session.
+ *
+ * @param[in]  entry    client session to free
+ */
+static void DeleteClientSession(SslClientSession_t *entry)
+{
+    HASH_DEL(g_caSslContext->clientSessions, entry);
+    mbedtls_ssl_session_free(&entry->session);
+    OICFree(entry);
+}
+
+/**
+ * Drops the session cached by the client role for endpoint, so that the
+ * next handshake with it is a full one.
+ *
+ * @param[in]  endpoint    remote address
+ */
+static void RemoveClientSession(const CAEndpoint_t *endpoint)
+{
+    oc_mutex_assert_owner(g_sslContextMutex, true);
+
+    VERIFY_NON_NULL_VOID(g_caSslContext, NET_SSL_TAG, "SSL Context is NULL");
+
+    SslPeerKey_t key;
+    MakeSslPeerKey(endpoint, &key);
+
+    SslClientSession_t *entry = NULL;
+    HASH_FIND(hh, g_caSslContext->clientSessions, &key, sizeof(key), entry);
+    if (NULL != entry)
+    {
+        DeleteClientSession(entry);
+    }
+}
+
+/**
+ * Saves the session negotiated by the client role for later resumption.
+ *
+ * @param[in]  tep    endpoint whose handshake is over
+ */
+static void SaveClientSession(SslEndPoint_t *tep)
+{
+    oc_mutex_assert_owner(g_sslContextMutex, true);
+
+    RemoveClientSession(&tep->sep.endpoint);
+    if (IsAnonSession(tep->ssl.session))
+    {
+        return;
+    }
+
+    SslClientSession_t *entry = (SslClientSession_t *)OICCalloc(1, sizeof(SslClientSession_t));
+    if (NULL == entry)
+    {
+        OIC_LOG(ERROR, NET_SSL_TAG, "Malloc failed!");
+        return;
+    }
+    mbedtls_ssl_session_init(&entry->session);
+    if (0 != mbedtls_ssl_get_session(&tep->ssl, &entry->session))
+    {
+        OIC_LOG(WARNING, NET_SSL_TAG, "Session not saved");
+        mbedtls_ssl_session_free(&entry->session);
+        OICFree(entry);
+        return;
+    }
+
+    // the table keeps insertion order, so its head is the oldest session
+    if (HASH_COUNT(g_caSslContext->clientSessions) >= SSL_SESSION_CACHE_MAX)
+    {
+        DeleteClientSession(g_caSslContext->clientSessions);
+    }
+    entry->key = tep->key;
+    entry->timeStamp = OICGetCurrentTime(TIME_IN_MS);
+    HASH_ADD(hh, g_caSslContext->clientSessions, key, sizeof(entry->key), entry);
+}
+
+/**
+ * Offers the session cached for the peer of tep, if its ciphersuite is
+ * still allowed by the credentials currently set up for that peer.
+ *
+ * @param[in]  tep    new client endpoint, before the handshake starts
+ */
+static void ApplyClientSession(SslEndPoint_t *tep)
+{
+    oc_mutex_assert_owner(g_sslContextMutex, true);
+
+    SslPeerKey_t key;
+    MakeSslPeerKey(&tep->sep.endpoint, &key);
+
+    SslClientSession_t *entry = NULL;
+    HASH_FIND(hh, g_caSslContext->clientSessions, &key, sizeof(key), entry);
+    if (NULL == entry)
+    {
+        return;
+    }
+    if (IsSessionExpired(entry->timeStamp))
+    {
+        DeleteClientSession(entry);
+        return;
+    }
+
+    bool allowed = false;
+    for (int i = 0; i < SSL_CIPHER_MAX && 0 != g_cipherSuitesList[i]; i++)
+    {
+        if (g_cipherSuitesList[i] == entry->session.ciphersuite)
         {
-            continue;
+            allowed = true;
+            break;
         }
+    }
+    if (!allowed || 0 != mbedtls_ssl_set_session(&tep->ssl, &entry->session))
+    {
+        OIC_LOG(DEBUG, NET_SSL_TAG, "Cached session dropped");
+        DeleteClientSession(entry);
+        return;
+    }
+    OIC_LOG_V(DEBUG, NET_SSL_TAG, "Resuming session with [%s:%d]",
+              tep->sep.endpoint.addr, tep->sep.endpoint.port);
+}
+
+/**
+ * Frees a stored server PSK identity.
+ *
+ * @param[in]  entry    identity to free
+ */
+static void DeleteServerIdentity(SslServerIdentity_t *entry)
+{
+    HASH_DEL(g_caSslContext->serverIdentities, entry);
+    OICFree(entry);
+}
+
+/**
+ * Keeps track of the PSK identity of server sessions. mbedTLS skips the PSK
+ * callback when a cached session is resumed, so the identity learned in the
+ * full handshake is stored by session id and restored on resumption. The
+ * restored identity must still have a credential.
+ *
+ * @param[in]  tep    server endpoint whose PSK handshake is over
+ *
+ * @return  0 on success or -1 if the identity of a resumed session is unknown
+ */
+static int UpdateServerIdentity(SslEndPoint_t *tep)
+{
+    oc_mutex_assert_owner(g_sslContextMutex, true);
+
+    const mbedtls_ssl_session *session = tep->ssl.session;
+    unsigned char sessionId[sizeof(((SslServerIdentity_t *)0)->sessionId)] = {0};
+    if (0 == session->id_len || session->id_len > sizeof(sessionId))
+    {
+        return (0 < tep->sep.identity.id_length) ? 0 : -1;
+    }
+    memcpy(sessionId, session->id, session->id_len);
 
-        OIC_LOG_V(DEBUG, NET_SSL_TAG, "Compare [%s:%d] and [%s:%d] for %d adapter",
-                  peer->addr, peer->port, tep->sep.endpoint.addr, tep->sep.endpoint.port,
-                  peer->adapter);
+    SslServerIdentity_t *entry = NULL;
+    HASH_FIND(hh, g_caSslContext->serverIdentities, sessionId, sizeof(sessionId), entry);
 
-        if((peer->adapter == tep->sep.endpoint.adapter)
-                && (0 == strncmp(peer->addr, tep->sep.endpoint.addr, MAX_ADDR_STR_SIZE_CA))
-                && (peer->port == tep->sep.endpoint.port || CA_ADAPTER_GATT_BTLE == peer->adapter))
+    if (0 < tep->sep.identity.id_length)
+    {
+        // full handshake, the PSK callback has set the identity
+        if (NULL != entry)
         {
-            OIC_LOG_V(DEBUG, NET_SSL_TAG, "Out %s", __func__);
-            return tep;
+            DeleteServerIdentity(entry);
+        }
+        entry = (SslServerIdentity_t *)OICCalloc(1, sizeof(SslServerIdentity_t));
+        if (NULL == entry)
+        {
+            OIC_LOG(ERROR, NET_SSL_TAG, "Malloc failed!");
+            return 0;
+        }
+        if (HASH_COUNT(g_caSslContext->serverIdentities) >= SSL_SESSION_CACHE_MAX)
+        {
+            DeleteServerIdentity(g_caSslContext->serverIdentities);
         }
+        memcpy(entry->sessionId, sessionId, sizeof(sessionId));
+        entry->identity = tep->sep.identity;
+        entry->timeStamp = OICGetCurrentTime(TIME_IN_MS);
+        HASH_ADD(hh, g_caSslContext->serverIdentities, sessionId, sizeof(entry->sessionId), entry);
+        return 0;
+    }
+
+    // resumed session
+    if (NULL == entry || IsSessionExpired(entry->timeStamp))
+    {
+        OIC_LOG(ERROR, NET_SSL_TAG, "Identity of resumed session is unknown");
+        if (NULL != entry)
+        {
+            DeleteServerIdentity(entry);
+        }
+        return -1;
+    }
+    uint8_t keyBuf[PSK_LENGTH] = {0};
+    if (NULL == g_getCredentialsCallback ||
+        0 >= g_getCredentialsCallback(CA_DTLS_PSK_KEY, entry->identity.id,
+                                      entry->identity.id_length, keyBuf, PSK_LENGTH))
+    {
+        OIC_LOG(ERROR, NET_SSL_TAG, "Credential of resumed session was removed");
+        DeleteServerIdentity(entry);
+        return -1;
+    }
+    tep->sep.identity = entry->identity;
+    return 0;
+}
+
+/**
+ * Deletes the session caches of both roles.
+ */
+static void DeleteSessionCaches()
+{
+    oc_mutex_assert_owner(g_sslContextMutex, true);
+
+    SslClientSession_t *session = NULL;
+    SslClientSession_t *sessionTmp = NULL;
+    HASH_ITER(hh, g_caSslContext->clientSessions, session, sessionTmp)
+    {
+        DeleteClientSession(session);
+    }
+
+    SslServerIdentity_t *identity = NULL;
+    SslServerIdentity_t *identityTmp = NULL;
+    HASH_ITER(hh, g_caSslContext->serverIdentities, identity, identityTmp)
+    {
+        DeleteServerIdentity(identity);
     }
-    OIC_LOG(DEBUG, NET_SSL_TAG, "Return NULL");
-    OIC_LOG_V(DEBUG, NET_SSL_TAG, "Out %s", __func__);
-    return NULL;
 }
 
 /**
@@ -1102,36 +1552,55 @@ static void DeleteSslEndPoint(SslEndPoint_t * tep)
 
     mbedtls_ssl_free(&tep->ssl);
     DeleteCacheList(tep->cacheList);
+    oc_mutex_free(tep->mutex);
     OICFree(tep);
     OIC_LOG_V(DEBUG, NET_SSL_TAG, "Out %s", __func__);
 }
 /**
- * Removes endpoint session from list.
+ * Removes endpoint session from list. It is deleted once the last user released it.
  *
- * @param[in]  endpoint    remote address
+ * @param[in]  tep    endpoint with session info
  */
-static void RemovePeerFromList(CAEndpoint_t * endpoint)
+static void RemoveSslPeer(SslEndPoint_t * tep)
 {
     oc_mutex_assert_owner(g_sslContextMutex, true);
 
-    VERIFY_NON_NULL_VOID(g_caSslContext, NET_SSL_TAG, "SSL Context is NULL");
-    VERIFY_NON_NULL_VOID(endpoint, NET_SSL_TAG, "endpoint");
-
-    size_t listLength = u_arraylist_length(g_caSslContext->peerList);
-    for (size_t listIndex = 0; listIndex < listLength; listIndex++)
+    // waits for the record being processed
+    oc_mutex_lock(tep->mutex);
+    if (tep->removed)
     {
-        SslEndPoint_t * tep = (SslEndPoint_t *)u_arraylist_get(g_caSslContext->peerList, listIndex);
-        if (NULL == tep)
-        {
-            continue;
-        }
-        if(0 == strncmp(endpoint->addr, tep->sep.endpoint.addr, MAX_ADDR_STR_SIZE_CA)
-                && (endpoint->port == tep->sep.endpoint.port))
-        {
-            u_arraylist_remove(g_caSslContext->peerList, listIndex);
-            DeleteSslEndPoint(tep);
-            return;
-        }
+        oc_mutex_unlock(tep->mutex);
+        return;
+    }
+    tep->removed = true;
+    oc_mutex_unlock(tep->mutex);
+
+    HASH_DEL(g_caSslContext->peerIndex, tep);
+
+    size_t listIndex = 0;
+    if (u_arraylist_get_index(g_caSslContext->peerList, tep, &listIndex))
+    {
+        u_arraylist_remove(g_caSslContext->peerList, listIndex);
+    }
+    ReleaseSslPeer(tep);
+}
+
+/**
+ * Removes endpoint session from list.
+ *
+ * @param[in]  endpoint    remote address
+ */
+static void RemovePeerFromList(CAEndpoint_t * endpoint)
+{
+    oc_mutex_assert_owner(g_sslContextMutex, true);
+
+    VERIFY_NON_NULL_VOID(g_caSslContext, NET_SSL_TAG, "SSL Context is NULL");
+    VERIFY_NON_NULL_VOID(endpoint, NET_SSL_TAG, "endpoint");
+
+    SslEndPoint_t * tep = GetSslPeer(endpoint);
+    if (NULL != tep)
+    {
+        RemoveSslPeer(tep);
     }
 }
 
@@ -1181,6 +1650,7 @@ static bool checkSslOperation(SslEndPoint_t*  peer,
         // Make a copy of the endpoint, because the callback might
         // free the peer object, during notifySubscriber() below.
         CAEndpoint_t removedEndpoint = (peer)->sep.endpoint;
+        bool isClient = (MBEDTLS_SSL_IS_CLIENT == peer->ssl.conf->endpoint);
 
         oc_mutex_lock(g_sslContextMutex);
 
@@ -1189,7 +1659,7 @@ static bool checkSslOperation(SslEndPoint_t*  peer,
             CAResult_t result = notifySubscriber(peer, CA_DTLS_AUTHENTICATION_FAILURE);
 
             //return an error to app layer
-            if (MBEDTLS_SSL_IS_CLIENT == peer->ssl.conf->endpoint)
+            if (isClient)
             {
                 if (CA_STATUS_OK == result)
                 {
@@ -1200,6 +1670,11 @@ static bool checkSslOperation(SslEndPoint_t*  peer,
             }
         }
 
+        // a rejected resumption must not be offered again
+        if (isClient)
+        {
+            RemoveClientSession(&removedEndpoint);
+        }
         RemovePeerFromList(&removedEndpoint);
 
         oc_mutex_unlock(g_sslContextMutex);
@@ -1226,6 +1701,7 @@ static void DeletePeerList()
         {
             continue;
         }
+        oc_mutex_lock(tep->mutex);
         if (MBEDTLS_SSL_HANDSHAKE_OVER == tep->ssl.state)
         {
             int ret = 0;
@@ -1235,7 +1711,11 @@ static void DeletePeerList()
             }
             while (MBEDTLS_ERR_SSL_WANT_WRITE == ret);
         }
-        DeleteSslEndPoint(tep);
+        tep->removed = true;
+        oc_mutex_unlock(tep->mutex);
+
+        HASH_DEL(g_caSslContext->peerIndex, tep);
+        ReleaseSslPeer(tep);
     }
     u_arraylist_free(&g_caSslContext->peerList);
 }
@@ -1261,13 +1741,15 @@ CAResult_t CAcloseSslConnection(const CAEndpoint_t *endpoint)
     }
     /* No error checking, the connection might be closed already */
     int ret = 0;
+    oc_mutex_lock(tep->mutex);
     do
     {
         ret = mbedtls_ssl_close_notify(&tep->ssl);
     }
     while (MBEDTLS_ERR_SSL_WANT_WRITE == ret);
+    oc_mutex_unlock(tep->mutex);
 
-    RemovePeerFromList(&tep->sep.endpoint);
+    RemoveSslPeer(tep);
     oc_mutex_unlock(g_sslContextMutex);
 
     OIC_LOG_V(DEBUG, NET_SSL_TAG, "Out %s", __func__);
@@ -1314,14 +1796,52 @@ void CAcloseSslConnectionAll(CATransportAdapter_t transportType)
         while (MBEDTLS_ERR_SSL_WANT_WRITE == ret);*/
 
         // delete from list
-        u_arraylist_remove(g_caSslContext->peerList, i - 1);
-        DeleteSslEndPoint(tep);
+        RemoveSslPeer(tep);
     }
     oc_mutex_unlock(g_sslContextMutex);
 
     OIC_LOG_V(DEBUG, NET_SSL_TAG, "Out %s", __func__);
     return;
 }
+
+#if defined(MBEDTLS_SSL_SESSION_TICKETS) && defined(MBEDTLS_SSL_TICKET_C)
+static int SslRandom(void *ctx, unsigned char *buf, size_t len);
+#endif
+
+void CAflushSslSessionCache()
+{
+    OIC_LOG_V(DEBUG, NET_SSL_TAG, "In %s", __func__);
+    oc_mutex_lock(g_sslContextMutex);
+    if (NULL == g_caSslContext)
+    {
+        OIC_LOG(ERROR, NET_SSL_TAG, "Context is NULL");
+        oc_mutex_unlock(g_sslContextMutex);
+        return;
+    }
+
+    DeleteSessionCaches();
+
+    // mbedTLS has no call to empty the cache, the configs keep pointing at the same one.
+    mbedtls_ssl_cache_free(&g_caSslContext->sessionCache);
+    mbedtls_ssl_cache_init(&g_caSslContext->sessionCache);
+    mbedtls_ssl_cache_set_timeout(&g_caSslContext->sessionCache, SSL_SESSION_TIMEOUT_SEC);
+    mbedtls_ssl_cache_set_max_entries(&g_caSslContext->sessionCache, SSL_SESSION_CACHE_MAX);
+
+#if defined(MBEDTLS_SSL_SESSION_TICKETS) && defined(MBEDTLS_SSL_TICKET_C)
+    // new keys, so that tickets issued so far are not accepted anymore
+    mbedtls_ssl_ticket_free(&g_caSslContext->ticketCtx);
+    mbedtls_ssl_ticket_init(&g_caSslContext->ticketCtx);
+    if (0 != mbedtls_ssl_ticket_setup(&g_caSslContext->ticketCtx, SslRandom,
+                                      g_caSslContext, MBEDTLS_CIPHER_AES_128_GCM,
+                                      SSL_SESSION_TIMEOUT_SEC))
+    {
+        OIC_LOG(ERROR, NET_SSL_TAG, "Session ticket setup failed!");
+    }
+#endif
+    oc_mutex_unlock(g_sslContextMutex);
+
+    OIC_LOG_V(DEBUG, NET_SSL_TAG, "Out %s", __func__);
+}
 /**
  * Creates session for endpoint.
  *
@@ -1348,9 +1868,19 @@ static SslEndPoint_t * NewSslEndPoint(const CAEndpoint_t * endpoint, mbedtls_ssl
     tep->sep.endpoint = *endpoint;
     tep->sep.endpoint.flags = (CATransportFlags_t)(tep->sep.endpoint.flags | CA_SECURE);
 
+    // recursive, the handshake callbacks may send to the same peer
+    tep->mutex = oc_mutex_new_recursive();
+    if (NULL == tep->mutex)
+    {
+        OIC_LOG(ERROR, NET_SSL_TAG, "Mutex creation failed!");
+        OICFree(tep);
+        return NULL;
+    }
+
     if(0 != mbedtls_ssl_setup(&tep->ssl, config))
     {
         OIC_LOG(ERROR, NET_SSL_TAG, "Setup failed");
+        oc_mutex_free(tep->mutex);
         OICFree(tep);
         OIC_LOG_V(DEBUG, NET_SSL_TAG, "Out %s", __func__);
         return NULL;
@@ -1368,6 +1898,7 @@ static SslEndPoint_t * NewSslEndPoint(const CAEndpoint_t * endpoint, mbedtls_ssl
             {
                 OIC_LOG(ERROR, NET_SSL_TAG, "Transport id setup failed!");
                 mbedtls_ssl_free(&tep->ssl);
+                oc_mutex_free(tep->mutex);
                 OICFree(tep);
                 OIC_LOG_V(DEBUG, NET_SSL_TAG, "Out %s", __func__);
                 return NULL;
@@ -1379,6 +1910,7 @@ static SslEndPoint_t * NewSslEndPoint(const CAEndpoint_t * endpoint, mbedtls_ssl
     {
         OIC_LOG(ERROR, NET_SSL_TAG, "cacheList initialization failed!");
         mbedtls_ssl_free(&tep->ssl);
+        oc_mutex_free(tep->mutex);
         OICFree(tep);
         OIC_LOG_V(DEBUG, NET_SSL_TAG, "Out %s", __func__);
         return NULL;
@@ -1555,15 +2087,19 @@ static SslEndPoint_t * InitiateTlsHandshake(const CAEndpoint_t *endpoint)
     }
 
     oc_mutex_lock(g_sslContextMutex);
-    ret = u_arraylist_add(g_caSslContext->peerList, (void *) tep);
-    if (!ret)
+    if (!AddPeerToList(tep))
     {
         oc_mutex_unlock(g_sslContextMutex);
-        OIC_LOG(ERROR, NET_SSL_TAG, "u_arraylist_add failed!");
         DeleteSslEndPoint(tep);
         return NULL;
     }
 
+    // the reference keeps tep alive if a failed step removes it
+    RetainSslPeer(tep);
+    oc_mutex_lock(tep->mutex);
+    ApplyClientSession(tep);
+
+    SslEndPoint_t * result = tep;
     while (MBEDTLS_SSL_HANDSHAKE_OVER > tep->ssl.state)
     {
         ret = mbedtls_ssl_handshake_step(&tep->ssl);
@@ -1574,25 +2110,26 @@ static SslEndPoint_t * InitiateTlsHandshake(const CAEndpoint_t *endpoint)
         else if (-1 == ret)
         {
             OIC_LOG(ERROR, NET_SSL_TAG, "Handshake failed due to socket error");
-            RemovePeerFromList(&tep->sep.endpoint);
-            oc_mutex_unlock(g_sslContextMutex);
-            return NULL;
+            RemoveSslPeer(tep);
+            result = NULL;
+            break;
         }
         if (!checkSslOperation(tep,
                                ret,
                                "Handshake error",
                                MBEDTLS_SSL_ALERT_MSG_HANDSHAKE_FAILURE))
         {
-            oc_mutex_unlock(g_sslContextMutex);
-            OIC_LOG_V(DEBUG, NET_SSL_TAG, "Out %s", __func__);
-            DeleteSslEndPoint(tep);
-            return NULL;
+            // checkSslOperation has already removed tep
+            result = NULL;
+            break;
         }
     }
+    oc_mutex_unlock(tep->mutex);
+    ReleaseSslPeer(tep);
 
     oc_mutex_unlock(g_sslContextMutex);
     OIC_LOG_V(DEBUG, NET_SSL_TAG, "Out %s", __func__);
-    return tep;
+    return result;
 }
 #ifdef __WITH_DTLS__
 /**
@@ -1619,6 +2156,11 @@ void CAdeinitSslAdapter()
 
     // Clear all lists
     DeletePeerList();
+    DeleteSessionCaches();
+    mbedtls_ssl_cache_free(&g_caSslContext->sessionCache);
+#if defined(MBEDTLS_SSL_SESSION_TICKETS) && defined(MBEDTLS_SSL_TICKET_C)
+    mbedtls_ssl_ticket_free(&g_caSslContext->ticketCtx);
+#endif
 
     // De-initialize mbedTLS
     mbedtls_x509_crt_free(&g_caSslContext->crt);
@@ -1637,6 +2179,10 @@ void CAdeinitSslAdapter()
 #ifdef __WITH_DTLS__
     StopRetransmit();
 #endif
+    if (NULL != g_caSslContext->rndMutex)
+    {
+        oc_mutex_free(g_caSslContext->rndMutex);
+    }
     // De-initialize tls Context
     OICFree(g_caSslContext);
     g_caSslContext = NULL;
@@ -1649,6 +2195,25 @@ void CAdeinitSslAdapter()
     OIC_LOG_V(DEBUG, NET_SSL_TAG, "Out %s ", __func__);
 }
 
+/**
+ * Random number callback of the configs. Sessions encrypt records in parallel and
+ * draw their IVs from the shared DRBG, which has no lock of its own.
+ *
+ * @param[in]  ctx    SSL context
+ * @param[out] buf    buffer to fill
+ * @param[in]  len    number of bytes
+ *
+ * @return  0 on success
+ */
+static int SslRandom(void *ctx, unsigned char *buf, size_t len)
+{
+    SslContext_t *context = (SslContext_t *) ctx;
+    oc_mutex_lock(context->rndMutex);
+    int ret = mbedtls_ctr_drbg_random(&context->rnd, buf, len);
+    oc_mutex_unlock(context->rndMutex);
+    return ret;
+}
+
 static int InitConfig(mbedtls_ssl_config * conf, int transport, int mode)
 {
     OIC_LOG_V(DEBUG, NET_SSL_TAG, "In %s", __func__);
@@ -1666,10 +2231,20 @@ static int InitConfig(mbedtls_ssl_config * conf, int transport, int mode)
      * time, see extlibs/mbedtls/config-iotivity.h
      */
     mbedtls_ssl_conf_psk_cb(conf, GetPskCredentialsCallback, NULL);
-    mbedtls_ssl_conf_rng(conf, mbedtls_ctr_drbg_random, &g_caSslContext->rnd);
+    mbedtls_ssl_conf_rng(conf, SslRandom, g_caSslContext);
     mbedtls_ssl_conf_curves(conf, curve[ADAPTER_CURVE_SECP256R1]);
     mbedtls_ssl_conf_authmode(conf, MBEDTLS_SSL_VERIFY_REQUIRED);
 
+    if (MBEDTLS_SSL_IS_SERVER == mode)
+    {
+        mbedtls_ssl_conf_session_cache(conf, &g_caSslContext->sessionCache,
+                                       mbedtls_ssl_cache_get, SetServerSessionCache);
+#if defined(MBEDTLS_SSL_SESSION_TICKETS) && defined(MBEDTLS_SSL_TICKET_C)
+        mbedtls_ssl_conf_session_tickets_cb(conf, mbedtls_ssl_ticket_write,
+                                            mbedtls_ssl_ticket_parse, &g_caSslContext->ticketCtx);
+#endif
+    }
+
 #ifdef __WITH_DTLS__
     if (MBEDTLS_SSL_TRANSPORT_DATAGRAM == transport &&
             MBEDTLS_SSL_IS_SERVER == mode)
@@ -1720,9 +2295,17 @@ static void StartRetransmit(void *ctx)
         {
             tep = (SslEndPoint_t *) u_arraylist_get(g_caSslContext->peerList, listIndex);
             if (NULL == tep
-                || (tep->ssl.conf && MBEDTLS_SSL_TRANSPORT_STREAM == tep->ssl.conf->transport)
-                || MBEDTLS_SSL_HANDSHAKE_OVER == tep->ssl.state)
+                || (tep->ssl.conf && MBEDTLS_SSL_TRANSPORT_STREAM == tep->ssl.conf->transport))
+            {
+                continue;
+            }
+
+            RetainSslPeer(tep);
+            oc_mutex_lock(tep->mutex);
+            if (MBEDTLS_SSL_HANDSHAKE_OVER == tep->ssl.state)
             {
+                oc_mutex_unlock(tep->mutex);
+                ReleaseSslPeer(tep);
                 continue;
             }
             int ret = mbedtls_ssl_handshake_step(&tep->ssl);
@@ -1737,10 +2320,14 @@ static void StartRetransmit(void *ctx)
                                        "Retransmission",
                                        MBEDTLS_SSL_ALERT_MSG_HANDSHAKE_FAILURE))
                 {
+                    oc_mutex_unlock(tep->mutex);
+                    ReleaseSslPeer(tep);
                     oc_mutex_unlock(g_sslContextMutex);
                     return;
                 }
             }
+            oc_mutex_unlock(tep->mutex);
+            ReleaseSslPeer(tep);
         }
     }
     //start new timer
@@ -1792,6 +2379,23 @@ CAResult_t CAinitSslAdapter()
         return CA_STATUS_FAILED;
     }
 
+    g_caSslContext->rndMutex = oc_mutex_new();
+
+    mbedtls_ssl_cache_init(&g_caSslContext->sessionCache);
+    mbedtls_ssl_cache_set_timeout(&g_caSslContext->sessionCache, SSL_SESSION_TIMEOUT_SEC);
+    mbedtls_ssl_cache_set_max_entries(&g_caSslContext->sessionCache, SSL_SESSION_CACHE_MAX);
+#if defined(MBEDTLS_SSL_SESSION_TICKETS) && defined(MBEDTLS_SSL_TICKET_C)
+    mbedtls_ssl_ticket_init(&g_caSslContext->ticketCtx);
+#endif
+
+    if (NULL == g_caSslContext->rndMutex)
+    {
+        OIC_LOG(ERROR, NET_SSL_TAG, "Mutex creation failed!");
+        oc_mutex_unlock(g_sslContextMutex);
+        CAdeinitSslAdapter();
+        return CA_MEMORY_ALLOC_FAILED;
+    }
+
     /* Initialize TLS library
      */
 #if !defined(NDEBUG) || defined(TB_LOG)
@@ -1820,6 +2424,18 @@ CAResult_t CAinitSslAdapter()
     }
     mbedtls_ctr_drbg_set_prediction_resistance(&g_caSslContext->rnd, MBEDTLS_CTR_DRBG_PR_ON);
 
+#if defined(MBEDTLS_SSL_SESSION_TICKETS) && defined(MBEDTLS_SSL_TICKET_C)
+    if (0 != mbedtls_ssl_ticket_setup(&g_caSslContext->ticketCtx, SslRandom,
+                                      g_caSslContext, MBEDTLS_CIPHER_AES_128_GCM,
+                                      SSL_SESSION_TIMEOUT_SEC))
+    {
+        OIC_LOG(ERROR, NET_SSL_TAG, "Session ticket setup failed!");
+        oc_mutex_unlock(g_sslContextMutex);
+        CAdeinitSslAdapter();
+        return CA_STATUS_FAILED;
+    }
+#endif
+
 #ifdef __WITH_TLS__
     if (0 != InitConfig(&g_caSslContext->clientTlsConf,
                         MBEDTLS_SSL_TRANSPORT_STREAM, MBEDTLS_SSL_IS_CLIENT))
@@ -1928,12 +2544,62 @@ SslCacheMessage_t *NewCacheMessage(uint8_t * data, size_t dataLen)
     return message;
 }
 
+/**
+ * Writes data to an established session, or caches it until the handshake is over.
+ * Called with the mutex of tep held.
+ *
+ * @param[in]  tep    remote address with session info
+ * @param[in]  data    data to encrypt
+ * @param[in]  dataLen    data length
+ *
+ * @return  CA_STATUS_OK on success, CA_SEND_FAILED if the session has to be removed
+ *          or another error code on failure
+ */
+static CAResult_t WriteSslData(SslEndPoint_t * tep, const void *data, size_t dataLen)
+{
+    if (MBEDTLS_SSL_HANDSHAKE_OVER == tep->ssl.state)
+    {
+        unsigned char *dataBuf = (unsigned char *)data;
+        size_t written = 0;
+
+        do
+        {
+            int ret = mbedtls_ssl_write(&tep->ssl, dataBuf, dataLen - written);
+            if (ret < 0)
+            {
+                if (MBEDTLS_ERR_SSL_WANT_WRITE != ret)
+                {
+                    OIC_LOG_V(ERROR, NET_SSL_TAG, "mbedTLS write failed! returned 0x%x", -ret);
+                    return CA_SEND_FAILED;
+                }
+                continue;
+            }
+            OIC_LOG_V(DEBUG, NET_SSL_TAG, "mbedTLS write returned with sent bytes[%d]", ret);
+
+            dataBuf += ret;
+            written += ret;
+        } while (dataLen > written);
+
+    }
+    else
+    {
+        SslCacheMessage_t * msg = NewCacheMessage((uint8_t*) data, dataLen);
+        if (NULL == msg || !u_arraylist_add(tep->cacheList, (void *) msg))
+        {
+            OIC_LOG(ERROR, NET_SSL_TAG, "u_arraylist_add failed!");
+            DeleteCacheMessage(msg);
+            return CA_STATUS_FAILED;
+        }
+    }
+    return CA_STATUS_OK;
+}
+
 /* Send data via TLS connection.
  */
 CAResult_t CAencryptSsl(const CAEndpoint_t *endpoint,
                         const void *data, size_t dataLen)
 {
-    int ret = 0;
+    CAResult_t res = CA_STATUS_OK;
 
     OIC_LOG_V(DEBUG, NET_SSL_TAG, "In %s ", __func__);
 
@@ -1949,6 +2615,34 @@ CAResult_t CAencryptSsl(const CAEndpoint_t *endpoint,
 
     OIC_LOG_V(DEBUG, NET_SSL_TAG, "Data to be encrypted dataLen [%" PRIuPTR "]", dataLen);
 
+    // Known peer: only its own mutex is taken.
+    SslEndPoint_t * tep = AcquireSslPeer(endpoint);
+    if (NULL != tep)
+    {
+        oc_mutex_lock(tep->mutex);
+        bool removed = tep->removed;
+        if (!removed)
+        {
+            res = WriteSslData(tep, data, dataLen);
+        }
+        oc_mutex_unlock(tep->mutex);
+
+        if (!removed)
+        {
+            if (CA_SEND_FAILED == res)
+            {
+                oc_mutex_lock(g_sslContextMutex);
+                RemoveSslPeer(tep);
+                oc_mutex_unlock(g_sslContextMutex);
+                res = CA_STATUS_FAILED;
+            }
+            ReleaseSslPeer(tep);
+            OIC_LOG_V(DEBUG, NET_SSL_TAG, "Out %s", __func__);
+            return res;
+        }
+        ReleaseSslPeer(tep);
+    }
+
     oc_mutex_lock(g_sslContextMutex);
     if(NULL == g_caSslContext)
     {
@@ -1957,7 +2651,7 @@ CAResult_t CAencryptSsl(const CAEndpoint_t *endpoint,
         return CA_STATUS_FAILED;
     }
 
-    SslEndPoint_t * tep = GetSslPeer(endpoint);
+    tep = GetSslPeer(endpoint);
     if (NULL == tep)
     {
         tep = InitiateTlsHandshake(endpoint);
@@ -1969,47 +2663,19 @@ CAResult_t CAencryptSsl(const CAEndpoint_t *endpoint,
         return CA_STATUS_FAILED;
     }
 
-    if (MBEDTLS_SSL_HANDSHAKE_OVER == tep->ssl.state)
-    {
-        unsigned char *dataBuf = (unsigned char *)data;
-        size_t written = 0;
-
-        do
-        {
-            ret = mbedtls_ssl_write(&tep->ssl, dataBuf, dataLen - written);
-            if (ret < 0)
-            {
-                if (MBEDTLS_ERR_SSL_WANT_WRITE != ret)
-                {
-                    OIC_LOG_V(ERROR, NET_SSL_TAG, "mbedTLS write failed! returned 0x%x", -ret);
-                    RemovePeerFromList(&tep->sep.endpoint);
-                    oc_mutex_unlock(g_sslContextMutex);
-                    return CA_STATUS_FAILED;
-                }
-                continue;
-            }
-            OIC_LOG_V(DEBUG, NET_SSL_TAG, "mbedTLS write returned with sent bytes[%d]", ret);
-
-            dataBuf += ret;
-            written += ret;
-        } while (dataLen > written);
-
-    }
-    else
+    oc_mutex_lock(tep->mutex);
+    res = WriteSslData(tep, data, dataLen);
+    oc_mutex_unlock(tep->mutex);
+    if (CA_SEND_FAILED == res)
     {
-        SslCacheMessage_t * msg = NewCacheMessage((uint8_t*) data, dataLen);
-        if (NULL == msg || !u_arraylist_add(tep->cacheList, (void *) msg))
-        {
-            OIC_LOG(ERROR, NET_SSL_TAG, "u_arraylist_add failed!");
-            oc_mutex_unlock(g_sslContextMutex);
-            return CA_STATUS_FAILED;
-        }
+        RemoveSslPeer(tep);
+        res = CA_STATUS_FAILED;
     }
 
     oc_mutex_unlock(g_sslContextMutex);
 
     OIC_LOG_V(DEBUG, NET_SSL_TAG, "Out %s", __func__);
-    return CA_STATUS_OK;
+    return res;
 }
 /**
  * Sends cached messages via TLS connection.
@@ -2105,58 +2771,19 @@ void CAsetSslHandshakeCallback(CAHandshakeErrorCallback tlsHandshakeCallback)
     OIC_LOG_V(DEBUG, NET_SSL_TAG, "Out %s(%p)", __func__, tlsHandshakeCallback);
 }
 
-/* Read data from TLS connection
+/**
+ * Runs handshake steps on the received record. Called with g_sslContextMutex and
+ * the mutex of peer held.
+ *
+ * @param[in]  peer    remote address with session info
+ * @param[in]  sep    endpoint the record came from
+ *
+ * @return  CA_STATUS_OK on success; other error code on failure
  */
-CAResult_t CAdecryptSsl(const CASecureEndpoint_t *sep, uint8_t *data, size_t dataLen)
+static CAResult_t ContinueSslHandshake(SslEndPoint_t * peer, const CASecureEndpoint_t *sep)
 {
     int ret = 0;
     OIC_LOG_V(DEBUG, NET_SSL_TAG, "In %s", __func__);
-    VERIFY_NON_NULL_RET(sep, NET_SSL_TAG, "endpoint is NULL" , CA_STATUS_INVALID_PARAM);
-    VERIFY_NON_NULL_RET(data, NET_SSL_TAG, "Param data is NULL" , CA_STATUS_INVALID_PARAM);
-
-    oc_mutex_lock(g_sslContextMutex);
-    if (NULL == g_caSslContext)
-    {
-        OIC_LOG(ERROR, NET_SSL_TAG, "Context is NULL");
-        oc_mutex_unlock(g_sslContextMutex);
-        return CA_STATUS_FAILED;
-    }
-
-    SslEndPoint_t * peer = GetSslPeer(&sep->endpoint);
-    if (NULL == peer)
-    {
-        mbedtls_ssl_config * config = (sep->endpoint.adapter == CA_ADAPTER_IP ||
-                                   sep->endpoint.adapter == CA_ADAPTER_GATT_BTLE ?
-                                   &g_caSslContext->serverDtlsConf : &g_caSslContext->serverTlsConf);
-        peer = NewSslEndPoint(&sep->endpoint, config);
-        if (NULL == peer)
-        {
-            OIC_LOG(ERROR, NET_SSL_TAG, "Malloc failed!");
-            oc_mutex_unlock(g_sslContextMutex);
-            return CA_STATUS_FAILED;
-        }
-        //Load allowed TLS suites from SVR DB
-        if(!SetupCipher(config, sep->endpoint.adapter, NULL))
-        {
-            OIC_LOG(ERROR, NET_SSL_TAG, "Failed to set up cipher");
-            DeleteSslEndPoint(peer);
-            oc_mutex_unlock(g_sslContextMutex);
-            return CA_STATUS_FAILED;
-        }
-
-        ret = u_arraylist_add(g_caSslContext->peerList, (void *) peer);
-        if (!ret)
-        {
-            OIC_LOG(ERROR, NET_SSL_TAG, "u_arraylist_add failed!");
-            DeleteSslEndPoint(peer);
-            oc_mutex_unlock(g_sslContextMutex);
-            return CA_STATUS_FAILED;
-        }
-    }
-
-    peer->recBuf.buff = data;
-    peer->recBuf.len = dataLen;
-    peer->recBuf.loaded = 0;
 
     while (MBEDTLS_SSL_HANDSHAKE_OVER != peer->ssl.state)
     {
@@ -2184,7 +2811,6 @@ CAResult_t CAdecryptSsl(const CASecureEndpoint_t *sep, uint8_t *data, size_t dat
                                    "Cert verification failed",
                                    GetAlertCode(flags)))
             {
-                oc_mutex_unlock(g_sslContextMutex);
                 OIC_LOG_V(DEBUG, NET_SSL_TAG, "Out %s", __func__);
                 return CA_STATUS_FAILED;
             }
@@ -2194,7 +2820,6 @@ CAResult_t CAdecryptSsl(const CASecureEndpoint_t *sep, uint8_t *data, size_t dat
                                "Handshake error",
                                MBEDTLS_SSL_ALERT_MSG_HANDSHAKE_FAILURE))
         {
-            oc_mutex_unlock(g_sslContextMutex);
             OIC_LOG_V(DEBUG, NET_SSL_TAG, "Out %s", __func__);
             return CA_STATUS_FAILED;
         }
@@ -2207,7 +2832,6 @@ CAResult_t CAdecryptSsl(const CASecureEndpoint_t *sep, uint8_t *data, size_t dat
                 ret = PeerCertExtractCN(peerCert);
                 if (CA_STATUS_OK != ret)
                 {
-                    oc_mutex_unlock(g_sslContextMutex);
                     OIC_LOG_V(ERROR, NET_SSL_TAG, "ProcessPeerCert failed with %d", ret);
                     OIC_LOG_V(DEBUG, NET_SSL_TAG, "Out %s", __func__);
                     return CA_STATUS_FAILED;
@@ -2227,14 +2851,34 @@ CAResult_t CAdecryptSsl(const CASecureEndpoint_t *sep, uint8_t *data, size_t dat
 
         if (MBEDTLS_SSL_HANDSHAKE_OVER == peer->ssl.state)
         {
+            int selectedCipher = peer->ssl.session->ciphersuite;
+            if (MBEDTLS_SSL_IS_SERVER == peer->ssl.conf->endpoint &&
+                MBEDTLS_TLS_ECDHE_PSK_WITH_AES_128_CBC_SHA256 == selectedCipher)
+            {
+                ret = UpdateServerIdentity(peer);
+                if (0 != ret)
+                {
+                    mbedtls_ssl_send_alert_message(&peer->ssl, MBEDTLS_SSL_ALERT_LEVEL_FATAL,
+                                                   MBEDTLS_SSL_ALERT_MSG_UNKNOWN_PSK_IDENTITY);
+                }
+                if (!checkSslOperation(peer,
+                                       ret,
+                                       "Unknown identity of resumed session",
+                                       MBEDTLS_SSL_ALERT_MSG_UNKNOWN_PSK_IDENTITY))
+                {
+                    OIC_LOG_V(DEBUG, NET_SSL_TAG, "Out %s", __func__);
+                    return CA_STATUS_FAILED;
+                }
+            }
+
             CAResult_t result = notifySubscriber(peer, CA_STATUS_OK);
 
             if (MBEDTLS_SSL_IS_CLIENT == peer->ssl.conf->endpoint)
             {
+                SaveClientSession(peer);
                 SendCacheMessages(peer, result);
             }
 
-            int selectedCipher = peer->ssl.session->ciphersuite;
             OIC_LOG_V(DEBUG, NET_SSL_TAG, "(D)TLS Session is connected via ciphersuite [0x%x]", selectedCipher);
             if (MBEDTLS_TLS_ECDHE_PSK_WITH_AES_128_CBC_SHA256 != selectedCipher &&
                 MBEDTLS_TLS_ECDH_ANON_WITH_AES_128_CBC_SHA256 != selectedCipher)
@@ -2248,7 +2892,6 @@ CAResult_t CAdecryptSsl(const CASecureEndpoint_t *sep, uint8_t *data, size_t dat
                                        "Failed to retrieve cert",
                                        MBEDTLS_SSL_ALERT_MSG_NO_CERT))
                 {
-                    oc_mutex_unlock(g_sslContextMutex);
                     OIC_LOG_V(DEBUG, NET_SSL_TAG, "Out %s", __func__);
                     return CA_STATUS_FAILED;
                 }
@@ -2261,7 +2904,6 @@ CAResult_t CAdecryptSsl(const CASecureEndpoint_t *sep, uint8_t *data, size_t dat
                 if (ret <= 0)
                 {
                     OIC_LOG_V(ERROR, NET_SSL_TAG, "Failed to copy public key of remote peer: -0x%x", ret);
-                    oc_mutex_unlock(g_sslContextMutex);
                     OIC_LOG_V(DEBUG, NET_SSL_TAG, "Out %s", __func__);
                     return CA_STATUS_FAILED;
                 }
@@ -2269,7 +2911,6 @@ CAResult_t CAdecryptSsl(const CASecureEndpoint_t *sep, uint8_t *data, size_t dat
                 {
                     assert(!"publicKey field of CASecureEndpoint_t is too small for the public key!");
                     OIC_LOG(ERROR, NET_SSL_TAG, "Public key of remote peer was too large");
-                    oc_mutex_unlock(g_sslContextMutex);
                     OIC_LOG_V(DEBUG, NET_SSL_TAG, "Out %s", __func__);
                     return CA_STATUS_FAILED;
                 }
@@ -2316,7 +2957,6 @@ CAResult_t CAdecryptSsl(const CASecureEndpoint_t *sep, uint8_t *data, size_t dat
                                                "Failed to convert subject",
                                                MBEDTLS_SSL_ALERT_MSG_UNSUPPORTED_CERT))
                         {
-                            oc_mutex_unlock(g_sslContextMutex);
                             OIC_LOG_V(DEBUG, NET_SSL_TAG, "Out %s", __func__);
                             return CA_STATUS_FAILED;
                         }
@@ -2341,7 +2981,6 @@ CAResult_t CAdecryptSsl(const CASecureEndpoint_t *sep, uint8_t *data, size_t dat
                                                "Failed to convert subject alt name",
                                                MBEDTLS_SSL_ALERT_MSG_UNSUPPORTED_CERT))
                         {
-                            oc_mutex_unlock(g_sslContextMutex);
                             OIC_LOG_V(DEBUG, NET_SSL_TAG, "Out %s", __func__);
                             return CA_STATUS_FAILED;
                         }
@@ -2359,60 +2998,196 @@ CAResult_t CAdecryptSsl(const CASecureEndpoint_t *sep, uint8_t *data, size_t dat
                 peer->sep.publicKeyLength = 0;
             }
 
-            oc_mutex_unlock(g_sslContextMutex);
             OIC_LOG_V(DEBUG, NET_SSL_TAG, "Out %s", __func__);
             return CA_STATUS_OK;
         }
     }
 
-    if (MBEDTLS_SSL_HANDSHAKE_OVER == peer->ssl.state)
+    OIC_LOG_V(DEBUG, NET_SSL_TAG, "Out %s", __func__);
+    return CA_STATUS_OK;
+}
+
+/**
+ * Decrypts the record received by an established session. Called with the mutex
+ * of peer held.
+ *
+ * @param[in]  peer    remote address with session info
+ * @param[out] buf    decrypted data
+ * @param[in]  bufLen    size of buf
+ *
+ * @return  length of the decrypted data or mbedTLS error code. Any close_notify
+ *          alert is reported as MBEDTLS_ERR_SSL_PEER_CLOSE_NOTIFY.
+ */
+static int ReadSslData(SslEndPoint_t * peer, uint8_t *buf, size_t bufLen)
+{
+    int ret = 0;
+    do
+    {
+        ret = mbedtls_ssl_read(&peer->ssl, buf, bufLen);
+    } while (MBEDTLS_ERR_SSL_WANT_READ == ret);
+
+    // TinyDTLS sends fatal close_notify alert
+    if (MBEDTLS_ERR_SSL_FATAL_ALERT_MESSAGE == ret &&
+        MBEDTLS_SSL_ALERT_LEVEL_FATAL == peer->ssl.in_msg[0] &&
+        MBEDTLS_SSL_ALERT_MSG_CLOSE_NOTIFY == peer->ssl.in_msg[1])
     {
-        uint8_t decryptBuffer[TLS_MSG_BUF_LEN] = {0};
-        do
+        ret = MBEDTLS_ERR_SSL_PEER_CLOSE_NOTIFY;
+    }
+    return ret;
+}
+
+/**
+ * Passes the result of ReadSslData() to the adapter. Called without the mutex
+ * of peer, so that the callbacks may use the session again.
+ *
+ * @param[in]  peer    remote address with session info
+ * @param[in]  ret    result of ReadSslData()
+ * @param[in]  buf    decrypted data
+ * @param[in]  data    received record
+ * @param[in]  dataLen    record length
+ *
+ * @return  CA_STATUS_OK on success; other error code on failure
+ */
+static CAResult_t DeliverSslData(SslEndPoint_t * peer, int ret, const uint8_t *buf,
+                                 uint8_t *data, size_t dataLen)
+{
+    if (MBEDTLS_ERR_SSL_PEER_CLOSE_NOTIFY == ret)
+    {
+        OIC_LOG(INFO, NET_SSL_TAG, "Connection was closed gracefully");
+        oc_mutex_lock(g_sslContextMutex);
+        RemoveSslPeer(peer);
+        oc_mutex_unlock(g_sslContextMutex);
+        return CA_STATUS_OK;
+    }
+
+    int adapterIndex = GetAdapterIndex(peer->sep.endpoint.adapter);
+    SslCallbacks_t callbacks;
+    if (adapterIndex < 0)
+    {
+        OIC_LOG(ERROR, NET_SSL_TAG, "Unsuported adapter");
+        oc_mutex_lock(g_sslContextMutex);
+        RemoveSslPeer(peer);
+        oc_mutex_unlock(g_sslContextMutex);
+        return CA_STATUS_FAILED;
+    }
+    if (!GetAdapterCallbacks(adapterIndex, &callbacks))
+    {
+        OIC_LOG(ERROR, NET_SSL_TAG, "SSL Context is NULL");
+        return CA_STATUS_FAILED;
+    }
+
+    if (0 > ret)
+    {
+        OIC_LOG_V(ERROR, NET_SSL_TAG, "mbedtls_ssl_read returned -0x%x", -ret);
+        callbacks.errorCallback(&peer->sep.endpoint, data, dataLen, CA_STATUS_FAILED);
+        oc_mutex_lock(g_sslContextMutex);
+        if (NULL != g_caSslContext && MBEDTLS_SSL_IS_CLIENT == peer->ssl.conf->endpoint)
         {
-            ret = mbedtls_ssl_read(&peer->ssl, decryptBuffer, TLS_MSG_BUF_LEN);
-        } while (MBEDTLS_ERR_SSL_WANT_READ == ret);
-
-        if (MBEDTLS_ERR_SSL_PEER_CLOSE_NOTIFY == ret ||
-            // TinyDTLS sends fatal close_notify alert
-            (MBEDTLS_ERR_SSL_FATAL_ALERT_MESSAGE == ret &&
-             MBEDTLS_SSL_ALERT_LEVEL_FATAL == peer->ssl.in_msg[0] &&
-             MBEDTLS_SSL_ALERT_MSG_CLOSE_NOTIFY == peer->ssl.in_msg[1]))
+            RemoveClientSession(&peer->sep.endpoint);
+        }
+        RemoveSslPeer(peer);
+        oc_mutex_unlock(g_sslContextMutex);
+        return CA_STATUS_FAILED;
+    }
+    else if (0 < ret)
+    {
+        callbacks.recvCallback(&peer->sep, buf, ret);
+    }
+    return CA_STATUS_OK;
+}
+
+/* Read data from TLS connection
+ */
+CAResult_t CAdecryptSsl(const CASecureEndpoint_t *sep, uint8_t *data, size_t dataLen)
+{
+    CAResult_t res = CA_STATUS_OK;
+    uint8_t decryptBuffer[TLS_MSG_BUF_LEN] = {0};
+    OIC_LOG_V(DEBUG, NET_SSL_TAG, "In %s", __func__);
+    VERIFY_NON_NULL_RET(sep, NET_SSL_TAG, "endpoint is NULL" , CA_STATUS_INVALID_PARAM);
+    VERIFY_NON_NULL_RET(data, NET_SSL_TAG, "Param data is NULL" , CA_STATUS_INVALID_PARAM);
+
+    // Record of an established session: only the mutex of its peer is taken.
+    SslEndPoint_t * peer = AcquireSslPeer(&sep->endpoint);
+    if (NULL != peer)
+    {
+        oc_mutex_lock(peer->mutex);
+        if (!peer->removed && MBEDTLS_SSL_HANDSHAKE_OVER == peer->ssl.state)
         {
-            OIC_LOG(INFO, NET_SSL_TAG, "Connection was closed gracefully");
-            RemovePeerFromList(&peer->sep.endpoint);
-            oc_mutex_unlock(g_sslContextMutex);
-            return CA_STATUS_OK;
+            peer->recBuf.buff = data;
+            peer->recBuf.len = dataLen;
+            peer->recBuf.loaded = 0;
+            int ret = ReadSslData(peer, decryptBuffer, sizeof(decryptBuffer));
+            oc_mutex_unlock(peer->mutex);
+
+            res = DeliverSslData(peer, ret, decryptBuffer, data, dataLen);
+            ReleaseSslPeer(peer);
+            OIC_LOG_V(DEBUG, NET_SSL_TAG, "Out %s", __func__);
+            return res;
         }
+        oc_mutex_unlock(peer->mutex);
+        ReleaseSslPeer(peer);
+    }
 
-        int adapterIndex = GetAdapterIndex(peer->sep.endpoint.adapter);
-        if (adapterIndex >= 0)
+    oc_mutex_lock(g_sslContextMutex);
+    if (NULL == g_caSslContext)
+    {
+        OIC_LOG(ERROR, NET_SSL_TAG, "Context is NULL");
+        oc_mutex_unlock(g_sslContextMutex);
+        return CA_STATUS_FAILED;
+    }
+
+    peer = GetSslPeer(&sep->endpoint);
+    if (NULL == peer)
+    {
+        mbedtls_ssl_config * config = (sep->endpoint.adapter == CA_ADAPTER_IP ||
+                                   sep->endpoint.adapter == CA_ADAPTER_GATT_BTLE ?
+                                   &g_caSslContext->serverDtlsConf : &g_caSslContext->serverTlsConf);
+        peer = NewSslEndPoint(&sep->endpoint, config);
+        if (NULL == peer)
         {
-            if (0 > ret)
-            {
-                OIC_LOG_V(ERROR, NET_SSL_TAG, "mbedtls_ssl_read returned -0x%x", -ret);
-                g_caSslContext->adapterCallbacks[adapterIndex].errorCallback(&peer->sep.endpoint, peer->recBuf.buff, peer->recBuf.len, CA_STATUS_FAILED);
-                RemovePeerFromList(&peer->sep.endpoint);
-                oc_mutex_unlock(g_sslContextMutex);
-                return CA_STATUS_FAILED;
-            }
-            else if (0 < ret)
-            {
-                g_caSslContext->adapterCallbacks[adapterIndex].recvCallback(&peer->sep, decryptBuffer, ret);
-            }
+            OIC_LOG(ERROR, NET_SSL_TAG, "Malloc failed!");
+            oc_mutex_unlock(g_sslContextMutex);
+            return CA_STATUS_FAILED;
         }
-        else
+        //Load allowed TLS suites from SVR DB
+        if(!SetupCipher(config, sep->endpoint.adapter, NULL))
+        {
+            OIC_LOG(ERROR, NET_SSL_TAG, "Failed to set up cipher");
+            DeleteSslEndPoint(peer);
+            oc_mutex_unlock(g_sslContextMutex);
+            return CA_STATUS_FAILED;
+        }
+
+        if (!AddPeerToList(peer))
         {
-            OIC_LOG(ERROR, NET_SSL_TAG, "Unsuported adapter");
-            RemovePeerFromList(&peer->sep.endpoint);
+            DeleteSslEndPoint(peer);
             oc_mutex_unlock(g_sslContextMutex);
             return CA_STATUS_FAILED;
         }
     }
 
+    RetainSslPeer(peer);
+    oc_mutex_lock(peer->mutex);
+    peer->recBuf.buff = data;
+    peer->recBuf.len = dataLen;
+    peer->recBuf.loaded = 0;
+
+    if (MBEDTLS_SSL_HANDSHAKE_OVER != peer->ssl.state)
+    {
+        res = ContinueSslHandshake(peer, sep);
+        oc_mutex_unlock(peer->mutex);
+    }
+    else
+    {
+        int ret = ReadSslData(peer, decryptBuffer, sizeof(decryptBuffer));
+        oc_mutex_unlock(peer->mutex);
+        res = DeliverSslData(peer, ret, decryptBuffer, data, dataLen);
+    }
+    ReleaseSslPeer(peer);
+
     oc_mutex_unlock(g_sslContextMutex);
     OIC_LOG_V(DEBUG, NET_SSL_TAG, "Out %s", __func__);
-    return CA_STATUS_OK;
+    return res;
 }
 
 void CAsetSslAdapterCallbacks(CAPacketReceivedCallback recvCallback,
@@ -2559,6 +3334,10 @@ CAResult_t CAinitiateSslHandshake(const CAEndpoint_t *endpoint)
         }
     }
 
+    // An explicit handshake is used for ownership transfer and after credential
+    // changes, so it always negotiates a new session.
+    RemoveClientSession(endpoint);
+
     if (NULL == InitiateTlsHandshake(endpoint))
     {
         OIC_LOG(ERROR, NET_SSL_TAG, "TLS handshake failed");
@@ -505,6 +505,25 @@ CAResult_t CAHandleRequestResponse()
     return CA_STATUS_OK;
 }
 
+CAResult_t CAWaitRequestResponse(uint64_t timeoutUs)
+{
+    if (!g_isInitialized)
+    {
+        OIC_LOG(ERROR, TAG, "not initialized");
+        return CA_STATUS_NOT_INITIALIZED;
+    }
+
+    return CAWaitRequestResponseCallbacks(timeoutUs) ? CA_STATUS_OK : CA_STATUS_FAILED;
+}
+
+void CACancelWaitRequestResponse()
+{
+    if (g_isInitialized)
+    {
+        CACancelWaitRequestResponseCallbacks();
+    }
+}
+
 CAResult_t CASelectCipherSuite(const uint16_t cipher, CATransportAdapter_t adapter)
 {
     (void)(adapter); // prevent unused-parameter warning when building release variant
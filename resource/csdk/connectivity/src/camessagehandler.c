@@ -38,6 +38,7 @@
 #include "cainterfacecontroller.h"
 #include "caretransmission.h"
 #include "oic_string.h"
+#include "umempool.h"
 
 #ifdef WITH_BWT
 #include "cablockwisetransfer.h"
@@ -52,8 +53,14 @@
 #include "caconnectionmanager.h"
 #endif
 #define SINGLE_HANDLE
+// workers for the short tasks, the adapter and queueing loops run on their own threads
 #define MAX_THREAD_POOL_SIZE    20
 
+// bound of the send and receive queues
+#define MESSAGE_QUEUE_CAPACITY          1024
+// time a producer waits for room in a full queue before the message is dropped
+#define MESSAGE_QUEUE_FULL_WAIT_US      (100 * 1000)
+
 // thread pool handle
 static ca_thread_pool_t g_threadPoolHandle = NULL;
 
@@ -75,6 +82,12 @@ static CAResponseCallback g_responseHandler = NULL;
 static CAErrorCallback g_errorHandler = NULL;
 static CANetworkMonitorCallback g_nwMonitorHandler = NULL;
 
+// most freed CAData_t kept for the next message
+#define DATA_POOL_CAPACITY      64
+
+// every queued message is a CAData_t from here once the handler is initialized
+static u_mem_pool_t *g_dataPool = NULL;
+
 static void CAErrorHandler(const CAEndpoint_t *endpoint,
                            const void *data, size_t dataLen,
                            CAResult_t result);
@@ -101,6 +114,17 @@ static bool CADropSecondMessage(CAHistory_t *history, const CAEndpoint_t *endpoi
  */
 static void CALogPDUInfo(const CAData_t *data, const coap_pdu_t *pdu);
 
+static CAData_t *CAAllocData()
+{
+    return g_dataPool ? (CAData_t *) u_mem_pool_calloc(g_dataPool)
+                      : (CAData_t *) OICCalloc(1, sizeof(CAData_t));
+}
+
+static void CAFreeData(CAData_t *data)
+{
+    u_mem_pool_free(g_dataPool, data);
+}
+
 #ifdef WITH_BWT
 void CAAddDataToSendThread(CAData_t *data)
 {
@@ -137,7 +161,7 @@ static CAData_t* CAGenerateHandlerData(const CAEndpoint_t *endpoint,
 {
     OIC_LOG(DEBUG, TAG, "CAGenerateHandlerData IN");
     CAInfo_t *info = NULL;
-    CAData_t *cadata = (CAData_t *) OICCalloc(1, sizeof(CAData_t));
+    CAData_t *cadata = CAAllocData();
     if (!cadata)
     {
         OIC_LOG(ERROR, TAG, "memory allocation failed");
@@ -254,7 +278,7 @@ static CAData_t* CAGenerateHandlerData(const CAEndpoint_t *endpoint,
     return cadata;
 
 exit:
-    OICFree(cadata);
+    CAFreeData(cadata);
 #ifndef SINGLE_THREAD
     CAFreeEndpoint(ep);
 #endif
@@ -303,7 +327,7 @@ static void CATimeoutCallback(const CAEndpoint_t *endpoint, const void *pdu, uin
         return;
     }
 
-    CAData_t *cadata = (CAData_t *) OICCalloc(1, sizeof(CAData_t));
+    CAData_t *cadata = CAAllocData();
     if (NULL == cadata)
     {
         OIC_LOG(ERROR, TAG, "memory allocation failed !");
@@ -374,7 +398,7 @@ static void CADestroyData(void *data, uint32_t size)
         CADestroyErrorInfoInternal(cadata->errorInfo);
     }
 
-    OICFree(cadata);
+    CAFreeData(cadata);
     OIC_LOG(DEBUG, TAG, "CADestroyData OUT");
 }
 
@@ -495,13 +519,13 @@ static CAResult_t CAProcessMulticastData(const CAData_t *data)
     }
 
     coap_delete_list(options);
-    coap_delete_pdu(pdu);
+    CADeletePDU(pdu);
     return res;
 
 exit:
     CAErrorHandler(data->remoteEndpoint, pdu->transport_hdr, pdu->length, res);
     coap_delete_list(options);
-    coap_delete_pdu(pdu);
+    CADeletePDU(pdu);
     return res;
 }
 
@@ -574,7 +598,7 @@ static CAResult_t CAProcessSendData(const CAData_t *data)
                         OIC_LOG(INFO, TAG, "to write block option has failed");
                         CAErrorHandler(data->remoteEndpoint, pdu->transport_hdr, pdu->length, res);
                         coap_delete_list(options);
-                        coap_delete_pdu(pdu);
+                        CADeletePDU(pdu);
                         return res;
                     }
                 }
@@ -589,7 +613,7 @@ static CAResult_t CAProcessSendData(const CAData_t *data)
                 OIC_LOG_V(ERROR, TAG, "send failed:%d", res);
                 CAErrorHandler(data->remoteEndpoint, pdu->transport_hdr, pdu->length, res);
                 coap_delete_list(options);
-                coap_delete_pdu(pdu);
+                CADeletePDU(pdu);
                 return res;
             }
 
@@ -614,13 +638,13 @@ static CAResult_t CAProcessSendData(const CAData_t *data)
                     //when retransmission not supported this will return CA_NOT_SUPPORTED, ignore
                     OIC_LOG_V(INFO, TAG, "retransmission is not enabled due to error, res : %d", res);
                     coap_delete_list(options);
-                    coap_delete_pdu(pdu);
+                    CADeletePDU(pdu);
                     return res;
                 }
             }
 
             coap_delete_list(options);
-            coap_delete_pdu(pdu);
+            CADeletePDU(pdu);
         }
         else
         {
@@ -767,7 +791,7 @@ static void CAReceivedPacketCallback(const CASecureEndpoint_t *sep,
         if (!cadata)
         {
             OIC_LOG(ERROR, TAG, "CAReceivedPacketCallback, CAGenerateHandlerData failed!");
-            coap_delete_pdu(pdu);
+            CADeletePDU(pdu);
             goto exit;
         }
     }
@@ -777,7 +801,7 @@ static void CAReceivedPacketCallback(const CASecureEndpoint_t *sep,
         if (!cadata)
         {
             OIC_LOG(ERROR, TAG, "CAReceivedPacketCallback, CAGenerateHandlerData failed!");
-            coap_delete_pdu(pdu);
+            CADeletePDU(pdu);
             goto exit;
         }
 
@@ -842,7 +866,7 @@ static void CAReceivedPacketCallback(const CASecureEndpoint_t *sep,
     }
 #endif // SINGLE_THREAD
 
-    coap_delete_pdu(pdu);
+    CADeletePDU(pdu);
 
 exit:
     OIC_LOG(DEBUG, TAG, "received pdu data :");
@@ -862,19 +886,15 @@ void CAHandleRequestResponseCallbacks()
     // #1 parse the data
     // #2 get endpoint
 
-    oc_mutex_lock(g_receiveThread.threadMutex);
-
-    u_queue_message_t *item = u_queue_get_element(g_receiveThread.dataQueue);
-
-    oc_mutex_unlock(g_receiveThread.threadMutex);
-
-    if (NULL == item || NULL == item->msg)
+    void *msg = NULL;
+    uint32_t size = 0;
+    if (!CAQueueingThreadGetData(&g_receiveThread, &msg, &size) || NULL == msg)
     {
         return;
     }
 
     // get endpoint
-    CAData_t *td = (CAData_t *) item->msg;
+    CAData_t *td = (CAData_t *) msg;
 
     if (td->requestInfo && g_requestHandler)
     {
@@ -892,19 +912,36 @@ void CAHandleRequestResponseCallbacks()
         g_errorHandler(td->remoteEndpoint, td->errorInfo);
     }
 
-    CADestroyData(item->msg, sizeof(CAData_t));
-    OICFree(item);
+    CADestroyData(msg, size);
 
 #endif // SINGLE_HANDLE
 #endif // SINGLE_THREAD
 }
 
+bool CAWaitRequestResponseCallbacks(uint64_t timeoutUs)
+{
+#if defined(SINGLE_THREAD) || !defined(SINGLE_HANDLE)
+    // Nothing is queued for CAHandleRequestResponseCallbacks.
+    (void)timeoutUs;
+    return true;
+#else
+    return CAQueueingThreadWaitData(&g_receiveThread, timeoutUs);
+#endif
+}
+
+void CACancelWaitRequestResponseCallbacks()
+{
+#if !defined(SINGLE_THREAD) && defined(SINGLE_HANDLE)
+    CAQueueingThreadCancelWait(&g_receiveThread);
+#endif
+}
+
 static CAData_t* CAPrepareSendData(const CAEndpoint_t *endpoint, const void *sendData,
                                    CADataType_t dataType)
 {
     OIC_LOG(DEBUG, TAG, "CAPrepareSendData IN");
 
-    CAData_t *cadata = (CAData_t *) OICCalloc(1, sizeof(CAData_t));
+    CAData_t *cadata = CAAllocData();
     if (!cadata)
     {
         OIC_LOG(ERROR, TAG, "memory allocation failed");
@@ -967,7 +1004,7 @@ exit:
 #ifndef SINGLE_THREAD
     CADestroyData(cadata, sizeof(CAData_t));
 #else
-    OICFree(cadata);
+    CAFreeData(cadata);
 #endif
     return NULL;
 }
@@ -985,7 +1022,7 @@ CAResult_t CADetachSendMessage(const CAEndpoint_t *endpoint, const void *sendMsg
 
 #ifdef ARDUINO
     // If max retransmission queue is reached, then don't handle new request
-    if (CA_MAX_RT_ARRAY_SIZE == u_arraylist_length(g_retransmissionContext.dataList))
+    if (CA_MAX_RT_ARRAY_SIZE == g_retransmissionContext.dataCount)
     {
         OIC_LOG(ERROR, TAG, "max RT queue size reached!");
         return CA_SEND_FAILED;
@@ -1014,19 +1051,18 @@ CAResult_t CADetachSendMessage(const CAEndpoint_t *endpoint, const void *sendMsg
     if (CA_STATUS_OK != result)
     {
         OIC_LOG(ERROR, TAG, "CAProcessSendData failed");
-        OICFree(data);
+        CAFreeData(data);
         return result;
     }
 
-    OICFree(data);
+    CAFreeData(data);
 
 #else
     if (SEND_TYPE_UNICAST == data->type && CAIsLocalEndpoint(data->remoteEndpoint))
     {
         OIC_LOG(DEBUG, TAG,
                 "This is a loopback message. Transfer it to the receive queue directly");
-        CAQueueingThreadAddData(&g_receiveThread, data, sizeof(CAData_t));
-        return CA_STATUS_OK;
+        return CAQueueingThreadAddData(&g_receiveThread, data, sizeof(CAData_t));
     }
 #ifdef WITH_BWT
     if (CAIsSupportedBlockwiseTransfer(endpoint->adapter))
@@ -1036,8 +1072,7 @@ CAResult_t CADetachSendMessage(const CAEndpoint_t *endpoint, const void *sendMsg
         if (CA_NOT_SUPPORTED == res)
         {
             OIC_LOG(DEBUG, TAG, "normal msg will be sent");
-            CAQueueingThreadAddData(&g_sendThread, data, sizeof(CAData_t));
-            return CA_STATUS_OK;
+            return CAQueueingThreadAddData(&g_sendThread, data, sizeof(CAData_t));
         }
         else
         {
@@ -1048,7 +1083,7 @@ CAResult_t CADetachSendMessage(const CAEndpoint_t *endpoint, const void *sendMsg
     else
 #endif // WITH_BWT
     {
-        CAQueueingThreadAddData(&g_sendThread, data, sizeof(CAData_t));
+        return CAQueueingThreadAddData(&g_sendThread, data, sizeof(CAData_t));
     }
 #endif // SINGLE_THREAD
 
@@ -1074,6 +1109,14 @@ CAResult_t CAInitializeMessageHandler(CATransportAdapter_t transportType)
     CASetErrorHandleCallback(CAErrorHandler);
 
 #ifndef SINGLE_THREAD
+    // without the pools messages are allocated one by one, so a failure is not fatal
+    if (NULL == g_dataPool)
+    {
+        g_dataPool = u_mem_pool_create(sizeof(CAData_t), DATA_POOL_CAPACITY);
+    }
+    CAInitializeEndpointPool();
+    CAInitializePDUPool();
+
     // create thread pool
     CAResult_t res = ca_thread_pool_init(MAX_THREAD_POOL_SIZE, &g_threadPoolHandle);
     if (CA_STATUS_OK != res)
@@ -1083,8 +1126,9 @@ CAResult_t CAInitializeMessageHandler(CATransportAdapter_t transportType)
     }
 
     // send thread initialize
-    res = CAQueueingThreadInitialize(&g_sendThread, g_threadPoolHandle,
-                                     CASendThreadProcess, CADestroyData);
+    res = CAQueueingThreadInitializeBounded(&g_sendThread, g_threadPoolHandle,
+                                            CASendThreadProcess, CADestroyData,
+                                            MESSAGE_QUEUE_CAPACITY, MESSAGE_QUEUE_FULL_WAIT_US);
     if (CA_STATUS_OK != res)
     {
         OIC_LOG(ERROR, TAG, "Failed to Initialize send queue thread");
@@ -1100,8 +1144,9 @@ CAResult_t CAInitializeMessageHandler(CATransportAdapter_t transportType)
     }
 
     // receive thread initialize
-    res = CAQueueingThreadInitialize(&g_receiveThread, g_threadPoolHandle,
-                                     CAReceiveThreadProcess, CADestroyData);
+    res = CAQueueingThreadInitializeBounded(&g_receiveThread, g_threadPoolHandle,
+                                            CAReceiveThreadProcess, CADestroyData,
+                                            MESSAGE_QUEUE_CAPACITY, MESSAGE_QUEUE_FULL_WAIT_US);
     if (CA_STATUS_OK != res)
     {
         OIC_LOG(ERROR, TAG, "Failed to Initialize receive queue thread");
@@ -1212,6 +1257,11 @@ void CATerminateMessageHandler()
 
     // terminate interface adapters by controller
     CATerminateAdapters();
+
+    // the pools stay, other threads may still free endpoints into them
+    u_mem_pool_trim(g_dataPool);
+    CATerminateEndpointPool();
+    CATerminatePDUPool();
 #else
     // terminate interface adapters by controller
     CATerminateAdapters();
@@ -1285,7 +1335,7 @@ void CAErrorHandler(const CAEndpoint_t *endpoint,
     if (!cadata)
     {
         OIC_LOG(ERROR, TAG, "CAErrorHandler, CAGenerateHandlerData failed!");
-        coap_delete_pdu(pdu);
+        CADeletePDU(pdu);
         return;
     }
 
@@ -1326,7 +1376,7 @@ void CAErrorHandler(const CAEndpoint_t *endpoint,
     cadata->errorInfo->result = result;
 
     CAQueueingThreadAddData(&g_receiveThread, cadata, sizeof(CAData_t));
-    coap_delete_pdu(pdu);
+    CADeletePDU(pdu);
 #else
     (void)result;
 #endif
@@ -1339,7 +1389,7 @@ static void CASendErrorInfo(const CAEndpoint_t *endpoint, const CAInfo_t *info,
 {
     OIC_LOG(DEBUG, TAG, "CASendErrorInfo IN");
 #ifndef SINGLE_THREAD
-    CAData_t *cadata = (CAData_t *) OICCalloc(1, sizeof(CAData_t));
+    CAData_t *cadata = CAAllocData();
     if (!cadata)
     {
         OIC_LOG(ERROR, TAG, "cadata memory allocation failed");
@@ -1350,7 +1400,7 @@ static void CASendErrorInfo(const CAEndpoint_t *endpoint, const CAInfo_t *info,
     if (!ep)
     {
         OIC_LOG(ERROR, TAG, "endpoint clone failed");
-        OICFree(cadata);
+        CAFreeData(cadata);
         return;
     }
 
@@ -1358,7 +1408,7 @@ static void CASendErrorInfo(const CAEndpoint_t *endpoint, const CAInfo_t *info,
     if (!errorInfo)
     {
         OIC_LOG(ERROR, TAG, "errorInfo memory allocation failed");
-        OICFree(cadata);
+        CAFreeData(cadata);
         CAFreeEndpoint(ep);
         return;
     }
@@ -1367,7 +1417,7 @@ static void CASendErrorInfo(const CAEndpoint_t *endpoint, const CAInfo_t *info,
     if (CA_STATUS_OK != res)
     {
         OIC_LOG(ERROR, TAG, "info clone failed");
-        OICFree(cadata);
+        CAFreeData(cadata);
         OICFree(errorInfo);
         CAFreeEndpoint(ep);
         return;
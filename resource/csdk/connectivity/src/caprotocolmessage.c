@@ -44,16 +44,69 @@
 #include "experimental/ocrandom.h"
 #include "cacommonutil.h"
 #include "cablockwisetransfer.h"
+#include "umempool.h"
 
 #define TAG "OIC_CA_PRTCL_MSG"
 
 #define CA_PDU_MIN_SIZE (4)
 #define CA_ENCODE_BUFFER_SIZE (4)
 
+/**
+ * Most freed PDUs kept for reuse.
+ */
+#define PDU_POOL_CAPACITY (16)
+
 static const char COAP_URI_HEADER[] = "coap://[::]/";
 
 static char g_chproxyUri[CA_MAX_URI_LENGTH];
 
+/**
+ * UDP PDUs with room for COAP_MAX_PDU_SIZE bytes. Every UDP message is built
+ * in one of these and every received UDP message is parsed into one. TCP PDUs
+ * are sized to their message and are not pooled.
+ */
+static u_mem_pool_t *g_pduPool = NULL;
+
+void CAInitializePDUPool(void)
+{
+    if (NULL == g_pduPool)
+    {
+        g_pduPool = u_mem_pool_create(sizeof(coap_pdu_t) + COAP_MAX_PDU_SIZE, PDU_POOL_CAPACITY);
+    }
+}
+
+void CATerminatePDUPool(void)
+{
+    u_mem_pool_trim(g_pduPool);
+}
+
+static coap_pdu_t *CAInitPDU(size_t size, coap_transport_t transport)
+{
+    if (NULL == g_pduPool || COAP_UDP != transport || COAP_MAX_PDU_SIZE < size)
+    {
+        return coap_pdu_init2(0, 0, ntohs((unsigned short)COAP_INVALID_TID), size, transport);
+    }
+
+    coap_pdu_t *pdu = (coap_pdu_t *) u_mem_pool_alloc(g_pduPool);
+    if (pdu)
+    {
+        coap_pdu_clear2(pdu, COAP_MAX_PDU_SIZE, transport, 0);
+        pdu->transport_hdr->udp.id = ntohs((unsigned short)COAP_INVALID_TID);
+    }
+    return pdu;
+}
+
+void CADeletePDU(coap_pdu_t *pdu)
+{
+    // coap_pdu_init2 allocates sizeof(coap_pdu_t) + max_size as well
+    if (g_pduPool && pdu && COAP_MAX_PDU_SIZE == pdu->max_size)
+    {
+        u_mem_pool_free(g_pduPool, pdu);
+        return;
+    }
+    coap_delete_pdu(pdu);
+}
+
 CAResult_t CASetProxyUri(const char *uri)
 {
     VERIFY_NON_NULL(uri, TAG, "uri");
@@ -199,8 +252,7 @@ coap_pdu_t *CAParsePDU(const char *data, size_t length, uint32_t *outCode,
     }
 #endif
 
-    coap_pdu_t *outpdu =
-        coap_pdu_init2(0, 0, ntohs((unsigned short)COAP_INVALID_TID), length, transport);
+    coap_pdu_t *outpdu = CAInitPDU(length, transport);
     if (NULL == outpdu)
     {
         OIC_LOG(ERROR, TAG, "outpdu is null");
@@ -250,7 +302,7 @@ coap_pdu_t *CAParsePDU(const char *data, size_t length, uint32_t *outCode,
 exit:
     OIC_LOG(DEBUG, TAG, "data :");
     OIC_LOG_BUFFER(DEBUG, TAG,  (const uint8_t *)data, length);
-    coap_delete_pdu(outpdu);
+    CADeletePDU(outpdu);
     return NULL;
 }
 
@@ -311,9 +363,7 @@ coap_pdu_t *CAGeneratePDUImpl(code_t code, const CAInfo_t *info,
         *transport = COAP_UDP;
     }
 
-    coap_pdu_t *pdu = coap_pdu_init2(0, 0,
-                                     ntohs((unsigned short)COAP_INVALID_TID),
-                                     length, *transport);
+    coap_pdu_t *pdu = CAInitPDU(length, *transport);
 
     if (NULL == pdu)
     {
@@ -392,7 +442,7 @@ coap_pdu_t *CAGeneratePDUImpl(code_t code, const CAInfo_t *info,
                                       COAP_OPTION_DATA(*(coap_option *) opt->data), *transport))
             {
                 OIC_LOG(ERROR, TAG, "coap_add_option2 has failed");
-                coap_delete_pdu(pdu);
+                CADeletePDU(pdu);
                 return NULL;
             }
         }
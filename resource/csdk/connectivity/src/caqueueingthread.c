@@ -30,11 +30,69 @@
 #endif
 
 #include "caqueueingthread.h"
+#include "ocatomic.h"
 #include "oic_malloc.h"
 #include "experimental/logger.h"
 
 #define TAG PCF("OIC_CA_QING")
 
+static void CAQueueingThreadDestroyData(CAQueueingThread_t *thread, void *data, uint32_t size)
+{
+    if (NULL != thread->destroy)
+    {
+        thread->destroy(data, size);
+    }
+    else
+    {
+        OICFree(data);
+    }
+}
+
+/**
+ * Takes the first data of the queue without waiting. Only the queueing thread,
+ * or the owner of a queue whose thread is not started, calls it.
+ */
+static bool CAQueueingThreadNextMessage(CAQueueingThread_t *thread, u_queue_message_t *message)
+{
+    if (NULL != thread->ringQueue)
+    {
+        if (!u_mpsc_queue_pop(thread->ringQueue, message))
+        {
+            return false;
+        }
+
+        // a cell is free now, wake a producer waiting for one
+        if (0 < oc_atomic_add(&thread->producersWaiting, 0))
+        {
+            oc_mutex_lock(thread->threadMutex);
+            oc_cond_signal(thread->spaceCond);
+            oc_mutex_unlock(thread->threadMutex);
+        }
+        return true;
+    }
+
+    oc_mutex_lock(thread->threadMutex);
+    u_queue_message_t *element = u_queue_get_element(thread->dataQueue);
+    oc_mutex_unlock(thread->threadMutex);
+    if (NULL == element)
+    {
+        return false;
+    }
+
+    *message = *element;
+    OICFree(element);
+    return true;
+}
+
+static bool CAQueueingThreadIsEmpty(CAQueueingThread_t *thread)
+{
+    if (NULL != thread->ringQueue)
+    {
+        return 0 == u_mpsc_queue_get_size(thread->ringQueue);
+    }
+    return u_queue_get_size(thread->dataQueue) <= 0;
+}
+
 static void CAQueueingThreadBaseRoutine(void *threadValue)
 {
     OIC_LOG(DEBUG, TAG, "message handler main thread start..");
@@ -49,51 +107,39 @@ static void CAQueueingThreadBaseRoutine(void *threadValue)
 
     while (!thread->isStop)
     {
-        // mutex lock
-        oc_mutex_lock(thread->threadMutex);
-
-        // if queue is empty, thread will wait
-        if (!thread->isStop && u_queue_get_size(thread->dataQueue) <= 0)
+        // get data
+        u_queue_message_t message;
+        if (!CAQueueingThreadNextMessage(thread, &message))
         {
-            OIC_LOG(DEBUG, TAG, "wait..");
+            // mutex lock
+            oc_mutex_lock(thread->threadMutex);
 
-            // wait
-            oc_cond_wait(thread->threadCond, thread->threadMutex);
+            // producers of a bounded queue only signal while this is set
+            oc_atomic_increment(&thread->consumerWaiting);
 
-            OIC_LOG(DEBUG, TAG, "wake up..");
-        }
+            // if queue is empty, thread will wait
+            if (!thread->isStop && CAQueueingThreadIsEmpty(thread))
+            {
+                OIC_LOG(DEBUG, TAG, "wait..");
+
+                // wait
+                oc_cond_wait(thread->threadCond, thread->threadMutex);
+
+                OIC_LOG(DEBUG, TAG, "wake up..");
+            }
+
+            oc_atomic_decrement(&thread->consumerWaiting);
 
-        // check stop flag
-        if (thread->isStop)
-        {
             // mutex unlock
             oc_mutex_unlock(thread->threadMutex);
             continue;
         }
 
-        // get data
-        u_queue_message_t *message = u_queue_get_element(thread->dataQueue);
-        // mutex unlock
-        oc_mutex_unlock(thread->threadMutex);
-        if (NULL == message)
-        {
-            continue;
-        }
-
         // process data
-        thread->threadTask(message->msg);
+        thread->threadTask(message.msg);
 
         // free
-        if (NULL != thread->destroy)
-        {
-            thread->destroy(message->msg, message->size);
-        }
-        else
-        {
-            OICFree(message->msg);
-        }
-
-        OICFree(message);
+        CAQueueingThreadDestroyData(thread, message.msg, message.size);
     }
 
     oc_mutex_lock(thread->threadMutex);
@@ -103,8 +149,11 @@ static void CAQueueingThreadBaseRoutine(void *threadValue)
     OIC_LOG(DEBUG, TAG, "message handler main thread end..");
 }
 
-CAResult_t CAQueueingThreadInitialize(CAQueueingThread_t *thread, ca_thread_pool_t handle,
-                                      CAThreadTask task, CADataDestroyFunction destroy)
+static CAResult_t CAQueueingThreadInitializeInternal(CAQueueingThread_t *thread,
+                                                     ca_thread_pool_t handle,
+                                                     CAThreadTask task,
+                                                     CADataDestroyFunction destroy,
+                                                     uint32_t capacity, uint64_t fullWaitUs)
 {
     if (NULL == thread)
     {
@@ -122,13 +171,31 @@ CAResult_t CAQueueingThreadInitialize(CAQueueingThread_t *thread, ca_thread_pool
 
     // set send thread data
     thread->threadPool = handle;
-    thread->dataQueue = u_queue_create();
+    thread->dataQueue = NULL;
+    thread->ringQueue = NULL;
+    thread->spaceCond = NULL;
+    if (0 < capacity)
+    {
+        thread->ringQueue = u_mpsc_queue_create(capacity);
+        thread->spaceCond = oc_cond_new();
+    }
+    else
+    {
+        thread->dataQueue = u_queue_create();
+    }
     thread->threadMutex = oc_mutex_new();
     thread->threadCond = oc_cond_new();
     thread->isStop = true;
     thread->threadTask = task;
     thread->destroy = destroy;
-    if (NULL == thread->dataQueue || NULL == thread->threadMutex || NULL == thread->threadCond)
+    thread->fullWaitUs = fullWaitUs;
+    thread->consumerWaiting = 0;
+    thread->producersWaiting = 0;
+    thread->droppedCount = 0;
+    thread->waitCancelled = false;
+    if ((0 < capacity && (NULL == thread->ringQueue || NULL == thread->spaceCond))
+        || (0 == capacity && NULL == thread->dataQueue)
+        || NULL == thread->threadMutex || NULL == thread->threadCond)
     {
         goto ERROR_MEM_FAILURE;
     }
@@ -141,6 +208,16 @@ ERROR_MEM_FAILURE:
         u_queue_delete(thread->dataQueue);
         thread->dataQueue = NULL;
     }
+    if (thread->ringQueue)
+    {
+        u_mpsc_queue_delete(thread->ringQueue);
+        thread->ringQueue = NULL;
+    }
+    if (thread->spaceCond)
+    {
+        oc_cond_free(thread->spaceCond);
+        thread->spaceCond = NULL;
+    }
     if (thread->threadMutex)
     {
         oc_mutex_free(thread->threadMutex);
@@ -154,6 +231,25 @@ ERROR_MEM_FAILURE:
     return CA_MEMORY_ALLOC_FAILED;
 }
 
+CAResult_t CAQueueingThreadInitialize(CAQueueingThread_t *thread, ca_thread_pool_t handle,
+                                      CAThreadTask task, CADataDestroyFunction destroy)
+{
+    return CAQueueingThreadInitializeInternal(thread, handle, task, destroy, 0, 0);
+}
+
+CAResult_t CAQueueingThreadInitializeBounded(CAQueueingThread_t *thread, ca_thread_pool_t handle,
+                                             CAThreadTask task, CADataDestroyFunction destroy,
+                                             uint32_t capacity, uint64_t fullWaitUs)
+{
+    if (0 == capacity)
+    {
+        OIC_LOG(ERROR, TAG, "capacity is zero..");
+        return CA_STATUS_INVALID_PARAM;
+    }
+    return CAQueueingThreadInitializeInternal(thread, handle, task, destroy, capacity,
+                                              fullWaitUs);
+}
+
 CAResult_t CAQueueingThreadStart(CAQueueingThread_t *thread)
 {
     if (NULL == thread)
@@ -180,8 +276,8 @@ CAResult_t CAQueueingThreadStart(CAQueueingThread_t *thread)
     // mutex unlock
     oc_mutex_unlock(thread->threadMutex);
 
-    CAResult_t res = ca_thread_pool_add_task(thread->threadPool, CAQueueingThreadBaseRoutine,
-                                             thread);
+    CAResult_t res = ca_thread_pool_add_long_running_task(thread->threadPool,
+                                                          CAQueueingThreadBaseRoutine, thread);
     if (res != CA_STATUS_OK)
     {
         // update thread status.
@@ -195,6 +291,51 @@ CAResult_t CAQueueingThreadStart(CAQueueingThread_t *thread)
     return res;
 }
 
+/**
+ * Adds data to the bounded queue. Waits up to fullWaitUs for room and drops the
+ * data when there is none.
+ */
+static CAResult_t CAQueueingThreadAddRingData(CAQueueingThread_t *thread, void *data,
+                                              uint32_t size)
+{
+    bool added = u_mpsc_queue_push(thread->ringQueue, data, size);
+    if (!added && 0 < thread->fullWaitUs)
+    {
+        oc_mutex_lock(thread->threadMutex);
+        oc_atomic_increment(&thread->producersWaiting);
+        while (!(added = u_mpsc_queue_push(thread->ringQueue, data, size)) && !thread->isStop)
+        {
+            if (OC_WAIT_SUCCESS != oc_cond_wait_for(thread->spaceCond, thread->threadMutex,
+                                                    thread->fullWaitUs))
+            {
+                added = u_mpsc_queue_push(thread->ringQueue, data, size);
+                break;
+            }
+        }
+        oc_atomic_decrement(&thread->producersWaiting);
+        oc_mutex_unlock(thread->threadMutex);
+    }
+
+    if (!added)
+    {
+        oc_atomic_increment(&thread->droppedCount);
+        OIC_LOG_V(WARNING, TAG, "queue is full, data dropped (%d so far)",
+                  thread->droppedCount);
+        CAQueueingThreadDestroyData(thread, data, size);
+        return CA_SEND_FAILED;
+    }
+
+    // notify the thread only if it waits for data
+    if (0 < oc_atomic_add(&thread->consumerWaiting, 0))
+    {
+        oc_mutex_lock(thread->threadMutex);
+        oc_cond_signal(thread->threadCond);
+        oc_mutex_unlock(thread->threadMutex);
+    }
+
+    return CA_STATUS_OK;
+}
+
 CAResult_t CAQueueingThreadAddData(CAQueueingThread_t *thread, void *data, uint32_t size)
 {
     if (NULL == thread)
@@ -209,6 +350,11 @@ CAResult_t CAQueueingThreadAddData(CAQueueingThread_t *thread, void *data, uint3
         return CA_STATUS_INVALID_PARAM;
     }
 
+    if (NULL != thread->ringQueue)
+    {
+        return CAQueueingThreadAddRingData(thread, data, size);
+    }
+
     // create thread data
     u_queue_message_t *message = (u_queue_message_t *) OICMalloc(sizeof(u_queue_message_t));
 
@@ -236,6 +382,64 @@ CAResult_t CAQueueingThreadAddData(CAQueueingThread_t *thread, void *data, uint3
     return CA_STATUS_OK;
 }
 
+bool CAQueueingThreadGetData(CAQueueingThread_t *thread, void **data, uint32_t *size)
+{
+    if (NULL == thread || NULL == data || NULL == size)
+    {
+        OIC_LOG(ERROR, TAG, "invalid parameter..");
+        return false;
+    }
+
+    u_queue_message_t message;
+    if (!CAQueueingThreadNextMessage(thread, &message))
+    {
+        return false;
+    }
+
+    *data = message.msg;
+    *size = message.size;
+    return true;
+}
+
+bool CAQueueingThreadWaitData(CAQueueingThread_t *thread, uint64_t timeoutUs)
+{
+    if (NULL == thread)
+    {
+        OIC_LOG(ERROR, TAG, "thread instance is empty..");
+        return false;
+    }
+
+    oc_mutex_lock(thread->threadMutex);
+
+    // producers of a bounded queue only signal while this is set
+    oc_atomic_increment(&thread->consumerWaiting);
+
+    if (0 < timeoutUs && !thread->waitCancelled && CAQueueingThreadIsEmpty(thread))
+    {
+        oc_cond_wait_for(thread->threadCond, thread->threadMutex, timeoutUs);
+    }
+    thread->waitCancelled = false;
+
+    oc_atomic_decrement(&thread->consumerWaiting);
+
+    bool hasData = !CAQueueingThreadIsEmpty(thread);
+    oc_mutex_unlock(thread->threadMutex);
+    return hasData;
+}
+
+void CAQueueingThreadCancelWait(CAQueueingThread_t *thread)
+{
+    if (NULL == thread || NULL == thread->threadMutex)
+    {
+        return;
+    }
+
+    oc_mutex_lock(thread->threadMutex);
+    thread->waitCancelled = true;
+    oc_cond_broadcast(thread->threadCond);
+    oc_mutex_unlock(thread->threadMutex);
+}
+
 CAResult_t CAQueueingThreadDestroy(CAQueueingThread_t *thread)
 {
     if (NULL == thread)
@@ -250,7 +454,7 @@ CAResult_t CAQueueingThreadDestroy(CAQueueingThread_t *thread)
     oc_mutex_lock(thread->threadMutex);
 
     // remove all remained list data.
-    while (u_queue_get_size(thread->dataQueue) > 0)
+    while (NULL != thread->dataQueue && u_queue_get_size(thread->dataQueue) > 0)
     {
         // get data
         u_queue_message_t *message = u_queue_get_element(thread->dataQueue);
@@ -258,21 +462,27 @@ CAResult_t CAQueueingThreadDestroy(CAQueueingThread_t *thread)
         // free
         if (NULL != message)
         {
-            if (NULL != thread->destroy)
-            {
-                thread->destroy(message->msg, message->size);
-            }
-            else
-            {
-                OICFree(message->msg);
-            }
-
+            CAQueueingThreadDestroyData(thread, message->msg, message->size);
             OICFree(message);
         }
     }
 
-    u_queue_delete(thread->dataQueue);
-    thread->dataQueue = NULL;
+    if (NULL != thread->dataQueue)
+    {
+        u_queue_delete(thread->dataQueue);
+        thread->dataQueue = NULL;
+    }
+
+    if (NULL != thread->ringQueue)
+    {
+        u_queue_message_t message;
+        while (u_mpsc_queue_pop(thread->ringQueue, &message))
+        {
+            CAQueueingThreadDestroyData(thread, message.msg, message.size);
+        }
+        u_mpsc_queue_delete(thread->ringQueue);
+        thread->ringQueue = NULL;
+    }
 
     // mutex unlock
     oc_mutex_unlock(thread->threadMutex);
@@ -280,6 +490,11 @@ CAResult_t CAQueueingThreadDestroy(CAQueueingThread_t *thread)
     oc_mutex_free(thread->threadMutex);
     thread->threadMutex = NULL;
     oc_cond_free(thread->threadCond);
+    if (NULL != thread->spaceCond)
+    {
+        oc_cond_free(thread->spaceCond);
+        thread->spaceCond = NULL;
+    }
 
     return CA_STATUS_OK;
 }
@@ -305,6 +520,12 @@ CAResult_t CAQueueingThreadStop(CAQueueingThread_t *thread)
         // notify the thread
         oc_cond_signal(thread->threadCond);
 
+        // producers waiting for room drop their data
+        if (NULL != thread->spaceCond)
+        {
+            oc_cond_broadcast(thread->spaceCond);
+        }
+
         oc_cond_wait(thread->threadCond, thread->threadMutex);
 
         // mutex unlock
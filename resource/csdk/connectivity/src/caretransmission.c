@@ -67,6 +67,8 @@
 
 #include "caretransmission.h"
 #include "caremotehandler.h"
+#include "uthash.h"
+#include "utlist.h"
 #include "caprotocolmessage.h"
 #include "oic_malloc.h"
 #include "oic_time.h"
@@ -75,20 +77,60 @@
 
 #define TAG "OIC_CA_RETRANS"
 
+/**
+ * The retransmission data are kept on a hierarchical timer wheel of
+ * RT_WHEEL_LEVELS levels with RT_WHEEL_SLOTS slots each.  A slot on level n
+ * covers RT_WHEEL_SLOTS^n ticks, and its data move down a level when the
+ * wheel reaches it, so every check only visits the data that are due.
+ */
+#define RT_WHEEL_LEVELS         3
+#ifdef SINGLE_THREAD
+#define RT_WHEEL_SLOT_BITS      3
+#define RT_WHEEL_TICK_US        (250 * 1000)
+#else
+#define RT_WHEEL_SLOT_BITS      6
+#define RT_WHEEL_TICK_US        (10 * 1000)
+#endif
+#define RT_WHEEL_SLOTS          (1 << RT_WHEEL_SLOT_BITS)
+#define RT_WHEEL_SLOT_MASK      (RT_WHEEL_SLOTS - 1)
+#define RT_WHEEL_SPAN           ((uint64_t)1 << (RT_WHEEL_SLOT_BITS * RT_WHEEL_LEVELS))
+
+/** An ACK or RST matches the CON data by transport adapter and message id. */
 typedef struct
+{
+    CATransportAdapter_t adapter;       /**< transport adapter of the remote endpoint */
+    uint16_t messageId;                 /**< coap PDU message id */
+} CARetransmissionKey_t;
+
+typedef struct CARetransmissionData
 {
     uint64_t timeStamp;                 /**< last sent time. microseconds */
 #ifndef SINGLE_THREAD
     uint64_t timeout;                   /**< timeout value. microseconds */
 #endif
+    uint64_t expires;                   /**< next send time. wheel ticks */
     uint8_t triedCount;                 /**< retransmission count */
     uint16_t messageId;                 /**< coap PDU message id */
     CADataType_t dataType;              /**< data Type (Request/Response) */
     CAEndpoint_t *endpoint;             /**< remote endpoint */
     void *pdu;                          /**< coap PDU */
     uint32_t size;                      /**< coap PDU size */
+    CARetransmissionKey_t key;          /**< key of dataTable */
+    bool isSending;                     /**< being retransmitted outside of the lock */
+    bool isAcked;                       /**< acknowledged while being retransmitted */
+    struct CARetransmissionData **slot; /**< wheel slot holding this data */
+    struct CARetransmissionData *prev;  /**< previous data in the slot */
+    struct CARetransmissionData *next;  /**< next data in the slot */
+    UT_hash_handle hh;                  /**< dataTable handle */
 } CARetransmissionData_t;
 
+struct CARetransmissionWheel
+{
+    uint64_t tick;                      /**< next tick to process */
+    size_t count;                       /**< number of data on the wheel */
+    CARetransmissionData_t *slots[RT_WHEEL_LEVELS][RT_WHEEL_SLOTS];
+};
+
 static const uint64_t USECS_PER_SEC = 1000000;
 static const uint64_t USECS_PER_MSEC = 1000;
 static const uint64_t MSECS_PER_SEC = 1000;
@@ -127,8 +169,8 @@ CAResult_t CARetransmissionStart(CARetransmission_t *context)
         return CA_STATUS_INVALID_PARAM;
     }
 
-    CAResult_t res = ca_thread_pool_add_task(context->threadPool, CARetransmissionBaseRoutine,
-                                             context);
+    CAResult_t res = ca_thread_pool_add_long_running_task(context->threadPool,
+                                                          CARetransmissionBaseRoutine, context);
 
     if (CA_STATUS_OK != res)
     {
@@ -141,38 +183,167 @@ CAResult_t CARetransmissionStart(CARetransmission_t *context)
 #endif
 
 /**
- * @brief   check timeout routine
- * @param   currentTime     [IN]microseconds
+ * @brief   time between the last send and the next retransmission
  * @param   retData         [IN]retransmission data
- * @return  true if the timeout period has elapsed, false otherwise
+ * @return  microseconds
  */
-static bool CACheckTimeout(uint64_t currentTime, CARetransmissionData_t *retData)
+static uint64_t CAGetRetransmissionInterval(const CARetransmissionData_t *retData)
 {
 #ifndef SINGLE_THREAD
-    // #1. calculate timeout
     uint64_t milliTimeoutValue = retData->timeout / USECS_PER_MSEC;
-    uint64_t timeout = (milliTimeoutValue << retData->triedCount) * USECS_PER_MSEC;
+    return (milliTimeoutValue << retData->triedCount) * USECS_PER_MSEC;
+#else
+    return (2 << retData->triedCount) * (uint64_t) USECS_PER_SEC;
+#endif
+}
+
+/**
+ * @brief   first wheel tick at which the retransmission is due
+ * @param   retData         [IN]retransmission data
+ * @return  wheel tick
+ */
+static uint64_t CAGetExpiryTick(const CARetransmissionData_t *retData)
+{
+    uint64_t expiry = retData->timeStamp + CAGetRetransmissionInterval(retData);
+    return (expiry + RT_WHEEL_TICK_US - 1) / RT_WHEEL_TICK_US;
+}
+
+static void CAFreeRetransmissionData(CARetransmissionData_t *retData)
+{
+    CAFreeEndpoint(retData->endpoint);
+    OICFree(retData->pdu);
+    OICFree(retData);
+}
+
+static void CAWheelInsert(struct CARetransmissionWheel *wheel, CARetransmissionData_t *retData)
+{
+    uint64_t expires = (retData->expires < wheel->tick) ? wheel->tick : retData->expires;
+    uint64_t delta = expires - wheel->tick;
 
-    if (currentTime >= retData->timeStamp + timeout)
+    // data beyond the wheel span wait on the last level and are placed again
+    // when that slot moves down.
+    if (delta >= RT_WHEEL_SPAN)
     {
-        OIC_LOG_V(DEBUG, TAG, "%" PRIu64 " microseconds time out!!, tried count(%d)",
-                  timeout, retData->triedCount);
-        return true;
+        expires = wheel->tick + RT_WHEEL_SPAN - 1;
+        delta = RT_WHEEL_SPAN - 1;
     }
-#else
-    // #1. calculate timeout
-    uint64_t timeOut = (2 << retData->triedCount) * (uint64_t) USECS_PER_SEC;
 
-    if (currentTime >= retData->timeStamp + timeOut)
+    size_t level = 0;
+    while (delta >= ((uint64_t)1 << (RT_WHEEL_SLOT_BITS * (level + 1))))
     {
-        OIC_LOG_V(DEBUG, TAG, "timeout=%d, tried cnt=%d",
-                  (2 << retData->triedCount), retData->triedCount);
-        return true;
+        level++;
     }
-#endif
-    return false;
+
+    size_t index = (size_t)(expires >> (RT_WHEEL_SLOT_BITS * level)) & RT_WHEEL_SLOT_MASK;
+    retData->slot = &wheel->slots[level][index];
+    DL_APPEND(*retData->slot, retData);
+    wheel->count++;
 }
 
+static void CAWheelRemove(struct CARetransmissionWheel *wheel, CARetransmissionData_t *retData)
+{
+    if (retData->slot)
+    {
+        DL_DELETE(*retData->slot, retData);
+        retData->slot = NULL;
+        wheel->count--;
+    }
+}
+
+static void CAWheelCascade(struct CARetransmissionWheel *wheel, size_t level, size_t index)
+{
+    CARetransmissionData_t *list = wheel->slots[level][index];
+    wheel->slots[level][index] = NULL;
+
+    CARetransmissionData_t *retData = NULL;
+    CARetransmissionData_t *tmp = NULL;
+    DL_FOREACH_SAFE(list, retData, tmp)
+    {
+        wheel->count--;
+        CAWheelInsert(wheel, retData);
+    }
+}
+
+/**
+ * @brief   take the data due up to the given tick off the wheel
+ * @param   wheel           [IN]timer wheel
+ * @param   currentTick     [IN]current wheel tick
+ * @return  list of the due data
+ */
+static CARetransmissionData_t *CAWheelExpire(struct CARetransmissionWheel *wheel,
+                                             uint64_t currentTick)
+{
+    CARetransmissionData_t *dueList = NULL;
+
+    while (wheel->tick <= currentTick && wheel->count > 0)
+    {
+        size_t index = (size_t)wheel->tick & RT_WHEEL_SLOT_MASK;
+        if (0 == index)
+        {
+            for (size_t level = 1; level < RT_WHEEL_LEVELS; level++)
+            {
+                size_t upper = (size_t)(wheel->tick >> (RT_WHEEL_SLOT_BITS * level))
+                               & RT_WHEEL_SLOT_MASK;
+                CAWheelCascade(wheel, level, upper);
+                if (0 != upper)
+                {
+                    break;
+                }
+            }
+        }
+
+        CARetransmissionData_t *list = wheel->slots[0][index];
+        wheel->slots[0][index] = NULL;
+
+        CARetransmissionData_t *retData = NULL;
+        CARetransmissionData_t *tmp = NULL;
+        DL_FOREACH_SAFE(list, retData, tmp)
+        {
+            retData->slot = NULL;
+            wheel->count--;
+            DL_APPEND(dueList, retData);
+        }
+        wheel->tick++;
+    }
+
+    if (0 == wheel->count && wheel->tick <= currentTick)
+    {
+        wheel->tick = currentTick + 1;
+    }
+
+    return dueList;
+}
+
+#ifndef SINGLE_THREAD
+/**
+ * @brief   time until the wheel holds due data or has to move a slot down
+ * @param   wheel           [IN]timer wheel
+ * @param   currentTime     [IN]microseconds
+ * @return  microseconds, at most RETRANSMISSION_CHECK_PERIOD_SEC
+ */
+static uint64_t CAWheelGetWaitTime(const struct CARetransmissionWheel *wheel,
+                                   uint64_t currentTime)
+{
+    uint64_t tick = wheel->tick;
+    for (size_t i = 0; i < RT_WHEEL_SLOTS; i++, tick++)
+    {
+        size_t index = (size_t)tick & RT_WHEEL_SLOT_MASK;
+        if (wheel->slots[0][index] || (0 == index && 0 != i))
+        {
+            break;
+        }
+    }
+
+    uint64_t waitTime = RETRANSMISSION_CHECK_PERIOD_SEC * (uint64_t) USECS_PER_SEC;
+    uint64_t wakeTime = tick * RT_WHEEL_TICK_US;
+    if (wakeTime <= currentTime)
+    {
+        return 0;
+    }
+    return (wakeTime - currentTime < waitTime) ? wakeTime - currentTime : waitTime;
+}
+#endif
+
 static void CACheckRetransmissionList(CARetransmission_t *context)
 {
     if (NULL == context)
@@ -181,72 +352,91 @@ static void CACheckRetransmissionList(CARetransmission_t *context)
         return;
     }
 
-    // mutex lock
+    // #1. take the due data off the wheel.
     oc_mutex_lock(context->threadMutex);
 
-    size_t len = u_arraylist_length(context->dataList);
+    uint64_t currentTime = OICGetCurrentTime(TIME_IN_US);
+    CARetransmissionData_t *dueList = CAWheelExpire(context->wheel,
+                                                    currentTime / RT_WHEEL_TICK_US);
+    if (NULL == dueList)
+    {
+        oc_mutex_unlock(context->threadMutex);
+        return;
+    }
 
-    for (size_t i = 0; i < len; i++)
+    CARetransmissionData_t *retData = NULL;
+    CARetransmissionData_t *tmp = NULL;
+    DL_FOREACH(dueList, retData)
     {
-        CARetransmissionData_t *retData = u_arraylist_get(context->dataList, i);
+        retData->isSending = true;
+    }
+
+    oc_mutex_unlock(context->threadMutex);
 
-        if (NULL == retData)
+    // #2. if time's up, send the data. an ACK arriving meanwhile only marks it.
+    DL_FOREACH(dueList, retData)
+    {
+        if (retData->triedCount < context->config.tryingCount
+            && NULL != context->dataSendMethod)
         {
-            continue;
+            OIC_LOG_V(DEBUG, TAG, "retransmission CON data!!, msgid=%d, tried count(%d)",
+                      retData->messageId, retData->triedCount);
+            context->dataSendMethod(retData->endpoint, retData->pdu,
+                                    retData->size, retData->dataType);
         }
+    }
+
+    CARetransmissionData_t *timeoutList = NULL;
+
+    oc_mutex_lock(context->threadMutex);
 
-        uint64_t currentTime = OICGetCurrentTime(TIME_IN_US);
+    DL_FOREACH_SAFE(dueList, retData, tmp)
+    {
+        DL_DELETE(dueList, retData);
+        retData->isSending = false;
 
-        if (CACheckTimeout(currentTime, retData))
+        if (retData->isAcked)
         {
-            // #2. if time's up, send the data.
-            if (NULL != context->dataSendMethod)
-            {
-                OIC_LOG_V(DEBUG, TAG, "retransmission CON data!!, msgid=%d",
-                          retData->messageId);
-                context->dataSendMethod(retData->endpoint, retData->pdu,
-                                        retData->size, retData->dataType);
-            }
+            // already removed from dataTable by CARetransmissionReceivedData.
+            CAFreeRetransmissionData(retData);
+            continue;
+        }
 
-            // #3. increase the retransmission count and update timestamp.
+        // #3. increase the retransmission count and update timestamp.
+        if (retData->triedCount < context->config.tryingCount)
+        {
             retData->timeStamp = currentTime;
             retData->triedCount++;
         }
 
-        // #4. if tried count is max, remove the retransmission data from list.
+        // #4. if tried count is max, remove the retransmission data.
         if (retData->triedCount >= context->config.tryingCount)
         {
-            CARetransmissionData_t *removedData = u_arraylist_remove(context->dataList, i);
-            if (NULL == removedData)
-            {
-                OIC_LOG(ERROR, TAG, "Removed data is NULL");
-                // mutex unlock
-                oc_mutex_unlock(context->threadMutex);
-                return;
-            }
             OIC_LOG_V(DEBUG, TAG, "max trying count, remove RTCON data,"
-                      "msgid=%d", removedData->messageId);
-
-            // callback for retransmit timeout
-            if (NULL != context->timeoutCallback)
-            {
-                context->timeoutCallback(removedData->endpoint, removedData->pdu,
-                                         removedData->size);
-            }
-
-            CAFreeEndpoint(removedData->endpoint);
-            OICFree(removedData->pdu);
-
-            OICFree(removedData);
-
-            // modify loop value.
-            len = u_arraylist_length(context->dataList);
-            --i;
+                      "msgid=%d", retData->messageId);
+            HASH_DELETE(hh, context->dataTable, retData);
+            context->dataCount--;
+            DL_APPEND(timeoutList, retData);
+        }
+        else
+        {
+            retData->expires = CAGetExpiryTick(retData);
+            CAWheelInsert(context->wheel, retData);
         }
     }
 
-    // mutex unlock
     oc_mutex_unlock(context->threadMutex);
+
+    // callback for retransmit timeout
+    DL_FOREACH_SAFE(timeoutList, retData, tmp)
+    {
+        DL_DELETE(timeoutList, retData);
+        if (NULL != context->timeoutCallback)
+        {
+            context->timeoutCallback(retData->endpoint, retData->pdu, retData->size);
+        }
+        CAFreeRetransmissionData(retData);
+    }
 }
 
 void CARetransmissionBaseRoutine(void *threadValue)
@@ -276,7 +466,7 @@ void CARetransmissionBaseRoutine(void *threadValue)
         // mutex lock
         oc_mutex_lock(context->threadMutex);
 
-        if (!context->isStop && u_arraylist_length(context->dataList) <= 0)
+        if (!context->isStop && 0 == context->dataCount)
         {
             // if list is empty, thread will wait
             OIC_LOG(DEBUG, TAG, "wait..there is no retransmission data.");
@@ -288,13 +478,17 @@ void CARetransmissionBaseRoutine(void *threadValue)
         }
         else if (!context->isStop)
         {
-            // check each RETRANSMISSION_CHECK_PERIOD_SEC time.
-            OIC_LOG_V(DEBUG, TAG, "wait..(%" PRIu64 ")microseconds",
-                      RETRANSMISSION_CHECK_PERIOD_SEC * (uint64_t) USECS_PER_SEC);
+            // wait until the next wheel slot with data, at most
+            // RETRANSMISSION_CHECK_PERIOD_SEC time.
+            uint64_t waitTime = CAWheelGetWaitTime(context->wheel,
+                                                   OICGetCurrentTime(TIME_IN_US));
+            OIC_LOG_V(DEBUG, TAG, "wait..(%" PRIu64 ")microseconds", waitTime);
 
             // wait
-            uint64_t absTime = RETRANSMISSION_CHECK_PERIOD_SEC * (uint64_t) USECS_PER_SEC;
-            oc_cond_wait_for(context->threadCond, context->threadMutex, absTime );
+            if (0 < waitTime)
+            {
+                oc_cond_wait_for(context->threadCond, context->threadMutex, waitTime);
+            }
         }
         else
         {
@@ -352,6 +546,14 @@ CAResult_t CARetransmissionInitialize(CARetransmission_t *context,
         cfg = *config;
     }
 
+    context->wheel = (struct CARetransmissionWheel *) OICCalloc(
+                         1, sizeof(struct CARetransmissionWheel));
+    if (NULL == context->wheel)
+    {
+        OIC_LOG(ERROR, TAG, "memory error");
+        return CA_MEMORY_ALLOC_FAILED;
+    }
+
     // set send thread data
     context->threadPool = handle;
     context->threadMutex = oc_mutex_new();
@@ -360,7 +562,8 @@ CAResult_t CARetransmissionInitialize(CARetransmission_t *context,
     context->timeoutCallback = timeoutCallback;
     context->config = cfg;
     context->isStop = false;
-    context->dataList = u_arraylist_create();
+    context->dataTable = NULL;
+    context->dataCount = 0;
 
     return CA_STATUS_OK;
 }
@@ -436,49 +639,48 @@ CAResult_t CARetransmissionSentData(CARetransmission_t *context,
     retData->pdu = pduData;
     retData->size = size;
     retData->dataType = dataType;
-#ifndef SINGLE_THREAD
+    retData->key.adapter = endpoint->adapter;
+    retData->key.messageId = messageId;
+    // without any retransmission the data times out on the next check.
+    retData->expires = context->config.tryingCount ? CAGetExpiryTick(retData) : 0;
+
     // mutex lock
     oc_mutex_lock(context->threadMutex);
 
-    size_t len = u_arraylist_length(context->dataList);
-
-    // #3. add data into list
-    for (size_t i = 0; i < len; i++)
+    // #3. add data into the table and on the wheel
+    CARetransmissionData_t *currData = NULL;
+    HASH_FIND(hh, context->dataTable, &retData->key, sizeof(retData->key), currData);
+    if (NULL != currData)
     {
-        CARetransmissionData_t *currData = u_arraylist_get(context->dataList, i);
+        OIC_LOG(ERROR, TAG, "Duplicate message ID");
 
-        if (NULL == currData)
-        {
-            continue;
-        }
-
-        // found index
-        if (NULL != currData->endpoint && currData->messageId == messageId
-            && (currData->endpoint->adapter == endpoint->adapter))
-        {
-            OIC_LOG(ERROR, TAG, "Duplicate message ID");
+        // mutex unlock
+        oc_mutex_unlock(context->threadMutex);
 
-            // mutex unlock
-            oc_mutex_unlock(context->threadMutex);
+        CAFreeRetransmissionData(retData);
+        return CA_STATUS_FAILED;
+    }
 
-            OICFree(retData);
-            OICFree(pduData);
-            OICFree(remoteEndpoint);
-            return CA_STATUS_FAILED;
-        }
+    // an empty wheel skips the ticks it slept through.
+    uint64_t currentTick = retData->timeStamp / RT_WHEEL_TICK_US;
+    if (0 == context->wheel->count && context->wheel->tick < currentTick)
+    {
+        context->wheel->tick = currentTick;
     }
 
-    u_arraylist_add(context->dataList, (void *) retData);
+    HASH_ADD(hh, context->dataTable, key, sizeof(retData->key), retData);
+    context->dataCount++;
+    CAWheelInsert(context->wheel, retData);
 
+#ifndef SINGLE_THREAD
     // notify the thread
     oc_cond_signal(context->threadCond);
+#endif
 
     // mutex unlock
     oc_mutex_unlock(context->threadMutex);
 
-#else
-    u_arraylist_add(context->dataList, (void *) retData);
-
+#ifdef SINGLE_THREAD
     CACheckRetransmissionList(context);
 #endif
     return CA_STATUS_OK;
@@ -517,80 +719,70 @@ CAResult_t CARetransmissionReceivedData(CARetransmission_t *context,
         return CA_STATUS_OK;
     }
 
+    CARetransmissionKey_t key;
+    memset(&key, 0, sizeof(key));
+    key.adapter = endpoint->adapter;
+    key.messageId = messageId;
+
     // mutex lock
     oc_mutex_lock(context->threadMutex);
-    size_t len = u_arraylist_length(context->dataList);
 
-    for (size_t i = 0; i < len; i++)
+    CARetransmissionData_t *retData = NULL;
+    HASH_FIND(hh, context->dataTable, &key, sizeof(key), retData);
+    if (NULL == retData)
     {
-        CARetransmissionData_t *retData = (CARetransmissionData_t *) u_arraylist_get(
-                context->dataList, i);
-
-        if (NULL == retData)
-        {
-            continue;
-        }
-
-        // found index
-        if (NULL != retData->endpoint && retData->messageId == messageId
-            && (retData->endpoint->adapter == endpoint->adapter))
-        {
-            // get pdu data for getting token when CA_EMPTY(RST/ACK) is received from remote device
-            // if retransmission was finish..token will be unavailable.
-            if (CA_EMPTY == CAGetCodeFromPduBinaryData(pdu, size))
-            {
-                OIC_LOG(DEBUG, TAG, "code is CA_EMPTY");
-
-                if (NULL == retData->pdu)
-                {
-                    OIC_LOG(ERROR, TAG, "retData->pdu is null");
-                    OICFree(retData);
-                    // mutex unlock
-                    oc_mutex_unlock(context->threadMutex);
-
-                    return CA_STATUS_FAILED;
-                }
-
-                // copy PDU data
-                (*retransmissionPdu) = (void *) OICCalloc(1, retData->size);
-                if ((*retransmissionPdu) == NULL)
-                {
-                    OICFree(retData);
-                    OIC_LOG(ERROR, TAG, "memory error");
+        // mutex unlock
+        oc_mutex_unlock(context->threadMutex);
 
-                    // mutex unlock
-                    oc_mutex_unlock(context->threadMutex);
+        OIC_LOG(DEBUG, TAG, "OUT");
+        return CA_STATUS_OK;
+    }
 
-                    return CA_MEMORY_ALLOC_FAILED;
-                }
-                memcpy((*retransmissionPdu), retData->pdu, retData->size);
-            }
+    // get pdu data for getting token when CA_EMPTY(RST/ACK) is received from remote device
+    // if retransmission was finish..token will be unavailable.
+    if (CA_EMPTY == code)
+    {
+        OIC_LOG(DEBUG, TAG, "code is CA_EMPTY");
 
-            // #2. remove data from list
-            CARetransmissionData_t *removedData = u_arraylist_remove(context->dataList, i);
-            if (NULL == removedData)
-            {
-                OIC_LOG(ERROR, TAG, "Removed data is NULL");
+        // copy PDU data
+        (*retransmissionPdu) = (void *) OICCalloc(1, retData->size);
+        if ((*retransmissionPdu) == NULL)
+        {
+            OIC_LOG(ERROR, TAG, "memory error");
 
-                // mutex unlock
-                oc_mutex_unlock(context->threadMutex);
+            // mutex unlock
+            oc_mutex_unlock(context->threadMutex);
 
-                return CA_STATUS_FAILED;
-            }
+            return CA_MEMORY_ALLOC_FAILED;
+        }
+        memcpy((*retransmissionPdu), retData->pdu, retData->size);
+    }
 
-            OIC_LOG_V(DEBUG, TAG, "remove RTCON data!!, msgid=%d", messageId);
+    // #2. remove data from the table and the wheel
+    HASH_DELETE(hh, context->dataTable, retData);
+    context->dataCount--;
 
-            CAFreeEndpoint(removedData->endpoint);
-            OICFree(removedData->pdu);
-            OICFree(removedData);
+    OIC_LOG_V(DEBUG, TAG, "remove RTCON data!!, msgid=%d", messageId);
 
-            break;
-        }
+    if (retData->isSending)
+    {
+        // the retransmission thread frees it once the send returns.
+        retData->isAcked = true;
+        retData = NULL;
+    }
+    else
+    {
+        CAWheelRemove(context->wheel, retData);
     }
 
     // mutex unlock
     oc_mutex_unlock(context->threadMutex);
 
+    if (retData)
+    {
+        CAFreeRetransmissionData(retData);
+    }
+
     OIC_LOG(DEBUG, TAG, "OUT");
     return CA_STATUS_OK;
 }
@@ -633,24 +825,21 @@ CAResult_t CARetransmissionDestroy(CARetransmission_t *context)
     OIC_LOG(DEBUG, TAG, "retransmission context destroy..");
 
     oc_mutex_lock(context->threadMutex);
-    size_t len = u_arraylist_length(context->dataList);
-    for (size_t i = 0; i < len; i++)
+    CARetransmissionData_t *data = NULL;
+    CARetransmissionData_t *tmp = NULL;
+    HASH_ITER(hh, context->dataTable, data, tmp)
     {
-        CARetransmissionData_t *data = u_arraylist_get(context->dataList, i);
-        if (NULL == data)
-        {
-            continue;
-        }
-        CAFreeEndpoint(data->endpoint);
-        OICFree(data->pdu);
-        OICFree(data);
+        HASH_DELETE(hh, context->dataTable, data);
+        CAFreeRetransmissionData(data);
     }
+    context->dataCount = 0;
+    OICFree(context->wheel);
+    context->wheel = NULL;
     oc_mutex_unlock(context->threadMutex);
 
     oc_mutex_free(context->threadMutex);
     context->threadMutex = NULL;
     oc_cond_free(context->threadCond);
-    u_arraylist_free(&context->dataList);
 
     return CA_STATUS_OK;
 }
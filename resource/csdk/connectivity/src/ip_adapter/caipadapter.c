@@ -557,6 +557,71 @@ void CATerminateIP()
 
 #ifndef SINGLE_THREAD
 
+/**
+ * Most queued datagrams sent by one call of ::CAIPSendDataBatch.
+ */
+#define SEND_BATCH_SIZE 32
+
+static bool CAIPIsBatchable(const CAIPData_t *ipData)
+{
+    return !ipData->isMulticast && ipData->remoteEndpoint
+           && !(ipData->remoteEndpoint->flags & CA_SECURE);
+}
+
+/**
+ * Send a plain unicast datagram together with the plain unicast datagrams
+ * queued after it. The first datagram that cannot join the batch is sent
+ * after the batch, so the queue order is kept.
+ */
+static void CAIPSendQueuedBatch(CAIPData_t *first)
+{
+    CAIPDatagram_t datagrams[SEND_BATCH_SIZE];
+    CAIPData_t *taken[SEND_BATCH_SIZE];
+    CAIPData_t *next = NULL;
+    size_t count = 0;
+
+    taken[count] = first;
+    datagrams[count].endpoint = first->remoteEndpoint;
+    datagrams[count].data = first->data;
+    datagrams[count].dataLength = first->dataLen;
+    count++;
+
+    while (count < SEND_BATCH_SIZE)
+    {
+        void *data = NULL;
+        uint32_t size = 0;
+        if (!CAQueueingThreadGetData(g_sendQueueHandle, &data, &size))
+        {
+            break;
+        }
+        next = (CAIPData_t *) data;
+        if (!next || !CAIPIsBatchable(next))
+        {
+            break;
+        }
+        taken[count] = next;
+        datagrams[count].endpoint = next->remoteEndpoint;
+        datagrams[count].data = next->data;
+        datagrams[count].dataLength = next->dataLen;
+        count++;
+        next = NULL;
+    }
+
+    CAIPSendDataBatch(datagrams, count);
+
+    // the first one belongs to the queueing thread
+    for (size_t i = 1; i < count; i++)
+    {
+        CAFreeIPData(taken[i]);
+    }
+
+    if (next)
+    {
+        CAIPSendDataThread(next);
+        CAFreeIPData(next);
+    }
+}
+
 void CAIPSendDataThread(void *threadData)
 {
     CAIPData_t *ipData = (CAIPData_t *) threadData;
@@ -566,6 +631,12 @@ void CAIPSendDataThread(void *threadData)
         return;
     }
 
+    if (caglobals.ip.sendBatching && CAIPIsBatchable(ipData))
+    {
+        CAIPSendQueuedBatch(ipData);
+        return;
+    }
+
     if (ipData->isMulticast)
     {
         //Processing for sending multicast
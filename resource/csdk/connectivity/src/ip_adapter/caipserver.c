@@ -60,6 +60,9 @@
 #include <linux/netlink.h>
 #include <linux/rtnetlink.h>
 #endif
+#ifdef HAVE_SYS_EPOLL_H
+#include <sys/epoll.h>
+#endif
 
 #include <coap/pdu.h>
 #include <inttypes.h>
@@ -78,6 +81,23 @@
 #undef USE_IP_MREQN
 #endif
 
+/*
+ * On Linux the receive thread waits on a persistent epoll set and drains each
+ * ready socket with recvmmsg(). select() is used everywhere else, and also on
+ * Linux if the epoll set cannot be created.
+ */
+#if defined(__linux__) && defined(HAVE_SYS_EPOLL_H) && !defined(__ANDROID__)
+#define USE_EPOLL
+#endif
+
+/*
+ * On Linux a batch of unicast datagrams going out of the same socket is sent
+ * with one sendmmsg() call.
+ */
+#if defined(__linux__) && !defined(__ANDROID__)
+#define USE_SENDMMSG
+#endif
+
 /*
  * Logging tag for module name
  */
@@ -114,6 +134,49 @@ static struct in6_addr IPv6MulticastAddressGlb;
  */
 #define RECV_MSG_BUF_LEN 16384
 
+#ifdef USE_EPOLL
+/*
+ * Number of datagrams read by one recvmmsg() call
+ */
+#define RECV_MMSG_BATCH 8
+
+/*
+ * Maximum number of ready fds returned by one epoll_wait() call
+ */
+#define EPOLL_MAX_EVENTS 16
+
+/*
+ * epoll_event.data carries the fd in the low 32 bits and its transport flags
+ * in the high 32 bits, so a ready socket needs no lookup.
+ */
+#define EPOLL_DATA(FD, FLAGS) (((uint64_t)(FLAGS) << 32) | (uint32_t)(FD))
+#define EPOLL_DATA_FD(DATA) ((int)(uint32_t)(DATA))
+#define EPOLL_DATA_FLAGS(DATA) ((CATransportFlags_t)((DATA) >> 32))
+
+typedef union
+{
+    struct cmsghdr cmsg;
+    unsigned char data[CMSG_SPACE(sizeof (struct in6_pktinfo))];
+} CAPktInfoControl_t;
+
+/*
+ * Receive buffers for one recvmmsg() batch, allocated when the epoll set is
+ * created. Only the receive thread uses them.
+ */
+typedef struct
+{
+    struct mmsghdr msgs[RECV_MMSG_BATCH];
+    struct iovec iovs[RECV_MMSG_BATCH];
+    struct sockaddr_storage srcAddrs[RECV_MMSG_BATCH];
+    CAPktInfoControl_t controls[RECV_MMSG_BATCH];
+    char buffers[RECV_MMSG_BATCH][RECV_MSG_BUF_LEN];
+} CARecvBatch_t;
+
+static int g_epollFd = -1;
+
+static CARecvBatch_t *g_recvBatch = NULL;
+#endif
+
 static char *ipv6mcnames[IPv6_DOMAINS] = {
     NULL,
     IPv6_MULTICAST_INT,
@@ -162,8 +225,23 @@ static void CAEventReturned(CASocketFd_t socket);
 
 static CAResult_t CAReceiveMessage(CASocketFd_t fd, CATransportFlags_t flags);
 
+static CAResult_t CADeliverMessage(CATransportFlags_t flags, const unsigned char *pktinfo,
+                                   const struct sockaddr_storage *srcAddr, int namelen,
+                                   char *recvBuffer, size_t recvLen);
+
+static void CAHandleInterfaceChange();
+
 static void CACloseFDs()
 {
+#ifdef USE_EPOLL
+    if (-1 != g_epollFd)
+    {
+        close(g_epollFd);
+        g_epollFd = -1;
+    }
+    OICFree(g_recvBatch);
+    g_recvBatch = NULL;
+#endif
 #if !defined(WSA_WAIT_EVENT_0)
     if (caglobals.ip.shutdownFds[0] != -1)
     {
@@ -185,6 +263,24 @@ static void CAReceiveHandler(void *data)
     CACloseFDs();
 }
 
+static void CAHandleInterfaceChange()
+{
+    u_arraylist_t *iflist = CAFindInterfaceChange();
+    if (iflist)
+    {
+        size_t listLength = u_arraylist_length(iflist);
+        for (size_t i = 0; i < listLength; i++)
+        {
+            CAInterface_t *ifitem = (CAInterface_t *)u_arraylist_get(iflist, i);
+            if (ifitem)
+            {
+                CAProcessNewInterface(ifitem);
+            }
+        }
+        u_arraylist_destroy(iflist);
+    }
+}
+
 #define CLOSE_SOCKET(TYPE) \
     if (caglobals.ip.TYPE.fd != OC_INVALID_SOCKET) \
     { \
@@ -207,9 +303,203 @@ static void CAReceiveHandler(void *data)
         flags = FLAGS; \
     }
 
+#ifdef USE_EPOLL
+
+static bool CAEpollAdd(int fd, CATransportFlags_t flags, uint32_t events)
+{
+    if (-1 == fd)
+    {
+        return true;
+    }
+
+    struct epoll_event event = { .events = events, .data.u64 = EPOLL_DATA(fd, flags) };
+    if (-1 == epoll_ctl(g_epollFd, EPOLL_CTL_ADD, fd, &event))
+    {
+        OIC_LOG_V(ERROR, TAG, "epoll_ctl(%d) failed: %s", fd, strerror(errno));
+        return false;
+    }
+    return true;
+}
+
+// UDP sockets are edge-triggered and drained on every event; the shutdown
+// pipe and netlink socket are level-triggered and read once per event.
+#define EPOLL_ADD_SOCKET(TYPE, FLAGS) \
+    CAEpollAdd(caglobals.ip.TYPE.fd, FLAGS, EPOLLIN | EPOLLET)
+
+static void CAInitializeEpoll()
+{
+    OIC_LOG_V(DEBUG, TAG, "IN %s", __func__);
+
+    g_epollFd = epoll_create1(EPOLL_CLOEXEC);
+    if (-1 == g_epollFd)
+    {
+        OIC_LOG_V(ERROR, TAG, "epoll_create1 failed: %s, using select", strerror(errno));
+        return;
+    }
+
+    g_recvBatch = (CARecvBatch_t *)OICMalloc(sizeof (CARecvBatch_t));
+    if (!g_recvBatch
+        || !EPOLL_ADD_SOCKET(u6,  CA_IPV6)
+        || !EPOLL_ADD_SOCKET(u6s, CA_IPV6 | CA_SECURE)
+        || !EPOLL_ADD_SOCKET(u4,  CA_IPV4)
+        || !EPOLL_ADD_SOCKET(u4s, CA_IPV4 | CA_SECURE)
+        || !EPOLL_ADD_SOCKET(m6,  CA_MULTICAST | CA_IPV6)
+        || !EPOLL_ADD_SOCKET(m6s, CA_MULTICAST | CA_IPV6 | CA_SECURE)
+        || !EPOLL_ADD_SOCKET(m4,  CA_MULTICAST | CA_IPV4)
+        || !EPOLL_ADD_SOCKET(m4s, CA_MULTICAST | CA_IPV4 | CA_SECURE)
+        || !CAEpollAdd(caglobals.ip.shutdownFds[0], CA_DEFAULT_FLAGS, EPOLLIN)
+        || !CAEpollAdd(caglobals.ip.netlinkFd, CA_DEFAULT_FLAGS, EPOLLIN))
+    {
+        OIC_LOG(ERROR, TAG, "epoll set up failed, using select");
+        close(g_epollFd);
+        g_epollFd = -1;
+        OICFree(g_recvBatch);
+        g_recvBatch = NULL;
+    }
+
+    OIC_LOG_V(DEBUG, TAG, "OUT %s", __func__);
+}
+
+/*
+ * Reads every datagram queued on an edge-triggered socket, up to
+ * RECV_MMSG_BATCH per system call.
+ */
+static void CAEpollDrainSocket(int fd, CATransportFlags_t flags)
+{
+    int namelen = 0;
+    int level = 0;
+    int type = 0;
+
+    if (flags & CA_IPV6)
+    {
+        namelen = sizeof (struct sockaddr_in6);
+        level = IPPROTO_IPV6;
+        type = IPV6_PKTINFO;
+    }
+    else
+    {
+        namelen = sizeof (struct sockaddr_in);
+        level = IPPROTO_IP;
+        type = IP_PKTINFO;
+    }
+
+    int received = RECV_MMSG_BATCH;
+    while (RECV_MMSG_BATCH == received && !caglobals.ip.terminate)
+    {
+        for (int i = 0; i < RECV_MMSG_BATCH; i++)
+        {
+            g_recvBatch->iovs[i].iov_base = g_recvBatch->buffers[i];
+            g_recvBatch->iovs[i].iov_len = RECV_MSG_BUF_LEN;
+
+            struct msghdr *msg = &g_recvBatch->msgs[i].msg_hdr;
+            msg->msg_name = &g_recvBatch->srcAddrs[i];
+            msg->msg_namelen = namelen;
+            msg->msg_iov = &g_recvBatch->iovs[i];
+            msg->msg_iovlen = 1;
+            msg->msg_control = &g_recvBatch->controls[i];
+            msg->msg_controllen = sizeof (CAPktInfoControl_t);
+            msg->msg_flags = 0;
+        }
+
+        received = recvmmsg(fd, g_recvBatch->msgs, RECV_MMSG_BATCH, MSG_DONTWAIT, NULL);
+        if (-1 == received)
+        {
+            if (EAGAIN == errno || EWOULDBLOCK == errno)
+            {
+                return;
+            }
+            if (EBADF == errno || ENOTSOCK == errno || EINVAL == errno || EFAULT == errno)
+            {
+                OIC_LOG_V(ERROR, TAG, "recvmmsg failed %s", strerror(errno));
+                return;
+            }
+            // EINTR and pending socket errors (e.g. ICMP unreachable) are
+            // cleared by the call that reports them, so keep draining or the
+            // edge-triggered socket would not be reported again.
+            OIC_LOG_V(DEBUG, TAG, "recvmmsg interrupted %s", strerror(errno));
+            received = RECV_MMSG_BATCH;
+            continue;
+        }
+
+        for (int i = 0; i < received; i++)
+        {
+            struct msghdr *msg = &g_recvBatch->msgs[i].msg_hdr;
+            unsigned char *pktinfo = NULL;
+            for (struct cmsghdr *cmp = CMSG_FIRSTHDR(msg); cmp != NULL;
+                 cmp = CMSG_NXTHDR(msg, cmp))
+            {
+                if (cmp->cmsg_level == level && cmp->cmsg_type == type)
+                {
+                    pktinfo = CMSG_DATA(cmp);
+                }
+            }
+
+            (void)CADeliverMessage(flags, pktinfo, &g_recvBatch->srcAddrs[i], namelen,
+                                   g_recvBatch->buffers[i], g_recvBatch->msgs[i].msg_len);
+        }
+    }
+}
+
+static void CAEpollFindReadyMessage()
+{
+    struct epoll_event events[EPOLL_MAX_EVENTS];
+    int timeout = caglobals.ip.selectTimeout == -1 ? -1 : caglobals.ip.selectTimeout * 1000;
+
+    int ret = epoll_wait(g_epollFd, events, EPOLL_MAX_EVENTS, timeout);
+
+    if (caglobals.ip.terminate)
+    {
+        OIC_LOG_V(DEBUG, TAG, "Packet receiver Stop request received.");
+        return;
+    }
+
+    if (0 > ret)
+    {
+        if (EINTR != errno)
+        {
+            OIC_LOG_V(FATAL, TAG, "epoll_wait error %s", strerror(errno));
+        }
+        return;
+    }
+
+    for (int i = 0; i < ret && !caglobals.ip.terminate; i++)
+    {
+        int fd = EPOLL_DATA_FD(events[i].data.u64);
+
+        if (fd == caglobals.ip.shutdownFds[0])
+        {
+            char buf[10] = {0};
+            if (-1 == read(fd, buf, sizeof (buf)))
+            {
+                OIC_LOG_V(DEBUG, TAG, "shutdown read failed: %s", strerror(errno));
+            }
+        }
+        else if (fd == caglobals.ip.netlinkFd)
+        {
+#if NETWORK_INTERFACE_CHANGED_LOGGING
+            OIC_LOG_V(DEBUG, TAG, "Netlink event detected");
+#endif
+            CAHandleInterfaceChange();
+        }
+        else
+        {
+            CAEpollDrainSocket(fd, EPOLL_DATA_FLAGS(events[i].data.u64));
+        }
+    }
+}
+
+#endif // USE_EPOLL
 
 static void CAFindReadyMessage()
 {
+#ifdef USE_EPOLL
+    if (-1 != g_epollFd)
+    {
+        CAEpollFindReadyMessage();
+        return;
+    }
+#endif
+
     fd_set readFds;
     struct timeval timeout;
 
@@ -280,20 +570,7 @@ static void CASelectReturned(fd_set *readFds, int ret)
 #if NETWORK_INTERFACE_CHANGED_LOGGING
             OIC_LOG_V(DEBUG, TAG, "Netlink event detected");
 #endif
-            u_arraylist_t *iflist = CAFindInterfaceChange();
-            if (iflist)
-            {
-                size_t listLength = u_arraylist_length(iflist);
-                for (size_t i = 0; i < listLength; i++)
-                {
-                    CAInterface_t *ifitem = (CAInterface_t *)u_arraylist_get(iflist, i);
-                    if (ifitem)
-                    {
-                        CAProcessNewInterface(ifitem);
-                    }
-                }
-                u_arraylist_destroy(iflist);
-            }
+            CAHandleInterfaceChange();
             break;
         }
         else if (FD_ISSET(caglobals.ip.shutdownFds[0], readFds))
@@ -447,20 +724,7 @@ static void CAFindReadyMessage()
                     if ((caglobals.ip.addressChangeEvent != WSA_INVALID_EVENT) &&
                         (caglobals.ip.addressChangeEvent == eventArray[eventIndex]))
                     {
-                        u_arraylist_t *iflist = CAFindInterfaceChange();
-                        if (iflist)
-                        {
-                            size_t listLength = u_arraylist_length(iflist);
-                            for (size_t i = 0; i < listLength; i++)
-                            {
-                                CAInterface_t *ifitem = (CAInterface_t *)u_arraylist_get(iflist, i);
-                                if (ifitem)
-                                {
-                                    CAProcessNewInterface(ifitem);
-                                }
-                            }
-                            u_arraylist_destroy(iflist);
-                        }
+                        CAHandleInterfaceChange();
                         break;
                     }
 
@@ -661,6 +925,13 @@ static CAResult_t CAReceiveMessage(CASocketFd_t fd, CATransportFlags_t flags)
         }
     }
 #endif // !defined(WSA_CMSG_DATA)
+    return CADeliverMessage(flags, pktinfo, &srcAddr, namelen, recvBuffer, recvLen);
+}
+
+static CAResult_t CADeliverMessage(CATransportFlags_t flags, const unsigned char *pktinfo,
+                                   const struct sockaddr_storage *srcAddr, int namelen,
+                                   char *recvBuffer, size_t recvLen)
+{
     if (!pktinfo)
     {
         OIC_LOG(ERROR, TAG, "pktinfo is null");
@@ -699,7 +970,7 @@ static CAResult_t CAReceiveMessage(CASocketFd_t fd, CATransportFlags_t flags)
         }
     }
 
-    CAConvertAddrToName(&srcAddr, namelen, sep.endpoint.addr, &sep.endpoint.port);
+    CAConvertAddrToName(srcAddr, namelen, sep.endpoint.addr, &sep.endpoint.port);
 
     if (flags & CA_SECURE)
     {
@@ -1016,8 +1287,12 @@ CAResult_t CAIPStartServer(const ca_thread_pool_t threadPool)
         return res;
     }
 
+#ifdef USE_EPOLL
+    CAInitializeEpoll();
+#endif
+
     caglobals.ip.terminate = false;
-    res = ca_thread_pool_add_task(threadPool, CAReceiveHandler, NULL);
+    res = ca_thread_pool_add_long_running_task(threadPool, CAReceiveHandler, NULL);
     if (CA_STATUS_OK != res)
     {
         OIC_LOG(ERROR, TAG, "thread_pool_add_task failed");
@@ -1554,6 +1829,149 @@ void CAIPSendData(CAEndpoint_t *endpoint, const void *data, size_t datalen,
     }
 }
 
+#ifdef USE_SENDMMSG
+/*
+ * Number of datagrams sent by one sendmmsg() call
+ */
+#define SEND_MMSG_BATCH 16
+
+/*
+ * Datagrams of a batch going out of one socket.
+ */
+typedef struct
+{
+    struct mmsghdr msgs[SEND_MMSG_BATCH];
+    struct iovec iovs[SEND_MMSG_BATCH];
+    struct sockaddr_storage addrs[SEND_MMSG_BATCH];
+    const CAIPDatagram_t *datagrams[SEND_MMSG_BATCH];
+    unsigned int count;
+} CASendBatch_t;
+
+static void CASendBatchAdd(CASendBatch_t *batch, const CAIPDatagram_t *datagram)
+{
+    unsigned int i = batch->count++;
+    CAConvertNameToAddr(datagram->endpoint->addr, datagram->endpoint->port, &batch->addrs[i]);
+
+    batch->iovs[i].iov_base = (void *)datagram->data;
+    batch->iovs[i].iov_len = datagram->dataLength;
+
+    struct msghdr *msg = &batch->msgs[i].msg_hdr;
+    memset(msg, 0, sizeof (*msg));
+    msg->msg_name = &batch->addrs[i];
+    msg->msg_namelen = (AF_INET6 == batch->addrs[i].ss_family) ?
+                       sizeof (struct sockaddr_in6) : sizeof (struct sockaddr_in);
+    msg->msg_iov = &batch->iovs[i];
+    msg->msg_iovlen = 1;
+    batch->datagrams[i] = datagram;
+}
+
+static void CASendBatchFlush(CASendBatch_t *batch, CASocketFd_t fd, const char *fam)
+{
+    (void)fam;  // eliminates release warning
+
+    unsigned int sent = 0;
+    while (sent < batch->count)
+    {
+        int ret = sendmmsg(fd, &batch->msgs[sent], batch->count - sent, 0);
+        if (-1 == ret)
+        {
+            if (EINTR == errno)
+            {
+                continue;
+            }
+            // Only the first datagram failed, go on with the next ones.
+            const CAIPDatagram_t *failed = batch->datagrams[sent];
+            if (g_ipErrorHandler)
+            {
+                g_ipErrorHandler(failed->endpoint, failed->data, failed->dataLength,
+                                 CA_SEND_FAILED);
+            }
+            OIC_LOG_V(ERROR, TAG, "unicast %s sendmmsg failed: %s", fam, strerror(errno));
+            CALogSendStateInfo(failed->endpoint->adapter, failed->endpoint->addr,
+                               failed->endpoint->port, -1, false, strerror(errno));
+            sent++;
+            continue;
+        }
+
+        for (int i = 0; i < ret; i++)
+        {
+            const CAEndpoint_t *endpoint = batch->datagrams[sent + i]->endpoint;
+            CALogSendStateInfo(endpoint->adapter, endpoint->addr, endpoint->port,
+                               batch->msgs[sent + i].msg_len, true, NULL);
+        }
+        OIC_LOG_V(INFO, TAG, "unicast %s sendmmsg is successful: %d datagrams", fam, ret);
+        sent += ret;
+    }
+    batch->count = 0;
+}
+#endif
+
+void CAIPSendDataBatch(CAIPDatagram_t *datagrams, size_t count)
+{
+    VERIFY_NON_NULL_VOID(datagrams, TAG, "datagrams is NULL");
+
+#ifdef USE_SENDMMSG
+    CASendBatch_t *batch6 = (CASendBatch_t *)OICMalloc(sizeof (CASendBatch_t));
+    CASendBatch_t *batch4 = (CASendBatch_t *)OICMalloc(sizeof (CASendBatch_t));
+    if (!batch6 || !batch4)
+    {
+        OIC_LOG(ERROR, TAG, "Memory allocation failed! (send batch)");
+        OICFree(batch6);
+        OICFree(batch4);
+        batch6 = batch4 = NULL;
+    }
+    else
+    {
+        batch6->count = 0;
+        batch4->count = 0;
+    }
+#endif
+
+    for (size_t i = 0; i < count; i++)
+    {
+        CAIPDatagram_t *datagram = &datagrams[i];
+        if (!datagram->endpoint || !datagram->data)
+        {
+            OIC_LOG(ERROR, TAG, "Invalid datagram");
+            continue;
+        }
+
+#ifdef USE_SENDMMSG
+        CAEndpoint_t *endpoint = datagram->endpoint;
+        bool ipv6 = caglobals.ip.ipv6enabled && (endpoint->flags & CA_IPV6);
+        bool ipv4 = caglobals.ip.ipv4enabled && (endpoint->flags & CA_IPV4);
+        // Secured datagrams and datagrams for both families go the usual way.
+        if (batch6 && ipv6 != ipv4 && !(endpoint->flags & CA_SECURE))
+        {
+            if (!endpoint->port)    // unicast discovery
+            {
+                endpoint->port = CA_COAP;
+            }
+
+            CASendBatch_t *batch = ipv6 ? batch6 : batch4;
+            CASendBatchAdd(batch, datagram);
+            if (SEND_MMSG_BATCH == batch->count)
+            {
+                CASendBatchFlush(batch, ipv6 ? caglobals.ip.u6.fd : caglobals.ip.u4.fd,
+                                 ipv6 ? "ipv6" : "ipv4");
+            }
+            continue;
+        }
+#endif
+        CAIPSendData(datagram->endpoint, datagram->data, datagram->dataLength, false);
+    }
+
+#ifdef USE_SENDMMSG
+    if (batch6)
+    {
+        CASendBatchFlush(batch6, caglobals.ip.u6.fd, "ipv6");
+        CASendBatchFlush(batch4, caglobals.ip.u4.fd, "ipv4");
+    }
+    OICFree(batch6);
+    OICFree(batch4);
+#endif
+}
+
 CAResult_t CAGetIPInterfaceInformation(CAEndpoint_t **info, size_t *size)
 {
     VERIFY_NON_NULL(info, TAG, "info is NULL");
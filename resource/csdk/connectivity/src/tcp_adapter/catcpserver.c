@@ -36,6 +36,9 @@
 #ifdef HAVE_SYS_POLL_H
 #include <sys/poll.h>
 #endif
+#ifdef HAVE_SYS_EPOLL_H
+#include <sys/epoll.h>
+#endif
 #include <stdio.h>
 #ifdef HAVE_UNISTD_H
 #include <unistd.h>
@@ -88,6 +91,38 @@
  */
 #define TLS_HEADER_SIZE 5
 
+/**
+ * Size of the receive buffers (rfc5246: TLSCiphertext max (2^14+2048+5)).
+ */
+#define TCP_RECV_BUF_LEN 18437
+
+/**
+ * Initial and maximum size of the per-session queue of data waiting for
+ * a non-blocking socket to become writable.
+ */
+#define TCP_SEND_BUF_INIT_LEN 4096
+#define TCP_SEND_BUF_MAX_LEN (1024 * 1024)
+
+/*
+ * On Linux the receive thread waits on a persistent epoll set, and session
+ * sockets are non-blocking with their unsent data queued in the session.
+ * select() is used everywhere else, and also on Linux if the epoll set
+ * cannot be created.
+ */
+#if defined(__linux__) && defined(HAVE_SYS_EPOLL_H) && !defined(__ANDROID__)
+#define USE_EPOLL
+
+/**
+ * Maximum number of ready fds returned by one epoll_wait() call.
+ */
+#define EPOLL_MAX_EVENTS 64
+
+/**
+ * Maximum number of connections accepted for one readiness event.
+ */
+#define ACCEPT_BATCH 64
+#endif
+
 /**
  * Mutex to synchronize device object list.
  */
@@ -118,12 +153,35 @@ static CATCPConnectionHandleCallback g_connectionCallback = NULL;
  */
 static CATCPSessionInfo_t *g_sessionList = NULL;
 
+/**
+ * Index of g_sessionList by socket fd.
+ */
+static CATCPSessionInfo_t *g_sessionByFd = NULL;
+
+/**
+ * Index of g_sessionList by remote address and port. Sessions sharing a key
+ * are chained through nextSameKey.
+ */
+static CATCPSessionInfo_t *g_sessionByKey = NULL;
+
+/**
+ * Receive buffer for non-secure sessions, used by the receive thread only.
+ */
+static unsigned char g_recvBuffer[TCP_RECV_BUF_LEN];
+
+#ifdef USE_EPOLL
+/**
+ * epoll set of the receive thread, or -1 when select() is used.
+ */
+static int g_epollFd = -1;
+#endif
+
 static CAResult_t CATCPCreateMutex(void);
 static void CATCPDestroyMutex(void);
 static CAResult_t CATCPCreateCond(void);
 static void CATCPDestroyCond(void);
 static CASocketFd_t CACreateAcceptSocket(int family, CASocket_t *sock);
-static void CAAcceptConnection(CATransportFlags_t flag, CASocket_t *sock);
+static bool CAAcceptConnection(CATransportFlags_t flag, CASocket_t *sock);
 static void CAFindReadyMessage();
 #if !defined(WSA_WAIT_EVENT_0)
 static void CASelectReturned(fd_set *readFds);
@@ -207,6 +265,238 @@ static CAResult_t CATCPCreateCond(void)
     return CA_STATUS_OK;
 }
 
+/*
+ * Session list and index maintenance. All of these must be called with
+ * g_mutexObjectList held.
+ */
+
+static void CATCPSetSessionKey(CATCPSessionInfo_t *session)
+{
+    memset(&session->key, 0, sizeof (session->key));
+    OICStrcpy(session->key.addr, sizeof (session->key.addr), session->sep.endpoint.addr);
+    session->key.port = session->sep.endpoint.port;
+}
+
+static void CATCPAddSession(CATCPSessionInfo_t *session)
+{
+    LL_APPEND(g_sessionList, session);
+
+    CATCPSetSessionKey(session);
+    session->nextSameKey = NULL;
+
+    CATCPSessionInfo_t *head = NULL;
+    HASH_FIND(hhKey, g_sessionByKey, &session->key, sizeof (session->key), head);
+    if (head)
+    {
+        // keep the oldest session first, as the list walk used to
+        CATCPSessionInfo_t *last = head;
+        while (last->nextSameKey)
+        {
+            last = last->nextSameKey;
+        }
+        last->nextSameKey = session;
+    }
+    else
+    {
+        HASH_ADD(hhKey, g_sessionByKey, key, sizeof (session->key), session);
+    }
+}
+
+static void CATCPIndexSessionFd(CATCPSessionInfo_t *session)
+{
+    if (!session->fdIndexed && OC_INVALID_SOCKET != session->fd)
+    {
+        HASH_ADD(hhFd, g_sessionByFd, fd, sizeof (session->fd), session);
+        session->fdIndexed = true;
+    }
+}
+
+static void CATCPRemoveSession(CATCPSessionInfo_t *session)
+{
+    LL_DELETE(g_sessionList, session);
+
+    if (session->fdIndexed)
+    {
+        HASH_DELETE(hhFd, g_sessionByFd, session);
+        session->fdIndexed = false;
+    }
+
+    CATCPSessionInfo_t *head = NULL;
+    HASH_FIND(hhKey, g_sessionByKey, &session->key, sizeof (session->key), head);
+    if (head == session)
+    {
+        HASH_DELETE(hhKey, g_sessionByKey, session);
+        if (session->nextSameKey)
+        {
+            CATCPSessionInfo_t *next = session->nextSameKey;
+            HASH_ADD(hhKey, g_sessionByKey, key, sizeof (next->key), next);
+        }
+    }
+    else
+    {
+        for (CATCPSessionInfo_t *prev = head; prev; prev = prev->nextSameKey)
+        {
+            if (prev->nextSameKey == session)
+            {
+                prev->nextSameKey = session->nextSameKey;
+                break;
+            }
+        }
+    }
+    session->nextSameKey = NULL;
+}
+
+static CATCPSessionInfo_t *CATCPFindSession(const CAEndpoint_t *endpoint)
+{
+    CATCPSessionKey_t key;
+    memset(&key, 0, sizeof (key));
+    OICStrcpy(key.addr, sizeof (key.addr), endpoint->addr);
+    key.port = endpoint->port;
+
+    CATCPSessionInfo_t *session = NULL;
+    HASH_FIND(hhKey, g_sessionByKey, &key, sizeof (key), session);
+    for (; session; session = session->nextSameKey)
+    {
+        if (session->sep.endpoint.flags & endpoint->flags)
+        {
+            return session;
+        }
+    }
+    return NULL;
+}
+
+#if defined(USE_EPOLL) || defined(WSA_WAIT_EVENT_0)
+static CATCPSessionInfo_t *CATCPFindSessionByFd(CASocketFd_t fd)
+{
+    CATCPSessionInfo_t *session = NULL;
+    HASH_FIND(hhFd, g_sessionByFd, &fd, sizeof (fd), session);
+    return session;
+}
+#endif
+
+#ifdef USE_EPOLL
+static bool CATCPEpollControl(int op, CASocketFd_t fd, uint32_t events)
+{
+    struct epoll_event event = { .events = events, .data.fd = fd };
+    if (-1 == epoll_ctl(g_epollFd, op, fd, &event))
+    {
+        OIC_LOG_V(ERROR, TAG, "epoll_ctl(%d, %d) failed: %s", op, fd, strerror(errno));
+        return false;
+    }
+    return true;
+}
+
+static bool CATCPSetNonBlocking(CASocketFd_t fd)
+{
+    int fl = fcntl(fd, F_GETFL);
+    if (-1 == fl || -1 == fcntl(fd, F_SETFL, fl | O_NONBLOCK))
+    {
+        OIC_LOG_V(ERROR, TAG, "set O_NONBLOCK failed: %s", strerror(errno));
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Make a connected session socket non-blocking and add it to the epoll set.
+ */
+static bool CATCPEpollAddSession(CATCPSessionInfo_t *session)
+{
+    if (-1 == g_epollFd)
+    {
+        return true;
+    }
+    return CATCPSetNonBlocking(session->fd)
+           && CATCPEpollControl(EPOLL_CTL_ADD, session->fd, EPOLLIN);
+}
+
+/**
+ * Append data to the session send queue and ask for EPOLLOUT.
+ * Called with g_mutexObjectList held.
+ */
+static CAResult_t CATCPQueueSendData(CATCPSessionInfo_t *session,
+                                     const unsigned char *data, size_t dlen)
+{
+    if (session->sendBufLen + dlen > TCP_SEND_BUF_MAX_LEN)
+    {
+        OIC_LOG_V(ERROR, TAG, "send queue full (%" PRIuPTR " bytes)", session->sendBufLen);
+        return CA_SEND_FAILED;
+    }
+
+    if (session->sendBufStart + session->sendBufLen + dlen > session->sendBufSize)
+    {
+        if (session->sendBufStart)
+        {
+            memmove(session->sendBuf, session->sendBuf + session->sendBufStart,
+                    session->sendBufLen);
+            session->sendBufStart = 0;
+        }
+
+        if (session->sendBufLen + dlen > session->sendBufSize)
+        {
+            size_t size = session->sendBufSize ? session->sendBufSize : TCP_SEND_BUF_INIT_LEN;
+            while (size < session->sendBufLen + dlen)
+            {
+                size *= 2;
+            }
+            unsigned char *buf = (unsigned char *)OICRealloc(session->sendBuf, size);
+            if (!buf)
+            {
+                OIC_LOG(ERROR, TAG, "OICRealloc - out of memory");
+                return CA_MEMORY_ALLOC_FAILED;
+            }
+            session->sendBuf = buf;
+            session->sendBufSize = size;
+        }
+    }
+
+    bool wasEmpty = (0 == session->sendBufLen);
+    memcpy(session->sendBuf + session->sendBufStart + session->sendBufLen, data, dlen);
+    session->sendBufLen += dlen;
+
+    if (wasEmpty && !CATCPEpollControl(EPOLL_CTL_MOD, session->fd, EPOLLIN | EPOLLOUT))
+    {
+        return CA_SEND_FAILED;
+    }
+    return CA_STATUS_OK;
+}
+
+/**
+ * Write as much of the session send queue as the socket accepts.
+ * Called with g_mutexObjectList held.
+ */
+static CAResult_t CATCPFlushSendData(CATCPSessionInfo_t *session)
+{
+    while (session->sendBufLen > 0)
+    {
+        ssize_t len = send(session->fd, session->sendBuf + session->sendBufStart,
+                           session->sendBufLen, 0);
+        if (-1 == len)
+        {
+            if (EINTR == errno)
+            {
+                continue;
+            }
+            if (EAGAIN == errno || EWOULDBLOCK == errno)
+            {
+                return CA_STATUS_OK;
+            }
+            OIC_LOG_V(ERROR, TAG, "send queued data failed: %s", strerror(errno));
+            return CA_SEND_FAILED;
+        }
+        session->sendBufStart += len;
+        session->sendBufLen -= len;
+    }
+
+    session->sendBufStart = 0;
+    if (!CATCPEpollControl(EPOLL_CTL_MOD, session->fd, EPOLLIN))
+    {
+        return CA_SEND_FAILED;
+    }
+    return CA_STATUS_OK;
+}
+#endif // USE_EPOLL
+
 static void CAReceiveHandler(void *data)
 {
     (void)data;
@@ -226,8 +516,155 @@ static void CAReceiveHandler(void *data)
 
 #if !defined(WSA_WAIT_EVENT_0)
 
+/**
+ * Close the TLS context of a failed session and remove it.
+ * Called with g_mutexObjectList held.
+ */
+static void CATCPCloseFailedSession(CATCPSessionInfo_t *session)
+{
+#ifdef __WITH_TLS__
+    if (CA_STATUS_OK != CAcloseSslConnection(&session->sep.endpoint))
+    {
+        OIC_LOG(ERROR, TAG, "Failed to close TLS session");
+    }
+#endif
+    CATCPRemoveSession(session);
+    CADisconnectTCPSession(session);
+}
+
+#ifdef USE_EPOLL
+
+static void CATCPInitializeEpoll()
+{
+    g_epollFd = epoll_create1(EPOLL_CLOEXEC);
+    if (-1 == g_epollFd)
+    {
+        OIC_LOG_V(ERROR, TAG, "epoll_create1 failed: %s, using select", strerror(errno));
+        return;
+    }
+
+    // Accept sockets are drained in batches, so they must not block either.
+    CASocketFd_t listenFds[] = { caglobals.tcp.ipv4.fd, caglobals.tcp.ipv4s.fd,
+                                 caglobals.tcp.ipv6.fd, caglobals.tcp.ipv6s.fd };
+    bool ok = true;
+    for (size_t i = 0; ok && i < sizeof (listenFds) / sizeof (listenFds[0]); i++)
+    {
+        if (OC_INVALID_SOCKET != listenFds[i])
+        {
+            ok = CATCPSetNonBlocking(listenFds[i])
+                 && CATCPEpollControl(EPOLL_CTL_ADD, listenFds[i], EPOLLIN);
+        }
+    }
+    if (ok && OC_INVALID_SOCKET != caglobals.tcp.shutdownFds[0])
+    {
+        ok = CATCPEpollControl(EPOLL_CTL_ADD, caglobals.tcp.shutdownFds[0], EPOLLIN);
+    }
+
+    if (!ok)
+    {
+        OIC_LOG(ERROR, TAG, "epoll set up failed, using select");
+        for (size_t i = 0; i < sizeof (listenFds) / sizeof (listenFds[0]); i++)
+        {
+            if (OC_INVALID_SOCKET != listenFds[i])
+            {
+                int fl = fcntl(listenFds[i], F_GETFL);
+                (void)fcntl(listenFds[i], F_SETFL, fl & ~O_NONBLOCK);
+            }
+        }
+        close(g_epollFd);
+        g_epollFd = -1;
+    }
+}
+
+static void CAEpollSessionReturned(CASocketFd_t fd, uint32_t events)
+{
+    oc_mutex_lock(g_mutexObjectList);
+    CATCPSessionInfo_t *session = CATCPFindSessionByFd(fd);
+    if (session)
+    {
+        CAResult_t res = CA_STATUS_OK;
+        if (events & EPOLLOUT)
+        {
+            res = CATCPFlushSendData(session);
+        }
+        if (CA_STATUS_OK == res && (events & (EPOLLIN | EPOLLHUP | EPOLLERR)))
+        {
+            res = CAReceiveMessage(session);
+        }
+        //disconnect session and clean-up data if any error occurs
+        if (CA_STATUS_OK != res)
+        {
+            CATCPCloseFailedSession(session);
+        }
+    }
+    oc_mutex_unlock(g_mutexObjectList);
+}
+
+#define EPOLL_ACCEPT(TYPE, FLAGS) \
+    if (caglobals.tcp.TYPE.fd != OC_INVALID_SOCKET && caglobals.tcp.TYPE.fd == fd) \
+    { \
+        for (int n = 0; n < ACCEPT_BATCH && CAAcceptConnection(FLAGS, &caglobals.tcp.TYPE); n++) \
+        { \
+        } \
+    }
+
+static void CAEpollFindReadyMessage()
+{
+    struct epoll_event events[EPOLL_MAX_EVENTS];
+
+    int ret = epoll_wait(g_epollFd, events, EPOLL_MAX_EVENTS,
+                         caglobals.tcp.selectTimeout * 1000);
+
+    if (caglobals.tcp.terminate)
+    {
+        OIC_LOG_V(DEBUG, TAG, "Packet receiver Stop request received.");
+        return;
+    }
+
+    if (0 > ret)
+    {
+        if (EINTR != errno)
+        {
+            OIC_LOG_V(FATAL, TAG, "epoll_wait error %s", strerror(errno));
+        }
+        return;
+    }
+
+    for (int i = 0; i < ret && !caglobals.tcp.terminate; i++)
+    {
+        CASocketFd_t fd = events[i].data.fd;
+
+        EPOLL_ACCEPT(ipv4, CA_IPV4)
+        else EPOLL_ACCEPT(ipv4s, CA_IPV4 | CA_SECURE)
+        else EPOLL_ACCEPT(ipv6, CA_IPV6)
+        else EPOLL_ACCEPT(ipv6s, CA_IPV6 | CA_SECURE)
+        else if (fd == caglobals.tcp.shutdownFds[0])
+        {
+            char buf[MAX_ADDR_STR_SIZE_CA] = {0};
+            if (-1 == read(fd, buf, sizeof (buf)))
+            {
+                OIC_LOG_V(DEBUG, TAG, "shutdown read failed: %s", strerror(errno));
+            }
+        }
+        else
+        {
+            CAEpollSessionReturned(fd, events[i].events);
+        }
+    }
+}
+
+#endif // USE_EPOLL
+
 static void CAFindReadyMessage()
 {
+#ifdef USE_EPOLL
+    if (-1 != g_epollFd)
+    {
+        CAEpollFindReadyMessage();
+        return;
+    }
+#endif
+
     fd_set readFds;
     struct timeval timeout = { .tv_sec = caglobals.tcp.selectTimeout };
 
@@ -331,14 +768,7 @@ static void CASelectReturned(fd_set *readFds)
                     //disconnect session and clean-up data if any error occurs
                     if (res != CA_STATUS_OK)
                     {
-#ifdef __WITH_TLS__
-                        if (CA_STATUS_OK != CAcloseSslConnection(&session->sep.endpoint))
-                        {
-                            OIC_LOG(ERROR, TAG, "Failed to close TLS session");
-                        }
-#endif
-                        LL_DELETE(g_sessionList, session);
-                        CADisconnectTCPSession(session);
+                        CATCPCloseFailedSession(session);
                         oc_mutex_unlock(g_mutexObjectList);
                         return;
                     }
@@ -535,27 +965,21 @@ static void CASocketEventReturned(CASocketFd_t s, long networkEvents)
     if (FD_READ & networkEvents)
     {
         oc_mutex_lock(g_mutexObjectList);
-        CATCPSessionInfo_t *session = NULL;
-        CATCPSessionInfo_t *tmp = NULL;
-        LL_FOREACH_SAFE(g_sessionList, session, tmp)
+        CATCPSessionInfo_t *session = CATCPFindSessionByFd(s);
+        if (session)
         {
-            if (session && (session->fd == s))
+            CAResult_t res = CAReceiveMessage(session);
+            //disconnect session and clean-up data if any error occurs
+            if (res != CA_STATUS_OK)
             {
-                CAResult_t res = CAReceiveMessage(session);
-                //disconnect session and clean-up data if any error occurs
-                if (res != CA_STATUS_OK)
-                {
 #ifdef __WITH_TLS__
-                    if (CA_STATUS_OK != CAcloseSslConnection(&session->sep.endpoint))
-                    {
-                        OIC_LOG(ERROR, TAG, "Failed to close TLS session");
-                    }
-#endif
-                    LL_DELETE(g_sessionList, session);
-                    CADisconnectTCPSession(session);
-                    oc_mutex_unlock(g_mutexObjectList);
-                    return;
+                if (CA_STATUS_OK != CAcloseSslConnection(&session->sep.endpoint))
+                {
+                    OIC_LOG(ERROR, TAG, "Failed to close TLS session");
                 }
+#endif
+                CATCPRemoveSession(session);
+                CADisconnectTCPSession(session);
             }
         }
         oc_mutex_unlock(g_mutexObjectList);
@@ -564,9 +988,15 @@ static void CASocketEventReturned(CASocketFd_t s, long networkEvents)
 
 #endif // WSA_WAIT_EVENT_0
 
-static void CAAcceptConnection(CATransportFlags_t flag, CASocket_t *sock)
+/**
+ * Accept one pending connection on a listening socket.
+ *
+ * @return true if a connection was accepted, false if none was pending or
+ *         it could not be set up.
+ */
+static bool CAAcceptConnection(CATransportFlags_t flag, CASocket_t *sock)
 {
-    VERIFY_NON_NULL_VOID(sock, TAG, "sock is NULL");
+    VERIFY_NON_NULL_RET(sock, TAG, "sock is NULL", false);
 
     struct sockaddr_storage clientaddr;
     socklen_t clientlen = sizeof (struct sockaddr_in);
@@ -584,7 +1014,7 @@ static void CAAcceptConnection(CATransportFlags_t flag, CASocket_t *sock)
         {
             OIC_LOG(ERROR, TAG, "Out of memory");
             OC_CLOSE_SOCKET(sockfd);
-            return;
+            return false;
         }
 
         svritem->fd = sockfd;
@@ -596,7 +1026,17 @@ static void CAAcceptConnection(CATransportFlags_t flag, CASocket_t *sock)
                             svritem->sep.endpoint.addr, &svritem->sep.endpoint.port);
 
         oc_mutex_lock(g_mutexObjectList);
-        LL_APPEND(g_sessionList, svritem);
+#ifdef USE_EPOLL
+        if (!CATCPEpollAddSession(svritem))
+        {
+            oc_mutex_unlock(g_mutexObjectList);
+            OC_CLOSE_SOCKET(sockfd);
+            OICFree(svritem);
+            return false;
+        }
+#endif
+        CATCPAddSession(svritem);
+        CATCPIndexSessionFd(svritem);
         oc_mutex_unlock(g_mutexObjectList);
 
         CHECKFD(sockfd);
@@ -606,7 +1046,9 @@ static void CAAcceptConnection(CATransportFlags_t flag, CASocket_t *sock)
         {
             g_connectionCallback(&(svritem->sep.endpoint), true, svritem->isClient);
         }
+        return true;
     }
+    return false;
 }
 
 /**
@@ -758,6 +1200,16 @@ static CAResult_t CAReceiveMessage(CATCPSessionInfo_t *svritem)
         size_t nbRead = 0;
         size_t tlsLength = 0;
 
+        if (!svritem->tlsdata)
+        {
+            svritem->tlsdata = (unsigned char *)OICMalloc(TCP_RECV_BUF_LEN);
+            if (!svritem->tlsdata)
+            {
+                OIC_LOG(ERROR, TAG, "OICMalloc - out of memory");
+                return CA_MEMORY_ALLOC_FAILED;
+            }
+        }
+
         if (TLS_HEADER_SIZE > svritem->tlsLen)
         {
             nbRead = TLS_HEADER_SIZE - svritem->tlsLen;
@@ -768,22 +1220,22 @@ static CAResult_t CAReceiveMessage(CATCPSessionInfo_t *svritem)
             tlsLength = TLS_HEADER_SIZE +
                             (size_t)((svritem->tlsdata[3] << 8) | svritem->tlsdata[4]);
             OIC_LOG_V(DEBUG, TAG, "total tls length = %" PRIuPTR, tlsLength);
-            if (tlsLength > sizeof(svritem->tlsdata))
+            if (tlsLength > TCP_RECV_BUF_LEN)
             {
-                OIC_LOG_V(ERROR, TAG, "total tls length is too big (buffer size : %" PRIuPTR ")",
-                                    sizeof(svritem->tlsdata));
-                if (CA_STATUS_OK != CAcloseSslConnection(&svritem->sep.endpoint))
-                {
-                    OIC_LOG(ERROR, TAG, "Failed to close TLS session");
-                }
-                CASearchAndDeleteTCPSession(&(svritem->sep.endpoint));
+                OIC_LOG_V(ERROR, TAG, "total tls length is too big (buffer size : %d)",
+                                    TCP_RECV_BUF_LEN);
+                // the caller closes the TLS session and removes svritem
                 return CA_RECEIVE_FAILED;
             }
             nbRead = tlsLength - svritem->tlsLen;
         }
 
         len = recv(svritem->fd, (char*)svritem->tlsdata + svritem->tlsLen, (int)nbRead, 0);
-        if (len < 0)
+        if (len < 0 && (EAGAIN == errno || EWOULDBLOCK == errno || EINTR == errno))
+        {
+            // non-blocking socket with nothing to read yet
+        }
+        else if (len < 0)
         {
             OIC_LOG_V(ERROR, TAG, "recv failed %s", strerror(errno));
             res = CA_RECEIVE_FAILED;
@@ -813,9 +1265,13 @@ static CAResult_t CAReceiveMessage(CATCPSessionInfo_t *svritem)
     {
         svritem->protocol = COAP;
 
-        // svritem->tlsdata can also be used as receiving buffer in case of raw tcp
-        len = recv(svritem->fd, (char*)svritem->tlsdata, sizeof(svritem->tlsdata), 0);
-        if (len < 0)
+        // raw tcp data is passed on at once, so the shared buffer is enough
+        len = recv(svritem->fd, (char*)g_recvBuffer, sizeof(g_recvBuffer), 0);
+        if (len < 0 && (EAGAIN == errno || EWOULDBLOCK == errno || EINTR == errno))
+        {
+            // non-blocking socket with nothing to read yet
+        }
+        else if (len < 0)
         {
             OIC_LOG_V(ERROR, TAG, "recv failed %s", strerror(errno));
             res = CA_RECEIVE_FAILED;
@@ -831,7 +1287,7 @@ static CAResult_t CAReceiveMessage(CATCPSessionInfo_t *svritem)
             //when successfully read data - pass them to callback.
             if (g_packetReceivedCallback)
             {
-                g_packetReceivedCallback(&svritem->sep, svritem->tlsdata, len);
+                g_packetReceivedCallback(&svritem->sep, g_recvBuffer, len);
             }
         }
     }
@@ -920,6 +1376,20 @@ static CAResult_t CATCPCreateSocket(int family, CATCPSessionInfo_t *svritem)
     OIC_LOG(DEBUG, TAG, "connect socket success");
     svritem->state = CONNECTED;
     CHECKFD(svritem->fd);
+
+    oc_mutex_lock(g_mutexObjectList);
+    CATCPIndexSessionFd(svritem);
+#ifdef USE_EPOLL
+    if (-1 != g_epollFd)
+    {
+        // the epoll set is updated in place, no need to wake the receive thread
+        bool added = CATCPEpollAddSession(svritem);
+        oc_mutex_unlock(g_mutexObjectList);
+        return added ? CA_STATUS_OK : CA_SOCKET_OPERATION_FAILED;
+    }
+#endif
+    oc_mutex_unlock(g_mutexObjectList);
+
 #if !defined(WSA_WAIT_EVENT_0)
     ssize_t len = CAWakeUpForReadFdsUpdate(svritem->sep.endpoint.addr);
     if (-1 == len)
@@ -1122,8 +1592,12 @@ CAResult_t CATCPStartServer(const ca_thread_pool_t threadPool)
     CHECKFD(caglobals.tcp.connectionFds[1]);
 #endif
 
+#ifdef USE_EPOLL
+    CATCPInitializeEpoll();
+#endif
+
     caglobals.tcp.terminate = false;
-    res = ca_thread_pool_add_task(threadPool, CAReceiveHandler, NULL);
+    res = ca_thread_pool_add_long_running_task(threadPool, CAReceiveHandler, NULL);
     if (CA_STATUS_OK != res)
     {
         OIC_LOG(ERROR, TAG, "thread_pool_add_task failed");
@@ -1190,6 +1664,14 @@ void CATCPStopServer(void)
     caglobals.tcp.shutdownFds[0] = OC_INVALID_SOCKET;
 #endif
 
+#ifdef USE_EPOLL
+    if (-1 != g_epollFd)
+    {
+        close(g_epollFd);
+        g_epollFd = -1;
+    }
+#endif
+
     // mutex unlock
     oc_mutex_unlock(g_mutexObjectList);
 
@@ -1267,6 +1749,67 @@ static ssize_t sendData(const CAEndpoint_t *endpoint, const void *data,
         }
     }
 
+#ifdef USE_EPOLL
+    if (-1 != g_epollFd)
+    {
+        // #2. send what the non-blocking socket takes now and queue the rest
+        // for EPOLLOUT, after anything queued earlier.
+        oc_mutex_lock(g_mutexObjectList);
+        CATCPSessionInfo_t *session = CATCPFindSession(endpoint);
+        if (!session || OC_INVALID_SOCKET == session->fd)
+        {
+            oc_mutex_unlock(g_mutexObjectList);
+            OIC_LOG(ERROR, TAG, "session closed before send");
+            return -1;
+        }
+
+        const unsigned char *buf = (const unsigned char *)data;
+        size_t remain = dlen;
+        while (remain > 0 && 0 == session->sendBufLen)
+        {
+            ssize_t len = send(session->fd, buf, remain, 0);
+            if (-1 == len)
+            {
+                if (EINTR == errno)
+                {
+                    continue;
+                }
+                if (EAGAIN == errno || EWOULDBLOCK == errno)
+                {
+                    break;
+                }
+                oc_mutex_unlock(g_mutexObjectList);
+                OIC_LOG_V(ERROR, TAG, "unicast %stcp sendTo failed: %s", fam, strerror(errno));
+                CALogSendStateInfo(endpoint->adapter, endpoint->addr, endpoint->port,
+                                   len, false, strerror(errno));
+                return len;
+            }
+            buf += len;
+            remain -= len;
+        }
+
+        CAResult_t res = CA_STATUS_OK;
+        if (remain > 0)
+        {
+            res = CATCPQueueSendData(session, buf, remain);
+        }
+        oc_mutex_unlock(g_mutexObjectList);
+
+        if (CA_STATUS_OK != res)
+        {
+            CALogSendStateInfo(endpoint->adapter, endpoint->addr, endpoint->port,
+                               0, false, "send queue failed");
+            return -1;
+        }
+
+        OIC_LOG_V(INFO, TAG, "unicast %stcp sendTo is successful: %" PRIuPTR " bytes, %"
+                  PRIuPTR " queued", fam, dlen, remain);
+        CALogSendStateInfo(endpoint->adapter, endpoint->addr, endpoint->port,
+                           dlen, true, NULL);
+        return dlen;
+    }
+#endif
+
     // #2. send data to remote device.
     ssize_t remainLen = dlen;
     do
@@ -1445,7 +1988,7 @@ CASocketFd_t CAConnectTCPSession(const CAEndpoint_t *endpoint)
 
     // #2. add TCP connection info to list
     oc_mutex_lock(g_mutexObjectList);
-    LL_APPEND(g_sessionList, svritem);
+    CATCPAddSession(svritem);
     oc_mutex_unlock(g_mutexObjectList);
 
     // #3. create the socket and connect to TCP server
@@ -1488,6 +2031,10 @@ CAResult_t CADisconnectTCPSession(CATCPSessionInfo_t *removedData)
     }
     OICFree(removedData->data);
     removedData->data = NULL;
+    OICFree(removedData->tlsdata);
+    removedData->tlsdata = NULL;
+    OICFree(removedData->sendBuf);
+    removedData->sendBuf = NULL;
 
     OICFree(removedData);
 
@@ -1504,7 +2051,7 @@ void CATCPDisconnectAll(void)
     {
         if (session)
         {
-            LL_DELETE(g_sessionList, session);
+            CATCPRemoveSession(session);
             // disconnect session from remote device.
             CADisconnectTCPSession(session);
         }
@@ -1526,17 +2073,11 @@ CATCPSessionInfo_t *CAGetTCPSessionInfoFromEndpoint(const CAEndpoint_t *endpoint
     OIC_LOG_V(DEBUG, TAG, "Looking for [%s:%d]", endpoint->addr, endpoint->port);
 
     // get connection info from list
-    CATCPSessionInfo_t *session = NULL;
-    LL_FOREACH(g_sessionList, session)
+    CATCPSessionInfo_t *session = CATCPFindSession(endpoint);
+    if (session)
     {
-        if (!strncmp(session->sep.endpoint.addr, endpoint->addr,
-                     sizeof(session->sep.endpoint.addr))
-                && (session->sep.endpoint.port == endpoint->port)
-                && (session->sep.endpoint.flags & endpoint->flags))
-        {
-            OIC_LOG(DEBUG, TAG, "Found in session list");
-            return session;
-        }
+        OIC_LOG(DEBUG, TAG, "Found in session list");
+        return session;
     }
 
     OIC_LOG(DEBUG, TAG, "Session not found");
@@ -1551,18 +2092,13 @@ CASocketFd_t CAGetSocketFDFromEndpoint(const CAEndpoint_t *endpoint)
 
     // get connection info from list.
     oc_mutex_lock(g_mutexObjectList);
-    CATCPSessionInfo_t *session = NULL;
-    LL_FOREACH(g_sessionList, session)
+    CATCPSessionInfo_t *session = CATCPFindSession(endpoint);
+    if (session)
     {
-        if (!strncmp(session->sep.endpoint.addr, endpoint->addr,
-                     sizeof(session->sep.endpoint.addr))
-                && (session->sep.endpoint.port == endpoint->port)
-                && (session->sep.endpoint.flags & endpoint->flags))
-        {
-            oc_mutex_unlock(g_mutexObjectList);
-            OIC_LOG(DEBUG, TAG, "Found in session list");
-            return session->fd;
-        }
+        CASocketFd_t fd = session->fd;
+        oc_mutex_unlock(g_mutexObjectList);
+        OIC_LOG(DEBUG, TAG, "Found in session list");
+        return fd;
     }
 
     oc_mutex_unlock(g_mutexObjectList);
@@ -1577,23 +2113,15 @@ CAResult_t CASearchAndDeleteTCPSession(const CAEndpoint_t *endpoint)
     OIC_LOG_V(DEBUG, TAG, "Looking for [%s:%d]", endpoint->addr, endpoint->port);
 
     // get connection info from list
-    CATCPSessionInfo_t *session = NULL;
-    CATCPSessionInfo_t *tmp = NULL;
-
     oc_mutex_lock(g_mutexObjectList);
-    LL_FOREACH_SAFE(g_sessionList, session, tmp)
+    CATCPSessionInfo_t *session = CATCPFindSession(endpoint);
+    if (session)
     {
-        if (!strncmp(session->sep.endpoint.addr, endpoint->addr,
-                     sizeof(session->sep.endpoint.addr))
-                && (session->sep.endpoint.port == endpoint->port)
-                && (session->sep.endpoint.flags & endpoint->flags))
-        {
-            OIC_LOG(DEBUG, TAG, "Found in session list");
-            LL_DELETE(g_sessionList, session);
-            CADisconnectTCPSession(session);
-            oc_mutex_unlock(g_mutexObjectList);
-            return CA_STATUS_OK;
-        }
+        OIC_LOG(DEBUG, TAG, "Found in session list");
+        CATCPRemoveSession(session);
+        CADisconnectTCPSession(session);
+        oc_mutex_unlock(g_mutexObjectList);
+        return CA_STATUS_OK;
     }
     oc_mutex_unlock(g_mutexObjectList);
 
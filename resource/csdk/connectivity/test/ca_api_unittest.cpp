@@ -277,6 +277,53 @@ TEST_F(CATests, CAStopListeningServerTest)
     EXPECT_EQ(CA_STATUS_OK, CAStopListeningServer());
 }
 
+// Every adapter runs its receive and queueing loops on the thread pool of the message
+// handler, those loops must not keep the send queue or CATerminate from running.
+TEST_F(CATests, StartAllAdaptersTest)
+{
+    CARegisterHandler(request_handler, response_handler, error_handler);
+
+#ifdef IP_ADAPTER
+    EXPECT_EQ(CA_STATUS_OK, CASelectNetwork(CA_ADAPTER_IP));
+#endif
+#ifdef LE_ADAPTER
+    EXPECT_EQ(CA_STATUS_OK, CASelectNetwork(CA_ADAPTER_GATT_BTLE));
+#endif
+#ifdef EDR_ADAPTER
+    EXPECT_EQ(CA_STATUS_OK, CASelectNetwork(CA_ADAPTER_RFCOMM_BTEDR));
+#endif
+#ifdef TCP_ADAPTER
+    EXPECT_EQ(CA_STATUS_OK, CASelectNetwork(CA_ADAPTER_TCP));
+#endif
+#ifdef NFC_ADAPTER
+    EXPECT_EQ(CA_STATUS_OK, CASelectNetwork(CA_ADAPTER_NFC));
+#endif
+
+    EXPECT_EQ(CA_STATUS_OK, CAStartListeningServer());
+    EXPECT_EQ(CA_STATUS_OK, CAStartDiscoveryServer());
+
+#ifdef IP_ADAPTER
+    CACreateEndpoint(CA_DEFAULT_FLAGS, CA_ADAPTER_IP, "127.0.0.1", PORT, &tempRep);
+
+    memset(&requestData, 0, sizeof(CAInfo_t));
+    CAGenerateToken(&tempToken, tokenLength);
+    requestData.token = tempToken;
+    requestData.tokenLength = tokenLength;
+    requestData.type = CA_MSG_NONCONFIRM;
+
+    memset(&requestInfo, 0, sizeof(CARequestInfo_t));
+    requestInfo.method = CA_GET;
+    requestInfo.info = requestData;
+
+    EXPECT_EQ(CA_STATUS_OK, CASendRequest(tempRep, &requestInfo));
+    EXPECT_EQ(CA_STATUS_OK, CAHandleRequestResponse());
+
+    CADestroyToken(tempToken);
+    CADestroyEndpoint(tempRep);
+    tempRep = NULL;
+#endif
+}
+
 // CARegisterHandlerTest TC
 TEST_F(CATests, RegisterHandlerTest)
 {
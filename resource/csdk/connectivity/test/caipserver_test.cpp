@@ -0,0 +1,165 @@
+//******************************************************************
+//
+// Copyright 2017 Samsung Electronics All Rights Reserved.
+//
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+
+#include "iotivity_config.h"
+#include <gtest/gtest.h>
+
+#include "cacommon.h"
+#include "caipinterface.h"
+#include "oic_string.h"
+#include "oic_time.h"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include <vector>
+
+// Datagrams sent per measurement, one per observer of a notification.
+static const size_t DATAGRAM_COUNT = 200;
+
+static const size_t DATAGRAM_LENGTH = 64;
+
+// Sends from a plain IPv4 socket of the adapter to a loopback receiver.
+class CAIPSendBatchTests : public testing::Test
+{
+protected:
+    virtual void SetUp()
+    {
+        m_savedSocket = caglobals.ip.u4.fd;
+        m_savedIpv4 = caglobals.ip.ipv4enabled;
+        m_savedIpv6 = caglobals.ip.ipv6enabled;
+
+        m_receiver = socket(AF_INET, SOCK_DGRAM, 0);
+        ASSERT_NE(-1, m_receiver);
+        struct sockaddr_in addr;
+        memset(&addr, 0, sizeof(addr));
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        ASSERT_EQ(0, bind(m_receiver, (struct sockaddr *)&addr, sizeof(addr)));
+        socklen_t len = sizeof(addr);
+        ASSERT_EQ(0, getsockname(m_receiver, (struct sockaddr *)&addr, &len));
+        int rcvbuf = 4 * 1024 * 1024;
+        setsockopt(m_receiver, SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof(rcvbuf));
+        struct timeval timeout = { 1, 0 };
+        setsockopt(m_receiver, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+        m_sender = socket(AF_INET, SOCK_DGRAM, 0);
+        ASSERT_NE(-1, m_sender);
+        caglobals.ip.u4.fd = m_sender;
+        caglobals.ip.ipv4enabled = true;
+        caglobals.ip.ipv6enabled = false;
+
+        memset(&m_endpoint, 0, sizeof(m_endpoint));
+        m_endpoint.adapter = CA_ADAPTER_IP;
+        m_endpoint.flags = CA_IPV4;
+        OICStrcpy(m_endpoint.addr, sizeof(m_endpoint.addr), "127.0.0.1");
+        m_endpoint.port = ntohs(addr.sin_port);
+
+        m_payloads.resize(DATAGRAM_COUNT, std::vector<uint8_t>(DATAGRAM_LENGTH));
+        for (size_t i = 0; i < DATAGRAM_COUNT; i++)
+        {
+            memset(&m_payloads[i][0], (int)(i & 0xFF), DATAGRAM_LENGTH);
+        }
+    }
+
+    virtual void TearDown()
+    {
+        caglobals.ip.u4.fd = m_savedSocket;
+        caglobals.ip.ipv4enabled = m_savedIpv4;
+        caglobals.ip.ipv6enabled = m_savedIpv6;
+        close(m_sender);
+        close(m_receiver);
+    }
+
+    // Checks that every datagram arrived, in the order it was sent.
+    void expectReceivedInOrder()
+    {
+        uint8_t buffer[DATAGRAM_LENGTH * 2];
+        for (size_t i = 0; i < DATAGRAM_COUNT; i++)
+        {
+            ssize_t len = recv(m_receiver, buffer, sizeof(buffer), 0);
+            ASSERT_EQ((ssize_t)DATAGRAM_LENGTH, len);
+            EXPECT_EQ(0, memcmp(buffer, &m_payloads[i][0], DATAGRAM_LENGTH));
+        }
+    }
+
+    CASocketFd_t m_savedSocket;
+    bool m_savedIpv4;
+    bool m_savedIpv6;
+    int m_receiver;
+    int m_sender;
+    CAEndpoint_t m_endpoint;
+    std::vector<std::vector<uint8_t> > m_payloads;
+};
+
+TEST_F(CAIPSendBatchTests, BatchArrivesInOrder)
+{
+    std::vector<CAEndpoint_t> endpoints(DATAGRAM_COUNT, m_endpoint);
+    std::vector<CAIPDatagram_t> datagrams(DATAGRAM_COUNT);
+    for (size_t i = 0; i < DATAGRAM_COUNT; i++)
+    {
+        datagrams[i].endpoint = &endpoints[i];
+        datagrams[i].data = &m_payloads[i][0];
+        datagrams[i].dataLength = DATAGRAM_LENGTH;
+    }
+
+    uint64_t beg = OICGetCurrentTime(TIME_IN_US);
+    CAIPSendDataBatch(&datagrams[0], DATAGRAM_COUNT);
+    uint64_t batched = OICGetCurrentTime(TIME_IN_US) - beg;
+    expectReceivedInOrder();
+
+    beg = OICGetCurrentTime(TIME_IN_US);
+    for (size_t i = 0; i < DATAGRAM_COUNT; i++)
+    {
+        CAIPSendData(&endpoints[i], &m_payloads[i][0], DATAGRAM_LENGTH, false);
+    }
+    uint64_t single = OICGetCurrentTime(TIME_IN_US) - beg;
+    expectReceivedInOrder();
+
+    printf("%zu datagrams: %llu us one by one, %llu us batched\n", DATAGRAM_COUNT,
+           (unsigned long long)single, (unsigned long long)batched);
+}
+
+TEST_F(CAIPSendBatchTests, SkipsInvalidDatagrams)
+{
+    CAIPDatagram_t datagrams[3];
+    datagrams[0].endpoint = NULL;
+    datagrams[0].data = &m_payloads[1][0];
+    datagrams[0].dataLength = DATAGRAM_LENGTH;
+    datagrams[1].endpoint = &m_endpoint;
+    datagrams[1].data = &m_payloads[0][0];
+    datagrams[1].dataLength = DATAGRAM_LENGTH;
+    datagrams[2].endpoint = &m_endpoint;
+    datagrams[2].data = NULL;
+    datagrams[2].dataLength = DATAGRAM_LENGTH;
+
+    CAIPSendDataBatch(NULL, 1);
+    CAIPSendDataBatch(datagrams, 3);
+
+    uint8_t buffer[DATAGRAM_LENGTH * 2];
+    ASSERT_EQ((ssize_t)DATAGRAM_LENGTH, recv(m_receiver, buffer, sizeof(buffer), 0));
+    EXPECT_EQ(0, memcmp(buffer, &m_payloads[0][0], DATAGRAM_LENGTH));
+    EXPECT_EQ(-1, recv(m_receiver, buffer, sizeof(buffer), MSG_DONTWAIT));
+}
@@ -29,6 +29,7 @@
 
 #include "oic_malloc.h"
 #include "caprotocolmessage.h"
+#include "caremotehandler.h"
 
 namespace {
 
@@ -261,3 +262,67 @@ TEST(CAProtocolMessage, CAGetInfoFromPDU)
     coap_delete_list(options);
     coap_delete_pdu(pdu);
 }
+
+// Builds, parses and frees one message, returning the allocations it made.
+static uint32_t roundTripAllocations(const CAEndpoint_t *endpoint)
+{
+    uint32_t before = OICGetAllocationCount();
+
+    CAInfo_t inData;
+    memset(&inData, 0, sizeof(CAInfo_t));
+    inData.token = (CAToken_t)"token";
+    inData.tokenLength = (uint8_t)strlen(inData.token);
+    inData.type = CA_MSG_NONCONFIRM;
+    inData.messageId = 1;
+
+    coap_list_t *options = NULL;
+    coap_transport_t transport = COAP_UDP;
+    coap_pdu_t *sent = CAGeneratePDU(CA_GET, &inData, endpoint, &options, &transport);
+    EXPECT_TRUE(sent != NULL);
+    if (!sent)
+    {
+        coap_delete_list(options);
+        return 0;
+    }
+
+    uint32_t code = CA_NOT_FOUND;
+    coap_pdu_t *received = CAParsePDU((const char *)sent->transport_hdr, sent->length,
+                                      &code, endpoint);
+    EXPECT_TRUE(received != NULL);
+    EXPECT_EQ((uint32_t)CA_GET, code);
+    CAEndpoint_t *clone = CACloneEndpoint(endpoint);
+    EXPECT_TRUE(clone != NULL);
+
+    uint32_t allocations = OICGetAllocationCount() - before;
+
+    CAFreeEndpoint(clone);
+    CADeletePDU(received);
+    coap_delete_list(options);
+    CADeletePDU(sent);
+    return allocations;
+}
+
+TEST(CAProtocolMessage, PooledMessagePathAllocations)
+{
+    CAEndpoint_t tempRep;
+    memset(&tempRep, 0, sizeof(CAEndpoint_t));
+    tempRep.flags = CA_DEFAULT_FLAGS;
+    tempRep.adapter = CA_ADAPTER_IP;
+    tempRep.port = 5683;
+
+    CAInitializePDUPool();
+    CAInitializeEndpointPool();
+    CATerminatePDUPool();
+    CATerminateEndpointPool();
+
+    // the pools are empty, so both PDUs and the endpoint are allocated
+    uint32_t cold = roundTripAllocations(&tempRep);
+    // and are all reused from here on
+    uint32_t warm = roundTripAllocations(&tempRep);
+    EXPECT_EQ(cold - 3, warm);
+    EXPECT_EQ(warm, roundTripAllocations(&tempRep));
+    printf("message path: %u allocations cold, %u warm\n", cold, warm);
+
+    CATerminatePDUPool();
+    CATerminateEndpointPool();
+}
@@ -0,0 +1,308 @@
+//******************************************************************
+//
+// Copyright 2017 Samsung Electronics All Rights Reserved.
+//
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+
+#include "iotivity_config.h"
+#include <gtest/gtest.h>
+
+#include "caqueueingthread.h"
+#include "ocatomic.h"
+#include "oic_time.h"
+
+#include <inttypes.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#ifdef HAVE_UNISTD_H
+#include <unistd.h>
+#endif
+
+#define PRODUCER_COUNT 4
+#define PRODUCER_PACKETS 20000
+#define QUEUE_CAPACITY 1024
+
+static const int WAIT_SECONDS = 60;
+
+static volatile int32_t g_processed = 0;
+static volatile int32_t g_destroyed = 0;
+
+static void countTask(void *data)
+{
+    (void)data;
+    oc_atomic_increment(&g_processed);
+}
+
+static void slowTask(void *data)
+{
+    (void)data;
+    usleep(100);
+    oc_atomic_increment(&g_processed);
+}
+
+// The packets are tagged pointers, not allocations.
+static void countDestroy(void *data, uint32_t size)
+{
+    (void)data;
+    (void)size;
+    oc_atomic_increment(&g_destroyed);
+}
+
+static void *packet(uint32_t index)
+{
+    return (void *)(uintptr_t)(index + 1);
+}
+
+static bool waitForProcessed(int32_t expected)
+{
+    for (int i = 0; i < WAIT_SECONDS * 1000; i++)
+    {
+        if (oc_atomic_add(&g_processed, 0) >= expected)
+        {
+            return true;
+        }
+        usleep(1000);
+    }
+    return false;
+}
+
+static void *produce(void *arg)
+{
+    CAQueueingThread_t *thread = (CAQueueingThread_t *)arg;
+    for (uint32_t i = 0; i < PRODUCER_PACKETS; i++)
+    {
+        CAQueueingThreadAddData(thread, packet(i), sizeof(uint32_t));
+    }
+    return NULL;
+}
+
+class CAQueueingThreadTests : public testing::Test
+{
+protected:
+    virtual void SetUp()
+    {
+        g_processed = 0;
+        g_destroyed = 0;
+        memset(&m_thread, 0, sizeof (m_thread));
+        ASSERT_EQ(CA_STATUS_OK, ca_thread_pool_init(PRODUCER_COUNT + 1, &m_threadPool));
+    }
+
+    virtual void TearDown()
+    {
+        CAQueueingThreadStop(&m_thread);
+        CAQueueingThreadDestroy(&m_thread);
+        ca_thread_pool_free(m_threadPool);
+    }
+
+    // Returns packets per second from PRODUCER_COUNT producers to the queueing thread.
+    uint64_t measure()
+    {
+        oc_thread producers[PRODUCER_COUNT];
+        uint64_t beg = OICGetCurrentTime(TIME_IN_US);
+        for (int p = 0; p < PRODUCER_COUNT; p++)
+        {
+            EXPECT_EQ(OC_THREAD_SUCCESS, oc_thread_new(&producers[p], produce, &m_thread));
+        }
+        for (int p = 0; p < PRODUCER_COUNT; p++)
+        {
+            oc_thread_wait(producers[p]);
+            oc_thread_free(producers[p]);
+        }
+        EXPECT_TRUE(waitForProcessed(PRODUCER_COUNT * PRODUCER_PACKETS));
+        uint64_t elapsed = OICGetCurrentTime(TIME_IN_US) - beg;
+        return (uint64_t)PRODUCER_COUNT * PRODUCER_PACKETS * 1000000 / (elapsed ? elapsed : 1);
+    }
+
+    ca_thread_pool_t m_threadPool;
+    CAQueueingThread_t m_thread;
+};
+
+TEST_F(CAQueueingThreadTests, ListQueueThroughput)
+{
+    ASSERT_EQ(CA_STATUS_OK, CAQueueingThreadInitialize(&m_thread, m_threadPool,
+                                                       countTask, countDestroy));
+    ASSERT_EQ(CA_STATUS_OK, CAQueueingThreadStart(&m_thread));
+
+    uint64_t pps = measure();
+    printf("list queue: %d producers, %" PRIu64 " packets/s\n", PRODUCER_COUNT, pps);
+}
+
+TEST_F(CAQueueingThreadTests, BoundedQueueThroughput)
+{
+    // producers wait as long as it takes, so nothing is dropped
+    ASSERT_EQ(CA_STATUS_OK, CAQueueingThreadInitializeBounded(&m_thread, m_threadPool,
+                                                              countTask, countDestroy,
+                                                              QUEUE_CAPACITY,
+                                                              WAIT_SECONDS * 1000000ULL));
+    ASSERT_EQ(CA_STATUS_OK, CAQueueingThreadStart(&m_thread));
+
+    uint64_t pps = measure();
+    EXPECT_EQ(0, m_thread.droppedCount);
+    printf("bounded queue: %d producers, %" PRIu64 " packets/s\n", PRODUCER_COUNT, pps);
+}
+
+TEST_F(CAQueueingThreadTests, FullBoundedQueueDropsNewest)
+{
+    ASSERT_EQ(CA_STATUS_OK, CAQueueingThreadInitializeBounded(&m_thread, m_threadPool,
+                                                              countTask, countDestroy, 4, 0));
+
+    // not started, so nothing is taken off the queue
+    for (uint32_t i = 0; i < 4; i++)
+    {
+        EXPECT_EQ(CA_STATUS_OK, CAQueueingThreadAddData(&m_thread, packet(i), i + 1));
+    }
+    EXPECT_EQ(CA_SEND_FAILED, CAQueueingThreadAddData(&m_thread, packet(4), 5));
+    EXPECT_EQ(1, g_destroyed);
+    EXPECT_EQ(1, m_thread.droppedCount);
+
+    void *data = NULL;
+    uint32_t size = 0;
+    for (uint32_t i = 0; i < 4; i++)
+    {
+        ASSERT_TRUE(CAQueueingThreadGetData(&m_thread, &data, &size));
+        EXPECT_EQ(packet(i), data);
+        EXPECT_EQ(i + 1, size);
+    }
+    EXPECT_FALSE(CAQueueingThreadGetData(&m_thread, &data, &size));
+}
+
+TEST_F(CAQueueingThreadTests, FullBoundedQueueWaitsForRoom)
+{
+    const int32_t count = 50;
+    ASSERT_EQ(CA_STATUS_OK, CAQueueingThreadInitializeBounded(&m_thread, m_threadPool,
+                                                              slowTask, countDestroy, 2,
+                                                              WAIT_SECONDS * 1000000ULL));
+    ASSERT_EQ(CA_STATUS_OK, CAQueueingThreadStart(&m_thread));
+
+    for (int32_t i = 0; i < count; i++)
+    {
+        EXPECT_EQ(CA_STATUS_OK, CAQueueingThreadAddData(&m_thread, packet(i), sizeof(uint32_t)));
+    }
+    EXPECT_TRUE(waitForProcessed(count));
+    EXPECT_EQ(0, m_thread.droppedCount);
+}
+
+TEST_F(CAQueueingThreadTests, WaitDataReturnsQueuedData)
+{
+    ASSERT_EQ(CA_STATUS_OK, CAQueueingThreadInitializeBounded(&m_thread, m_threadPool,
+                                                              countTask, countDestroy, 4, 0));
+
+    EXPECT_FALSE(CAQueueingThreadWaitData(&m_thread, 0));
+    uint64_t beg = OICGetCurrentTime(TIME_IN_US);
+    EXPECT_FALSE(CAQueueingThreadWaitData(&m_thread, 20000));
+    EXPECT_LE(10000u, OICGetCurrentTime(TIME_IN_US) - beg);
+
+    EXPECT_EQ(CA_STATUS_OK, CAQueueingThreadAddData(&m_thread, packet(0), sizeof(uint32_t)));
+    EXPECT_TRUE(CAQueueingThreadWaitData(&m_thread, WAIT_SECONDS * 1000000ULL));
+
+    void *data = NULL;
+    uint32_t size = 0;
+    EXPECT_TRUE(CAQueueingThreadGetData(&m_thread, &data, &size));
+}
+
+TEST_F(CAQueueingThreadTests, CancelWaitEndsWait)
+{
+    ASSERT_EQ(CA_STATUS_OK, CAQueueingThreadInitializeBounded(&m_thread, m_threadPool,
+                                                              countTask, countDestroy, 4, 0));
+
+    // a cancel before the wait is kept for it
+    CAQueueingThreadCancelWait(&m_thread);
+    uint64_t beg = OICGetCurrentTime(TIME_IN_US);
+    EXPECT_FALSE(CAQueueingThreadWaitData(&m_thread, WAIT_SECONDS * 1000000ULL));
+    EXPECT_GT(WAIT_SECONDS * 1000000ULL / 2, OICGetCurrentTime(TIME_IN_US) - beg);
+}
+
+#define PING_PONG_ROUNDS 50
+#define POLL_INTERVAL_US 10000
+
+static void *echo(void *arg)
+{
+    CAQueueingThread_t *queues = (CAQueueingThread_t *)arg;
+    for (;;)
+    {
+        void *data = NULL;
+        uint32_t size = 0;
+        CAQueueingThreadWaitData(&queues[0], WAIT_SECONDS * 1000000ULL);
+        if (!CAQueueingThreadGetData(&queues[0], &data, &size))
+        {
+            continue;
+        }
+        if (packet(PING_PONG_ROUNDS) == data)
+        {
+            return NULL;
+        }
+        CAQueueingThreadAddData(&queues[1], data, size);
+    }
+}
+
+// Returns the average round trip in microseconds of a packet sent to an echo thread,
+// with the reply taken by sleeping between polls, like the C++ wrappers used to
+// around OCProcess, or by waiting for it with CAQueueingThreadWaitData.
+static uint64_t pingPong(ca_thread_pool_t threadPool, bool poll)
+{
+    CAQueueingThread_t queues[2];
+    memset(queues, 0, sizeof (queues));
+    for (int q = 0; q < 2; q++)
+    {
+        EXPECT_EQ(CA_STATUS_OK, CAQueueingThreadInitializeBounded(&queues[q], threadPool,
+                                                                  countTask, countDestroy,
+                                                                  QUEUE_CAPACITY, 0));
+    }
+    oc_thread echoThread;
+    EXPECT_EQ(OC_THREAD_SUCCESS, oc_thread_new(&echoThread, echo, queues));
+
+    uint64_t beg = OICGetCurrentTime(TIME_IN_US);
+    for (uint32_t i = 0; i < PING_PONG_ROUNDS; i++)
+    {
+        CAQueueingThreadAddData(&queues[0], packet(i), sizeof(uint32_t));
+
+        void *data = NULL;
+        uint32_t size = 0;
+        while (!CAQueueingThreadGetData(&queues[1], &data, &size))
+        {
+            if (poll)
+            {
+                usleep(POLL_INTERVAL_US);
+            }
+            else
+            {
+                CAQueueingThreadWaitData(&queues[1], POLL_INTERVAL_US);
+            }
+        }
+        EXPECT_EQ(packet(i), data);
+    }
+    uint64_t elapsed = OICGetCurrentTime(TIME_IN_US) - beg;
+
+    CAQueueingThreadAddData(&queues[0], packet(PING_PONG_ROUNDS), sizeof(uint32_t));
+    oc_thread_wait(echoThread);
+    oc_thread_free(echoThread);
+    for (int q = 0; q < 2; q++)
+    {
+        CAQueueingThreadDestroy(&queues[q]);
+    }
+    return elapsed / PING_PONG_ROUNDS;
+}
+
+TEST_F(CAQueueingThreadTests, PingPongLatency)
+{
+    uint64_t pollUs = pingPong(m_threadPool, true);
+    uint64_t waitUs = pingPong(m_threadPool, false);
+    printf("ping-pong round trip: %" PRIu64 " us polling every %d us, %" PRIu64 " us waiting\n",
+           pollUs, POLL_INTERVAL_US, waitUs);
+}
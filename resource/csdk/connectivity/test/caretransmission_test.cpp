@@ -0,0 +1,212 @@
+//******************************************************************
+//
+// Copyright 2017 Samsung Electronics All Rights Reserved.
+//
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+
+#include "iotivity_config.h"
+#include <gtest/gtest.h>
+
+#include "caretransmission.h"
+#include "oic_malloc.h"
+#include "oic_time.h"
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+
+#ifdef HAVE_UNISTD_H
+#include <unistd.h>
+#endif
+
+// CoAP header bytes: version 1, no token.
+#define COAP_CON_HEADER     0x40
+#define COAP_ACK_HEADER     0x60
+#define COAP_CODE_EMPTY     0x00
+#define COAP_CODE_GET       0x01
+#define COAP_CODE_CONTENT   0x45
+
+static const int WAIT_SECONDS = 20;
+
+typedef struct
+{
+    oc_mutex mutex;
+    uint32_t sent;
+    uint32_t timedOut;
+} RetransmissionCounters_t;
+
+static RetransmissionCounters_t g_counters;
+
+static CAResult_t countSend(const CAEndpoint_t *endpoint, const void *pdu,
+                            uint32_t size, CADataType_t dataType)
+{
+    (void)endpoint;
+    (void)pdu;
+    (void)size;
+    (void)dataType;
+    oc_mutex_lock(g_counters.mutex);
+    g_counters.sent++;
+    oc_mutex_unlock(g_counters.mutex);
+    return CA_STATUS_OK;
+}
+
+static void countTimeout(const CAEndpoint_t *endpoint, const void *pdu, uint32_t size)
+{
+    (void)endpoint;
+    (void)pdu;
+    (void)size;
+    oc_mutex_lock(g_counters.mutex);
+    g_counters.timedOut++;
+    oc_mutex_unlock(g_counters.mutex);
+}
+
+static void makePdu(uint8_t *pdu, uint8_t header, uint8_t code, uint16_t messageId)
+{
+    pdu[0] = header;
+    pdu[1] = code;
+    pdu[2] = (uint8_t)(messageId >> 8);
+    pdu[3] = (uint8_t)(messageId & 0xFF);
+}
+
+class CARetransmissionTests : public testing::Test
+{
+protected:
+    virtual void SetUp()
+    {
+        memset(&g_counters, 0, sizeof (g_counters));
+        g_counters.mutex = oc_mutex_new();
+
+        memset(&m_endpoint, 0, sizeof (m_endpoint));
+        m_endpoint.adapter = CA_ADAPTER_IP;
+        strcpy(m_endpoint.addr, "127.0.0.1");
+        m_endpoint.port = 5683;
+
+        ASSERT_EQ(CA_STATUS_OK, ca_thread_pool_init(1, &m_threadPool));
+    }
+
+    virtual void TearDown()
+    {
+        CARetransmissionStop(&m_context);
+        CARetransmissionDestroy(&m_context);
+        ca_thread_pool_free(m_threadPool);
+        oc_mutex_free(g_counters.mutex);
+    }
+
+    void start(CARetransmissionConfig_t *config)
+    {
+        ASSERT_EQ(CA_STATUS_OK, CARetransmissionInitialize(&m_context, m_threadPool,
+                                                           countSend, countTimeout, config));
+        ASSERT_EQ(CA_STATUS_OK, CARetransmissionStart(&m_context));
+    }
+
+    ca_thread_pool_t m_threadPool;
+    CARetransmission_t m_context;
+    CAEndpoint_t m_endpoint;
+};
+
+TEST_F(CARetransmissionTests, AckMatchesOutstandingCon)
+{
+    const uint32_t MESSAGE_COUNT = 50000;
+    start(NULL);
+
+    uint8_t pdu[4];
+    uint64_t beg = OICGetCurrentTime(TIME_IN_US);
+    for (uint32_t i = 0; i < MESSAGE_COUNT; i++)
+    {
+        makePdu(pdu, COAP_CON_HEADER, COAP_CODE_GET, (uint16_t)i);
+        ASSERT_EQ(CA_STATUS_OK, CARetransmissionSentData(&m_context, &m_endpoint,
+                                                         CA_REQUEST_DATA, pdu, sizeof (pdu)));
+    }
+    uint64_t sent = OICGetCurrentTime(TIME_IN_US);
+    EXPECT_EQ(MESSAGE_COUNT, m_context.dataCount);
+
+    // a message id already waiting for its ACK is refused.
+    makePdu(pdu, COAP_CON_HEADER, COAP_CODE_GET, 0);
+    EXPECT_EQ(CA_STATUS_FAILED, CARetransmissionSentData(&m_context, &m_endpoint,
+                                                         CA_REQUEST_DATA, pdu, sizeof (pdu)));
+
+    // ACK in reverse order, so a list scan would be at its worst.
+    for (uint32_t i = MESSAGE_COUNT; i > 0; i--)
+    {
+        void *retransmissionPdu = NULL;
+        makePdu(pdu, COAP_ACK_HEADER, COAP_CODE_CONTENT, (uint16_t)(i - 1));
+        EXPECT_EQ(CA_STATUS_OK, CARetransmissionReceivedData(&m_context, &m_endpoint, pdu,
+                                                             sizeof (pdu), &retransmissionPdu));
+        EXPECT_TRUE(NULL == retransmissionPdu);
+    }
+    uint64_t acked = OICGetCurrentTime(TIME_IN_US);
+
+    EXPECT_EQ(0u, m_context.dataCount);
+    oc_mutex_lock(g_counters.mutex);
+    EXPECT_EQ(0u, g_counters.timedOut);
+    uint32_t retransmitted = g_counters.sent;
+    oc_mutex_unlock(g_counters.mutex);
+
+    printf("%u CON messages: add %" PRIu64 " us, ack %" PRIu64 " us, %u retransmitted\n",
+           MESSAGE_COUNT, sent - beg, acked - sent, retransmitted);
+}
+
+TEST_F(CARetransmissionTests, EmptyAckReturnsCon)
+{
+    start(NULL);
+
+    uint8_t pdu[4];
+    makePdu(pdu, COAP_CON_HEADER, COAP_CODE_GET, 0x1234);
+    ASSERT_EQ(CA_STATUS_OK, CARetransmissionSentData(&m_context, &m_endpoint,
+                                                     CA_REQUEST_DATA, pdu, sizeof (pdu)));
+
+    uint8_t ack[4];
+    void *retransmissionPdu = NULL;
+    makePdu(ack, COAP_ACK_HEADER, COAP_CODE_EMPTY, 0x1234);
+    EXPECT_EQ(CA_STATUS_OK, CARetransmissionReceivedData(&m_context, &m_endpoint, ack,
+                                                         sizeof (ack), &retransmissionPdu));
+    ASSERT_TRUE(NULL != retransmissionPdu);
+    EXPECT_EQ(0, memcmp(pdu, retransmissionPdu, sizeof (pdu)));
+    OICFree(retransmissionPdu);
+    EXPECT_EQ(0u, m_context.dataCount);
+}
+
+TEST_F(CARetransmissionTests, RetransmitsUntilTryingCount)
+{
+    CARetransmissionConfig_t config;
+    config.supportType = (CATransportAdapter_t) DEFAULT_RETRANSMISSION_TYPE;
+    config.tryingCount = 1;
+    start(&config);
+
+    uint8_t pdu[4];
+    makePdu(pdu, COAP_CON_HEADER, COAP_CODE_GET, 1);
+    ASSERT_EQ(CA_STATUS_OK, CARetransmissionSentData(&m_context, &m_endpoint,
+                                                     CA_REQUEST_DATA, pdu, sizeof (pdu)));
+
+    uint64_t beg = OICGetCurrentTime(TIME_IN_US);
+    bool timedOut = false;
+    for (int i = 0; i < WAIT_SECONDS * 10 && !timedOut; i++)
+    {
+        usleep(100 * 1000);
+        oc_mutex_lock(g_counters.mutex);
+        timedOut = (0 < g_counters.timedOut);
+        oc_mutex_unlock(g_counters.mutex);
+    }
+    uint64_t elapsed = OICGetCurrentTime(TIME_IN_US) - beg;
+
+    ASSERT_TRUE(timedOut);
+    EXPECT_EQ(1u, g_counters.sent);
+    EXPECT_EQ(0u, m_context.dataCount);
+
+    // the first retransmission waits DEFAULT_ACK_TIMEOUT_SEC to 1.5 times that.
+    EXPECT_LE((uint64_t)DEFAULT_ACK_TIMEOUT_SEC * 1000000, elapsed + 10000);
+}
@@ -0,0 +1,272 @@
+//******************************************************************
+//
+// Copyright 2017 Samsung Electronics All Rights Reserved.
+//
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+
+#include "iotivity_config.h"
+#include <gtest/gtest.h>
+
+#include "cacommon.h"
+#include "catcpinterface.h"
+#include "cathreadpool.h"
+#include "octhread.h"
+#include "oic_malloc.h"
+#include "oic_string.h"
+
+#include <arpa/inet.h>
+#include <errno.h>
+#include <inttypes.h>
+#include <netinet/in.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include <vector>
+
+// The load test wants this many loopback sessions; it scales down when
+// RLIMIT_NOFILE cannot hold both ends of every connection.  Without epoll
+// the server falls back to select() and stays below FD_SETSIZE.
+#ifdef HAVE_SYS_EPOLL_H
+static const size_t TARGET_CONNECTIONS = 20000;
+#else
+static const size_t TARGET_CONNECTIONS = FD_SETSIZE / 4;
+#endif
+
+static const int WAIT_SECONDS = 60;
+
+static const useconds_t POLL_INTERVAL_US = 10 * 1000;
+
+typedef struct
+{
+    oc_mutex mutex;
+    size_t connected;
+    size_t disconnected;
+    size_t bytesReceived;
+    bool haveEndpoint;
+    CAEndpoint_t firstEndpoint;
+} TCPServerCounters_t;
+
+static TCPServerCounters_t g_counters;
+
+static void connectionHandler(const CAEndpoint_t *endpoint, bool isConnected, bool isClient)
+{
+    (void)isClient;
+    oc_mutex_lock(g_counters.mutex);
+    if (isConnected)
+    {
+        g_counters.connected++;
+        if (!g_counters.haveEndpoint)
+        {
+            g_counters.firstEndpoint = *endpoint;
+            g_counters.haveEndpoint = true;
+        }
+    }
+    else
+    {
+        g_counters.disconnected++;
+    }
+    oc_mutex_unlock(g_counters.mutex);
+}
+
+static void packetHandler(const CASecureEndpoint_t *sep, const void *data, size_t dataLength)
+{
+    (void)sep;
+    (void)data;
+    oc_mutex_lock(g_counters.mutex);
+    g_counters.bytesReceived += dataLength;
+    oc_mutex_unlock(g_counters.mutex);
+}
+
+static uint64_t nowUs()
+{
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return (uint64_t)tv.tv_sec * 1000000 + tv.tv_usec;
+}
+
+static bool waitForCounter(size_t *counter, size_t expected)
+{
+    for (int i = 0; i < WAIT_SECONDS * 100; i++)
+    {
+        oc_mutex_lock(g_counters.mutex);
+        size_t value = *counter;
+        oc_mutex_unlock(g_counters.mutex);
+        if (value >= expected)
+        {
+            return true;
+        }
+        usleep(POLL_INTERVAL_US);
+    }
+    return false;
+}
+
+static size_t connectionBudget()
+{
+    struct rlimit limit;
+    if (0 != getrlimit(RLIMIT_NOFILE, &limit))
+    {
+        return 0;
+    }
+    if (limit.rlim_cur < limit.rlim_max)
+    {
+        limit.rlim_cur = limit.rlim_max;
+        (void)setrlimit(RLIMIT_NOFILE, &limit);
+        (void)getrlimit(RLIMIT_NOFILE, &limit);
+    }
+
+    // client and server ends of each connection, plus headroom for the stack
+    size_t budget = (limit.rlim_cur > 256) ? (size_t)(limit.rlim_cur - 256) / 2 : 0;
+    return (budget < TARGET_CONNECTIONS) ? budget : TARGET_CONNECTIONS;
+}
+
+class CATCPServerTests : public testing::Test
+{
+protected:
+    virtual void SetUp()
+    {
+        memset(&g_counters, 0, sizeof (g_counters));
+        g_counters.mutex = oc_mutex_new();
+
+        caglobals.tcp.ipv4.fd = OC_INVALID_SOCKET;
+        caglobals.tcp.ipv4s.fd = OC_INVALID_SOCKET;
+        caglobals.tcp.ipv6.fd = OC_INVALID_SOCKET;
+        caglobals.tcp.ipv6s.fd = OC_INVALID_SOCKET;
+        caglobals.tcp.ipv4.port = 0;
+        caglobals.tcp.ipv4s.port = 0;
+        caglobals.tcp.ipv6.port = 0;
+        caglobals.tcp.ipv6s.port = 0;
+        caglobals.tcp.selectTimeout = 1;
+        caglobals.tcp.listenBacklog = 4096;
+        caglobals.tcp.terminate = false;
+
+        ASSERT_EQ(CA_STATUS_OK, ca_thread_pool_init(2, &m_threadPool));
+        CATCPSetConnectionChangedCallback(connectionHandler);
+        CATCPSetPacketReceiveCallback(packetHandler);
+        ASSERT_EQ(CA_STATUS_OK, CATCPStartServer(m_threadPool));
+    }
+
+    virtual void TearDown()
+    {
+        CATCPStopServer();
+        CATCPSetConnectionChangedCallback(NULL);
+        CATCPSetPacketReceiveCallback(NULL);
+        ca_thread_pool_free(m_threadPool);
+        oc_mutex_free(g_counters.mutex);
+    }
+
+    ca_thread_pool_t m_threadPool;
+};
+
+TEST_F(CATCPServerTests, HoldManyLoopbackConnections)
+{
+    size_t count = connectionBudget();
+    if (count < TARGET_CONNECTIONS)
+    {
+        printf("RLIMIT_NOFILE only allows %" PRIuPTR " of %" PRIuPTR " connections\n",
+               count, TARGET_CONNECTIONS);
+    }
+    ASSERT_LT(0u, count);
+
+    struct sockaddr_in server;
+    memset(&server, 0, sizeof (server));
+    server.sin_family = AF_INET;
+    server.sin_port = htons(caglobals.tcp.ipv4.port);
+    server.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+    std::vector<int> clients;
+    clients.reserve(count);
+
+    uint64_t beg = nowUs();
+    for (size_t i = 0; i < count; i++)
+    {
+        int fd = socket(AF_INET, SOCK_STREAM, 0);
+        ASSERT_NE(-1, fd) << strerror(errno);
+        ASSERT_EQ(0, connect(fd, (struct sockaddr *)&server, sizeof (server)))
+            << "connection " << i << ": " << strerror(errno);
+        clients.push_back(fd);
+    }
+    EXPECT_TRUE(waitForCounter(&g_counters.connected, count));
+    uint64_t connected = nowUs();
+
+    // A CoAP over TCP ping (len 0, code 7.02) from every 100th client.
+    const unsigned char ping[] = { 0x00, 0xE2 };
+    size_t senders = 0;
+    for (size_t i = 0; i < count; i += 100, senders++)
+    {
+        ASSERT_EQ((ssize_t)sizeof (ping), send(clients[i], ping, sizeof (ping), 0));
+    }
+    EXPECT_TRUE(waitForCounter(&g_counters.bytesReceived, senders * sizeof (ping)));
+    uint64_t received = nowUs();
+
+    for (size_t i = 0; i < clients.size(); i++)
+    {
+        close(clients[i]);
+    }
+    EXPECT_TRUE(waitForCounter(&g_counters.disconnected, count));
+    uint64_t closed = nowUs();
+
+    printf("%" PRIuPTR " connections: connect %" PRIu64 " us, %" PRIuPTR " pings %" PRIu64
+           " us, close %" PRIu64 " us\n", count, connected - beg, senders,
+           received - connected, closed - received);
+}
+
+#ifdef HAVE_SYS_EPOLL_H
+// Session sockets are only non-blocking when the server runs on epoll.
+TEST_F(CATCPServerTests, QueuesDataForSlowReader)
+{
+    struct sockaddr_in server;
+    memset(&server, 0, sizeof (server));
+    server.sin_family = AF_INET;
+    server.sin_port = htons(caglobals.tcp.ipv4.port);
+    server.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    ASSERT_NE(-1, fd);
+    int small = 4096;
+    setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &small, sizeof (small));
+    ASSERT_EQ(0, connect(fd, (struct sockaddr *)&server, sizeof (server)));
+    ASSERT_TRUE(waitForCounter(&g_counters.connected, 1));
+
+    // More than the socket buffers hold, so the tail has to wait for EPOLLOUT.
+    const size_t length = 512 * 1024;
+    std::vector<unsigned char> data(length);
+    for (size_t i = 0; i < length; i++)
+    {
+        data[i] = (unsigned char)(i * 31);
+    }
+
+    CAEndpoint_t endpoint = g_counters.firstEndpoint;
+    EXPECT_EQ((ssize_t)length, CATCPSendData(&endpoint, &data[0], length));
+
+    std::vector<unsigned char> in(length);
+    size_t total = 0;
+    while (total < length)
+    {
+        ssize_t len = recv(fd, &in[total], length - total, 0);
+        ASSERT_LT(0, len) << strerror(errno);
+        total += len;
+    }
+    EXPECT_TRUE(data == in);
+
+    close(fd);
+    EXPECT_TRUE(waitForCounter(&g_counters.disconnected, 1));
+}
+#endif
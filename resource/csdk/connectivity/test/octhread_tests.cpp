@@ -39,6 +39,9 @@
 #include "octhread.h"
 #include <cathreadpool.h>
 
+#include <inttypes.h>
+#include <stdio.h>
+
 #ifdef HAVE_TIME_H
 #include <time.h>
 #endif
@@ -542,3 +545,139 @@ TEST(ConditionTests, TC_07_WAITDURATION)
 
     oc_cond_free(sharedCond);
 }
+
+typedef struct _tagPoolFunc
+{
+    oc_mutex mutex;
+    uint32_t count;
+} _poolfunc_struct;
+
+void poolCountFunc(void *context)
+{
+    _poolfunc_struct *pData = (_poolfunc_struct *) context;
+
+    oc_mutex_lock(pData->mutex);
+    pData->count++;
+    oc_mutex_unlock(pData->mutex);
+}
+
+TEST(ThreadPoolTests, TC_01_BOUNDED_WORKERS)
+{
+    const uint32_t TASK_COUNT = 10000;
+    const uint32_t MAX_WORKERS = 3;
+
+    ca_thread_pool_t mythreadpool;
+
+    EXPECT_EQ(CA_STATUS_OK, ca_thread_pool_init(MAX_WORKERS, &mythreadpool));
+
+    _poolfunc_struct pData = {0, 0};
+    pData.mutex = oc_mutex_new();
+    ASSERT_TRUE(pData.mutex != NULL);
+
+    uint64_t beg = getAbsTime();
+    for (uint32_t i = 0; i < TASK_COUNT; i++)
+    {
+        EXPECT_EQ(CA_STATUS_OK,
+                  ca_thread_pool_add_task(mythreadpool, poolCountFunc, &pData));
+    }
+
+    ca_thread_pool_stats_t stats;
+    do
+    {
+        usleep(MINIMAL_LOOP_SLEEP * USECS_PER_MSEC);
+        EXPECT_EQ(CA_STATUS_OK, ca_thread_pool_get_stats(mythreadpool, &stats));
+    } while (stats.tasks_completed < TASK_COUNT);
+    uint64_t end = getAbsTime();
+
+    printf("%u tasks on %u workers: %" PRIu64 " us, stolen %" PRIu64
+           ", max queue depth %u, max wait %" PRIu64 " us\n",
+           TASK_COUNT, (unsigned) stats.workers, end - beg, stats.tasks_stolen,
+           (unsigned) stats.max_queue_depth, stats.max_wait_us);
+
+    EXPECT_LE(stats.workers, MAX_WORKERS);
+    EXPECT_EQ(0u, stats.queue_depth);
+
+    ca_thread_pool_free(mythreadpool);
+
+    EXPECT_EQ(TASK_COUNT, pData.count);
+    oc_mutex_free(pData.mutex);
+}
+
+typedef struct _tagPoolBlock
+{
+    oc_mutex mutex;
+    oc_cond cond;
+    bool release;
+    uint32_t running;
+} _poolblock_struct;
+
+void poolBlockFunc(void *context)
+{
+    _poolblock_struct *pData = (_poolblock_struct *) context;
+
+    oc_mutex_lock(pData->mutex);
+    pData->running++;
+    while (!pData->release)
+    {
+        oc_cond_wait(pData->cond, pData->mutex);
+    }
+    pData->running--;
+    oc_mutex_unlock(pData->mutex);
+}
+
+TEST(ThreadPoolTests, TC_02_LONG_RUNNING_TASKS)
+{
+    const uint32_t MAX_WORKERS = 2;
+    const uint32_t LOOP_COUNT = 2 * MAX_WORKERS;
+    const uint32_t TASK_COUNT = 100;
+
+    ca_thread_pool_t mythreadpool;
+
+    EXPECT_EQ(CA_STATUS_OK, ca_thread_pool_init(MAX_WORKERS, &mythreadpool));
+
+    _poolblock_struct block = {oc_mutex_new(), oc_cond_new(), false, 0};
+    ASSERT_TRUE(block.mutex != NULL);
+    ASSERT_TRUE(block.cond != NULL);
+
+    _poolfunc_struct pData = {0, 0};
+    pData.mutex = oc_mutex_new();
+    ASSERT_TRUE(pData.mutex != NULL);
+
+    // More blocking loops than workers, as when every adapter is started.
+    for (uint32_t i = 0; i < LOOP_COUNT; i++)
+    {
+        EXPECT_EQ(CA_STATUS_OK,
+                  ca_thread_pool_add_long_running_task(mythreadpool, poolBlockFunc, &block));
+    }
+    for (uint32_t i = 0; i < TASK_COUNT; i++)
+    {
+        EXPECT_EQ(CA_STATUS_OK,
+                  ca_thread_pool_add_task(mythreadpool, poolCountFunc, &pData));
+    }
+
+    // The short tasks must complete while the loops still run.
+    ca_thread_pool_stats_t stats;
+    uint64_t deadline = getAbsTime() + 10 * USECS_PER_SEC;
+    do
+    {
+        usleep(MINIMAL_LOOP_SLEEP * USECS_PER_MSEC);
+        EXPECT_EQ(CA_STATUS_OK, ca_thread_pool_get_stats(mythreadpool, &stats));
+    } while (stats.tasks_completed < TASK_COUNT && getAbsTime() < deadline);
+
+    EXPECT_EQ(TASK_COUNT, stats.tasks_completed);
+    EXPECT_EQ(LOOP_COUNT, stats.dedicated_threads);
+    EXPECT_LE(stats.workers, MAX_WORKERS);
+
+    oc_mutex_lock(block.mutex);
+    block.release = true;
+    oc_cond_broadcast(block.cond);
+    oc_mutex_unlock(block.mutex);
+
+    ca_thread_pool_free(mythreadpool);
+
+    EXPECT_EQ(TASK_COUNT, pData.count);
+    EXPECT_EQ(0u, block.running);
+    oc_mutex_free(pData.mutex);
+    oc_cond_free(block.cond);
+    oc_mutex_free(block.mutex);
+}
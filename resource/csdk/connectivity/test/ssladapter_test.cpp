@@ -1900,6 +1900,8 @@ static void * test0CAinitiateSslHandshake(void * arg)
     oc_mutex_lock(g_sslContextMutex);
     g_caSslContext = (SslContext_t *)OICCalloc(1, sizeof(SslContext_t));
     g_caSslContext->peerList = u_arraylist_create();
+    g_caSslContext->peerTableMutex = oc_mutex_new();
+    g_caSslContext->rndMutex = oc_mutex_new();
     mbedtls_entropy_init(&g_caSslContext->entropy);
     mbedtls_ctr_drbg_init(&g_caSslContext->rnd);
     mbedtls_ctr_drbg_seed(&g_caSslContext->rnd, mbedtls_entropy_func_clutch,
@@ -1966,12 +1968,15 @@ static void * test0CAinitiateSslHandshake(void * arg)
     // CAdeinitTlsAdapter
     oc_mutex_lock(g_sslContextMutex);
     DeletePeerList();
+    DeleteSessionCaches();
     mbedtls_x509_crt_free(&g_caSslContext->crt);
     mbedtls_pk_free(&g_caSslContext->pkey);
     mbedtls_ssl_config_free(&g_caSslContext->clientTlsConf);
     mbedtls_ssl_config_free(&g_caSslContext->serverTlsConf);
     mbedtls_ctr_drbg_free(&g_caSslContext->rnd);
     mbedtls_entropy_free(&g_caSslContext->entropy);
+    oc_mutex_free(g_caSslContext->peerTableMutex);
+    oc_mutex_free(g_caSslContext->rndMutex);
     OICFree(g_caSslContext);
     g_caSslContext = NULL;
     oc_mutex_unlock(g_sslContextMutex);
@@ -2966,6 +2971,8 @@ TEST(TLSAdapter, Test_11)
     oc_mutex_lock(g_sslContextMutex);
     g_caSslContext = (SslContext_t *)OICCalloc(1, sizeof(SslContext_t));
     g_caSslContext->peerList = u_arraylist_create();
+    g_caSslContext->peerTableMutex = oc_mutex_new();
+    g_caSslContext->rndMutex = oc_mutex_new();
     mbedtls_entropy_init(&g_caSslContext->entropy);
     mbedtls_ctr_drbg_init(&g_caSslContext->rnd);
     mbedtls_ctr_drbg_seed(&g_caSslContext->rnd, mbedtls_entropy_func_clutch,
@@ -3055,3 +3062,427 @@ TEST(TLSAdapter, TestCertsValid)
     EXPECT_EQ(0, ret) << "Failed to parse CA cert";
     mbedtls_x509_crt_free(&cert);
 }
+
+/* **************************
+ *
+ *
+ * Session resumption test
+ *
+ *
+ * *************************/
+
+#ifdef __WITH_DTLS__
+#define RESUME_SERVER_PORT 5684
+#define RESUME_CLIENT_PORT 5685
+#define RESUME_HANDSHAKES 20
+#define RESUME_QUEUE_SIZE 32
+#define RESUME_PACKET_SIZE 2048
+
+static const unsigned char RESUME_PSK_IDENTITY[] = "6767676767676767";
+static const unsigned char RESUME_PSK[] = "AAAAAAAAAAAAAAAA";
+
+typedef struct
+{
+    uint16_t fromPort;
+    size_t len;
+    uint8_t data[RESUME_PACKET_SIZE];
+} ResumePacket_t;
+
+// Datagrams between the in-process client and server; both share g_caSslContext,
+// so the send callback only queues and the test thread delivers them.
+static ResumePacket_t g_resumeQueue[RESUME_QUEUE_SIZE];
+static size_t g_resumeHead = 0;
+static size_t g_resumeCount = 0;
+static size_t g_resumeReceived = 0;
+
+static ssize_t ResumeSendCB(CAEndpoint_t *endpoint, const void *data, size_t dataLength)
+{
+    if (RESUME_QUEUE_SIZE == g_resumeCount || RESUME_PACKET_SIZE < dataLength)
+    {
+        return -1;
+    }
+    ResumePacket_t *packet = &g_resumeQueue[(g_resumeHead + g_resumeCount) % RESUME_QUEUE_SIZE];
+    packet->fromPort = (RESUME_SERVER_PORT == endpoint->port) ? RESUME_CLIENT_PORT
+                                                              : RESUME_SERVER_PORT;
+    packet->len = dataLength;
+    memcpy(packet->data, data, dataLength);
+    g_resumeCount++;
+    return (ssize_t)dataLength;
+}
+
+static void ResumeReceivedCB(const CASecureEndpoint_t *sep, const void *data, size_t dataLength)
+{
+    OC_UNUSED(sep);
+    OC_UNUSED(data);
+    OC_UNUSED(dataLength);
+    g_resumeReceived++;
+}
+
+static void ResumeErrorCB(const CAEndpoint_t *endpoint, const void *data, size_t dataLength,
+                          CAResult_t result)
+{
+    OC_UNUSED(endpoint);
+    OC_UNUSED(data);
+    OC_UNUSED(dataLength);
+    OC_UNUSED(result);
+}
+
+static void ResumeCredentialTypes(bool *list, const char *deviceId)
+{
+    OC_UNUSED(deviceId);
+    list[0] = true;
+}
+
+static int32_t ResumePskCredentials(CADtlsPskCredType_t type, const unsigned char *desc,
+                                    size_t descLen, unsigned char *result, size_t resultLen)
+{
+    OC_UNUSED(desc);
+    OC_UNUSED(descLen);
+    const unsigned char *value = (CA_DTLS_PSK_KEY == type) ? RESUME_PSK : RESUME_PSK_IDENTITY;
+    size_t len = UUID_LENGTH;
+    if (NULL == result || resultLen < len)
+    {
+        return -1;
+    }
+    memcpy(result, value, len);
+    return (int32_t)len;
+}
+
+static void ResumeMakeEndpoint(CAEndpoint_t *endpoint, uint16_t port)
+{
+    memset(endpoint, 0, sizeof(*endpoint));
+    endpoint->adapter = CA_ADAPTER_IP;
+    endpoint->flags = CA_SECURE;
+    endpoint->port = port;
+    strcpy(endpoint->addr, "127.0.0.1");
+}
+
+static void ResumeDeliverAll()
+{
+    CASecureEndpoint_t sep;
+    memset(&sep, 0, sizeof(sep));
+    while (0 < g_resumeCount)
+    {
+        ResumePacket_t *packet = &g_resumeQueue[g_resumeHead];
+        ResumeMakeEndpoint(&sep.endpoint, packet->fromPort);
+        CAdecryptSsl(&sep, packet->data, packet->len);
+        g_resumeHead = (g_resumeHead + 1) % RESUME_QUEUE_SIZE;
+        g_resumeCount--;
+    }
+}
+
+static void ResumeClose(const CAEndpoint_t *server, const CAEndpoint_t *client)
+{
+    // the server session goes with the close_notify of the client
+    CAcloseSslConnection(server);
+    ResumeDeliverAll();
+    CAcloseSslConnection(client);
+    ResumeDeliverAll();
+}
+
+// Compares full ECDHE-PSK handshakes with handshakes resuming a cached session.
+TEST(TLSAdapter, ResumedHandshakeIsFaster)
+{
+    CAEndpoint_t server;
+    CAEndpoint_t client;
+    ResumeMakeEndpoint(&server, RESUME_SERVER_PORT);
+    ResumeMakeEndpoint(&client, RESUME_CLIENT_PORT);
+    uint8_t message[] = "resume";
+
+    ASSERT_EQ(CA_STATUS_OK, CAinitSslAdapter());
+    CAsetSslAdapterCallbacks(ResumeReceivedCB, ResumeSendCB, ResumeErrorCB, CA_ADAPTER_IP);
+    CAsetCredentialTypesCallback(ResumeCredentialTypes);
+    CAsetPskCredentialsCallback(ResumePskCredentials);
+    ASSERT_EQ(CA_STATUS_OK, CAsetTlsCipherSuite(MBEDTLS_TLS_ECDHE_PSK_WITH_AES_128_CBC_SHA256));
+
+    // an explicit handshake never resumes
+    g_resumeReceived = 0;
+    uint64_t beg = OICGetCurrentTime(TIME_IN_US);
+    for (int i = 0; i < RESUME_HANDSHAKES; i++)
+    {
+        ASSERT_EQ(CA_STATUS_OK, CAinitiateSslHandshake(&server));
+        ResumeDeliverAll();
+        ASSERT_EQ(CA_STATUS_OK, CAencryptSsl(&server, message, sizeof(message)));
+        ResumeDeliverAll();
+        ResumeClose(&server, &client);
+    }
+    uint64_t full = OICGetCurrentTime(TIME_IN_US) - beg;
+    EXPECT_EQ((size_t)RESUME_HANDSHAKES, g_resumeReceived);
+
+    // the session of the last full handshake is resumed from now on
+    g_resumeReceived = 0;
+    beg = OICGetCurrentTime(TIME_IN_US);
+    for (int i = 0; i < RESUME_HANDSHAKES; i++)
+    {
+        ASSERT_EQ(CA_STATUS_OK, CAencryptSsl(&server, message, sizeof(message)));
+        ResumeDeliverAll();
+
+        // the server restores the PSK identity of the resumed session
+        CASecureEndpoint_t sep;
+        ASSERT_EQ(CA_STATUS_OK, GetCASecureEndpointData(&client, &sep));
+        EXPECT_EQ(UUID_LENGTH, sep.identity.id_length);
+        EXPECT_EQ(0, memcmp(RESUME_PSK_IDENTITY, sep.identity.id, UUID_LENGTH));
+
+        ResumeClose(&server, &client);
+    }
+    uint64_t resumed = OICGetCurrentTime(TIME_IN_US) - beg;
+    EXPECT_EQ((size_t)RESUME_HANDSHAKES, g_resumeReceived);
+
+    CAdeinitSslAdapter();
+
+    printf("%d handshakes: full %" PRIu64 " us, resumed %" PRIu64 " us\n",
+           RESUME_HANDSHAKES, full, resumed);
+    EXPECT_LT(resumed, full);
+}
+
+static bool g_resumeCredRemoved = false;
+
+static int32_t ResumeRemovablePskCredentials(CADtlsPskCredType_t type, const unsigned char *desc,
+                                             size_t descLen, unsigned char *result,
+                                             size_t resultLen)
+{
+    if (g_resumeCredRemoved && CA_DTLS_PSK_KEY == type)
+    {
+        return -1;
+    }
+    return ResumePskCredentials(type, desc, descLen, result, resultLen);
+}
+
+// A session must not be resumed once the credential it was set up with is gone.
+TEST(TLSAdapter, ResumptionFailsAfterCredRemoved)
+{
+    CAEndpoint_t server;
+    CAEndpoint_t client;
+    ResumeMakeEndpoint(&server, RESUME_SERVER_PORT);
+    ResumeMakeEndpoint(&client, RESUME_CLIENT_PORT);
+    uint8_t message[] = "resume";
+
+    ASSERT_EQ(CA_STATUS_OK, CAinitSslAdapter());
+    CAsetSslAdapterCallbacks(ResumeReceivedCB, ResumeSendCB, ResumeErrorCB, CA_ADAPTER_IP);
+    CAsetCredentialTypesCallback(ResumeCredentialTypes);
+    CAsetPskCredentialsCallback(ResumeRemovablePskCredentials);
+    ASSERT_EQ(CA_STATUS_OK, CAsetTlsCipherSuite(MBEDTLS_TLS_ECDHE_PSK_WITH_AES_128_CBC_SHA256));
+
+    // full handshake, its session is kept by both roles
+    g_resumeCredRemoved = false;
+    g_resumeReceived = 0;
+    ASSERT_EQ(CA_STATUS_OK, CAinitiateSslHandshake(&server));
+    ResumeDeliverAll();
+    ASSERT_EQ(CA_STATUS_OK, CAencryptSsl(&server, message, sizeof(message)));
+    ResumeDeliverAll();
+    ResumeClose(&server, &client);
+    EXPECT_EQ(1u, g_resumeReceived);
+
+    // the credential resource flushes the caches when the credential is removed
+    g_resumeCredRemoved = true;
+    CAflushSslSessionCache();
+
+    g_resumeReceived = 0;
+    CAencryptSsl(&server, message, sizeof(message));
+    ResumeDeliverAll();
+    EXPECT_EQ(0u, g_resumeReceived);
+    ResumeClose(&server, &client);
+
+    // with the credential back, a new full handshake succeeds
+    g_resumeCredRemoved = false;
+    ASSERT_EQ(CA_STATUS_OK, CAencryptSsl(&server, message, sizeof(message)));
+    ResumeDeliverAll();
+    EXPECT_EQ(1u, g_resumeReceived);
+    ResumeClose(&server, &client);
+
+    CAdeinitSslAdapter();
+}
+
+/* **************************
+ *
+ *
+ * Parallel sessions test
+ *
+ *
+ * *************************/
+
+#define PARALLEL_PAIRS 4
+#define PARALLEL_MESSAGES 2000
+#define PARALLEL_SERVER_PORT 6000
+#define PARALLEL_CLIENT_PORT 7000
+
+// One client/server pair per thread. The timer thread may retransmit handshake
+// records, so the queue of a pair is guarded by its own mutex.
+typedef struct
+{
+    oc_mutex mutex;
+    ResumePacket_t queue[RESUME_QUEUE_SIZE];
+    size_t head;
+    size_t count;
+    size_t received;
+    bool failed;
+} ParallelPair_t;
+
+static ParallelPair_t g_parallelPairs[PARALLEL_PAIRS];
+
+static size_t ParallelPairIndex(uint16_t port)
+{
+    return (PARALLEL_CLIENT_PORT <= port) ? port - PARALLEL_CLIENT_PORT
+                                          : port - PARALLEL_SERVER_PORT;
+}
+
+static ssize_t ParallelSendCB(CAEndpoint_t *endpoint, const void *data, size_t dataLength)
+{
+    size_t index = ParallelPairIndex(endpoint->port);
+    ParallelPair_t *pair = &g_parallelPairs[index];
+    ssize_t ret = -1;
+
+    oc_mutex_lock(pair->mutex);
+    if (RESUME_QUEUE_SIZE > pair->count && RESUME_PACKET_SIZE >= dataLength)
+    {
+        ResumePacket_t *packet = &pair->queue[(pair->head + pair->count) % RESUME_QUEUE_SIZE];
+        packet->fromPort = (uint16_t)((PARALLEL_CLIENT_PORT <= endpoint->port) ?
+                                      PARALLEL_SERVER_PORT + index : PARALLEL_CLIENT_PORT + index);
+        packet->len = dataLength;
+        memcpy(packet->data, data, dataLength);
+        pair->count++;
+        ret = (ssize_t)dataLength;
+    }
+    oc_mutex_unlock(pair->mutex);
+    return ret;
+}
+
+static void ParallelReceivedCB(const CASecureEndpoint_t *sep, const void *data, size_t dataLength)
+{
+    OC_UNUSED(data);
+    OC_UNUSED(dataLength);
+    ParallelPair_t *pair = &g_parallelPairs[ParallelPairIndex(sep->endpoint.port)];
+    oc_mutex_lock(pair->mutex);
+    pair->received++;
+    oc_mutex_unlock(pair->mutex);
+}
+
+static void ParallelDeliverAll(ParallelPair_t *pair)
+{
+    CASecureEndpoint_t sep;
+    memset(&sep, 0, sizeof(sep));
+    for (;;)
+    {
+        oc_mutex_lock(pair->mutex);
+        if (0 == pair->count)
+        {
+            oc_mutex_unlock(pair->mutex);
+            break;
+        }
+        // new records go behind the head, so it stays valid while unlocked
+        ResumePacket_t *packet = &pair->queue[pair->head];
+        oc_mutex_unlock(pair->mutex);
+
+        ResumeMakeEndpoint(&sep.endpoint, packet->fromPort);
+        CAdecryptSsl(&sep, packet->data, packet->len);
+
+        oc_mutex_lock(pair->mutex);
+        pair->head = (pair->head + 1) % RESUME_QUEUE_SIZE;
+        pair->count--;
+        oc_mutex_unlock(pair->mutex);
+    }
+}
+
+static void *ParallelPeerThread(void *arg)
+{
+    size_t index = (size_t)(uintptr_t)arg;
+    ParallelPair_t *pair = &g_parallelPairs[index];
+    CAEndpoint_t server;
+    ResumeMakeEndpoint(&server, (uint16_t)(PARALLEL_SERVER_PORT + index));
+    uint8_t message[] = "parallel";
+
+    if (CA_STATUS_OK != CAinitiateSslHandshake(&server))
+    {
+        pair->failed = true;
+        return NULL;
+    }
+    ParallelDeliverAll(pair);
+
+    for (int i = 0; i < PARALLEL_MESSAGES; i++)
+    {
+        if (CA_STATUS_OK != CAencryptSsl(&server, message, sizeof(message)))
+        {
+            pair->failed = true;
+            break;
+        }
+        ParallelDeliverAll(pair);
+    }
+    return NULL;
+}
+
+// Runs the given number of pairs concurrently and returns the elapsed time.
+static uint64_t ParallelRun(size_t pairs)
+{
+    pthread_t threads[PARALLEL_PAIRS];
+    for (size_t i = 0; i < pairs; i++)
+    {
+        g_parallelPairs[i].head = 0;
+        g_parallelPairs[i].count = 0;
+        g_parallelPairs[i].received = 0;
+        g_parallelPairs[i].failed = false;
+    }
+
+    uint64_t beg = OICGetCurrentTime(TIME_IN_US);
+    for (size_t i = 0; i < pairs; i++)
+    {
+        EXPECT_EQ(0, pthread_create(&threads[i], NULL, ParallelPeerThread, (void *)(uintptr_t)i));
+    }
+    for (size_t i = 0; i < pairs; i++)
+    {
+        pthread_join(threads[i], NULL);
+    }
+    uint64_t elapsed = OICGetCurrentTime(TIME_IN_US) - beg;
+
+    for (size_t i = 0; i < pairs; i++)
+    {
+        CAEndpoint_t server;
+        CAEndpoint_t client;
+        ResumeMakeEndpoint(&server, (uint16_t)(PARALLEL_SERVER_PORT + i));
+        ResumeMakeEndpoint(&client, (uint16_t)(PARALLEL_CLIENT_PORT + i));
+        CAcloseSslConnection(&server);
+        ParallelDeliverAll(&g_parallelPairs[i]);
+        CAcloseSslConnection(&client);
+        ParallelDeliverAll(&g_parallelPairs[i]);
+    }
+    return elapsed;
+}
+
+// Established sessions are processed under their own lock, so independent
+// pairs should not wait for each other.
+TEST(TLSAdapter, ParallelSessionsThroughput)
+{
+    for (size_t i = 0; i < PARALLEL_PAIRS; i++)
+    {
+        g_parallelPairs[i].mutex = oc_mutex_new();
+    }
+
+    ASSERT_EQ(CA_STATUS_OK, CAinitSslAdapter());
+    CAsetSslAdapterCallbacks(ParallelReceivedCB, ParallelSendCB, ResumeErrorCB, CA_ADAPTER_IP);
+    CAsetCredentialTypesCallback(ResumeCredentialTypes);
+    CAsetPskCredentialsCallback(ResumePskCredentials);
+    ASSERT_EQ(CA_STATUS_OK, CAsetTlsCipherSuite(MBEDTLS_TLS_ECDHE_PSK_WITH_AES_128_CBC_SHA256));
+
+    uint64_t single = ParallelRun(1);
+    EXPECT_FALSE(g_parallelPairs[0].failed);
+    EXPECT_EQ((size_t)PARALLEL_MESSAGES, g_parallelPairs[0].received);
+
+    uint64_t parallel = ParallelRun(PARALLEL_PAIRS);
+    for (size_t i = 0; i < PARALLEL_PAIRS; i++)
+    {
+        EXPECT_FALSE(g_parallelPairs[i].failed) << "pair " << i;
+        EXPECT_EQ((size_t)PARALLEL_MESSAGES, g_parallelPairs[i].received) << "pair " << i;
+    }
+
+    CAdeinitSslAdapter();
+    for (size_t i = 0; i < PARALLEL_PAIRS; i++)
+    {
+        oc_mutex_free(g_parallelPairs[i].mutex);
+    }
+
+    printf("%d messages per session: 1 session %" PRIu64 " msg/s, %d sessions %" PRIu64 " msg/s\n",
+           PARALLEL_MESSAGES,
+           (uint64_t)PARALLEL_MESSAGES * 1000000 / (single ? single : 1),
+           PARALLEL_PAIRS,
+           (uint64_t)PARALLEL_MESSAGES * PARALLEL_PAIRS * 1000000 / (parallel ? parallel : 1));
+}
+#endif // __WITH_DTLS__
@@ -0,0 +1,103 @@
+//******************************************************************
+//
+// Copyright 2017 Samsung Electronics All Rights Reserved.
+//
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+
+#include "iotivity_config.h"
+#include <gtest/gtest.h>
+
+#include "umempool.h"
+#include "oic_malloc.h"
+
+#include <stdint.h>
+#include <string.h>
+
+#define BLOCK_SIZE 64
+
+TEST(UMemPool, Base)
+{
+    EXPECT_TRUE(NULL == u_mem_pool_create(0, 4));
+    EXPECT_TRUE(NULL == u_mem_pool_create(BLOCK_SIZE, 0));
+    EXPECT_TRUE(NULL == u_mem_pool_alloc(NULL));
+
+    u_mem_pool_t *pool = u_mem_pool_create(BLOCK_SIZE, 4);
+    ASSERT_TRUE(pool != NULL);
+    EXPECT_EQ(0u, u_mem_pool_get_count(pool));
+    u_mem_pool_delete(pool);
+}
+
+TEST(UMemPool, FreedBlocksAreReused)
+{
+    u_mem_pool_t *pool = u_mem_pool_create(BLOCK_SIZE, 4);
+    ASSERT_TRUE(pool != NULL);
+
+    void *block = u_mem_pool_alloc(pool);
+    ASSERT_TRUE(block != NULL);
+    memset(block, 0xff, BLOCK_SIZE);
+    u_mem_pool_free(pool, block);
+    EXPECT_EQ(1u, u_mem_pool_get_count(pool));
+
+    uint32_t before = OICGetAllocationCount();
+    uint8_t *zeroed = (uint8_t *)u_mem_pool_calloc(pool);
+    EXPECT_EQ(before, OICGetAllocationCount());
+    EXPECT_EQ(block, (void *)zeroed);
+    for (int i = 0; i < BLOCK_SIZE; i++)
+    {
+        EXPECT_EQ(0, zeroed[i]);
+    }
+    EXPECT_EQ(0u, u_mem_pool_get_count(pool));
+
+    // blocks from the pool are ordinary heap blocks
+    OICFree(zeroed);
+    u_mem_pool_delete(pool);
+}
+
+TEST(UMemPool, FullPoolFreesBlocks)
+{
+    u_mem_pool_t *pool = u_mem_pool_create(BLOCK_SIZE, 2);
+    ASSERT_TRUE(pool != NULL);
+
+    void *blocks[3];
+    for (int i = 0; i < 3; i++)
+    {
+        blocks[i] = u_mem_pool_alloc(pool);
+        ASSERT_TRUE(blocks[i] != NULL);
+    }
+    for (int i = 0; i < 3; i++)
+    {
+        u_mem_pool_free(pool, blocks[i]);
+    }
+    EXPECT_EQ(2u, u_mem_pool_get_count(pool));
+
+    u_mem_pool_trim(pool);
+    EXPECT_EQ(0u, u_mem_pool_get_count(pool));
+
+    // the pool stays usable after a trim
+    void *block = u_mem_pool_alloc(pool);
+    EXPECT_TRUE(block != NULL);
+    u_mem_pool_free(pool, block);
+    EXPECT_EQ(1u, u_mem_pool_get_count(pool));
+
+    u_mem_pool_delete(pool);
+}
+
+TEST(UMemPool, NullPoolFreesBlocks)
+{
+    u_mem_pool_free(NULL, OICMalloc(BLOCK_SIZE));
+    u_mem_pool_free(NULL, NULL);
+}
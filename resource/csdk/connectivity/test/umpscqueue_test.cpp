@@ -0,0 +1,168 @@
+//******************************************************************
+//
+// Copyright 2017 Samsung Electronics All Rights Reserved.
+//
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+
+#include "iotivity_config.h"
+#include <gtest/gtest.h>
+
+#include "umpscqueue.h"
+#include "octhread.h"
+
+#include <stdint.h>
+
+#ifdef HAVE_UNISTD_H
+#include <unistd.h>
+#endif
+#ifdef HAVE_WINDOWS_H
+#include <windows.h>
+#endif
+
+static void Backoff()
+{
+#ifdef HAVE_UNISTD_H
+    usleep(1);
+#elif defined(HAVE_WINDOWS_H)
+    Sleep(0);
+#endif
+}
+
+static void *MakeMessage(uint32_t producer, uint32_t index)
+{
+    return (void *)(uintptr_t)(((uintptr_t)producer << 24) | (index + 1));
+}
+
+TEST(UMpscQueue, Base)
+{
+    EXPECT_TRUE(NULL == u_mpsc_queue_create(0));
+
+    u_mpsc_queue_t *queue = u_mpsc_queue_create(1000);
+    ASSERT_TRUE(queue != NULL);
+    EXPECT_EQ(1024u, u_mpsc_queue_get_capacity(queue));
+    EXPECT_EQ(0u, u_mpsc_queue_get_size(queue));
+    u_mpsc_queue_delete(queue);
+}
+
+TEST(UMpscQueue, FifoUntilFull)
+{
+    u_mpsc_queue_t *queue = u_mpsc_queue_create(8);
+    ASSERT_TRUE(queue != NULL);
+
+    for (uint32_t i = 0; i < 8; i++)
+    {
+        EXPECT_TRUE(u_mpsc_queue_push(queue, MakeMessage(0, i), i));
+    }
+    EXPECT_EQ(8u, u_mpsc_queue_get_size(queue));
+    EXPECT_FALSE(u_mpsc_queue_push(queue, MakeMessage(0, 8), 8));
+
+    u_queue_message_t message;
+    for (uint32_t i = 0; i < 8; i++)
+    {
+        ASSERT_TRUE(u_mpsc_queue_pop(queue, &message));
+        EXPECT_EQ(MakeMessage(0, i), message.msg);
+        EXPECT_EQ(i, message.size);
+    }
+    EXPECT_FALSE(u_mpsc_queue_pop(queue, &message));
+    EXPECT_EQ(0u, u_mpsc_queue_get_size(queue));
+
+    u_mpsc_queue_delete(queue);
+}
+
+TEST(UMpscQueue, WrapsAround)
+{
+    u_mpsc_queue_t *queue = u_mpsc_queue_create(4);
+    ASSERT_TRUE(queue != NULL);
+
+    u_queue_message_t message;
+    for (uint32_t i = 0; i < 1000; i++)
+    {
+        ASSERT_TRUE(u_mpsc_queue_push(queue, MakeMessage(0, i), i));
+        ASSERT_TRUE(u_mpsc_queue_push(queue, MakeMessage(1, i), i));
+        ASSERT_TRUE(u_mpsc_queue_pop(queue, &message));
+        EXPECT_EQ(MakeMessage(0, i), message.msg);
+        ASSERT_TRUE(u_mpsc_queue_pop(queue, &message));
+        EXPECT_EQ(MakeMessage(1, i), message.msg);
+    }
+    EXPECT_FALSE(u_mpsc_queue_pop(queue, &message));
+
+    u_mpsc_queue_delete(queue);
+}
+
+#define PRODUCER_COUNT 4
+#define PRODUCER_MESSAGES 20000
+
+typedef struct
+{
+    u_mpsc_queue_t *queue;
+    uint32_t producer;
+} ProducerArgs_t;
+
+static void *Produce(void *arg)
+{
+    ProducerArgs_t *args = (ProducerArgs_t *)arg;
+    for (uint32_t i = 0; i < PRODUCER_MESSAGES; i++)
+    {
+        while (!u_mpsc_queue_push(args->queue, MakeMessage(args->producer, i), args->producer))
+        {
+            Backoff();
+        }
+    }
+    return NULL;
+}
+
+TEST(UMpscQueue, ManyProducersKeepTheirOrder)
+{
+    u_mpsc_queue_t *queue = u_mpsc_queue_create(64);
+    ASSERT_TRUE(queue != NULL);
+
+    oc_thread threads[PRODUCER_COUNT];
+    ProducerArgs_t args[PRODUCER_COUNT];
+    for (uint32_t p = 0; p < PRODUCER_COUNT; p++)
+    {
+        args[p].queue = queue;
+        args[p].producer = p;
+        ASSERT_EQ(OC_THREAD_SUCCESS, oc_thread_new(&threads[p], Produce, &args[p]));
+    }
+
+    uint32_t next[PRODUCER_COUNT] = { 0 };
+    uint32_t received = 0;
+    u_queue_message_t message;
+    while (received < PRODUCER_COUNT * PRODUCER_MESSAGES)
+    {
+        if (!u_mpsc_queue_pop(queue, &message))
+        {
+            Backoff();
+            continue;
+        }
+        uint32_t producer = message.size;
+        ASSERT_LT(producer, (uint32_t)PRODUCER_COUNT);
+        ASSERT_EQ(MakeMessage(producer, next[producer]), message.msg);
+        next[producer]++;
+        received++;
+    }
+
+    for (uint32_t p = 0; p < PRODUCER_COUNT; p++)
+    {
+        oc_thread_wait(threads[p]);
+        oc_thread_free(threads[p]);
+        EXPECT_EQ((uint32_t)PRODUCER_MESSAGES, next[p]);
+    }
+    EXPECT_FALSE(u_mpsc_queue_pop(queue, &message));
+
+    u_mpsc_queue_delete(queue);
+}
@@ -138,6 +138,12 @@ CAResult_t CASetPortNumberToAssign(CATransportAdapter_t adapter,
     return CA_NOT_SUPPORTED;
 }
 
+void CAUtilSetIPSendBatching(bool enable)
+{
+    OIC_LOG_V(DEBUG, TAG, "CAUtilSetIPSendBatching %d", enable);
+    caglobals.ip.sendBatching = enable;
+}
+
 uint16_t CAGetAssignedPortNumber(CATransportAdapter_t adapter, CATransportFlags_t flag)
 {
     OIC_LOG(DEBUG, TAG, "CAGetAssignedPortNumber");
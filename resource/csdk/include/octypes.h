@@ -1441,7 +1441,9 @@ typedef enum
     /** The payload is an OCDiagnosticPayload */
     PAYLOAD_TYPE_DIAGNOSTIC,
     /** The payload is an OCIntrospectionPayload */
-    PAYLOAD_TYPE_INTROSPECTION
+    PAYLOAD_TYPE_INTROSPECTION,
+    /** The payload is an OCEncodedRepPayload */
+    PAYLOAD_TYPE_ENCODED_REPRESENTATION
 } OCPayloadType;
 
 /**
@@ -1528,6 +1530,10 @@ typedef struct OCRepPayload
     OCStringLL* interfaces;
     OCRepPayloadValue* values;
     struct OCRepPayload* next;
+    /** Opaque: private to ocpayload.c, which allocates and frees it.*/
+    struct OCRepPayloadIndex* index;
+    /** Arena the payload and its values are allocated in, see OCRepPayloadCreateInArena.*/
+    struct OCPayloadBuffer* buffer;
 } OCRepPayload;
 
 // used inside a resource payload
@@ -1613,6 +1619,17 @@ typedef struct
     OCByteString cborPayload;
 } OCIntrospectionPayload;
 
+/**
+ * A representation that is already encoded as CBOR, as the C++ layer sends it and, when
+ * asked with OCSetResponsePayloadEncoded, receives it. The CBOR is the same that
+ * OCConvertPayload makes of the matching OCRepPayload.
+ */
+typedef struct
+{
+    OCPayload base;
+    OCByteString cborPayload;
+} OCEncodedRepPayload;
+
 /**
  * Incoming requests handled by the server. Requests are passed in as a parameter to the
  * OCEntityHandler callback API.
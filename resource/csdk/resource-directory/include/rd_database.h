@@ -28,7 +28,8 @@ extern "C" {
 #ifdef RD_SERVER
 
 /**
- * Opens the RD publish database.
+ * Opens the RD publish database.  The connection is kept open by subsequent calls until
+ * ::OCRDDatabaseClose is called or the storage file is replaced.
  *
  * @return ::OC_STACK_OK in case of success or else other value.
  */
@@ -88,6 +88,103 @@ static sqlite3 *gRDDB = NULL;
     "FOREIGN KEY("XSTR(LINK_ID)") REFERENCES RD_DEVICE_LINK_LIST("XSTR(OC_RSRVD_INS)") " \
     "ON DELETE CASCADE);"
 
+/*
+ * The link tables are looked up by LINK_ID for every stored and discovered link; the rt and if
+ * values are part of the index so that the discovery filters are answered from the index alone.
+ */
+#define RD_INDEXES \
+    "CREATE INDEX IF NOT EXISTS RD_DEVICE_LINK_LIST_DEVICE_ID " \
+    "ON RD_DEVICE_LINK_LIST(DEVICE_ID, " XSTR(OC_RSRVD_HREF) ");" \
+    "CREATE INDEX IF NOT EXISTS RD_LINK_RT_LINK_ID " \
+    "ON RD_LINK_RT(LINK_ID, " XSTR(OC_RSRVD_RESOURCE_TYPE) ");" \
+    "CREATE INDEX IF NOT EXISTS RD_LINK_IF_LINK_ID " \
+    "ON RD_LINK_IF(LINK_ID, " XSTR(OC_RSRVD_INTERFACE) ");" \
+    "CREATE INDEX IF NOT EXISTS RD_LINK_EP_LINK_ID ON RD_LINK_EP(LINK_ID);"
+
+/* Time to wait for the discovery connection to release the database, in milliseconds */
+#define RD_BUSY_TIMEOUT_MS (1000)
+
+/*
+ * Statements used by publish and delete requests.  They are prepared once on the long-lived
+ * connection and reset after each use.
+ */
+typedef enum
+{
+    RD_DELETE_RT = 0,
+    RD_INSERT_RT,
+    RD_DELETE_IF,
+    RD_INSERT_IF,
+    RD_DELETE_EP,
+    RD_INSERT_EP,
+    RD_INSERT_LINK,
+    RD_UPDATE_LINK,
+    RD_SELECT_LINK,
+    RD_INSERT_DEVICE,
+    RD_UPDATE_DEVICE,
+    RD_SELECT_DEVICE,
+    RD_DELETE_DEVICE,
+    RD_DELETE_LINK,
+    RD_STATEMENT_COUNT
+} RDStatement;
+
+static const char *gRDStatementSql[RD_STATEMENT_COUNT] =
+{
+    "DELETE FROM RD_LINK_RT WHERE LINK_ID=@id",
+    "INSERT INTO RD_LINK_RT VALUES(@resourceType, @id)",
+    "DELETE FROM RD_LINK_IF WHERE LINK_ID=@id",
+    "INSERT INTO RD_LINK_IF VALUES(@interfaceType, @id)",
+    "DELETE FROM RD_LINK_EP WHERE LINK_ID=@id",
+    "INSERT INTO RD_LINK_EP VALUES(@ep, @pri, @id)",
+    "INSERT OR IGNORE INTO RD_DEVICE_LINK_LIST (ins, href, DEVICE_ID) "
+        "VALUES((SELECT ins FROM RD_DEVICE_LINK_LIST WHERE DEVICE_ID=@id AND href=@uri),@uri,@id)",
+    "UPDATE RD_DEVICE_LINK_LIST SET anchor=@anchor,bm=@bm WHERE DEVICE_ID=@id AND href=@uri",
+    "SELECT ins FROM RD_DEVICE_LINK_LIST WHERE DEVICE_ID=@id AND href=@uri",
+    /* INSERT OR IGNORE then UPDATE to update or insert the row without triggering the cascading deletes */
+    "INSERT OR IGNORE INTO RD_DEVICE_LIST (ID, di, ttl, external_host) "
+        "VALUES ((SELECT ID FROM RD_DEVICE_LIST WHERE di=@deviceId), @deviceId, @ttl, @external_host)",
+    "UPDATE RD_DEVICE_LIST SET ttl=@ttl WHERE di=@deviceId",
+    "SELECT ID FROM RD_DEVICE_LIST WHERE di=@deviceId",
+    "DELETE FROM RD_DEVICE_LIST WHERE di=@deviceId",
+    "DELETE FROM RD_DEVICE_LINK_LIST WHERE ins=@ins"
+};
+
+static sqlite3_stmt *gRDStatements[RD_STATEMENT_COUNT] = { NULL };
+
+/* Copy of the storage filename gRDDB was opened with */
+static char *gRDDBFilename = NULL;
+
+static int getStatement(RDStatement id, sqlite3_stmt **stmt)
+{
+    if (!gRDStatements[id])
+    {
+        int res = sqlite3_prepare_v2(gRDDB, gRDStatementSql[id], -1, &gRDStatements[id], NULL);
+        if (SQLITE_OK != res)
+        {
+            return res;
+        }
+    }
+    *stmt = gRDStatements[id];
+    return SQLITE_OK;
+}
+
+static void releaseStatement(sqlite3_stmt *stmt)
+{
+    if (stmt)
+    {
+        sqlite3_reset(stmt);
+        sqlite3_clear_bindings(stmt);
+    }
+}
+
+static void finalizeStatements()
+{
+    for (size_t i = 0; i < RD_STATEMENT_COUNT; i++)
+    {
+        sqlite3_finalize(gRDStatements[i]);
+        gRDStatements[i] = NULL;
+    }
+}
+
 static void errorCallback(void *arg, int errCode, const char *errMsg)
 {
     OC_UNUSED(arg);
@@ -130,24 +227,19 @@ static int storeResourceTypes(const char **resourceTypes, size_t size, sqlite3_i
 
     VERIFY_SQLITE(sqlite3_exec(gRDDB, "SAVEPOINT storeResourceTypes", NULL, NULL, NULL));
 
-    static const char deleteRT[] = "DELETE FROM RD_LINK_RT WHERE LINK_ID=@id";
-    static const char insertRT[] = "INSERT INTO RD_LINK_RT VALUES(@resourceType, @id)";
-    int deleteRTSize = (int)sizeof(deleteRT);
-    int insertRTSize = (int)sizeof(insertRT);
-
-    VERIFY_SQLITE(sqlite3_prepare_v2(gRDDB, deleteRT, deleteRTSize, &stmt, NULL));
+    VERIFY_SQLITE(getStatement(RD_DELETE_RT, &stmt));
     VERIFY_SQLITE(sqlite3_bind_int64(stmt, sqlite3_bind_parameter_index(stmt, "@id"), rowid));
     res = sqlite3_step(stmt);
     if (SQLITE_DONE != res)
     {
         goto exit;
     }
-    VERIFY_SQLITE(sqlite3_finalize(stmt));
+    releaseStatement(stmt);
     stmt = NULL;
 
     for (size_t i = 0; i < size; i++)
     {
-        VERIFY_SQLITE(sqlite3_prepare_v2(gRDDB, insertRT, insertRTSize, &stmt, NULL));
+        VERIFY_SQLITE(getStatement(RD_INSERT_RT, &stmt));
         if (resourceTypes[i])
         {
             VERIFY_SQLITE(sqlite3_bind_text(stmt, sqlite3_bind_parameter_index(stmt, "@resourceType"),
@@ -159,7 +251,7 @@ static int storeResourceTypes(const char **resourceTypes, size_t size, sqlite3_i
         {
             goto exit;
         }
-        VERIFY_SQLITE(sqlite3_finalize(stmt));
+        releaseStatement(stmt);
         stmt = NULL;
     }
 
@@ -167,7 +259,7 @@ static int storeResourceTypes(const char **resourceTypes, size_t size, sqlite3_i
     res = SQLITE_OK;
 
 exit:
-    sqlite3_finalize(stmt);
+    releaseStatement(stmt);
     if (SQLITE_OK != res)
     {
         sqlite3_exec(gRDDB, "ROLLBACK TO storeResourceTypes", NULL, NULL, NULL);
@@ -186,24 +278,19 @@ static int storeInterfaces(const char **interfaces, size_t size, sqlite3_int64 r
 
     VERIFY_SQLITE(sqlite3_exec(gRDDB, "SAVEPOINT storeInterfaces", NULL, NULL, NULL));
 
-    static const char deleteIF[] = "DELETE FROM RD_LINK_IF WHERE LINK_ID=@id";
-    static const char insertIF[] = "INSERT INTO RD_LINK_IF VALUES(@interfaceType, @id)";
-    int deleteIFLength = (int)sizeof(deleteIF);
-    int insertIFLength = (int)sizeof(insertIF);
-
-    VERIFY_SQLITE(sqlite3_prepare_v2(gRDDB, deleteIF, deleteIFLength, &stmt, NULL));
+    VERIFY_SQLITE(getStatement(RD_DELETE_IF, &stmt));
     VERIFY_SQLITE(sqlite3_bind_int64(stmt, sqlite3_bind_parameter_index(stmt, "@id"), rowid));
     res = sqlite3_step(stmt);
     if (SQLITE_DONE != res)
     {
         goto exit;
     }
-    VERIFY_SQLITE(sqlite3_finalize(stmt));
+    releaseStatement(stmt);
     stmt = NULL;
 
     for (size_t i = 0; i < size; i++)
     {
-        VERIFY_SQLITE(sqlite3_prepare_v2(gRDDB, insertIF, insertIFLength, &stmt, NULL));
+        VERIFY_SQLITE(getStatement(RD_INSERT_IF, &stmt));
         if (interfaces[i])
         {
             VERIFY_SQLITE(sqlite3_bind_text(stmt, sqlite3_bind_parameter_index(stmt, "@interfaceType"),
@@ -215,7 +302,7 @@ static int storeInterfaces(const char **interfaces, size_t size, sqlite3_int64 r
         {
             goto exit;
         }
-        VERIFY_SQLITE(sqlite3_finalize(stmt));
+        releaseStatement(stmt);
         stmt = NULL;
     }
 
@@ -223,7 +310,7 @@ static int storeInterfaces(const char **interfaces, size_t size, sqlite3_int64 r
     res = SQLITE_OK;
 
 exit:
-    sqlite3_finalize(stmt);
+    releaseStatement(stmt);
     if (SQLITE_OK != res)
     {
         sqlite3_exec(gRDDB, "ROLLBACK TO storeInterfaces", NULL, NULL, NULL);
@@ -238,24 +325,20 @@ static int storeEndpoints(OCRepPayload **eps, size_t size, sqlite3_int64 rowid)
     sqlite3_stmt *stmt = NULL;
 
     VERIFY_SQLITE(sqlite3_exec(gRDDB, "SAVEPOINT storeEndpoints", NULL, NULL, NULL));
-    static const char deleteEp[] = "DELETE FROM RD_LINK_EP WHERE LINK_ID=@id";
-    static const char insertEp[] = "INSERT INTO RD_LINK_EP VALUES(@ep, @pri, @id)";
-    int deleteEpLength = (int)sizeof(deleteEp);
-    int insertEpLength = (int)sizeof(insertEp);
 
-    VERIFY_SQLITE(sqlite3_prepare_v2(gRDDB, deleteEp, deleteEpLength, &stmt, NULL));
+    VERIFY_SQLITE(getStatement(RD_DELETE_EP, &stmt));
     VERIFY_SQLITE(sqlite3_bind_int64(stmt, sqlite3_bind_parameter_index(stmt, "@id"), rowid));
     res = sqlite3_step(stmt);
     if (SQLITE_DONE != res)
     {
         goto exit;
     }
-    VERIFY_SQLITE(sqlite3_finalize(stmt));
+    releaseStatement(stmt);
     stmt = NULL;
 
     for (size_t i = 0; i < size; i++)
     {
-        VERIFY_SQLITE(sqlite3_prepare_v2(gRDDB, insertEp, insertEpLength, &stmt, NULL));
+        VERIFY_SQLITE(getStatement(RD_INSERT_EP, &stmt));
         if (OCRepPayloadGetPropString(eps[i], OC_RSRVD_ENDPOINT, &ep))
         {
             if (!stringArgumentWithinBounds(ep))
@@ -274,7 +357,7 @@ static int storeEndpoints(OCRepPayload **eps, size_t size, sqlite3_int64 rowid)
         {
             goto exit;
         }
-        VERIFY_SQLITE(sqlite3_finalize(stmt));
+        releaseStatement(stmt);
         stmt = NULL;
         OICFree(ep);
         ep = NULL;
@@ -285,7 +368,7 @@ static int storeEndpoints(OCRepPayload **eps, size_t size, sqlite3_int64 rowid)
 
 exit:
     OICFree(ep);
-    sqlite3_finalize(stmt);
+    releaseStatement(stmt);
     if (SQLITE_OK != res)
     {
         sqlite3_exec(gRDDB, "ROLLBACK TO storeInterfaces", NULL, NULL, NULL);
@@ -332,20 +415,12 @@ static int storeLinkPayload(OCRepPayloadValue *links, sqlite3_int64 rowid)
     OCRepPayload** eps = NULL;
     size_t epsDim[MAX_REP_ARRAY_DEPTH] = {0};
 
-    static const char insertDeviceLLList[] = "INSERT OR IGNORE INTO RD_DEVICE_LINK_LIST (ins, href, DEVICE_ID) "
-        "VALUES((SELECT ins FROM RD_DEVICE_LINK_LIST WHERE DEVICE_ID=@id AND href=@uri),@uri,@id)";
-    static const char updateDeviceLLList[] = "UPDATE RD_DEVICE_LINK_LIST SET anchor=@anchor,bm=@bm "
-        "WHERE DEVICE_ID=@id AND href=@uri";
-    int insertDeviceLLListSize = (int)sizeof(insertDeviceLLList);
-    int updateDeviceLLListSize = (int)sizeof(updateDeviceLLList);
-
     assert(links);
     for (size_t i = 0; (SQLITE_OK == res) && (i < links->arr.dimensions[0]); i++)
     {
         VERIFY_SQLITE(sqlite3_exec(gRDDB, "SAVEPOINT storeLinkPayload", NULL, NULL, NULL));
 
-        VERIFY_SQLITE(sqlite3_prepare_v2(gRDDB, insertDeviceLLList,
-                        insertDeviceLLListSize, &stmt, NULL));
+        VERIFY_SQLITE(getStatement(RD_INSERT_LINK, &stmt));
 
         OCRepPayload *link = links->arr.objArray[i];
         VERIFY_SQLITE(sqlite3_bind_int64(stmt, sqlite3_bind_parameter_index(stmt, "@id"), rowid));
@@ -353,7 +428,8 @@ static int storeLinkPayload(OCRepPayloadValue *links, sqlite3_int64 rowid)
         {
             if (!stringArgumentWithinBounds(uri))
             {
-                return SQLITE_ERROR;
+                res = SQLITE_ERROR;
+                goto exit;
             }
             VERIFY_SQLITE(sqlite3_bind_text(stmt, sqlite3_bind_parameter_index(stmt, "@uri"),
                             uri, (int)strlen(uri), SQLITE_STATIC));
@@ -363,11 +439,10 @@ static int storeLinkPayload(OCRepPayloadValue *links, sqlite3_int64 rowid)
         {
             goto exit;
         }
-        VERIFY_SQLITE(sqlite3_finalize(stmt));
+        releaseStatement(stmt);
         stmt = NULL;
 
-        VERIFY_SQLITE(sqlite3_prepare_v2(gRDDB, updateDeviceLLList,
-                        updateDeviceLLListSize, &stmt, NULL));
+        VERIFY_SQLITE(getStatement(RD_UPDATE_LINK, &stmt));
         VERIFY_SQLITE(sqlite3_bind_int64(stmt, sqlite3_bind_parameter_index(stmt, "@id"), rowid));
         if (uri)
         {
@@ -396,13 +471,10 @@ static int storeLinkPayload(OCRepPayloadValue *links, sqlite3_int64 rowid)
         {
             goto exit;
         }
-        VERIFY_SQLITE(sqlite3_finalize(stmt));
+        releaseStatement(stmt);
         stmt = NULL;
 
-        static const char input[] = "SELECT ins FROM RD_DEVICE_LINK_LIST WHERE DEVICE_ID=@id AND href=@uri";
-        int inputSize = (int)sizeof(input);
-
-        VERIFY_SQLITE(sqlite3_prepare_v2(gRDDB, input, inputSize, &stmt, NULL));
+        VERIFY_SQLITE(getStatement(RD_SELECT_LINK, &stmt));
         VERIFY_SQLITE(sqlite3_bind_int64(stmt, sqlite3_bind_parameter_index(stmt, "@id"), rowid));
         if (uri)
         {
@@ -413,12 +485,13 @@ static int storeLinkPayload(OCRepPayloadValue *links, sqlite3_int64 rowid)
         if (res == SQLITE_ROW || res == SQLITE_DONE)
         {
             sqlite3_int64 ins = sqlite3_column_int64(stmt, 0);
-            VERIFY_SQLITE(sqlite3_finalize(stmt));
+            releaseStatement(stmt);
             stmt = NULL;
             if (!OCRepPayloadSetPropInt(link, OC_RSRVD_INS, ins))
             {
                 OIC_LOG_V(ERROR, TAG, "Error setting 'ins' value");
-                return SQLITE_ERROR;
+                res = SQLITE_ERROR;
+                goto exit;
             }
             OCRepPayloadGetStringArray(link, OC_RSRVD_RESOURCE_TYPE, &rt, rtDim);
             OCRepPayloadGetStringArray(link, OC_RSRVD_INTERFACE, &itf, itfDim);
@@ -429,7 +502,7 @@ static int storeLinkPayload(OCRepPayloadValue *links, sqlite3_int64 rowid)
         }
         else
         {
-            VERIFY_SQLITE(sqlite3_finalize(stmt));
+            releaseStatement(stmt);
             stmt = NULL;
         }
 
@@ -470,7 +543,7 @@ static int storeLinkPayload(OCRepPayloadValue *links, sqlite3_int64 rowid)
         anchor = NULL;
         OICFree(uri);
         uri = NULL;
-        sqlite3_finalize(stmt);
+        releaseStatement(stmt);
         stmt = NULL;
         if (SQLITE_OK != res)
         {
@@ -512,12 +585,7 @@ static int storeResources(const OCRepPayload *payload, bool externalHost)
     int res;
     VERIFY_SQLITE(sqlite3_exec(gRDDB, "BEGIN TRANSACTION", NULL, NULL, NULL));
 
-    /* INSERT OR IGNORE then UPDATE to update or insert the row without triggering the cascading deletes */
-    static const char insertDeviceList[] = "INSERT OR IGNORE INTO RD_DEVICE_LIST (ID, di, ttl, external_host) "
-        "VALUES ((SELECT ID FROM RD_DEVICE_LIST WHERE di=@deviceId), @deviceId, @ttl, @external_host)";
-    int insertDeviceListSize = (int)sizeof(insertDeviceList);
-    VERIFY_SQLITE(sqlite3_prepare_v2(gRDDB, insertDeviceList, insertDeviceListSize,
-                    &stmt, NULL));
+    VERIFY_SQLITE(getStatement(RD_INSERT_DEVICE, &stmt));
     if (deviceId)
     {
         VERIFY_SQLITE(sqlite3_bind_text(stmt, sqlite3_bind_parameter_index(stmt, "@deviceId"),
@@ -534,13 +602,10 @@ static int storeResources(const OCRepPayload *payload, bool externalHost)
     {
         goto exit;
     }
-    VERIFY_SQLITE(sqlite3_finalize(stmt));
+    releaseStatement(stmt);
     stmt = NULL;
 
-    static const char updateDeviceList[] = "UPDATE RD_DEVICE_LIST SET ttl=@ttl WHERE di=@deviceId";
-    int updateDeviceListSize = (int)sizeof(updateDeviceList);
-    VERIFY_SQLITE(sqlite3_prepare_v2(gRDDB, updateDeviceList, updateDeviceListSize,
-                    &stmt, NULL));
+    VERIFY_SQLITE(getStatement(RD_UPDATE_DEVICE, &stmt));
     if (deviceId)
     {
         VERIFY_SQLITE(sqlite3_bind_text(stmt, sqlite3_bind_parameter_index(stmt, "@deviceId"),
@@ -555,14 +620,11 @@ static int storeResources(const OCRepPayload *payload, bool externalHost)
     {
         goto exit;
     }
-    VERIFY_SQLITE(sqlite3_finalize(stmt));
+    releaseStatement(stmt);
     stmt = NULL;
 
     /* Store the rest of the payload */
-    static const char input[] = "SELECT ID FROM RD_DEVICE_LIST WHERE di=@deviceId";
-    int inputSize = (int)sizeof(input);
-
-    VERIFY_SQLITE(sqlite3_prepare_v2(gRDDB, input, inputSize, &stmt, NULL));
+    VERIFY_SQLITE(getStatement(RD_SELECT_DEVICE, &stmt));
     if (deviceId)
     {
         VERIFY_SQLITE(sqlite3_bind_text(stmt, sqlite3_bind_parameter_index(stmt, "@deviceId"),
@@ -572,13 +634,13 @@ static int storeResources(const OCRepPayload *payload, bool externalHost)
     if (res == SQLITE_ROW || res == SQLITE_DONE)
     {
         sqlite3_int64 rowid = sqlite3_column_int64(stmt, 0);
-        VERIFY_SQLITE(sqlite3_finalize(stmt));
+        releaseStatement(stmt);
         stmt = NULL;
         VERIFY_SQLITE(storeLinkPayload(links, rowid));
     }
     else
     {
-        VERIFY_SQLITE(sqlite3_finalize(stmt));
+        releaseStatement(stmt);
         stmt = NULL;
     }
 
@@ -586,7 +648,7 @@ static int storeResources(const OCRepPayload *payload, bool externalHost)
     res = SQLITE_OK;
 
 exit:
-    sqlite3_finalize(stmt);
+    releaseStatement(stmt);
     OICFree(deviceId);
     if (SQLITE_OK != res)
     {
@@ -597,7 +659,6 @@ exit:
 
 static int deleteResources(const char *deviceId, const int64_t *instanceIds, uint16_t nInstanceIds)
 {
-    char *delResource = NULL;
     sqlite3_stmt *stmt = NULL;
     if (!stringArgumentWithinBounds(deviceId))
     {
@@ -610,58 +671,41 @@ static int deleteResources(const char *deviceId, const int64_t *instanceIds, uin
 
     if (!instanceIds || !nInstanceIds)
     {
-        static const char delDevice[] = "DELETE FROM RD_DEVICE_LIST WHERE di=@deviceId";
-        int delDeviceSize = (int)sizeof(delDevice);
-
-        VERIFY_SQLITE(sqlite3_prepare_v2(gRDDB, delDevice, delDeviceSize, &stmt, NULL));
+        VERIFY_SQLITE(getStatement(RD_DELETE_DEVICE, &stmt));
         VERIFY_SQLITE(sqlite3_bind_text(stmt, sqlite3_bind_parameter_index(stmt, "@deviceId"),
                                         deviceId, (int)strlen(deviceId), SQLITE_STATIC));
-    }
-    else
-    {
-        static const char pre[] = "DELETE FROM RD_DEVICE_LINK_LIST "
-            "WHERE ins IN ("
-            "SELECT RD_DEVICE_LINK_LIST.ins FROM RD_DEVICE_LINK_LIST "
-            "INNER JOIN RD_DEVICE_LIST ON RD_DEVICE_LINK_LIST.DEVICE_ID=RD_DEVICE_LIST.ID "
-            "WHERE RD_DEVICE_LINK_LIST.ins IN (";
-        size_t inLen = nInstanceIds + (nInstanceIds - 1);
-        static const char post[] = "))";
-        size_t delResourceSize = sizeof(pre) + inLen + (sizeof(post) - 1);
-        delResource = OICCalloc(delResourceSize, 1);
-        if (!delResource)
+        res = sqlite3_step(stmt);
+        if (SQLITE_DONE != res)
         {
-            res = SQLITE_NOMEM;
             goto exit;
         }
-        OICStrcat(delResource, delResourceSize, pre);
-        OICStrcat(delResource, delResourceSize, "?");
-        for (uint16_t i = 1; i < nInstanceIds; ++i)
-        {
-            OICStrcat(delResource, delResourceSize, ",?");
-        }
-        OICStrcat(delResource, delResourceSize, post);
-        VERIFY_SQLITE(sqlite3_prepare_v2(gRDDB, delResource, (int)delResourceSize,
-                        &stmt, NULL));
+        releaseStatement(stmt);
+        stmt = NULL;
+    }
+    else
+    {
+        /* Reuse the same statement for each instance instead of preparing an IN list per request */
+        VERIFY_SQLITE(getStatement(RD_DELETE_LINK, &stmt));
         for (uint16_t i = 0; i < nInstanceIds; ++i)
         {
-            VERIFY_SQLITE(sqlite3_bind_int64(stmt, 1 + i, instanceIds[i]));
+            VERIFY_SQLITE(sqlite3_bind_int64(stmt, sqlite3_bind_parameter_index(stmt, "@ins"),
+                            instanceIds[i]));
+            res = sqlite3_step(stmt);
+            if (SQLITE_DONE != res)
+            {
+                goto exit;
+            }
+            VERIFY_SQLITE(sqlite3_reset(stmt));
         }
+        releaseStatement(stmt);
+        stmt = NULL;
     }
 
-    res = sqlite3_step(stmt);
-    if (SQLITE_DONE != res)
-    {
-        goto exit;
-    }
-    VERIFY_SQLITE(sqlite3_finalize(stmt));
-    stmt = NULL;
-
     VERIFY_SQLITE(sqlite3_exec(gRDDB, "COMMIT", NULL, NULL, NULL));
     res = SQLITE_OK;
 
 exit:
-    OICFree(delResource);
-    sqlite3_finalize(stmt);
+    releaseStatement(stmt);
     if (SQLITE_OK != res)
     {
         sqlite3_exec(gRDDB, "ROLLBACK", NULL, NULL, NULL);
@@ -669,8 +713,47 @@ exit:
     return res;
 }
 
+static bool databaseIsOpen()
+{
+    if (!gRDDB)
+    {
+        return false;
+    }
+    if (gRDDBFilename && (0 == strcmp(gRDDBFilename, OCRDDatabaseGetStorageFilename())))
+    {
+        int moved = 0;
+        if ((SQLITE_OK == sqlite3_file_control(gRDDB, "main", SQLITE_FCNTL_HAS_MOVED, &moved)) &&
+                !moved)
+        {
+            return true;
+        }
+    }
+    OIC_LOG(DEBUG, TAG, "RD database file has changed, reopening it.");
+    return false;
+}
+
+static int closeDatabase()
+{
+    finalizeStatements();
+    int res = sqlite3_close(gRDDB);
+    gRDDB = NULL;
+    OICFree(gRDDBFilename);
+    gRDDBFilename = NULL;
+    return res;
+}
+
 OCStackResult OC_CALL OCRDDatabaseInit()
 {
+    /* The connection is kept open between requests unless the storage file has changed */
+    if (databaseIsOpen())
+    {
+        return OC_STACK_OK;
+    }
+    if (gRDDB)
+    {
+        closeDatabase();
+    }
+
     if (SQLITE_OK == sqlite3_config(SQLITE_CONFIG_LOG, errorCallback))
     {
         OIC_LOG_V(INFO, TAG, "SQLite debugging log initialized.");
@@ -683,6 +766,8 @@ OCStackResult OC_CALL OCRDDatabaseInit()
     {
         OIC_LOG(DEBUG, TAG, "RD database file did not open, as no table exists.");
         OIC_LOG(DEBUG, TAG, "RD creating new table.");
+        sqlite3_close(gRDDB);
+        gRDDB = NULL;
         VERIFY_SQLITE(sqlite3_open_v2(OCRDDatabaseGetStorageFilename(), &gRDDB,
                         SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE, NULL));
 
@@ -714,6 +799,21 @@ OCStackResult OC_CALL OCRDDatabaseInit()
         }
         VERIFY_SQLITE(sqlite3_finalize(stmt));
         stmt = NULL;
+
+        /*
+         * Write-ahead logging lets the discovery connection read while publish requests write,
+         * and a normal sync level is sufficient for a database whose entries expire anyway.
+         */
+        VERIFY_SQLITE(sqlite3_exec(gRDDB, "PRAGMA journal_mode = WAL;", NULL, NULL, NULL));
+        VERIFY_SQLITE(sqlite3_exec(gRDDB, "PRAGMA synchronous = NORMAL;", NULL, NULL, NULL));
+        VERIFY_SQLITE(sqlite3_busy_timeout(gRDDB, RD_BUSY_TIMEOUT_MS));
+        VERIFY_SQLITE(sqlite3_exec(gRDDB, RD_INDEXES, NULL, NULL, NULL));
+
+        gRDDBFilename = OICStrdup(OCRDDatabaseGetStorageFilename());
+        if (!gRDDBFilename)
+        {
+            res = SQLITE_NOMEM;
+        }
     }
 
 exit:
@@ -724,8 +824,7 @@ exit:
     }
     else
     {
-        sqlite3_close(gRDDB);
-        gRDDB = NULL;
+        closeDatabase();
         return OC_STACK_ERROR;
     }
 }
@@ -734,8 +833,7 @@ OCStackResult OC_CALL OCRDDatabaseClose()
 {
     CHECK_DATABASE_INIT;
     int res;
-    VERIFY_SQLITE(sqlite3_close(gRDDB));
-    gRDDB = NULL;
+    VERIFY_SQLITE(closeDatabase());
 
 exit:
     return (SQLITE_OK == res) ? OC_STACK_OK : OC_STACK_ERROR;
@@ -29,6 +29,7 @@ extern "C"
     #include "oic_malloc.h"
     #include "oic_string.h"
     #include "ocpayload.h"
+    #include "experimental/ocrandom.h"
     #include "experimental/payload_logging.h"
 }
 
@@ -176,10 +177,16 @@ static OCRepPayload *CreateRDPublishPayload(const char *deviceId,
         OCRepPayloadSetPropString(eps[1], OC_RSRVD_ENDPOINT, "coaps://[::1]:5678");
         OCRepPayloadSetPropInt(eps[1], OC_RSRVD_PRIORITY, 1);
         OCRepPayloadSetPropObjectArray(link, OC_RSRVD_ENDPOINTS, (const OCRepPayload **)eps, epsDim);
+        OCRepPayloadDestroy(eps[0]);
+        OCRepPayloadDestroy(eps[1]);
         linkArr[i] = link;
     }
 
     OCRepPayloadSetPropObjectArray(repPayload, OC_RSRVD_LINKS, linkArr, dimensions);
+    for (size_t i = 0; i < nresources; ++i)
+    {
+        OCRepPayloadDestroy((OCRepPayload *)linkArr[i]);
+    }
 
     OIC_LOG_PAYLOAD(DEBUG, (OCPayload *)repPayload);
     return repPayload;
@@ -489,3 +496,81 @@ TEST_F(RDDatabaseTests, TTLLapsedDeleteDevice)
     OCDiscoveryPayloadDestroy(discPayload);
     discPayload = NULL;
 }
+
+TEST_F(RDDatabaseTests, PublishAndDiscoverManyLinks)
+{
+    itst::DeadmanTimer killSwitch(std::chrono::minutes(5));
+
+    const size_t deviceCount = 100;
+    const size_t linkCount = 100;
+    const size_t discoveryCount = 5;
+
+    char uris[linkCount][MAX_URI_LENGTH];
+    Resource resources[linkCount];
+    for (size_t i = 0; i < linkCount; ++i)
+    {
+        snprintf(uris[i], sizeof(uris[i]), "/a/resource%" PRIuPTR, i);
+        resources[i].uri = uris[i];
+        resources[i].rt = (i % 2) ? "core.light" : "core.fan";
+        resources[i].itf = (i % 4) ? OC_RSRVD_INTERFACE_DEFAULT : OC_RSRVD_INTERFACE_ACTUATOR;
+        resources[i].bm = OC_DISCOVERABLE;
+    }
+
+    char deviceIds[deviceCount][UUID_STRING_SIZE];
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < deviceCount; ++i)
+    {
+        snprintf(deviceIds[i], sizeof(deviceIds[i]), "7a960f46-a52e-4837-bd83-%012" PRIxPTR, i);
+        OCRepPayload *repPayload = CreateRDPublishPayload(deviceIds[i], 0, resources, linkCount);
+        ASSERT_TRUE(NULL != repPayload) << "CreateRDPublishPayload failed!";
+        EXPECT_EQ(OC_STACK_OK, OCRDDatabaseInit());
+        EXPECT_EQ(OC_STACK_OK, OCRDDatabaseStoreResources(repPayload));
+        OCPayloadDestroy((OCPayload *)repPayload);
+    }
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+                       std::chrono::steady_clock::now() - start);
+    printf("Publishing %" PRIuPTR " links: %lld ms\n", deviceCount * linkCount,
+           (long long) elapsed.count());
+
+    struct
+    {
+        const char *itf;
+        const char *rt;
+        size_t expectedLinks;
+    } queries[] =
+    {
+        { OC_RSRVD_INTERFACE_LL, NULL, linkCount },
+        { NULL, "core.light", linkCount / 2 },
+        { OC_RSRVD_INTERFACE_ACTUATOR, NULL, linkCount / 4 },
+        { OC_RSRVD_INTERFACE_ACTUATOR, "core.fan", linkCount / 4 },
+    };
+    for (size_t q = 0; q < sizeof(queries) / sizeof(queries[0]); ++q)
+    {
+        start = std::chrono::steady_clock::now();
+        for (size_t n = 0; n < discoveryCount; ++n)
+        {
+            OCDiscoveryPayload *discPayload = NULL;
+            EXPECT_EQ(OC_STACK_OK, OCRDDatabaseDiscoveryPayloadCreate(queries[q].itf, queries[q].rt,
+                                                                      &discPayload));
+            size_t devices = 0;
+            for (OCDiscoveryPayload *payload = discPayload; payload; payload = payload->next)
+            {
+                size_t links = 0;
+                for (OCResourcePayload *resource = payload->resources; resource;
+                     resource = resource->next)
+                {
+                    ++links;
+                }
+                EXPECT_EQ(queries[q].expectedLinks, links);
+                ++devices;
+            }
+            EXPECT_EQ(deviceCount, devices);
+            OCDiscoveryPayloadDestroy(discPayload);
+        }
+        elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+                      std::chrono::steady_clock::now() - start);
+        printf("Discovering if=%s rt=%s over %" PRIuPTR " links: %lld ms per query\n",
+               queries[q].itf ? queries[q].itf : "", queries[q].rt ? queries[q].rt : "",
+               deviceCount * linkCount, (long long) elapsed.count() / (long long) discoveryCount);
+    }
+}
@@ -78,6 +78,54 @@ const OicSecAce_t* GetACLResourceDataByRoles(const OicSecRole_t *roles, size_t r
  */
 const OicSecAce_t* GetACLResourceDataByConntype(const OicSecConntype_t conntype, OicSecAce_t **savePtr);
 
+/**
+ * ACEs of one subject that can match one resource, in ACL order.
+ */
+typedef struct OicSecAceMatches
+{
+    const OicSecAce_t **aces;   /**< ACEs listing the resource href or a resource wildcard. */
+    size_t count;               /**< Number of ACEs in aces. */
+} OicSecAceMatches_t;
+
+/**
+ * This method is used by PolicyEngine to retrieve the ACEs of a subject that can match
+ * a resource. The ACEs are looked up in an index of the ACL by subject and resource href,
+ * which is kept up to date as the ACL changes.
+ *
+ * @param[in] subjectId ID of the subject for which ACEs are required.
+ * @param[in] resourceUri URI of the requested resource.
+ *
+ * @return ACEs of the subject that list @p resourceUri or a resource wildcard, or NULL if
+ *         the ACL has no ACE for the subject. The result is valid until the ACL changes.
+ */
+const OicSecAceMatches_t* GetACLIndexedAces(const OicUuid_t *subjectId, const char *resourceUri);
+
+/**
+ * This method is used by PolicyEngine to retrieve the ACEs of a role that can match
+ * a resource.
+ *
+ * @param[in] role Role for which ACEs are required.
+ * @param[in] resourceUri URI of the requested resource.
+ *
+ * @return ACEs of the role that list @p resourceUri or a resource wildcard, or NULL if
+ *         the ACL has no ACE for the role. The result is valid until the ACL changes.
+ */
+const OicSecAceMatches_t* GetACLIndexedAcesByRole(const OicSecRole_t *role,
+                                                  const char *resourceUri);
+
+/**
+ * This method is used by PolicyEngine to retrieve the ACEs of a conntype that can match
+ * a resource.
+ *
+ * @param[in] conntype Conntype for which ACEs are required.
+ * @param[in] resourceUri URI of the requested resource.
+ *
+ * @return ACEs of the conntype that list @p resourceUri or a resource wildcard, or NULL if
+ *         the ACL has no ACE for the conntype. The result is valid until the ACL changes.
+ */
+const OicSecAceMatches_t* GetACLIndexedAcesByConntype(const OicSecConntype_t conntype,
+                                                      const char *resourceUri);
+
 /**
  * This function converts ACL data into CBOR format.
  *
@@ -54,6 +54,29 @@ OCStackResult GetDos(OicSecDostype_t *dos);
  */
 OCStackResult SetDosState(const OicSecDeviceOnboardingState_t state);
 
+/**
+ * Hold the SVR updates made during an ownership transfer in one persistent storage
+ * transaction, which is committed when the device leaves RFOTM. The transaction of a
+ * transfer that does not complete is committed by ExpireOwnershipTransferTransaction().
+ *
+ * @return  ::OC_STACK_OK if the updates are held.
+ */
+OCStackResult BeginOwnershipTransferTransaction(void);
+
+/**
+ * Commit the transaction of the ownership transfer, if one is open. SetDosState() calls
+ * this when the device tries to leave RFOTM, whether the ownership transfer succeeded or not.
+ *
+ * @return  ::OC_STACK_OK if no transaction was open, or its updates were written.
+ */
+OCStackResult EndOwnershipTransferTransaction(void);
+
+/**
+ * Commit the transaction of an ownership transfer that has not completed in time, as
+ * when the onboarding tool gave up on it. Called periodically by OCProcess().
+ */
+void ExpireOwnershipTransferTransaction(void);
+
 #ifdef __cplusplus
 }
 #endif
@@ -21,6 +21,10 @@
 #ifndef IOTVT_SRM_PSI_H
 #define IOTVT_SRM_PSI_H
 
+#ifdef __cplusplus
+extern "C" {
+#endif
+
 /**
  * Reads the database from PS
  *
@@ -103,4 +107,71 @@ OCStackResult ResetSecureResourceInPS(void);
  */
 OCStackResult CreateResetProfile(void);
 
+/**
+ * This method selects how the databases are kept in PS.
+ *
+ * By default each update of a resource rewrites the whole database file. With the journal
+ * enabled, each update appends the resource to a journal next to the database file, named
+ * after it with a ".jnl" suffix, and the journal is periodically compacted into the database
+ * file. An existing database file is read as the initial state of the journal. Disabling
+ * the journal folds the existing journals back into their database files.
+ *
+ * @note The journal requires a persistent storage handler that opens each name as its own
+ *       file, and supports the "ab" mode.
+ *
+ * @param enable  true to keep the databases with a journal, false to rewrite them.
+ *
+ * @return ::OC_STACK_OK for Success, otherwise some error value
+ */
+OCStackResult SetPSJournalEnabled(bool enable);
+
+/**
+ * This method starts a transaction, which holds the updates of resources in PS until it is
+ * committed. Each database is then written once, with the latest update of each resource.
+ * Reads of a resource return its held update.
+ *
+ * Transactions nest: the updates are written when the outermost one is committed. They are
+ * also written after at most a few seconds by FlushPSTransaction(), so that a transaction
+ * left open, e.g. by an ownership transfer that did not complete, has a bounded window of
+ * updates that a power loss can drop.
+ *
+ * @return ::OC_STACK_OK for Success, otherwise some error value
+ */
+OCStackResult BeginPSTransaction(void);
+
+/**
+ * This method ends a transaction started by BeginPSTransaction(), and writes the held
+ * updates when it is the outermost one.
+ *
+ * @return ::OC_STACK_OK for Success, otherwise some error value
+ */
+OCStackResult CommitPSTransaction(void);
+
+/**
+ * This method writes the updates held by open transactions, which stay open.
+ *
+ * @param force  true to write the updates now, false to write them only once they have
+ *               been held for longer than the transaction window.
+ *
+ * @return ::OC_STACK_OK for Success, otherwise some error value
+ */
+OCStackResult FlushPSTransaction(bool force);
+
+/**
+ * This method closes the transactions left open and drops the updates they still hold,
+ * e.g. after FlushPSTransaction() failed to write them, so that the next initialization
+ * starts without a transaction.
+ */
+void DeInitPSTransaction(void);
+
+/**
+ * This method releases the cached state of the journaled databases. Their resources stay
+ * in PS and are reloaded on next use.
+ */
+void DeInitPSJournal(void);
+
+#ifdef __cplusplus
+}
+#endif
+
 #endif //IOTVT_SRM_PSI_H
@@ -21,6 +21,7 @@
 #ifndef SECURITYRESOURCEMANAGER_H_
 #define SECURITYRESOURCEMANAGER_H_
 
+#include <time.h>
 #include "experimental/securevirtualresourcetypes.h"
 #include "cainterface.h"
 
@@ -58,6 +59,9 @@ typedef struct SRMRequestContext
                                                                 // iff IdType is UUID_TYPE).
     // Developer note: when adding support for an additional type (e.g.
     // ROLE_TYPE) suggest adding a new var to hold the Subject ID for that type.
+    time_t                  aclDecisionValidUntil;              // When an ACE validity period
+                                                                // may change the ACL decision
+                                                                // (0 if never).
 #ifdef MULTIPLE_OWNER
     uint8_t*                payload;
     size_t                  payloadSize;
@@ -115,6 +119,44 @@ void SRMDeInitSecureResources();
 typedef bool (*SPResponseCallback) (const CAEndpoint_t *object,
                                     const CAResponseInfo_t *responseInfo);
 
+/**
+ * Look up the ACL decision made for an earlier request with the same subject,
+ * secure channel, resource URI, discoverability, requested permission and, if
+ * the decision depended on them, roles.
+ *
+ * @param[in,out] context Request to look up. context->responseVal is set on success.
+ *
+ * @return true if a cached decision was found, else false.
+ */
+bool SRMGetCachedAccessDecision(SRMRequestContext_t *context);
+
+/**
+ * Cache the ACL decision made for a request.
+ *
+ * @param[in] context Request with the decision in context->responseVal.
+ * @param[in] rolesChecked Whether the ACEs of the roles of the requester were checked.
+ * @param[in] roles Roles of the requester, if rolesChecked.
+ * @param[in] roleCount Length of roles array.
+ */
+void SRMCacheAccessDecision(const SRMRequestContext_t *context, bool rolesChecked,
+                            const OicSecRole_t *roles, size_t roleCount);
+
+/**
+ * Drop all cached ACL decisions. Called when the ACL, credentials or roles change.
+ */
+void SRMInvalidateAccessDecisionCache();
+
+/**
+ * Get the number of cached ACL decisions used and the number of requests for which
+ * no cached decision was found.
+ *
+ * @param[out] hits Number of requests answered from the cache.
+ * @param[out] misses Number of requests that went through ACL evaluation.
+ *
+ * @return ::OC_STACK_OK, or ::OC_STACK_INVALID_PARAM if a parameter is NULL.
+ */
+OCStackResult SRMGetAccessDecisionCacheStats(uint32_t *hits, uint32_t *misses);
+
 /**
  * Check the security resource URI.
  * @param uri Pointers to security resource URI.
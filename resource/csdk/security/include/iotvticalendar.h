@@ -160,6 +160,25 @@ struct IotvtICalRecur
  */
 IotvtICalResult_t IsRequestWithinValidTime(const char *period, const char *recur);
 
+/**
+ * This API is used by policy engine to find out how long the result of
+ * IsRequestWithinValidTime() for a period holds.
+ *
+ * The result can only change on a day boundary, or when the time of day reaches
+ * the start time or passes the end time of the period. Recurrence rules only
+ * select days, so they don't add other boundaries.
+ *
+ * @param period string representing period.
+ * @param nextChange is set to the first time after the current time at which
+ *                   the result of IsRequestWithinValidTime() may change.
+ *
+ * @return ::IOTVTICAL_SUCCESS, if @p nextChange was set.
+ * ::IOTVTICAL_INVALID_PARAMETER, if parameter are invalid
+ * ::IOTVTICAL_INVALID_PERIOD, if period string has invalid format
+ * ::IOTVTICAL_ERROR, if the local time can't be computed.
+ */
+IotvtICalResult_t GetNextValidTimeChange(const char *period, time_t *nextChange);
+
 /**
  * Parses periodStr and populate struct IotvtICalPeriod_t.
  *
@@ -48,6 +48,7 @@
 #include "secureresourcemanager.h"
 #include "deviceonboardingstate.h"
 #include "octhread.h"
+#include "uthash.h"
 
 #include "security_internals.h"
 
@@ -205,6 +206,368 @@ static void DeleteAceIdList(AceIdList_t** list)
     }
 }
 
+/**
+ * ACEs kept in ACL order. The policy engine is handed the embedded matches.
+ */
+typedef struct AclIndexAceList
+{
+    OicSecAceMatches_t matches;
+    size_t capacity;
+} AclIndexAceList_t;
+
+/**
+ * ACEs of one subject that list one resource href, merged with the subject's wildcard ACEs.
+ */
+typedef struct AclIndexHref
+{
+    char *href;
+    AclIndexAceList_t aces;
+    UT_hash_handle hh;
+} AclIndexHref_t;
+
+/**
+ * Subject of an ACE. Zero filled so that it can be hashed as raw bytes.
+ */
+typedef struct AclIndexSubjectKey
+{
+    OicSecAceSubjectType type;
+    union
+    {
+        OicUuid_t uuid;
+        OicSecRole_t role;
+        OicSecConntype_t conntype;
+    } id;
+} AclIndexSubjectKey_t;
+
+typedef struct AclIndexSubject
+{
+    AclIndexSubjectKey_t key;
+    size_t aceCount;                    // number of ACEs of the subject
+    AclIndexAceList_t wildcardAces;     // ACEs with a resource wildcard
+    AclIndexHref_t *hrefs;              // ACEs by resource href
+    UT_hash_handle hh;
+} AclIndexSubject_t;
+
+// Index of gAcl by subject and resource href, used by the policy engine.
+static AclIndexSubject_t *gAclIndex = NULL;
+// Whether gAclIndex has to be rebuilt from gAcl before it is used.
+static bool gAclIndexStale = true;
+
+static bool InsertAceInList(AclIndexAceList_t *list, const OicSecAce_t *ace, bool prepend)
+{
+    OicSecAceMatches_t *matches = &list->matches;
+
+    // An ACE listing the same href twice is only kept once.
+    if (0 < matches->count && ace == matches->aces[prepend ? 0 : matches->count - 1])
+    {
+        return true;
+    }
+
+    if (matches->count == list->capacity)
+    {
+        size_t capacity = (0 < list->capacity) ? 2 * list->capacity : 4;
+        const OicSecAce_t **aces = (const OicSecAce_t **)OICRealloc((void *)matches->aces,
+                                                                      capacity * sizeof(*aces));
+        if (NULL == aces)
+        {
+            return false;
+        }
+        matches->aces = aces;
+        list->capacity = capacity;
+    }
+
+    if (prepend)
+    {
+        memmove(&matches->aces[1], &matches->aces[0], matches->count * sizeof(*matches->aces));
+        matches->aces[0] = ace;
+    }
+    else
+    {
+        matches->aces[matches->count] = ace;
+    }
+    matches->count++;
+    return true;
+}
+
+static void RemoveAceFromList(AclIndexAceList_t *list, const OicSecAce_t *ace)
+{
+    OicSecAceMatches_t *matches = &list->matches;
+
+    for (size_t i = 0; i < matches->count; i++)
+    {
+        if (ace == matches->aces[i])
+        {
+            matches->count--;
+            memmove(&matches->aces[i], &matches->aces[i + 1],
+                    (matches->count - i) * sizeof(*matches->aces));
+            return;
+        }
+    }
+}
+
+static bool GetAclIndexSubjectKey(const OicSecAce_t *ace, AclIndexSubjectKey_t *key)
+{
+    memset(key, 0, sizeof(*key));
+    key->type = ace->subjectType;
+
+    switch (ace->subjectType)
+    {
+        case OicSecAceUuidSubject:
+            memcpy(&key->id.uuid, &ace->subjectuuid, sizeof(key->id.uuid));
+            return true;
+        case OicSecAceRoleSubject:
+            OICStrcpy(key->id.role.id, sizeof(key->id.role.id), ace->subjectRole.id);
+            OICStrcpy(key->id.role.authority, sizeof(key->id.role.authority),
+                      ace->subjectRole.authority);
+            return true;
+        case OicSecAceConntypeSubject:
+            key->id.conntype = ace->subjectConn;
+            return true;
+        default:
+            return false;
+    }
+}
+
+static bool IsWildcardRsrc(const OicSecRsrc_t *rsrc)
+{
+    if (NULL == rsrc->href)
+    {
+        return (NO_WILDCARD != rsrc->wildcard);
+    }
+    return (0 == strcmp(WILDCARD_RESOURCE_URI, rsrc->href));
+}
+
+static void FreeAclIndexHref(AclIndexHref_t *href)
+{
+    OICFree(href->href);
+    OICFree((void *)href->aces.matches.aces);
+    OICFree(href);
+}
+
+static void FreeAclIndexSubject(AclIndexSubject_t *subject)
+{
+    AclIndexHref_t *href = NULL;
+    AclIndexHref_t *tmpHref = NULL;
+    HASH_ITER(hh, subject->hrefs, href, tmpHref)
+    {
+        HASH_DEL(subject->hrefs, href);
+        FreeAclIndexHref(href);
+    }
+    OICFree((void *)subject->wildcardAces.matches.aces);
+    OICFree(subject);
+}
+
+static void FreeAclIndex(void)
+{
+    AclIndexSubject_t *subject = NULL;
+    AclIndexSubject_t *tmpSubject = NULL;
+    HASH_ITER(hh, gAclIndex, subject, tmpSubject)
+    {
+        HASH_DEL(gAclIndex, subject);
+        FreeAclIndexSubject(subject);
+    }
+}
+
+/**
+ * Add an ACE to the ACL index at the position it has in gAcl, which is either the head
+ * (@p prepend) or the tail of the list.
+ *
+ * @return false on allocation failure, which leaves the index incomplete.
+ */
+static bool AddAceToAclIndex(const OicSecAce_t *ace, bool prepend)
+{
+    AclIndexSubjectKey_t key;
+    if (!GetAclIndexSubjectKey(ace, &key))
+    {
+        // No request matches an unknown subject type.
+        return true;
+    }
+
+    AclIndexSubject_t *subject = NULL;
+    HASH_FIND(hh, gAclIndex, &key, sizeof(key), subject);
+    if (NULL == subject)
+    {
+        subject = (AclIndexSubject_t *)OICCalloc(1, sizeof(AclIndexSubject_t));
+        if (NULL == subject)
+        {
+            return false;
+        }
+        subject->key = key;
+        HASH_ADD(hh, gAclIndex, key, sizeof(subject->key), subject);
+    }
+    subject->aceCount++;
+
+    OicSecRsrc_t *rsrc = NULL;
+    bool hasWildcard = false;
+    LL_FOREACH(ace->resources, rsrc)
+    {
+        hasWildcard = hasWildcard || IsWildcardRsrc(rsrc);
+    }
+
+    // A wildcard ACE can match every resource, so it goes in every href list of the subject.
+    if (hasWildcard)
+    {
+        if (!InsertAceInList(&subject->wildcardAces, ace, prepend))
+        {
+            return false;
+        }
+        AclIndexHref_t *href = NULL;
+        AclIndexHref_t *tmpHref = NULL;
+        HASH_ITER(hh, subject->hrefs, href, tmpHref)
+        {
+            if (!InsertAceInList(&href->aces, ace, prepend))
+            {
+                return false;
+            }
+        }
+    }
+
+    LL_FOREACH(ace->resources, rsrc)
+    {
+        if ((NULL == rsrc->href) || IsWildcardRsrc(rsrc))
+        {
+            continue;
+        }
+
+        AclIndexHref_t *href = NULL;
+        HASH_FIND_STR(subject->hrefs, rsrc->href, href);
+        if (NULL == href)
+        {
+            href = (AclIndexHref_t *)OICCalloc(1, sizeof(AclIndexHref_t));
+            if (NULL == href)
+            {
+                return false;
+            }
+            href->href = OICStrdup(rsrc->href);
+            if (NULL == href->href)
+            {
+                OICFree(href);
+                return false;
+            }
+            for (size_t i = 0; i < subject->wildcardAces.matches.count; i++)
+            {
+                if (!InsertAceInList(&href->aces, subject->wildcardAces.matches.aces[i], false))
+                {
+                    FreeAclIndexHref(href);
+                    return false;
+                }
+            }
+            HASH_ADD_KEYPTR(hh, subject->hrefs, href->href, strlen(href->href), href);
+        }
+        if (!InsertAceInList(&href->aces, ace, prepend))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void RemoveAceFromAclIndex(const OicSecAce_t *ace)
+{
+    AclIndexSubjectKey_t key;
+    if (!GetAclIndexSubjectKey(ace, &key))
+    {
+        return;
+    }
+
+    AclIndexSubject_t *subject = NULL;
+    HASH_FIND(hh, gAclIndex, &key, sizeof(key), subject);
+    if (NULL == subject)
+    {
+        return;
+    }
+
+    if (0 == --subject->aceCount)
+    {
+        HASH_DEL(gAclIndex, subject);
+        FreeAclIndexSubject(subject);
+        return;
+    }
+
+    RemoveAceFromList(&subject->wildcardAces, ace);
+    AclIndexHref_t *href = NULL;
+    AclIndexHref_t *tmpHref = NULL;
+    HASH_ITER(hh, subject->hrefs, href, tmpHref)
+    {
+        RemoveAceFromList(&href->aces, ace);
+        if (0 == href->aces.matches.count)
+        {
+            HASH_DEL(subject->hrefs, href);
+            FreeAclIndexHref(href);
+        }
+    }
+}
+
+/**
+ * Drop the ACL index after a change it can't follow; it is rebuilt on next use.
+ */
+static void InvalidateAclIndex(void)
+{
+    FreeAclIndex();
+    gAclIndexStale = true;
+    SRMInvalidateAccessDecisionCache();
+}
+
+/**
+ * Update the ACL index after @p ace was added to the head (@p prepend) or tail of gAcl.
+ */
+static void IndexAce(const OicSecAce_t *ace, bool prepend)
+{
+    SRMInvalidateAccessDecisionCache();
+    if (!gAclIndexStale && !AddAceToAclIndex(ace, prepend))
+    {
+        OIC_LOG(WARNING, TAG, "Failed to index ACE, the ACL index will be rebuilt");
+        InvalidateAclIndex();
+    }
+}
+
+/**
+ * Update the ACL index before @p ace is removed from gAcl.
+ */
+static void UnindexAce(const OicSecAce_t *ace)
+{
+    SRMInvalidateAccessDecisionCache();
+    if (!gAclIndexStale)
+    {
+        RemoveAceFromAclIndex(ace);
+    }
+}
+
+static const OicSecAceMatches_t* GetIndexedAces(const AclIndexSubjectKey_t *key,
+                                                const char *resourceUri)
+{
+    if ((NULL == gAcl) || (NULL == resourceUri))
+    {
+        return NULL;
+    }
+
+    if (gAclIndexStale)
+    {
+        OicSecAce_t *ace = NULL;
+        LL_FOREACH(gAcl->aces, ace)
+        {
+            if (!AddAceToAclIndex(ace, false))
+            {
+                OIC_LOG(ERROR, TAG, "Failed to build the ACL index");
+                FreeAclIndex();
+                return NULL;
+            }
+        }
+        gAclIndexStale = false;
+    }
+
+    AclIndexSubject_t *subject = NULL;
+    HASH_FIND(hh, gAclIndex, key, sizeof(*key), subject);
+    if (NULL == subject)
+    {
+        return NULL;
+    }
+
+    AclIndexHref_t *href = NULL;
+    HASH_FIND_STR(subject->hrefs, resourceUri, href);
+    return (NULL != href) ? &href->aces.matches : &subject->wildcardAces.matches;
+}
+
 static OicSecAce_t* DuplicateACE(const OicSecAce_t* ace, bool createNewAceID)
 {
     OicSecAce_t* newAce = NULL;
@@ -2184,6 +2547,7 @@ OCStackResult RemoveACE(const OicUuid_t *subject, const char *resource)
         {
             if (memcmp(ace->subjectuuid.id, subject->id, sizeof(subject->id)) == 0)
             {
+                UnindexAce(ace);
                 LL_DELETE(gAcl->aces, ace);
                 FreeACE(ace);
                 deleteFlag = true;
@@ -2221,6 +2585,12 @@ OCStackResult RemoveACE(const OicUuid_t *subject, const char *resource)
                 }
             }
         }
+
+        // Resources were removed from ACEs in place.
+        if (deleteFlag)
+        {
+            InvalidateAclIndex();
+        }
     }
 
     if (deleteFlag)
@@ -2276,6 +2646,7 @@ static OCStackResult RemoveAceByAceIds(AceIdList_t *aceIdList)
         {
             if (ace->aceid == aceIdElem->aceid)
             {
+                UnindexAce(ace);
                 LL_DELETE(gAcl->aces, ace);
                 FreeACE(ace);
 
@@ -2714,6 +3085,7 @@ static OCStackResult RemoveAllAce(const char *resource)
 
             if (removeFlag)
             {
+                UnindexAce(aceItem);
                 LL_DELETE(gAcl->aces, aceItem);
                 FreeACE(aceItem);
             }
@@ -2744,6 +3116,7 @@ static OCStackResult RemoveAllAce(const char *resource)
                 {
                     DeleteACLList(gAcl);
                     gAcl = originAcl;
+                    InvalidateAclIndex();
                 }
                 else
                 {
@@ -2882,6 +3255,7 @@ static OCEntityHandlerResult HandleACLPostRequest(const OCEntityHandlerRequest *
     size_t size = ((OCSecurityPayload *) ehRequest->payload)->payloadSize;
 
     OicSecDostype_t dos;
+    BeginPSTransaction();
     VERIFY_SUCCESS(TAG, OC_STACK_OK == GetDos(&dos), ERROR);
     ehRet = OC_EH_OK;
 
@@ -2943,6 +3317,7 @@ static OCEntityHandlerResult HandleACLPostRequest(const OCEntityHandlerRequest *
                         OIC_LOG(DEBUG, TAG, "Prepending new ACE:");
                         OIC_LOG_ACE(DEBUG, insertAce);
                         LL_PREPEND(gAcl->aces, insertAce);
+                        IndexAce(insertAce, true);
                     }
                     else
                     {
@@ -2974,6 +3349,12 @@ static OCEntityHandlerResult HandleACLPostRequest(const OCEntityHandlerRequest *
     }
 
 exit:
+    // Write the SVRs changed by the request before answering it
+    if (OC_STACK_OK != CommitPSTransaction())
+    {
+        OIC_LOG(ERROR, TAG, "Failed to write the SVRs changed by the request");
+        ehRet = OC_EH_ERROR;
+    }
 
     //Send response to request originator
     ehRet = ((SendSRMResponse(ehRequest, ehRet, NULL, 0)) == OC_STACK_OK) ?
@@ -2993,6 +3374,7 @@ static OCEntityHandlerResult HandleACL2PostRequest(const OCEntityHandlerRequest
     size_t size = ((OCSecurityPayload *) ehRequest->payload)->payloadSize;
 
     OicSecDostype_t dos;
+    BeginPSTransaction();
     VERIFY_SUCCESS(TAG, OC_STACK_OK == GetDos(&dos), ERROR);
     ehRet = OC_EH_OK;
 
@@ -3048,6 +3430,7 @@ static OCEntityHandlerResult HandleACL2PostRequest(const OCEntityHandlerRequest
                             OIC_LOG(DEBUG, TAG, "Remove old ACE");
 
                             //remove old ace with the same aceid
+                            UnindexAce(existAce);
                             LL_DELETE(gAcl->aces, existAce);
                             FreeACE(existAce);
                             break;
@@ -3064,6 +3447,7 @@ static OCEntityHandlerResult HandleACL2PostRequest(const OCEntityHandlerRequest
                     OIC_LOG(DEBUG, TAG, "Prepending new ACE:");
                     OIC_LOG_ACE(DEBUG, insertAce);
                     LL_PREPEND(gAcl->aces, insertAce);
+                    IndexAce(insertAce, true);
                 }
                 else
                 {
@@ -3094,6 +3478,12 @@ static OCEntityHandlerResult HandleACL2PostRequest(const OCEntityHandlerRequest
     }
 
 exit:
+    // Write the SVRs changed by the request before answering it
+    if (OC_STACK_OK != CommitPSTransaction())
+    {
+        OIC_LOG(ERROR, TAG, "Failed to write the SVRs changed by the request");
+        ehRet = OC_EH_ERROR;
+    }
 
     //Send response to request originator
     ehRet = ((SendSRMResponse(ehRequest, ehRet, NULL, 0)) == OC_STACK_OK) ?
@@ -3257,6 +3647,7 @@ static OCStackResult CreateACLResource()
 OCStackResult SetDefaultACL(OicSecAcl_t *acl)
 {
     gAcl = acl;
+    InvalidateAclIndex();
     return OC_STACK_OK;
 }
 
@@ -3477,6 +3868,7 @@ OCStackResult InitACLResource()
         // TODO Needs to update persistent storage
     }
     VERIFY_NOT_NULL(TAG, gAcl, FATAL);
+    InvalidateAclIndex();
 
     // Instantiate 'oic.sec.acl'
     ret = CreateACLResource();
@@ -3501,6 +3893,7 @@ OCStackResult DeInitACLResource()
         DeleteACLList(gAcl);
         gAcl = NULL;
     }
+    InvalidateAclIndex();
 
     oc_mutex_free(g_AceIdCounterMutex);
     g_AceIdCounterMutex = NULL;
@@ -3679,6 +4072,46 @@ const OicSecAce_t* GetACLResourceDataByConntype(const OicSecConntype_t conntype,
     return NULL;
 }
 
+const OicSecAceMatches_t* GetACLIndexedAces(const OicUuid_t *subjectId, const char *resourceUri)
+{
+    if (NULL == subjectId)
+    {
+        return NULL;
+    }
+
+    AclIndexSubjectKey_t key;
+    memset(&key, 0, sizeof(key));
+    key.type = OicSecAceUuidSubject;
+    memcpy(&key.id.uuid, subjectId, sizeof(key.id.uuid));
+    return GetIndexedAces(&key, resourceUri);
+}
+
+const OicSecAceMatches_t* GetACLIndexedAcesByRole(const OicSecRole_t *role,
+                                                  const char *resourceUri)
+{
+    if (NULL == role)
+    {
+        return NULL;
+    }
+
+    AclIndexSubjectKey_t key;
+    memset(&key, 0, sizeof(key));
+    key.type = OicSecAceRoleSubject;
+    OICStrcpy(key.id.role.id, sizeof(key.id.role.id), role->id);
+    OICStrcpy(key.id.role.authority, sizeof(key.id.role.authority), role->authority);
+    return GetIndexedAces(&key, resourceUri);
+}
+
+const OicSecAceMatches_t* GetACLIndexedAcesByConntype(const OicSecConntype_t conntype,
+                                                      const char *resourceUri)
+{
+    AclIndexSubjectKey_t key;
+    memset(&key, 0, sizeof(key));
+    key.type = OicSecAceConntypeSubject;
+    key.id.conntype = conntype;
+    return GetIndexedAces(&key, resourceUri);
+}
+
 OCStackResult AppendACLObject(const OicSecAcl_t* acl)
 {
     OCStackResult ret = OC_STACK_ERROR;
@@ -3703,6 +4136,10 @@ OCStackResult AppendACLObject(const OicSecAcl_t* acl)
     {
         gAcl->aces = acl->aces;
     }
+    LL_FOREACH(acl->aces, ace)
+    {
+        IndexAce(ace, false);
+    }
 
     OIC_LOG_ACL(INFO, gAcl);
 
@@ -3945,6 +4382,7 @@ OCStackResult UpdateDefaultSecProvACE()
                 //If default security resource ACL is detected, delete it.
                 if(NUMBER_OF_SEC_PROV_RSCS == matchedRsrc)
                 {
+                    UnindexAce(ace);
                     LL_DELETE(gAcl->aces, ace);
                     FreeACE(ace);
                     isRemoved = true;
@@ -3964,6 +4402,7 @@ OCStackResult UpdateDefaultSecProvACE()
             if (secDefaultAce)
             {
                 LL_APPEND(gAcl->aces, secDefaultAce);
+                IndexAce(secDefaultAce, false);
 
                 size_t size = 0;
                 uint8_t *payload = NULL;
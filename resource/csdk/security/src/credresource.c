@@ -1460,6 +1460,13 @@ static bool UpdatePersistentStorage(const OicSecCred_t *cred)
     bool ret = false;
     OIC_LOG(DEBUG, TAG, "IN Cred UpdatePersistentStorage");
 
+    // Credentials changed, so drop decisions made for their subjects.
+    SRMInvalidateAccessDecisionCache();
+#if defined(__WITH_DTLS__) || defined(__WITH_TLS__)
+    // Nor may sessions set up with the former credentials or trust anchors be resumed.
+    CAflushSslSessionCache();
+#endif
+
     // Convert Cred data into JSON for update to persistent storage
     if (cred)
     {
@@ -2349,6 +2356,7 @@ static OCEntityHandlerResult HandlePostRequest(OCEntityHandlerRequest* ehRequest
 
     OCStackResult res = OC_STACK_OK;
 
+    BeginPSTransaction();
     VERIFY_SUCCESS(TAG, OC_STACK_OK == GetDos(&dos), ERROR);
     if ((DOS_RESET == dos.state) ||
         (DOS_RFNOP == dos.state))
@@ -2412,6 +2420,13 @@ exit:
         }
     }
 
+    // Write the SVRs changed by the request before answering it
+    if (OC_STACK_OK != CommitPSTransaction())
+    {
+        OIC_LOG(ERROR, TAG, "Failed to write the SVRs changed by the request");
+        ret = OC_EH_ERROR;
+    }
+
     // Send response to request originator
     ret = ((SendSRMResponse(ehRequest, ret, NULL, 0)) == OC_STACK_OK) ?
                    OC_EH_OK : OC_EH_ERROR;
@@ -2684,6 +2699,7 @@ OCStackResult DeInitCredResource()
     OCStackResult result = OCDeleteResource(gCredHandle);
     DeleteCredList(gCred);
     gCred = NULL;
+    SRMInvalidateAccessDecisionCache();
     return result;
 }
 
@@ -31,6 +31,7 @@
 #include "oic_malloc.h"
 #include "oic_string.h"
 #include "crlresource.h"
+#include "casecurityinterface.h"
 #include "ocpayloadcbor.h"
 #include "mbedtls/base64.h"
 #include <time.h>
@@ -446,6 +447,9 @@ OCStackResult UpdateCRLResource(OicSecCrl_t *crl)
         return OC_STACK_ERROR;
     }
 
+    // Sessions set up before may rely on certificates revoked now.
+    CAflushSslSessionCache();
+
     char currentTime[32] = {0};
     getCurrentUTCTime(currentTime, sizeof(currentTime));
 
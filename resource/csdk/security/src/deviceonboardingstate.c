@@ -32,9 +32,17 @@
 #include "experimental/doxmresource.h"
 #include "pstatresource.h"
 #include "resourcemanager.h"
+#include "psinterface.h"
+#include "oic_time.h"
 
 #define TAG "OIC_SRM_DOS"
 
+/**
+ * Longest time an ownership transfer holds its persistent storage transaction open,
+ * in milliseconds. An ownership transfer that takes longer is considered failed.
+ */
+#define OWNERSHIP_TRANSFER_TIMEOUT_MS (60 * 1000)
+
 /**
  * @return true if changing from oldState to newState is valid transition.
  */
@@ -568,6 +576,55 @@ exit:
     return OC_STACK_ERROR;
 }
 
+/**
+ * True while the SVR updates of an ownership transfer are held in a transaction.
+ */
+static bool g_ownershipTransferTransaction = false;
+
+/**
+ * Time at which the current ownership transfer started, in milliseconds.
+ */
+static uint64_t g_ownershipTransferStartTime = 0;
+
+OCStackResult BeginOwnershipTransferTransaction(void)
+{
+    if (!g_ownershipTransferTransaction)
+    {
+        VERIFY_SUCCESS(TAG, OC_STACK_OK == BeginPSTransaction(), ERROR);
+        g_ownershipTransferTransaction = true;
+    }
+    // A new oxmsel restarts the ownership transfer
+    g_ownershipTransferStartTime = OICGetCurrentTime(TIME_IN_MS);
+    return OC_STACK_OK;
+
+exit:
+    return OC_STACK_ERROR;
+}
+
+OCStackResult EndOwnershipTransferTransaction(void)
+{
+    if (!g_ownershipTransferTransaction)
+    {
+        return OC_STACK_OK;
+    }
+    g_ownershipTransferTransaction = false;
+    return CommitPSTransaction();
+}
+
+void ExpireOwnershipTransferTransaction(void)
+{
+    if (g_ownershipTransferTransaction &&
+        (OICGetCurrentTime(TIME_IN_MS) - g_ownershipTransferStartTime >=
+         OWNERSHIP_TRANSFER_TIMEOUT_MS))
+    {
+        OIC_LOG(WARNING, TAG, "Ownership transfer timed out; writing its SVR updates");
+        if (OC_STACK_OK != EndOwnershipTransferTransaction())
+        {
+            OIC_LOG(ERROR, TAG, "Failed to write the SVR updates of the ownership transfer");
+        }
+    }
+}
+
 OCStackResult SetDosState(const OicSecDeviceOnboardingState_t desiredState)
 {
     OIC_LOG_V(INFO, TAG, "%s called for state %d.", __func__, desiredState);
@@ -586,6 +643,8 @@ OCStackResult SetDosState(const OicSecDeviceOnboardingState_t desiredState)
         VERIFY_SUCCESS(TAG, OC_STACK_OK == GetPstatDosS(&oldState), ERROR);
         if (IsValidStateTransition(oldState, desiredState))
         {
+            // Write the SVRs changed by the state change together
+            VERIFY_SUCCESS(TAG, OC_STACK_OK == BeginPSTransaction(), ERROR);
             OCStackResult stateChangeResult = DoStateChange(desiredState);
             switch (stateChangeResult)
             {
@@ -609,6 +668,20 @@ OCStackResult SetDosState(const OicSecDeviceOnboardingState_t desiredState)
                 ret = OC_STACK_INTERNAL_SERVER_ERROR;
                 break;
             }
+            if (DOS_RFOTM == oldState)
+            {
+                // The ownership transfer is over, whether or not it left RFOTM
+                if ((OC_STACK_OK != EndOwnershipTransferTransaction()) && (OC_STACK_OK == ret))
+                {
+                    ret = OC_STACK_INTERNAL_SERVER_ERROR;
+                }
+            }
+            if ((OC_STACK_OK != CommitPSTransaction()) && (OC_STACK_OK == ret))
+            {
+                OIC_LOG_V(ERROR, TAG, "%s: failed to write the SVRs changed by the DOS state"
+                    " change from %d to %d.", __func__, oldState, desiredState);
+                ret = OC_STACK_INTERNAL_SERVER_ERROR;
+            }
         }
         else
         {
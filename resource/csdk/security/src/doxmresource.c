@@ -1568,6 +1568,7 @@ static OCEntityHandlerResult HandleDoxmPostRequest(OCEntityHandlerRequest *ehReq
     bool oxmselParsed = false;
     OicSecDostype_t dos;
 
+    BeginPSTransaction();
     VERIFY_NOT_NULL(TAG, ehRequest, ERROR);
     VERIFY_NOT_NULL(TAG, ehRequest->payload, ERROR);
     VERIFY_NOT_NULL(TAG, gDoxm, ERROR);
@@ -1624,6 +1625,8 @@ static OCEntityHandlerResult HandleDoxmPostRequest(OCEntityHandlerRequest *ehReq
         OIC_LOG_V(INFO, TAG, "%s: Device in RFOTM, and oxmsel Updated... starting OTM!", __func__);
         ehRet = StartOwnershipTransfer(newDoxm, ehRequest);
         VERIFY_SUCCESS(TAG, OC_EH_OK == ehRet, ERROR);
+        // Write the SVRs changed by the ownership transfer together, once it completes
+        OC_VERIFY(OC_STACK_OK == BeginOwnershipTransferTransaction());
     }
 
 #if defined(__WITH_DTLS__) || defined (__WITH_TLS__)
@@ -1636,6 +1639,12 @@ static OCEntityHandlerResult HandleDoxmPostRequest(OCEntityHandlerRequest *ehReq
     ehRet = HandleDoxmPostRequestUpdatePS(fACE);
 
 exit:
+    // Write the SVRs changed by the request before answering it
+    if (OC_STACK_OK != CommitPSTransaction())
+    {
+        OIC_LOG(ERROR, TAG, "Failed to write the SVRs changed by the request");
+        ehRet = OC_EH_ERROR;
+    }
 
     //Send payload to request originator
     ehRet = ((SendSRMResponse(ehRequest, ehRet, NULL, 0)) == OC_STACK_OK) ?
@@ -450,4 +450,83 @@ IotvtICalResult_t IsRequestWithinValidTime(const char *periodStr, const char *re
     }
     return ret;
 }
+
+/**
+ * Computes the first time after @param rawTime at which the time of day is @param secs
+ * seconds past midnight.
+ *
+ * @param today local date-time of rawTime.
+ *
+ * @return the time, or (time_t)-1 if it can't be represented.
+ */
+static time_t NextTimeOfDay(const IotvtICalDateTime_t *today, int secs, time_t rawTime)
+{
+    IotvtICalDateTime_t dateTime = *today;
+    dateTime.tm_hour = 0;
+    dateTime.tm_min = 0;
+    dateTime.tm_sec = secs;     //normalized by mktime
+    dateTime.tm_isdst = -1;
+    time_t nextTime = mktime(&dateTime);
+
+    if (((time_t)-1 != nextTime) && (nextTime <= rawTime))
+    {
+        dateTime = *today;
+        dateTime.tm_mday += 1;
+        dateTime.tm_hour = 0;
+        dateTime.tm_min = 0;
+        dateTime.tm_sec = secs;
+        dateTime.tm_isdst = -1;
+        nextTime = mktime(&dateTime);
+    }
+    return nextTime;
+}
+
+IotvtICalResult_t GetNextValidTimeChange(const char *periodStr, time_t *nextChange)
+{
+    if ((NULL == periodStr) || (NULL == nextChange))
+    {
+        return IOTVTICAL_INVALID_PARAMETER;
+    }
+
+    IotvtICalPeriod_t period = {.startDateTime={.tm_sec=0}};
+    IotvtICalResult_t ret = ParsePeriod(periodStr, &period);
+    if (ret != IOTVTICAL_SUCCESS)
+    {
+        return ret;
+    }
+
+    time_t rawTime = time(0);
+    IotvtICalDateTime_t *currentTime = localtime(&rawTime);
+    if (NULL == currentTime)
+    {
+        return IOTVTICAL_ERROR;
+    }
+    IotvtICalDateTime_t today = *currentTime;
+
+    //Access is granted from the first second of startTime through the last second of endTime
+    int startSecs = 3600 * period.startDateTime.tm_hour + 60 * period.startDateTime.tm_min +
+                    period.startDateTime.tm_sec;
+    int endSecs = 3600 * period.endDateTime.tm_hour + 60 * period.endDateTime.tm_min +
+                  period.endDateTime.tm_sec + 1;
+    time_t changes[] =
+    {
+        NextTimeOfDay(&today, 0, rawTime),
+        NextTimeOfDay(&today, startSecs, rawTime),
+        NextTimeOfDay(&today, endSecs, rawTime)
+    };
+
+    *nextChange = changes[0];
+    for (size_t i = 0; i < sizeof(changes) / sizeof(changes[0]); i++)
+    {
+        if ((time_t)-1 == changes[i])
+        {
+            return IOTVTICAL_ERROR;
+        }
+        if (changes[i] < *nextChange)
+        {
+            *nextChange = changes[i];
+        }
+    }
+    return IOTVTICAL_SUCCESS;
+}
 #endif
@@ -541,15 +541,43 @@ INLINE_API bool IsWildCardSubject(OicUuid_t *subject)
     }
 }
 
+#ifndef WITH_ARDUINO
+/**
+ * Limit context->aclDecisionValidUntil to the next time at which 'period' may
+ * start or stop allowing access.
+ */
+static void LimitDecisionValidity(SRMRequestContext_t *context, const char *period)
+{
+    time_t nextChange = 0;
+    IotvtICalResult_t res = GetNextValidTimeChange(period, &nextChange);
+    if (IOTVTICAL_ERROR == res)
+    {
+        // Unknown; the decision expires right away.
+        nextChange = time(NULL);
+    }
+    else if (IOTVTICAL_SUCCESS != res)
+    {
+        // The period is invalid, so it never allows access.
+        return;
+    }
+
+    if ((0 == context->aclDecisionValidUntil) || (nextChange < context->aclDecisionValidUntil))
+    {
+        context->aclDecisionValidUntil = nextChange;
+    }
+}
+#endif
+
 /**
  * Check whether 'resource' is getting accessed within the valid time period.
  *
+ * @param context context->aclDecisionValidUntil is limited to the next time the result may change.
  * @param acl is the ACL to check.
  *
  * @return true if access is within valid time period or if the period or recurrence is not present.
  * false if period and recurrence present and the access is not within valid time period.
  */
-static bool IsAccessWithinValidTime(const OicSecAce_t *ace)
+static bool IsAccessWithinValidTime(SRMRequestContext_t *context, const OicSecAce_t *ace)
 {
 #ifndef WITH_ARDUINO //Period & Recurrence not supported on Arduino due
     //lack of absolute time
@@ -567,6 +595,7 @@ static bool IsAccessWithinValidTime(const OicSecAce_t *ace)
     OicSecValidity_t* validity =  NULL;
     LL_FOREACH(ace->validities, validity)
     {
+        LimitDecisionValidity(context, validity->period);
         for(size_t i = 0; i < validity->recurrenceLen; i++)
         {
             if (IOTVTICAL_VALID_ACCESS == IsRequestWithinValidTime(validity->period,
@@ -581,6 +610,7 @@ static bool IsAccessWithinValidTime(const OicSecAce_t *ace)
     return false;
 
 #else
+    OC_UNUSED(context);
     return true;
 #endif
 }
@@ -645,7 +675,7 @@ static void ProcessMatchingACE(SRMRequestContext_t *context, const OicSecAce_t *
 
         // Found the resource, so it's down to valid period & permission.
         context->responseVal = ACCESS_DENIED_INVALID_PERIOD;
-        if (IsAccessWithinValidTime(currentAce))
+        if (IsAccessWithinValidTime(context, currentAce))
         {
             context->responseVal = ACCESS_DENIED_INSUFFICIENT_PERMISSION;
             if (IsPermissionAllowingRequest(currentAce->permission,
@@ -657,6 +687,28 @@ static void ProcessMatchingACE(SRMRequestContext_t *context, const OicSecAce_t *
     }
 }
 
+/**
+ * Check the ACEs of one subject that can match the requested resource, in ACL order,
+ * until one of them grants access.
+ *
+ * @param matches ACEs of the subject, or NULL if the ACL has none for the subject, in
+ *                which case context->responseVal is left unchanged.
+ */
+static void ProcessMatchingACEs(SRMRequestContext_t *context, const OicSecAceMatches_t *matches)
+{
+    if (NULL == matches)
+    {
+        return;
+    }
+
+    // Subject was found, so err changes to Rsrc not found for now.
+    context->responseVal = ACCESS_DENIED_RESOURCE_NOT_FOUND;
+    for (size_t i = 0; (i < matches->count) && !IsAccessGranted(context->responseVal); i++)
+    {
+        ProcessMatchingACE(context, matches->aces[i]);
+    }
+}
+
 /**
  * Search for an ACE that matches the Resource URI, by conntype, subjectuuid, or roles.
  * For each matching ACE, check whether it grants permission.
@@ -672,8 +724,7 @@ static void ProcessAccessRequest(SRMRequestContext_t *context)
 
     OIC_LOG_V(DEBUG, TAG, "Entering %s(%s)", __func__, context->resourceUri);
 
-    const OicSecAce_t *currentAce = NULL;
-    OicSecAce_t *aceSavePtr = NULL;
+    const OicSecAceMatches_t *matches = NULL;
 
     // Start out assuming subject not found.
     context->responseVal = ACCESS_DENIED_SUBJECT_NOT_FOUND;
@@ -688,79 +739,76 @@ static void ProcessAccessRequest(SRMRequestContext_t *context)
     {
         conntype = ANON_CLEAR;
     }
-    do
+    matches = GetACLIndexedAcesByConntype(conntype, context->resourceUri);
+    if (NULL != matches)
     {
-        currentAce = GetACLResourceDataByConntype(conntype, &aceSavePtr);
+        OIC_LOG_V(DEBUG, TAG, "%s: found %u conntype %s ACEs for resource %s.", __func__,
+            (unsigned int)matches->count, (AUTH_CRYPT == conntype?"auth-crypt":"anon-clear"),
+            context->resourceUri);
+        ProcessMatchingACEs(context, matches);
+    }
+    else
+    {
+        OIC_LOG_V(INFO, TAG, "%s:no ACL found matching conntype %s for resource %s",
+            __func__, (AUTH_CRYPT == conntype?"auth-crypt":"anon-clear"), context->resourceUri);
+    }
 
-        if (NULL != currentAce)
+    // If not granted via conntype, try Subject-based match.
+    if (!IsAccessGranted(context->responseVal))
+    {
+        matches = GetACLIndexedAces(&context->subjectUuid, context->resourceUri);
+        if (NULL != matches)
         {
-            OIC_LOG_V(DEBUG, TAG, "%s: found conntype %s match; processing for access.",
-                __func__, (AUTH_CRYPT == conntype?"auth-crypt":"anon-clear"));
-            ProcessMatchingACE(context, currentAce);
+            ProcessMatchingACEs(context, matches);
         }
         else
         {
-            OIC_LOG_V(INFO, TAG, "%s:no ACL found matching conntype %s for resource %s",
-                __func__, (AUTH_CRYPT == conntype?"auth-crypt":"anon-clear"), context->resourceUri);
+            OIC_LOG_V(INFO, TAG, "%s:no ACL found matching subject for resource %s",
+                __func__, context->resourceUri);
         }
-    } while ((NULL != currentAce) && !IsAccessGranted(context->responseVal));
-
-    // If not granted via conntype, try Subject-based match.
-    if (!IsAccessGranted(context->responseVal))
-    {
-        currentAce = NULL;
-        aceSavePtr = NULL;
-        do
-        {
-            currentAce = GetACLResourceData(&context->subjectUuid, &aceSavePtr);
-
-            if (NULL != currentAce)
-            {
-                ProcessMatchingACE(context, currentAce);
-            }
-            else
-            {
-                OIC_LOG_V(INFO, TAG, "%s:no ACL found matching subject for resource %s",
-                    __func__, context->resourceUri);
-            }
-        } while ((NULL != currentAce) && !IsAccessGranted(context->responseVal));
     }
 
+    bool cacheable = true;
+    bool rolesChecked = false;
+    OicSecRole_t *roles = NULL;
+    size_t roleCount = 0;
 #if defined(__WITH_DTLS__) || defined(__WITH_TLS__)
     // If no subject ACE granted access, try role ACEs.
     if (!IsAccessGranted(context->responseVal))
     {
-        currentAce = NULL;
-        aceSavePtr = NULL;
-        OicSecRole_t *roles = NULL;
-        size_t roleCount = 0;
         OCStackResult res = GetEndpointRoles(context->endPoint, &roles, &roleCount);
         if (OC_STACK_OK != res)
         {
             OIC_LOG_V(ERROR, TAG, "Error getting asserted roles for endpoint: %d", res);
+            // Without the roles the decision can't be cached.
+            cacheable = false;
         }
         else
         {
             OIC_LOG_V(DEBUG, TAG, "Found %u asserted roles for endpoint", (unsigned int) roleCount);
-            do
+            rolesChecked = true;
+            for (size_t i = 0; (i < roleCount) && !IsAccessGranted(context->responseVal); i++)
             {
-                currentAce = GetACLResourceDataByRoles(roles, roleCount, &aceSavePtr);
-                if (NULL != currentAce)
+                matches = GetACLIndexedAcesByRole(&roles[i], context->resourceUri);
+                if (NULL != matches)
                 {
-                    ProcessMatchingACE(context, currentAce);
+                    ProcessMatchingACEs(context, matches);
                 }
                 else
                 {
-                    OIC_LOG_V(INFO, TAG, "%s:no ACL found matching roles for resource %s",
-                        __func__, context->resourceUri);
+                    OIC_LOG_V(INFO, TAG, "%s:no ACL found matching role %s for resource %s",
+                        __func__, roles[i].id, context->resourceUri);
                 }
-            } while ((NULL != currentAce) && !IsAccessGranted(context->responseVal));
-
-            OICFree(roles);
+            }
         }
     }
 #endif /* defined(__WITH_DTLS__) || defined(__WITH_TLS__) */
 
+    if (cacheable)
+    {
+        SRMCacheAccessDecision(context, rolesChecked, roles, roleCount);
+    }
+    OICFree(roles);
     OIC_LOG_V(INFO, TAG, "%s: returning with responseVal = %s", __func__,
         IsAccessGranted(context->responseVal) ? "ACCESS_GRANTED" : "ACCESS_DENIED");
     return;
@@ -833,8 +881,9 @@ void CheckPermission(SRMRequestContext_t *context)
         OIC_LOG_V(INFO, TAG, "%s: granting CMS implicit access to /pstat.", __func__);
         context->responseVal = ACCESS_GRANTED;
     }
-    // Else request is a "normal" request that must be tested against ACL.
-    else
+    // Else request is a "normal" request that must be tested against ACL,
+    // unless the same request was tested since the ACL last changed.
+    else if (!SRMGetCachedAccessDecision(context))
     {
         ProcessAccessRequest(context);
     }
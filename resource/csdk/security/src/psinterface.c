@@ -40,6 +40,9 @@
 #include "pstatresource.h"
 #include "experimental/doxmresource.h"
 #include "ocresourcehandler.h"
+#include "psinterface.h"
+#include "utlist.h"
+#include "oic_time.h"
 
 #define TAG  "OIC_SRM_PSI"
 
@@ -142,6 +145,1140 @@ static size_t GetDatabaseSize(const OCPersistentStorage *ps, const char *databas
     return size;
 }
 
+/**
+ * Suffix appended to a database name to form the name of its journal.
+ */
+#define PS_JOURNAL_SUFFIX ".jnl"
+
+/**
+ * Marker that starts the journal, and every run of records appended after a torn write.
+ */
+static const uint8_t PS_JOURNAL_MAGIC[] = { 'O', 'C', 'J', 0x01 };
+
+/**
+ * Size of a journal record header: type, name length and payload length.
+ */
+#define PS_JOURNAL_RECORD_HEADER_SIZE (1 + 2 + 4)
+
+/**
+ * Size of the checksum that ends a journal record.
+ */
+#define PS_JOURNAL_RECORD_CHECKSUM_SIZE 4
+
+/**
+ * The journal is compacted into the database once it is larger than
+ * PS_JOURNAL_COMPACTION_SIZE and PS_JOURNAL_COMPACTION_RATIO times the size of the
+ * resources it holds.
+ */
+#define PS_JOURNAL_COMPACTION_SIZE (64 * 1024)
+#define PS_JOURNAL_COMPACTION_RATIO 4
+
+/**
+ * Overhead of one resource in the CBOR map of a database.
+ */
+#define PS_CBOR_ENTRY_ADDITION 18
+
+typedef enum
+{
+    PS_JOURNAL_PUT = 'P',               /**< Sets a resource. */
+    PS_JOURNAL_DELETE = 'D',            /**< Removes a resource. */
+    PS_JOURNAL_SNAPSHOT_BEGIN = 'B',    /**< Starts the complete set of resources. */
+    PS_JOURNAL_SNAPSHOT_END = 'E',      /**< Replaces all resources by the records since 'B'. */
+    PS_JOURNAL_BATCH_BEGIN = 'T',       /**< Starts the updates of a transaction. */
+    PS_JOURNAL_BATCH_END = 'C'          /**< Applies the records since 'T'. */
+} PSJournalRecordType;
+
+/**
+ * One resource of a journaled database, or one update held by a transaction.
+ */
+typedef struct PSRecord
+{
+    char *name;                 /**< Resource name. */
+    uint8_t *payload;           /**< CBOR payload of the resource, NULL for an update that
+                                     removes it. */
+    size_t size;                /**< Size of payload. */
+    struct PSRecord *next;
+} PSRecord_t;
+
+/**
+ * State of a journaled database.
+ *
+ * The database file keeps the CBOR map written at the last compaction. Every update of a
+ * resource is appended to the journal as one checksummed record, so it costs the size of
+ * that resource only. A compaction first appends a snapshot of all the resources to the
+ * journal, then rewrites the database file and removes the journal. A crash at any point
+ * leaves either the previous or the new state: the journal is replayed over the database
+ * file, a complete snapshot replaces it, and a torn record at the end is ignored.
+ */
+typedef struct PSJournal
+{
+    char *databaseName;             /**< Name of the database file. */
+    char *journalName;              /**< Name of the journal file. */
+    const OCPersistentStorage *ps;  /**< Handler the state was loaded with. */
+    PSRecord_t *records;            /**< Current resources of the database. */
+    size_t journalSize;             /**< Size of the journal file. */
+    bool resync;                    /**< Journal ends with a torn record. */
+    struct PSJournal *next;
+} PSJournal_t;
+
+static bool gPSJournalEnabled = false;
+static PSJournal_t *gPSJournals = NULL;
+
+static void FreeRecords(PSRecord_t *records)
+{
+    PSRecord_t *record = NULL;
+    PSRecord_t *tmp = NULL;
+    LL_FOREACH_SAFE(records, record, tmp)
+    {
+        LL_DELETE(records, record);
+        OICFree(record->name);
+        OICFree(record->payload);
+        OICFree(record);
+    }
+}
+
+static PSRecord_t *FindRecord(PSRecord_t *records, const char *name, size_t nameLen)
+{
+    PSRecord_t *record = NULL;
+    LL_FOREACH(records, record)
+    {
+        if ((strlen(record->name) == nameLen) && (0 == memcmp(record->name, name, nameLen)))
+        {
+            break;
+        }
+    }
+    return record;
+}
+
+/**
+ * Sets the payload of a resource, adding the resource if needed.
+ */
+static bool SetRecord(PSRecord_t **records, const char *name, size_t nameLen,
+                      const uint8_t *payload, size_t size)
+{
+    uint8_t *copy = NULL;
+    if (payload && size)
+    {
+        copy = (uint8_t *)OICMalloc(size);
+        if (!copy)
+        {
+            return false;
+        }
+        memcpy(copy, payload, size);
+    }
+
+    PSRecord_t *record = FindRecord(*records, name, nameLen);
+    if (!record)
+    {
+        record = (PSRecord_t *)OICCalloc(1, sizeof(PSRecord_t));
+        char *recordName = (char *)OICMalloc(nameLen + 1);
+        if (!record || !recordName)
+        {
+            OICFree(record);
+            OICFree(recordName);
+            OICFree(copy);
+            return false;
+        }
+        memcpy(recordName, name, nameLen);
+        recordName[nameLen] = '\0';
+        record->name = recordName;
+        LL_APPEND(*records, record);
+    }
+    OICFree(record->payload);
+    record->payload = copy;
+    record->size = copy ? size : 0;
+    return true;
+}
+
+static void RemoveRecord(PSRecord_t **records, const char *name, size_t nameLen)
+{
+    PSRecord_t *record = FindRecord(*records, name, nameLen);
+    if (record)
+    {
+        LL_DELETE(*records, record);
+        OICFree(record->name);
+        OICFree(record->payload);
+        OICFree(record);
+    }
+}
+
+/**
+ * Applies updates, whose NULL payloads remove resources, to a list of records.
+ */
+static bool ApplyRecordUpdates(PSRecord_t **records, const PSRecord_t *updates)
+{
+    for (const PSRecord_t *update = updates; update; update = update->next)
+    {
+        size_t nameLen = strlen(update->name);
+        if (!update->payload)
+        {
+            RemoveRecord(records, update->name, nameLen);
+        }
+        else if (!SetRecord(records, update->name, nameLen, update->payload, update->size))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Copies the payload of a record for a caller of ReadDatabaseFromPS.
+ */
+static OCStackResult CopyRecordPayload(const PSRecord_t *record, uint8_t **data, size_t *size)
+{
+    if (!record || !record->payload)
+    {
+        return OC_STACK_ERROR;
+    }
+    *data = (uint8_t *)OICMalloc(record->size);
+    if (!*data)
+    {
+        return OC_STACK_NO_MEMORY;
+    }
+    memcpy(*data, record->payload, record->size);
+    *size = record->size;
+    return OC_STACK_OK;
+}
+
+static size_t GetRecordsSize(const PSRecord_t *records)
+{
+    size_t size = 0;
+    for (const PSRecord_t *record = records; record; record = record->next)
+    {
+        size += strlen(record->name) + record->size;
+    }
+    return size;
+}
+
+/**
+ * Reads a whole file from persistent storage. A missing file reads as empty.
+ */
+static OCStackResult ReadFileFromPS(const OCPersistentStorage *ps, const char *name,
+                                    uint8_t **data, size_t *size)
+{
+    *data = NULL;
+    *size = 0;
+
+    size_t fileSize = GetDatabaseSize(ps, name);
+    if (0 == fileSize)
+    {
+        return OC_STACK_OK;
+    }
+
+    uint8_t *fsData = (uint8_t *)OICMalloc(fileSize);
+    if (!fsData)
+    {
+        return OC_STACK_NO_MEMORY;
+    }
+    FILE *fp = ps->open(name, "rb");
+    if (!fp)
+    {
+        OICFree(fsData);
+        return OC_STACK_ERROR;
+    }
+    size_t bytesRead = ps->read(fsData, 1, fileSize, fp);
+    ps->close(fp);
+    if (bytesRead != fileSize)
+    {
+        OICFree(fsData);
+        return OC_STACK_ERROR;
+    }
+
+    *data = fsData;
+    *size = fileSize;
+    return OC_STACK_OK;
+}
+
+/**
+ * Adds the resources of a database file to a list of records. The resources that can be
+ * decoded are kept if the file is truncated.
+ */
+static OCStackResult ParseDatabaseRecords(const uint8_t *data, size_t size, PSRecord_t **records)
+{
+    CborParser parser;  // will be initialized in |cbor_parser_init|
+    CborValue cbor;     // will be initialized in |cbor_parser_init|
+    CborValue map;      // will be initialized in |cbor_value_enter_container|
+    char *name = NULL;
+    uint8_t *payload = NULL;
+    size_t nameLen = 0;
+    size_t payloadLen = 0;
+    OCStackResult ret = OC_STACK_OK;
+
+    CborError cborFindResult = cbor_parser_init(data, size, 0, &parser, &cbor);
+    if ((CborNoError != cborFindResult) || !cbor_value_is_map(&cbor) ||
+        (CborNoError != cbor_value_enter_container(&cbor, &map)))
+    {
+        OIC_LOG(WARNING, TAG, "Database is not a CBOR map");
+        return OC_STACK_OK;
+    }
+
+    while (cbor_value_is_valid(&map) && cbor_value_is_text_string(&map))
+    {
+        cborFindResult = cbor_value_dup_text_string(&map, &name, &nameLen, &map);
+        if ((CborNoError != cborFindResult) || !cbor_value_is_valid(&map))
+        {
+            break;
+        }
+        if (cbor_value_is_byte_string(&map))
+        {
+            cborFindResult = cbor_value_dup_byte_string(&map, &payload, &payloadLen, &map);
+            if (CborNoError != cborFindResult)
+            {
+                break;
+            }
+            if (!SetRecord(records, name, nameLen, payload, payloadLen))
+            {
+                ret = OC_STACK_NO_MEMORY;
+                break;
+            }
+            OICFree(payload);
+            payload = NULL;
+        }
+        else if (CborNoError != cbor_value_advance(&map))
+        {
+            break;
+        }
+        OICFree(name);
+        name = NULL;
+    }
+
+    OICFree(name);
+    OICFree(payload);
+    return ret;
+}
+
+/**
+ * Encodes a list of records as the CBOR map of a database file.
+ */
+static OCStackResult EncodeDatabaseRecords(const PSRecord_t *records, uint8_t **data, size_t *size)
+{
+    size_t allocSize = CBOR_ENCODING_SIZE_ADDITION;
+    for (const PSRecord_t *record = records; record; record = record->next)
+    {
+        allocSize += strlen(record->name) + record->size + PS_CBOR_ENTRY_ADDITION;
+    }
+
+    OCStackResult ret = OC_STACK_ERROR;
+    int64_t cborEncoderResult = CborNoError;
+    uint8_t *outPayload = (uint8_t *)OICCalloc(1, allocSize);
+    VERIFY_NOT_NULL(TAG, outPayload, ERROR);
+
+    CborEncoder encoder;  // will be initialized in |cbor_parser_init|
+    cbor_encoder_init(&encoder, outPayload, allocSize, 0);
+    CborEncoder resource;  // will be initialized in |cbor_encoder_create_map|
+    cborEncoderResult |= cbor_encoder_create_map(&encoder, &resource, CborIndefiniteLength);
+    VERIFY_CBOR_SUCCESS_OR_OUT_OF_MEMORY(TAG, cborEncoderResult, "Failed Adding PS Map.");
+
+    for (const PSRecord_t *record = records; record; record = record->next)
+    {
+        cborEncoderResult |= cbor_encode_text_string(&resource, record->name, strlen(record->name));
+        VERIFY_CBOR_SUCCESS_OR_OUT_OF_MEMORY(TAG, cborEncoderResult, "Failed Adding Value Tag");
+        cborEncoderResult |= cbor_encode_byte_string(&resource, record->payload, record->size);
+        VERIFY_CBOR_SUCCESS_OR_OUT_OF_MEMORY(TAG, cborEncoderResult, "Failed Adding Value.");
+    }
+
+    cborEncoderResult |= cbor_encoder_close_container(&encoder, &resource);
+    VERIFY_CBOR_SUCCESS_OR_OUT_OF_MEMORY(TAG, cborEncoderResult, "Failed Closing Map.");
+
+    *size = cbor_encoder_get_buffer_size(&encoder, outPayload);
+    *data = outPayload;
+    outPayload = NULL;
+    ret = OC_STACK_OK;
+
+exit:
+    OICFree(outPayload);
+    return ret;
+}
+
+/**
+ * FNV-1a hash used to detect torn and corrupted journal records.
+ */
+static uint32_t GetJournalChecksum(const uint8_t *data, size_t size)
+{
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < size; i++)
+    {
+        hash ^= data[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+static size_t GetJournalRecordSize(size_t nameLen, size_t payloadSize)
+{
+    return PS_JOURNAL_RECORD_HEADER_SIZE + nameLen + payloadSize + PS_JOURNAL_RECORD_CHECKSUM_SIZE;
+}
+
+static void PutUint32(uint8_t *out, uint32_t value)
+{
+    out[0] = (uint8_t)(value & 0xFF);
+    out[1] = (uint8_t)((value >> 8) & 0xFF);
+    out[2] = (uint8_t)((value >> 16) & 0xFF);
+    out[3] = (uint8_t)((value >> 24) & 0xFF);
+}
+
+static uint32_t GetUint32(const uint8_t *in)
+{
+    return (uint32_t)in[0] | ((uint32_t)in[1] << 8) | ((uint32_t)in[2] << 16) |
+           ((uint32_t)in[3] << 24);
+}
+
+/**
+ * Encodes one journal record into out, which must hold GetJournalRecordSize() bytes.
+ *
+ * @return number of bytes written to out.
+ */
+static size_t PutJournalRecord(uint8_t *out, PSJournalRecordType type, const char *name,
+                               const uint8_t *payload, size_t payloadSize)
+{
+    size_t nameLen = name ? strlen(name) : 0;
+    size_t pos = 0;
+
+    out[pos++] = (uint8_t)type;
+    out[pos++] = (uint8_t)(nameLen & 0xFF);
+    out[pos++] = (uint8_t)((nameLen >> 8) & 0xFF);
+    PutUint32(out + pos, (uint32_t)payloadSize);
+    pos += 4;
+    if (nameLen)
+    {
+        memcpy(out + pos, name, nameLen);
+        pos += nameLen;
+    }
+    if (payloadSize)
+    {
+        memcpy(out + pos, payload, payloadSize);
+        pos += payloadSize;
+    }
+    PutUint32(out + pos, GetJournalChecksum(out, pos));
+    return pos + PS_JOURNAL_RECORD_CHECKSUM_SIZE;
+}
+
+/**
+ * Decodes the journal record at the start of data.
+ *
+ * @return size of the record, or 0 if data does not start with a complete and valid record.
+ */
+static size_t GetJournalRecord(const uint8_t *data, size_t size, PSJournalRecordType *type,
+                               const char **name, size_t *nameLen,
+                               const uint8_t **payload, size_t *payloadSize)
+{
+    if (size < GetJournalRecordSize(0, 0))
+    {
+        return 0;
+    }
+    size_t recordNameLen = (size_t)data[1] | ((size_t)data[2] << 8);
+    size_t recordPayloadSize = GetUint32(data + 3);
+    if ((size - GetJournalRecordSize(0, 0) < recordNameLen) ||
+        (size - GetJournalRecordSize(0, 0) - recordNameLen < recordPayloadSize))
+    {
+        return 0;
+    }
+    size_t checksumPos = PS_JOURNAL_RECORD_HEADER_SIZE + recordNameLen + recordPayloadSize;
+    if (GetJournalChecksum(data, checksumPos) != GetUint32(data + checksumPos))
+    {
+        return 0;
+    }
+
+    *type = (PSJournalRecordType)data[0];
+    *name = (const char *)(data + PS_JOURNAL_RECORD_HEADER_SIZE);
+    *nameLen = recordNameLen;
+    *payload = data + PS_JOURNAL_RECORD_HEADER_SIZE + recordNameLen;
+    *payloadSize = recordPayloadSize;
+    return checksumPos + PS_JOURNAL_RECORD_CHECKSUM_SIZE;
+}
+
+/**
+ * Replays a journal over the records read from the database file.
+ *
+ * Records are read from each journal marker up to the first invalid record, which is left
+ * by a torn write. The records of a snapshot or of a transaction are only applied once its
+ * end is read.
+ *
+ * @return true if the journal ends with a valid record, false if it ends with a torn one.
+ */
+static bool ReplayJournal(const uint8_t *data, size_t size, PSRecord_t **records)
+{
+    PSRecord_t *snapshot = NULL;
+    PSRecord_t *batch = NULL;
+    bool inSnapshot = false;
+    bool inBatch = false;
+    bool inRun = false;
+    size_t pos = 0;
+
+    while (pos < size)
+    {
+        if (!inRun)
+        {
+            // Look for the next run of records.
+            while ((pos + sizeof(PS_JOURNAL_MAGIC) <= size) &&
+                   memcmp(data + pos, PS_JOURNAL_MAGIC, sizeof(PS_JOURNAL_MAGIC)))
+            {
+                pos++;
+            }
+            if (pos + sizeof(PS_JOURNAL_MAGIC) > size)
+            {
+                break;
+            }
+            pos += sizeof(PS_JOURNAL_MAGIC);
+            inRun = true;
+            continue;
+        }
+
+        PSJournalRecordType type;
+        const char *name = NULL;
+        size_t nameLen = 0;
+        const uint8_t *payload = NULL;
+        size_t payloadSize = 0;
+        size_t recordSize = GetJournalRecord(data + pos, size - pos, &type, &name, &nameLen,
+                                             &payload, &payloadSize);
+        if (0 == recordSize)
+        {
+            OIC_LOG_V(WARNING, TAG, "Torn journal record at %" PRIuPTR, pos);
+            FreeRecords(snapshot);
+            snapshot = NULL;
+            FreeRecords(batch);
+            batch = NULL;
+            inSnapshot = false;
+            inBatch = false;
+            inRun = false;
+            continue;
+        }
+        pos += recordSize;
+
+        PSRecord_t **target = inSnapshot ? &snapshot : records;
+        switch (type)
+        {
+            case PS_JOURNAL_PUT:
+            case PS_JOURNAL_DELETE:
+                if (PS_JOURNAL_DELETE == type)
+                {
+                    payload = NULL;
+                    payloadSize = 0;
+                }
+                if (inBatch)
+                {
+                    // Held as an update, whose NULL payload removes the resource.
+                    if (!SetRecord(&batch, name, nameLen, payload, payloadSize))
+                    {
+                        OIC_LOG(ERROR, TAG, "Failed replaying journal record");
+                    }
+                }
+                else if (!payload)
+                {
+                    RemoveRecord(target, name, nameLen);
+                }
+                else if (!SetRecord(target, name, nameLen, payload, payloadSize))
+                {
+                    OIC_LOG(ERROR, TAG, "Failed replaying journal record");
+                }
+                break;
+            case PS_JOURNAL_BATCH_BEGIN:
+                FreeRecords(batch);
+                batch = NULL;
+                inBatch = true;
+                break;
+            case PS_JOURNAL_BATCH_END:
+                if (inBatch && !ApplyRecordUpdates(target, batch))
+                {
+                    OIC_LOG(ERROR, TAG, "Failed replaying journal transaction");
+                }
+                FreeRecords(batch);
+                batch = NULL;
+                inBatch = false;
+                break;
+            case PS_JOURNAL_SNAPSHOT_BEGIN:
+                FreeRecords(snapshot);
+                snapshot = NULL;
+                inSnapshot = true;
+                break;
+            case PS_JOURNAL_SNAPSHOT_END:
+                if (inSnapshot)
+                {
+                    FreeRecords(*records);
+                    *records = snapshot;
+                    snapshot = NULL;
+                    inSnapshot = false;
+                }
+                break;
+            default:
+                OIC_LOG_V(WARNING, TAG, "Unknown journal record type %d", (int)type);
+                break;
+        }
+    }
+
+    FreeRecords(snapshot);
+    FreeRecords(batch);
+    return (0 == size) || inRun;
+}
+
+static void FreeJournal(PSJournal_t *journal)
+{
+    if (journal)
+    {
+        FreeRecords(journal->records);
+        OICFree(journal->databaseName);
+        OICFree(journal->journalName);
+        OICFree(journal);
+    }
+}
+
+static void RemoveJournal(PSJournal_t *journal)
+{
+    LL_DELETE(gPSJournals, journal);
+    FreeJournal(journal);
+}
+
+/**
+ * Gets the state of a journaled database, loading it from persistent storage on first use.
+ */
+static PSJournal_t *GetJournal(const OCPersistentStorage *ps, const char *databaseName)
+{
+    PSJournal_t *journal = NULL;
+    LL_FOREACH(gPSJournals, journal)
+    {
+        if (0 == strcmp(journal->databaseName, databaseName))
+        {
+            break;
+        }
+    }
+    if (journal)
+    {
+        if (journal->ps == ps)
+        {
+            return journal;
+        }
+        RemoveJournal(journal);
+    }
+
+    uint8_t *data = NULL;
+    size_t size = 0;
+    size_t nameLen = strlen(databaseName);
+
+    journal = (PSJournal_t *)OICCalloc(1, sizeof(PSJournal_t));
+    VERIFY_NOT_NULL(TAG, journal, ERROR);
+    journal->ps = ps;
+    journal->databaseName = (char *)OICMalloc(nameLen + 1);
+    VERIFY_NOT_NULL(TAG, journal->databaseName, ERROR);
+    memcpy(journal->databaseName, databaseName, nameLen + 1);
+    journal->journalName = (char *)OICMalloc(nameLen + sizeof(PS_JOURNAL_SUFFIX));
+    VERIFY_NOT_NULL(TAG, journal->journalName, ERROR);
+    memcpy(journal->journalName, databaseName, nameLen);
+    memcpy(journal->journalName + nameLen, PS_JOURNAL_SUFFIX, sizeof(PS_JOURNAL_SUFFIX));
+
+    VERIFY_SUCCESS(TAG, OC_STACK_OK == ReadFileFromPS(ps, databaseName, &data, &size), ERROR);
+    VERIFY_SUCCESS(TAG, OC_STACK_OK == ParseDatabaseRecords(data, size, &journal->records), ERROR);
+    OICFree(data);
+    data = NULL;
+
+    VERIFY_SUCCESS(TAG, OC_STACK_OK == ReadFileFromPS(ps, journal->journalName, &data, &size), ERROR);
+    journal->resync = !ReplayJournal(data, size, &journal->records);
+    journal->journalSize = size;
+    OICFree(data);
+
+    OIC_LOG_V(DEBUG, TAG, "Loaded %s with a journal of %" PRIuPTR " bytes",
+              databaseName, journal->journalSize);
+    LL_PREPEND(gPSJournals, journal);
+    return journal;
+
+exit:
+    OICFree(data);
+    FreeJournal(journal);
+    return NULL;
+}
+
+/**
+ * Appends records to the journal of a database.
+ */
+static OCStackResult AppendToJournal(const OCPersistentStorage *ps, PSJournal_t *journal,
+                                     const uint8_t *data, size_t size)
+{
+    FILE *fp = ps->open(journal->journalName, "ab");
+    if (!fp)
+    {
+        OIC_LOG_V(ERROR, TAG, "Failed opening %s", journal->journalName);
+        return OC_STACK_ERROR;
+    }
+
+    size_t written = 0;
+    size_t expected = size;
+    if ((0 == journal->journalSize) || journal->resync)
+    {
+        // Start a new run of records, which also skips a torn record left at the end.
+        expected += sizeof(PS_JOURNAL_MAGIC);
+        written += ps->write(PS_JOURNAL_MAGIC, 1, sizeof(PS_JOURNAL_MAGIC), fp);
+    }
+    written += ps->write(data, 1, size, fp);
+    ps->close(fp);
+
+    journal->journalSize += written;
+    if (written != expected)
+    {
+        OIC_LOG_V(ERROR, TAG, "Failed writing %" PRIuPTR " bytes in %s", size, journal->journalName);
+        journal->resync = true;
+        return OC_STACK_ERROR;
+    }
+    journal->resync = false;
+    return OC_STACK_OK;
+}
+
+/**
+ * Writes all the resources of a database to its database file and removes its journal.
+ */
+static OCStackResult CompactJournal(const OCPersistentStorage *ps, PSJournal_t *journal)
+{
+    OIC_LOG_V(DEBUG, TAG, "Compacting %s", journal->databaseName);
+
+    uint8_t *snapshot = NULL;
+    uint8_t *dbData = NULL;
+    size_t dbSize = 0;
+    size_t snapshotSize = 2 * GetJournalRecordSize(0, 0);
+    for (const PSRecord_t *record = journal->records; record; record = record->next)
+    {
+        snapshotSize += GetJournalRecordSize(strlen(record->name), record->size);
+    }
+
+    // The snapshot keeps the new state in the journal while the database file is rewritten.
+    OCStackResult ret = OC_STACK_NO_MEMORY;
+    snapshot = (uint8_t *)OICMalloc(snapshotSize);
+    VERIFY_NOT_NULL(TAG, snapshot, ERROR);
+    size_t pos = PutJournalRecord(snapshot, PS_JOURNAL_SNAPSHOT_BEGIN, NULL, NULL, 0);
+    for (const PSRecord_t *record = journal->records; record; record = record->next)
+    {
+        pos += PutJournalRecord(snapshot + pos, PS_JOURNAL_PUT, record->name,
+                                record->payload, record->size);
+    }
+    PutJournalRecord(snapshot + pos, PS_JOURNAL_SNAPSHOT_END, NULL, NULL, 0);
+
+    ret = AppendToJournal(ps, journal, snapshot, snapshotSize);
+    VERIFY_SUCCESS(TAG, OC_STACK_OK == ret, ERROR);
+
+    ret = EncodeDatabaseRecords(journal->records, &dbData, &dbSize);
+    VERIFY_SUCCESS(TAG, OC_STACK_OK == ret, ERROR);
+    ret = WritePayloadToPS(journal->databaseName, dbData, dbSize);
+    VERIFY_SUCCESS(TAG, OC_STACK_OK == ret, ERROR);
+
+    if (0 != ps->unlink(journal->journalName))
+    {
+        OIC_LOG_V(ERROR, TAG, "Failed removing %s", journal->journalName);
+        ret = OC_STACK_ERROR;
+        goto exit;
+    }
+    journal->journalSize = 0;
+    journal->resync = false;
+
+exit:
+    OICFree(snapshot);
+    OICFree(dbData);
+    return ret;
+}
+
+/**
+ * Reads a database, or one of its resources, through its journal.
+ */
+static OCStackResult ReadDatabaseFromJournal(const char *databaseName, const char *resourceName,
+                                             uint8_t **data, size_t *size)
+{
+    OCPersistentStorage *ps = OCGetPersistentStorageHandler();
+    if (!ps)
+    {
+        return OC_STACK_ERROR;
+    }
+    PSJournal_t *journal = GetJournal(ps, databaseName);
+    if (!journal)
+    {
+        return OC_STACK_ERROR;
+    }
+
+    if (!resourceName)
+    {
+        return journal->records ? EncodeDatabaseRecords(journal->records, data, size)
+                                : OC_STACK_ERROR;
+    }
+
+    return CopyRecordPayload(FindRecord(journal->records, resourceName, strlen(resourceName)),
+                             data, size);
+}
+
+/**
+ * Updates resources of a database by appending records to its journal. Several updates are
+ * appended as one transaction, which is replayed completely or not at all.
+ *
+ * @param databaseName  is the name of the database to access through persistent storage.
+ * @param updates       are the updates to make; a NULL payload removes the resource.
+ *
+ * @return ::OC_STACK_OK for Success, otherwise some error value
+ */
+static OCStackResult UpdateResourcesInJournal(const char *databaseName, const PSRecord_t *updates)
+{
+    bool isBatch = updates && updates->next;
+    size_t recordsSize = isBatch ? 2 * GetJournalRecordSize(0, 0) : 0;
+    for (const PSRecord_t *update = updates; update; update = update->next)
+    {
+        size_t nameLen = strlen(update->name);
+        if ((nameLen > UINT16_MAX) || ((uint64_t)update->size > UINT32_MAX))
+        {
+            return OC_STACK_INVALID_PARAM;
+        }
+        recordsSize += GetJournalRecordSize(nameLen, update->payload ? update->size : 0);
+    }
+
+    OCPersistentStorage *ps = OCGetPersistentStorageHandler();
+    if (!ps)
+    {
+        return OC_STACK_ERROR;
+    }
+    PSJournal_t *journal = GetJournal(ps, databaseName);
+    if (!journal)
+    {
+        return OC_STACK_ERROR;
+    }
+
+    uint8_t *records = (uint8_t *)OICMalloc(recordsSize);
+    if (!records)
+    {
+        return OC_STACK_NO_MEMORY;
+    }
+    size_t pos = 0;
+    if (isBatch)
+    {
+        pos += PutJournalRecord(records + pos, PS_JOURNAL_BATCH_BEGIN, NULL, NULL, 0);
+    }
+    for (const PSRecord_t *update = updates; update; update = update->next)
+    {
+        pos += PutJournalRecord(records + pos,
+                                update->payload ? PS_JOURNAL_PUT : PS_JOURNAL_DELETE,
+                                update->name, update->payload,
+                                update->payload ? update->size : 0);
+    }
+    if (isBatch)
+    {
+        PutJournalRecord(records + pos, PS_JOURNAL_BATCH_END, NULL, NULL, 0);
+    }
+    OCStackResult ret = AppendToJournal(ps, journal, records, recordsSize);
+    OICFree(records);
+    if (OC_STACK_OK != ret)
+    {
+        return ret;
+    }
+
+    if (!ApplyRecordUpdates(&journal->records, updates))
+    {
+        // The records are in the journal; reload the database on next use.
+        RemoveJournal(journal);
+        return OC_STACK_NO_MEMORY;
+    }
+
+    if ((journal->journalSize > PS_JOURNAL_COMPACTION_SIZE) &&
+        (journal->journalSize > PS_JOURNAL_COMPACTION_RATIO * GetRecordsSize(journal->records)))
+    {
+        if (OC_STACK_OK != CompactJournal(ps, journal))
+        {
+            // The updates themselves are already in the journal.
+            OIC_LOG_V(WARNING, TAG, "Failed compacting %s", databaseName);
+        }
+    }
+    return OC_STACK_OK;
+}
+
+/**
+ * Longest time a transaction holds updates before writing them, in milliseconds.
+ */
+#define PS_TRANSACTION_WINDOW_MS (5 * 1000)
+
+/**
+ * Updates of a database held by a transaction.
+ */
+typedef struct PSPendingDatabase
+{
+    char *databaseName;             /**< Name of the database file. */
+    PSRecord_t *updates;            /**< Latest update of each resource. */
+    struct PSPendingDatabase *next;
+} PSPendingDatabase_t;
+
+static size_t gPSTransactionDepth = 0;
+static uint64_t gPSTransactionHoldTime = 0;
+static PSPendingDatabase_t *gPSPendingDatabases = NULL;
+
+static PSPendingDatabase_t *FindPendingDatabase(const char *databaseName)
+{
+    PSPendingDatabase_t *pending = NULL;
+    LL_FOREACH(gPSPendingDatabases, pending)
+    {
+        if (0 == strcmp(pending->databaseName, databaseName))
+        {
+            break;
+        }
+    }
+    return pending;
+}
+
+static void RemovePendingDatabase(PSPendingDatabase_t *pending)
+{
+    LL_DELETE(gPSPendingDatabases, pending);
+    FreeRecords(pending->updates);
+    OICFree(pending->databaseName);
+    OICFree(pending);
+}
+
+/**
+ * Holds an update of a resource until the transaction writes it.
+ */
+static OCStackResult HoldResourceUpdate(const char *databaseName, const char *resourceName,
+                                        const uint8_t *payload, size_t size)
+{
+    PSPendingDatabase_t *pending = FindPendingDatabase(databaseName);
+    if (!pending)
+    {
+        size_t nameLen = strlen(databaseName);
+        pending = (PSPendingDatabase_t *)OICCalloc(1, sizeof(PSPendingDatabase_t));
+        VERIFY_NOT_NULL_RETURN(TAG, pending, ERROR, OC_STACK_NO_MEMORY);
+        pending->databaseName = (char *)OICMalloc(nameLen + 1);
+        if (!pending->databaseName)
+        {
+            OICFree(pending);
+            return OC_STACK_NO_MEMORY;
+        }
+        memcpy(pending->databaseName, databaseName, nameLen + 1);
+        if (!gPSPendingDatabases)
+        {
+            gPSTransactionHoldTime = OICGetCurrentTime(TIME_IN_MS);
+        }
+        LL_APPEND(gPSPendingDatabases, pending);
+    }
+
+    if (!SetRecord(&pending->updates, resourceName, strlen(resourceName),
+                   size ? payload : NULL, size))
+    {
+        return OC_STACK_NO_MEMORY;
+    }
+    OIC_LOG_V(DEBUG, TAG, "Holding the update of %s in %s", resourceName, databaseName);
+    return OC_STACK_OK;
+}
+
+/**
+ * Updates resources of a database file with one read and one write of the file.
+ *
+ * @param databaseName  is the name of the database to access through persistent storage.
+ * @param updates       are the updates to make; a NULL payload removes the resource.
+ *
+ * @return ::OC_STACK_OK for Success, otherwise some error value
+ */
+static OCStackResult UpdateResourcesInFile(const char *databaseName, const PSRecord_t *updates)
+{
+    OCPersistentStorage *ps = OCGetPersistentStorageHandler();
+    if (!ps)
+    {
+        return OC_STACK_ERROR;
+    }
+
+    PSRecord_t *records = NULL;
+    uint8_t *data = NULL;
+    size_t size = 0;
+    OCStackResult ret = ReadFileFromPS(ps, databaseName, &data, &size);
+    if (OC_STACK_OK == ret)
+    {
+        ret = ParseDatabaseRecords(data, size, &records);
+    }
+    OICFree(data);
+    data = NULL;
+    if ((OC_STACK_OK == ret) && !ApplyRecordUpdates(&records, updates))
+    {
+        ret = OC_STACK_NO_MEMORY;
+    }
+    if (OC_STACK_OK == ret)
+    {
+        ret = EncodeDatabaseRecords(records, &data, &size);
+    }
+    if (OC_STACK_OK == ret)
+    {
+        ret = WritePayloadToPS(databaseName, data, size);
+    }
+    OICFree(data);
+    FreeRecords(records);
+    return ret;
+}
+
+/**
+ * Writes the updates held for a database, and stops holding them once they are written.
+ * The updates stay held if the write fails, so that a later flush retries them.
+ */
+static OCStackResult WritePendingDatabase(PSPendingDatabase_t *pending)
+{
+    OIC_LOG_V(DEBUG, TAG, "Writing the held updates of %s", pending->databaseName);
+
+    OCStackResult ret = gPSJournalEnabled ?
+        UpdateResourcesInJournal(pending->databaseName, pending->updates) :
+        UpdateResourcesInFile(pending->databaseName, pending->updates);
+    if (OC_STACK_OK != ret)
+    {
+        OIC_LOG_V(ERROR, TAG, "Failed writing the held updates of %s", pending->databaseName);
+        return ret;
+    }
+    RemovePendingDatabase(pending);
+    return ret;
+}
+
+OCStackResult BeginPSTransaction(void)
+{
+    gPSTransactionDepth++;
+    return OC_STACK_OK;
+}
+
+OCStackResult CommitPSTransaction(void)
+{
+    if (0 == gPSTransactionDepth)
+    {
+        OIC_LOG(ERROR, TAG, "No persistent storage transaction to commit");
+        return OC_STACK_ERROR;
+    }
+    if (0 == --gPSTransactionDepth)
+    {
+        return FlushPSTransaction(true);
+    }
+    return OC_STACK_OK;
+}
+
+OCStackResult FlushPSTransaction(bool force)
+{
+    if (!gPSPendingDatabases)
+    {
+        return OC_STACK_OK;
+    }
+    if (!force &&
+        (OICGetCurrentTime(TIME_IN_MS) - gPSTransactionHoldTime < PS_TRANSACTION_WINDOW_MS))
+    {
+        return OC_STACK_OK;
+    }
+
+    OCStackResult ret = OC_STACK_OK;
+    PSPendingDatabase_t *pending = NULL;
+    PSPendingDatabase_t *tmp = NULL;
+    LL_FOREACH_SAFE(gPSPendingDatabases, pending, tmp)
+    {
+        if (OC_STACK_OK != WritePendingDatabase(pending))
+        {
+            ret = OC_STACK_ERROR;
+        }
+    }
+    if (gPSPendingDatabases)
+    {
+        // Retry the updates that failed after another window
+        gPSTransactionHoldTime = OICGetCurrentTime(TIME_IN_MS);
+    }
+    return ret;
+}
+
+void DeInitPSTransaction(void)
+{
+    if (gPSTransactionDepth > 0)
+    {
+        OIC_LOG_V(WARNING, TAG, "Closing %" PRIuPTR " persistent storage transactions",
+                  gPSTransactionDepth);
+    }
+    PSPendingDatabase_t *pending = NULL;
+    PSPendingDatabase_t *tmp = NULL;
+    LL_FOREACH_SAFE(gPSPendingDatabases, pending, tmp)
+    {
+        OIC_LOG_V(ERROR, TAG, "Dropping the held updates of %s", pending->databaseName);
+        RemovePendingDatabase(pending);
+    }
+    gPSTransactionDepth = 0;
+    gPSTransactionHoldTime = 0;
+}
+
+/**
+ * Replaces a whole database, including the updates held for it. The resources of a
+ * journaled database are replaced, and its journal is compacted.
+ *
+ * @param databaseName is the name of the database to access through persistent storage.
+ * @param payload      is the CBOR payload to write to the database in persistent storage.
+ * @param size         is the size of payload.
+ *
+ * @return ::OC_STACK_OK for Success, otherwise some error value
+ */
+static OCStackResult WriteDatabaseToPS(const char *databaseName, uint8_t *payload, size_t size)
+{
+    PSPendingDatabase_t *pending = databaseName ? FindPendingDatabase(databaseName) : NULL;
+    if (pending)
+    {
+        RemovePendingDatabase(pending);
+    }
+
+    if (!gPSJournalEnabled)
+    {
+        return WritePayloadToPS(databaseName, payload, size);
+    }
+    if (!databaseName || !payload || (size <= 0))
+    {
+        return OC_STACK_INVALID_PARAM;
+    }
+
+    OCPersistentStorage *ps = OCGetPersistentStorageHandler();
+    if (!ps)
+    {
+        return OC_STACK_ERROR;
+    }
+    PSJournal_t *journal = GetJournal(ps, databaseName);
+    if (!journal)
+    {
+        return OC_STACK_ERROR;
+    }
+
+    PSRecord_t *records = NULL;
+    OCStackResult ret = ParseDatabaseRecords(payload, size, &records);
+    if (OC_STACK_OK != ret)
+    {
+        FreeRecords(records);
+        return ret;
+    }
+    FreeRecords(journal->records);
+    journal->records = records;
+    return CompactJournal(ps, journal);
+}
+
+OCStackResult SetPSJournalEnabled(bool enable)
+{
+    OCStackResult ret = OC_STACK_OK;
+
+    if (!enable)
+    {
+        // Fold the journals back into the database files, which are all that is read
+        // once the journal is disabled.
+        OCPersistentStorage *ps = OCGetPersistentStorageHandler();
+        if (ps)
+        {
+            GetJournal(ps, SVR_DB_DAT_FILE_NAME);
+            GetJournal(ps, OC_DEVICE_PROPS_FILE_NAME);
+
+            PSJournal_t *journal = NULL;
+            LL_FOREACH(gPSJournals, journal)
+            {
+                if (((journal->ps == ps) && (journal->journalSize > 0)) &&
+                    (OC_STACK_OK != CompactJournal(ps, journal)))
+                {
+                    OIC_LOG_V(ERROR, TAG, "Failed folding the journal of %s", journal->databaseName);
+                    ret = OC_STACK_ERROR;
+                }
+            }
+        }
+    }
+
+    DeInitPSJournal();
+    gPSJournalEnabled = enable;
+    return ret;
+}
+
+void DeInitPSJournal(void)
+{
+    PSJournal_t *journal = NULL;
+    PSJournal_t *tmp = NULL;
+    LL_FOREACH_SAFE(gPSJournals, journal, tmp)
+    {
+        RemoveJournal(journal);
+    }
+}
+
 /**
  * Reads the database from PS
  * 
@@ -165,6 +1302,31 @@ OCStackResult ReadDatabaseFromPS(const char *databaseName, const char *resourceN
         return OC_STACK_INVALID_PARAM;
     }
 
+    PSPendingDatabase_t *pending = FindPendingDatabase(databaseName);
+    if (pending)
+    {
+        const PSRecord_t *update = resourceName ?
+            FindRecord(pending->updates, resourceName, strlen(resourceName)) : NULL;
+        if (update)
+        {
+            return CopyRecordPayload(update, data, size);
+        }
+        if (!resourceName)
+        {
+            // The whole database is read from PS, with its held updates written first.
+            OCStackResult ret = WritePendingDatabase(pending);
+            if (OC_STACK_OK != ret)
+            {
+                return ret;
+            }
+        }
+    }
+
+    if (gPSJournalEnabled)
+    {
+        return ReadDatabaseFromJournal(databaseName, resourceName, data, size);
+    }
+
     FILE *fp = NULL;
     uint8_t *fsData = NULL;
     size_t fileSize = 0;
@@ -239,6 +1401,25 @@ OCStackResult UpdateResourceInPS(const char *databaseName, const char *resourceN
         return OC_STACK_INVALID_PARAM;
     }
 
+    if (gPSTransactionDepth > 0)
+    {
+        return HoldResourceUpdate(databaseName, resourceName, payload, size);
+    }
+
+    PSPendingDatabase_t *pending = FindPendingDatabase(databaseName);
+    if (pending)
+    {
+        // Updates of a failed commit are still held; write this one after them.
+        OCStackResult ret = HoldResourceUpdate(databaseName, resourceName, payload, size);
+        return (OC_STACK_OK == ret) ? WritePendingDatabase(pending) : ret;
+    }
+
+    if (gPSJournalEnabled)
+    {
+        PSRecord_t update = { (char *)resourceName, (uint8_t *)(size ? payload : NULL), size, NULL };
+        return UpdateResourcesInJournal(databaseName, &update);
+    }
+
     size_t dbSize = 0;
     size_t outSize = 0;
     uint8_t *dbData = NULL;
@@ -652,7 +1833,7 @@ OCStackResult ResetSecureResourceInPS(void)
             outSize = cbor_encoder_get_buffer_size(&encoder, outPayload);
         }
 
-        ret = WritePayloadToPS(SVR_DB_DAT_FILE_NAME, outPayload, outSize);
+        ret = WriteDatabaseToPS(SVR_DB_DAT_FILE_NAME, outPayload, outSize);
         VERIFY_SUCCESS(TAG, (OC_STACK_OK == ret), ERROR);
     }
 
@@ -817,6 +817,7 @@ static OCEntityHandlerResult HandlePstatPostRequest(OCEntityHandlerRequest *ehRe
     OIC_LOG_V(DEBUG, TAG, "IN %s", __func__);
     OicSecPstat_t *pstat = NULL;
 
+    BeginPSTransaction();
     if (ehRequest->payload && NULL != gPstat)
     {
         uint8_t *payload = ((OCSecurityPayload *) ehRequest->payload)->securityData;
@@ -921,6 +922,12 @@ static OCEntityHandlerResult HandlePstatPostRequest(OCEntityHandlerRequest *ehRe
     }
 
 exit:
+    // Write the SVRs changed by the request before answering it
+    if (OC_STACK_OK != CommitPSTransaction())
+    {
+        OIC_LOG(ERROR, TAG, "Failed to write the SVRs changed by the request");
+        ehRet = OC_EH_ERROR;
+    }
 
     // Send response payload to request originator
     ehRet = ((SendSRMResponse(ehRequest, ehRet, NULL, 0)) == OC_STACK_OK) ?
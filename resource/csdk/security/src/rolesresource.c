@@ -222,6 +222,8 @@ OCStackResult RegisterSymmetricCredentialRole(const OicSecCred_t *cred)
 
     SymmetricRoleEntry_t *curr = NULL;
 
+    SRMInvalidateAccessDecisionCache();
+
     LL_FOREACH(gSymmetricRoles, curr)
     {
         if (0 == memcmp(&cred->subject, &curr->subject, sizeof(curr->subject)))
@@ -383,6 +385,7 @@ static OCStackResult AddRoleCertificate(const RoleCertChain_t *roleCert, const u
         // Assign our own credId.
         copy->credId = gIdCounter++;
         LL_APPEND(targetEntry->chains, copy);
+        SRMInvalidateAccessDecisionCache();
     }
     else
     {
@@ -982,6 +985,7 @@ static OCEntityHandlerResult HandleDeleteRequest(OCEntityHandlerRequest *ehReque
     }
 
     InvalidateRoleCache(entry);
+    SRMInvalidateAccessDecisionCache();
 
     if (NULL != entry->chains)
     {
@@ -1093,6 +1097,7 @@ OCStackResult DeInitRolesResource()
     FreeSymmetricRolesList(gSymmetricRoles);
 
     gRoles = NULL;
+    SRMInvalidateAccessDecisionCache();
 
     return res;
 }
@@ -19,6 +19,7 @@
 //-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
 
 #include <string.h>
+#include "utlist.h"
 #include "ocstack.h"
 #include "experimental/logger.h"
 #include "cainterface.h"
@@ -35,6 +36,7 @@
 
 #if defined( __WITH_TLS__) || defined(__WITH_DTLS__)
 #include "pkix_interface.h"
+#include "rolesresource.h"
 #endif //__WITH_TLS__ or __WITH_DTLS__
 #define TAG  "OIC_SRM"
 
@@ -51,6 +53,34 @@ static CAErrorCallback gErrorHandler = NULL;
  */
 SRMRequestContext_t g_requestContext;
 
+/**
+ * Maximum number of ACL decisions kept in the access decision cache.
+ */
+#define SRM_ACCESS_CACHE_SIZE (32)
+
+/**
+ * ACL decision for one kind of request, kept in most recently used order.
+ */
+typedef struct SRMAccessCacheEntry
+{
+    OicUuid_t               subjectUuid;
+    bool                    secureChannel;
+    OicSecDiscoverable_t    discoverable;
+    uint16_t                requestedPermission;
+    char                    resourceUri[MAX_URI_LENGTH + 1];
+    bool                    rolesChecked;   // Does the decision depend on the requester roles?
+    OicSecRole_t            *roles;
+    size_t                  roleCount;
+    time_t                  validUntil;     // 0 if no ACE validity period was checked.
+    SRMAccessResponse_t     responseVal;
+    struct SRMAccessCacheEntry *next;
+} SRMAccessCacheEntry_t;
+
+static SRMAccessCacheEntry_t *g_accessCache = NULL;
+static size_t g_accessCacheCount = 0;
+static uint32_t g_accessCacheHits = 0;
+static uint32_t g_accessCacheMisses = 0;
+
 void SetRequestedResourceType(SRMRequestContext_t *context)
 {
     context->resourceType = GetSvrTypeFromUri(context->resourceUri);
@@ -222,6 +252,7 @@ static void ClearRequestContext(SRMRequestContext_t *context)
         context->discoverable = DISCOVERABLE_NOT_KNOWN;
         context->subjectIdType = SUBJECT_ID_TYPE_ERROR;
         memset(&context->subjectUuid, 0, sizeof(context->subjectUuid));
+        context->aclDecisionValidUntil = 0;
 #ifdef MULTIPLE_OWNER
         context->payload = NULL;
         context->payloadSize = 0;
@@ -231,6 +262,202 @@ static void ClearRequestContext(SRMRequestContext_t *context)
     return;
 }
 
+static void FreeAccessCacheEntry(SRMAccessCacheEntry_t *entry)
+{
+    OICFree(entry->roles);
+    OICFree(entry);
+}
+
+static void RemoveAccessCacheEntry(SRMAccessCacheEntry_t *entry)
+{
+    LL_DELETE(g_accessCache, entry);
+    FreeAccessCacheEntry(entry);
+    g_accessCacheCount--;
+}
+
+static bool IsSameAccessRequest(const SRMAccessCacheEntry_t *entry,
+                                const SRMRequestContext_t *context)
+{
+    return (entry->secureChannel == context->secureChannel) &&
+           (entry->discoverable == context->discoverable) &&
+           (entry->requestedPermission == context->requestedPermission) &&
+           (0 == memcmp(&entry->subjectUuid, &context->subjectUuid, sizeof(entry->subjectUuid))) &&
+           (0 == strcmp(entry->resourceUri, context->resourceUri));
+}
+
+#if defined(__WITH_DTLS__) || defined(__WITH_TLS__)
+static bool IsSameRoleList(const OicSecRole_t *roles1, size_t roleCount1,
+                           const OicSecRole_t *roles2, size_t roleCount2)
+{
+    if (roleCount1 != roleCount2)
+    {
+        return false;
+    }
+    for (size_t i = 0; i < roleCount1; i++)
+    {
+        if ((0 != strcmp(roles1[i].id, roles2[i].id)) ||
+            (0 != strcmp(roles1[i].authority, roles2[i].authority)))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+#endif /* __WITH_DTLS__ or __WITH_TLS__ */
+
+bool SRMGetCachedAccessDecision(SRMRequestContext_t *context)
+{
+    if ((NULL == context) || (SUBJECT_ID_TYPE_UUID != context->subjectIdType))
+    {
+        return false;
+    }
+
+#ifndef WITH_ARDUINO
+    time_t now = time(NULL);
+#endif
+#if defined(__WITH_DTLS__) || defined(__WITH_TLS__)
+    OicSecRole_t *roles = NULL;
+    size_t roleCount = 0;
+    bool rolesFetched = false;
+#endif
+    SRMAccessCacheEntry_t *entry = NULL;
+    SRMAccessCacheEntry_t *tmp = NULL;
+    SRMAccessCacheEntry_t *found = NULL;
+
+    LL_FOREACH_SAFE(g_accessCache, entry, tmp)
+    {
+        if (!IsSameAccessRequest(entry, context))
+        {
+            continue;
+        }
+#ifndef WITH_ARDUINO
+        if ((0 != entry->validUntil) && (now >= entry->validUntil))
+        {
+            // An ACE validity period may have started or ended since the decision.
+            RemoveAccessCacheEntry(entry);
+            continue;
+        }
+#endif
+        if (entry->rolesChecked)
+        {
+#if defined(__WITH_DTLS__) || defined(__WITH_TLS__)
+            if (!rolesFetched)
+            {
+                if (OC_STACK_OK != GetEndpointRoles(context->endPoint, &roles, &roleCount))
+                {
+                    break;
+                }
+                rolesFetched = true;
+            }
+            if (!IsSameRoleList(entry->roles, entry->roleCount, roles, roleCount))
+            {
+                continue;
+            }
+#else
+            continue;
+#endif
+        }
+        found = entry;
+        break;
+    }
+
+#if defined(__WITH_DTLS__) || defined(__WITH_TLS__)
+    OICFree(roles);
+#endif
+
+    if (NULL == found)
+    {
+        g_accessCacheMisses++;
+        return false;
+    }
+
+    g_accessCacheHits++;
+    if (found != g_accessCache)
+    {
+        LL_DELETE(g_accessCache, found);
+        LL_PREPEND(g_accessCache, found);
+    }
+    context->responseVal = found->responseVal;
+    OIC_LOG_V(DEBUG, TAG, "%s: cached responseVal %d for %s", __func__,
+              found->responseVal, context->resourceUri);
+    return true;
+}
+
+void SRMCacheAccessDecision(const SRMRequestContext_t *context, bool rolesChecked,
+                            const OicSecRole_t *roles, size_t roleCount)
+{
+    if ((NULL == context) || (SUBJECT_ID_TYPE_UUID != context->subjectIdType))
+    {
+        return;
+    }
+
+    SRMAccessCacheEntry_t *entry =
+        (SRMAccessCacheEntry_t *)OICCalloc(1, sizeof(SRMAccessCacheEntry_t));
+    if (NULL == entry)
+    {
+        OIC_LOG(WARNING, TAG, "Failed to allocate access cache entry");
+        return;
+    }
+    if (rolesChecked && (0 < roleCount))
+    {
+        entry->roles = (OicSecRole_t *)OICCalloc(roleCount, sizeof(OicSecRole_t));
+        if (NULL == entry->roles)
+        {
+            OIC_LOG(WARNING, TAG, "Failed to allocate access cache entry roles");
+            OICFree(entry);
+            return;
+        }
+        memcpy(entry->roles, roles, roleCount * sizeof(OicSecRole_t));
+        entry->roleCount = roleCount;
+    }
+
+    memcpy(&entry->subjectUuid, &context->subjectUuid, sizeof(entry->subjectUuid));
+    entry->secureChannel = context->secureChannel;
+    entry->discoverable = context->discoverable;
+    entry->requestedPermission = context->requestedPermission;
+    OICStrcpy(entry->resourceUri, sizeof(entry->resourceUri), context->resourceUri);
+    entry->rolesChecked = rolesChecked;
+    entry->validUntil = context->aclDecisionValidUntil;
+    entry->responseVal = context->responseVal;
+
+    // Drop the least recently used decision when full.
+    if (SRM_ACCESS_CACHE_SIZE <= g_accessCacheCount)
+    {
+        SRMAccessCacheEntry_t *last = g_accessCache;
+        while (NULL != last->next)
+        {
+            last = last->next;
+        }
+        RemoveAccessCacheEntry(last);
+    }
+
+    LL_PREPEND(g_accessCache, entry);
+    g_accessCacheCount++;
+}
+
+void SRMInvalidateAccessDecisionCache()
+{
+    SRMAccessCacheEntry_t *entry = NULL;
+    SRMAccessCacheEntry_t *tmp = NULL;
+    LL_FOREACH_SAFE(g_accessCache, entry, tmp)
+    {
+        LL_DELETE(g_accessCache, entry);
+        FreeAccessCacheEntry(entry);
+    }
+    g_accessCacheCount = 0;
+}
+
+OCStackResult SRMGetAccessDecisionCacheStats(uint32_t *hits, uint32_t *misses)
+{
+    if ((NULL == hits) || (NULL == misses))
+    {
+        return OC_STACK_INVALID_PARAM;
+    }
+    *hits = g_accessCacheHits;
+    *misses = g_accessCacheMisses;
+    return OC_STACK_OK;
+}
+
 // Returns true iff Request arrived over secure channel
 // Note: context->subjectUuid must be copied from requestInfo prior to calling
 // this function, or this function may incorrectly read the nil-UUID (0s)
@@ -459,6 +686,7 @@ OCStackResult SRMInitSecureResources()
 void SRMDeInitSecureResources()
 {
     DestroySecureResources();
+    SRMInvalidateAccessDecisionCache();
 }
 
 bool SRMIsSecurityResourceURI(const char* uri)
@@ -0,0 +1,168 @@
+//******************************************************************
+//
+// Copyright 2017 Intel Mobile Communications GmbH All Rights Reserved.
+//
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+
+#include <gtest/gtest.h>
+#include <stdio.h>
+#include <string.h>
+#include "ocstack.h"
+#include "srmresourcestrings.h"
+#include "aclresource.h"
+#include "credresource.h"
+#include "experimental/doxmresource.h"
+#include "pstatresource.h"
+#include "deviceonboardingstate.h"
+
+#define STRINGIZE2(x) #x
+#define STRINGIZE(x) STRINGIZE2(x)
+
+#define DOS_TEST_DB_FILE_NAME "deviceonboardingstate_test.dat"
+
+static size_t g_svrDbWrites = 0;
+
+/**
+ * Opens the SVR database of the test in place of the device's, counting its opens for
+ * writing.
+ */
+static FILE *TestSvrDbOpen(const char *path, const char *mode)
+{
+    if (0 == strcmp(path, SVR_DB_DAT_FILE_NAME))
+    {
+        if (strchr(mode, 'w') || strchr(mode, 'a'))
+        {
+            g_svrDbWrites++;
+        }
+        return fopen(DOS_TEST_DB_FILE_NAME, mode);
+    }
+    return fopen(path, mode);
+}
+
+static bool CopyFileContents(const char *from, const char *to)
+{
+    FILE *in = fopen(from, "rb");
+    if (!in)
+    {
+        printf("Unable to open %s file\n", from);
+        return false;
+    }
+    FILE *out = fopen(to, "wb");
+    bool copied = (NULL != out);
+    char buf[1024];
+    size_t len = 0;
+    while (copied && (0 < (len = fread(buf, 1, sizeof(buf), in))))
+    {
+        copied = (len == fwrite(buf, 1, len, out));
+    }
+    if (out)
+    {
+        fclose(out);
+    }
+    fclose(in);
+    return copied;
+}
+
+class DeviceOnboardingStateTest : public ::testing::Test
+{
+protected:
+    virtual void SetUp()
+    {
+#ifdef _MSC_VER
+// See ReadCBORFile() in srmtestcommon.cpp
+#pragma warning(push)
+#pragma warning(disable:4429)
+#endif
+        // An unowned device, in RFOTM
+        ASSERT_TRUE(CopyFileContents(STRINGIZE(SECURITY_BUILD_UNITTEST_DIR) "oic_svr_db.dat",
+                                     DOS_TEST_DB_FILE_NAME));
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
+        m_ps.open = TestSvrDbOpen;
+        m_ps.read = fread;
+        m_ps.write = fwrite;
+        m_ps.close = fclose;
+        m_ps.unlink = remove;
+        ASSERT_EQ(OC_STACK_OK, OCRegisterPersistentStorageHandler(&m_ps));
+        ASSERT_EQ(OC_STACK_OK, OCInit(NULL, 0, OC_SERVER));
+
+        OicSecDostype_t dos;
+        ASSERT_EQ(OC_STACK_OK, GetDos(&dos));
+        ASSERT_EQ(DOS_RFOTM, dos.state);
+        g_svrDbWrites = 0;
+    }
+
+    virtual void TearDown()
+    {
+        OCStop();
+        remove(DOS_TEST_DB_FILE_NAME);
+    }
+
+    static OicSecDeviceOnboardingState_t GetDosState()
+    {
+        OicSecDostype_t dos;
+        EXPECT_EQ(OC_STACK_OK, GetDos(&dos));
+        return dos.state;
+    }
+
+    OCPersistentStorage m_ps;
+};
+
+static const OicUuid_t OWNER_UUID = {{ 0x6f, 0x77, 0x6e, 0x65, 0x72, 0x55, 0x75, 0x69,
+                                       0x64, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x31 }};
+
+TEST_F(DeviceOnboardingStateTest, OwnershipTransferWritesSvrsInRFPRO)
+{
+    ASSERT_EQ(OC_STACK_OK, BeginOwnershipTransferTransaction());
+
+    // The SVRs the onboarding tool sets during the ownership transfer are held
+    EXPECT_EQ(OC_STACK_OK, SetDoxmIsOwned(true));
+    EXPECT_EQ(OC_STACK_OK, SetDoxmDevOwnerId(&OWNER_UUID));
+    EXPECT_EQ(OC_STACK_OK, SetDoxmRownerId(&OWNER_UUID));
+    EXPECT_EQ(OC_STACK_OK, SetAclRownerId(&OWNER_UUID));
+    EXPECT_EQ(OC_STACK_OK, SetCredRownerId(&OWNER_UUID));
+    EXPECT_EQ(OC_STACK_OK, SetPstatRownerId(&OWNER_UUID));
+    EXPECT_EQ(0u, g_svrDbWrites);
+
+    // and written once the device enters RFPRO
+    EXPECT_EQ(OC_STACK_OK, SetDosState(DOS_RFPRO));
+    EXPECT_EQ(DOS_RFPRO, GetDosState());
+    EXPECT_LT(0u, g_svrDbWrites);
+
+    // No transaction is left open
+    size_t writes = g_svrDbWrites;
+    EXPECT_EQ(OC_STACK_OK, SetPstatRownerId(&OWNER_UUID));
+    EXPECT_EQ(writes + 1, g_svrDbWrites);
+}
+
+TEST_F(DeviceOnboardingStateTest, FailedOwnershipTransferWritesSvrs)
+{
+    ASSERT_EQ(OC_STACK_OK, BeginOwnershipTransferTransaction());
+    EXPECT_EQ(OC_STACK_OK, SetPstatRownerId(&OWNER_UUID));
+    EXPECT_EQ(0u, g_svrDbWrites);
+
+    // The device is not owned, so it cannot enter RFPRO
+    EXPECT_EQ(OC_STACK_FORBIDDEN_REQ, SetDosState(DOS_RFPRO));
+    EXPECT_EQ(DOS_RFOTM, GetDosState());
+    EXPECT_LT(0u, g_svrDbWrites);
+
+    // No transaction is left open
+    size_t writes = g_svrDbWrites;
+    EXPECT_EQ(OC_STACK_OK, SetPstatRownerId(&OWNER_UUID));
+    EXPECT_EQ(writes + 1, g_svrDbWrites);
+}
@@ -345,4 +345,39 @@ TEST(IsRequestWithinValidTimeTest, IsRequestWithinValidTimeInValidPeriodAndValid
     EXPECT_EQ(IOTVTICAL_INVALID_ACCESS, IsRequestWithinValidTime(periodStr, recurStr));
 }
 
+TEST(GetNextValidTimeChangeTest, GetNextValidTimeChangeWithinOneDay)
+{
+    char periodStr[] = "20150630T060000/20150630T200000";
+    time_t now = time(0);
+    time_t nextChange = 0;
+
+    EXPECT_EQ(IOTVTICAL_SUCCESS, GetNextValidTimeChange(periodStr, &nextChange));
+    EXPECT_LT(now, nextChange);
+    //Next midnight is at most a day (and a DST shift) away
+    EXPECT_GE(now + 25 * 3600, nextChange);
+}
+
+TEST(GetNextValidTimeChangeTest, GetNextValidTimeChangeAtStartTime)
+{
+    //Period starting one minute from now; the result changes then at the latest.
+    time_t now = time(0);
+    time_t start = now + 60;
+    struct tm startTm = *localtime(&start);
+    char periodStr[40];
+    strftime(periodStr, sizeof(periodStr), "%Y%m%dT%H%M%S/20551230T235959", &startTm);
+    time_t nextChange = 0;
+
+    EXPECT_EQ(IOTVTICAL_SUCCESS, GetNextValidTimeChange(periodStr, &nextChange));
+    EXPECT_LT(now, nextChange);
+    EXPECT_GE(start, nextChange);
+}
+
+TEST(GetNextValidTimeChangeTest, GetNextValidTimeChangeInvalidPeriod)
+{
+    char periodStr[] = "20150630T060000";
+    time_t nextChange = 0;
+
+    EXPECT_EQ(IOTVTICAL_INVALID_PERIOD, GetNextValidTimeChange(periodStr, &nextChange));
+    EXPECT_EQ(IOTVTICAL_INVALID_PARAMETER, GetNextValidTimeChange(NULL, &nextChange));
+}
 #endif
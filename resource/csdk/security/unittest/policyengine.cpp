@@ -19,9 +19,17 @@
 //-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
 
 #include <gtest/gtest.h>
+#include <coap/utlist.h>
+#include <chrono>
 #include "ocstack.h"
 #include "cainterface.h"
+#include "oic_malloc.h"
+#include "oic_string.h"
 #include "srmresourcestrings.h"
+#include "secureresourcemanager.h"
+#include "aclresource.h"
+#include "pstatresource.h"
+#include "security_internals.h"
 
 using namespace std;
 
@@ -115,3 +123,215 @@ extern OicSecDoxm_t *gDoxm;
 //     EXPECT_EQ((uint16_t)0, g_peContext.permission);
 //     EXPECT_EQ(ACCESS_DENIED_POLICY_ENGINE_ERROR, g_peContext.retVal);
 // }
+
+#define PE_TEST_DB_FILE_NAME "policyengine_test.dat"
+
+static FILE *TestSvrDbOpen(const char *path, const char *mode)
+{
+    return fopen((0 == strcmp(path, SVR_DB_DAT_FILE_NAME)) ? PE_TEST_DB_FILE_NAME : path, mode);
+}
+
+/**
+ * Writes the SVR updates of a test to a test database in place of the device's, and
+ * removes it at the end of the test.
+ */
+class TestSvrDb
+{
+public:
+    TestSvrDb()
+    {
+        remove(PE_TEST_DB_FILE_NAME);
+        EXPECT_EQ(OC_STACK_OK, OCRegisterPersistentStorageHandler(&s_ps));
+    }
+
+    ~TestSvrDb()
+    {
+        remove(PE_TEST_DB_FILE_NAME);
+    }
+
+private:
+    static OCPersistentStorage s_ps;
+};
+
+OCPersistentStorage TestSvrDb::s_ps = { TestSvrDbOpen, fread, fwrite, fclose, remove };
+
+static OicSecAce_t *CreateUuidAce(const char *subject, const char *href, uint16_t permission)
+{
+    OicSecAce_t *ace = (OicSecAce_t *)OICCalloc(1, sizeof(OicSecAce_t));
+    OicSecRsrc_t *rsrc = (OicSecRsrc_t *)OICCalloc(1, sizeof(OicSecRsrc_t));
+    if ((NULL == ace) || (NULL == rsrc))
+    {
+        OICFree(ace);
+        OICFree(rsrc);
+        return NULL;
+    }
+    ace->subjectType = OicSecAceUuidSubject;
+    OICStrcpy((char *)ace->subjectuuid.id, sizeof(ace->subjectuuid.id), subject);
+    ace->permission = permission;
+    rsrc->href = OICStrdup(href);
+    LL_APPEND(ace->resources, rsrc);
+    return ace;
+}
+
+static void InitRequestContext(SRMRequestContext_t *context, const char *subject,
+                               const char *uri, uint16_t permission)
+{
+    memset(context, 0, sizeof(*context));
+    context->resourceType = NOT_A_SVR_RESOURCE;
+    OICStrcpy(context->resourceUri, sizeof(context->resourceUri), uri);
+    context->requestedPermission = permission;
+    context->discoverable = DISCOVERABLE_TRUE;
+    context->subjectIdType = SUBJECT_ID_TYPE_UUID;
+    OICStrcpy((char *)context->subjectUuid.id, sizeof(context->subjectUuid.id), subject);
+}
+
+static SRMAccessResponse_t CheckRequest(const char *subject, const char *uri,
+                                        uint16_t permission)
+{
+    SRMRequestContext_t context;
+    InitRequestContext(&context, subject, uri, permission);
+    CheckPermission(&context);
+    return context.responseVal;
+}
+
+TEST(PolicyEngineCore, CheckPermissionWithAclIndex)
+{
+    TestSvrDb svrDb;
+    ASSERT_EQ(OC_STACK_OK, InitPstatResourceToDefault());
+
+    OicSecAcl_t *acl = (OicSecAcl_t *)OICCalloc(1, sizeof(OicSecAcl_t));
+    ASSERT_TRUE(NULL != acl);
+    OicSecAce_t *aceA = CreateUuidAce("SubjectA", "/a/light", PERMISSION_READ);
+    OicSecAce_t *aceB = CreateUuidAce("SubjectB", WILDCARD_RESOURCE_URI,
+                                      PERMISSION_READ | PERMISSION_WRITE);
+    ASSERT_TRUE(NULL != aceA);
+    ASSERT_TRUE(NULL != aceB);
+    LL_APPEND(acl->aces, aceA);
+    LL_APPEND(acl->aces, aceB);
+    EXPECT_EQ(OC_STACK_OK, SetDefaultACL(acl));
+
+    EXPECT_EQ(ACCESS_GRANTED, CheckRequest("SubjectA", "/a/light", PERMISSION_READ));
+    EXPECT_EQ(ACCESS_DENIED_INSUFFICIENT_PERMISSION,
+              CheckRequest("SubjectA", "/a/light", PERMISSION_WRITE));
+    EXPECT_EQ(ACCESS_DENIED_RESOURCE_NOT_FOUND,
+              CheckRequest("SubjectA", "/a/fan", PERMISSION_READ));
+    EXPECT_EQ(ACCESS_GRANTED, CheckRequest("SubjectB", "/a/fan", PERMISSION_WRITE));
+    EXPECT_EQ(ACCESS_DENIED_SUBJECT_NOT_FOUND,
+              CheckRequest("SubjectC", "/a/light", PERMISSION_READ));
+
+    // Removing the ACE of a subject must be seen by the next request. RemoveACE() frees
+    // the ACE, so its subject is passed as a copy.
+    OicUuid_t subjectA = aceA->subjectuuid;
+    EXPECT_EQ(OC_STACK_RESOURCE_DELETED, RemoveACE(&subjectA, NULL));
+    EXPECT_EQ(ACCESS_DENIED_SUBJECT_NOT_FOUND,
+              CheckRequest("SubjectA", "/a/light", PERMISSION_READ));
+    EXPECT_EQ(ACCESS_GRANTED, CheckRequest("SubjectB", "/a/light", PERMISSION_READ));
+
+    DeInitACLResource();
+}
+
+TEST(PolicyEngineCore, CheckPermissionCachesAclDecision)
+{
+    TestSvrDb svrDb;
+    ASSERT_EQ(OC_STACK_OK, InitPstatResourceToDefault());
+
+    OicSecAcl_t *acl = (OicSecAcl_t *)OICCalloc(1, sizeof(OicSecAcl_t));
+    ASSERT_TRUE(NULL != acl);
+    OicSecAce_t *ace = CreateUuidAce("SubjectA", "/a/light", PERMISSION_READ);
+    ASSERT_TRUE(NULL != ace);
+    LL_APPEND(acl->aces, ace);
+    EXPECT_EQ(OC_STACK_OK, SetDefaultACL(acl));
+
+    uint32_t hits = 0;
+    uint32_t misses = 0;
+    EXPECT_EQ(OC_STACK_OK, SRMGetAccessDecisionCacheStats(&hits, &misses));
+
+    EXPECT_EQ(ACCESS_GRANTED, CheckRequest("SubjectA", "/a/light", PERMISSION_READ));
+    EXPECT_EQ(ACCESS_GRANTED, CheckRequest("SubjectA", "/a/light", PERMISSION_READ));
+
+    uint32_t newHits = 0;
+    uint32_t newMisses = 0;
+    EXPECT_EQ(OC_STACK_OK, SRMGetAccessDecisionCacheStats(&newHits, &newMisses));
+    EXPECT_EQ(hits + 1, newHits);
+    EXPECT_EQ(misses + 1, newMisses);
+
+    // A different permission is a different request.
+    EXPECT_EQ(ACCESS_DENIED_INSUFFICIENT_PERMISSION,
+              CheckRequest("SubjectA", "/a/light", PERMISSION_WRITE));
+
+    // Changing the ACL drops the cached decision. RemoveACE() frees the ACE, so its
+    // subject is passed as a copy.
+    OicUuid_t subject = ace->subjectuuid;
+    EXPECT_EQ(OC_STACK_RESOURCE_DELETED, RemoveACE(&subject, NULL));
+    EXPECT_EQ(ACCESS_DENIED_SUBJECT_NOT_FOUND,
+              CheckRequest("SubjectA", "/a/light", PERMISSION_READ));
+
+    DeInitACLResource();
+}
+
+TEST(PolicyEngineCore, CheckPermissionLargeAclTiming)
+{
+    const int aceCount = 1000;
+    const int checkCount = 10000;
+
+    ASSERT_EQ(OC_STACK_OK, InitPstatResourceToDefault());
+
+    OicSecAcl_t *acl = (OicSecAcl_t *)OICCalloc(1, sizeof(OicSecAcl_t));
+    ASSERT_TRUE(NULL != acl);
+    for (int i = 0; i < aceCount; i++)
+    {
+        char subject[UUID_LENGTH];
+        char href[MAX_URI_LENGTH];
+        snprintf(subject, sizeof(subject), "Subject%d", i % 100);
+        snprintf(href, sizeof(href), "/a/res%d", i);
+        OicSecAce_t *ace = CreateUuidAce(subject, href, PERMISSION_READ);
+        ASSERT_TRUE(NULL != ace);
+        LL_APPEND(acl->aces, ace);
+    }
+    EXPECT_EQ(OC_STACK_OK, SetDefaultACL(acl));
+
+    // The last ACE of the ACL, which a linear scan reaches only after all the others.
+    SRMRequestContext_t context;
+    InitRequestContext(&context, "Subject99", "/a/res999", PERMISSION_READ);
+
+    // Each check goes through the ACL index, with the cached decision dropped first.
+    uint32_t hits = 0;
+    uint32_t misses = 0;
+    EXPECT_EQ(OC_STACK_OK, SRMGetAccessDecisionCacheStats(&hits, &misses));
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < checkCount; i++)
+    {
+        SRMInvalidateAccessDecisionCache();
+        CheckPermission(&context);
+        ASSERT_EQ(ACCESS_GRANTED, context.responseVal);
+    }
+    auto uncached = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start);
+    uint32_t newHits = 0;
+    uint32_t newMisses = 0;
+    EXPECT_EQ(OC_STACK_OK, SRMGetAccessDecisionCacheStats(&newHits, &newMisses));
+    EXPECT_EQ(hits, newHits);
+    EXPECT_EQ(misses + checkCount, newMisses);
+
+    // Each check but the first is answered by the decision cache.
+    SRMInvalidateAccessDecisionCache();
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < checkCount; i++)
+    {
+        CheckPermission(&context);
+        ASSERT_EQ(ACCESS_GRANTED, context.responseVal);
+    }
+    auto cached = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start);
+    hits = newHits;
+    misses = newMisses;
+    EXPECT_EQ(OC_STACK_OK, SRMGetAccessDecisionCacheStats(&newHits, &newMisses));
+    EXPECT_EQ(hits + checkCount - 1, newHits);
+    EXPECT_EQ(misses + 1, newMisses);
+
+    printf("%s %d ACEs: %.3f us per CheckPermission without the decision cache, "
+           "%.3f us with it\n", PE_UT_TAG, aceCount,
+           (double)uncached.count() / checkCount, (double)cached.count() / checkCount);
+
+    DeInitACLResource();
+}
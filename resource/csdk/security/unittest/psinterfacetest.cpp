@@ -0,0 +1,428 @@
+/******************************************************************
+*
+* Copyright 2017 Samsung Electronics All Rights Reserved.
+*
+*
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*      http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*
+******************************************************************/
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <chrono>
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+#include <thread>
+#include <vector>
+#include "ocstack.h"
+#include "oic_malloc.h"
+#include "psinterface.h"
+#include "srmresourcestrings.h"
+#include "srmtestcommon.h"
+
+#define PS_TEST_DB_FILE_NAME "psinterface_test.dat"
+#define PS_TEST_JOURNAL_FILE_NAME PS_TEST_DB_FILE_NAME ".jnl"
+
+static size_t g_fileWrites = 0;
+static std::chrono::microseconds g_writeDelay(0);
+
+/**
+ * Opens files like fopen, counting the opens for writing.
+ */
+static FILE *CountingOpen(const char *path, const char *mode)
+{
+    if (strchr(mode, 'w') || strchr(mode, 'a'))
+    {
+        g_fileWrites++;
+    }
+    return fopen(path, mode);
+}
+
+/**
+ * Writes files like fwrite, with the delay of a slow flash device.
+ */
+static size_t SlowWrite(const void *ptr, size_t size, size_t count, FILE *fp)
+{
+    std::this_thread::sleep_for(g_writeDelay);
+    return fwrite(ptr, size, count, fp);
+}
+
+/**
+ * Opens files like fopen, but fails the opens for writing, like read-only storage.
+ */
+static FILE *ReadOnlyOpen(const char *path, const char *mode)
+{
+    if (strchr(mode, 'w') || strchr(mode, 'a'))
+    {
+        return NULL;
+    }
+    return fopen(path, mode);
+}
+
+class PSInterfaceTest : public ::testing::Test
+{
+protected:
+    virtual void SetUp()
+    {
+        remove(PS_TEST_DB_FILE_NAME);
+        remove(PS_TEST_JOURNAL_FILE_NAME);
+        SetPersistentHandler(&m_ps, true);
+    }
+
+    virtual void TearDown()
+    {
+        EXPECT_EQ(OC_STACK_OK, SetPSJournalEnabled(false));
+        remove(PS_TEST_DB_FILE_NAME);
+        remove(PS_TEST_JOURNAL_FILE_NAME);
+        SetPersistentHandler(&m_ps, false);
+    }
+
+    static std::vector<uint8_t> MakePayload(uint8_t seed, size_t size)
+    {
+        std::vector<uint8_t> payload(size);
+        for (size_t i = 0; i < size; i++)
+        {
+            payload[i] = (uint8_t)(seed + i);
+        }
+        return payload;
+    }
+
+    static OCStackResult Update(const char *resourceName, const std::vector<uint8_t> &payload)
+    {
+        return UpdateResourceInPS(PS_TEST_DB_FILE_NAME, resourceName,
+                                  payload.empty() ? NULL : payload.data(), payload.size());
+    }
+
+    static bool Matches(const char *resourceName, const std::vector<uint8_t> &expected)
+    {
+        uint8_t *data = NULL;
+        size_t size = 0;
+        OCStackResult ret = ReadDatabaseFromPS(PS_TEST_DB_FILE_NAME, resourceName, &data, &size);
+        bool matches = (OC_STACK_OK == ret) && (expected.size() == size) &&
+                       std::equal(expected.begin(), expected.end(), data);
+        OICFree(data);
+        return matches;
+    }
+
+    static bool Exists(const char *resourceName)
+    {
+        uint8_t *data = NULL;
+        size_t size = 0;
+        OCStackResult ret = ReadDatabaseFromPS(PS_TEST_DB_FILE_NAME, resourceName, &data, &size);
+        OICFree(data);
+        return OC_STACK_OK == ret;
+    }
+
+    static bool FileExists(const char *name)
+    {
+        FILE *fp = fopen(name, "rb");
+        if (fp)
+        {
+            fclose(fp);
+        }
+        return NULL != fp;
+    }
+
+    OCPersistentStorage m_ps;
+};
+
+TEST_F(PSInterfaceTest, JournalKeepsEachResource)
+{
+    std::vector<uint8_t> acl1 = MakePayload(1, 100);
+    std::vector<uint8_t> acl2 = MakePayload(2, 150);
+    std::vector<uint8_t> cred = MakePayload(3, 200);
+
+    ASSERT_EQ(OC_STACK_OK, SetPSJournalEnabled(true));
+    EXPECT_EQ(OC_STACK_OK, Update(OIC_JSON_ACL_NAME, acl1));
+    EXPECT_EQ(OC_STACK_OK, Update(OIC_JSON_CRED_NAME, cred));
+    EXPECT_EQ(OC_STACK_OK, Update(OIC_JSON_ACL_NAME, acl2));
+    EXPECT_TRUE(FileExists(PS_TEST_JOURNAL_FILE_NAME));
+
+    // Reload the database from the journal.
+    DeInitPSJournal();
+    EXPECT_TRUE(Matches(OIC_JSON_ACL_NAME, acl2));
+    EXPECT_TRUE(Matches(OIC_JSON_CRED_NAME, cred));
+    EXPECT_FALSE(Exists(OIC_JSON_PSTAT_NAME));
+
+    EXPECT_EQ(OC_STACK_OK, Update(OIC_JSON_CRED_NAME, std::vector<uint8_t>()));
+    DeInitPSJournal();
+    EXPECT_TRUE(Matches(OIC_JSON_ACL_NAME, acl2));
+    EXPECT_FALSE(Exists(OIC_JSON_CRED_NAME));
+}
+
+TEST_F(PSInterfaceTest, JournalMigratesDatabaseFile)
+{
+    std::vector<uint8_t> acl = MakePayload(1, 100);
+    std::vector<uint8_t> pstat = MakePayload(2, 50);
+    std::vector<uint8_t> cred = MakePayload(3, 200);
+
+    // Database file written without the journal.
+    EXPECT_EQ(OC_STACK_OK, Update(OIC_JSON_ACL_NAME, acl));
+    EXPECT_EQ(OC_STACK_OK, Update(OIC_JSON_PSTAT_NAME, pstat));
+
+    ASSERT_EQ(OC_STACK_OK, SetPSJournalEnabled(true));
+    EXPECT_TRUE(Matches(OIC_JSON_ACL_NAME, acl));
+    EXPECT_TRUE(Matches(OIC_JSON_PSTAT_NAME, pstat));
+    EXPECT_EQ(OC_STACK_OK, Update(OIC_JSON_CRED_NAME, cred));
+
+    // Disabling the journal folds it into the database file.
+    ASSERT_EQ(OC_STACK_OK, SetPSJournalEnabled(false));
+    EXPECT_FALSE(FileExists(PS_TEST_JOURNAL_FILE_NAME));
+    EXPECT_TRUE(Matches(OIC_JSON_ACL_NAME, acl));
+    EXPECT_TRUE(Matches(OIC_JSON_PSTAT_NAME, pstat));
+    EXPECT_TRUE(Matches(OIC_JSON_CRED_NAME, cred));
+}
+
+TEST_F(PSInterfaceTest, JournalIgnoresTornRecord)
+{
+    std::vector<uint8_t> acl1 = MakePayload(1, 100);
+    std::vector<uint8_t> acl2 = MakePayload(2, 100);
+    std::vector<uint8_t> pstat = MakePayload(3, 50);
+
+    ASSERT_EQ(OC_STACK_OK, SetPSJournalEnabled(true));
+    EXPECT_EQ(OC_STACK_OK, Update(OIC_JSON_ACL_NAME, acl1));
+    EXPECT_EQ(OC_STACK_OK, Update(OIC_JSON_ACL_NAME, acl2));
+
+    // Simulate a crash in the middle of appending a record.
+    FILE *fp = fopen(PS_TEST_JOURNAL_FILE_NAME, "ab");
+    ASSERT_TRUE(NULL != fp);
+    const uint8_t torn[] = { 'P', 3, 0, 100, 0, 0, 0, 'a', 'c' };
+    EXPECT_EQ(sizeof(torn), fwrite(torn, 1, sizeof(torn), fp));
+    fclose(fp);
+
+    DeInitPSJournal();
+    EXPECT_TRUE(Matches(OIC_JSON_ACL_NAME, acl2));
+
+    // Records appended after the torn one are replayed.
+    EXPECT_EQ(OC_STACK_OK, Update(OIC_JSON_PSTAT_NAME, pstat));
+    DeInitPSJournal();
+    EXPECT_TRUE(Matches(OIC_JSON_ACL_NAME, acl2));
+    EXPECT_TRUE(Matches(OIC_JSON_PSTAT_NAME, pstat));
+}
+
+TEST_F(PSInterfaceTest, JournalCompactsIntoDatabaseFile)
+{
+    std::vector<uint8_t> acl = MakePayload(1, 100);
+    std::vector<uint8_t> cred;
+
+    ASSERT_EQ(OC_STACK_OK, SetPSJournalEnabled(true));
+    EXPECT_EQ(OC_STACK_OK, Update(OIC_JSON_ACL_NAME, acl));
+    for (int i = 0; i < 100; i++)
+    {
+        cred = MakePayload((uint8_t)i, 4096);
+        ASSERT_EQ(OC_STACK_OK, Update(OIC_JSON_CRED_NAME, cred));
+    }
+
+    // The journal is compacted well before it holds all the updates.
+    FILE *fp = fopen(PS_TEST_JOURNAL_FILE_NAME, "rb");
+    size_t journalSize = 0;
+    if (fp)
+    {
+        fseek(fp, 0, SEEK_END);
+        journalSize = (size_t)ftell(fp);
+        fclose(fp);
+    }
+    EXPECT_GT(100 * cred.size(), journalSize);
+    EXPECT_TRUE(FileExists(PS_TEST_DB_FILE_NAME));
+
+    DeInitPSJournal();
+    EXPECT_TRUE(Matches(OIC_JSON_ACL_NAME, acl));
+    EXPECT_TRUE(Matches(OIC_JSON_CRED_NAME, cred));
+}
+
+/**
+ * Provisions credentials one by one on a device that already has a large ACL, and prints
+ * the time spent persisting them with and without the journal.
+ */
+TEST_F(PSInterfaceTest, BulkCredentialProvisioningTiming)
+{
+    const size_t credCount = 1000;
+    const size_t credSize = 64;
+    std::vector<uint8_t> acl = MakePayload(1, 64 * 1024);
+    std::vector<uint8_t> pstat = MakePayload(2, 128);
+    std::vector<uint8_t> doxm = MakePayload(3, 256);
+    std::vector<uint8_t> cred;
+
+    for (int journal = 0; journal < 2; journal++)
+    {
+        remove(PS_TEST_DB_FILE_NAME);
+        remove(PS_TEST_JOURNAL_FILE_NAME);
+        ASSERT_EQ(OC_STACK_OK, SetPSJournalEnabled(0 != journal));
+        ASSERT_EQ(OC_STACK_OK, Update(OIC_JSON_ACL_NAME, acl));
+        ASSERT_EQ(OC_STACK_OK, Update(OIC_JSON_PSTAT_NAME, pstat));
+        ASSERT_EQ(OC_STACK_OK, Update(OIC_JSON_DOXM_NAME, doxm));
+
+        auto start = std::chrono::steady_clock::now();
+        for (size_t i = 1; i <= credCount; i++)
+        {
+            cred = MakePayload((uint8_t)i, i * credSize);
+            ASSERT_EQ(OC_STACK_OK, Update(OIC_JSON_CRED_NAME, cred));
+        }
+        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+                           std::chrono::steady_clock::now() - start);
+
+        printf("Persisting %" PRIuPTR " creds %s the journal: %lld ms\n", credCount,
+               journal ? "with" : "without", (long long)elapsed.count());
+
+        DeInitPSJournal();
+        EXPECT_TRUE(Matches(OIC_JSON_ACL_NAME, acl));
+        EXPECT_TRUE(Matches(OIC_JSON_CRED_NAME, cred));
+    }
+}
+
+TEST_F(PSInterfaceTest, TransactionHoldsUpdates)
+{
+    std::vector<uint8_t> acl = MakePayload(1, 100);
+    std::vector<uint8_t> pstat1 = MakePayload(2, 50);
+    std::vector<uint8_t> pstat2 = MakePayload(3, 60);
+    std::vector<uint8_t> doxm = MakePayload(4, 70);
+
+    EXPECT_EQ(OC_STACK_OK, Update(OIC_JSON_ACL_NAME, acl));
+    EXPECT_EQ(OC_STACK_OK, Update(OIC_JSON_DOXM_NAME, doxm));
+    m_ps.open = CountingOpen;
+    g_fileWrites = 0;
+
+    EXPECT_EQ(OC_STACK_OK, BeginPSTransaction());
+    EXPECT_EQ(OC_STACK_OK, Update(OIC_JSON_PSTAT_NAME, pstat1));
+    EXPECT_EQ(OC_STACK_OK, BeginPSTransaction());
+    EXPECT_EQ(OC_STACK_OK, Update(OIC_JSON_PSTAT_NAME, pstat2));
+    EXPECT_EQ(OC_STACK_OK, Update(OIC_JSON_DOXM_NAME, std::vector<uint8_t>()));
+    EXPECT_EQ(OC_STACK_OK, CommitPSTransaction());
+
+    // Held updates are read back, and written by the outermost commit only.
+    EXPECT_TRUE(Matches(OIC_JSON_PSTAT_NAME, pstat2));
+    EXPECT_FALSE(Exists(OIC_JSON_DOXM_NAME));
+    EXPECT_EQ(0u, g_fileWrites);
+    EXPECT_EQ(OC_STACK_OK, CommitPSTransaction());
+    EXPECT_EQ(1u, g_fileWrites);
+    EXPECT_EQ(OC_STACK_ERROR, CommitPSTransaction());
+
+    EXPECT_TRUE(Matches(OIC_JSON_ACL_NAME, acl));
+    EXPECT_TRUE(Matches(OIC_JSON_PSTAT_NAME, pstat2));
+    EXPECT_FALSE(Exists(OIC_JSON_DOXM_NAME));
+}
+
+TEST_F(PSInterfaceTest, FailedCommitKeepsHeldUpdates)
+{
+    std::vector<uint8_t> acl = MakePayload(1, 100);
+    std::vector<uint8_t> pstat = MakePayload(2, 50);
+    std::vector<uint8_t> doxm = MakePayload(3, 70);
+
+    EXPECT_EQ(OC_STACK_OK, Update(OIC_JSON_ACL_NAME, acl));
+
+    EXPECT_EQ(OC_STACK_OK, BeginPSTransaction());
+    EXPECT_EQ(OC_STACK_OK, Update(OIC_JSON_PSTAT_NAME, pstat));
+    m_ps.open = ReadOnlyOpen;
+    EXPECT_NE(OC_STACK_OK, CommitPSTransaction());
+
+    // The update is still held, and written after it by the next update of the database.
+    EXPECT_TRUE(Matches(OIC_JSON_PSTAT_NAME, pstat));
+    EXPECT_NE(OC_STACK_OK, FlushPSTransaction(true));
+    m_ps.open = fopen;
+    EXPECT_EQ(OC_STACK_OK, Update(OIC_JSON_DOXM_NAME, doxm));
+    EXPECT_EQ(OC_STACK_OK, FlushPSTransaction(true));
+
+    EXPECT_TRUE(Matches(OIC_JSON_ACL_NAME, acl));
+    EXPECT_TRUE(Matches(OIC_JSON_PSTAT_NAME, pstat));
+    EXPECT_TRUE(Matches(OIC_JSON_DOXM_NAME, doxm));
+}
+
+TEST_F(PSInterfaceTest, TransactionAppendsOneJournalBatch)
+{
+    std::vector<uint8_t> acl = MakePayload(1, 100);
+    std::vector<uint8_t> pstat = MakePayload(2, 50);
+    std::vector<uint8_t> cred = MakePayload(3, 200);
+
+    ASSERT_EQ(OC_STACK_OK, SetPSJournalEnabled(true));
+    EXPECT_EQ(OC_STACK_OK, Update(OIC_JSON_ACL_NAME, acl));
+    m_ps.open = CountingOpen;
+    g_fileWrites = 0;
+
+    EXPECT_EQ(OC_STACK_OK, BeginPSTransaction());
+    EXPECT_EQ(OC_STACK_OK, Update(OIC_JSON_PSTAT_NAME, pstat));
+    EXPECT_EQ(OC_STACK_OK, Update(OIC_JSON_CRED_NAME, cred));
+    EXPECT_EQ(OC_STACK_OK, Update(OIC_JSON_ACL_NAME, std::vector<uint8_t>()));
+    EXPECT_EQ(OC_STACK_OK, FlushPSTransaction(false));
+    EXPECT_EQ(0u, g_fileWrites);
+    EXPECT_EQ(OC_STACK_OK, CommitPSTransaction());
+    EXPECT_EQ(1u, g_fileWrites);
+
+    DeInitPSJournal();
+    EXPECT_FALSE(Exists(OIC_JSON_ACL_NAME));
+    EXPECT_TRUE(Matches(OIC_JSON_PSTAT_NAME, pstat));
+    EXPECT_TRUE(Matches(OIC_JSON_CRED_NAME, cred));
+}
+
+/**
+ * Persists the SVR updates of an ownership transfer on a storage device that takes
+ * 10 ms to commit each write, and prints the time spent with and without a transaction.
+ */
+TEST_F(PSInterfaceTest, OnboardingLatencyOnSlowStorage)
+{
+    const struct
+    {
+        const char *name;
+        size_t size;
+    } updates[] =
+    {
+        { OIC_JSON_DOXM_NAME, 300 },    // oxmsel
+        { OIC_JSON_ACL_NAME, 2048 },    // default ACE for provisioning
+        { OIC_JSON_DOXM_NAME, 320 },    // devowneruuid
+        { OIC_JSON_CRED_NAME, 400 },    // owner credential
+        { OIC_JSON_DOXM_NAME, 330 },    // owned
+        { OIC_JSON_DOXM_NAME, 330 },    // rowneruuid
+        { OIC_JSON_PSTAT_NAME, 120 },   // rowneruuid
+        { OIC_JSON_ACL_NAME, 2100 },    // rowneruuid
+        { OIC_JSON_CRED_NAME, 420 },    // rowneruuid
+        { OIC_JSON_PSTAT_NAME, 120 },   // dos RFPRO
+        { OIC_JSON_PSTAT_NAME, 120 },   // cm, tm, isop
+        { OIC_JSON_ACL_NAME, 2200 },    // provisioning ACEs
+    };
+
+    EXPECT_EQ(OC_STACK_OK, Update(OIC_JSON_ACL_NAME, MakePayload(1, 2048)));
+    EXPECT_EQ(OC_STACK_OK, Update(OIC_JSON_PSTAT_NAME, MakePayload(2, 120)));
+    EXPECT_EQ(OC_STACK_OK, Update(OIC_JSON_DOXM_NAME, MakePayload(3, 300)));
+    m_ps.open = CountingOpen;
+    m_ps.write = SlowWrite;
+    g_writeDelay = std::chrono::milliseconds(10);
+
+    for (int transaction = 0; transaction < 2; transaction++)
+    {
+        g_fileWrites = 0;
+        auto start = std::chrono::steady_clock::now();
+        if (transaction)
+        {
+            ASSERT_EQ(OC_STACK_OK, BeginPSTransaction());
+        }
+        for (size_t i = 0; i < sizeof(updates) / sizeof(updates[0]); i++)
+        {
+            ASSERT_EQ(OC_STACK_OK, Update(updates[i].name, MakePayload((uint8_t)i, updates[i].size)));
+        }
+        if (transaction)
+        {
+            ASSERT_EQ(OC_STACK_OK, CommitPSTransaction());
+        }
+        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+                           std::chrono::steady_clock::now() - start);
+
+        printf("Onboarding %s a transaction: %" PRIuPTR " writes, %lld ms\n",
+               transaction ? "with" : "without", g_fileWrites, (long long)elapsed.count());
+        EXPECT_EQ(transaction ? 1u : sizeof(updates) / sizeof(updates[0]), g_fileWrites);
+    }
+    g_writeDelay = std::chrono::microseconds(0);
+
+    EXPECT_TRUE(Matches(OIC_JSON_ACL_NAME, MakePayload(11, 2200)));
+    EXPECT_TRUE(Matches(OIC_JSON_PSTAT_NAME, MakePayload(10, 120)));
+}
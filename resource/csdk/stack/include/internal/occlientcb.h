@@ -31,6 +31,7 @@
 #include "ocstack.h"
 #include "ocresource.h"
 #include "cacommon.h"
+#include "uthash.h"
 
 
 #ifdef __cplusplus
@@ -122,6 +123,9 @@ typedef struct ClientCB {
     /** The connectivity type on which the request was sent on.*/
     OCConnectivityType conType;
 
+    /** Representations are passed on encoded, see OCSetResponsePayloadEncoded.*/
+    bool encodedResponse;
+
     /** The TTL for this callback. Holds the time till when this callback can
      * still be used. TTL is set to 0 when the callback is for presence and observe.
      * Presence has ttl mechanism in the "presence" member of this struct and observes
@@ -130,12 +134,33 @@ typedef struct ClientCB {
 
     /** next node in this list.*/
     struct ClientCB    *next;
+
+    /** previous node in this list.*/
+    struct ClientCB    *prev;
+
+    /** next node in the list of callbacks with a TTL, which is sorted by TTL.*/
+    struct ClientCB    *timeoutNext;
+
+    /** previous node in the list of callbacks with a TTL.*/
+    struct ClientCB    *timeoutPrev;
+
+    /** Handle for the token index; the key is the token.*/
+    UT_hash_handle hh;
+
+    /** Handle for the invocation handle index; the key is handle.*/
+    UT_hash_handle hhHandle;
+
+#ifdef WITH_PRESENCE
+    /** Handle for the presence request uri index; the key is requestUri.*/
+    UT_hash_handle hhUri;
+#endif
 } ClientCB;
 
 //TODO: Now ocstack is directly accessing the clientCB list to process presence.
 //      It should be avoided after we make a presence feature separately.
 /**
- * Linked list of ClientCB node.
+ * Doubly linked list of ClientCB node.  Use DeleteClientCB() to remove nodes, it also keeps the
+ * token and handle indexes of the list up to date.
  */
 extern struct ClientCB *g_cbList;
 
@@ -189,6 +214,14 @@ OCStackResult AddClientCB(ClientCB** clientCB,
  */
 void DeleteClientCB(ClientCB *cbNode);
 
+/**
+ * This method is used to update the time to live of a cb node in cbList.
+ *
+ * @param[in]  cbNode               Address to client callback node.
+ * @param[in]  ttl                  New time to live in coap_ticks, 0 for no timeout.
+ */
+void UpdateClientCBTTL(ClientCB *cbNode, uint32_t ttl);
+
 /**
  * This method is used to clear the cbList.
  */
@@ -34,6 +34,39 @@ OCStackResult OCParsePayload(OCPayload** outPayload, OCPayloadFormat format, OCP
 OCStackResult OCConvertPayload(OCPayload* payload, OCPayloadFormat format,
         uint8_t** outPayload, size_t* size);
 
+/**
+ * Reference counted arena the payloads made with OCRepPayloadCreateInArena, and those
+ * parsed from CBOR, are allocated in. It starts with a copy of the encoded payload, if any,
+ * which byte strings of payloads parsed from it point into.
+ */
+typedef struct OCPayloadBuffer OCPayloadBuffer;
+
+/** Creates a buffer holding a copy of cborData, with a reference count of 1.*/
+OCPayloadBuffer* OCPayloadBufferCreate(const uint8_t* cborData, size_t size);
+OCPayloadBuffer* OCPayloadBufferRetain(OCPayloadBuffer* buffer);
+void OCPayloadBufferRelease(OCPayloadBuffer* buffer);
+
+/** Returns the copy of the encoded payload.*/
+const uint8_t* OCPayloadBufferGetData(const OCPayloadBuffer* buffer);
+
+/**
+ * Returns size bytes of zeroed memory held until the buffer is released, or NULL if size
+ * is 0 or memory runs out.
+ */
+void* OCPayloadBufferAlloc(OCPayloadBuffer* buffer, size_t size);
+
+/** Allocates like OICCalloc, from buffer if there is one.*/
+void* OCPayloadBufferCalloc(OCPayloadBuffer* buffer, size_t num, size_t size);
+
+/** Whether ptr points into the buffer and so must not be freed.*/
+bool OCPayloadBufferHolds(const OCPayloadBuffer* buffer, const void* ptr);
+
+/** Frees ptr with OICFree, unless it is held in buffer.*/
+void OCPayloadBufferFree(const OCPayloadBuffer* buffer, void* ptr);
+
+/** Creates a payload in buffer, or on the heap if buffer is NULL.*/
+OCRepPayload* OCRepPayloadCreateInBuffer(OCPayloadBuffer* buffer);
+
 #ifdef __cplusplus
 }
 #endif
@@ -32,6 +32,7 @@
 #include "ocstackconfig.h"
 #include "occlientcb.h"
 #include "ocobserve.h"
+#include "uthash.h"
 
 /** Macro Definitions for observers */
 
@@ -250,8 +251,37 @@ typedef struct OCResource {
 
     /** Resource endpoint type(s). */
     OCTpsSchemeFlags endpointType;
+
+    /** Handle for the URI keyed resource index; the key is uri.*/
+    UT_hash_handle hh;
 } OCResource;
 
+/**
+ * Entry of a secondary resource index bucket; one entry per resource in the bucket.
+ */
+typedef struct OCResourceIndexEntry {
+    /** Indexed resource; also the key of the entry.*/
+    OCResource *resource;
+
+    /** Handle for the bucket's resource table; iteration follows insertion order.*/
+    UT_hash_handle hh;
+} OCResourceIndexEntry;
+
+/**
+ * Bucket of a secondary resource index, i.e. all of the resources which are bound to the
+ * resource type or resource interface given by name.
+ */
+typedef struct OCResourceIndexBucket {
+    /** Resource type or resource interface name; the key of the bucket.*/
+    char *name;
+
+    /** Resources bound to name.*/
+    OCResourceIndexEntry *entries;
+
+    /** Handle for the index the bucket belongs to.*/
+    UT_hash_handle hh;
+} OCResourceIndexBucket;
+
 /**
  * Checks if an observation Id already exists among the resources.
  *
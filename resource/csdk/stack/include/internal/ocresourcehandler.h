@@ -213,6 +213,15 @@ void DeletePlatformInfo();
  */
 void DeleteDeviceInfo();
 
+/**
+ * Internal API used to drop cached /oic/res responses after a resource changes.
+ * Must be called with the state of the resource before a change that can remove it from a
+ * response, and with its state after a change that can add it to a response.
+ *
+ * @param resource  Resource that changes, or NULL to drop every cached response.
+ */
+void InvalidateDiscoveryCache(const OCResource *resource);
+
 /*
  * Prepare payload for resource representation.
  */
@@ -46,6 +46,40 @@ extern "C"
  */
 typedef OCStackResult (* OCEHResponseHandler)(OCEntityHandlerResponse * ehResponse);
 
+/**
+ * Response to a notification, kept so that it can be sent to other observers asking for
+ * the same representation without calling the entity handler and encoding the payload again.
+ */
+typedef struct OCNotificationResponse
+{
+    /** True once the response of a notification was kept.*/
+    bool captured;
+
+    /** Result of the response.*/
+    CAResponseResult_t result;
+
+    /** Number of header options, the observe option excluded.*/
+    uint8_t numOptions;
+
+    /** Header options of the response, the observe option excluded.*/
+    CAHeaderOption_t *options;
+
+    /** Encoded payload of the response.*/
+    CAPayload_t payload;
+
+    /** Size of the encoded payload.*/
+    size_t payloadSize;
+
+    /** Format of the encoded payload.*/
+    CAPayloadFormat_t payloadFormat;
+
+    /** Content version of the encoded payload.*/
+    uint16_t payloadVersion;
+
+    /** Requests whose response is to be kept here, see ::AttachNotificationResponse.*/
+    struct OCServerRequest *requests;
+} OCNotificationResponse;
+
 /**
  * following structure will be created in occoap and passed up the stack on the server side.
  */
@@ -124,6 +158,13 @@ typedef struct OCServerRequest
     /** Payload Size.*/
     size_t payloadSize;
 
+    /** Where to keep the response of a notification, NULL if it is not kept.*/
+    OCNotificationResponse *notificationResponse;
+
+    /** Links of the requests of the same notificationResponse.*/
+    struct OCServerRequest *notificationPrev;
+    struct OCServerRequest *notificationNext;
+
     /** payload is retrieved from the payload of the received request PDU.*/
     uint8_t payload[1];
 
@@ -227,6 +268,45 @@ void DeleteServerRequest(OCServerRequest * serverRequest);
  */
 OCStackResult HandleSingleResponse(OCEntityHandlerResponse * ehResponse);
 
+/**
+ * Send a kept notification response to an observer.
+ *
+ * @param[in]  response         Response kept by ::HandleSingleResponse.
+ * @param[in]  devAddr          Device address of the observer.
+ * @param[in]  resourceUri      URI of the observed resource.
+ * @param[in]  token            Token of the observer.
+ * @param[in]  tokenLength      Length of token.
+ * @param[in]  sequenceNum      Observe sequence number of the notification.
+ * @param[in]  qos              Quality of service of the notification.
+ *
+ * @return
+ *     ::OCStackResult
+ */
+OCStackResult SendNotificationResponse(const OCNotificationResponse *response,
+                                       const OCDevAddr *devAddr,
+                                       const char *resourceUri,
+                                       const CAToken_t token,
+                                       uint8_t tokenLength,
+                                       uint32_t sequenceNum,
+                                       OCQualityOfService qos);
+
+/**
+ * Keep the response of a notification request in the given response once it is sent.
+ * The request is detached again when it is deleted or the response is cleared.
+ *
+ * @param[in]  request          Request of the notification.
+ * @param[in]  response         Where to keep the response.
+ */
+void AttachNotificationResponse(OCServerRequest *request, OCNotificationResponse *response);
+
+/**
+ * Free the options and payload of a kept notification response, and detach the requests
+ * which would still keep their response in it.
+ *
+ * @param[in]  response         Response kept by ::HandleSingleResponse.
+ */
+void ClearNotificationResponse(OCNotificationResponse *response);
+
 /**
  * Handler function for sending a response from multiple resources, such as a collection.
  * Aggregates responses from multiple resource until all responses are received then sends the
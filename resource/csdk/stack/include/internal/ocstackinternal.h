@@ -299,6 +299,33 @@ void CopyDevAddrToEndpoint(const OCDevAddr *in, CAEndpoint_t *out);
  */
 uint32_t GetTicks(uint32_t milliSeconds);
 
+/**
+ * Get the resource at the specified URI from the URI index of the resource list.
+ *
+ * @param uri URI of the resource.
+ *
+ * @return Pointer to the resource if found, NULL otherwise.
+ */
+OCResource *GetResourceFromUriIndex(const char *uri);
+
+/**
+ * Get the bucket of all resources bound to the specified resource type.
+ *
+ * @param resourceTypeName Resource type name.
+ *
+ * @return Pointer to the bucket if any resource has this type, NULL otherwise.
+ */
+OCResourceIndexBucket *GetResourceTypeIndexBucket(const char *resourceTypeName);
+
+/**
+ * Get the bucket of all resources bound to the specified resource interface.
+ *
+ * @param resourceInterfaceName Resource interface name.
+ *
+ * @return Pointer to the bucket if any resource has this interface, NULL otherwise.
+ */
+OCResourceIndexBucket *GetResourceInterfaceIndexBucket(const char *resourceInterfaceName);
+
 /**
  * Extract interface and resource type from the query.
  *
@@ -324,6 +351,13 @@ OCStackResult OCUpdateResourceInsWithResponse(const char *requestUri,
                                               const OCClientResponse *response);
 #endif
 
+#ifdef RD_SERVER
+/**
+ * Close the RD database connection kept open between discovery queries.
+ */
+void CloseRDDatabaseDiscovery();
+#endif
+
 /**
  * Delete all of the dynamically allocated elements that were created for the resource attributes.
  *
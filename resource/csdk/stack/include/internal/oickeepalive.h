@@ -71,6 +71,13 @@ OCStackResult TerminateKeepAlive(OCMode mode);
  */
 void ProcessKeepAlive();
 
+/**
+ * Time until ProcessKeepAlive next has a ping to send or a connection to close.
+ * @return  time in microseconds, 0 if ProcessKeepAlive has work now,
+ *          UINT64_MAX if there is no KeepAlive connection.
+ */
+uint64_t GetKeepAliveWaitTime();
+
 /**
  * This API will be called from RI layer whenever there is a request for KeepAlive.
  * Virtual Resource.
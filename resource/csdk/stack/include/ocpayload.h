@@ -86,10 +86,27 @@ void OC_CALL OCPayloadDestroy(OCPayload* payload);
 // Representation Payload
 OCRepPayload* OC_CALL OCRepPayloadCreate();
 
+/**
+ * Creates a payload in an arena. The payload and its values, names, strings and arrays are
+ * allocated from blocks shared by all payloads of the arena, which are freed together
+ * once the last of them is destroyed. The payload is used like any other. Memory of values
+ * replaced on it is only given back with the arena, so arenas suit payloads built, sent or
+ * read, and destroyed, as those of requests and responses, rather than long lived ones.
+ * Payloads parsed by the stack are in arenas.
+ *
+ * @param owner Payload whose arena to create the payload in, such as the parent of a
+ *              nested payload, or NULL for a new arena.
+ * @return The payload, destroyed with OCRepPayloadDestroy as usual.
+ */
+OCRepPayload* OC_CALL OCRepPayloadCreateInArena(const OCRepPayload* owner);
+
 size_t OC_CALL calcDimTotal(const size_t dimensions[MAX_REP_ARRAY_DEPTH]);
 
 OCRepPayload* OC_CALL OCRepPayloadClone(const OCRepPayload* payload);
 
+/** Clones payload into a new arena, see OCRepPayloadCreateInArena.*/
+OCRepPayload* OC_CALL OCRepPayloadCloneInArena(const OCRepPayload* payload);
+
 OCRepPayload* OC_CALL OCRepPayloadBatchClone(const OCRepPayload* repPayload);
 
 void OC_CALL OCRepPayloadAppend(OCRepPayload* parent, OCRepPayload* child);
@@ -254,6 +271,53 @@ OCIntrospectionPayload* OC_CALL OCIntrospectionPayloadCreateFromCbor(const uint8
                                                              size_t size);
 void OC_CALL OCIntrospectionPayloadDestroy(OCIntrospectionPayload* payload);
 
+// Encoded Representation Payload
+OCEncodedRepPayload* OC_CALL OCEncodedRepPayloadCreate(const uint8_t* cborData, size_t size);
+
+/**
+ * Creates an encoded representation payload that takes ownership of cborData, which must
+ * have been allocated with OICMalloc.
+ */
+OCEncodedRepPayload* OC_CALL OCEncodedRepPayloadCreateAsOwner(uint8_t* cborData, size_t size);
+void OC_CALL OCEncodedRepPayloadDestroy(OCEncodedRepPayload* payload);
+
+/**
+ * Parses an encoded representation into a view. Names, strings and byte strings of the
+ * view point into one retained copy of the CBOR instead of being allocated one by one, the
+ * view does not depend on payload after it is made. The view is an OCRepPayload like any
+ * other: getters return copies, setters replace values, and OCRepPayloadDestroy releases the
+ * copy once the last payload parsed out of it is destroyed.
+ *
+ * @param payload The encoded representation.
+ * @return The parsed view, or NULL if payload is malformed or memory runs out.
+ */
+OCRepPayload* OC_CALL OCEncodedRepPayloadParseView(const OCEncodedRepPayload* payload);
+
+/** Iterator over the elements of an array property of an encoded representation.*/
+typedef struct OCRepPayloadArrayIter OCRepPayloadArrayIter;
+
+/**
+ * Starts iterating the array property name of the first representation in payload, parsing
+ * one element at a time so that large arrays are never parsed whole. payload must outlive
+ * the iterator.
+ *
+ * @param payload The encoded representation.
+ * @param name Name of the array property.
+ * @return The iterator, or NULL if there is no array property name.
+ */
+OCRepPayloadArrayIter* OC_CALL OCEncodedRepPayloadGetArrayIter(const OCEncodedRepPayload* payload,
+        const char* name);
+
+/**
+ * Parses the next element of the array.
+ *
+ * @param iter The iterator.
+ * @return The element, valid until the next call or until the iterator is destroyed, or
+ *         NULL at the end of the array or on a malformed element.
+ */
+const OCRepPayloadValue* OC_CALL OCRepPayloadArrayIterNext(OCRepPayloadArrayIter* iter);
+void OC_CALL OCRepPayloadArrayIterDestroy(OCRepPayloadArrayIter* iter);
+
 #ifndef TCP_ADAPTER
 void OC_CALL OCDiscoveryPayloadAddResource(OCDiscoveryPayload* payload, const OCResource* res,
                                    uint16_t securePort);
@@ -122,6 +122,18 @@ OCStackResult OC_CALL OCStartMulticastServer();
  */
 OCStackResult OC_CALL OCStopMulticastServer();
 
+/**
+ * This function gets the hit and miss counts of the cache of encoded /oic/res responses.
+ * A response is cached per combination of query filters, accept format and requesting
+ * endpoint, and is dropped when a resource it lists (or would list) changes.
+ *
+ * @param hits      Number of /oic/res requests answered from the cache.
+ * @param misses    Number of /oic/res requests whose response had to be built.
+ *
+ * @return ::OC_STACK_OK on success, ::OC_STACK_INVALID_PARAM if either pointer is NULL.
+ */
+OCStackResult OC_CALL OCGetDiscoveryCacheStats(uint32_t *hits, uint32_t *misses);
+
 /**
  * This function is Called in main loop of OC client or server.
  * Allows low-level processing of stack services.
@@ -130,6 +142,24 @@ OCStackResult OC_CALL OCStopMulticastServer();
  */
 OCStackResult OC_CALL OCProcess();
 
+/**
+ * This function blocks until OCProcess has work to do: a received request or
+ * response, a presence or keepalive timeout, or the given timeout.
+ * It does not process anything itself, so call OCProcess after it returns.
+ * Use it in place of sleeping between OCProcess calls.
+ *
+ * @param timeoutMs     Longest time to wait in milliseconds. 0 returns at once.
+ *
+ * @return ::OC_STACK_OK on success, some other value upon failure.
+ */
+OCStackResult OC_CALL OCProcessWait(uint32_t timeoutMs);
+
+/**
+ * This function makes a thread blocked in OCProcessWait return early, e.g. so
+ * it can notice that its main loop should stop.
+ */
+void OC_CALL OCCancelProcessWait();
+
 /**
  * This function discovers or Perform requests on a specified resource
  * (specified by that Resource's respective URI).
@@ -222,6 +252,20 @@ OCStackResult OC_CALL OCDoRequest(OCDoHandle *handle,
                           OCHeaderOption *options,
                           uint8_t numOptions);
 
+/**
+ * This function makes the responses of a request arrive as an OCEncodedRepPayload, holding
+ * the CBOR as received, in place of a parsed OCRepPayload. Other payload types are parsed
+ * as before. Call it before the next OCProcess, i.e. right after OCDoResource while still
+ * holding the lock that serializes calls into the stack. Requests to the batch interface
+ * keep receiving parsed representations.
+ *
+ * @param handle       Used to identify a specific OCDoResource invocation.
+ * @param encoded      true to receive representations encoded.
+ *
+ * @return ::OC_STACK_OK on success, some other value upon failure.
+ */
+OCStackResult OC_CALL OCSetResponsePayloadEncoded(OCDoHandle handle, bool encoded);
+
 /**
  * This function cancels a request associated with a specific @ref OCDoResource invocation.
  *
@@ -248,6 +292,25 @@ OCStackResult OC_CALL OCCancel(OCDoHandle handle,
  */
 OCStackResult OC_CALL OCRegisterPersistentStorageHandler(OCPersistentStorage* persistentStorageHandler);
 
+/**
+ * Select how the security and device properties databases are kept in persistent storage.
+ *
+ * By default each update of a secure resource rewrites its whole database. With the journal
+ * enabled, each update is appended to a journal file next to the database, named after it with
+ * a ".jnl" suffix, which is periodically compacted into the database. Existing databases are
+ * migrated on first use, and disabling the journal folds it back into the databases.
+ *
+ * @note The persistent storage handler must open each file name as its own file, and support
+ *       the "ab" mode.
+ *
+ * @param   enable  true to keep the databases with a journal, false to rewrite them.
+ *
+ * @return
+ *     OC_STACK_OK                    No errors; Success.
+ *     OC_STACK_ERROR                 A journal could not be folded back into its database.
+ */
+OCStackResult OC_CALL OCSetPersistentStorageJournal(bool enable);
+
 #ifdef WITH_PRESENCE
 /**
  * When operating in  OCServer or  OCClientServer mode,
@@ -20,6 +20,7 @@
 
 #include "iotivity_config.h"
 #include "occlientcb.h"
+#include "utlist.h"
 #include <coap/coap.h>
 #include "experimental/logger.h"
 #include "trace.h"
@@ -46,6 +47,20 @@
 //      This should be static variable after we make a presence feature separately.
 struct ClientCB *g_cbList = NULL;
 
+/// Callbacks of g_cbList keyed by token.
+static ClientCB *g_cbTokenIndex = NULL;
+
+/// Callbacks of g_cbList keyed by invocation handle.
+static ClientCB *g_cbHandleIndex = NULL;
+
+#ifdef WITH_PRESENCE
+/// Presence callbacks of g_cbList keyed by request uri.
+static ClientCB *g_cbPresenceUriIndex = NULL;
+#endif
+
+/// Callbacks of g_cbList with a TTL, sorted by TTL so that timed-out callbacks are at the head.
+static ClientCB *g_cbTimeoutList = NULL;
+
 //-------------------------------------------------------------------------------------------------
 // Local functions
 //-------------------------------------------------------------------------------------------------
@@ -59,7 +74,20 @@ static void DeleteClientCBInternal(ClientCB * cbNode)
     OIC_TRACE_BUFFER("OIC_RI_CLIENTCB:DeleteClientCB:token:",
                      (const uint8_t *)cbNode->token, cbNode->tokenLength);
 
-    LL_DELETE(g_cbList, cbNode);
+    DL_DELETE(g_cbList, cbNode);
+    HASH_DELETE(hh, g_cbTokenIndex, cbNode);
+    HASH_DELETE(hhHandle, g_cbHandleIndex, cbNode);
+#ifdef WITH_PRESENCE
+    // Only presence callbacks with a URI are in the URI index, see AddClientCB()
+    if (cbNode->method == OC_REST_PRESENCE && cbNode->requestUri)
+    {
+        HASH_DELETE(hhUri, g_cbPresenceUriIndex, cbNode);
+    }
+#endif
+    if (cbNode->TTL)
+    {
+        DL_DELETE2(g_cbTimeoutList, cbNode, timeoutPrev, timeoutNext);
+    }
     CADestroyToken(cbNode->token);
     OICFree(cbNode->devAddr);
     OICFree(cbNode->handle);
@@ -109,13 +137,11 @@ static void DeleteClientCBInternal(ClientCB * cbNode)
 }
 
 /*
- * This function checks if the node is past its time to live and
- * deletes it if timed-out. Calling this function with a  presence or observe
- * callback with ttl set to 0 will not delete anything as presence nodes have
- * their own mechanisms for timeouts. A null argument will cause the function to
- * silently return.
+ * This function inserts the node into the list of callbacks with a TTL, keeping the list
+ * sorted by TTL. Presence and observe callbacks with ttl set to 0 are not inserted as
+ * presence nodes have their own mechanisms for timeouts.
  */
-static void CheckAndDeleteTimedOutCB(ClientCB * cbNode)
+static void InsertTimeoutCB(ClientCB * cbNode)
 {
     assert(cbNode);
 
@@ -123,13 +149,45 @@ static void CheckAndDeleteTimedOutCB(ClientCB * cbNode)
     {
         return;
     }
+
+    // Callbacks are mostly added with a TTL at a fixed offset from now, so the
+    // insertion point is found by walking back from the tail.
+    ClientCB *pos = g_cbTimeoutList ? g_cbTimeoutList->timeoutPrev : NULL;
+    while (pos && pos->TTL > cbNode->TTL)
+    {
+        pos = (pos == g_cbTimeoutList) ? NULL : pos->timeoutPrev;
+    }
+
+    if (pos)
+    {
+        DL_APPEND_ELEM2(g_cbTimeoutList, pos, cbNode, timeoutPrev, timeoutNext);
+    }
+    else
+    {
+        DL_PREPEND2(g_cbTimeoutList, cbNode, timeoutPrev, timeoutNext);
+    }
+}
+
+/*
+ * This function deletes the nodes which are past their time to live, except for
+ * keepNode which the caller is still using. As the timeout list is sorted by TTL only
+ * the timed-out nodes at its head are visited.
+ */
+static void DeleteTimedOutCBs(const ClientCB * keepNode)
+{
     coap_tick_t now;
     coap_ticks(&now);
 
-    if (cbNode->TTL < now)
+    ClientCB *cbNode = g_cbTimeoutList;
+    while (cbNode && cbNode->TTL < now)
     {
-        OIC_LOG(INFO, TAG, "Deleting timed-out callback");
-        DeleteClientCBInternal(cbNode);
+        ClientCB *next = cbNode->timeoutNext;
+        if (cbNode != keepNode)
+        {
+            OIC_LOG(INFO, TAG, "Deleting timed-out callback");
+            DeleteClientCBInternal(cbNode);
+        }
+        cbNode = next;
     }
 }
 
@@ -190,7 +248,7 @@ OCStackResult AddClientCB(ClientCB** clientCB, OCCallbackData* cbData,
     if (!cbNode)// If it does not already exist, create new node.
 #endif // WITH_PRESENCE
     {
-        cbNode = (ClientCB*) OICMalloc(sizeof(ClientCB));
+        cbNode = (ClientCB*) OICCalloc(1, sizeof(ClientCB));
         if (!cbNode)
         {
             *clientCB = NULL;
@@ -275,7 +333,17 @@ OCStackResult AddClientCB(ClientCB** clientCB, OCCallbackData* cbData,
         cbNode->devAddr = devAddr;          // I own it now
         OIC_LOG_V(INFO, TAG, "Added Callback for uri : %s", requestUri);
         OIC_TRACE_MARK(%s:AddClientCB:uri:%s, TAG, requestUri);
-        LL_APPEND(g_cbList, cbNode);
+        DL_APPEND(g_cbList, cbNode);
+        HASH_ADD_KEYPTR(hh, g_cbTokenIndex, cbNode->token, cbNode->tokenLength, cbNode);
+        HASH_ADD(hhHandle, g_cbHandleIndex, handle, sizeof(cbNode->handle), cbNode);
+#ifdef WITH_PRESENCE
+        if (method == OC_REST_PRESENCE && requestUri)
+        {
+            HASH_ADD_KEYPTR(hhUri, g_cbPresenceUriIndex, cbNode->requestUri,
+                            strlen(cbNode->requestUri), cbNode);
+        }
+#endif
+        InsertTimeoutCB(cbNode);
         *clientCB = cbNode;
     }
 #ifdef WITH_PRESENCE
@@ -325,27 +393,44 @@ void DeleteClientCB(ClientCB * cbNode)
     if (cbNode)
     {
         ClientCB* out = NULL;
-        ClientCB* tmp = NULL;
-        LL_FOREACH_SAFE(g_cbList, out, tmp)
+        HASH_FIND(hhHandle, g_cbHandleIndex, &cbNode->handle, sizeof(cbNode->handle), out);
+        if (cbNode == out)
         {
-            if (cbNode == out)
-            {
-                DeleteClientCBInternal(out);
-                break;
-            }
+            DeleteClientCBInternal(out);
         }
     }
 }
 
+void UpdateClientCBTTL(ClientCB *cbNode, uint32_t ttl)
+{
+    if (!cbNode)
+    {
+        return;
+    }
+
+    if (cbNode->TTL)
+    {
+        DL_DELETE2(g_cbTimeoutList, cbNode, timeoutPrev, timeoutNext);
+    }
+    cbNode->TTL = ttl;
+    InsertTimeoutCB(cbNode);
+}
+
 void DeleteClientCBList()
 {
     ClientCB* out = NULL;
     ClientCB* tmp = NULL;
-    LL_FOREACH_SAFE(g_cbList, out, tmp)
+    DL_FOREACH_SAFE(g_cbList, out, tmp)
     {
         DeleteClientCBInternal(out);
     }
     g_cbList = NULL;
+    g_cbTokenIndex = NULL;
+    g_cbHandleIndex = NULL;
+#ifdef WITH_PRESENCE
+    g_cbPresenceUriIndex = NULL;
+#endif
+    g_cbTimeoutList = NULL;
 }
 
 ClientCB* GetClientCBUsingToken(const CAToken_t token,
@@ -361,17 +446,12 @@ ClientCB* GetClientCBUsingToken(const CAToken_t token,
     OIC_LOG_BUFFER(INFO, TAG, (const uint8_t *)token, tokenLength);
 
     ClientCB* out = NULL;
-    ClientCB* tmp = NULL;
-    LL_FOREACH_SAFE(g_cbList, out, tmp)
+    HASH_FIND(hh, g_cbTokenIndex, token, tokenLength, out);
+    DeleteTimedOutCBs(out);
+    if (out)
     {
-        /* de-annotate below line if want to see all token in g_cbList */
-        //OIC_LOG_BUFFER(INFO, TAG, (const uint8_t *)out->token, tokenLength);
-        if (memcmp(out->token, token, tokenLength) == 0)
-        {
-            OIC_LOG(INFO, TAG, "Found in callback list");
-            return out;
-        }
-        CheckAndDeleteTimedOutCB(out);
+        OIC_LOG(INFO, TAG, "Found in callback list");
+        return out;
     }
 
     OIC_LOG(INFO, TAG, "Callback Not found!");
@@ -389,15 +469,12 @@ ClientCB* GetClientCBUsingHandle(const OCDoHandle handle)
     OIC_LOG(INFO, TAG,  "Looking for handle");
 
     ClientCB* out = NULL;
-    ClientCB* tmp = NULL;
-    LL_FOREACH_SAFE(g_cbList, out, tmp)
+    HASH_FIND(hhHandle, g_cbHandleIndex, &handle, sizeof(handle), out);
+    DeleteTimedOutCBs(out);
+    if (out)
     {
-        if (out->handle == handle)
-        {
-            OIC_LOG(INFO, TAG, "Found in callback list");
-            return out;
-        }
-        CheckAndDeleteTimedOutCB(out);
+        OIC_LOG(INFO, TAG, "Found in callback list");
+        return out;
     }
 
     OIC_LOG(INFO, TAG, "Callback Not found!");
@@ -416,17 +493,12 @@ ClientCB* GetClientCBUsingUri(const char *requestUri)
     OIC_LOG_V(INFO, TAG, "Looking for uri %s", requestUri);
 
     ClientCB* out = NULL;
-    ClientCB* tmp = NULL;
-    LL_FOREACH_SAFE(g_cbList, out, tmp)
+    HASH_FIND(hhUri, g_cbPresenceUriIndex, requestUri, strlen(requestUri), out);
+    DeleteTimedOutCBs(out);
+    if (out)
     {
-        /* de-annotate below line if want to see all uri in g_cbList */
-        //OIC_LOG_V(INFO, TAG, "%s", out->requestUri);
-        if (out->requestUri && strcmp(out->requestUri, requestUri ) == 0)
-        {
-            OIC_LOG(INFO, TAG, "Found in callback list");
-            return out;
-        }
-        CheckAndDeleteTimedOutCB(out);
+        OIC_LOG(INFO, TAG, "Found in callback list");
+        return out;
     }
 
     OIC_LOG(INFO, TAG, "Callback Not found!");
@@ -95,17 +95,99 @@ static OCQualityOfService DetermineObserverQoS(OCMethod method,
     return decidedQoS;
 }
 
+/**
+ * Observers of a resource asking for the same representation. The entity handler is
+ * called once for the group, and its response is sent to every observer of the group.
+ */
+typedef struct NotificationGroup
+{
+    /** Query of the observers.*/
+    char *query;
+
+    /** Accept format of the observers.*/
+    OCPayloadFormat acceptFormat;
+
+    /** Accept version of the observers.*/
+    uint16_t acceptVersion;
+
+    /** Response kept from the first notification of the group.*/
+    OCNotificationResponse response;
+
+    struct NotificationGroup *next;
+} NotificationGroup;
+
+/**
+ * Find the notification group of an observer, or add one if there is none yet.
+ *
+ * @param groups Notification groups of the resource.
+ * @param observer Observer that need to be notified.
+ *
+ * @return the group of the observer, NULL if there is no memory for a new group.
+ */
+static NotificationGroup *GetNotificationGroup(NotificationGroup **groups,
+                                               const ResourceObserver *observer)
+{
+    NotificationGroup *group = NULL;
+    LL_FOREACH(*groups, group)
+    {
+        if (group->acceptFormat == observer->acceptFormat
+            && group->acceptVersion == observer->acceptVersion
+            && ((!group->query && !observer->query)
+                || (group->query && observer->query
+                    && 0 == strcmp(group->query, observer->query))))
+        {
+            return group;
+        }
+    }
+
+    group = (NotificationGroup *)OICCalloc(1, sizeof(NotificationGroup));
+    if (!group)
+    {
+        OIC_LOG(ERROR, TAG, "Failed to allocate notification group");
+        return NULL;
+    }
+    if (observer->query)
+    {
+        group->query = OICStrdup(observer->query);
+        if (!group->query)
+        {
+            OIC_LOG(ERROR, TAG, "Failed to allocate notification group");
+            OICFree(group);
+            return NULL;
+        }
+    }
+    group->acceptFormat = observer->acceptFormat;
+    group->acceptVersion = observer->acceptVersion;
+    LL_PREPEND(*groups, group);
+    return group;
+}
+
+static void DeleteNotificationGroups(NotificationGroup *groups)
+{
+    NotificationGroup *group = NULL;
+    NotificationGroup *tmp = NULL;
+    LL_FOREACH_SAFE(groups, group, tmp)
+    {
+        LL_DELETE(groups, group);
+        ClearNotificationResponse(&group->response);
+        OICFree(group->query);
+        OICFree(group);
+    }
+}
+
 /**
  * Create a get request and pass to entityhandler to notify specific observer.
  *
  * @param observer Observer that need to be notified.
  * @param qos Quality of service of resource.
+ * @param notificationResponse Where to keep the response for other observers, may be NULL.
  *
  * @return ::OC_STACK_OK on success, some other value upon failure.
  */
 static OCStackResult SendObserveNotification(ResourceObserver *observer,
                                              uint32_t sequenceNum,
-                                             OCQualityOfService qos)
+                                             OCQualityOfService qos,
+                                             OCNotificationResponse *notificationResponse)
 {
     OCStackResult result = OC_STACK_ERROR;
     OCServerRequest * request = NULL;
@@ -120,6 +202,7 @@ static OCStackResult SendObserveNotification(ResourceObserver *observer,
     if (request)
     {
         request->observeResult = OC_STACK_OK;
+        AttachNotificationResponse(request, notificationResponse);
         if (result == OC_STACK_OK)
         {
             ResourceHandling resHandling = OC_RESOURCE_VIRTUAL;
@@ -137,6 +220,35 @@ static OCStackResult SendObserveNotification(ResourceObserver *observer,
     return result;
 }
 
+/**
+ * Notify an observer, with the response kept for its group if there is one.
+ *
+ * @param groups Notification groups of the resource.
+ * @param observer Observer that need to be notified.
+ * @param qos Quality of service of resource.
+ *
+ * @return ::OC_STACK_OK on success, some other value upon failure.
+ */
+static OCStackResult NotifyObserver(NotificationGroup **groups,
+                                    ResourceObserver *observer,
+                                    uint32_t sequenceNum,
+                                    OCQualityOfService qos)
+{
+    NotificationGroup *group = GetNotificationGroup(groups, observer);
+    if (!group || !group->response.captured)
+    {
+        return SendObserveNotification(observer, sequenceNum, qos,
+                                       group ? &group->response : NULL);
+    }
+
+    OCStackResult result = SendNotificationResponse(&group->response, &observer->devAddr,
+                                                    observer->resUri, observer->token,
+                                                    observer->tokenLength, sequenceNum, qos);
+    // Reset Observer TTL.
+    observer->TTL = GetTicks(MAX_OBSERVER_TTL_SECONDS * MILLISECONDS_PER_SECOND);
+    return result;
+}
+
 #ifdef WITH_PRESENCE
 OCStackResult SendAllObserverNotification (OCMethod method, OCResource *resPtr, uint32_t maxAge,
         OCPresenceTrigger trigger, OCResourceType *resourceType, OCQualityOfService qos)
@@ -159,6 +271,7 @@ OCStackResult SendAllObserverNotification (OCMethod method, OCResource *resPtr,
     OCStackResult result = OC_STACK_ERROR;
     ResourceObserver * resourceObserver = resPtr->observersHead;
     OCServerRequest * request = NULL;
+    NotificationGroup *groups = NULL;
     bool observeErrorFlag = false;
 
     // Find clients that are observing this resource
@@ -169,7 +282,7 @@ OCStackResult SendAllObserverNotification (OCMethod method, OCResource *resPtr,
         {
 #endif
             qos = DetermineObserverQoS(method, resourceObserver, qos);
-            result = SendObserveNotification(resourceObserver, resPtr->sequenceNum, qos);
+            result = NotifyObserver(&groups, resourceObserver, resPtr->sequenceNum, qos);
 #ifdef WITH_PRESENCE
         }
         else
@@ -220,6 +333,7 @@ OCStackResult SendAllObserverNotification (OCMethod method, OCResource *resPtr,
 
         resourceObserver = resourceObserver->next;
     }
+    DeleteNotificationGroups(groups);
 
     if (observeErrorFlag)
     {
@@ -449,7 +563,7 @@ static void CheckTimedOutObserver(ResourceObserver* observer, OCResource *resour
     {
         // Send confirmable notification message to observer.
         OIC_LOG(INFO, TAG, "Sending High-QoS notification to observer");
-        SendObserveNotification(observer, resource->sequenceNum, OC_HIGH_QOS);
+        SendObserveNotification(observer, resource->sequenceNum, OC_HIGH_QOS, NULL);
     }
 }
 
@@ -29,6 +29,8 @@
 #include <string.h>
 #include "oic_malloc.h"
 #include "oic_string.h"
+#include "ocatomic.h"
+#include "ocpayloadcbor.h"
 #include "ocstackinternal.h"
 #include "ocresource.h"
 #include "experimental/logger.h"
@@ -40,7 +42,7 @@
 #define CSV_SEPARATOR ','
 #define MASK_SECURE_FAMS (OC_FLAG_SECURE | OC_MASK_FAMS)
 
-static void OCFreeRepPayloadValueContents(OCRepPayloadValue* val);
+static void OCFreeRepPayloadValueContents(const OCPayloadBuffer* buffer, OCRepPayloadValue* val);
 
 void OC_CALL OCPayloadDestroy(OCPayload* payload)
 {
@@ -69,6 +71,9 @@ void OC_CALL OCPayloadDestroy(OCPayload* payload)
         case PAYLOAD_TYPE_INTROSPECTION:
             OCIntrospectionPayloadDestroy((OCIntrospectionPayload*)payload);
             break;
+        case PAYLOAD_TYPE_ENCODED_REPRESENTATION:
+            OCEncodedRepPayloadDestroy((OCEncodedRepPayload*)payload);
+            break;
         default:
             OIC_LOG_V(ERROR, TAG, "Unsupported payload type in destroy: %d", payload->type);
             OICFree(payload);
@@ -76,6 +81,222 @@ void OC_CALL OCPayloadDestroy(OCPayload* payload)
     }
 }
 
+/** Smallest block an arena allocates.*/
+#define PAYLOAD_BUFFER_BLOCK_SIZE 512
+/** Alignment of the memory handed out of an arena, enough for any value of a payload.*/
+#define PAYLOAD_BUFFER_ALIGNMENT 8
+
+typedef struct OCPayloadBufferBlock
+{
+    struct OCPayloadBufferBlock* next;
+    size_t capacity;
+    size_t used;
+    uint8_t bytes[];
+} OCPayloadBufferBlock;
+
+struct OCPayloadBuffer
+{
+    volatile int32_t refCount;
+    /** Blocks, the one allocated from first. Memory is never handed back to a block.*/
+    OCPayloadBufferBlock* blocks;
+    /** Copy of the encoded payload, at the start of the first block.*/
+    const uint8_t* data;
+};
+
+static OCPayloadBufferBlock* OCPayloadBufferAddBlock(OCPayloadBuffer* buffer, size_t capacity)
+{
+    // blocks are zeroed so that everything allocated from them is
+    OCPayloadBufferBlock* block = (OCPayloadBufferBlock*)OICCalloc(1,
+            sizeof(OCPayloadBufferBlock) + capacity);
+    if (!block)
+    {
+        return NULL;
+    }
+
+    block->capacity = capacity;
+    block->next = buffer->blocks;
+    buffer->blocks = block;
+    return block;
+}
+
+OCPayloadBuffer* OCPayloadBufferCreate(const uint8_t* cborData, size_t size)
+{
+    if (size > SIZE_MAX / 2)
+    {
+        return NULL;
+    }
+
+    OCPayloadBuffer* buffer = (OCPayloadBuffer*)OICCalloc(1, sizeof(OCPayloadBuffer));
+    if (!buffer)
+    {
+        return NULL;
+    }
+
+    // a text string takes at least one byte more in CBOR than its characters
+    OCPayloadBufferBlock* block = OCPayloadBufferAddBlock(buffer,
+            (2 * size > PAYLOAD_BUFFER_BLOCK_SIZE) ? 2 * size : PAYLOAD_BUFFER_BLOCK_SIZE);
+    if (!block)
+    {
+        OICFree(buffer);
+        return NULL;
+    }
+
+    buffer->refCount = 1;
+    if (size)
+    {
+        memcpy(block->bytes, cborData, size);
+        block->used = size;
+        buffer->data = block->bytes;
+    }
+    return buffer;
+}
+
+OCPayloadBuffer* OCPayloadBufferRetain(OCPayloadBuffer* buffer)
+{
+    if (buffer)
+    {
+        oc_atomic_increment(&buffer->refCount);
+    }
+    return buffer;
+}
+
+void OCPayloadBufferRelease(OCPayloadBuffer* buffer)
+{
+    if (buffer && 0 == oc_atomic_decrement(&buffer->refCount))
+    {
+        OCPayloadBufferBlock* block = buffer->blocks;
+        while (block)
+        {
+            OCPayloadBufferBlock* next = block->next;
+            OICFree(block);
+            block = next;
+        }
+        OICFree(buffer);
+    }
+}
+
+const uint8_t* OCPayloadBufferGetData(const OCPayloadBuffer* buffer)
+{
+    return buffer->data;
+}
+
+void* OCPayloadBufferAlloc(OCPayloadBuffer* buffer, size_t size)
+{
+    if (!buffer || !size || size > SIZE_MAX / 4)
+    {
+        return NULL;
+    }
+
+    OCPayloadBufferBlock* block = buffer->blocks;
+    size_t padding = (PAYLOAD_BUFFER_ALIGNMENT -
+            (uintptr_t)&block->bytes[block->used] % PAYLOAD_BUFFER_ALIGNMENT) % PAYLOAD_BUFFER_ALIGNMENT;
+    if (block->capacity - block->used < padding + size)
+    {
+        size_t capacity = 2 * block->capacity;
+        if (capacity < size + PAYLOAD_BUFFER_ALIGNMENT)
+        {
+            capacity = size + PAYLOAD_BUFFER_ALIGNMENT;
+        }
+        block = OCPayloadBufferAddBlock(buffer, capacity);
+        if (!block)
+        {
+            return NULL;
+        }
+        padding = (PAYLOAD_BUFFER_ALIGNMENT -
+                (uintptr_t)block->bytes % PAYLOAD_BUFFER_ALIGNMENT) % PAYLOAD_BUFFER_ALIGNMENT;
+    }
+
+    void* ptr = &block->bytes[block->used + padding];
+    block->used += padding + size;
+    return ptr;
+}
+
+void* OCPayloadBufferCalloc(OCPayloadBuffer* buffer, size_t num, size_t size)
+{
+    if (!buffer)
+    {
+        return OICCalloc(num, size);
+    }
+    if (size && num > SIZE_MAX / size)
+    {
+        return NULL;
+    }
+    return OCPayloadBufferAlloc(buffer, num * size);
+}
+
+bool OCPayloadBufferHolds(const OCPayloadBuffer* buffer, const void* ptr)
+{
+    for (const OCPayloadBufferBlock* block = buffer ? buffer->blocks : NULL; block;
+         block = block->next)
+    {
+        if ((const uint8_t*)ptr >= block->bytes && (const uint8_t*)ptr < block->bytes + block->capacity)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+void OCPayloadBufferFree(const OCPayloadBuffer* buffer, void* ptr)
+{
+    if (!OCPayloadBufferHolds(buffer, ptr))
+    {
+        OICFree(ptr);
+    }
+}
+
+static char* OCPayloadBufferStrdup(OCPayloadBuffer* buffer, const char* str)
+{
+    if (!buffer || !str)
+    {
+        return OICStrdup(str);
+    }
+
+    size_t size = strlen(str) + 1;
+    char* dup = (char*)OCPayloadBufferAlloc(buffer, size);
+    if (dup)
+    {
+        memcpy(dup, str, size);
+    }
+    return dup;
+}
+
+OCRepPayload* OCRepPayloadCreateInBuffer(OCPayloadBuffer* buffer)
+{
+    if (!buffer)
+    {
+        return OCRepPayloadCreate();
+    }
+
+    OCRepPayload* payload = (OCRepPayload*)OCPayloadBufferAlloc(buffer, sizeof(OCRepPayload));
+    if (!payload)
+    {
+        return NULL;
+    }
+
+    payload->base.type = PAYLOAD_TYPE_REPRESENTATION;
+    payload->buffer = OCPayloadBufferRetain(buffer);
+    return payload;
+}
+
+OCRepPayload* OC_CALL OCRepPayloadCreateInArena(const OCRepPayload* owner)
+{
+    if (owner && owner->buffer)
+    {
+        return OCRepPayloadCreateInBuffer(owner->buffer);
+    }
+
+    OCPayloadBuffer* buffer = OCPayloadBufferCreate(NULL, 0);
+    if (!buffer)
+    {
+        return NULL;
+    }
+
+    OCRepPayload* payload = OCRepPayloadCreateInBuffer(buffer);
+    OCPayloadBufferRelease(buffer);
+    return payload;
+}
+
 OCRepPayload* OC_CALL OCRepPayloadCreate()
 {
     OCRepPayload* payload = (OCRepPayload*)OICCalloc(1, sizeof(OCRepPayload));
@@ -106,6 +327,146 @@ void OC_CALL OCRepPayloadAppend(OCRepPayload* parent, OCRepPayload* child)
     child->next = NULL;
 }
 
+/** Number of values from which they are looked up through an OCRepPayloadIndex. */
+#define REP_INDEX_THRESHOLD 16
+
+/**
+ * Open addressing hash of the values of an OCRepPayload by name. The setters build and
+ * update it; it is checked against the values list on use, so that values appended or
+ * replaced directly are picked up by the next setter and skipped by the getters until then.
+ */
+typedef struct OCRepPayloadIndex
+{
+    /** First and last value of the list indexed.*/
+    OCRepPayloadValue* head;
+    OCRepPayloadValue* tail;
+    size_t count;
+    /** Power of 2, at least twice count.*/
+    size_t capacity;
+    OCRepPayloadValue* slots[];
+} OCRepPayloadIndex;
+
+static size_t OCRepPayloadIndexHash(const char* name)
+{
+    // FNV-1a
+    uint32_t hash = 2166136261u;
+    for (; *name; name++)
+    {
+        hash = (hash ^ (uint8_t)*name) * 16777619u;
+    }
+    return hash;
+}
+
+/** Returns the slot of the value with the name, or the empty slot where it would go.*/
+static size_t OCRepPayloadIndexSlot(const OCRepPayloadIndex* index, const char* name)
+{
+    size_t mask = index->capacity - 1;
+    size_t i = OCRepPayloadIndexHash(name) & mask;
+    while (index->slots[i] && 0 != strcmp(index->slots[i]->name, name))
+    {
+        i = (i + 1) & mask;
+    }
+    return i;
+}
+
+static OCRepPayloadIndex* OCRepPayloadIndexCreate(size_t capacity)
+{
+    OCRepPayloadIndex* index = (OCRepPayloadIndex*)OICCalloc(1,
+            sizeof(OCRepPayloadIndex) + capacity * sizeof(OCRepPayloadValue*));
+    if (index)
+    {
+        index->capacity = capacity;
+    }
+    return index;
+}
+
+static void OCRepPayloadIndexDestroy(OCRepPayload* payload)
+{
+    OICFree(payload->index);
+    payload->index = NULL;
+}
+
+/** Adds the value at the tail of the indexed list; the first of equal names is found.*/
+static bool OCRepPayloadIndexAdd(OCRepPayload* payload, OCRepPayloadValue* val)
+{
+    OCRepPayloadIndex* index = payload->index;
+    if (2 * (index->count + 1) > index->capacity)
+    {
+        OCRepPayloadIndex* grown = OCRepPayloadIndexCreate(2 * index->capacity);
+        if (!grown)
+        {
+            OCRepPayloadIndexDestroy(payload);
+            return false;
+        }
+        for (size_t i = 0; i < index->capacity; i++)
+        {
+            if (index->slots[i])
+            {
+                grown->slots[OCRepPayloadIndexSlot(grown, index->slots[i]->name)] = index->slots[i];
+            }
+        }
+        grown->head = index->head;
+        grown->tail = index->tail;
+        grown->count = index->count;
+        OICFree(index);
+        payload->index = index = grown;
+    }
+
+    size_t slot = OCRepPayloadIndexSlot(index, val->name);
+    if (!index->slots[slot])
+    {
+        index->slots[slot] = val;
+    }
+    index->tail = val;
+    index->count++;
+    return true;
+}
+
+/**
+ * Returns the index of the values of the payload, building it when there are enough values,
+ * or NULL if the values are to be searched in the list. Used by the setters.
+ */
+static OCRepPayloadIndex* OCRepPayloadGetIndex(OCRepPayload* payload)
+{
+    if (payload->index && payload->index->head != payload->values)
+    {
+        OCRepPayloadIndexDestroy(payload);
+    }
+
+    if (payload->index)
+    {
+        // values appended directly
+        while (payload->index && payload->index->tail->next)
+        {
+            OCRepPayloadIndexAdd(payload, payload->index->tail->next);
+        }
+        return payload->index;
+    }
+
+    size_t count = 0;
+    for (OCRepPayloadValue* val = payload->values; val && count < REP_INDEX_THRESHOLD;
+         val = val->next)
+    {
+        count++;
+    }
+    if (count < REP_INDEX_THRESHOLD)
+    {
+        return NULL;
+    }
+
+    payload->index = OCRepPayloadIndexCreate(4 * REP_INDEX_THRESHOLD);
+    if (!payload->index)
+    {
+        return NULL;
+    }
+    payload->index->head = payload->values;
+    for (OCRepPayloadValue* val = payload->values; val && payload->index; val = val->next)
+    {
+        OCRepPayloadIndexAdd(payload, val);
+    }
+    return payload->index;
+}
+
 static OCRepPayloadValue* OC_CALL OCRepPayloadFindValue(const OCRepPayload* payload, const char* name)
 {
     if (!payload || !name)
@@ -113,6 +474,13 @@ static OCRepPayloadValue* OC_CALL OCRepPayloadFindValue(const OCRepPayload* payl
         return NULL;
     }
 
+    // the getters only read the index, and search the list when it is not up to date
+    const OCRepPayloadIndex* index = payload->index;
+    if (index && index->head == payload->values && !index->tail->next)
+    {
+        return index->slots[OCRepPayloadIndexSlot(index, name)];
+    }
+
     OCRepPayloadValue* val = payload->values;
     while(val)
     {
@@ -126,7 +494,10 @@ static OCRepPayloadValue* OC_CALL OCRepPayloadFindValue(const OCRepPayload* payl
     return NULL;
 }
 
-static void OC_CALL OCCopyPropertyValueArray(OCRepPayloadValue* dest, OCRepPayloadValue* source)
+static OCRepPayload* OCRepPayloadCloneInBuffer(const OCRepPayload* payload, OCPayloadBuffer* buffer);
+
+static void OC_CALL OCCopyPropertyValueArray(OCPayloadBuffer* buffer, OCRepPayloadValue* dest,
+        OCRepPayloadValue* source)
 {
     if (!dest || !source)
     {
@@ -137,51 +508,71 @@ static void OC_CALL OCCopyPropertyValueArray(OCRepPayloadValue* dest, OCRepPaylo
     switch(source->arr.type)
     {
         case OCREP_PROP_INT:
-            dest->arr.iArray = (int64_t*)OICMalloc(dimTotal * sizeof(int64_t));
+            dest->arr.iArray = (int64_t*)OCPayloadBufferCalloc(buffer, dimTotal, sizeof(int64_t));
             VERIFY_PARAM_NON_NULL(TAG, dest->arr.iArray, "Failed allocating memory");
             memcpy(dest->arr.iArray, source->arr.iArray, dimTotal * sizeof(int64_t));
             break;
         case OCREP_PROP_DOUBLE:
-            dest->arr.dArray = (double*)OICMalloc(dimTotal * sizeof(double));
+            dest->arr.dArray = (double*)OCPayloadBufferCalloc(buffer, dimTotal, sizeof(double));
             VERIFY_PARAM_NON_NULL(TAG, dest->arr.dArray, "Failed allocating memory");
             memcpy(dest->arr.dArray, source->arr.dArray, dimTotal * sizeof(double));
             break;
         case OCREP_PROP_BOOL:
-            dest->arr.bArray = (bool*)OICMalloc(dimTotal * sizeof(bool));
+            dest->arr.bArray = (bool*)OCPayloadBufferCalloc(buffer, dimTotal, sizeof(bool));
             VERIFY_PARAM_NON_NULL(TAG, dest->arr.bArray, "Failed allocating memory");
             memcpy(dest->arr.bArray, source->arr.bArray, dimTotal * sizeof(bool));
             break;
         case OCREP_PROP_STRING:
-            dest->arr.strArray = (char**)OICMalloc(dimTotal * sizeof(char*));
+            dest->arr.strArray = (char**)OCPayloadBufferCalloc(buffer, dimTotal, sizeof(char*));
             VERIFY_PARAM_NON_NULL(TAG, dest->arr.strArray, "Failed allocating memory");
             for(size_t i = 0; i < dimTotal; ++i)
             {
-                dest->arr.strArray[i] = OICStrdup(source->arr.strArray[i]);
+                dest->arr.strArray[i] = OCPayloadBufferStrdup(buffer, source->arr.strArray[i]);
                 VERIFY_PARAM_NON_NULL(TAG, dest->arr.strArray[i], "Failed to duplicate string");
             }
             break;
         case OCREP_PROP_OBJECT:
-            dest->arr.objArray = (OCRepPayload**)OICMalloc(dimTotal * sizeof(OCRepPayload*));
+            dest->arr.objArray = (OCRepPayload**)OCPayloadBufferCalloc(buffer, dimTotal,
+                    sizeof(OCRepPayload*));
             VERIFY_PARAM_NON_NULL(TAG, dest->arr.objArray, "Failed allocating memory");
             for(size_t i = 0; i < dimTotal; ++i)
             {
-                dest->arr.objArray[i] = OCRepPayloadClone(source->arr.objArray[i]);
+                dest->arr.objArray[i] = OCRepPayloadCloneInBuffer(source->arr.objArray[i], buffer);
             }
             break;
         case OCREP_PROP_ARRAY:
-            dest->arr.objArray = (OCRepPayload**)OICMalloc(dimTotal * sizeof(OCRepPayload*));
+            dest->arr.objArray = (OCRepPayload**)OCPayloadBufferCalloc(buffer, dimTotal,
+                    sizeof(OCRepPayload*));
             VERIFY_PARAM_NON_NULL(TAG, dest->arr.objArray, "Failed allocating memory");
             for(size_t i = 0; i < dimTotal; ++i)
             {
-                dest->arr.objArray[i] = OCRepPayloadClone(source->arr.objArray[i]);
+                dest->arr.objArray[i] = OCRepPayloadCloneInBuffer(source->arr.objArray[i], buffer);
             }
             break;
         case OCREP_PROP_BYTE_STRING:
-            dest->arr.ocByteStrArray = (OCByteString*)OICCalloc(dimTotal, sizeof(OCByteString));
+            dest->arr.ocByteStrArray = (OCByteString*)OCPayloadBufferCalloc(buffer, dimTotal,
+                    sizeof(OCByteString));
             VERIFY_PARAM_NON_NULL(TAG, dest->arr.ocByteStrArray, "Failed allocating memory");
             for (size_t i = 0; i < dimTotal; ++i)
             {
-                OCByteStringCopy(&dest->arr.ocByteStrArray[i], &source->arr.ocByteStrArray[i]);
+                if (!source->arr.ocByteStrArray[i].len)
+                {
+                    // Left as {NULL, 0} by the calloc above
+                    continue;
+                }
+                if (!buffer)
+                {
+                    OCByteStringCopy(&dest->arr.ocByteStrArray[i], &source->arr.ocByteStrArray[i]);
+                }
+                else
+                {
+                    dest->arr.ocByteStrArray[i].bytes = (uint8_t*)OCPayloadBufferAlloc(buffer,
+                            source->arr.ocByteStrArray[i].len);
+                    VERIFY_PARAM_NON_NULL(TAG, dest->arr.ocByteStrArray[i].bytes, "Failed allocating memory");
+                    dest->arr.ocByteStrArray[i].len = source->arr.ocByteStrArray[i].len;
+                    memcpy(dest->arr.ocByteStrArray[i].bytes, source->arr.ocByteStrArray[i].bytes,
+                           dest->arr.ocByteStrArray[i].len);
+                }
                 VERIFY_PARAM_NON_NULL(TAG, dest->arr.ocByteStrArray[i].bytes, "Failed allocating memory");
             }
             break;
@@ -193,7 +584,8 @@ exit:
     return;
 }
 
-static void OC_CALL OCCopyPropertyValue (OCRepPayloadValue *dest, OCRepPayloadValue *source)
+static void OC_CALL OCCopyPropertyValue (OCPayloadBuffer *buffer, OCRepPayloadValue *dest,
+        OCRepPayloadValue *source)
 {
     if (!source || !dest)
     {
@@ -203,19 +595,20 @@ static void OC_CALL OCCopyPropertyValue (OCRepPayloadValue *dest, OCRepPayloadVa
     switch(source->type)
     {
         case OCREP_PROP_STRING:
-            dest->str = OICStrdup(source->str);
+            dest->str = OCPayloadBufferStrdup(buffer, source->str);
             break;
         case OCREP_PROP_BYTE_STRING:
-            dest->ocByteStr.bytes = (uint8_t*)OICMalloc(source->ocByteStr.len * sizeof(uint8_t));
+            dest->ocByteStr.bytes = (uint8_t*)OCPayloadBufferCalloc(buffer, source->ocByteStr.len,
+                    sizeof(uint8_t));
             VERIFY_PARAM_NON_NULL(TAG, dest->ocByteStr.bytes, "Failed allocating memory");
             dest->ocByteStr.len = source->ocByteStr.len;
             memcpy(dest->ocByteStr.bytes, source->ocByteStr.bytes, dest->ocByteStr.len);
             break;
         case OCREP_PROP_OBJECT:
-            dest->obj = OCRepPayloadClone(source->obj);
+            dest->obj = OCRepPayloadCloneInBuffer(source->obj, buffer);
             break;
         case OCREP_PROP_ARRAY:
-            OCCopyPropertyValueArray(dest, source);
+            OCCopyPropertyValueArray(buffer, dest, source);
             break;
         default:
             // Nothing to do for the trivially copyable types.
@@ -225,7 +618,7 @@ exit:
     return;
 }
 
-static void OCFreeRepPayloadValueContents(OCRepPayloadValue* val)
+static void OCFreeRepPayloadValueContents(const OCPayloadBuffer* buffer, OCRepPayloadValue* val)
 {
     if (!val)
     {
@@ -234,11 +627,11 @@ static void OCFreeRepPayloadValueContents(OCRepPayloadValue* val)
 
     if (val->type == OCREP_PROP_STRING)
     {
-        OICFree(val->str);
+        OCPayloadBufferFree(buffer, val->str);
     }
     else if (val->type == OCREP_PROP_BYTE_STRING)
     {
-        OICFree(val->ocByteStr.bytes);
+        OCPayloadBufferFree(buffer, val->ocByteStr.bytes);
     }
     else if (val->type == OCREP_PROP_OBJECT)
     {
@@ -254,31 +647,31 @@ static void OCFreeRepPayloadValueContents(OCRepPayloadValue* val)
             case OCREP_PROP_BOOL:
                 // Since this is a union, iArray will
                 // point to all of the above
-                OICFree(val->arr.iArray);
+                OCPayloadBufferFree(buffer, val->arr.iArray);
                 break;
             case OCREP_PROP_STRING:
                 for(size_t i = 0; i < dimTotal; ++i)
                 {
-                    OICFree(val->arr.strArray[i]);
+                    OCPayloadBufferFree(buffer, val->arr.strArray[i]);
                 }
-                OICFree(val->arr.strArray);
+                OCPayloadBufferFree(buffer, val->arr.strArray);
                 break;
             case OCREP_PROP_BYTE_STRING:
                 for (size_t i = 0; i < dimTotal; ++i)
                 {
                     if (val->arr.ocByteStrArray[i].bytes)
                     {
-                        OICFree(val->arr.ocByteStrArray[i].bytes);
+                        OCPayloadBufferFree(buffer, val->arr.ocByteStrArray[i].bytes);
                     }
                 }
-                OICFree(val->arr.ocByteStrArray);
+                OCPayloadBufferFree(buffer, val->arr.ocByteStrArray);
                 break;
             case OCREP_PROP_OBJECT: // This case is the temporary fix for string input
                 for(size_t i = 0; i< dimTotal; ++i)
                 {
                     OCRepPayloadDestroy(val->arr.objArray[i]);
                 }
-                OICFree(val->arr.objArray);
+                OCPayloadBufferFree(buffer, val->arr.objArray);
                 break;
             case OCREP_PROP_NULL:
             case OCREP_PROP_ARRAY:
@@ -289,19 +682,20 @@ static void OCFreeRepPayloadValueContents(OCRepPayloadValue* val)
     }
 }
 
-static void OC_CALL OCFreeRepPayloadValue(OCRepPayloadValue* val)
+static void OC_CALL OCFreeRepPayloadValue(const OCPayloadBuffer* buffer, OCRepPayloadValue* val)
 {
     if (!val)
     {
         return;
     }
 
-    OICFree(val->name);
-    OCFreeRepPayloadValueContents(val);
-    OCFreeRepPayloadValue(val->next);
-    OICFree(val);
+    OCPayloadBufferFree(buffer, val->name);
+    OCFreeRepPayloadValueContents(buffer, val);
+    OCFreeRepPayloadValue(buffer, val->next);
+    OCPayloadBufferFree(buffer, val);
 }
-static OCRepPayloadValue* OC_CALL OCRepPayloadValueClone (OCRepPayloadValue* source)
+static OCRepPayloadValue* OC_CALL OCRepPayloadValueClone (OCPayloadBuffer* buffer,
+        OCRepPayloadValue* source)
 {
     if (!source)
     {
@@ -309,7 +703,8 @@ static OCRepPayloadValue* OC_CALL OCRepPayloadValueClone (OCRepPayloadValue* sou
     }
 
     OCRepPayloadValue *sourceIter = source;
-    OCRepPayloadValue *destIter = (OCRepPayloadValue*) OICCalloc(1, sizeof(OCRepPayloadValue));
+    OCRepPayloadValue *destIter = (OCRepPayloadValue*) OCPayloadBufferCalloc(buffer, 1,
+            sizeof(OCRepPayloadValue));
     if (!destIter)
     {
         return NULL;
@@ -319,23 +714,24 @@ static OCRepPayloadValue* OC_CALL OCRepPayloadValueClone (OCRepPayloadValue* sou
 
     // Copy payload type and non pointer types in union.
     *destIter = *sourceIter;
-    destIter->name = OICStrdup (sourceIter->name);
-    OCCopyPropertyValue (destIter, sourceIter);
+    destIter->name = OCPayloadBufferStrdup (buffer, sourceIter->name);
+    OCCopyPropertyValue (buffer, destIter, sourceIter);
 
     sourceIter = sourceIter->next;
 
     while (sourceIter)
     {
-        destIter->next = (OCRepPayloadValue*) OICCalloc(1, sizeof(OCRepPayloadValue));
+        destIter->next = (OCRepPayloadValue*) OCPayloadBufferCalloc(buffer, 1,
+                sizeof(OCRepPayloadValue));
         if (!destIter->next)
         {
-            OCFreeRepPayloadValue (headOfClone);
+            OCFreeRepPayloadValue (buffer, headOfClone);
             return NULL;
         }
 
         *(destIter->next) = *sourceIter;
-        destIter->next->name = OICStrdup (sourceIter->name);
-        OCCopyPropertyValue (destIter->next, sourceIter);
+        destIter->next->name = OCPayloadBufferStrdup (buffer, sourceIter->name);
+        OCCopyPropertyValue (buffer, destIter->next, sourceIter);
 
         sourceIter = sourceIter->next;
         destIter = destIter->next;
@@ -343,6 +739,13 @@ static OCRepPayloadValue* OC_CALL OCRepPayloadValueClone (OCRepPayloadValue* sou
     return headOfClone;
 }
 
+/** Names held in the buffer of the payload, as the parser makes them, are not copied.*/
+static char* OCRepPayloadValueName(const OCRepPayload* payload, const char* name)
+{
+    return OCPayloadBufferHolds(payload->buffer, name) ?
+            (char*)name : OCPayloadBufferStrdup(payload->buffer, name);
+}
+
 static OCRepPayloadValue* OC_CALL OCRepPayloadFindAndSetValue(OCRepPayload* payload, const char* name,
         OCRepPayloadPropType type)
 {
@@ -351,18 +754,48 @@ static OCRepPayloadValue* OC_CALL OCRepPayloadFindAndSetValue(OCRepPayload* payl
         return NULL;
     }
 
+    OCRepPayloadIndex* index = OCRepPayloadGetIndex(payload);
+    if (index)
+    {
+        OCRepPayloadValue* val = index->slots[OCRepPayloadIndexSlot(index, name)];
+        if (val)
+        {
+            OCFreeRepPayloadValueContents(payload->buffer, val);
+            val->type = type;
+            return val;
+        }
+
+        val = (OCRepPayloadValue*)OCPayloadBufferCalloc(payload->buffer, 1, sizeof(OCRepPayloadValue));
+        if (!val)
+        {
+            return NULL;
+        }
+        val->name = OCRepPayloadValueName(payload, name);
+        if (!val->name)
+        {
+            OCPayloadBufferFree(payload->buffer, val);
+            return NULL;
+        }
+        val->type = type;
+        index->tail->next = val;
+        // without the index the values are searched in the list
+        OCRepPayloadIndexAdd(payload, val);
+        return val;
+    }
+
     OCRepPayloadValue* val = payload->values;
     if (val == NULL)
     {
-        payload->values = (OCRepPayloadValue*)OICCalloc(1, sizeof(OCRepPayloadValue));
+        payload->values = (OCRepPayloadValue*)OCPayloadBufferCalloc(payload->buffer, 1,
+                sizeof(OCRepPayloadValue));
         if (!payload->values)
         {
             return NULL;
         }
-        payload->values->name = OICStrdup(name);
+        payload->values->name = OCRepPayloadValueName(payload, name);
         if (!payload->values->name)
         {
-            OICFree(payload->values);
+            OCPayloadBufferFree(payload->buffer, payload->values);
             payload->values = NULL;
             return NULL;
         }
@@ -374,21 +807,22 @@ static OCRepPayloadValue* OC_CALL OCRepPayloadFindAndSetValue(OCRepPayload* payl
     {
         if (0 == strcmp(val->name, name))
         {
-            OCFreeRepPayloadValueContents(val);
+            OCFreeRepPayloadValueContents(payload->buffer, val);
             val->type = type;
             return val;
         }
         else if (val->next == NULL)
         {
-            val->next = (OCRepPayloadValue*)OICCalloc(1, sizeof(OCRepPayloadValue));
+            val->next = (OCRepPayloadValue*)OCPayloadBufferCalloc(payload->buffer, 1,
+                    sizeof(OCRepPayloadValue));
             if (!val->next)
             {
                 return NULL;
             }
-            val->next->name = OICStrdup(name);
+            val->next->name = OCRepPayloadValueName(payload, name);
             if (!val->next->name)
             {
-                OICFree(val->next);
+                OCPayloadBufferFree(payload->buffer, val->next);
                 val->next = NULL;
                 return NULL;
             }
@@ -604,12 +1038,13 @@ bool OC_CALL OCRepPayloadGetPropDouble(const OCRepPayload* payload, const char*
 
 bool OC_CALL OCRepPayloadSetPropString(OCRepPayload* payload, const char* name, const char* value)
 {
-    char* temp = OICStrdup(value);
+    OCPayloadBuffer* buffer = payload ? payload->buffer : NULL;
+    char* temp = OCPayloadBufferStrdup(buffer, value);
     bool b = OCRepPayloadSetPropStringAsOwner(payload, name, temp);
 
     if (!b)
     {
-        OICFree(temp);
+        OCPayloadBufferFree(buffer, temp);
     }
     return b;
 }
@@ -634,8 +1069,28 @@ bool OC_CALL OCRepPayloadGetPropString(const OCRepPayload* payload, const char*
 
 bool OC_CALL OCRepPayloadSetPropByteString(OCRepPayload* payload, const char* name, OCByteString value)
 {
+    OCPayloadBuffer* buffer = payload ? payload->buffer : NULL;
     OCByteString ocByteStr = {NULL, 0};
-    bool b = OCByteStringCopy(&ocByteStr, &value);
+    bool b = false;
+
+    if (!buffer)
+    {
+        b = OCByteStringCopy(&ocByteStr, &value);
+    }
+    else if (!value.len)
+    {
+        b = true;
+    }
+    else
+    {
+        ocByteStr.bytes = (uint8_t*)OCPayloadBufferAlloc(buffer, value.len);
+        if (ocByteStr.bytes)
+        {
+            memcpy(ocByteStr.bytes, value.bytes, value.len);
+            ocByteStr.len = value.len;
+            b = true;
+        }
+    }
 
     if (b)
     {
@@ -643,7 +1098,7 @@ bool OC_CALL OCRepPayloadSetPropByteString(OCRepPayload* payload, const char* na
     }
     if (!b)
     {
-        OICFree(ocByteStr.bytes);
+        OCPayloadBufferFree(buffer, ocByteStr.bytes);
     }
     return b;
 }
@@ -853,7 +1308,7 @@ bool OC_CALL OCRepPayloadGetPropPubDataType(const OCRepPayload *payload, const c
 
 bool OC_CALL OCRepPayloadSetPropObject(OCRepPayload* payload, const char* name, const OCRepPayload* value)
 {
-    OCRepPayload* temp = OCRepPayloadClone(value);
+    OCRepPayload* temp = OCRepPayloadCloneInBuffer(value, payload ? payload->buffer : NULL);
     bool b = OCRepPayloadSetPropObjectAsOwner(payload, name, temp);
 
     if (!b)
@@ -922,13 +1377,15 @@ bool OC_CALL OCRepPayloadSetByteStringArray(OCRepPayload* payload, const char* n
         return false;
     }
 
+    OCPayloadBuffer* buffer = payload ? payload->buffer : NULL;
     size_t dimTotal = calcDimTotal(dimensions);
     if (dimTotal == 0)
     {
         return false;
     }
 
-    OCByteString* newArray = (OCByteString*)OICCalloc(dimTotal, sizeof(OCByteString));
+    OCByteString* newArray = (OCByteString*)OCPayloadBufferCalloc(buffer, dimTotal,
+            sizeof(OCByteString));
 
     if (!newArray)
     {
@@ -939,15 +1396,16 @@ bool OC_CALL OCRepPayloadSetByteStringArray(OCRepPayload* payload, const char* n
     {
         if (array[i].len)
         {
-            newArray[i].bytes = (uint8_t*)OICMalloc(array[i].len * sizeof(uint8_t));
+            newArray[i].bytes = (uint8_t*)OCPayloadBufferCalloc(buffer, array[i].len,
+                    sizeof(uint8_t));
             if (NULL == newArray[i].bytes)
             {
                 for (size_t j = 0; j < i; ++j)
                 {
-                    OICFree(newArray[j].bytes);
+                    OCPayloadBufferFree(buffer, newArray[j].bytes);
                 }
 
-                OICFree(newArray);
+                OCPayloadBufferFree(buffer, newArray);
                 return false;
             }
         }
@@ -960,10 +1418,10 @@ bool OC_CALL OCRepPayloadSetByteStringArray(OCRepPayload* payload, const char* n
     {
         for (size_t i = 0; i < dimTotal; ++i)
         {
-            OICFree(newArray[i].bytes);
+            OCPayloadBufferFree(buffer, newArray[i].bytes);
         }
 
-        OICFree(newArray);
+        OCPayloadBufferFree(buffer, newArray);
     }
     return b;
 }
@@ -1039,9 +1497,10 @@ bool OC_CALL OCRepPayloadSetIntArrayAsOwner(OCRepPayload* payload, const char* n
 bool OC_CALL OCRepPayloadSetIntArray(OCRepPayload* payload, const char* name,
         const int64_t* array, size_t dimensions[MAX_REP_ARRAY_DEPTH])
 {
+    OCPayloadBuffer* buffer = payload ? payload->buffer : NULL;
     size_t dimTotal = calcDimTotal(dimensions);
 
-    int64_t* newArray = (int64_t*)OICMalloc(dimTotal * sizeof(int64_t));
+    int64_t* newArray = (int64_t*)OCPayloadBufferCalloc(buffer, dimTotal, sizeof(int64_t));
 
     if (newArray && array)
     {
@@ -1051,7 +1510,7 @@ bool OC_CALL OCRepPayloadSetIntArray(OCRepPayload* payload, const char* name,
     bool b = OCRepPayloadSetIntArrayAsOwner(payload, name, newArray, dimensions);
     if (!b)
     {
-        OICFree(newArray);
+        OCPayloadBufferFree(buffer, newArray);
     }
     return b;
 }
@@ -1102,13 +1561,14 @@ bool OC_CALL OCRepPayloadSetDoubleArrayAsOwner(OCRepPayload* payload, const char
 bool OC_CALL OCRepPayloadSetDoubleArray(OCRepPayload* payload, const char* name,
         const double* array, size_t dimensions[MAX_REP_ARRAY_DEPTH])
 {
+    OCPayloadBuffer* buffer = payload ? payload->buffer : NULL;
     size_t dimTotal = calcDimTotal(dimensions);
     if (dimTotal == 0)
     {
         return false;
     }
 
-    double* newArray = (double*)OICMalloc(dimTotal * sizeof(double));
+    double* newArray = (double*)OCPayloadBufferCalloc(buffer, dimTotal, sizeof(double));
 
     if (!newArray)
     {
@@ -1120,7 +1580,7 @@ bool OC_CALL OCRepPayloadSetDoubleArray(OCRepPayload* payload, const char* name,
     bool b = OCRepPayloadSetDoubleArrayAsOwner(payload, name, newArray, dimensions);
     if (!b)
     {
-        OICFree(newArray);
+        OCPayloadBufferFree(buffer, newArray);
     }
     return b;
 }
@@ -1192,13 +1652,14 @@ bool OC_CALL OCRepPayloadSetStringArrayAsOwner(OCRepPayload* payload, const char
 bool OC_CALL OCRepPayloadSetStringArray(OCRepPayload* payload, const char* name,
         const char** array, size_t dimensions[MAX_REP_ARRAY_DEPTH])
 {
+    OCPayloadBuffer* buffer = payload ? payload->buffer : NULL;
     size_t dimTotal = calcDimTotal(dimensions);
     if (dimTotal == 0)
     {
         return false;
     }
 
-    char** newArray = (char**)OICMalloc(dimTotal * sizeof(char*));
+    char** newArray = (char**)OCPayloadBufferCalloc(buffer, dimTotal, sizeof(char*));
 
     if (!newArray)
     {
@@ -1207,7 +1668,7 @@ bool OC_CALL OCRepPayloadSetStringArray(OCRepPayload* payload, const char* name,
 
     for(size_t i = 0; i < dimTotal; ++i)
     {
-        newArray[i] = OICStrdup(array[i]);
+        newArray[i] = OCPayloadBufferStrdup(buffer, array[i]);
     }
 
     bool b = OCRepPayloadSetStringArrayAsOwner(payload, name, newArray, dimensions);
@@ -1216,9 +1677,9 @@ bool OC_CALL OCRepPayloadSetStringArray(OCRepPayload* payload, const char* name,
     {
         for(size_t i = 0; i < dimTotal; ++i)
         {
-            OICFree(newArray[i]);
+            OCPayloadBufferFree(buffer, newArray[i]);
         }
-        OICFree(newArray);
+        OCPayloadBufferFree(buffer, newArray);
     }
     return b;
 }
@@ -1276,13 +1737,14 @@ bool OC_CALL OCRepPayloadSetBoolArrayAsOwner(OCRepPayload* payload, const char*
 bool OC_CALL OCRepPayloadSetBoolArray(OCRepPayload* payload, const char* name,
         const bool* array, size_t dimensions[MAX_REP_ARRAY_DEPTH])
 {
+    OCPayloadBuffer* buffer = payload ? payload->buffer : NULL;
     size_t dimTotal = calcDimTotal(dimensions);
     if (dimTotal == 0)
     {
         return false;
     }
 
-    bool* newArray = (bool*)OICMalloc(dimTotal * sizeof(bool));
+    bool* newArray = (bool*)OCPayloadBufferCalloc(buffer, dimTotal, sizeof(bool));
 
     if (!newArray)
     {
@@ -1295,7 +1757,7 @@ bool OC_CALL OCRepPayloadSetBoolArray(OCRepPayload* payload, const char* name,
     bool b = OCRepPayloadSetBoolArrayAsOwner(payload, name, newArray, dimensions);
     if (!b)
     {
-        OICFree(newArray);
+        OCPayloadBufferFree(buffer, newArray);
     }
     return b;
 }
@@ -1347,13 +1809,14 @@ bool OC_CALL OCRepPayloadSetPropObjectArrayAsOwner(OCRepPayload* payload, const
 bool OC_CALL OCRepPayloadSetPropObjectArray(OCRepPayload* payload, const char* name,
         const OCRepPayload** array, size_t dimensions[MAX_REP_ARRAY_DEPTH])
 {
+    OCPayloadBuffer* buffer = payload ? payload->buffer : NULL;
     size_t dimTotal = calcDimTotal(dimensions);
     if (dimTotal == 0)
     {
         return false;
     }
 
-    OCRepPayload** newArray = (OCRepPayload**)OICMalloc(dimTotal * sizeof(OCRepPayload*));
+    OCRepPayload** newArray = (OCRepPayload**)OCPayloadBufferCalloc(buffer, dimTotal, sizeof(OCRepPayload*));
 
     if (!newArray)
     {
@@ -1362,7 +1825,7 @@ bool OC_CALL OCRepPayloadSetPropObjectArray(OCRepPayload* payload, const char* n
 
     for(size_t i = 0; i < dimTotal; ++i)
     {
-        newArray[i] = OCRepPayloadClone(array[i]);
+        newArray[i] = OCRepPayloadCloneInBuffer(array[i], buffer);
     }
 
     bool b = OCRepPayloadSetPropObjectArrayAsOwner(payload, name, newArray, dimensions);
@@ -1373,7 +1836,7 @@ bool OC_CALL OCRepPayloadSetPropObjectArray(OCRepPayload* payload, const char* n
         {
            OCRepPayloadDestroy(newArray[i]);
         }
-        OICFree(newArray);
+        OCPayloadBufferFree(buffer, newArray);
     }
     return b;
 }
@@ -1583,14 +2046,14 @@ exit:
     return false;
 }
 
-OCRepPayload* OC_CALL OCRepPayloadClone (const OCRepPayload* payload)
+static OCRepPayload* OCRepPayloadCloneInBuffer(const OCRepPayload* payload, OCPayloadBuffer* buffer)
 {
     if (!payload)
     {
         return NULL;
     }
 
-    OCRepPayload *clone = OCRepPayloadCreate();
+    OCRepPayload *clone = OCRepPayloadCreateInBuffer(buffer);
 
     if (!clone)
     {
@@ -1600,8 +2063,31 @@ OCRepPayload* OC_CALL OCRepPayloadClone (const OCRepPayload* payload)
     clone->uri = OICStrdup (payload->uri);
     clone->types = CloneOCStringLL (payload->types);
     clone->interfaces = CloneOCStringLL (payload->interfaces);
-    clone->values = OCRepPayloadValueClone (payload->values);
+    clone->values = OCRepPayloadValueClone (buffer, payload->values);
+
+    return clone;
+}
+
+OCRepPayload* OC_CALL OCRepPayloadClone (const OCRepPayload* payload)
+{
+    return OCRepPayloadCloneInBuffer(payload, NULL);
+}
+
+OCRepPayload* OC_CALL OCRepPayloadCloneInArena(const OCRepPayload* payload)
+{
+    if (!payload)
+    {
+        return NULL;
+    }
+
+    OCPayloadBuffer* buffer = OCPayloadBufferCreate(NULL, 0);
+    if (!buffer)
+    {
+        return NULL;
+    }
 
+    OCRepPayload* clone = OCRepPayloadCloneInBuffer(payload, buffer);
+    OCPayloadBufferRelease(buffer);
     return clone;
 }
 
@@ -1623,7 +2109,7 @@ OCRepPayload* OC_CALL OCRepPayloadBatchClone(const OCRepPayload* repPayload)
 
     clone->types  = CloneOCStringLL(repPayload->types);
     clone->interfaces  = CloneOCStringLL(repPayload->interfaces);
-    clone->values = OCRepPayloadValueClone(repPayload->values);
+    clone->values = OCRepPayloadValueClone(NULL, repPayload->values);
     OCRepPayloadSetPropObjectAsOwner(newPayload, OC_RSRVD_REPRESENTATION, clone);
 
     return newPayload;
@@ -1636,12 +2122,16 @@ void OC_CALL OCRepPayloadDestroy(OCRepPayload* payload)
         return;
     }
 
+    OCPayloadBuffer* buffer = payload->buffer;
     OICFree(payload->uri);
     OCFreeOCStringLL(payload->types);
     OCFreeOCStringLL(payload->interfaces);
-    OCFreeRepPayloadValue(payload->values);
+    OCFreeRepPayloadValue(buffer, payload->values);
+    OCRepPayloadIndexDestroy(payload);
     OCRepPayloadDestroy(payload->next);
-    OICFree(payload);
+    // a payload in an arena frees nothing on its own, the arena goes with its last payload
+    OCPayloadBufferFree(buffer, payload);
+    OCPayloadBufferRelease(buffer);
 }
 
 OCDiscoveryPayload* OC_CALL OCDiscoveryPayloadCreate()
@@ -1726,6 +2216,59 @@ void OC_CALL OCIntrospectionPayloadDestroy(OCIntrospectionPayload* payload)
     OICFree(payload);
 }
 
+OCEncodedRepPayload* OC_CALL OCEncodedRepPayloadCreate(const uint8_t* cborData, size_t size)
+{
+    if (!cborData || !size)
+    {
+        return NULL;
+    }
+
+    uint8_t* bytes = (uint8_t*)OICMalloc(size);
+    if (!bytes)
+    {
+        return NULL;
+    }
+    memcpy(bytes, cborData, size);
+
+    OCEncodedRepPayload* payload = OCEncodedRepPayloadCreateAsOwner(bytes, size);
+    if (!payload)
+    {
+        OICFree(bytes);
+    }
+    return payload;
+}
+
+OCEncodedRepPayload* OC_CALL OCEncodedRepPayloadCreateAsOwner(uint8_t* cborData, size_t size)
+{
+    if (!cborData || !size)
+    {
+        return NULL;
+    }
+
+    OCEncodedRepPayload* payload = (OCEncodedRepPayload*)OICCalloc(1, sizeof(OCEncodedRepPayload));
+    if (!payload)
+    {
+        return NULL;
+    }
+
+    payload->base.type = PAYLOAD_TYPE_ENCODED_REPRESENTATION;
+    payload->cborPayload.bytes = cborData;
+    payload->cborPayload.len = size;
+
+    return payload;
+}
+
+void OC_CALL OCEncodedRepPayloadDestroy(OCEncodedRepPayload* payload)
+{
+    if (!payload)
+    {
+        return;
+    }
+
+    OICFree(payload->cborPayload.bytes);
+    OICFree(payload);
+}
+
 size_t OC_CALL OCDiscoveryPayloadGetResourceCount(OCDiscoveryPayload* payload)
 {
     size_t i = 0;
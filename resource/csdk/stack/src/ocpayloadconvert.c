@@ -60,6 +60,8 @@ static int64_t OCConvertSecurityPayload(OCSecurityPayload *payload, uint8_t *out
         size_t *size);
 static int64_t OCConvertIntrospectionPayload(OCIntrospectionPayload *payload, uint8_t *outPayload,
         size_t *size);
+static int64_t OCConvertEncodedRepPayload(OCEncodedRepPayload *payload, uint8_t *outPayload,
+        size_t *size);
 static int64_t OCConvertSingleRepPayloadValue(CborEncoder *parent, const OCRepPayloadValue *value);
 static int64_t OCConvertSingleRepPayload(CborEncoder *parent, const OCRepPayload *payload);
 static int64_t OCConvertArray(CborEncoder *parent, const OCRepPayloadValueArray *valArray);
@@ -82,7 +84,12 @@ OCStackResult OCConvertPayload(OCPayload* payload, OCPayloadFormat format,
     OCStackResult ret = OC_STACK_INVALID_PARAM;
     int64_t err = CborErrorOutOfMemory;
     uint8_t *out = NULL;
-    size_t curSize = INIT_SIZE;
+    size_t curSize = 0;
+    // Most payloads fit here and are copied out into an exactly sized buffer.
+    // When one does not fit, the encoder keeps counting, so the failed attempt
+    // yields the exact size and the payload is encoded once more straight into
+    // its final buffer.
+    uint8_t scratch[INIT_SIZE];
 
     VERIFY_PARAM_NON_NULL(TAG, payload, "Input param, payload is NULL");
     VERIFY_PARAM_NON_NULL(TAG, outPayload, "OutPayload parameter is NULL");
@@ -91,48 +98,50 @@ OCStackResult OCConvertPayload(OCPayload* payload, OCPayloadFormat format,
     OIC_LOG_V(INFO, TAG, "Converting payload of type %d", payload->type);
     if (PAYLOAD_TYPE_SECURITY == payload->type)
     {
-        size_t securityPayloadSize = ((OCSecurityPayload *)payload)->payloadSize;
-        if (securityPayloadSize > 0)
-        {
-            curSize = securityPayloadSize;
-        }
+        curSize = ((OCSecurityPayload *)payload)->payloadSize;
     }
     if (PAYLOAD_TYPE_INTROSPECTION == payload->type)
     {
-        size_t introspectionPayloadSize = ((OCIntrospectionPayload *)payload)->cborPayload.len;
-        if (introspectionPayloadSize > 0)
-        {
-            curSize = introspectionPayloadSize;
-        }
+        curSize = ((OCIntrospectionPayload *)payload)->cborPayload.len;
+    }
+    if (PAYLOAD_TYPE_ENCODED_REPRESENTATION == payload->type)
+    {
+        curSize = ((OCEncodedRepPayload *)payload)->cborPayload.len;
     }
 
     ret = OC_STACK_NO_MEMORY;
 
-    for (;;)
+    if (0 < curSize)
     {
-        out = (uint8_t *)OICCalloc(1, curSize);
+        // already encoded, the size is known up front
+        out = (uint8_t *)OICMalloc(curSize);
         VERIFY_PARAM_NON_NULL(TAG, out, "Failed to allocate payload");
         err = OCConvertPayloadHelper(payload, format, out, &curSize);
-
-        if (CborErrorOutOfMemory != err)
+    }
+    else
+    {
+        curSize = sizeof(scratch);
+        err = OCConvertPayloadHelper(payload, format, scratch, &curSize);
+        if (CborNoError == err)
         {
-            break;
+            // an empty payload still gets a buffer, as callers expect one
+            out = (uint8_t *)OICMalloc(curSize ? curSize : 1);
+            VERIFY_PARAM_NON_NULL(TAG, out, "Failed to allocate payload");
+            memcpy(out, scratch, curSize);
         }
+    }
 
+    // curSize is the exact size needed now
+    while (CborErrorOutOfMemory == err)
+    {
         OICFree(out);
+        out = (uint8_t *)OICMalloc(curSize);
+        VERIFY_PARAM_NON_NULL(TAG, out, "Failed to allocate payload");
+        err = OCConvertPayloadHelper(payload, format, out, &curSize);
     }
 
     if (err == CborNoError)
     {
-        if ((curSize < INIT_SIZE) &&
-            (PAYLOAD_TYPE_SECURITY != payload->type) &&
-            (PAYLOAD_TYPE_INTROSPECTION != payload->type))
-        {
-            uint8_t *out2 = (uint8_t *)OICRealloc(out, curSize);
-            VERIFY_PARAM_NON_NULL(TAG, out2, "Failed to increase payload size");
-            out = out2;
-        }
-
         *size = curSize;
         *outPayload = out;
         OIC_LOG_V(DEBUG, TAG, "Payload Size: %zd Payload : ", *size);
@@ -167,6 +176,8 @@ static int64_t OCConvertPayloadHelper(OCPayload* payload, OCPayloadFormat format
         case PAYLOAD_TYPE_INTROSPECTION:
             return OCConvertIntrospectionPayload((OCIntrospectionPayload*)payload,
                                                  outPayload, size);
+        case PAYLOAD_TYPE_ENCODED_REPRESENTATION:
+            return OCConvertEncodedRepPayload((OCEncodedRepPayload*)payload, outPayload, size);
         default:
             OIC_LOG_V(INFO, TAG, "ConvertPayload default %d", payload->type);
             return CborErrorUnknownType;
@@ -210,6 +221,15 @@ static int64_t OCConvertIntrospectionPayload(OCIntrospectionPayload *payload,
     return CborNoError;
 }
 
+static int64_t OCConvertEncodedRepPayload(OCEncodedRepPayload *payload,
+        uint8_t *outPayload, size_t *size)
+{
+    memcpy(outPayload, payload->cborPayload.bytes, payload->cborPayload.len);
+    *size = payload->cborPayload.len;
+
+    return CborNoError;
+}
+
 static int64_t OCStringLLJoin(CborEncoder *map, char *type, OCStringLL *val)
 {
     uint16_t count = 0;
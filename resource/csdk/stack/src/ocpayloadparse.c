@@ -45,10 +45,59 @@
  */
 #define UINT64_MAX_STRLEN 20
 
+/*
+ * Payloads parsed into a buffer take text strings from it and point into its copy of the
+ * encoded payload for byte strings. Strings of other payloads are allocated.
+ */
+static CborError OCParseTextString(const CborValue *value, char **str, OCPayloadBuffer *buffer)
+{
+    size_t len = 0;
+    if (buffer)
+    {
+        CborError err = cbor_value_calculate_string_length(value, &len);
+        if (CborNoError != err)
+        {
+            return err;
+        }
+        char *dest = (char *)OCPayloadBufferAlloc(buffer, len + 1);
+        if (!dest)
+        {
+            return CborErrorOutOfMemory;
+        }
+        size_t size = len + 1;
+        err = cbor_value_copy_text_string(value, dest, &size, NULL);
+        dest[len] = '\0';
+        *str = (CborNoError == err) ? dest : NULL;
+        return err;
+    }
+    return cbor_value_dup_text_string(value, str, &len, NULL);
+}
+
+static CborError OCParseByteString(const CborValue *value, uint8_t **bytes, size_t *len,
+        OCPayloadBuffer *buffer)
+{
+    if (buffer && cbor_value_is_length_known(value))
+    {
+        CborError err = cbor_value_get_string_length(value, len);
+        if (CborNoError == err)
+        {
+            // the bytes follow the head of the string, sized by its additional information
+            uint8_t info = *value->ptr & 0x1f;
+            *bytes = (uint8_t *)value->ptr + ((info < 24) ? 1 : 1 + ((size_t)1 << (info - 24)));
+        }
+        return err;
+    }
+    return cbor_value_dup_byte_string(value, bytes, len, NULL);
+}
+
 static OCStackResult OCParseDiscoveryPayload(OCPayload **outPayload, OCPayloadFormat format,
         CborValue *arrayVal);
-static CborError OCParseSingleRepPayload(OCRepPayload **outPayload, CborValue *repParent, bool isRoot);
-static OCStackResult OCParseRepPayload(OCPayload **outPayload, CborValue *arrayVal);
+static CborError OCParseSingleRepPayload(OCRepPayload **outPayload, CborValue *repParent, bool isRoot,
+        OCPayloadBuffer *buffer);
+static OCStackResult OCParseRepPayload(OCPayload **outPayload, CborValue *arrayVal,
+        OCPayloadBuffer *buffer);
+static OCStackResult OCParseRepPayloadInArena(OCPayload **outPayload, const uint8_t *payload,
+        size_t size);
 static OCStackResult OCParsePresencePayload(OCPayload **outPayload, CborValue *arrayVal);
 static OCStackResult OCParseDiagnosticPayload(OCPayload **outPayload, CborValue *arrayVal);
 static OCStackResult OCParseSecurityPayload(OCPayload **outPayload, const uint8_t *payload, size_t size);
@@ -77,7 +126,7 @@ OCStackResult OCParsePayload(OCPayload **outPayload, OCPayloadFormat payloadForm
             result = OCParseDiscoveryPayload(outPayload, payloadFormat, &rootValue);
             break;
         case PAYLOAD_TYPE_REPRESENTATION:
-            result = OCParseRepPayload(outPayload, &rootValue);
+            result = OCParseRepPayloadInArena(outPayload, payload, payloadSize);
             break;
         case PAYLOAD_TYPE_PRESENCE:
             result = OCParsePresencePayload(outPayload, &rootValue);
@@ -818,14 +867,14 @@ static size_t arrayStep(size_t dimensions[MAX_REP_ARRAY_DEPTH], size_t elementNu
 }
 
 static CborError OCParseArrayFillArray(const CborValue *parent,
-        size_t dimensions[MAX_REP_ARRAY_DEPTH], OCRepPayloadPropType type, void *targetArray)
+        size_t dimensions[MAX_REP_ARRAY_DEPTH], OCRepPayloadPropType type, void *targetArray,
+        OCPayloadBuffer *buffer)
 {
     CborValue insideArray;
 
     size_t i = 0;
     char *tempStr = NULL;
     OCByteString ocByteStr = { .bytes = NULL, .len = 0};
-    size_t tempLen = 0;
     OCRepPayload *tempPl = NULL;
 
     size_t newdim[MAX_REP_ARRAY_DEPTH];
@@ -851,7 +900,7 @@ static CborError OCParseArrayFillArray(const CborValue *parent,
                     else
                     {
                         err = OCParseArrayFillArray(&insideArray, newdim, type,
-                            &(((int64_t*)targetArray)[arrayStep(dimensions, i)]));
+                            &(((int64_t*)targetArray)[arrayStep(dimensions, i)]), buffer);
                     }
                     break;
                 case OCREP_PROP_DOUBLE:
@@ -874,7 +923,7 @@ static CborError OCParseArrayFillArray(const CborValue *parent,
                     else
                     {
                         err = OCParseArrayFillArray(&insideArray, newdim, type,
-                            &(((double*)targetArray)[arrayStep(dimensions, i)]));
+                            &(((double*)targetArray)[arrayStep(dimensions, i)]), buffer);
                     }
                     break;
                 case OCREP_PROP_BOOL:
@@ -885,39 +934,39 @@ static CborError OCParseArrayFillArray(const CborValue *parent,
                     else
                     {
                         err = OCParseArrayFillArray(&insideArray, newdim, type,
-                            &(((bool*)targetArray)[arrayStep(dimensions, i)]));
+                            &(((bool*)targetArray)[arrayStep(dimensions, i)]), buffer);
                     }
                     break;
                 case OCREP_PROP_STRING:
                     if (dimensions[1] == 0)
                     {
-                        err = cbor_value_dup_text_string(&insideArray, &tempStr, &tempLen, NULL);
+                        err = OCParseTextString(&insideArray, &tempStr, buffer);
                         ((char**)targetArray)[i] = tempStr;
                         tempStr = NULL;
                     }
                     else
                     {
                         err = OCParseArrayFillArray(&insideArray, newdim, type,
-                            &(((char**)targetArray)[arrayStep(dimensions, i)]));
+                            &(((char**)targetArray)[arrayStep(dimensions, i)]), buffer);
                     }
                     break;
                 case OCREP_PROP_BYTE_STRING:
                     if (dimensions[1] == 0)
                     {
-                        err = cbor_value_dup_byte_string(&insideArray, &(ocByteStr.bytes),
-                                &(ocByteStr.len), NULL);
+                        err = OCParseByteString(&insideArray, &(ocByteStr.bytes),
+                                &(ocByteStr.len), buffer);
                         ((OCByteString*)targetArray)[i] = ocByteStr;
                     }
                     else
                     {
                         err = OCParseArrayFillArray(&insideArray, newdim, type,
-                                &(((OCByteString*)targetArray)[arrayStep(dimensions, i)]));
+                                &(((OCByteString*)targetArray)[arrayStep(dimensions, i)]), buffer);
                     }
                     break;
                 case OCREP_PROP_OBJECT:
                     if (dimensions[1] == 0)
                     {
-                        err = OCParseSingleRepPayload(&tempPl, &insideArray, false);
+                        err = OCParseSingleRepPayload(&tempPl, &insideArray, false, buffer);
                         ((OCRepPayload**)targetArray)[i] = tempPl;
                         tempPl = NULL;
                         noAdvance = true;
@@ -925,7 +974,7 @@ static CborError OCParseArrayFillArray(const CborValue *parent,
                     else
                     {
                         err = OCParseArrayFillArray(&insideArray, newdim, type,
-                            &(((OCRepPayload**)targetArray)[arrayStep(dimensions, i)]));
+                            &(((OCRepPayload**)targetArray)[arrayStep(dimensions, i)]), buffer);
                     }
                     break;
                 default:
@@ -947,7 +996,8 @@ exit:
     return err;
 }
 
-static CborError OCParseArray(OCRepPayload *out, const char *name, CborValue *container)
+static CborError OCParseArray(OCRepPayload *out, const char *name, CborValue *container,
+        OCPayloadBuffer *buffer)
 {
     void *arr = NULL;
 
@@ -970,10 +1020,10 @@ static CborError OCParseArray(OCRepPayload *out, const char *name, CborValue *co
 
     dimTotal = calcDimTotal(dimensions);
     allocSize = getAllocSize(type);
-    arr = OICCalloc(dimTotal, allocSize);
+    arr = OCPayloadBufferCalloc(buffer, dimTotal, allocSize);
     VERIFY_PARAM_NON_NULL(TAG, arr, "Array Parse allocation failed");
 
-    res = OCParseArrayFillArray(container, dimensions, type, arr);
+    res = OCParseArrayFillArray(container, dimensions, type, arr, buffer);
     VERIFY_CBOR_SUCCESS_OR_OUT_OF_MEMORY(TAG, err, "Failed parse array");
 
     switch (type)
@@ -1008,14 +1058,14 @@ exit:
     {
         for(size_t i = 0; i < dimTotal; ++i)
         {
-            OICFree(((char**)arr)[i]);
+            OCPayloadBufferFree(buffer, ((char**)arr)[i]);
         }
     }
     if (type == OCREP_PROP_BYTE_STRING)
     {
         for(size_t i = 0; i < dimTotal; ++i)
         {
-            OICFree(((OCByteString*)arr)[i].bytes);
+            OCPayloadBufferFree(buffer, ((OCByteString*)arr)[i].bytes);
         }
     }
     if (type == OCREP_PROP_OBJECT)
@@ -1025,15 +1075,102 @@ exit:
             OCRepPayloadDestroy(((OCRepPayload**)arr)[i]);
         }
     }
-    OICFree(arr);
+    OCPayloadBufferFree(buffer, arr);
+    return err;
+}
+
+/* Parses value into the property name of curPayload, see OCParseSingleRepPayload. */
+static CborError OCParseValue(OCRepPayload *curPayload, const char *name, CborValue *repMap,
+        OCPayloadBuffer *buffer)
+{
+    CborError err = CborNoError;
+    bool res = false;
+    size_t len = 0;
+    CborType type = cbor_value_get_type(repMap);
+    switch (type)
+    {
+        case CborNullType:
+            res = OCRepPayloadSetNull(curPayload, name);
+            break;
+        case CborIntegerType:
+            {
+                int64_t intval = 0;
+                err = cbor_value_get_int64(repMap, &intval);
+                VERIFY_CBOR_SUCCESS_OR_OUT_OF_MEMORY(TAG, err, "Failed getting int value");
+                res = OCRepPayloadSetPropInt(curPayload, name, intval);
+            }
+            break;
+        case CborDoubleType:
+            {
+                double doubleval = 0;
+                err = cbor_value_get_double(repMap, &doubleval);
+                VERIFY_CBOR_SUCCESS_OR_OUT_OF_MEMORY(TAG, err, "Failed getting double value");
+                res = OCRepPayloadSetPropDouble(curPayload, name, doubleval);
+            }
+            break;
+        case CborBooleanType:
+            {
+                bool boolval = false;
+                err = cbor_value_get_boolean(repMap, &boolval);
+                VERIFY_CBOR_SUCCESS_OR_OUT_OF_MEMORY(TAG, err, "Failed getting boolean value");
+                res = OCRepPayloadSetPropBool(curPayload, name, boolval);
+            }
+            break;
+        case CborTextStringType:
+            {
+                char *strval = NULL;
+                err = OCParseTextString(repMap, &strval, buffer);
+                VERIFY_CBOR_SUCCESS_OR_OUT_OF_MEMORY(TAG, err, "Failed getting string value");
+                res = OCRepPayloadSetPropStringAsOwner(curPayload, name, strval);
+            }
+            break;
+        case CborByteStringType:
+            {
+                uint8_t* bytestrval = NULL;
+                err = OCParseByteString(repMap, &bytestrval, &len, buffer);
+                VERIFY_CBOR_SUCCESS_OR_OUT_OF_MEMORY(TAG, err, "Failed getting byte string value");
+                OCByteString tmp = {.bytes = bytestrval, .len = len};
+                res = OCRepPayloadSetPropByteStringAsOwner(curPayload, name, &tmp);
+            }
+            break;
+        case CborMapType:
+            {
+                OCRepPayload *pl = NULL;
+                err = OCParseSingleRepPayload(&pl, repMap, false, buffer);
+                VERIFY_CBOR_SUCCESS_OR_OUT_OF_MEMORY(TAG, err, "Failed setting parse single rep");
+                res = OCRepPayloadSetPropObjectAsOwner(curPayload, name, pl);
+            }
+            break;
+        case CborArrayType:
+            err = OCParseArray(curPayload, name, repMap, buffer);
+            if (err != CborNoError)
+            {
+                // OCParseArray will fail if the array contains mixed types, try
+                // to parse as payload with non-negative integer value names
+                OCRepPayload *pl = NULL;
+                err = OCParseSingleRepPayload(&pl, repMap, false, buffer);
+                VERIFY_CBOR_SUCCESS_OR_OUT_OF_MEMORY(TAG, err, "Failed setting parse single rep");
+                res = OCRepPayloadSetPropObjectAsOwner(curPayload, name, pl);
+            }
+            break;
+        default:
+            OIC_LOG_V(ERROR, TAG, "Parsing rep property, unknown type %d", repMap->type);
+            res = false;
+    }
+    if (type != CborArrayType)
+    {
+        err = (CborError) !res;
+    }
+
+exit:
     return err;
 }
 
-static CborError OCParseSingleRepPayload(OCRepPayload **outPayload, CborValue *objMap, bool isRoot)
+static CborError OCParseSingleRepPayload(OCRepPayload **outPayload, CborValue *objMap, bool isRoot,
+        OCPayloadBuffer *buffer)
 {
     CborError err = CborUnknownError;
     char *name = NULL;
-    bool res = false;
     VERIFY_PARAM_NON_NULL(TAG, outPayload, "Invalid Parameter outPayload");
     VERIFY_PARAM_NON_NULL(TAG, objMap, "Invalid Parameter objMap");
 
@@ -1041,7 +1178,7 @@ static CborError OCParseSingleRepPayload(OCRepPayload **outPayload, CborValue *o
     {
         if (!*outPayload)
         {
-            *outPayload = OCRepPayloadCreate();
+            *outPayload = OCRepPayloadCreateInBuffer(buffer);
             if (!*outPayload)
             {
                 return CborErrorOutOfMemory;
@@ -1051,7 +1188,6 @@ static CborError OCParseSingleRepPayload(OCRepPayload **outPayload, CborValue *o
         OCRepPayload *curPayload = *outPayload;
 
         uint64_t arrayIndex = 0;
-        size_t len = 0;
         CborValue repMap;
         err = cbor_value_enter_container(objMap, &repMap);
         VERIFY_CBOR_SUCCESS_OR_OUT_OF_MEMORY(TAG, err, "Failed entering repMap");
@@ -1060,7 +1196,7 @@ static CborError OCParseSingleRepPayload(OCRepPayload **outPayload, CborValue *o
         {
             if (cbor_value_is_map(objMap) && cbor_value_is_text_string(&repMap))
             {
-                err = cbor_value_dup_text_string(&repMap, &name, &len, NULL);
+                err = OCParseTextString(&repMap, &name, buffer);
                 VERIFY_CBOR_SUCCESS_OR_OUT_OF_MEMORY(TAG, err, "Failed finding tag name in the map");
                 err = cbor_value_advance(&repMap);
                 VERIFY_CBOR_SUCCESS_OR_OUT_OF_MEMORY(TAG, err, "Failed advancing rootMap");
@@ -1071,7 +1207,7 @@ static CborError OCParseSingleRepPayload(OCRepPayload **outPayload, CborValue *o
                     (0 == strcmp(OC_RSRVD_INTERFACE, name))))
                 {
                     err = cbor_value_advance(&repMap);
-                    free(name);  // Free *TinyCBOR allocated* string.
+                    OCPayloadBufferFree(buffer, name);
                     name = NULL;
                     continue;
                 }
@@ -1101,80 +1237,7 @@ static CborError OCParseSingleRepPayload(OCRepPayload **outPayload, CborValue *o
 #endif
             }
             CborType type = cbor_value_get_type(&repMap);
-            switch (type)
-            {
-                case CborNullType:
-                    res = OCRepPayloadSetNull(curPayload, name);
-                    break;
-                case CborIntegerType:
-                    {
-                        int64_t intval = 0;
-                        err = cbor_value_get_int64(&repMap, &intval);
-                        VERIFY_CBOR_SUCCESS_OR_OUT_OF_MEMORY(TAG, err, "Failed getting int value");
-                        res = OCRepPayloadSetPropInt(curPayload, name, intval);
-                    }
-                    break;
-                case CborDoubleType:
-                    {
-                        double doubleval = 0;
-                        err = cbor_value_get_double(&repMap, &doubleval);
-                        VERIFY_CBOR_SUCCESS_OR_OUT_OF_MEMORY(TAG, err, "Failed getting double value");
-                        res = OCRepPayloadSetPropDouble(curPayload, name, doubleval);
-                    }
-                    break;
-                case CborBooleanType:
-                    {
-                        bool boolval = false;
-                        err = cbor_value_get_boolean(&repMap, &boolval);
-                        VERIFY_CBOR_SUCCESS_OR_OUT_OF_MEMORY(TAG, err, "Failed getting boolean value");
-                        res = OCRepPayloadSetPropBool(curPayload, name, boolval);
-                    }
-                    break;
-                case CborTextStringType:
-                    {
-                        char *strval = NULL;
-                        err = cbor_value_dup_text_string(&repMap, &strval, &len, NULL);
-                        VERIFY_CBOR_SUCCESS_OR_OUT_OF_MEMORY(TAG, err, "Failed getting string value");
-                        res = OCRepPayloadSetPropStringAsOwner(curPayload, name, strval);
-                    }
-                    break;
-                case CborByteStringType:
-                    {
-                        uint8_t* bytestrval = NULL;
-                        err = cbor_value_dup_byte_string(&repMap, &bytestrval, &len, NULL);
-                        VERIFY_CBOR_SUCCESS_OR_OUT_OF_MEMORY(TAG, err, "Failed getting byte string value");
-                        OCByteString tmp = {.bytes = bytestrval, .len = len};
-                        res = OCRepPayloadSetPropByteStringAsOwner(curPayload, name, &tmp);
-                    }
-                    break;
-                case CborMapType:
-                    {
-                        OCRepPayload *pl = NULL;
-                        err = OCParseSingleRepPayload(&pl, &repMap, false);
-                        VERIFY_CBOR_SUCCESS_OR_OUT_OF_MEMORY(TAG, err, "Failed setting parse single rep");
-                        res = OCRepPayloadSetPropObjectAsOwner(curPayload, name, pl);
-                    }
-                    break;
-                case CborArrayType:
-                    err = OCParseArray(curPayload, name, &repMap);
-                    if (err != CborNoError)
-                    {
-                        // OCParseArray will fail if the array contains mixed types, try
-                        // to parse as payload with non-negative integer value names
-                        OCRepPayload *pl = NULL;
-                        err = OCParseSingleRepPayload(&pl, &repMap, false);
-                        VERIFY_CBOR_SUCCESS_OR_OUT_OF_MEMORY(TAG, err, "Failed setting parse single rep");
-                        res = OCRepPayloadSetPropObjectAsOwner(curPayload, name, pl);
-                    }
-                    break;
-                default:
-                    OIC_LOG_V(ERROR, TAG, "Parsing rep property, unknown type %d", repMap.type);
-                    res = false;
-            }
-            if (type != CborArrayType)
-            {
-                err = (CborError) !res;
-            }
+            err = OCParseValue(curPayload, name, &repMap, buffer);
             VERIFY_CBOR_SUCCESS_OR_OUT_OF_MEMORY(TAG, err, "Failed setting value");
 
             if (type != CborMapType && cbor_value_is_valid(&repMap))
@@ -1182,7 +1245,7 @@ static CborError OCParseSingleRepPayload(OCRepPayload **outPayload, CborValue *o
                 err = cbor_value_advance(&repMap);
                 VERIFY_CBOR_SUCCESS_OR_OUT_OF_MEMORY(TAG, err, "Failed advance repMap");
             }
-            OICFree(name);
+            OCPayloadBufferFree(buffer, name);
             name = NULL;
             ++arrayIndex;
         }
@@ -1195,13 +1258,14 @@ static CborError OCParseSingleRepPayload(OCRepPayload **outPayload, CborValue *o
     }
 
 exit:
-    OICFree(name);
+    OCPayloadBufferFree(buffer, name);
     OCRepPayloadDestroy(*outPayload);
     *outPayload = NULL;
     return err;
 }
 
-static OCStackResult OCParseRepPayload(OCPayload **outPayload, CborValue *root)
+static OCStackResult OCParseRepPayload(OCPayload **outPayload, CborValue *root,
+        OCPayloadBuffer *buffer)
 {
     OCStackResult ret = OC_STACK_INVALID_PARAM;
     CborError err;
@@ -1221,7 +1285,7 @@ static OCStackResult OCParseRepPayload(OCPayload **outPayload, CborValue *root)
     }
     while (cbor_value_is_valid(&rootMap))
     {
-        temp = OCRepPayloadCreate();
+        temp = OCRepPayloadCreateInBuffer(buffer);
         ret = OC_STACK_NO_MEMORY;
         VERIFY_PARAM_NON_NULL(TAG, temp, "Failed allocating memory");
 
@@ -1268,7 +1332,7 @@ static OCStackResult OCParseRepPayload(OCPayload **outPayload, CborValue *root)
 
         if (cbor_value_is_map(&rootMap))
         {
-            err = OCParseSingleRepPayload(&temp, &rootMap, true);
+            err = OCParseSingleRepPayload(&temp, &rootMap, true, buffer);
             VERIFY_CBOR_SUCCESS_OR_OUT_OF_MEMORY(TAG, err, "Failed to parse single rep payload");
         }
 
@@ -1299,6 +1363,33 @@ exit:
     return ret;
 }
 
+/*
+ * Representations are parsed into an arena holding a copy of the encoded payload, so that
+ * they are allocated in a few blocks and freed together, see OCRepPayloadCreateInArena.
+ */
+static OCStackResult OCParseRepPayloadInArena(OCPayload **outPayload, const uint8_t *payload,
+        size_t size)
+{
+    OCPayloadBuffer *buffer = OCPayloadBufferCreate(payload, size);
+    if (!buffer)
+    {
+        return OC_STACK_NO_MEMORY;
+    }
+
+    OCStackResult ret = OC_STACK_MALFORMED_RESPONSE;
+    CborParser parser;
+    CborValue rootValue;
+    if (CborNoError == cbor_parser_init(OCPayloadBufferGetData(buffer), size, 0, &parser,
+            &rootValue))
+    {
+        ret = OCParseRepPayload(outPayload, &rootValue, buffer);
+    }
+
+    // the parsed payloads hold their own references
+    OCPayloadBufferRelease(buffer);
+    return ret;
+}
+
 static OCStackResult OCParsePresencePayload(OCPayload **outPayload, CborValue *rootValue)
 {
     OCStackResult ret = OC_STACK_INVALID_PARAM;
@@ -1398,3 +1489,101 @@ exit:
     OCDiagnosticPayloadDestroy(payload);
     return ret;
 }
+
+OCRepPayload* OC_CALL OCEncodedRepPayloadParseView(const OCEncodedRepPayload *payload)
+{
+    if (!payload || !payload->cborPayload.bytes)
+    {
+        return NULL;
+    }
+
+    OCPayload *view = NULL;
+    OCParseRepPayloadInArena(&view, payload->cborPayload.bytes, payload->cborPayload.len);
+    return (OCRepPayload *)view;
+}
+
+struct OCRepPayloadArrayIter
+{
+    CborParser parser;
+    CborValue element;
+    OCRepPayload *scratch;
+    bool failed;
+};
+
+OCRepPayloadArrayIter* OC_CALL OCEncodedRepPayloadGetArrayIter(const OCEncodedRepPayload *payload,
+        const char *name)
+{
+    OCRepPayloadArrayIter *iter = NULL;
+    CborValue rootValue;
+    CborValue rootMap;
+    CborValue arrayVal;
+    CborError err = CborNoError;
+    VERIFY_PARAM_NON_NULL(TAG, payload, "Invalid Parameter payload");
+    VERIFY_PARAM_NON_NULL(TAG, name, "Invalid Parameter name");
+
+    iter = (OCRepPayloadArrayIter *)OICCalloc(1, sizeof(OCRepPayloadArrayIter));
+    VERIFY_PARAM_NON_NULL(TAG, iter, "Failed allocating array iterator");
+    iter->scratch = OCRepPayloadCreate();
+    VERIFY_PARAM_NON_NULL(TAG, iter->scratch, "Failed allocating array iterator");
+
+    err = cbor_parser_init(payload->cborPayload.bytes, payload->cborPayload.len, 0,
+            &iter->parser, &rootValue);
+    VERIFY_CBOR_SUCCESS_OR_OUT_OF_MEMORY(TAG, err, "Failed initializing init value");
+    rootMap = rootValue;
+    if (cbor_value_is_array(&rootValue))
+    {
+        err = cbor_value_enter_container(&rootValue, &rootMap);
+        VERIFY_CBOR_SUCCESS_OR_OUT_OF_MEMORY(TAG, err, "Failed entering root array");
+    }
+    if (!cbor_value_is_map(&rootMap))
+    {
+        goto exit;
+    }
+    err = cbor_value_map_find_value(&rootMap, name, &arrayVal);
+    VERIFY_CBOR_SUCCESS_OR_OUT_OF_MEMORY(TAG, err, "Failed finding array");
+    if (!cbor_value_is_array(&arrayVal))
+    {
+        goto exit;
+    }
+    err = cbor_value_enter_container(&arrayVal, &iter->element);
+    VERIFY_CBOR_SUCCESS_OR_OUT_OF_MEMORY(TAG, err, "Failed entering array");
+    return iter;
+
+exit:
+    OCRepPayloadArrayIterDestroy(iter);
+    return NULL;
+}
+
+const OCRepPayloadValue* OC_CALL OCRepPayloadArrayIterNext(OCRepPayloadArrayIter *iter)
+{
+    if (!iter || iter->failed || !cbor_value_is_valid(&iter->element))
+    {
+        return NULL;
+    }
+
+    // every element replaces the one before under the same name
+    CborType type = cbor_value_get_type(&iter->element);
+    CborError err = OCParseValue(iter->scratch, "", &iter->element, NULL);
+    if (CborNoError == err && type != CborMapType && cbor_value_is_valid(&iter->element))
+    {
+        err = cbor_value_advance(&iter->element);
+    }
+    if (CborNoError != err)
+    {
+        // stop at the malformed element
+        iter->failed = true;
+        return NULL;
+    }
+    return iter->scratch->values;
+}
+
+void OC_CALL OCRepPayloadArrayIterDestroy(OCRepPayloadArrayIter *iter)
+{
+    if (!iter)
+    {
+        return;
+    }
+
+    OCRepPayloadDestroy(iter->scratch);
+    OICFree(iter);
+}
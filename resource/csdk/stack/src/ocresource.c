@@ -1303,17 +1303,12 @@ OCResource *OC_CALL FindResourceByUri(const char* resourceUri)
         return NULL;
     }
 
-    OCResource * pointer = headResource;
-    while (pointer)
+    OCResource *pointer = GetResourceFromUriIndex(resourceUri);
+    if (!pointer)
     {
-        if (strcmp(resourceUri, pointer->uri) == 0)
-        {
-            return pointer;
-        }
-        pointer = pointer->next;
+        OIC_LOG_V(INFO, TAG, "Resource %s not found", resourceUri);
     }
-    OIC_LOG_V(INFO, TAG, "Resource %s not found", resourceUri);
-    return NULL;
+    return pointer;
 }
 
 OCStackResult CheckRequestsEndpoint(const OCDevAddr *reqDevAddr,
@@ -1509,7 +1504,7 @@ OCStackResult EntityHandlerCodeToOCStackCode(OCEntityHandlerResult ehResult)
     return result;
 }
 
-static bool resourceMatchesRTFilter(OCResource *resource, char *resourceTypeFilter)
+static bool resourceMatchesRTFilter(const OCResource *resource, const char *resourceTypeFilter)
 {
     if (!resource)
     {
@@ -1542,7 +1537,7 @@ static bool resourceMatchesRTFilter(OCResource *resource, char *resourceTypeFilt
     return false;
 }
 
-static bool resourceMatchesIFFilter(OCResource *resource, char *interfaceFilter)
+static bool resourceMatchesIFFilter(const OCResource *resource, const char *interfaceFilter)
 {
     if (!resource)
     {
@@ -1582,9 +1577,9 @@ static bool resourceMatchesIFFilter(OCResource *resource, char *interfaceFilter)
  * and the resource will not be matched against them.
  * Function will return true if all non null AND non empty filters passed in find a match.
  */
-static bool includeThisResourceInResponse(OCResource *resource,
-                                          char *interfaceFilter,
-                                          char *resourceTypeFilter)
+static bool includeThisResourceInResponse(const OCResource *resource,
+                                          const char *interfaceFilter,
+                                          const char *resourceTypeFilter)
 {
     if (!resource)
     {
@@ -1872,6 +1867,396 @@ exit:
     return result;
 }
 
+/**
+ * Returns the property a resource needs to be listed in an oic.if.ll response of @p virtualUri.
+ */
+static OCResourceProperty GetDiscoverableProperty(OCVirtualResources virtualUri)
+{
+#ifdef MQ_BROKER
+    if (OC_MQ_BROKER_URI == virtualUri)
+    {
+        return OC_MQ_BROKER;
+    }
+#else
+    (void) virtualUri;
+#endif
+    return OC_DISCOVERABLE;
+}
+
+/**
+ * Builds the response to a discovery request of @p virtualUri from the resource list starting
+ * at @p resource.
+ *
+ * @return ::OC_STACK_OK on success, ::OC_STACK_NO_RESOURCE if no resource matches the query,
+ *         some other value upon failure. @p payload is NULL unless ::OC_STACK_OK is returned.
+ */
+static OCStackResult BuildDiscoveryResponse(OCVirtualResources virtualUri,
+                                            OCResource *resource,
+                                            const char *interfaceQuery,
+                                            const char *resourceTypeQuery,
+                                            OCDevAddr *devAddr,
+                                            CAEndpoint_t *networkInfo,
+                                            size_t infoSize,
+                                            OCPayload **payload)
+{
+    OCStackResult discoveryResult = discoveryPayloadCreateAndAddDeviceId(payload);
+    VERIFY_PARAM_NON_NULL(TAG, *payload, "Failed creating Discovery Payload.");
+    VERIFY_SUCCESS(discoveryResult);
+
+    OCDiscoveryPayload *discPayload = (OCDiscoveryPayload *)*payload;
+    if (interfaceQuery && 0 == strcmp(interfaceQuery, OC_RSRVD_INTERFACE_DEFAULT))
+    {
+        discoveryResult = addDiscoveryBaselineCommonProperties(discPayload);
+        VERIFY_SUCCESS(discoveryResult);
+    }
+    OCResourceProperty prop = GetDiscoverableProperty(virtualUri);
+    // A resource type query, or an interface query other than oic.if.ll/oic.if.baseline
+    // (which match every resource), only needs to visit the resources in the matching
+    // bucket of the resource index.
+    OCResourceIndexBucket *bucket = NULL;
+    bool useIndex = false;
+    if (resourceTypeQuery && *resourceTypeQuery)
+    {
+        bucket = GetResourceTypeIndexBucket(resourceTypeQuery);
+        useIndex = true;
+    }
+    else if (interfaceQuery && *interfaceQuery &&
+             0 != strcmp(interfaceQuery, OC_RSRVD_INTERFACE_LL) &&
+             0 != strcmp(interfaceQuery, OC_RSRVD_INTERFACE_DEFAULT))
+    {
+        bucket = GetResourceInterfaceIndexBucket(interfaceQuery);
+        useIndex = true;
+    }
+
+    for (OCResourceIndexEntry *entry = bucket ? bucket->entries : NULL;
+         entry && discoveryResult == OC_STACK_OK;
+         entry = (OCResourceIndexEntry *)entry->hh.next)
+    {
+        if (includeThisResourceInResponse(entry->resource, interfaceQuery, resourceTypeQuery))
+        {
+            discoveryResult = BuildVirtualResourceResponse(entry->resource,
+                                                           discPayload,
+                                                           devAddr,
+                                                           networkInfo,
+                                                           infoSize);
+        }
+    }
+    for (; !useIndex && resource && discoveryResult == OC_STACK_OK; resource = resource->next)
+    {
+        // This case will handle when no resource type and it is oic.if.ll.
+        // Do not assume check if the query is ll
+        if (!resourceTypeQuery &&
+            (interfaceQuery && 0 == strcmp(interfaceQuery, OC_RSRVD_INTERFACE_LL)))
+        {
+            // Only include discoverable type
+            if (resource->resourceProperties & prop)
+            {
+                discoveryResult = BuildVirtualResourceResponse(resource,
+                                                               discPayload,
+                                                               devAddr,
+                                                               networkInfo,
+                                                               infoSize);
+            }
+        }
+        else if (includeThisResourceInResponse(resource, interfaceQuery, resourceTypeQuery))
+        {
+            discoveryResult = BuildVirtualResourceResponse(resource,
+                                                           discPayload,
+                                                           devAddr,
+                                                           networkInfo,
+                                                           infoSize);
+        }
+        else
+        {
+            discoveryResult = OC_STACK_OK;
+        }
+    }
+    if (discPayload->resources == NULL)
+    {
+        discoveryResult = OC_STACK_NO_RESOURCE;
+        OCPayloadDestroy(*payload);
+        *payload = NULL;
+    }
+    return discoveryResult;
+
+exit:
+    OCPayloadDestroy(*payload);
+    *payload = NULL;
+    return (OC_STACK_OK != discoveryResult) ? discoveryResult : OC_STACK_NO_MEMORY;
+
+}
+
+/**
+ * Maximum number of encoded /oic/res responses kept in the discovery response cache.
+ * The least recently used response is dropped to make room for a new one.
+ */
+#define DISCOVERY_CACHE_MAX_ENTRIES 16
+
+/**
+ * Encoded /oic/res response for one combination of query filters, accept format and
+ * requesting endpoint.
+ */
+typedef struct DiscoveryCacheEntry
+{
+    /** Virtual resource the request was sent to. */
+    OCVirtualResources virtualUri;
+    /** Interface filter of the request, after the oic.if.ll default was applied. */
+    char *interfaceQuery;
+    /** Resource type filter of the request. */
+    char *resourceTypeQuery;
+    /** Format the response is encoded in. */
+    OCPayloadFormat acceptFormat;
+    /** Adapter, flags and interface of the requester select the ports and endpoints listed. */
+    OCTransportAdapter adapter;
+    OCTransportFlags flags;
+    uint32_t ifindex;
+    /** Server instance ID the response was built with. */
+    char sid[UUID_STRING_SIZE];
+    /** Encoded response. */
+    uint8_t *payload;
+    size_t payloadSize;
+    struct DiscoveryCacheEntry *next;
+} DiscoveryCacheEntry;
+
+/** Cached responses, most recently used first. */
+static DiscoveryCacheEntry *g_discoveryCache = NULL;
+static size_t g_discoveryCacheCount = 0;
+
+/** Network interfaces all cached responses were built with. */
+static CAEndpoint_t *g_discoveryCacheNetworkInfo = NULL;
+static size_t g_discoveryCacheNetworkInfoSize = 0;
+
+static uint32_t g_discoveryCacheHits = 0;
+static uint32_t g_discoveryCacheMisses = 0;
+
+static bool DiscoveryQueryEquals(const char *lhs, const char *rhs)
+{
+    return (lhs == rhs) || (lhs && rhs && 0 == strcmp(lhs, rhs));
+}
+
+static void FreeDiscoveryCacheEntry(DiscoveryCacheEntry *entry)
+{
+    if (entry)
+    {
+        OICFree(entry->interfaceQuery);
+        OICFree(entry->resourceTypeQuery);
+        OICFree(entry->payload);
+        OICFree(entry);
+    }
+}
+
+/**
+ * Whether the cached response can list @p resource in its current state, following the same
+ * rules as BuildDiscoveryResponse.
+ */
+static bool DiscoveryCacheEntryIncludes(const DiscoveryCacheEntry *entry,
+                                        const OCResource *resource)
+{
+    if (!entry->resourceTypeQuery && entry->interfaceQuery &&
+        0 == strcmp(entry->interfaceQuery, OC_RSRVD_INTERFACE_LL))
+    {
+        return (resource->resourceProperties & GetDiscoverableProperty(entry->virtualUri));
+    }
+    return includeThisResourceInResponse(resource, entry->interfaceQuery,
+                                         entry->resourceTypeQuery);
+}
+
+void InvalidateDiscoveryCache(const OCResource *resource)
+{
+    DiscoveryCacheEntry **link = &g_discoveryCache;
+    while (*link)
+    {
+        DiscoveryCacheEntry *entry = *link;
+        if (!resource || DiscoveryCacheEntryIncludes(entry, resource))
+        {
+            *link = entry->next;
+            FreeDiscoveryCacheEntry(entry);
+            g_discoveryCacheCount--;
+        }
+        else
+        {
+            link = &entry->next;
+        }
+    }
+
+    if (!g_discoveryCache)
+    {
+        OICFree(g_discoveryCacheNetworkInfo);
+        g_discoveryCacheNetworkInfo = NULL;
+        g_discoveryCacheNetworkInfoSize = 0;
+    }
+}
+
+/**
+ * Whether the response to @p request can be served from and added to the cache.
+ */
+static bool IsDiscoveryResponseCacheable(const OCServerRequest *request)
+{
+#ifdef RD_SERVER
+    // Resources published to the resource directory are read from its database, which
+    // changes without going through the stack.
+    (void) request;
+    return false;
+#else
+    switch (request->acceptFormat)
+    {
+        case OC_FORMAT_UNDEFINED:
+        case OC_FORMAT_CBOR:
+        case OC_FORMAT_VND_OCF_CBOR:
+            return true;
+        default:
+            return false;
+    }
+#endif
+}
+
+static bool DiscoveryCacheEntryMatches(const DiscoveryCacheEntry *entry,
+                                       OCVirtualResources virtualUri,
+                                       const char *interfaceQuery,
+                                       const char *resourceTypeQuery,
+                                       const OCServerRequest *request,
+                                       const char *sid)
+{
+    return entry->virtualUri == virtualUri &&
+           entry->acceptFormat == request->acceptFormat &&
+           entry->adapter == request->devAddr.adapter &&
+           entry->flags == request->devAddr.flags &&
+           entry->ifindex == request->devAddr.ifindex &&
+           DiscoveryQueryEquals(entry->interfaceQuery, interfaceQuery) &&
+           DiscoveryQueryEquals(entry->resourceTypeQuery, resourceTypeQuery) &&
+           0 == strcmp(entry->sid, sid ? sid : "");
+}
+
+/**
+ * Looks up the cached response to a discovery request.
+ *
+ * @return Encoded copy of the cached response, or NULL if there is none.
+ */
+static OCPayload *GetCachedDiscoveryResponse(OCVirtualResources virtualUri,
+                                             const char *interfaceQuery,
+                                             const char *resourceTypeQuery,
+                                             const OCServerRequest *request,
+                                             const CAEndpoint_t *networkInfo,
+                                             size_t infoSize)
+{
+    // The endpoints listed in every response depend on the network interfaces.
+    if (infoSize != g_discoveryCacheNetworkInfoSize ||
+        (infoSize && 0 != memcmp(networkInfo, g_discoveryCacheNetworkInfo,
+                                 infoSize * sizeof(CAEndpoint_t))))
+    {
+        InvalidateDiscoveryCache(NULL);
+        return NULL;
+    }
+
+    const char *sid = OCGetServerInstanceIDString();
+    for (DiscoveryCacheEntry **link = &g_discoveryCache; *link; link = &(*link)->next)
+    {
+        DiscoveryCacheEntry *entry = *link;
+        if (DiscoveryCacheEntryMatches(entry, virtualUri, interfaceQuery, resourceTypeQuery,
+                                       request, sid))
+        {
+            *link = entry->next;
+            entry->next = g_discoveryCache;
+            g_discoveryCache = entry;
+            return (OCPayload *)OCEncodedRepPayloadCreate(entry->payload, entry->payloadSize);
+        }
+    }
+    return NULL;
+}
+
+/**
+ * Encodes a built discovery response and adds it to the cache.
+ *
+ * @return Encoded copy of the response to send in place of @p payload, which is destroyed,
+ *         or @p payload itself if the response could not be cached.
+ */
+static OCPayload *CacheDiscoveryResponse(OCVirtualResources virtualUri,
+                                         const char *interfaceQuery,
+                                         const char *resourceTypeQuery,
+                                         const OCServerRequest *request,
+                                         const CAEndpoint_t *networkInfo,
+                                         size_t infoSize,
+                                         OCPayload *payload)
+{
+    OCPayload *encoded = NULL;
+    DiscoveryCacheEntry *entry = (DiscoveryCacheEntry *)OICCalloc(1, sizeof(DiscoveryCacheEntry));
+    VERIFY_PARAM_NON_NULL(TAG, entry, "Failed allocating DiscoveryCacheEntry");
+
+    if (OC_STACK_OK != OCConvertPayload(payload, request->acceptFormat,
+                                        &entry->payload, &entry->payloadSize))
+    {
+        OIC_LOG(ERROR, TAG, "Failed encoding discovery response for the cache");
+        goto exit;
+    }
+    encoded = (OCPayload *)OCEncodedRepPayloadCreate(entry->payload, entry->payloadSize);
+    VERIFY_PARAM_NON_NULL(TAG, encoded, "Failed allocating encoded discovery response");
+
+    if (interfaceQuery)
+    {
+        entry->interfaceQuery = OICStrdup(interfaceQuery);
+        VERIFY_PARAM_NON_NULL(TAG, entry->interfaceQuery, "Failed copying interface query");
+    }
+    if (resourceTypeQuery)
+    {
+        entry->resourceTypeQuery = OICStrdup(resourceTypeQuery);
+        VERIFY_PARAM_NON_NULL(TAG, entry->resourceTypeQuery, "Failed copying resource type query");
+    }
+    const char *sid = OCGetServerInstanceIDString();
+    if (sid)
+    {
+        OICStrcpy(entry->sid, sizeof(entry->sid), sid);
+    }
+    entry->virtualUri = virtualUri;
+    entry->acceptFormat = request->acceptFormat;
+    entry->adapter = request->devAddr.adapter;
+    entry->flags = request->devAddr.flags;
+    entry->ifindex = request->devAddr.ifindex;
+
+    // GetCachedDiscoveryResponse emptied the cache if the network interfaces changed.
+    if (!g_discoveryCache && infoSize)
+    {
+        g_discoveryCacheNetworkInfo = (CAEndpoint_t *)OICMalloc(infoSize * sizeof(CAEndpoint_t));
+        VERIFY_PARAM_NON_NULL(TAG, g_discoveryCacheNetworkInfo, "Failed copying network info");
+        memcpy(g_discoveryCacheNetworkInfo, networkInfo, infoSize * sizeof(CAEndpoint_t));
+        g_discoveryCacheNetworkInfoSize = infoSize;
+    }
+
+    if (g_discoveryCacheCount >= DISCOVERY_CACHE_MAX_ENTRIES)
+    {
+        DiscoveryCacheEntry **link = &g_discoveryCache;
+        while ((*link)->next)
+        {
+            link = &(*link)->next;
+        }
+        FreeDiscoveryCacheEntry(*link);
+        *link = NULL;
+        g_discoveryCacheCount--;
+    }
+    entry->next = g_discoveryCache;
+    g_discoveryCache = entry;
+    g_discoveryCacheCount++;
+
+    OCPayloadDestroy(payload);
+    return encoded;
+
+exit:
+    FreeDiscoveryCacheEntry(entry);
+    OCPayloadDestroy(encoded);
+    return payload;
+}
+
+OCStackResult OC_CALL OCGetDiscoveryCacheStats(uint32_t *hits, uint32_t *misses)
+{
+    if (!hits || !misses)
+    {
+        return OC_STACK_INVALID_PARAM;
+    }
+
+    *hits = g_discoveryCacheHits;
+    *misses = g_discoveryCacheMisses;
+    return OC_STACK_OK;
+}
+
 static OCStackResult HandleVirtualResource (OCServerRequest *request, OCResource* resource)
 {
     if (!request || !resource)
@@ -1956,55 +2341,35 @@ static OCStackResult HandleVirtualResource (OCServerRequest *request, OCResource
             interfaceQuery = OICStrdup(OC_RSRVD_INTERFACE_LL);
         }
 
-        discoveryResult = discoveryPayloadCreateAndAddDeviceId(&payload);
-        VERIFY_PARAM_NON_NULL(TAG, payload, "Failed creating Discovery Payload.");
-        VERIFY_SUCCESS(discoveryResult);
-
-        OCDiscoveryPayload *discPayload = (OCDiscoveryPayload *)payload;
-        if (interfaceQuery && 0 == strcmp(interfaceQuery, OC_RSRVD_INTERFACE_DEFAULT))
+        bool cacheable = IsDiscoveryResponseCacheable(request);
+        if (cacheable)
         {
-            discoveryResult = addDiscoveryBaselineCommonProperties(discPayload);
-            VERIFY_SUCCESS(discoveryResult);
+            payload = GetCachedDiscoveryResponse(virtualUriInRequest, interfaceQuery,
+                                                 resourceTypeQuery, request,
+                                                 networkInfo, infoSize);
         }
-        OCResourceProperty prop = OC_DISCOVERABLE;
-#ifdef MQ_BROKER
-        prop = (OC_MQ_BROKER_URI == virtualUriInRequest) ? OC_MQ_BROKER : prop;
-#endif
-        for (; resource && discoveryResult == OC_STACK_OK; resource = resource->next)
+        if (payload)
+        {
+            OIC_LOG(INFO, TAG, "Discovery response found in the cache");
+            g_discoveryCacheHits++;
+            discoveryResult = OC_STACK_OK;
+        }
+        else
         {
-            // This case will handle when no resource type and it is oic.if.ll.
-            // Do not assume check if the query is ll
-            if (!resourceTypeQuery &&
-                (interfaceQuery && 0 == strcmp(interfaceQuery, OC_RSRVD_INTERFACE_LL)))
+            discoveryResult = BuildDiscoveryResponse(virtualUriInRequest, resource,
+                                                     interfaceQuery, resourceTypeQuery,
+                                                     &request->devAddr, networkInfo, infoSize,
+                                                     &payload);
+            if (cacheable)
             {
-                // Only include discoverable type
-                if (resource->resourceProperties & prop)
+                g_discoveryCacheMisses++;
+                if (OC_STACK_OK == discoveryResult)
                 {
-                    discoveryResult = BuildVirtualResourceResponse(resource,
-                                                                   discPayload,
-                                                                   &request->devAddr,
-                                                                   networkInfo,
-                                                                   infoSize);
+                    payload = CacheDiscoveryResponse(virtualUriInRequest, interfaceQuery,
+                                                     resourceTypeQuery, request,
+                                                     networkInfo, infoSize, payload);
                 }
             }
-            else if (includeThisResourceInResponse(resource, interfaceQuery, resourceTypeQuery))
-            {
-                discoveryResult = BuildVirtualResourceResponse(resource,
-                                                               discPayload,
-                                                               &request->devAddr,
-                                                               networkInfo,
-                                                               infoSize);
-            }
-            else
-            {
-                discoveryResult = OC_STACK_OK;
-            }
-        }
-        if (discPayload->resources == NULL)
-        {
-            discoveryResult = OC_STACK_NO_RESOURCE;
-            OCPayloadDestroy(payload);
-            payload = NULL;
         }
 
         if (networkInfo)
@@ -2652,6 +3017,12 @@ static OCStackResult SetAttributeInternal(OCResource *resource,
     }
     VERIFY_PARAM_NON_NULL(TAG, resAttrib->attrValue, "Failed allocating attribute value");
 
+    // The device name is part of oic.if.baseline discovery responses.
+    if (0 == strcmp(OC_RSRVD_DEVICE_NAME, attribute))
+    {
+        InvalidateDiscoveryCache(NULL);
+    }
+
     // The resource has changed from what is stored in the database. Update the database to
     // reflect the new value.
     if (updateDatabase)
@@ -26,6 +26,7 @@
 #include "ocobserve.h"
 #include "oic_malloc.h"
 #include "oic_string.h"
+#include "utlist.h"
 #include "ocpayload.h"
 #include "ocpayloadcbor.h"
 #include "experimental/logger.h"
@@ -188,6 +189,74 @@ static OCStackResult OCSendResponse (const CAEndpoint_t *object, CAResponseInfo_
     return OC_STACK_OK;
 }
 
+/**
+ * Fill in the observe option of a notification.
+ *
+ * @param[out] option           Header option to fill in.
+ * @param[in]  sequenceNum      Observe sequence number.
+ */
+static void SetObserveOption(CAHeaderOption_t *option, uint32_t sequenceNum)
+{
+    option->protocolID = CA_COAP_ID;
+    option->optionID = COAP_OPTION_OBSERVE;
+    option->optionLength = sizeof(uint32_t);
+    uint8_t* observationData = (uint8_t*)option->optionData;
+
+    for (size_t i=sizeof(uint32_t); i; --i)
+    {
+        observationData[i-1] = sequenceNum & 0xFF;
+        sequenceNum >>=8;
+    }
+}
+
+/**
+ * Free the options and payload of a kept notification response.
+ */
+static void FreeNotificationResponse(OCNotificationResponse *response)
+{
+    OICFree(response->options);
+    response->options = NULL;
+    OICFree(response->payload);
+    response->payload = NULL;
+}
+
+/**
+ * Keep the response to a notification so that it can be sent to other observers.
+ * The observe option is left out, and the payload is taken over by the kept response.
+ *
+ * @param[out] response         Where to keep the response.
+ * @param[in]  responseInfo     Response to keep. Its first option is the observe option.
+ *
+ * @return true if the response was kept.
+ */
+static bool CaptureNotificationResponse(OCNotificationResponse *response,
+                                        const CAResponseInfo_t *responseInfo)
+{
+    uint8_t numOptions = responseInfo->info.numOptions - 1;
+    CAHeaderOption_t *options = NULL;
+    if (numOptions)
+    {
+        options = (CAHeaderOption_t *)OICMalloc(numOptions * sizeof(CAHeaderOption_t));
+        if (!options)
+        {
+            OIC_LOG(ERROR, TAG, "Memory alloc for kept notification options failed");
+            return false;
+        }
+        memcpy(options, responseInfo->info.options + 1, numOptions * sizeof(CAHeaderOption_t));
+    }
+
+    FreeNotificationResponse(response);
+    response->captured = true;
+    response->result = responseInfo->result;
+    response->numOptions = numOptions;
+    response->options = options;
+    response->payload = responseInfo->info.payload;
+    response->payloadSize = responseInfo->info.payloadSize;
+    response->payloadFormat = responseInfo->info.payloadFormat;
+    response->payloadVersion = responseInfo->info.payloadVersion;
+    return true;
+}
+
 static CAPayloadFormat_t OCToCAPayloadFormat (OCPayloadFormat ocFormat)
 {
     switch (ocFormat)
@@ -409,6 +478,11 @@ void DeleteServerRequest(OCServerRequest * serverRequest)
     if (serverRequest)
     {
         RBL_REMOVE(ServerRequestTree, &g_serverRequestTree, serverRequest);
+        if (serverRequest->notificationResponse)
+        {
+            DL_DELETE2(serverRequest->notificationResponse->requests, serverRequest,
+                       notificationPrev, notificationNext);
+        }
         OICFree(serverRequest->requestToken);
         OICFree(serverRequest);
         serverRequest = NULL;
@@ -619,17 +693,7 @@ OCStackResult HandleSingleResponse(OCEntityHandlerResponse * ehResponse)
         if(serverRequest->observeResult == OC_STACK_OK
            && serverRequest->observationOption != MAX_SEQUENCE_NUMBER + 1)
         {
-            responseInfo.info.options[0].protocolID = CA_COAP_ID;
-            responseInfo.info.options[0].optionID = COAP_OPTION_OBSERVE;
-            responseInfo.info.options[0].optionLength = sizeof(uint32_t);
-            uint8_t* observationData = (uint8_t*)responseInfo.info.options[0].optionData;
-            uint32_t observationOption= serverRequest->observationOption;
-
-            for (size_t i=sizeof(uint32_t); i; --i)
-            {
-                observationData[i-1] = observationOption & 0xFF;
-                observationOption >>=8;
-            }
+            SetObserveOption(&responseInfo.info.options[0], serverRequest->observationOption);
 
             // Point to the next header option before copying vender specific header options
             optionsPointer += 1;
@@ -766,6 +830,15 @@ OCStackResult HandleSingleResponse(OCEntityHandlerResponse * ehResponse)
         }
     }
 
+    // Other observers asking for the same representation get the same response.
+    bool payloadKept = false;
+    if (serverRequest->notificationResponse && responseInfo.info.options
+        && COAP_OPTION_OBSERVE == responseInfo.info.options[0].optionID)
+    {
+        payloadKept = CaptureNotificationResponse(serverRequest->notificationResponse,
+                                                  &responseInfo);
+    }
+
 #ifdef WITH_PRESENCE
     CATransportAdapter_t CAConnTypes[] = {
                             CA_ADAPTER_IP,
@@ -825,13 +898,102 @@ OCStackResult HandleSingleResponse(OCEntityHandlerResponse * ehResponse)
     result = OCSendResponse(&responseEndpoint, &responseInfo);
 #endif
 
-    OICFree(responseInfo.info.payload);
+    if (!payloadKept)
+    {
+        OICFree(responseInfo.info.payload);
+    }
     OICFree(responseInfo.info.options);
     //Delete the request
     DeleteServerRequest(serverRequest);
     return result;
 }
 
+OCStackResult SendNotificationResponse(const OCNotificationResponse *response,
+                                       const OCDevAddr *devAddr,
+                                       const char *resourceUri,
+                                       const CAToken_t token,
+                                       uint8_t tokenLength,
+                                       uint32_t sequenceNum,
+                                       OCQualityOfService qos)
+{
+    if (!response || !response->captured || !devAddr || !token)
+    {
+        OIC_LOG(ERROR, TAG, "SendNotificationResponse invalid parameters");
+        return OC_STACK_INVALID_PARAM;
+    }
+
+    CAEndpoint_t responseEndpoint = {.adapter = CA_DEFAULT_ADAPTER};
+    CopyDevAddrToEndpoint(devAddr, &responseEndpoint);
+
+    CAResponseInfo_t responseInfo = {.result = response->result};
+    responseInfo.info.type = (OC_HIGH_QOS == qos) ? CA_MSG_CONFIRM : CA_MSG_NONCONFIRM;
+    // To assign new messageId in CA.
+    responseInfo.info.messageId = 0;
+    responseInfo.info.dataType = CA_RESPONSE_DATA;
+    responseInfo.info.resourceUri = (CAURI_t)resourceUri;
+
+    char rspToken[CA_MAX_TOKEN_LEN + 1] = {0};
+    memcpy(rspToken, token, tokenLength);
+    responseInfo.info.token = (CAToken_t)rspToken;
+    responseInfo.info.tokenLength = tokenLength;
+
+    responseInfo.info.numOptions = response->numOptions + 1;
+    responseInfo.info.options = (CAHeaderOption_t *)
+                                  OICMalloc(responseInfo.info.numOptions *
+                                            sizeof(CAHeaderOption_t));
+    if (!responseInfo.info.options)
+    {
+        OIC_LOG(FATAL, TAG, "Memory alloc for options failed");
+        return OC_STACK_NO_MEMORY;
+    }
+    SetObserveOption(&responseInfo.info.options[0], sequenceNum);
+    if (response->numOptions)
+    {
+        memcpy(responseInfo.info.options + 1, response->options,
+               response->numOptions * sizeof(CAHeaderOption_t));
+    }
+
+    // CA copies the payload, so the kept one is shared by all observers.
+    responseInfo.isMulticast = false;
+    responseInfo.info.payload = response->payload;
+    responseInfo.info.payloadSize = response->payloadSize;
+    responseInfo.info.payloadFormat = response->payloadFormat;
+    responseInfo.info.payloadVersion = response->payloadVersion;
+
+    OCStackResult result = OCSendResponse(&responseEndpoint, &responseInfo);
+    OICFree(responseInfo.info.options);
+    return result;
+}
+
+void AttachNotificationResponse(OCServerRequest *request, OCNotificationResponse *response)
+{
+    if (!request || !response || request->notificationResponse)
+    {
+        return;
+    }
+    request->notificationResponse = response;
+    DL_APPEND2(response->requests, request, notificationPrev, notificationNext);
+}
+
+void ClearNotificationResponse(OCNotificationResponse *response)
+{
+    if (!response)
+    {
+        return;
+    }
+    // A slow response must not be kept once the response is gone.
+    OCServerRequest *request = NULL;
+    OCServerRequest *tmp = NULL;
+    DL_FOREACH_SAFE2(response->requests, request, tmp, notificationNext)
+    {
+        request->notificationResponse = NULL;
+        request->notificationPrev = NULL;
+        request->notificationNext = NULL;
+    }
+    FreeNotificationResponse(response);
+    memset(response, 0, sizeof(OCNotificationResponse));
+}
+
 OCStackResult HandleAggregateResponse(OCEntityHandlerResponse * ehResponse)
 {
     if(!ehResponse || !ehResponse->payload)
@@ -861,14 +1023,32 @@ OCStackResult HandleAggregateResponse(OCEntityHandlerResponse * ehResponse)
             VERIFY_NON_NULL(serverResponse);
         }
 
-        if(ehResponse->payload->type != PAYLOAD_TYPE_REPRESENTATION)
+        OCPayload *repPayload = ehResponse->payload;
+        if (repPayload->type == PAYLOAD_TYPE_ENCODED_REPRESENTATION)
+        {
+            // children encoded by the C++ layer are merged as representations
+            OCEncodedRepPayload *encoded = (OCEncodedRepPayload *)repPayload;
+            repPayload = NULL;
+            stackRet = OCParsePayload(&repPayload, OC_FORMAT_CBOR, PAYLOAD_TYPE_REPRESENTATION,
+                                      encoded->cborPayload.bytes, encoded->cborPayload.len);
+            if (OC_STACK_OK != stackRet)
+            {
+                OIC_LOG(ERROR, TAG, "Error parsing encoded payload");
+                goto exit;
+            }
+        }
+        else if(repPayload->type != PAYLOAD_TYPE_REPRESENTATION)
         {
             stackRet = OC_STACK_ERROR;
             OIC_LOG(ERROR, TAG, "Error adding payload, as it was the incorrect type");
             goto exit;
         }
 
-        OCRepPayload *newPayload = OCRepPayloadBatchClone((OCRepPayload *)ehResponse->payload);
+        OCRepPayload *newPayload = OCRepPayloadBatchClone((OCRepPayload *)repPayload);
+        if (repPayload != ehResponse->payload)
+        {
+            OCPayloadDestroy(repPayload);
+        }
 
         if(!serverResponse->payload)
         {
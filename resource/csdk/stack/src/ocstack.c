@@ -53,11 +53,13 @@
 #include "experimental/ocrandom.h"
 #include "oic_malloc.h"
 #include "oic_string.h"
+#include "oic_time.h"
 #include "experimental/logger.h"
 #include "trace.h"
 #include "ocserverrequest.h"
 #include "secureresourcemanager.h"
 #include "psinterface.h"
+#include "deviceonboardingstate.h"
 #include "experimental/doxmresource.h"
 #include "cacommon.h"
 #include "cainterface.h"
@@ -136,6 +138,9 @@ static OCStackState stackState = OC_STACK_UNINITIALIZED;
 
 OCResource *headResource = NULL;
 static OCResource *tailResource = NULL;
+static OCResource *resourceUriIndex = NULL;
+static OCResourceIndexBucket *resourceTypeIndex = NULL;
+static OCResourceIndexBucket *resourceInterfaceIndex = NULL;
 static OCResourceHandle platformResource = {0};
 static OCResourceHandle deviceResource = {0};
 static OCResourceHandle introspectionResource = {0};
@@ -173,6 +178,9 @@ volatile int32_t g_ocStackStartStopThreadCount = 0;
 
 bool g_multicastServerStopped = false;
 
+// Ticks at which OCProcess next has timed work to do, set by OCProcess for OCProcessWait.
+static volatile uint32_t g_processDeadline = 0;
+
 //-----------------------------------------------------------------------------
 // Macros
 //-----------------------------------------------------------------------------
@@ -191,6 +199,12 @@ bool g_multicastServerStopped = false;
 
 #define MILLISECONDS_PER_SECOND   (1000)
 
+/**
+ * Longest time OCProcessWait waits for timed work, in milliseconds. Timed work
+ * scheduled after the last OCProcess call is handled after this long at the latest.
+ */
+#define OC_PROCESS_MAX_WAIT_MS    (1000)
+
 // handle case that SCNd64 is not defined in arduino's inttypes.h
 #if defined(WITH_ARDUINO) && !defined(SCNd64)
 #define SCNd64 "lld"
@@ -214,12 +228,45 @@ static OCDoHandle GenerateInvocationHandle();
 static OCStackResult initResources();
 
 /**
- * Add a resource to the end of the linked list of resources.
+ * Add a resource to the end of the linked list of resources and to the URI index.
+ * The URI of the resource must already be set.
  *
  * @param resource Resource to be added
  */
 static void insertResource(OCResource *resource);
 
+/**
+ * Add a resource to the bucket with the specified name of a secondary resource index.
+ * The bucket is created if it does not exist yet.
+ *
+ * @param index Secondary resource index, i.e. the resource type or resource interface index.
+ * @param name Resource type or resource interface name.
+ * @param resource Resource to be added.
+ *
+ * @return ::OC_STACK_OK on success, some other value upon failure.
+ */
+static OCStackResult addResourceToIndex(OCResourceIndexBucket **index, const char *name,
+        OCResource *resource);
+
+/**
+ * Remove a resource from the bucket with the specified name of a secondary resource index.
+ * The bucket is deleted once it no longer holds any resource.
+ *
+ * @param index Secondary resource index, i.e. the resource type or resource interface index.
+ * @param name Resource type or resource interface name.
+ * @param resource Resource to be removed.
+ */
+static void removeResourceFromIndex(OCResourceIndexBucket **index, const char *name,
+        OCResource *resource);
+
+/**
+ * Remove a resource from the URI index and from the buckets of all of its resource types and
+ * resource interfaces.
+ *
+ * @param resource Resource to be removed.
+ */
+static void removeResourceFromIndexes(OCResource *resource);
+
 /**
  * Find a resource in the linked list of resources.
  *
@@ -230,16 +277,19 @@ static void insertResource(OCResource *resource);
 static OCResource *findResource(OCResource *resource);
 
 /**
- * Insert a resource type into a resource's resource type linked list.
+ * Insert a resource type into a resource's resource type linked list and into the
+ * resource type index.
  * If resource type already exists, it will not be inserted and the
  * resourceType will be free'd.
  * resourceType->next should be null to avoid memory leaks.
- * Function returns silently for null args.
+ * On failure resourceType is not free'd.
  *
  * @param resource Resource where resource type is to be inserted.
  * @param resourceType Resource type to be inserted.
+ *
+ * @return ::OC_STACK_OK on success, some other value upon failure.
  */
-static void insertResourceType(OCResource *resource,
+static OCStackResult insertResourceType(OCResource *resource,
         OCResourceType *resourceType);
 
 /**
@@ -254,15 +304,19 @@ static OCResourceType *findResourceTypeAtIndex(OCResourceHandle handle,
         uint8_t index);
 
 /**
- * Insert a resource interface into a resource's resource interface linked list.
+ * Insert a resource interface into a resource's resource interface linked list and into the
+ * resource interface index.
  * If resource interface already exists, it will not be inserted and the
  * resourceInterface will be free'd.
  * resourceInterface->next should be null to avoid memory leaks.
+ * On failure resourceInterface is not free'd.
  *
  * @param resource Resource where resource interface is to be inserted.
  * @param resourceInterface Resource interface to be inserted.
+ *
+ * @return ::OC_STACK_OK on success, some other value upon failure.
  */
-static void insertResourceInterface(OCResource *resource,
+static OCStackResult insertResourceInterface(OCResource *resource,
         OCResourceInterface *resourceInterface);
 
 /**
@@ -1831,8 +1885,22 @@ void OC_CALL OCHandleResponse(const CAEndpoint_t* endPoint, const CAResponseInfo
                 if (OCResultToSuccess(response->result) || PAYLOAD_TYPE_REPRESENTATION == type ||
                         PAYLOAD_TYPE_DIAGNOSTIC == type)
                 {
-                    if (OC_STACK_OK != OCParsePayload(&response->payload,
-                            CAToOCPayloadFormat(responseInfo->info.payloadFormat),
+                    OCPayloadFormat format = CAToOCPayloadFormat(responseInfo->info.payloadFormat);
+                    if (cbNode->encodedResponse && PAYLOAD_TYPE_REPRESENTATION == type &&
+                        (OC_FORMAT_CBOR == format || OC_FORMAT_VND_OCF_CBOR == format))
+                    {
+                        // the application decodes it straight from CBOR
+                        response->payload = (OCPayload *)OCEncodedRepPayloadCreate(
+                                responseInfo->info.payload, responseInfo->info.payloadSize);
+                        if (!response->payload)
+                        {
+                            OIC_LOG(ERROR, TAG, "Error copying payload");
+                            OICFree(response);
+                            return;
+                        }
+                    }
+                    else if (OC_STACK_OK != OCParsePayload(&response->payload,
+                            format,
                             type,
                             responseInfo->info.payload,
                             responseInfo->info.payloadSize))
@@ -1967,8 +2035,8 @@ void OC_CALL OCHandleResponse(const CAEndpoint_t* endPoint, const CAResponseInfo
                 else
                 {
                     // To keep discovery callbacks active.
-                    cbNode->TTL = GetTicks(MAX_CB_TIMEOUT_SECONDS *
-                                            MILLISECONDS_PER_SECOND);
+                    UpdateClientCBTTL(cbNode, GetTicks(MAX_CB_TIMEOUT_SECONDS *
+                                                       MILLISECONDS_PER_SECOND));
                 }
             }
 
@@ -2910,6 +2978,16 @@ OCStackResult OCDeInitializeInternal()
     DeleteClientCBList();
     // Terminate connectivity-abstraction layer.
     CATerminate();
+    // Write the updates held by persistent storage transactions, including those of an
+    // ownership transfer in progress, and release the cached state of journaled databases
+    EndOwnershipTransferTransaction();
+    FlushPSTransaction(true);
+    DeInitPSTransaction();
+    DeInitPSJournal();
+#ifdef RD_SERVER
+    // Close the connection used to answer resource directory discovery queries
+    CloseRDDatabaseDiscovery();
+#endif
 
 #if defined(TCP_ADAPTER) && defined(WITH_CLOUD)
     // Terminate the Connection Manager
@@ -3712,6 +3790,41 @@ exit:
     return result;
 }
 
+OCStackResult OC_CALL OCSetResponsePayloadEncoded(OCDoHandle handle, bool encoded)
+{
+    if (!handle)
+    {
+        return OC_STACK_INVALID_PARAM;
+    }
+
+    ClientCB *clientCB = GetClientCBUsingHandle(handle);
+    if (!clientCB)
+    {
+        OIC_LOG(ERROR, TAG, "Callback not found");
+        return OC_STACK_ERROR;
+    }
+
+    // batch responses are rearranged by HandleBatchResponse, so they stay parsed
+    bool batch = false;
+    char *interfaceName = NULL;
+    char *rtTypeName = NULL;
+    char *uriQuery = NULL;
+    char *uriWithoutQuery = NULL;
+    if (encoded && clientCB->requestUri
+        && OC_STACK_OK == getQueryFromUri(clientCB->requestUri, &uriQuery, &uriWithoutQuery)
+        && OC_STACK_OK == ExtractFiltersFromQuery(uriQuery, &interfaceName, &rtTypeName))
+    {
+        batch = interfaceName && (0 == strcmp(OC_RSRVD_INTERFACE_BATCH, interfaceName));
+    }
+    OICFree(interfaceName);
+    OICFree(rtTypeName);
+    OICFree(uriQuery);
+    OICFree(uriWithoutQuery);
+
+    clientCB->encodedResponse = encoded && !batch;
+    return OC_STACK_OK;
+}
+
 OCStackResult OC_CALL OCCancel(OCDoHandle handle, OCQualityOfService qos, OCHeaderOption * options,
         uint8_t numOptions)
 {
@@ -3850,6 +3963,12 @@ OCPersistentStorage *OC_CALL OCGetPersistentStorageHandler()
     return g_PersistentStorageHandler;
 }
 
+OCStackResult OC_CALL OCSetPersistentStorageJournal(bool enable)
+{
+    OIC_LOG_V(INFO, TAG, "Persistent storage journal %s", enable ? "enabled" : "disabled");
+    return SetPSJournalEnabled(enable);
+}
+
 #ifdef WITH_PRESENCE
 
 OCStackResult OCProcessPresence()
@@ -3948,6 +4067,63 @@ exit:
 }
 #endif // WITH_PRESENCE
 
+#ifdef WITH_PRESENCE
+/**
+ * Ticks until OCProcessPresence next has a presence timeout to handle.
+ *
+ * @param now           Current ticks.
+ * @param waitTicks     Longest wait to return.
+ * @return ticks to wait, 0 if a timeout is due now.
+ */
+static uint32_t GetPresenceWaitTicks(uint32_t now, uint32_t waitTicks)
+{
+    ClientCB* cbNode = NULL;
+    LL_FOREACH(g_cbList, cbNode)
+    {
+        if (OC_REST_PRESENCE != cbNode->method || !cbNode->presence
+            || cbNode->presence->TTLlevel > PresenceTimeOutSize)
+        {
+            continue;
+        }
+        if (cbNode->presence->TTLlevel == PresenceTimeOutSize)
+        {
+            return 0;
+        }
+
+        uint32_t timeOut = cbNode->presence->timeOut[cbNode->presence->TTLlevel];
+        if (timeOut <= now)
+        {
+            return 0;
+        }
+        if (timeOut - now < waitTicks)
+        {
+            waitTicks = timeOut - now;
+        }
+    }
+    return waitTicks;
+}
+#endif // WITH_PRESENCE
+
+/**
+ * Record when OCProcess next has presence or keepalive work, for OCProcessWait.
+ */
+static void UpdateProcessDeadline()
+{
+    uint32_t now = GetTicks(0);
+    uint32_t waitTicks = (OC_PROCESS_MAX_WAIT_MS * COAP_TICKS_PER_SECOND) / MILLISECONDS_PER_SECOND;
+#ifdef WITH_PRESENCE
+    waitTicks = GetPresenceWaitTicks(now, waitTicks);
+#endif
+#ifdef TCP_ADAPTER
+    uint64_t keepAliveUs = GetKeepAliveWaitTime();
+    if (keepAliveUs < ((uint64_t)waitTicks * US_PER_SEC) / COAP_TICKS_PER_SECOND)
+    {
+        waitTicks = (uint32_t)((keepAliveUs * COAP_TICKS_PER_SECOND) / US_PER_SEC);
+    }
+#endif
+    g_processDeadline = now + waitTicks;
+}
+
 OCStackResult OC_CALL OCProcess()
 {
     if (stackState == OC_STACK_UNINITIALIZED)
@@ -3967,9 +4143,41 @@ OCStackResult OC_CALL OCProcess()
 #ifdef TCP_ADAPTER
     ProcessKeepAlive();
 #endif
+    ExpireOwnershipTransferTransaction();
+    FlushPSTransaction(false);
+    UpdateProcessDeadline();
+    return OC_STACK_OK;
+}
+
+OCStackResult OC_CALL OCProcessWait(uint32_t timeoutMs)
+{
+    if (stackState == OC_STACK_UNINITIALIZED)
+    {
+        OIC_LOG(ERROR, TAG, "OCProcessWait has failed. ocstack is not initialized");
+        return OC_STACK_ERROR;
+    }
+
+    uint64_t waitUs = (uint64_t)timeoutMs * US_PER_MS;
+    int32_t deadlineTicks = (int32_t)(g_processDeadline - GetTicks(0));
+    uint64_t deadlineUs = (0 < deadlineTicks) ?
+            ((uint64_t)deadlineTicks * US_PER_SEC) / COAP_TICKS_PER_SECOND : 0;
+    if (deadlineUs < waitUs)
+    {
+        waitUs = deadlineUs;
+    }
+
+    if (CA_STATUS_NOT_INITIALIZED == CAWaitRequestResponse(waitUs))
+    {
+        return OC_STACK_ERROR;
+    }
     return OC_STACK_OK;
 }
 
+void OC_CALL OCCancelProcessWait()
+{
+    CACancelWaitRequestResponse();
+}
+
 #ifdef WITH_PRESENCE
 OCStackResult OC_CALL OCStartPresence(const uint32_t ttl)
 {
@@ -4170,21 +4378,11 @@ OCStackResult OC_CALL OCCreateResourceWithEp(OCResourceHandle *handle,
         return OC_STACK_INVALID_PARAM;
     }
 
-    // If the headResource is NULL, then no resources have been created...
-    pointer = headResource;
-    if (pointer)
+    // Repeated URLs are not allowed.  If a repeat is found, exit with an error
+    if (GetResourceFromUriIndex(uri))
     {
-        // At least one resources is in the resource list, so we need to search for
-        // repeated URLs, which are not allowed.  If a repeat is found, exit with an error
-        while (pointer)
-        {
-            if (strncmp(uri, pointer->uri, MAX_URI_LENGTH) == 0)
-            {
-                OIC_LOG_V(ERROR, TAG, "Resource %s already exists", uri);
-                return OC_STACK_INVALID_PARAM;
-            }
-            pointer = pointer->next;
-        }
+        OIC_LOG_V(ERROR, TAG, "Resource %s already exists", uri);
+        return OC_STACK_INVALID_PARAM;
     }
     // Create the pointer and insert it into the resource list
     pointer = (OCResource *) OICCalloc(1, sizeof(OCResource));
@@ -4195,16 +4393,18 @@ OCStackResult OC_CALL OCCreateResourceWithEp(OCResourceHandle *handle,
     }
     pointer->sequenceNum = OC_OFFSET_SEQUENCE_NUMBER;
 
-    insertResource(pointer);
-
-    // Set the uri
+    // Set the uri; it is the key of the resource in the URI index.
     pointer->uri = OICStrdup(uri);
     if (!pointer->uri)
     {
+        OICFree(pointer);
+        pointer = NULL;
         result = OC_STACK_NO_MEMORY;
         goto exit;
     }
 
+    insertResource(pointer);
+
     // Set resource to nonsecure if caller did not specify
     if ((resourceProperties & OC_MASK_RESOURCE_SECURE) == 0)
     {
@@ -4512,8 +4712,11 @@ OCStackResult BindResourceTypeToResource(OCResource* resource,
     pointer->resourcetypename = str;
     pointer->next = NULL;
 
-    insertResourceType(resource, pointer);
-    result = OC_STACK_OK;
+    result = insertResourceType(resource, pointer);
+    if (result == OC_STACK_OK)
+    {
+        InvalidateDiscoveryCache(resource);
+    }
 
 exit:
     if (result != OC_STACK_OK)
@@ -4558,9 +4761,11 @@ OCStackResult BindResourceInterfaceToResource(OCResource* resource,
     pointer->name = str;
 
     // Bind the resourceinterface to the resource
-    insertResourceInterface(resource, pointer);
-
-    result = OC_STACK_OK;
+    result = insertResourceInterface(resource, pointer);
+    if (result == OC_STACK_OK)
+    {
+        InvalidateDiscoveryCache(resource);
+    }
 
     exit:
     if (result != OC_STACK_OK)
@@ -4600,6 +4805,7 @@ OCStackResult BindTpsTypeToResource(OCResource* resource,
 
     OIC_LOG_V(INFO, TAG, "Binding %d TPS flags to %s", supportedTps, resource->uri);
     resource->endpointType = supportedTps;
+    InvalidateDiscoveryCache(resource);
     return result;
 }
 
@@ -4740,7 +4946,9 @@ OCStackResult OC_CALL OCSetResourceProperties(OCResourceHandle handle, uint8_t r
         OIC_LOG(ERROR, TAG, "Resource not found");
         return OC_STACK_NO_RESOURCE;
     }
+    InvalidateDiscoveryCache(resource);
     resource->resourceProperties = (OCResourceProperty) (resource->resourceProperties | resourceProperties);
+    InvalidateDiscoveryCache(resource);
     return OC_STACK_OK;
 }
 
@@ -4754,7 +4962,9 @@ OCStackResult OC_CALL OCClearResourceProperties(OCResourceHandle handle, uint8_t
         OIC_LOG(ERROR, TAG, "Resource not found");
         return OC_STACK_NO_RESOURCE;
     }
+    InvalidateDiscoveryCache(resource);
     resource->resourceProperties = (OCResourceProperty) (resource->resourceProperties & ~resourceProperties);
+    InvalidateDiscoveryCache(resource);
     return OC_STACK_OK;
 }
 
@@ -5098,6 +5308,7 @@ OCStackResult OCChangeResourceProperty(OCResourceProperty * inputProperty,
     {
         *inputProperty = (OCResourceProperty) (*inputProperty | resourceProperties);
     }
+    InvalidateDiscoveryCache(NULL);
     return OC_STACK_OK;
 }
 #endif
@@ -5108,6 +5319,9 @@ OCStackResult initResources()
 
     headResource = NULL;
     tailResource = NULL;
+    resourceUriIndex = NULL;
+    resourceTypeIndex = NULL;
+    resourceInterfaceIndex = NULL;
     // Init Virtual Resources
 #ifdef WITH_PRESENCE
     presenceResource.presenceTTL = OC_DEFAULT_PRESENCE_TTL_SECONDS;
@@ -5262,6 +5476,130 @@ void insertResource(OCResource *resource)
         tailResource = resource;
     }
     resource->next = NULL;
+
+    HASH_ADD_KEYPTR(hh, resourceUriIndex, resource->uri, strlen(resource->uri), resource);
+}
+
+OCResource *GetResourceFromUriIndex(const char *uri)
+{
+    OCResource *resource = NULL;
+
+    if (uri)
+    {
+        HASH_FIND_STR(resourceUriIndex, uri, resource);
+    }
+    return resource;
+}
+
+OCResourceIndexBucket *GetResourceTypeIndexBucket(const char *resourceTypeName)
+{
+    OCResourceIndexBucket *bucket = NULL;
+
+    if (resourceTypeName)
+    {
+        HASH_FIND_STR(resourceTypeIndex, resourceTypeName, bucket);
+    }
+    return bucket;
+}
+
+OCResourceIndexBucket *GetResourceInterfaceIndexBucket(const char *resourceInterfaceName)
+{
+    OCResourceIndexBucket *bucket = NULL;
+
+    if (resourceInterfaceName)
+    {
+        HASH_FIND_STR(resourceInterfaceIndex, resourceInterfaceName, bucket);
+    }
+    return bucket;
+}
+
+OCStackResult addResourceToIndex(OCResourceIndexBucket **index, const char *name,
+        OCResource *resource)
+{
+    OCResourceIndexBucket *buckets = *index;
+    OCResourceIndexBucket *bucket = NULL;
+    OCResourceIndexEntry *entry = NULL;
+
+    HASH_FIND_STR(buckets, name, bucket);
+    if (!bucket)
+    {
+        bucket = (OCResourceIndexBucket *) OICCalloc(1, sizeof(OCResourceIndexBucket));
+        if (!bucket)
+        {
+            return OC_STACK_NO_MEMORY;
+        }
+        bucket->name = OICStrdup(name);
+        if (!bucket->name)
+        {
+            OICFree(bucket);
+            return OC_STACK_NO_MEMORY;
+        }
+        HASH_ADD_KEYPTR(hh, buckets, bucket->name, strlen(bucket->name), bucket);
+        *index = buckets;
+    }
+
+    HASH_FIND_PTR(bucket->entries, &resource, entry);
+    if (entry)
+    {
+        return OC_STACK_OK;
+    }
+
+    entry = (OCResourceIndexEntry *) OICCalloc(1, sizeof(OCResourceIndexEntry));
+    if (!entry)
+    {
+        if (!bucket->entries)
+        {
+            removeResourceFromIndex(index, name, resource);
+        }
+        return OC_STACK_NO_MEMORY;
+    }
+    entry->resource = resource;
+    HASH_ADD_PTR(bucket->entries, resource, entry);
+
+    return OC_STACK_OK;
+}
+
+void removeResourceFromIndex(OCResourceIndexBucket **index, const char *name,
+        OCResource *resource)
+{
+    OCResourceIndexBucket *buckets = *index;
+    OCResourceIndexBucket *bucket = NULL;
+    OCResourceIndexEntry *entry = NULL;
+
+    HASH_FIND_STR(buckets, name, bucket);
+    if (!bucket)
+    {
+        return;
+    }
+
+    HASH_FIND_PTR(bucket->entries, &resource, entry);
+    if (entry)
+    {
+        HASH_DEL(bucket->entries, entry);
+        OICFree(entry);
+    }
+
+    if (!bucket->entries)
+    {
+        HASH_DEL(buckets, bucket);
+        OICFree(bucket->name);
+        OICFree(bucket);
+        *index = buckets;
+    }
+}
+
+void removeResourceFromIndexes(OCResource *resource)
+{
+    HASH_DELETE(hh, resourceUriIndex, resource);
+
+    for (OCResourceType *rtPtr = resource->rsrcType; rtPtr; rtPtr = rtPtr->next)
+    {
+        removeResourceFromIndex(&resourceTypeIndex, rtPtr->resourcetypename, resource);
+    }
+    for (OCResourceInterface *ifPtr = resource->rsrcInterface; ifPtr; ifPtr = ifPtr->next)
+    {
+        removeResourceFromIndex(&resourceInterfaceIndex, ifPtr->name, resource);
+    }
 }
 
 OCResource *findResource(OCResource *resource)
@@ -5312,6 +5650,8 @@ void deleteAllResources()
     deleteResource((OCResource *) presenceResource.handle);
     memset(&presenceResource, 0, sizeof(presenceResource));
 #endif // WITH_PRESENCE
+
+    InvalidateDiscoveryCache(NULL);
 }
 
 OCStackResult deleteResource(OCResource *resource)
@@ -5331,6 +5671,7 @@ OCStackResult deleteResource(OCResource *resource)
     {
         if (temp == resource)
         {
+            InvalidateDiscoveryCache(resource);
             // Invalidate all Resource Properties.
             resource->resourceProperties = (OCResourceProperty) 0;
 #ifdef WITH_PRESENCE
@@ -5369,6 +5710,7 @@ OCStackResult deleteResource(OCResource *resource)
                 prev->next = temp->next;
             }
 
+            removeResourceFromIndexes(temp);
             deleteResourceElements(temp);
             OICFree(temp);
             temp = NULL;
@@ -5466,44 +5808,47 @@ void OCDeleteResourceAttributes(OCAttribute *rsrcAttributes)
     }
 }
 
-void insertResourceType(OCResource *resource, OCResourceType *resourceType)
+OCStackResult insertResourceType(OCResource *resource, OCResourceType *resourceType)
 {
     OCResourceType *pointer = NULL;
     OCResourceType *previous = NULL;
     if (!resource || !resourceType)
     {
-        return;
+        return OC_STACK_INVALID_PARAM;
+    }
+
+    for (pointer = resource->rsrcType; pointer; pointer = pointer->next)
+    {
+        if (!strcmp(resourceType->resourcetypename, pointer->resourcetypename))
+        {
+            OIC_LOG_V(INFO, TAG, "Type %s already exists", resourceType->resourcetypename);
+            OICFree(resourceType->resourcetypename);
+            OICFree(resourceType);
+            return OC_STACK_OK;
+        }
+        previous = pointer;
+    }
+
+    if (OC_STACK_OK != addResourceToIndex(&resourceTypeIndex, resourceType->resourcetypename,
+                                          resource))
+    {
+        OIC_LOG_V(ERROR, TAG, "Failed to index type %s", resourceType->resourcetypename);
+        return OC_STACK_NO_MEMORY;
     }
+
+    resourceType->next = NULL;
     // resource type list is empty.
-    else if (!resource->rsrcType)
+    if (!previous)
     {
         resource->rsrcType = resourceType;
     }
     else
     {
-        pointer = resource->rsrcType;
-
-        while (pointer)
-        {
-            if (!strcmp(resourceType->resourcetypename, pointer->resourcetypename))
-            {
-                OIC_LOG_V(INFO, TAG, "Type %s already exists", resourceType->resourcetypename);
-                OICFree(resourceType->resourcetypename);
-                OICFree(resourceType);
-                return;
-            }
-            previous = pointer;
-            pointer = pointer->next;
-        }
-
-        if (previous)
-        {
-            previous->next = resourceType;
-        }
+        previous->next = resourceType;
     }
-    resourceType->next = NULL;
 
     OIC_LOG_V(INFO, TAG, "Added type %s to %s", resourceType->resourcetypename, resource->uri);
+    return OC_STACK_OK;
 }
 
 OCResourceType *findResourceTypeAtIndex(OCResourceHandle handle, uint8_t index)
@@ -5559,10 +5904,11 @@ OCResourceType *findResourceType(OCResourceType * resourceTypeList, const char *
  * If alredy present, 2nd arg is free'd.
  * Default interface will always be first if present.
  */
-void insertResourceInterface(OCResource *resource, OCResourceInterface *newInterface)
+OCStackResult insertResourceInterface(OCResource *resource, OCResourceInterface *newInterface)
 {
     OCResourceInterface *pointer = NULL;
     OCResourceInterface *previous = NULL;
+    OCStackResult result = OC_STACK_OK;
 
     newInterface->next = NULL;
 
@@ -5573,17 +5919,24 @@ void insertResourceInterface(OCResource *resource, OCResourceInterface *newInter
         // If first interface is not oic.if.baseline, by default add it as first interface type.
         if (0 == strcmp(newInterface->name, OC_RSRVD_INTERFACE_DEFAULT))
         {
+            result = addResourceToIndex(&resourceInterfaceIndex, newInterface->name, resource);
+            if (result != OC_STACK_OK)
+            {
+                return result;
+            }
             *firstInterface = newInterface;
         }
         else
         {
-            OCStackResult result = BindResourceInterfaceToResource(resource,
-                                                                    OC_RSRVD_INTERFACE_DEFAULT);
+            result = BindResourceInterfaceToResource(resource, OC_RSRVD_INTERFACE_DEFAULT);
             if (result != OC_STACK_OK)
             {
-                OICFree(newInterface->name);
-                OICFree(newInterface);
-                return;
+                return result;
+            }
+            result = addResourceToIndex(&resourceInterfaceIndex, newInterface->name, resource);
+            if (result != OC_STACK_OK)
+            {
+                return result;
             }
             if (*firstInterface)
             {
@@ -5598,11 +5951,16 @@ void insertResourceInterface(OCResource *resource, OCResourceInterface *newInter
         {
             OICFree(newInterface->name);
             OICFree(newInterface);
-            return;
+            return OC_STACK_OK;
         }
         // This code will not hit anymore, keeping
         else
         {
+            result = addResourceToIndex(&resourceInterfaceIndex, newInterface->name, resource);
+            if (result != OC_STACK_OK)
+            {
+                return result;
+            }
             newInterface->next = *firstInterface;
             *firstInterface = newInterface;
         }
@@ -5616,17 +5974,23 @@ void insertResourceInterface(OCResource *resource, OCResourceInterface *newInter
             {
                 OICFree(newInterface->name);
                 OICFree(newInterface);
-                return;
+                return OC_STACK_OK;
             }
             previous = pointer;
             pointer = pointer->next;
         }
 
+        result = addResourceToIndex(&resourceInterfaceIndex, newInterface->name, resource);
+        if (result != OC_STACK_OK)
+        {
+            return result;
+        }
         if (previous)
         {
             previous->next = newInterface;
         }
     }
+    return OC_STACK_OK;
 }
 
 OCResourceInterface *findResourceInterfaceAtIndex(OCResourceHandle handle,
@@ -6025,18 +6389,12 @@ OCResourceHandle OC_CALL OCGetResourceHandleAtUri(const char *uri)
         return NULL;
     }
 
-    OCResource *pointer = headResource;
-
-    while (pointer)
+    OCResource *pointer = GetResourceFromUriIndex(uri);
+    if (pointer)
     {
-        if (strncmp(uri, pointer->uri, MAX_URI_LENGTH) == 0)
-        {
-            OIC_LOG_V(DEBUG, TAG, "Found Resource %s", uri);
-            return pointer;
-        }
-        pointer = pointer->next;
+        OIC_LOG_V(DEBUG, TAG, "Found Resource %s", uri);
     }
-    return NULL;
+    return pointer;
 }
 
 static OCStackResult SetHeaderOption(CAHeaderOption_t *caHdrOpt, size_t numOptions,
@@ -617,6 +617,42 @@ void ProcessKeepAlive()
     }
 }
 
+uint64_t GetKeepAliveWaitTime()
+{
+    uint64_t waitTime = UINT64_MAX;
+    if (!g_isKeepAliveInitialized)
+    {
+        return waitTime;
+    }
+
+    uint64_t currentTime = OICGetCurrentTime(TIME_IN_US);
+    size_t len = u_arraylist_length(g_keepAliveConnectionTable);
+    for (size_t i = 0; i < len; i++)
+    {
+        KeepAliveEntry_t *entry = (KeepAliveEntry_t *)u_arraylist_get(g_keepAliveConnectionTable,
+                                                                      i);
+        if (NULL == entry)
+        {
+            continue;
+        }
+
+        // Same deadlines as ProcessKeepAlive.
+        uint64_t timeout = (OC_CLIENT == entry->mode && entry->sentPingMsg) ?
+                KEEPALIVE_RESPONSE_TIMEOUT_SEC * USECS_PER_SEC :
+                entry->interval * KEEPALIVE_RESPONSE_TIMEOUT_SEC * USECS_PER_SEC;
+        uint64_t elapsed = currentTime - entry->timeStamp;
+        if (timeout <= elapsed)
+        {
+            return 0;
+        }
+        if (timeout - elapsed < waitTime)
+        {
+            waitTime = timeout - elapsed;
+        }
+    }
+    return waitTime;
+}
+
 void IncreaseInterval(KeepAliveEntry_t *entry)
 {
     VERIFY_NON_NULL_NR(entry, FATAL);
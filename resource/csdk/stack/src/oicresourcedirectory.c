@@ -36,6 +36,7 @@
 #include "oic_string.h"
 #include "oic_time.h"
 #include "cainterface.h"
+#include "ocstackinternal.h"
 
 #define TAG "OIC_RI_RESOURCEDIRECTORY"
 
@@ -51,15 +52,18 @@ if (!(arg)) \
 
 static const char *gRDPath = "RD.db";
 
+/* Connection kept open between discovery queries, see OpenDiscoveryDatabase() */
 static sqlite3 *gRDDB = NULL;
 
-/* Column indices of RD_DEVICE_LINK_LIST table */
+/* Column indices of the discovery query */
 static const uint8_t ins_index = 0;
 static const uint8_t href_index = 1;
 static const uint8_t rel_index = 2;
 static const uint8_t anchor_index = 3;
 static const uint8_t bm_index = 4;
 static const uint8_t d_index = 5;
+static const uint8_t di_index = 6;
+static const uint8_t external_host_index = 7;
 
 /* Column indices of RD_LINK_RT table */
 static const uint8_t rt_value_index = 0;
@@ -71,6 +75,61 @@ static const uint8_t if_value_index = 0;
 static const uint8_t ep_value_index = 0;
 static const uint8_t pri_value_index = 1;
 
+/* Time to wait for a publish request to release the database, in milliseconds */
+#define RD_BUSY_TIMEOUT_MS (1000)
+
+/*
+ * All links of all devices matching a query are read with a single statement, ordered by device
+ * so that one discovery payload is built per device.
+ */
+#define RD_DISCOVER_SELECT \
+    "SELECT RD_DEVICE_LINK_LIST.ins, RD_DEVICE_LINK_LIST.href, RD_DEVICE_LINK_LIST.rel, " \
+    "RD_DEVICE_LINK_LIST.anchor, RD_DEVICE_LINK_LIST.bm, RD_DEVICE_LINK_LIST.DEVICE_ID, " \
+    "RD_DEVICE_LIST.di, RD_DEVICE_LIST.external_host FROM RD_DEVICE_LINK_LIST " \
+    "INNER JOIN RD_DEVICE_LIST ON RD_DEVICE_LINK_LIST.DEVICE_ID=RD_DEVICE_LIST.ID "
+#define RD_DISCOVER_JOIN_RT \
+    "INNER JOIN RD_LINK_RT ON RD_DEVICE_LINK_LIST.ins=RD_LINK_RT.LINK_ID "
+#define RD_DISCOVER_JOIN_IF \
+    "INNER JOIN RD_LINK_IF ON RD_DEVICE_LINK_LIST.ins=RD_LINK_IF.LINK_ID "
+#define RD_DISCOVER_WHERE "WHERE RD_DEVICE_LIST.di<>@serverId "
+#define RD_DISCOVER_FILTER_RT "AND RD_LINK_RT.rt LIKE @resourceType "
+#define RD_DISCOVER_FILTER_IF "AND RD_LINK_IF.if LIKE @interfaceType "
+#define RD_DISCOVER_ORDER "ORDER BY RD_DEVICE_LIST.ID, RD_DEVICE_LINK_LIST.ins"
+
+/*
+ * Statements used by discovery queries.  They are prepared once on the long-lived connection and
+ * reset after each use.
+ */
+typedef enum
+{
+    RD_DISCOVER_ALL = 0,
+    RD_DISCOVER_RT,
+    RD_DISCOVER_IF,
+    RD_DISCOVER_RT_IF,
+    RD_SELECT_RT,
+    RD_SELECT_IF,
+    RD_SELECT_EP,
+    RD_DELETE_EXPIRED,
+    RD_STATEMENT_COUNT
+} RDStatement;
+
+static const char *gRDStatementSql[RD_STATEMENT_COUNT] =
+{
+    RD_DISCOVER_SELECT RD_DISCOVER_WHERE RD_DISCOVER_ORDER,
+    RD_DISCOVER_SELECT RD_DISCOVER_JOIN_RT RD_DISCOVER_WHERE RD_DISCOVER_FILTER_RT
+        RD_DISCOVER_ORDER,
+    RD_DISCOVER_SELECT RD_DISCOVER_JOIN_IF RD_DISCOVER_WHERE RD_DISCOVER_FILTER_IF
+        RD_DISCOVER_ORDER,
+    RD_DISCOVER_SELECT RD_DISCOVER_JOIN_RT RD_DISCOVER_JOIN_IF RD_DISCOVER_WHERE
+        RD_DISCOVER_FILTER_RT RD_DISCOVER_FILTER_IF RD_DISCOVER_ORDER,
+    "SELECT rt FROM RD_LINK_RT WHERE LINK_ID=@id",
+    "SELECT if FROM RD_LINK_IF WHERE LINK_ID=@id",
+    "SELECT ep,pri FROM RD_LINK_EP WHERE LINK_ID=@id",
+    "DELETE FROM RD_DEVICE_LIST WHERE ttl < @ttl"
+};
+
+static sqlite3_stmt *gRDStatements[RD_STATEMENT_COUNT] = { NULL };
+
 #define VERIFY_SQLITE(arg) \
 if (SQLITE_OK != (arg)) \
 { \
@@ -87,6 +146,7 @@ OCStackResult OC_CALL OCRDDatabaseSetStorageFilename(const char *filename)
         return OC_STACK_INVALID_PARAM;
     }
     gRDPath = filename;
+    CloseRDDatabaseDiscovery();
     return OC_STACK_OK;
 }
 
@@ -103,6 +163,78 @@ static void errorCallback(void *arg, int errCode, const char *errMsg)
     OIC_LOG_V(ERROR, TAG, "SQLLite Error: %s : %d", errMsg, errCode);
 }
 
+static int GetStatement(RDStatement id, sqlite3_stmt **stmt)
+{
+    if (!gRDStatements[id])
+    {
+        int res = sqlite3_prepare_v2(gRDDB, gRDStatementSql[id], -1, &gRDStatements[id], NULL);
+        if (SQLITE_OK != res)
+        {
+            return res;
+        }
+    }
+    *stmt = gRDStatements[id];
+    return SQLITE_OK;
+}
+
+static void ReleaseStatement(sqlite3_stmt *stmt)
+{
+    if (stmt)
+    {
+        sqlite3_reset(stmt);
+        sqlite3_clear_bindings(stmt);
+    }
+}
+
+void CloseRDDatabaseDiscovery()
+{
+    for (size_t i = 0; i < RD_STATEMENT_COUNT; i++)
+    {
+        sqlite3_finalize(gRDStatements[i]);
+        gRDStatements[i] = NULL;
+    }
+    sqlite3_close(gRDDB);
+    gRDDB = NULL;
+}
+
+static OCStackResult OpenDiscoveryDatabase()
+{
+    if (gRDDB)
+    {
+        int moved = 0;
+        if ((SQLITE_OK == sqlite3_file_control(gRDDB, "main", SQLITE_FCNTL_HAS_MOVED, &moved)) &&
+                !moved)
+        {
+            return OC_STACK_OK;
+        }
+        OIC_LOG(DEBUG, TAG, "RD database file has changed, reopening it.");
+        CloseRDDatabaseDiscovery();
+    }
+
+    if (SQLITE_OK == sqlite3_config(SQLITE_CONFIG_LOG, errorCallback))
+    {
+        OIC_LOG_V(INFO, TAG, "SQLite debugging log initialized.");
+    }
+
+    OCStackResult result = OC_STACK_ERROR;
+    if (SQLITE_OK != sqlite3_open_v2(OCRDDatabaseGetStorageFilename(), &gRDDB,
+                SQLITE_OPEN_READWRITE, NULL))
+    {
+        goto exit;
+    }
+    VERIFY_SQLITE(sqlite3_busy_timeout(gRDDB, RD_BUSY_TIMEOUT_MS));
+    /* Expired devices are deleted through this connection, their links with them */
+    VERIFY_SQLITE(sqlite3_exec(gRDDB, "PRAGMA foreign_keys = ON;", NULL, NULL, NULL));
+    result = OC_STACK_OK;
+
+exit:
+    if (OC_STACK_OK != result)
+    {
+        CloseRDDatabaseDiscovery();
+    }
+    return result;
+}
+
 static OCStackResult appendStringLL(OCStringLL **type, const unsigned char *value)
 {
     OCStackResult result;
@@ -134,341 +266,131 @@ exit:
     return result;
 }
 
-/* stmt is of form "SELECT * FROM RD_DEVICE_LINK_LIST ..." */
+/* stmt is positioned on a row of the discovery query */
 static OCStackResult ResourcePayloadCreate(sqlite3_stmt *stmt, OCDevAddr *devAddr,
-        OCDiscoveryPayload *discPayload)
+        const CAEndpoint_t *networkInfo, size_t infoSize, OCDiscoveryPayload *discPayload)
 {
-    int res = sqlite3_step(stmt);
-    if (SQLITE_ROW != res)
-    {
-        return OC_STACK_NO_RESOURCE;
-    }
-
     OCStackResult result;
     OCResourcePayload *resourcePayload = NULL;
     OCEndpointPayload *epPayload = NULL;
     sqlite3_stmt *stmtRT = NULL;
     sqlite3_stmt *stmtIF = NULL;
     sqlite3_stmt *stmtEP = NULL;
-    sqlite3_stmt *stmtDI = NULL;
-    while (SQLITE_ROW == res)
-    {
-        resourcePayload = (OCResourcePayload *)OICCalloc(1, sizeof(OCResourcePayload));
-        VERIFY_NON_NULL(resourcePayload);
-
-        sqlite3_int64 id = sqlite3_column_int64(stmt, ins_index);
-        const unsigned char *uri = sqlite3_column_text(stmt, href_index);
-        const unsigned char *rel = sqlite3_column_text(stmt, rel_index);
-        const unsigned char *anchor = sqlite3_column_text(stmt, anchor_index);
-        sqlite3_int64 bitmap = sqlite3_column_int64(stmt, bm_index);
-        sqlite3_int64 deviceId = sqlite3_column_int64(stmt, d_index);
-        OIC_LOG_V(DEBUG, TAG, " %s %" PRId64, uri, (int64_t) deviceId);
-
-        resourcePayload->uri = OICStrdup((char *)uri);
-        VERIFY_NON_NULL(resourcePayload->uri)
-        if (rel)
-        {
-            resourcePayload->rel = OICStrdup((char *)rel);
-            VERIFY_NON_NULL(resourcePayload->rel);
-        }
-        if (anchor)
-        {
-            resourcePayload->anchor = OICStrdup((char *)anchor);
-            VERIFY_NON_NULL(resourcePayload->anchor);
-        }
 
-        const char rt[] = "SELECT rt FROM RD_LINK_RT WHERE LINK_ID=@id";
-        int rtSize = (int)sizeof(rt);
-        VERIFY_SQLITE(sqlite3_prepare_v2(gRDDB, rt, rtSize, &stmtRT, NULL));
-        VERIFY_SQLITE(sqlite3_bind_int64(stmtRT, sqlite3_bind_parameter_index(stmtRT, "@id"), id));
-        while (SQLITE_ROW == sqlite3_step(stmtRT))
-        {
-            const unsigned char *tempRt = sqlite3_column_text(stmtRT, rt_value_index);
-            result = appendStringLL(&resourcePayload->types, tempRt);
-            if (OC_STACK_OK != result)
-            {
-                goto exit;
-            }
-        }
-        VERIFY_SQLITE(sqlite3_finalize(stmtRT));
-        stmtRT = NULL;
-
-        const char itf[] = "SELECT if FROM RD_LINK_IF WHERE LINK_ID=@id";
-        int itfSize = (int)sizeof(itf);
-        VERIFY_SQLITE(sqlite3_prepare_v2(gRDDB, itf, itfSize, &stmtIF, NULL));
-        VERIFY_SQLITE(sqlite3_bind_int64(stmtIF, sqlite3_bind_parameter_index(stmtIF, "@id"), id));
-        while (SQLITE_ROW == sqlite3_step(stmtIF))
-        {
-            const unsigned char *tempItf = sqlite3_column_text(stmtIF, if_value_index);
-            result = appendStringLL(&resourcePayload->interfaces, tempItf);
-            if (OC_STACK_OK != result)
-            {
-                goto exit;
-            }
-        }
-        VERIFY_SQLITE(sqlite3_finalize(stmtIF));
-        stmtIF = NULL;
+    resourcePayload = (OCResourcePayload *)OICCalloc(1, sizeof(OCResourcePayload));
+    VERIFY_NON_NULL(resourcePayload);
 
-        resourcePayload->bitmap = (uint8_t)(bitmap & (OC_OBSERVABLE | OC_DISCOVERABLE));
+    sqlite3_int64 id = sqlite3_column_int64(stmt, ins_index);
+    const unsigned char *uri = sqlite3_column_text(stmt, href_index);
+    const unsigned char *rel = sqlite3_column_text(stmt, rel_index);
+    const unsigned char *anchor = sqlite3_column_text(stmt, anchor_index);
+    sqlite3_int64 bitmap = sqlite3_column_int64(stmt, bm_index);
+    sqlite3_int64 deviceId = sqlite3_column_int64(stmt, d_index);
+    OIC_LOG_V(DEBUG, TAG, " %s %" PRId64, uri, (int64_t) deviceId);
 
-        CAEndpoint_t *networkInfo = NULL;
-        size_t infoSize = 0;
-        if (devAddr)
-        {
-            CAResult_t caResult = CAGetNetworkInformation(&networkInfo, &infoSize);
-            if (CA_STATUS_FAILED == caResult)
-            {
-                OIC_LOG(WARNING, TAG, "CAGetNetworkInformation has error on parsing network infomation");
-            }
-        }
-        const char ep[] = "SELECT ep,pri FROM RD_LINK_EP WHERE LINK_ID=@id";
-        int epSize = (int)sizeof(ep);
-        VERIFY_SQLITE(sqlite3_prepare_v2(gRDDB, ep, epSize, &stmtEP, NULL));
-        VERIFY_SQLITE(sqlite3_bind_int64(stmtEP, sqlite3_bind_parameter_index(stmtEP, "@id"), id));
-        while (SQLITE_ROW == sqlite3_step(stmtEP))
-        {
-            epPayload = (OCEndpointPayload *)OICCalloc(1, sizeof(OCEndpointPayload));
-            VERIFY_NON_NULL(epPayload);
-            const unsigned char *tempEp = sqlite3_column_text(stmtEP, ep_value_index);
-            result = OCParseEndpointString((const char *)tempEp, epPayload);
-            if (OC_STACK_OK != result)
-            {
-                goto exit;
-            }
-            sqlite3_int64 pri = sqlite3_column_int64(stmtEP, pri_value_index);
-            epPayload->pri = (uint16_t)pri;
-            bool includeEp = true;
-            if (devAddr)
-            {
-                CAEndpoint_t *info = NULL;
-                for (size_t i = 0; i < infoSize; ++i)
-                {
-                    if (!strcmp(epPayload->addr, networkInfo[i].addr))
-                    {
-                        info = &networkInfo[i];
-                        break;
-                    }
-                }
-                includeEp = info &&
-                        (((OC_ADAPTER_IP | OC_ADAPTER_TCP) & (devAddr->adapter)) &&
-                        ((((CA_ADAPTER_IP | CA_ADAPTER_TCP) & info->adapter) &&
-                                (info->ifindex == devAddr->ifindex)) ||
-                                info->adapter == CA_ADAPTER_RFCOMM_BTEDR));
-            }
-            if (includeEp)
-            {
-                OCEndpointPayload **tmp = &resourcePayload->eps;
-                while (*tmp)
-                {
-                    tmp = &(*tmp)->next;
-                }
-                *tmp = epPayload;
-            }
-            else
-            {
-                OICFree(epPayload);
-            }
-            epPayload = NULL;
-        }
-        VERIFY_SQLITE(sqlite3_finalize(stmtEP));
-        stmtEP = NULL;
-        if (networkInfo)
-        {
-            OICFree(networkInfo);
-        }
-
-        const char di[] = "SELECT di FROM RD_DEVICE_LIST "
-            "INNER JOIN RD_DEVICE_LINK_LIST ON RD_DEVICE_LINK_LIST.DEVICE_ID = RD_DEVICE_LIST.ID "
-            "WHERE RD_DEVICE_LINK_LIST.DEVICE_ID=@deviceId";
-        int diSize = (int)sizeof(di);
-        const uint8_t di_index = 0;
-        VERIFY_SQLITE(sqlite3_prepare_v2(gRDDB, di, diSize, &stmtDI, NULL));
-        VERIFY_SQLITE(sqlite3_bind_int64(stmtDI, sqlite3_bind_parameter_index(stmtDI, "@deviceId"), deviceId));
-        res = sqlite3_step(stmtDI);
-        if (SQLITE_ROW == res || SQLITE_DONE == res)
-        {
-            const unsigned char *tempDi = sqlite3_column_text(stmtDI, di_index);
-            OIC_LOG_V(DEBUG, TAG, " %s", tempDi);
-            discPayload->sid = OICStrdup((char *)tempDi);
-            VERIFY_NON_NULL(discPayload->sid);
-        }
-        VERIFY_SQLITE(sqlite3_finalize(stmtDI));
-        stmtDI = NULL;
-
-        OCDiscoveryPayloadAddNewResource(discPayload, resourcePayload);
-        resourcePayload = NULL;
-        res = sqlite3_step(stmt);
-    }
-    result = OC_STACK_OK;
-
-exit:
-    sqlite3_finalize(stmtDI);
-    sqlite3_finalize(stmtEP);
-    sqlite3_finalize(stmtIF);
-    sqlite3_finalize(stmtRT);
-    OICFree(epPayload);
-    OCDiscoveryResourceDestroy(resourcePayload);
-    return result;
-}
-
-static OCStackResult CheckResources(const char *interfaceType, const char *resourceType,
-        OCDevAddr *devAddr, OCDiscoveryPayload *discPayload)
-{
-    if (!interfaceType && !resourceType)
+    resourcePayload->uri = OICStrdup((char *)uri);
+    VERIFY_NON_NULL(resourcePayload->uri)
+    if (rel)
     {
-        return OC_STACK_INVALID_QUERY;
+        resourcePayload->rel = OICStrdup((char *)rel);
+        VERIFY_NON_NULL(resourcePayload->rel);
     }
-    if (!discPayload || !discPayload->sid)
+    if (anchor)
     {
-        return OC_STACK_INTERNAL_SERVER_ERROR;
+        resourcePayload->anchor = OICStrdup((char *)anchor);
+        VERIFY_NON_NULL(resourcePayload->anchor);
     }
 
-    size_t sidLength = strlen(discPayload->sid);
-    size_t resourceTypeLength = resourceType ? strlen(resourceType) : 0;
-    size_t interfaceTypeLength = interfaceType ? strlen(interfaceType) : 0;
-
-    if ((sidLength > INT_MAX) ||
-        (resourceTypeLength > INT_MAX) ||
-        (interfaceTypeLength > INT_MAX))
+    VERIFY_SQLITE(GetStatement(RD_SELECT_RT, &stmtRT));
+    VERIFY_SQLITE(sqlite3_bind_int64(stmtRT, sqlite3_bind_parameter_index(stmtRT, "@id"), id));
+    while (SQLITE_ROW == sqlite3_step(stmtRT))
     {
-        return OC_STACK_INVALID_QUERY;
+        const unsigned char *tempRt = sqlite3_column_text(stmtRT, rt_value_index);
+        result = appendStringLL(&resourcePayload->types, tempRt);
+        if (OC_STACK_OK != result)
+        {
+            goto exit;
+        }
     }
+    ReleaseStatement(stmtRT);
+    stmtRT = NULL;
 
-    OCStackResult result = OC_STACK_OK;
-    sqlite3_stmt *stmt = NULL;
-    if (resourceType)
+    VERIFY_SQLITE(GetStatement(RD_SELECT_IF, &stmtIF));
+    VERIFY_SQLITE(sqlite3_bind_int64(stmtIF, sqlite3_bind_parameter_index(stmtIF, "@id"), id));
+    while (SQLITE_ROW == sqlite3_step(stmtIF))
     {
-        if (!interfaceType || 0 == strcmp(interfaceType, OC_RSRVD_INTERFACE_LL) ||
-                0 == strcmp(interfaceType, OC_RSRVD_INTERFACE_DEFAULT))
+        const unsigned char *tempItf = sqlite3_column_text(stmtIF, if_value_index);
+        result = appendStringLL(&resourcePayload->interfaces, tempItf);
+        if (OC_STACK_OK != result)
         {
-            const char input[] = "SELECT * FROM RD_DEVICE_LINK_LIST "
-                                "INNER JOIN RD_DEVICE_LIST ON RD_DEVICE_LINK_LIST.DEVICE_ID=RD_DEVICE_LIST.ID "
-                                "INNER JOIN RD_LINK_RT ON RD_DEVICE_LINK_LIST.INS=RD_LINK_RT.LINK_ID "
-                                "WHERE RD_DEVICE_LIST.di LIKE @di AND RD_LINK_RT.rt LIKE @resourceType";
-            int inputSize = (int)sizeof(input);
-            VERIFY_SQLITE(sqlite3_prepare_v2(gRDDB, input, inputSize, &stmt, NULL));
-            VERIFY_SQLITE(sqlite3_bind_text(stmt, sqlite3_bind_parameter_index(stmt, "@di"),
-                            discPayload->sid, (int)sidLength, SQLITE_STATIC));
-            VERIFY_SQLITE(sqlite3_bind_text(stmt, sqlite3_bind_parameter_index(stmt, "@resourceType"),
-                            resourceType, (int)resourceTypeLength, SQLITE_STATIC));
+            goto exit;
         }
-        else
-        {
-            const char input[] = "SELECT * FROM RD_DEVICE_LINK_LIST "
-                                "INNER JOIN RD_DEVICE_LIST ON RD_DEVICE_LINK_LIST.DEVICE_ID=RD_DEVICE_LIST.ID "
-                                "INNER JOIN RD_LINK_RT ON RD_DEVICE_LINK_LIST.INS=RD_LINK_RT.LINK_ID "
-                                "INNER JOIN RD_LINK_IF ON RD_DEVICE_LINK_LIST.INS=RD_LINK_IF.LINK_ID "
-                                "WHERE RD_DEVICE_LIST.di LIKE @di "
-                                "AND RD_LINK_RT.rt LIKE @resourceType "
-                                "AND RD_LINK_IF.if LIKE @interfaceType";
-            int inputSize = (int)sizeof(input);
-            VERIFY_SQLITE(sqlite3_prepare_v2(gRDDB, input, inputSize, &stmt, NULL));
-            VERIFY_SQLITE(sqlite3_bind_text(stmt, sqlite3_bind_parameter_index(stmt, "@di"),
-                            discPayload->sid, (int)sidLength, SQLITE_STATIC));
-            VERIFY_SQLITE(sqlite3_bind_text(stmt, sqlite3_bind_parameter_index(stmt, "@resourceType"),
-                            resourceType, (int)resourceTypeLength, SQLITE_STATIC));
-            VERIFY_SQLITE(sqlite3_bind_text(stmt, sqlite3_bind_parameter_index(stmt, "@interfaceType"),
-                            interfaceType, (int)interfaceTypeLength, SQLITE_STATIC));
-        }
-        result = ResourcePayloadCreate(stmt, devAddr, discPayload);
     }
-    else if (interfaceType)
+    ReleaseStatement(stmtIF);
+    stmtIF = NULL;
+
+    resourcePayload->bitmap = (uint8_t)(bitmap & (OC_OBSERVABLE | OC_DISCOVERABLE));
+
+    VERIFY_SQLITE(GetStatement(RD_SELECT_EP, &stmtEP));
+    VERIFY_SQLITE(sqlite3_bind_int64(stmtEP, sqlite3_bind_parameter_index(stmtEP, "@id"), id));
+    while (SQLITE_ROW == sqlite3_step(stmtEP))
     {
-        if (0 == strcmp(interfaceType, OC_RSRVD_INTERFACE_LL) ||
-                0 == strcmp(interfaceType, OC_RSRVD_INTERFACE_DEFAULT))
+        epPayload = (OCEndpointPayload *)OICCalloc(1, sizeof(OCEndpointPayload));
+        VERIFY_NON_NULL(epPayload);
+        const unsigned char *tempEp = sqlite3_column_text(stmtEP, ep_value_index);
+        result = OCParseEndpointString((const char *)tempEp, epPayload);
+        if (OC_STACK_OK != result)
         {
-            const char input[] = "SELECT * FROM RD_DEVICE_LINK_LIST "
-                                "INNER JOIN RD_DEVICE_LIST ON RD_DEVICE_LINK_LIST.DEVICE_ID=RD_DEVICE_LIST.ID "
-                                "WHERE RD_DEVICE_LIST.di LIKE @di";
-            int inputSize = (int)sizeof(input);
-            VERIFY_SQLITE(sqlite3_prepare_v2(gRDDB, input, inputSize, &stmt, NULL));
-            VERIFY_SQLITE(sqlite3_bind_text(stmt, sqlite3_bind_parameter_index(stmt, "@di"),
-                            discPayload->sid, (int)sidLength, SQLITE_STATIC));
+            goto exit;
         }
-        else
+        sqlite3_int64 pri = sqlite3_column_int64(stmtEP, pri_value_index);
+        epPayload->pri = (uint16_t)pri;
+        bool includeEp = true;
+        if (devAddr)
         {
-            const char input[] = "SELECT * FROM RD_DEVICE_LINK_LIST "
-                                "INNER JOIN RD_DEVICE_LIST ON RD_DEVICE_LINK_LIST.DEVICE_ID=RD_DEVICE_LIST.ID "
-                                "INNER JOIN RD_LINK_IF ON RD_DEVICE_LINK_LIST.INS=RD_LINK_IF.LINK_ID "
-                                "WHERE RD_DEVICE_LIST.di LIKE @di AND RD_LINK_IF.if LIKE @interfaceType";
-            int inputSize = (int)sizeof(input);
-            VERIFY_SQLITE(sqlite3_prepare_v2(gRDDB, input, inputSize, &stmt, NULL));
-            VERIFY_SQLITE(sqlite3_bind_text(stmt, sqlite3_bind_parameter_index(stmt, "@di"),
-                            discPayload->sid, (int)sidLength, SQLITE_STATIC));
-            VERIFY_SQLITE(sqlite3_bind_text(stmt, sqlite3_bind_parameter_index(stmt, "@interfaceType"),
-                            interfaceType, (int)interfaceTypeLength, SQLITE_STATIC));
+            const CAEndpoint_t *info = NULL;
+            for (size_t i = 0; i < infoSize; ++i)
+            {
+                if (!strcmp(epPayload->addr, networkInfo[i].addr))
+                {
+                    info = &networkInfo[i];
+                    break;
+                }
+            }
+            includeEp = info &&
+                    (((OC_ADAPTER_IP | OC_ADAPTER_TCP) & (devAddr->adapter)) &&
+                    ((((CA_ADAPTER_IP | CA_ADAPTER_TCP) & info->adapter) &&
+                            (info->ifindex == devAddr->ifindex)) ||
+                            info->adapter == CA_ADAPTER_RFCOMM_BTEDR));
         }
-        result = ResourcePayloadCreate(stmt, devAddr, discPayload);
-    }
-
-exit:
-    sqlite3_finalize(stmt);
-    return result;
-}
-
-static OCStackResult deleteResources(const char *deviceId, const int64_t *instanceIds, uint16_t nInstanceIds)
-{
-    char *delResource = NULL;
-    sqlite3_stmt *stmt = NULL;
-
-    OCStackResult result;
-    VERIFY_SQLITE(sqlite3_exec(gRDDB, "BEGIN TRANSACTION", NULL, NULL, NULL));
-
-    if (!instanceIds || !nInstanceIds)
-    {
-        static const char delDevice[] = "DELETE FROM RD_DEVICE_LIST WHERE di=@deviceId";
-        int delDeviceSize = (int)sizeof(delDevice);
-
-        VERIFY_SQLITE(sqlite3_prepare_v2(gRDDB, delDevice, delDeviceSize, &stmt, NULL));
-        VERIFY_SQLITE(sqlite3_bind_text(stmt, sqlite3_bind_parameter_index(stmt, "@deviceId"),
-                                        deviceId, (int)strlen(deviceId), SQLITE_STATIC));
-    }
-    else
-    {
-        static const char pre[] = "DELETE FROM RD_DEVICE_LINK_LIST "
-            "WHERE ins IN ("
-            "SELECT RD_DEVICE_LINK_LIST.ins FROM RD_DEVICE_LINK_LIST "
-            "INNER JOIN RD_DEVICE_LIST ON RD_DEVICE_LINK_LIST.DEVICE_ID=RD_DEVICE_LIST.ID "
-            "WHERE RD_DEVICE_LINK_LIST.ins IN (";
-        size_t inLen = nInstanceIds + (nInstanceIds - 1);
-        static const char post[] = "))";
-        size_t delResourceSize = sizeof(pre) + inLen + (sizeof(post) - 1);
-        delResource = OICCalloc(delResourceSize, 1);
-        VERIFY_NON_NULL(delResource);
-        OICStrcat(delResource, delResourceSize, pre);
-        OICStrcat(delResource, delResourceSize, "?");
-        for (uint16_t i = 1; i < nInstanceIds; ++i)
+        if (includeEp)
         {
-            OICStrcat(delResource, delResourceSize, ",?");
+            OCEndpointPayload **tmp = &resourcePayload->eps;
+            while (*tmp)
+            {
+                tmp = &(*tmp)->next;
+            }
+            *tmp = epPayload;
         }
-        OICStrcat(delResource, delResourceSize, post);
-        VERIFY_SQLITE(sqlite3_prepare_v2(gRDDB, delResource, (int)delResourceSize,
-                        &stmt, NULL));
-        for (uint16_t i = 0; i < nInstanceIds; ++i)
+        else
         {
-            VERIFY_SQLITE(sqlite3_bind_int64(stmt, 1 + i, instanceIds[i]));
+            OICFree(epPayload);
         }
+        epPayload = NULL;
     }
+    ReleaseStatement(stmtEP);
+    stmtEP = NULL;
 
-    int res = sqlite3_step(stmt);
-    if (SQLITE_DONE != res)
-    {
-        result = OC_STACK_ERROR;
-        goto exit;
-    }
-    VERIFY_SQLITE(sqlite3_finalize(stmt));
-    stmt = NULL;
-
-    VERIFY_SQLITE(sqlite3_exec(gRDDB, "COMMIT", NULL, NULL, NULL));
+    OCDiscoveryPayloadAddNewResource(discPayload, resourcePayload);
+    resourcePayload = NULL;
     result = OC_STACK_OK;
 
 exit:
-    OICFree(delResource);
-    sqlite3_finalize(stmt);
-    if (OC_STACK_OK != result)
-    {
-        sqlite3_exec(gRDDB, "ROLLBACK", NULL, NULL, NULL);
-    }
+    ReleaseStatement(stmtEP);
+    ReleaseStatement(stmtIF);
+    ReleaseStatement(stmtRT);
+    OICFree(epPayload);
+    OCDiscoveryResourceDestroy(resourcePayload);
     return result;
 }
 
@@ -478,30 +400,24 @@ static OCStackResult DeleteExpiredResources()
     OCStackResult result;
 
     uint64_t ttl = OICGetCurrentTime(TIME_IN_US);
-    static const char lapsed[] = "SELECT di FROM RD_DEVICE_LIST WHERE ttl < @ttl";
-    int lapsedSize = (int)sizeof(lapsed);
-    VERIFY_SQLITE(sqlite3_prepare_v2(gRDDB, lapsed, lapsedSize, &stmt, NULL));
+    VERIFY_SQLITE(GetStatement(RD_DELETE_EXPIRED, &stmt));
     VERIFY_SQLITE(sqlite3_bind_int64(stmt, sqlite3_bind_parameter_index(stmt, "@ttl"),
                                      (int64_t)ttl));
-
-    while (SQLITE_ROW == sqlite3_step(stmt))
+    if (SQLITE_DONE != sqlite3_step(stmt))
     {
-        const unsigned char *di = sqlite3_column_text(stmt, 0);
-        if (SQLITE_OK != deleteResources((const char *)di, NULL, 0))
-        {
-            OIC_LOG_V(WARNING, TAG, "Error in deleteResources, Error Message: %s", sqlite3_errmsg(gRDDB));
-        }
-        else
-        {
-            OIC_LOG_V(INFO, TAG, "Deleted resources with di=%s", di);
-        }
+        OIC_LOG_V(WARNING, TAG, "Error deleting expired resources, Error Message: %s",
+                  sqlite3_errmsg(gRDDB));
+        result = OC_STACK_ERROR;
+        goto exit;
+    }
+    if (sqlite3_changes(gRDDB))
+    {
+        OIC_LOG_V(INFO, TAG, "Deleted resources of %d expired devices", sqlite3_changes(gRDDB));
     }
-    VERIFY_SQLITE(sqlite3_finalize(stmt));
-    stmt = NULL;
     result = OC_STACK_OK;
 
  exit:
-    sqlite3_finalize(stmt);
+    ReleaseStatement(stmt);
     return result;
 }
 
@@ -518,6 +434,8 @@ OCStackResult OC_CALL OCRDDatabaseDiscoveryPayloadCreateWithEp(const char *inter
     OCDiscoveryPayload *head = NULL;
     OCDiscoveryPayload **tail = &head;
     sqlite3_stmt *stmt = NULL;
+    CAEndpoint_t *networkInfo = NULL;
+    size_t infoSize = 0;
 
     if (*payload)
     {
@@ -530,50 +448,106 @@ OCStackResult OC_CALL OCRDDatabaseDiscoveryPayloadCreateWithEp(const char *inter
         goto exit;
     }
 
-    if (SQLITE_OK == sqlite3_config(SQLITE_CONFIG_LOG, errorCallback))
+    if (!interfaceType && !resourceType)
     {
-        OIC_LOG_V(INFO, TAG, "SQLite debugging log initialized.");
+        result = OC_STACK_NO_RESOURCE;
+        goto exit;
     }
-    sqlite3_open_v2(OCRDDatabaseGetStorageFilename(), &gRDDB, SQLITE_OPEN_READWRITE, NULL);
-    if (!gRDDB)
+
+    const char *serverID = OCGetServerInstanceIDString();
+    if (!serverID)
+    {
+        serverID = "";
+    }
+    size_t serverIDLength = strlen(serverID);
+    size_t resourceTypeLength = resourceType ? strlen(resourceType) : 0;
+    size_t interfaceTypeLength = interfaceType ? strlen(interfaceType) : 0;
+    if ((serverIDLength > INT_MAX) ||
+        (resourceTypeLength > INT_MAX) ||
+        (interfaceTypeLength > INT_MAX))
+    {
+        result = OC_STACK_INVALID_QUERY;
+        goto exit;
+    }
+
+    result = OpenDiscoveryDatabase();
+    if (OC_STACK_OK != result)
     {
-        result = OC_STACK_ERROR;
         goto exit;
     }
 
     DeleteExpiredResources();
 
-    const char *serverID = OCGetServerInstanceIDString();
-    const char input[] = "SELECT di, external_host FROM RD_DEVICE_LIST";
-    int inputSize = (int)sizeof(input);
-    const uint8_t di_index = 0;
-    const uint8_t external_host_index = 1;
-    VERIFY_SQLITE(sqlite3_prepare_v2(gRDDB, input, inputSize, &stmt, NULL));
-    while (SQLITE_ROW == sqlite3_step(stmt))
+    bool filterRT = (NULL != resourceType);
+    bool filterIF = interfaceType &&
+            (0 != strcmp(interfaceType, OC_RSRVD_INTERFACE_LL)) &&
+            (0 != strcmp(interfaceType, OC_RSRVD_INTERFACE_DEFAULT));
+    RDStatement query = filterRT ? (filterIF ? RD_DISCOVER_RT_IF : RD_DISCOVER_RT) :
+            (filterIF ? RD_DISCOVER_IF : RD_DISCOVER_ALL);
+    VERIFY_SQLITE(GetStatement(query, &stmt));
+    VERIFY_SQLITE(sqlite3_bind_text(stmt, sqlite3_bind_parameter_index(stmt, "@serverId"),
+                    serverID, (int)serverIDLength, SQLITE_STATIC));
+    if (filterRT)
+    {
+        VERIFY_SQLITE(sqlite3_bind_text(stmt, sqlite3_bind_parameter_index(stmt, "@resourceType"),
+                        resourceType, (int)resourceTypeLength, SQLITE_STATIC));
+    }
+    if (filterIF)
+    {
+        VERIFY_SQLITE(sqlite3_bind_text(stmt, sqlite3_bind_parameter_index(stmt, "@interfaceType"),
+                        interfaceType, (int)interfaceTypeLength, SQLITE_STATIC));
+    }
+
+    if (endpoint)
     {
-        const unsigned char *di = sqlite3_column_text(stmt, di_index);
-        if (0 == strcmp((const char *)di, serverID))
+        CAResult_t caResult = CAGetNetworkInformation(&networkInfo, &infoSize);
+        if (CA_STATUS_FAILED == caResult)
         {
-            continue;
+            OIC_LOG(WARNING, TAG, "CAGetNetworkInformation has error on parsing network infomation");
         }
-        sqlite3_int64 externalHost = sqlite3_column_int64(stmt, external_host_index);
-        *tail = OCDiscoveryPayloadCreate();
-        result = OC_STACK_INTERNAL_SERVER_ERROR;
-        VERIFY_NON_NULL(*tail);
-        (*tail)->sid = (char *)OICCalloc(1, UUID_STRING_SIZE);
-        VERIFY_NON_NULL((*tail)->sid);
-        memcpy((*tail)->sid, di, UUID_STRING_SIZE);
-        result = CheckResources(interfaceType, resourceType, externalHost ? NULL : endpoint, *tail);
-        if (OC_STACK_OK == result)
+    }
+
+    /* Rows are ordered by device, a new discovery payload is started when the device changes */
+    sqlite3_int64 deviceId = 0;
+    OCDiscoveryPayload *device = NULL;
+    OCDevAddr *devAddr = NULL;
+    int res;
+    while (SQLITE_ROW == (res = sqlite3_step(stmt)))
+    {
+        sqlite3_int64 rowDeviceId = sqlite3_column_int64(stmt, d_index);
+        if (rowDeviceId != deviceId)
         {
-            tail = &(*tail)->next;
+            deviceId = rowDeviceId;
+            if (*tail)
+            {
+                tail = &(*tail)->next;
+            }
+            device = OCDiscoveryPayloadCreate();
+            VERIFY_NON_NULL(device);
+            *tail = device;
+            device->sid = OICStrdup((const char *)sqlite3_column_text(stmt, di_index));
+            VERIFY_NON_NULL(device->sid);
+            devAddr = sqlite3_column_int64(stmt, external_host_index) ? NULL : endpoint;
         }
-        else
+        else if (!device)
+        {
+            /* An earlier resource of this device could not be added */
+            continue;
+        }
+        if (OC_STACK_OK != ResourcePayloadCreate(stmt, devAddr, networkInfo, infoSize, device))
         {
-            OCPayloadDestroy((OCPayload *) *tail);
+            OIC_LOG_V(ERROR, TAG, "Skipping resources of %s", device->sid);
+            OCPayloadDestroy((OCPayload *) device);
             *tail = NULL;
+            device = NULL;
         }
     }
+    if (SQLITE_DONE != res)
+    {
+        OIC_LOG_V(ERROR, TAG, "Error in discovery query, Error Message: %s", sqlite3_errmsg(gRDDB));
+        result = OC_STACK_ERROR;
+        goto exit;
+    }
     result = head ? OC_STACK_OK : OC_STACK_NO_RESOURCE;
 
 exit:
@@ -583,8 +557,8 @@ exit:
         head = NULL;
     }
     *payload = head;
-    sqlite3_finalize(stmt);
-    sqlite3_close(gRDDB);
+    OICFree(networkInfo);
+    ReleaseStatement(stmt);
     return result;
 }
 #endif
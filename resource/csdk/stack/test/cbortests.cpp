@@ -27,6 +27,8 @@ extern "C"
     #include "ocpayloadcbor.h"
     #include "experimental/logger.h"
     #include "oic_malloc.h"
+    #include "oic_string.h"
+    #include "oic_time.h"
 }
 
 #include <gtest/gtest.h>
@@ -432,3 +434,633 @@ TEST(CborEmptyArrayTest, EmptyArrayArraySetGetTest)
     OCRepPayloadDestroy(payload_in);
 }
 
+
+//-----------------------------------------------------------------------------
+// Conversion throughput of representative payloads. Nothing is asserted about
+// the timings, they are logged for comparison between builds.
+//-----------------------------------------------------------------------------
+#define CONVERT_ITERATIONS 2000
+#define DISCOVERY_RESOURCES 20
+#define REP_PROPERTIES 40
+
+static OCDiscoveryPayload *createDiscoveryPayload()
+{
+    OCDiscoveryPayload *payload = OCDiscoveryPayloadCreate();
+    if (!payload)
+    {
+        return NULL;
+    }
+    payload->sid = OICStrdup("0685B960-736F-46F7-BEC0-9E6CBD61ADC1");
+    payload->name = OICStrdup("benchmark device");
+    OCResourcePayloadAddStringLL(&payload->type, OC_RSRVD_RESOURCE_TYPE_RES);
+    OCResourcePayloadAddStringLL(&payload->iface, OC_RSRVD_INTERFACE_LL);
+    OCResourcePayloadAddStringLL(&payload->iface, OC_RSRVD_INTERFACE_DEFAULT);
+
+    for (int i = 0; i < DISCOVERY_RESOURCES; i++)
+    {
+        OCResourcePayload *resource = (OCResourcePayload *)OICCalloc(1, sizeof(OCResourcePayload));
+        if (!resource)
+        {
+            break;
+        }
+        char uri[32];
+        snprintf(uri, sizeof(uri), "/a/light/%d", i);
+        resource->uri = OICStrdup(uri);
+        OCResourcePayloadAddStringLL(&resource->types, "core.light");
+        OCResourcePayloadAddStringLL(&resource->types, "core.brightlight");
+        OCResourcePayloadAddStringLL(&resource->interfaces, OC_RSRVD_INTERFACE_DEFAULT);
+        OCResourcePayloadAddStringLL(&resource->interfaces, OC_RSRVD_INTERFACE_READ);
+        resource->bitmap = OC_DISCOVERABLE | OC_OBSERVABLE;
+        resource->port = 5683;
+        OCDiscoveryPayloadAddNewResource(payload, resource);
+    }
+    return payload;
+}
+
+static OCRepPayload *createRepPayload()
+{
+    OCRepPayload *payload = OCRepPayloadCreate();
+    if (!payload)
+    {
+        return NULL;
+    }
+    OCRepPayloadSetUri(payload, "/a/benchmark");
+    OCRepPayloadAddResourceType(payload, "core.benchmark");
+    OCRepPayloadAddInterface(payload, OC_RSRVD_INTERFACE_DEFAULT);
+    for (int i = 0; i < REP_PROPERTIES; i++)
+    {
+        char name[32];
+        snprintf(name, sizeof(name), "int%d", i);
+        OCRepPayloadSetPropInt(payload, name, i * 1000);
+        snprintf(name, sizeof(name), "double%d", i);
+        OCRepPayloadSetPropDouble(payload, name, i / 3.0);
+        snprintf(name, sizeof(name), "string%d", i);
+        OCRepPayloadSetPropString(payload, name, "the quick brown fox jumps over the lazy dog");
+    }
+    return payload;
+}
+
+// Returns conversions per second and the size of the encoded payload.
+static uint64_t measureConversions(OCPayload *payload, size_t *encodedSize)
+{
+    uint64_t beg = OICGetCurrentTime(TIME_IN_US);
+    for (int i = 0; i < CONVERT_ITERATIONS; i++)
+    {
+        uint8_t *cbor = NULL;
+        size_t size = 0;
+        EXPECT_EQ(OC_STACK_OK, OCConvertPayload(payload, OC_FORMAT_CBOR, &cbor, &size));
+        *encodedSize = size;
+        OICFree(cbor);
+    }
+    uint64_t elapsed = OICGetCurrentTime(TIME_IN_US) - beg;
+    return (uint64_t)CONVERT_ITERATIONS * 1000000 / (elapsed ? elapsed : 1);
+}
+
+TEST(CborConvertBenchmark, DiscoveryRepAndIntrospection)
+{
+    size_t size = 0;
+
+    OCDiscoveryPayload *discovery = createDiscoveryPayload();
+    ASSERT_TRUE(discovery != NULL);
+    uint64_t rate = measureConversions((OCPayload *)discovery, &size);
+    printf("discovery payload: %zu bytes, %llu conversions/s\n", size, (unsigned long long)rate);
+    OCDiscoveryPayloadDestroy(discovery);
+
+    OCRepPayload *rep = createRepPayload();
+    ASSERT_TRUE(rep != NULL);
+    rate = measureConversions((OCPayload *)rep, &size);
+    printf("rep payload: %zu bytes, %llu conversions/s\n", size, (unsigned long long)rate);
+
+    // introspection data is served as already encoded CBOR
+    uint8_t *cbor = NULL;
+    ASSERT_EQ(OC_STACK_OK, OCConvertPayload((OCPayload *)rep, OC_FORMAT_CBOR, &cbor, &size));
+    OCRepPayloadDestroy(rep);
+    OCIntrospectionPayload *introspection = OCIntrospectionPayloadCreateFromCbor(cbor, size);
+    OICFree(cbor);
+    ASSERT_TRUE(introspection != NULL);
+    rate = measureConversions((OCPayload *)introspection, &size);
+    printf("introspection payload: %zu bytes, %llu conversions/s\n", size, (unsigned long long)rate);
+    OCIntrospectionPayloadDestroy(introspection);
+
+    // a small payload takes the path without a second encoding
+    OCRepPayload *small = OCRepPayloadCreate();
+    ASSERT_TRUE(small != NULL);
+    OCRepPayloadSetPropInt(small, "scale", 4);
+    rate = measureConversions((OCPayload *)small, &size);
+    printf("small rep payload: %zu bytes, %llu conversions/s\n", size, (unsigned long long)rate);
+    OCRepPayloadDestroy(small);
+}
+
+//-----------------------------------------------------------------------------
+// Property lookup: from REP_INDEX_THRESHOLD values on, the setters of OCRepPayload index
+// values by name in a hash, which the getters read without changing it.
+//-----------------------------------------------------------------------------
+#define MANY_PROPERTIES 512
+
+static void propertyName(char *name, size_t size, int i)
+{
+    snprintf(name, size, "x.org.iotivity.property%d", i);
+}
+
+TEST(RepPayloadLookupTest, ManyProperties)
+{
+    OCRepPayload *payload = OCRepPayloadCreate();
+    ASSERT_TRUE(payload != NULL);
+
+    char name[64];
+    for (int i = 0; i < MANY_PROPERTIES; i++)
+    {
+        propertyName(name, sizeof(name), i);
+        EXPECT_TRUE(OCRepPayloadSetPropInt(payload, name, i));
+    }
+    // replacing keeps the value in place
+    EXPECT_TRUE(OCRepPayloadSetPropString(payload, "x.org.iotivity.property7", "seven"));
+
+    size_t count = 0;
+    for (OCRepPayloadValue *val = payload->values; val; val = val->next)
+    {
+        count++;
+    }
+    EXPECT_EQ((size_t)MANY_PROPERTIES, count);
+
+    for (int i = 0; i < MANY_PROPERTIES; i++)
+    {
+        propertyName(name, sizeof(name), i);
+        int64_t value = -1;
+        if (7 == i)
+        {
+            char *str = NULL;
+            EXPECT_TRUE(OCRepPayloadGetPropString(payload, name, &str));
+            EXPECT_STREQ("seven", str);
+            OICFree(str);
+        }
+        else
+        {
+            EXPECT_TRUE(OCRepPayloadGetPropInt(payload, name, &value));
+            EXPECT_EQ(i, value);
+        }
+    }
+    EXPECT_TRUE(OCRepPayloadIsNull(payload, "x.org.iotivity.missing"));
+
+    // values appended directly are found
+    OCRepPayloadValue *tail = payload->values;
+    while (tail->next)
+    {
+        tail = tail->next;
+    }
+    tail->next = (OCRepPayloadValue *)OICCalloc(1, sizeof(OCRepPayloadValue));
+    ASSERT_TRUE(tail->next != NULL);
+    tail->next->name = OICStrdup("appended");
+    tail->next->type = OCREP_PROP_BOOL;
+    tail->next->b = true;
+    bool b = false;
+    EXPECT_TRUE(OCRepPayloadGetPropBool(payload, "appended", &b));
+    EXPECT_TRUE(b);
+    // before and after the next setter indexes them
+    EXPECT_TRUE(OCRepPayloadSetPropInt(payload, "set", 1));
+    b = false;
+    EXPECT_TRUE(OCRepPayloadGetPropBool(payload, "appended", &b));
+    EXPECT_TRUE(b);
+    EXPECT_TRUE(OCRepPayloadSetPropBool(payload, "appended", false));
+    EXPECT_TRUE(OCRepPayloadGetPropBool(payload, "appended", &b));
+    EXPECT_FALSE(b);
+
+    // and so are values of a list replaced directly
+    OCRepPayload *other = OCRepPayloadCreate();
+    ASSERT_TRUE(other != NULL);
+    EXPECT_TRUE(OCRepPayloadSetPropInt(other, "replaced", 1));
+    OCRepPayloadValue *values = payload->values;
+    payload->values = other->values;
+    other->values = values;
+    int64_t value = 0;
+    EXPECT_TRUE(OCRepPayloadGetPropInt(payload, "replaced", &value));
+    EXPECT_FALSE(OCRepPayloadGetPropInt(payload, "x.org.iotivity.property0", &value));
+    EXPECT_TRUE(OCRepPayloadGetPropInt(other, "x.org.iotivity.property0", &value));
+
+    OCRepPayload *clone = OCRepPayloadClone(other);
+    ASSERT_TRUE(clone != NULL);
+    EXPECT_TRUE(OCRepPayloadGetPropInt(clone, "x.org.iotivity.property511", &value));
+    EXPECT_EQ(511, value);
+
+    OCRepPayloadDestroy(clone);
+    OCRepPayloadDestroy(other);
+    OCRepPayloadDestroy(payload);
+}
+
+// Prints the time to set and to get each of 8, 64 and 512 properties.
+TEST(RepPayloadLookupBenchmark, SetAndGet)
+{
+    static const int counts[] = { 8, 64, MANY_PROPERTIES };
+    char names[MANY_PROPERTIES][64];
+    for (int i = 0; i < MANY_PROPERTIES; i++)
+    {
+        propertyName(names[i], sizeof(names[i]), i);
+    }
+
+    for (size_t c = 0; c < sizeof(counts) / sizeof(counts[0]); c++)
+    {
+        int count = counts[c];
+        int rounds = 4 * MANY_PROPERTIES / count;
+        uint64_t setTime = 0;
+        uint64_t getTime = 0;
+        for (int r = 0; r < rounds; r++)
+        {
+            OCRepPayload *payload = OCRepPayloadCreate();
+            ASSERT_TRUE(payload != NULL);
+
+            uint64_t beg = OICGetCurrentTime(TIME_IN_US);
+            for (int i = 0; i < count; i++)
+            {
+                OCRepPayloadSetPropInt(payload, names[i], i);
+            }
+            uint64_t mid = OICGetCurrentTime(TIME_IN_US);
+            for (int i = 0; i < count; i++)
+            {
+                int64_t value = 0;
+                EXPECT_TRUE(OCRepPayloadGetPropInt(payload, names[i], &value));
+            }
+            uint64_t end = OICGetCurrentTime(TIME_IN_US);
+
+            setTime += mid - beg;
+            getTime += end - mid;
+            OCRepPayloadDestroy(payload);
+        }
+        printf("%d properties: %.3f us per set, %.3f us per get\n", count,
+               (double)setTime / rounds / count, (double)getTime / rounds / count);
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Views: OCEncodedRepPayloadParseView parses into payloads whose names, strings and byte
+// strings point into one retained copy of the CBOR.
+//-----------------------------------------------------------------------------
+#define VIEW_ARRAY_LENGTH 1000
+
+static OCEncodedRepPayload *encodeRepPayload(OCRepPayload *payload)
+{
+    uint8_t *cbor = NULL;
+    size_t size = 0;
+    if (OC_STACK_OK != OCConvertPayload((OCPayload *)payload, OC_FORMAT_CBOR, &cbor, &size))
+    {
+        return NULL;
+    }
+    return OCEncodedRepPayloadCreateAsOwner(cbor, size);
+}
+
+static OCRepPayload *createViewRepPayload()
+{
+    OCRepPayload *payload = createRepPayload();
+    if (!payload)
+    {
+        return NULL;
+    }
+    static uint8_t bytes[] = { 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09,
+                               0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f, 0x10, 0x11, 0x12, 0x13,
+                               0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0x1a, 0x1b, 0x1c, 0x1d };
+    OCByteString byteString = { bytes, sizeof(bytes) };
+    OCRepPayloadSetPropByteString(payload, "bytes", byteString);
+
+    const char *strings[] = { "red", "green", "blue" };
+    size_t dimensions[MAX_REP_ARRAY_DEPTH] = { 3, 0, 0 };
+    OCRepPayloadSetStringArray(payload, "colors", strings, dimensions);
+
+    OCRepPayload *child = OCRepPayloadCreate();
+    OCRepPayloadSetPropString(child, "name", "child");
+    OCRepPayloadSetPropByteString(child, "bytes", byteString);
+    OCRepPayloadSetPropObjectAsOwner(payload, "child", child);
+    return payload;
+}
+
+static void expectSameValues(OCRepPayload *expected, OCRepPayload *actual)
+{
+    uint8_t *expectedCbor = NULL;
+    size_t expectedSize = 0;
+    uint8_t *actualCbor = NULL;
+    size_t actualSize = 0;
+    ASSERT_EQ(OC_STACK_OK, OCConvertPayload((OCPayload *)expected, OC_FORMAT_CBOR,
+                                            &expectedCbor, &expectedSize));
+    ASSERT_EQ(OC_STACK_OK, OCConvertPayload((OCPayload *)actual, OC_FORMAT_CBOR,
+                                            &actualCbor, &actualSize));
+    ASSERT_EQ(expectedSize, actualSize);
+    EXPECT_EQ(0, memcmp(expectedCbor, actualCbor, expectedSize));
+    OICFree(expectedCbor);
+    OICFree(actualCbor);
+}
+
+TEST(RepPayloadViewTest, SameAsParsePayload)
+{
+    OCRepPayload *payload = createViewRepPayload();
+    ASSERT_TRUE(payload != NULL);
+    OCEncodedRepPayload *encoded = encodeRepPayload(payload);
+    ASSERT_TRUE(encoded != NULL);
+
+    OCPayload *copy = NULL;
+    ASSERT_EQ(OC_STACK_OK, OCParsePayload(&copy, OC_FORMAT_CBOR, PAYLOAD_TYPE_REPRESENTATION,
+                                          encoded->cborPayload.bytes, encoded->cborPayload.len));
+    OCRepPayload *view = OCEncodedRepPayloadParseView(encoded);
+    ASSERT_TRUE(view != NULL);
+
+    // the view does not depend on the encoded payload
+    OCEncodedRepPayloadDestroy(encoded);
+    expectSameValues((OCRepPayload *)copy, view);
+    EXPECT_STREQ("/a/benchmark", view->uri);
+
+    char *str = NULL;
+    EXPECT_TRUE(OCRepPayloadGetPropString(view, "string3", &str));
+    EXPECT_STREQ("the quick brown fox jumps over the lazy dog", str);
+    OICFree(str);
+    OCByteString byteString = { NULL, 0 };
+    EXPECT_TRUE(OCRepPayloadGetPropByteString(view, "bytes", &byteString));
+    EXPECT_EQ(30u, byteString.len);
+    EXPECT_EQ(0x1d, byteString.bytes[29]);
+    OICFree(byteString.bytes);
+
+    // child payloads keep the copy alive on their own
+    OCRepPayload *child = NULL;
+    EXPECT_TRUE(OCRepPayloadGetPropObject(view, "child", &child));
+    OCRepPayload *clone = OCRepPayloadClone(view);
+    ASSERT_TRUE(clone != NULL);
+    expectSameValues(view, clone);
+    OCRepPayloadDestroy(view);
+    EXPECT_TRUE(OCRepPayloadGetPropString(child, "name", &str));
+    EXPECT_STREQ("child", str);
+    OICFree(str);
+
+    OCRepPayloadDestroy(child);
+    OCRepPayloadDestroy(clone);
+    OCPayloadDestroy(copy);
+    OCRepPayloadDestroy(payload);
+}
+
+TEST(RepPayloadViewTest, SetValues)
+{
+    OCRepPayload *payload = createViewRepPayload();
+    ASSERT_TRUE(payload != NULL);
+    OCEncodedRepPayload *encoded = encodeRepPayload(payload);
+    ASSERT_TRUE(encoded != NULL);
+    OCRepPayload *view = OCEncodedRepPayloadParseView(encoded);
+    OCEncodedRepPayloadDestroy(encoded);
+    ASSERT_TRUE(view != NULL);
+
+    // replacing values held in the copy and adding new ones
+    EXPECT_TRUE(OCRepPayloadSetPropString(view, "string0", "replaced"));
+    EXPECT_TRUE(OCRepPayloadSetPropInt(view, "bytes", 1));
+    EXPECT_TRUE(OCRepPayloadSetNull(view, "colors"));
+    EXPECT_TRUE(OCRepPayloadSetPropString(view, "added", "new"));
+    EXPECT_TRUE(OCRepPayloadSetPropString(payload, "string0", "replaced"));
+    EXPECT_TRUE(OCRepPayloadSetPropInt(payload, "bytes", 1));
+    EXPECT_TRUE(OCRepPayloadSetNull(payload, "colors"));
+    EXPECT_TRUE(OCRepPayloadSetPropString(payload, "added", "new"));
+    expectSameValues(payload, view);
+
+    OCRepPayloadDestroy(view);
+    OCRepPayloadDestroy(payload);
+}
+
+TEST(RepPayloadViewTest, ArrayIter)
+{
+    OCRepPayload *payload = OCRepPayloadCreate();
+    ASSERT_TRUE(payload != NULL);
+    int64_t values[VIEW_ARRAY_LENGTH];
+    for (int i = 0; i < VIEW_ARRAY_LENGTH; i++)
+    {
+        values[i] = i * 3;
+    }
+    size_t dimensions[MAX_REP_ARRAY_DEPTH] = { VIEW_ARRAY_LENGTH, 0, 0 };
+    EXPECT_TRUE(OCRepPayloadSetIntArray(payload, "values", values, dimensions));
+    const char *strings[] = { "red", "green", "blue" };
+    dimensions[0] = 3;
+    EXPECT_TRUE(OCRepPayloadSetStringArray(payload, "colors", strings, dimensions));
+    OCEncodedRepPayload *encoded = encodeRepPayload(payload);
+    OCRepPayloadDestroy(payload);
+    ASSERT_TRUE(encoded != NULL);
+
+    OCRepPayloadArrayIter *iter = OCEncodedRepPayloadGetArrayIter(encoded, "values");
+    ASSERT_TRUE(iter != NULL);
+    int count = 0;
+    for (const OCRepPayloadValue *val = OCRepPayloadArrayIterNext(iter); val;
+         val = OCRepPayloadArrayIterNext(iter))
+    {
+        EXPECT_EQ(OCREP_PROP_INT, val->type);
+        EXPECT_EQ(count * 3, val->i);
+        count++;
+    }
+    EXPECT_EQ(VIEW_ARRAY_LENGTH, count);
+    EXPECT_TRUE(OCRepPayloadArrayIterNext(iter) == NULL);
+    OCRepPayloadArrayIterDestroy(iter);
+
+    iter = OCEncodedRepPayloadGetArrayIter(encoded, "colors");
+    ASSERT_TRUE(iter != NULL);
+    for (size_t i = 0; i < 3; i++)
+    {
+        const OCRepPayloadValue *val = OCRepPayloadArrayIterNext(iter);
+        ASSERT_TRUE(val != NULL);
+        EXPECT_EQ(OCREP_PROP_STRING, val->type);
+        EXPECT_STREQ(strings[i], val->str);
+    }
+    EXPECT_TRUE(OCRepPayloadArrayIterNext(iter) == NULL);
+    OCRepPayloadArrayIterDestroy(iter);
+
+    EXPECT_TRUE(OCEncodedRepPayloadGetArrayIter(encoded, "missing") == NULL);
+    OCEncodedRepPayloadDestroy(encoded);
+}
+
+//-----------------------------------------------------------------------------
+// Arenas: payloads made with OCRepPayloadCreateInArena, or parsed by the stack, are
+// allocated in blocks freed together with the last payload of the arena.
+//-----------------------------------------------------------------------------
+static OCRepPayload *buildRepPayload(OCRepPayload *payload)
+{
+    if (!payload)
+    {
+        return NULL;
+    }
+    for (int i = 0; i < REP_PROPERTIES; i++)
+    {
+        char name[32];
+        snprintf(name, sizeof(name), "int%d", i);
+        OCRepPayloadSetPropInt(payload, name, i * 1000);
+        snprintf(name, sizeof(name), "string%d", i);
+        OCRepPayloadSetPropString(payload, name, "the quick brown fox jumps over the lazy dog");
+    }
+    static uint8_t bytes[] = { 0x01, 0x02, 0x03, 0x04 };
+    OCByteString byteString = { bytes, sizeof(bytes) };
+    OCRepPayloadSetPropByteString(payload, "bytes", byteString);
+    OCByteString byteStrings[] = { byteString, byteString };
+    size_t dimensions[MAX_REP_ARRAY_DEPTH] = { 2, 0, 0 };
+    OCRepPayloadSetByteStringArray(payload, "byteStrings", byteStrings, dimensions);
+    const char *strings[] = { "red", "green", "blue" };
+    dimensions[0] = 3;
+    OCRepPayloadSetStringArray(payload, "colors", strings, dimensions);
+    double doubles[] = { 0.5, 1.5, 2.5 };
+    OCRepPayloadSetDoubleArray(payload, "doubles", doubles, dimensions);
+    return payload;
+}
+
+TEST(RepPayloadArenaTest, BuildCloneDestroy)
+{
+    OCRepPayload *heap = buildRepPayload(OCRepPayloadCreate());
+    ASSERT_TRUE(heap != NULL);
+    OCRepPayload *heapChild = buildRepPayload(OCRepPayloadCreate());
+    ASSERT_TRUE(heapChild != NULL);
+    EXPECT_TRUE(OCRepPayloadSetPropObjectAsOwner(heap, "child", heapChild));
+
+    OCRepPayload *arena = buildRepPayload(OCRepPayloadCreateInArena(NULL));
+    ASSERT_TRUE(arena != NULL);
+    ASSERT_TRUE(arena->buffer != NULL);
+    OCRepPayload *arenaChild = buildRepPayload(OCRepPayloadCreateInArena(arena));
+    ASSERT_TRUE(arenaChild != NULL);
+    EXPECT_EQ(arena->buffer, arenaChild->buffer);
+    EXPECT_TRUE(OCRepPayloadSetPropObjectAsOwner(arena, "child", arenaChild));
+    expectSameValues(heap, arena);
+
+    // replacing values, and values the payload takes ownership of
+    EXPECT_TRUE(OCRepPayloadSetPropString(arena, "string0", "replaced"));
+    EXPECT_TRUE(OCRepPayloadSetPropStringAsOwner(arena, "string1", OICStrdup("owned")));
+    EXPECT_TRUE(OCRepPayloadSetPropObject(arena, "copy", heapChild));
+    EXPECT_TRUE(OCRepPayloadSetPropString(heap, "string0", "replaced"));
+    EXPECT_TRUE(OCRepPayloadSetPropStringAsOwner(heap, "string1", OICStrdup("owned")));
+    EXPECT_TRUE(OCRepPayloadSetPropObject(heap, "copy", heapChild));
+    expectSameValues(heap, arena);
+
+    OCRepPayload *clone = OCRepPayloadCloneInArena(heap);
+    ASSERT_TRUE(clone != NULL);
+    ASSERT_TRUE(clone->buffer != NULL);
+    expectSameValues(heap, clone);
+    OCRepPayload *heapClone = OCRepPayloadClone(clone);
+    ASSERT_TRUE(heapClone != NULL);
+    EXPECT_TRUE(heapClone->buffer == NULL);
+    expectSameValues(heap, heapClone);
+
+    // a payload outliving the others of its arena keeps the arena
+    OCRepPayload *last = OCRepPayloadCreateInArena(arena);
+    ASSERT_TRUE(last != NULL);
+    OCRepPayloadDestroy(arena);
+    EXPECT_TRUE(OCRepPayloadSetPropString(last, "name", "last"));
+    char *str = NULL;
+    EXPECT_TRUE(OCRepPayloadGetPropString(last, "name", &str));
+    EXPECT_STREQ("last", str);
+    OICFree(str);
+
+    OCRepPayloadDestroy(last);
+    OCRepPayloadDestroy(heapClone);
+    OCRepPayloadDestroy(clone);
+    OCRepPayloadDestroy(heap);
+}
+
+TEST(RepPayloadArenaTest, ParsedPayloads)
+{
+    OCRepPayload *payload = buildRepPayload(OCRepPayloadCreate());
+    ASSERT_TRUE(payload != NULL);
+    uint8_t *cbor = NULL;
+    size_t size = 0;
+    ASSERT_EQ(OC_STACK_OK, OCConvertPayload((OCPayload *)payload, OC_FORMAT_CBOR, &cbor, &size));
+
+    OCPayload *parsed = NULL;
+    ASSERT_EQ(OC_STACK_OK, OCParsePayload(&parsed, OC_FORMAT_CBOR, PAYLOAD_TYPE_REPRESENTATION,
+                                          cbor, size));
+    OICFree(cbor);
+    ASSERT_TRUE(((OCRepPayload *)parsed)->buffer != NULL);
+    expectSameValues(payload, (OCRepPayload *)parsed);
+
+    OCPayloadDestroy(parsed);
+    OCRepPayloadDestroy(payload);
+}
+
+TEST(RepPayloadArenaTest, EmptyByteString)
+{
+    OCRepPayload *payload = OCRepPayloadCreateInArena(NULL);
+    ASSERT_TRUE(payload != NULL);
+    ASSERT_TRUE(payload->buffer != NULL);
+
+    OCByteString empty = { NULL, 0 };
+    EXPECT_TRUE(OCRepPayloadSetPropByteString(payload, "bytestring", empty));
+    OCByteString emptyArray[] = { empty, empty };
+    size_t dimensions[MAX_REP_ARRAY_DEPTH] = { 2, 0, 0 };
+    EXPECT_TRUE(OCRepPayloadSetByteStringArray(payload, "bytestrings", emptyArray, dimensions));
+
+    OCByteString bytestring_out = { NULL, 0 };
+    ASSERT_TRUE(OCRepPayloadGetPropByteString(payload, "bytestring", &bytestring_out));
+    EXPECT_TRUE(bytestring_out.bytes == NULL);
+    EXPECT_EQ(0u, bytestring_out.len);
+
+    OCRepPayload *clone = OCRepPayloadCloneInArena(payload);
+    ASSERT_TRUE(clone != NULL);
+    OCByteString *array_out = NULL;
+    size_t dimensions_out[MAX_REP_ARRAY_DEPTH] = { 0 };
+    ASSERT_TRUE(OCRepPayloadGetByteStringArray(clone, "bytestrings", &array_out, dimensions_out));
+    EXPECT_EQ(2u, dimensions_out[0]);
+    for (size_t i = 0; i < dimensions_out[0]; i++)
+    {
+        EXPECT_TRUE(array_out[i].bytes == NULL);
+        EXPECT_EQ(0u, array_out[i].len);
+        OICFree(array_out[i].bytes);
+    }
+    OICFree(array_out);
+
+    OCRepPayloadDestroy(clone);
+    OCRepPayloadDestroy(payload);
+}
+
+// Prints the time and the OICMalloc allocations to build, clone, parse and destroy a
+// payload on the heap and in an arena.
+TEST(RepPayloadArenaBenchmark, BuildCloneParse)
+{
+    uint32_t allocations[2] = { 0, 0 };
+    uint64_t buildTime[2] = { 0, 0 };
+    uint64_t cloneTime[2] = { 0, 0 };
+    for (int inArena = 0; inArena < 2; inArena++)
+    {
+        uint32_t count = OICGetAllocationCount();
+        uint64_t beg = OICGetCurrentTime(TIME_IN_US);
+        for (int i = 0; i < CONVERT_ITERATIONS; i++)
+        {
+            OCRepPayload *payload = buildRepPayload(inArena ? OCRepPayloadCreateInArena(NULL)
+                                                            : OCRepPayloadCreate());
+            EXPECT_TRUE(payload != NULL);
+            OCRepPayloadDestroy(payload);
+        }
+        buildTime[inArena] = OICGetCurrentTime(TIME_IN_US) - beg;
+        allocations[inArena] = (OICGetAllocationCount() - count) / CONVERT_ITERATIONS;
+
+        OCRepPayload *payload = buildRepPayload(OCRepPayloadCreate());
+        ASSERT_TRUE(payload != NULL);
+        beg = OICGetCurrentTime(TIME_IN_US);
+        for (int i = 0; i < CONVERT_ITERATIONS; i++)
+        {
+            OCRepPayload *clone = inArena ? OCRepPayloadCloneInArena(payload)
+                                          : OCRepPayloadClone(payload);
+            EXPECT_TRUE(clone != NULL);
+            OCRepPayloadDestroy(clone);
+        }
+        cloneTime[inArena] = OICGetCurrentTime(TIME_IN_US) - beg;
+        OCRepPayloadDestroy(payload);
+    }
+    printf("build and destroy: heap %.3f us, %u allocations; arena %.3f us, %u allocations\n",
+           (double)buildTime[0] / CONVERT_ITERATIONS, allocations[0],
+           (double)buildTime[1] / CONVERT_ITERATIONS, allocations[1]);
+    printf("clone and destroy: heap %.3f us; arena %.3f us\n",
+           (double)cloneTime[0] / CONVERT_ITERATIONS, (double)cloneTime[1] / CONVERT_ITERATIONS);
+    EXPECT_LT(allocations[1] * 4, allocations[0]);
+
+    OCRepPayload *payload = createViewRepPayload();
+    ASSERT_TRUE(payload != NULL);
+    OCEncodedRepPayload *encoded = encodeRepPayload(payload);
+    OCRepPayloadDestroy(payload);
+    ASSERT_TRUE(encoded != NULL);
+    uint32_t count = OICGetAllocationCount();
+    uint64_t beg = OICGetCurrentTime(TIME_IN_US);
+    for (int i = 0; i < CONVERT_ITERATIONS; i++)
+    {
+        OCPayload *parsed = NULL;
+        EXPECT_EQ(OC_STACK_OK, OCParsePayload(&parsed, OC_FORMAT_CBOR, PAYLOAD_TYPE_REPRESENTATION,
+                                              encoded->cborPayload.bytes,
+                                              encoded->cborPayload.len));
+        OCPayloadDestroy(parsed);
+    }
+    uint64_t parseTime = OICGetCurrentTime(TIME_IN_US) - beg;
+    printf("parse and destroy %zu bytes: %.3f us, %u allocations\n", encoded->cborPayload.len,
+           (double)parseTime / CONVERT_ITERATIONS,
+           (OICGetAllocationCount() - count) / CONVERT_ITERATIONS);
+    OCEncodedRepPayloadDestroy(encoded);
+}
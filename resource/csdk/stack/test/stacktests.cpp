@@ -24,6 +24,7 @@ extern "C"
     #include "ocpayload.h"
     #include "ocstack.h"
     #include "ocstackinternal.h"
+    #include "ocobserve.h"
     #include "experimental/logger.h"
     #include "oic_malloc.h"
     #include "oic_string.h"
@@ -55,6 +56,8 @@ extern "C"
 
 #include <iostream>
 #include <stdint.h>
+#include <inttypes.h>
+#include <vector>
 
 #include "gtest_helper.h"
 
@@ -1391,6 +1394,39 @@ TEST(StackResource, ClearResourceProperties)
     EXPECT_EQ(OC_STACK_OK, OCStop());
 }
 
+TEST(StackResource, GetDiscoveryCacheStats)
+{
+    itst::DeadmanTimer killSwitch(SHORT_TEST_TIMEOUT);
+    OIC_LOG(INFO, TAG, "Starting GetDiscoveryCacheStats test");
+    InitStack(OC_SERVER);
+
+    uint32_t hits = 0;
+    uint32_t misses = 0;
+    EXPECT_EQ(OC_STACK_INVALID_PARAM, OCGetDiscoveryCacheStats(NULL, &misses));
+    EXPECT_EQ(OC_STACK_INVALID_PARAM, OCGetDiscoveryCacheStats(&hits, NULL));
+    EXPECT_EQ(OC_STACK_OK, OCGetDiscoveryCacheStats(&hits, &misses));
+
+    // Changing resources drops cached responses but is neither a hit nor a miss.
+    OCResourceHandle handle;
+    EXPECT_EQ(OC_STACK_OK, OCCreateResource(&handle,
+                                            "core.led",
+                                            "core.rw",
+                                            "/a/led",
+                                            0,
+                                            NULL,
+                                            OC_DISCOVERABLE));
+    EXPECT_EQ(OC_STACK_OK, OCBindResourceTypeToResource(handle, "core.brightled"));
+    EXPECT_EQ(OC_STACK_OK, OCDeleteResource(handle));
+
+    uint32_t hitsAfter = 0;
+    uint32_t missesAfter = 0;
+    EXPECT_EQ(OC_STACK_OK, OCGetDiscoveryCacheStats(&hitsAfter, &missesAfter));
+    EXPECT_EQ(hits, hitsAfter);
+    EXPECT_EQ(misses, missesAfter);
+
+    EXPECT_EQ(OC_STACK_OK, OCStop());
+}
+
 TEST(StackResource, StackTestResourceDiscoverOneResourceBad)
 {
     itst::DeadmanTimer killSwitch(SHORT_TEST_TIMEOUT);
@@ -2326,6 +2362,210 @@ TEST(StackResourceAccess, DeleteMiddleResource)
     EXPECT_EQ(OC_STACK_OK, OCStop());
 }
 
+TEST(StackResourceAccess, GetResourceHandleAtUriAfterDelete)
+{
+    itst::DeadmanTimer killSwitch(SHORT_TEST_TIMEOUT);
+    OIC_LOG(INFO, TAG, "Starting GetResourceHandleAtUriAfterDelete test");
+    InitStack(OC_SERVER);
+
+    OCResourceHandle handle0;
+    EXPECT_EQ(OC_STACK_OK, OCCreateResource(&handle0,
+                                            "core.led",
+                                            "core.rw",
+                                            "/a/led0",
+                                            0,
+                                            NULL,
+                                            OC_DISCOVERABLE|OC_OBSERVABLE));
+    OCResourceHandle handle1;
+    EXPECT_EQ(OC_STACK_OK, OCCreateResource(&handle1,
+                                            "core.fan",
+                                            "core.rw",
+                                            "/a/fan1",
+                                            0,
+                                            NULL,
+                                            OC_DISCOVERABLE|OC_OBSERVABLE));
+
+    EXPECT_EQ(handle0, OCGetResourceHandleAtUri("/a/led0"));
+    EXPECT_EQ(handle1, OCGetResourceHandleAtUri("/a/fan1"));
+    EXPECT_EQ(NULL, OCGetResourceHandleAtUri("/a/led1"));
+
+    EXPECT_EQ(OC_STACK_OK, OCDeleteResource(handle0));
+    EXPECT_EQ(NULL, OCGetResourceHandleAtUri("/a/led0"));
+    EXPECT_EQ(NULL, GetResourceTypeIndexBucket("core.led"));
+    EXPECT_EQ(handle1, OCGetResourceHandleAtUri("/a/fan1"));
+
+    // The URI is free again once the resource has been deleted
+    EXPECT_EQ(OC_STACK_OK, OCCreateResource(&handle0,
+                                            "core.led",
+                                            "core.rw",
+                                            "/a/led0",
+                                            0,
+                                            NULL,
+                                            OC_DISCOVERABLE|OC_OBSERVABLE));
+    EXPECT_EQ(handle0, OCGetResourceHandleAtUri("/a/led0"));
+
+    EXPECT_EQ(OC_STACK_OK, OCStop());
+}
+
+static size_t CountResourceIndexBucket(const OCResourceIndexBucket *bucket)
+{
+    size_t count = 0;
+    for (OCResourceIndexEntry *entry = bucket ? bucket->entries : NULL; entry;
+         entry = (OCResourceIndexEntry *)entry->hh.next)
+    {
+        count++;
+    }
+    return count;
+}
+
+TEST(StackResourceAccess, ResourceIndexLookup)
+{
+    itst::DeadmanTimer killSwitch(LONG_TEST_TIMEOUT);
+    OIC_LOG(INFO, TAG, "Starting ResourceIndexLookup test");
+
+    const size_t resourceCounts[] = { 10, 1000, 10000 };
+    for (size_t count : resourceCounts)
+    {
+        InitStack(OC_SERVER);
+
+        std::vector<OCResourceHandle> handles(count);
+        char uri[MAX_URI_LENGTH];
+        for (size_t i = 0; i < count; i++)
+        {
+            snprintf(uri, sizeof(uri), "/a/light/%zu", i);
+            EXPECT_EQ(OC_STACK_OK, OCCreateResource(&handles[i],
+                                                    (i % 2) ? "core.odd" : "core.even",
+                                                    "core.rw",
+                                                    uri,
+                                                    0,
+                                                    NULL,
+                                                    OC_DISCOVERABLE|OC_OBSERVABLE));
+            if (0 == (i % 10))
+            {
+                EXPECT_EQ(OC_STACK_OK, OCBindResourceInterfaceToResource(handles[i], "oic.if.r"));
+            }
+        }
+
+        uint64_t start = OICGetCurrentTime(TIME_IN_US);
+        for (size_t i = 0; i < count; i++)
+        {
+            snprintf(uri, sizeof(uri), "/a/light/%zu", i);
+            EXPECT_EQ(handles[i], OCGetResourceHandleAtUri(uri));
+        }
+        uint64_t elapsed = OICGetCurrentTime(TIME_IN_US) - start;
+        printf("%zu lookups by uri among %zu resources: %" PRIu64 " us\n",
+               count, count, elapsed);
+
+        EXPECT_EQ(count / 2, CountResourceIndexBucket(GetResourceTypeIndexBucket("core.odd")));
+        EXPECT_EQ((count + 9) / 10,
+                  CountResourceIndexBucket(GetResourceInterfaceIndexBucket("oic.if.r")));
+
+        for (size_t i = 0; i < count; i += 2)
+        {
+            EXPECT_EQ(OC_STACK_OK, OCDeleteResource(handles[i]));
+        }
+        EXPECT_EQ(NULL, GetResourceTypeIndexBucket("core.even"));
+        EXPECT_EQ(NULL, GetResourceInterfaceIndexBucket("oic.if.r"));
+        EXPECT_EQ(NULL, OCGetResourceHandleAtUri("/a/light/0"));
+        EXPECT_EQ(handles[1], OCGetResourceHandleAtUri("/a/light/1"));
+
+        EXPECT_EQ(OC_STACK_OK, OCStop());
+    }
+}
+
+TEST(StackClientCB, LookupWithManyCallbacks)
+{
+    itst::DeadmanTimer killSwitch(LONG_TEST_TIMEOUT);
+    OIC_LOG(INFO, TAG, "Starting LookupWithManyCallbacks test");
+    InitStack(OC_CLIENT);
+
+    const size_t count = 10000;
+    std::vector<std::vector<char>> tokens(count);
+    std::vector<OCDoHandle> handles(count);
+    OCCallbackData cbData;
+    cbData.cb = asyncDoResourcesCallback;
+    cbData.context = (void*)DEFAULT_CONTEXT_VALUE;
+    cbData.cd = NULL;
+
+    for (size_t i = 0; i < count; i++)
+    {
+        CAToken_t token = NULL;
+        ASSERT_EQ(CA_STATUS_OK, CAGenerateToken(&token, CA_MAX_TOKEN_LEN));
+        tokens[i].assign(token, token + CA_MAX_TOKEN_LEN);
+        handles[i] = (OCDoHandle)OICMalloc(1);
+        ASSERT_TRUE(NULL != handles[i]);
+
+        ClientCB *cbNode = NULL;
+        EXPECT_EQ(OC_STACK_OK, AddClientCB(&cbNode, &cbData, CA_MSG_CONFIRM,
+                                           token, CA_MAX_TOKEN_LEN, NULL, 0, NULL, 0,
+                                           CA_FORMAT_APPLICATION_CBOR, &handles[i],
+                                           (i % 2) ? OC_REST_OBSERVE : OC_REST_GET, NULL,
+                                           OICStrdup("/a/light"), NULL,
+                                           GetTicks(MAX_CB_TIMEOUT_SECONDS * 1000)));
+    }
+
+    uint64_t start = OICGetCurrentTime(TIME_IN_US);
+    for (size_t i = 0; i < count; i++)
+    {
+        ClientCB *cbNode = GetClientCBUsingToken(tokens[i].data(), CA_MAX_TOKEN_LEN);
+        ASSERT_TRUE(NULL != cbNode);
+        EXPECT_EQ(handles[i], cbNode->handle);
+    }
+    uint64_t elapsed = OICGetCurrentTime(TIME_IN_US) - start;
+    printf("%zu lookups by token among %zu callbacks: %" PRIu64 " us\n",
+           count, count, elapsed);
+
+    for (size_t i = 0; i < count; i += 2)
+    {
+        DeleteClientCB(GetClientCBUsingHandle(handles[i]));
+    }
+    for (size_t i = 0; i < count; i++)
+    {
+        ClientCB *cbNode = GetClientCBUsingToken(tokens[i].data(), CA_MAX_TOKEN_LEN);
+        EXPECT_EQ((i % 2) != 0, NULL != cbNode);
+        EXPECT_EQ(cbNode, GetClientCBUsingHandle(handles[i]));
+    }
+
+    EXPECT_EQ(OC_STACK_OK, OCStop());
+}
+
+#ifdef WITH_PRESENCE
+TEST(StackClientCB, DeletePresenceCallbackWithoutUri)
+{
+    itst::DeadmanTimer killSwitch(SHORT_TEST_TIMEOUT);
+    OIC_LOG(INFO, TAG, "Starting DeletePresenceCallbackWithoutUri test");
+    InitStack(OC_CLIENT);
+
+    OCCallbackData cbData;
+    cbData.cb = asyncDoResourcesCallback;
+    cbData.context = (void*)DEFAULT_CONTEXT_VALUE;
+    cbData.cd = NULL;
+
+    // Only the presence callback with a URI is in the URI index
+    OCDoHandle handles[2] = { (OCDoHandle)OICMalloc(1), (OCDoHandle)OICMalloc(1) };
+    ClientCB *cbNodes[2] = { NULL, NULL };
+    char *uris[2] = { OICStrdup("/oic/ad"), NULL };
+    for (size_t i = 0; i < 2; i++)
+    {
+        ASSERT_TRUE(NULL != handles[i]);
+        CAToken_t token = NULL;
+        ASSERT_EQ(CA_STATUS_OK, CAGenerateToken(&token, CA_MAX_TOKEN_LEN));
+        EXPECT_EQ(OC_STACK_OK, AddClientCB(&cbNodes[i], &cbData, CA_MSG_NONCONFIRM,
+                                           token, CA_MAX_TOKEN_LEN, NULL, 0, NULL, 0,
+                                           CA_FORMAT_APPLICATION_CBOR, &handles[i],
+                                           OC_REST_PRESENCE, NULL, uris[i], NULL, 0));
+    }
+    EXPECT_EQ(cbNodes[0], GetClientCBUsingUri("/oic/ad"));
+
+    DeleteClientCB(cbNodes[1]);
+    EXPECT_EQ(cbNodes[0], GetClientCBUsingUri("/oic/ad"));
+    DeleteClientCB(cbNodes[0]);
+    EXPECT_EQ(NULL, GetClientCBUsingUri("/oic/ad"));
+
+    EXPECT_EQ(OC_STACK_OK, OCStop());
+}
+#endif
+
 // Visual Studio versions earlier than 2015 have bugs in is_pod and report the wrong answer.
 #if !defined(_MSC_VER) || (_MSC_VER >= 1900)
 TEST(PODTests, OCHeaderOption)
@@ -2828,6 +3068,167 @@ TEST_F(OCDiscoverTests, DISABLED_DiscoverResourceWithInvalidQueries)
     EXPECT_EQ(OC_STACK_OK, discoverUnicastRTEmptyCB.Wait(10));
 }
 
+static size_t g_discoveredResources = 0;
+static bool g_discoveredRare = false;
+
+static OCStackApplicationResult DiscoverRareResource(void *ctx, OCDoHandle handle,
+    OCClientResponse *response)
+{
+    OC_UNUSED(ctx);
+    OC_UNUSED(handle);
+    EXPECT_EQ(OC_STACK_OK, response->result);
+    g_discoveredResources = 0;
+    g_discoveredRare = false;
+    if (NULL != response->payload)
+    {
+        EXPECT_EQ(PAYLOAD_TYPE_DISCOVERY, response->payload->type);
+        OCDiscoveryPayload *payload = (OCDiscoveryPayload *)response->payload;
+        for (OCResourcePayload *resource = payload->resources; resource; resource = resource->next)
+        {
+            g_discoveredResources++;
+            if (0 == strcmp("/a/rare", resource->uri))
+            {
+                g_discoveredRare = true;
+            }
+        }
+    }
+
+    return OC_STACK_DELETE_TRANSACTION;
+}
+
+// Times /oic/res discovery filtered by a resource type, which visits the matching bucket
+// of the resource index, against discovery of the same resource by walking the whole
+// resource list. The other resources are not discoverable, so that both responses list
+// the one resource of that type, and differ only in the resources they visit.
+TEST_F(OCDiscoverTests, FilteredDiscoveryTiming)
+{
+    itst::DeadmanTimer killSwitch(LONG_TEST_TIMEOUT);
+    const int iterations = 10;
+
+    OCResourceHandle handle;
+    EXPECT_EQ(OC_STACK_OK, OCCreateResource(&handle, "core.rare", "oic.if.baseline", "/a/rare",
+        entityHandler, NULL, OC_DISCOVERABLE));
+
+    const size_t resourceCounts[] = { 10, 1000, 10000 };
+    size_t created = 0;
+    char uri[MAX_URI_LENGTH];
+    for (size_t count : resourceCounts)
+    {
+        for (; created < count; created++)
+        {
+            snprintf(uri, sizeof(uri), "/a/hidden/%zu", created);
+            EXPECT_EQ(OC_STACK_OK, OCCreateResource(&handle, "core.hidden", "oic.if.baseline",
+                uri, entityHandler, NULL, OC_ACTIVE));
+        }
+
+        uint64_t elapsed[2] = { 0, 0 };
+        const char *targetUris[2] = { "127.0.0.1/oic/res", "127.0.0.1/oic/res?rt=core.rare" };
+        for (int filtered = 0; filtered < 2; filtered++)
+        {
+            for (int i = 0; i < iterations; i++)
+            {
+                // time building the response, not the discovery cache
+                InvalidateDiscoveryCache(NULL);
+                itst::Callback discoveryCB(&DiscoverRareResource);
+                uint64_t start = OICGetCurrentTime(TIME_IN_US);
+                EXPECT_EQ(OC_STACK_OK, OCDoResource(NULL, OC_REST_DISCOVER, targetUris[filtered],
+                    NULL, 0, CT_DEFAULT, OC_HIGH_QOS, discoveryCB, NULL, 0));
+                EXPECT_EQ(OC_STACK_OK, discoveryCB.Wait(10));
+                elapsed[filtered] += OICGetCurrentTime(TIME_IN_US) - start;
+                EXPECT_TRUE(g_discoveredRare);
+                if (filtered)
+                {
+                    EXPECT_EQ(1u, g_discoveredResources);
+                }
+            }
+        }
+        printf("%zu resources: list walk %" PRIu64 " us, rt filter %" PRIu64 " us per discovery\n",
+               count, elapsed[0] / iterations, elapsed[1] / iterations);
+    }
+}
+
+static bool g_discoveredFan = false;
+
+static OCStackApplicationResult DiscoverCachedResources(void *ctx, OCDoHandle handle,
+    OCClientResponse *response)
+{
+    OC_UNUSED(ctx);
+    OC_UNUSED(handle);
+    EXPECT_EQ(OC_STACK_OK, response->result);
+    EXPECT_TRUE(NULL != response->payload);
+    g_discoveredFan = false;
+    if (NULL != response->payload)
+    {
+        EXPECT_EQ(PAYLOAD_TYPE_DISCOVERY, response->payload->type);
+        OCDiscoveryPayload *payload = (OCDiscoveryPayload *)response->payload;
+        for (OCResourcePayload *resource = payload->resources; resource; resource = resource->next)
+        {
+            if (0 == strcmp("/a/fan", resource->uri))
+            {
+                g_discoveredFan = true;
+            }
+        }
+    }
+
+    return OC_STACK_DELETE_TRANSACTION;
+}
+
+#ifndef RD_SERVER
+TEST_F(OCDiscoverTests, DiscoveryCacheHitsMissesAndInvalidation)
+{
+    itst::DeadmanTimer killSwitch(LONG_TEST_TIMEOUT);
+
+    OCResourceHandle handle;
+    EXPECT_EQ(OC_STACK_OK, OCCreateResource(&handle, "core.light", "oic.if.baseline", "/a/light",
+        entityHandler, NULL, OC_DISCOVERABLE));
+
+    uint32_t hits = 0;
+    uint32_t misses = 0;
+    EXPECT_EQ(OC_STACK_OK, OCGetDiscoveryCacheStats(&hits, &misses));
+
+    char targetUri[MAX_URI_LENGTH * 2] ={ 0, };
+    snprintf(targetUri, MAX_URI_LENGTH * 2, "127.0.0.1/oic/res");
+
+    // The first discovery builds the response and caches it
+    itst::Callback firstDiscoveryCB(&DiscoverCachedResources);
+    EXPECT_EQ(OC_STACK_OK, OCDoResource(NULL, OC_REST_DISCOVER, targetUri, NULL, 0,
+        CT_DEFAULT, OC_HIGH_QOS, firstDiscoveryCB, NULL, 0));
+    EXPECT_EQ(OC_STACK_OK, firstDiscoveryCB.Wait(10));
+    EXPECT_FALSE(g_discoveredFan);
+
+    uint32_t hitsAfter = 0;
+    uint32_t missesAfter = 0;
+    EXPECT_EQ(OC_STACK_OK, OCGetDiscoveryCacheStats(&hitsAfter, &missesAfter));
+    EXPECT_EQ(hits, hitsAfter);
+    EXPECT_EQ(misses + 1, missesAfter);
+
+    // the same discovery is then answered from the cache
+    itst::Callback secondDiscoveryCB(&DiscoverCachedResources);
+    EXPECT_EQ(OC_STACK_OK, OCDoResource(NULL, OC_REST_DISCOVER, targetUri, NULL, 0,
+        CT_DEFAULT, OC_HIGH_QOS, secondDiscoveryCB, NULL, 0));
+    EXPECT_EQ(OC_STACK_OK, secondDiscoveryCB.Wait(10));
+    EXPECT_FALSE(g_discoveredFan);
+
+    EXPECT_EQ(OC_STACK_OK, OCGetDiscoveryCacheStats(&hitsAfter, &missesAfter));
+    EXPECT_EQ(hits + 1, hitsAfter);
+    EXPECT_EQ(misses + 1, missesAfter);
+
+    // until a new resource drops the cached response.
+    EXPECT_EQ(OC_STACK_OK, OCCreateResource(&handle, "core.fan", "oic.if.baseline", "/a/fan",
+        entityHandler, NULL, OC_DISCOVERABLE));
+
+    itst::Callback thirdDiscoveryCB(&DiscoverCachedResources);
+    EXPECT_EQ(OC_STACK_OK, OCDoResource(NULL, OC_REST_DISCOVER, targetUri, NULL, 0,
+        CT_DEFAULT, OC_HIGH_QOS, thirdDiscoveryCB, NULL, 0));
+    EXPECT_EQ(OC_STACK_OK, thirdDiscoveryCB.Wait(10));
+    EXPECT_TRUE(g_discoveredFan);
+
+    EXPECT_EQ(OC_STACK_OK, OCGetDiscoveryCacheStats(&hitsAfter, &missesAfter));
+    EXPECT_EQ(hits + 1, hitsAfter);
+    EXPECT_EQ(misses + 2, missesAfter);
+}
+#endif
+
 class OCEndpointTests : public testing::Test
 {
     protected:
@@ -3228,6 +3629,159 @@ TEST(DiagnosticPayload, DISABLED_EndToEnd)
     OCStop();
 }
 
+#define NOTIFY_ITERATIONS 20
+
+static int g_notifyHandlerCalls = 0;
+
+static OCEntityHandlerResult NotifyEntityHandler(OCEntityHandlerFlag flag,
+        OCEntityHandlerRequest *request, void *ctx)
+{
+    OC_UNUSED(flag);
+    OC_UNUSED(ctx);
+    g_notifyHandlerCalls++;
+
+    OCRepPayload *payload = OCRepPayloadCreate();
+    EXPECT_TRUE(payload != NULL);
+    OCRepPayloadSetUri(payload, "/a/notify");
+    OCRepPayloadSetPropBool(payload, "state", true);
+    OCRepPayloadSetPropInt(payload, "power", 42);
+    OCRepPayloadSetPropString(payload, "name", "notification");
+
+    OCEntityHandlerResponse response;
+    memset(&response, 0, sizeof(response));
+    response.requestHandle = request->requestHandle;
+    response.ehResult = OC_EH_OK;
+    response.payload = (OCPayload *)payload;
+    EXPECT_EQ(OC_STACK_OK, OCDoResponse(&response));
+    OCRepPayloadDestroy(payload);
+    return OC_EH_OK;
+}
+
+// Observers at an unused local port, so that notifications are sent but never answered.
+static void AddNotifyObservers(OCResourceHandle handle, size_t first, size_t count,
+                               OCPayloadFormat acceptFormat)
+{
+    OCDevAddr devAddr;
+    memset(&devAddr, 0, sizeof(devAddr));
+    devAddr.adapter = OC_ADAPTER_IP;
+    devAddr.flags = OC_IP_USE_V4;
+    OICStrcpy(devAddr.addr, sizeof(devAddr.addr), "127.0.0.1");
+    devAddr.port = 5999;
+
+    for (size_t i = first; i < first + count; i++)
+    {
+        char token[CA_MAX_TOKEN_LEN] = {0};
+        memcpy(token, &i, sizeof(i));
+        OCObservationId obsId = 0;
+        ASSERT_EQ(OC_STACK_OK, GenerateObserverId(&obsId));
+        ASSERT_EQ(OC_STACK_OK, AddObserver("/a/notify", NULL, obsId, token, sizeof(token),
+                                           (OCResource *)handle, OC_LOW_QOS, acceptFormat,
+                                           0, &devAddr));
+    }
+}
+
+TEST(StackNotify, EntityHandlerCalledOncePerRepresentation)
+{
+    itst::DeadmanTimer killSwitch(SHORT_TEST_TIMEOUT);
+    InitStack(OC_SERVER);
+
+    OCResourceHandle handle;
+    ASSERT_EQ(OC_STACK_OK, OCCreateResource(&handle, "core.light", "oic.if.baseline",
+                                            "/a/notify", NotifyEntityHandler, NULL,
+                                            OC_DISCOVERABLE|OC_OBSERVABLE));
+    AddNotifyObservers(handle, 0, 5, OC_FORMAT_CBOR);
+    AddNotifyObservers(handle, 5, 5, OC_FORMAT_VND_OCF_CBOR);
+
+    g_notifyHandlerCalls = 0;
+    EXPECT_EQ(OC_STACK_OK, OCNotifyAllObservers(handle, OC_LOW_QOS));
+    EXPECT_EQ(2, g_notifyHandlerCalls);
+
+    EXPECT_EQ(OC_STACK_OK, OCStop());
+}
+
+static OCRequestHandle g_slowNotifyRequests[2];
+static int g_slowNotifyRequestCount = 0;
+
+static OCEntityHandlerResult SlowNotifyEntityHandler(OCEntityHandlerFlag flag,
+        OCEntityHandlerRequest *request, void *ctx)
+{
+    OC_UNUSED(flag);
+    OC_UNUSED(ctx);
+    if (g_slowNotifyRequestCount < 2)
+    {
+        g_slowNotifyRequests[g_slowNotifyRequestCount++] = request->requestHandle;
+    }
+    return OC_EH_SLOW;
+}
+
+TEST(StackNotify, SlowResponseAfterNotifyWithDuplicateTokens)
+{
+    itst::DeadmanTimer killSwitch(SHORT_TEST_TIMEOUT);
+    InitStack(OC_SERVER);
+
+    OCResourceHandle handle;
+    ASSERT_EQ(OC_STACK_OK, OCCreateResource(&handle, "core.light", "oic.if.baseline",
+                                            "/a/notify", SlowNotifyEntityHandler, NULL,
+                                            OC_DISCOVERABLE|OC_OBSERVABLE));
+
+    // Two observers of the same group with the same token.
+    AddNotifyObservers(handle, 0, 1, OC_FORMAT_CBOR);
+    AddNotifyObservers(handle, 0, 1, OC_FORMAT_CBOR);
+
+    g_slowNotifyRequestCount = 0;
+    EXPECT_EQ(OC_STACK_OK, OCNotifyAllObservers(handle, OC_LOW_QOS));
+    ASSERT_EQ(2, g_slowNotifyRequestCount);
+
+    // The group is gone, the slow responses must not be kept in it.
+    for (int i = 0; i < g_slowNotifyRequestCount; i++)
+    {
+        OCRepPayload *payload = OCRepPayloadCreate();
+        ASSERT_TRUE(payload != NULL);
+        OCRepPayloadSetPropBool(payload, "state", true);
+
+        OCEntityHandlerResponse response;
+        memset(&response, 0, sizeof(response));
+        response.requestHandle = g_slowNotifyRequests[i];
+        response.ehResult = OC_EH_OK;
+        response.payload = (OCPayload *)payload;
+        EXPECT_EQ(OC_STACK_OK, OCDoResponse(&response));
+        OCRepPayloadDestroy(payload);
+    }
+
+    EXPECT_EQ(OC_STACK_OK, OCStop());
+}
+
+TEST(StackNotify, NotificationLatencyByObserverCount)
+{
+    itst::DeadmanTimer killSwitch(LONG_TEST_TIMEOUT);
+    const size_t observerCounts[] = { 1, 10, 100 };
+
+    for (size_t c = 0; c < sizeof(observerCounts) / sizeof(observerCounts[0]); c++)
+    {
+        InitStack(OC_SERVER);
+        OCResourceHandle handle;
+        ASSERT_EQ(OC_STACK_OK, OCCreateResource(&handle, "core.light", "oic.if.baseline",
+                                                "/a/notify", NotifyEntityHandler, NULL,
+                                                OC_DISCOVERABLE|OC_OBSERVABLE));
+        AddNotifyObservers(handle, 0, observerCounts[c], OC_FORMAT_CBOR);
+
+        g_notifyHandlerCalls = 0;
+        uint64_t beg = OICGetCurrentTime(TIME_IN_US);
+        for (int i = 0; i < NOTIFY_ITERATIONS; i++)
+        {
+            EXPECT_EQ(OC_STACK_OK, OCNotifyAllObservers(handle, OC_LOW_QOS));
+        }
+        uint64_t elapsed = OICGetCurrentTime(TIME_IN_US) - beg;
+
+        // all the observers ask for the same representation
+        EXPECT_EQ(NOTIFY_ITERATIONS, g_notifyHandlerCalls);
+        printf("%zu observers: %llu us per notification\n", observerCounts[c],
+               (unsigned long long)(elapsed / NOTIFY_ITERATIONS));
+
+        EXPECT_EQ(OC_STACK_OK, OCStop());
+    }
+}
+
 // Mostly copy-paste from ca_api_unittest.cpp
 TEST(OCIpv6ScopeLevel, getMulticastScope)
 {
@@ -0,0 +1,98 @@
+//******************************************************************
+//
+// Copyright 2017 Samsung Electronics All Rights Reserved.
+//
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+
+#ifndef OC_CALLBACK_DISPATCHER_H_
+#define OC_CALLBACK_DISPATCHER_H_
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <OCApi.h>
+
+namespace OC
+{
+    /**
+     * Runs application callbacks of the client as configured by
+     * PlatformConfig::callbackExecution.
+     *
+     * Callbacks posted with the same key, the OCDoHandle of the request, run one at a
+     * time in the order they were posted, except with CallbackExecution::NewThread.
+     */
+    class CallbackDispatcher
+    {
+    public:
+        typedef std::function<void()> Task;
+        typedef std::shared_ptr<CallbackDispatcher> Ptr;
+
+        CallbackDispatcher(CallbackExecution execution, unsigned int threads,
+                           CallbackExecutor executor);
+
+        /**
+         * Runs the callbacks still queued on the pool threads, then stops them.
+         */
+        ~CallbackDispatcher();
+
+        /**
+         * Runs the task as configured.
+         *
+         * @param key   tasks with the same key are run in order, one at a time.
+         * @param task  task to run.
+         */
+        void post(const void* key, Task task);
+
+    private:
+        // Everything the pool threads and the executor's tasks use. They hold a reference
+        // to it, so a callback may drop the last reference to the dispatcher.
+        struct State : public std::enable_shared_from_this<State>
+        {
+            State(CallbackExecution execution, CallbackExecutor executor);
+
+            void schedule(const void* key);
+            void drain(const void* key);
+
+            CallbackExecution execution;
+            CallbackExecutor executor;
+
+            // tasks of every key that has a drain queued or running
+            std::mutex pendingLock;
+            std::map<const void*, std::deque<Task>> pending;
+
+            // CallbackExecution::ThreadPool
+            std::mutex queueLock;
+            std::condition_variable queueCond;
+            std::deque<Task> queue;
+            bool stopping;
+        };
+
+        static void work(std::shared_ptr<State> state);
+        static void run(const Task& task);
+
+        std::shared_ptr<State> m_state;
+        std::vector<std::thread> m_threads;
+    };
+}
+
+#endif // OC_CALLBACK_DISPATCHER_H_
@@ -30,6 +30,7 @@
 #include <IClientWrapper.h>
 #include <InitializeException.h>
 #include <ResourceInitException.h>
+#include <CallbackDispatcher.h>
 
 namespace OC
 {
@@ -38,22 +39,28 @@ namespace OC
         struct GetContext
         {
             GetCallback callback;
-            GetContext(GetCallback cb) : callback(cb){}
+            CallbackDispatcher::Ptr dispatcher;
+            GetContext(GetCallback cb, CallbackDispatcher::Ptr d)
+                : callback(cb), dispatcher(d){}
         };
 
         struct SetContext
         {
             PutCallback callback;
-            SetContext(PutCallback cb) : callback(cb){}
+            CallbackDispatcher::Ptr dispatcher;
+            SetContext(PutCallback cb, CallbackDispatcher::Ptr d)
+                : callback(cb), dispatcher(d){}
         };
 
         struct ListenContext
         {
             FindCallback callback;
             std::weak_ptr<IClientWrapper> clientWrapper;
+            CallbackDispatcher::Ptr dispatcher;
 
-            ListenContext(FindCallback cb, std::weak_ptr<IClientWrapper> cw)
-                : callback(cb), clientWrapper(cw){}
+            ListenContext(FindCallback cb, std::weak_ptr<IClientWrapper> cw,
+                          CallbackDispatcher::Ptr d)
+                : callback(cb), clientWrapper(cw), dispatcher(d){}
         };
 
         struct ListenErrorContext
@@ -61,19 +68,22 @@ namespace OC
             FindCallback callback;
             FindErrorCallback errorCallback;
             std::weak_ptr<IClientWrapper> clientWrapper;
+            CallbackDispatcher::Ptr dispatcher;
 
             ListenErrorContext(FindCallback cb1, FindErrorCallback cb2,
-                               std::weak_ptr<IClientWrapper> cw)
-                : callback(cb1), errorCallback(cb2), clientWrapper(cw){}
+                               std::weak_ptr<IClientWrapper> cw, CallbackDispatcher::Ptr d)
+                : callback(cb1), errorCallback(cb2), clientWrapper(cw), dispatcher(d){}
         };
 
         struct ListenResListContext
         {
             FindResListCallback callback;
             std::weak_ptr<IClientWrapper> clientWrapper;
+            CallbackDispatcher::Ptr dispatcher;
 
-            ListenResListContext(FindResListCallback cb, std::weak_ptr<IClientWrapper> cw)
-                : callback(cb), clientWrapper(cw){}
+            ListenResListContext(FindResListCallback cb, std::weak_ptr<IClientWrapper> cw,
+                                 CallbackDispatcher::Ptr d)
+                : callback(cb), clientWrapper(cw), dispatcher(d){}
         };
 
         struct ListenResListWithErrorContext
@@ -81,36 +91,45 @@ namespace OC
             FindResListCallback callback;
             FindErrorCallback errorCallback;
             std::weak_ptr<IClientWrapper> clientWrapper;
+            CallbackDispatcher::Ptr dispatcher;
 
             ListenResListWithErrorContext(FindResListCallback cb1, FindErrorCallback cb2,
-                               std::weak_ptr<IClientWrapper> cw)
-                : callback(cb1), errorCallback(cb2), clientWrapper(cw){}
+                               std::weak_ptr<IClientWrapper> cw, CallbackDispatcher::Ptr d)
+                : callback(cb1), errorCallback(cb2), clientWrapper(cw), dispatcher(d){}
         };
 
         struct DeviceListenContext
         {
             FindDeviceCallback callback;
             IClientWrapper::Ptr clientWrapper;
-            DeviceListenContext(FindDeviceCallback cb, IClientWrapper::Ptr cw)
-                    : callback(cb), clientWrapper(cw){}
+            CallbackDispatcher::Ptr dispatcher;
+            DeviceListenContext(FindDeviceCallback cb, IClientWrapper::Ptr cw,
+                                CallbackDispatcher::Ptr d)
+                    : callback(cb), clientWrapper(cw), dispatcher(d){}
         };
 
         struct SubscribePresenceContext
         {
             SubscribeCallback callback;
-            SubscribePresenceContext(SubscribeCallback cb) : callback(cb){}
+            CallbackDispatcher::Ptr dispatcher;
+            SubscribePresenceContext(SubscribeCallback cb, CallbackDispatcher::Ptr d)
+                : callback(cb), dispatcher(d){}
         };
 
         struct DeleteContext
         {
             DeleteCallback callback;
-            DeleteContext(DeleteCallback cb) : callback(cb){}
+            CallbackDispatcher::Ptr dispatcher;
+            DeleteContext(DeleteCallback cb, CallbackDispatcher::Ptr d)
+                : callback(cb), dispatcher(d){}
         };
 
         struct ObserveContext
         {
             ObserveCallback callback;
-            ObserveContext(ObserveCallback cb) : callback(cb){}
+            CallbackDispatcher::Ptr dispatcher;
+            ObserveContext(ObserveCallback cb, CallbackDispatcher::Ptr d)
+                : callback(cb), dispatcher(d){}
         };
 
 #ifdef WITH_MQ
@@ -118,8 +137,10 @@ namespace OC
         {
             MQTopicCallback callback;
             std::weak_ptr<IClientWrapper> clientWrapper;
-            MQTopicContext(MQTopicCallback cb, std::weak_ptr<IClientWrapper> cw)
-                : callback(cb), clientWrapper(cw){}
+            CallbackDispatcher::Ptr dispatcher;
+            MQTopicContext(MQTopicCallback cb, std::weak_ptr<IClientWrapper> cw,
+                           CallbackDispatcher::Ptr d)
+                : callback(cb), clientWrapper(cw), dispatcher(d){}
         };
 #endif
     }
@@ -244,6 +265,7 @@ namespace OC
 
     private:
         PlatformConfig  m_cfg;
+        CallbackDispatcher::Ptr m_dispatcher;
     };
 }
 
@@ -131,6 +131,33 @@ namespace OC
         NaQos       = OC_NA_QOS
     };
 
+    /**
+     * How the client runs application callbacks such as FindCallback or GetCallback.
+     */
+    enum class CallbackExecution
+    {
+        /** Every callback runs on a new detached thread. Callbacks are not ordered. */
+        NewThread,
+
+        /**
+         * Callbacks run on the thread processing the stack, before the next message is
+         * handled. A callback must not wait for another callback.
+         */
+        Inline,
+
+        /** Callbacks run on PlatformConfig::callbackThreads threads. */
+        ThreadPool,
+
+        /** Callbacks are handed to PlatformConfig::callbackExecutor. */
+        Custom
+    };
+
+    /**
+     * Runs a task on an application-chosen thread, used with CallbackExecution::Custom.
+     * The task may be run on any thread, but must be run exactly once.
+     */
+    typedef std::function<void(std::function<void()>)> CallbackExecutor;
+
     /**
      *  Data structure to provide the configuration.
      */
@@ -175,6 +202,19 @@ namespace OC
          */
         bool                       useLegacyCleanup;
 
+        /**
+         * How callbacks to the client API are run. With ThreadPool and Custom, callbacks
+         * for the same request (OCDoHandle) run one at a time, in the order the responses
+         * arrived. The default, NewThread, starts a thread per callback.
+         */
+        CallbackExecution          callbackExecution;
+
+        /** number of threads for CallbackExecution::ThreadPool, 0 for one per CPU. */
+        unsigned int               callbackThreads;
+
+        /** executor for CallbackExecution::Custom. */
+        CallbackExecutor           callbackExecutor;
+
         public:
             PlatformConfig(const ServiceType serviceType_,
             const ModeType mode_,
@@ -188,7 +228,9 @@ namespace OC
                 port(0),
                 QoS(QualityOfService::NaQos),
                 ps(ps_),
-                useLegacyCleanup(false)
+                useLegacyCleanup(false),
+                callbackExecution(CallbackExecution::NewThread),
+                callbackThreads(0)
         {}
             /* @deprecated: Use a non deprecated constructor. */
             PlatformConfig()
@@ -201,7 +243,9 @@ namespace OC
                 port(0),
                 QoS(QualityOfService::NaQos),
                 ps(nullptr),
-                useLegacyCleanup(true)
+                useLegacyCleanup(true),
+                callbackExecution(CallbackExecution::NewThread),
+                callbackThreads(0)
         {}
             /* @deprecated: Use a non deprecated constructor. */
             PlatformConfig(const ServiceType serviceType_,
@@ -219,7 +263,9 @@ namespace OC
                 port(0),
                 QoS(QoS_),
                 ps(ps_),
-                useLegacyCleanup(true)
+                useLegacyCleanup(true),
+                callbackExecution(CallbackExecution::NewThread),
+                callbackThreads(0)
         {}
             /* @deprecated: Use a non deprecated constructor. */
             PlatformConfig(const ServiceType serviceType_,
@@ -237,7 +283,9 @@ namespace OC
                 port(port_),
                 QoS(QoS_),
                 ps(ps_),
-                useLegacyCleanup(true)
+                useLegacyCleanup(true),
+                callbackExecution(CallbackExecution::NewThread),
+                callbackThreads(0)
         {}
             /* @deprecated: Use a non deprecated constructor. */
             PlatformConfig(const ServiceType serviceType_,
@@ -255,7 +303,9 @@ namespace OC
                 ipAddress(ipAddress_),
                 port(port_),
                 QoS(QoS_),
-                ps(ps_)
+                ps(ps_),
+                callbackExecution(CallbackExecution::NewThread),
+                callbackThreads(0)
         {}
             PlatformConfig(const ServiceType serviceType_,
             const ModeType mode_,
@@ -271,7 +321,9 @@ namespace OC
                 port(0),
                 QoS(QoS_),
                 ps(ps_),
-                useLegacyCleanup(true)
+                useLegacyCleanup(true),
+                callbackExecution(CallbackExecution::NewThread),
+                callbackThreads(0)
         {}
             /* @deprecated: Use a non deprecated constructor. */
             PlatformConfig(const ServiceType serviceType_,
@@ -290,7 +342,9 @@ namespace OC
                 port(0),
                 QoS(QoS_),
                 ps(ps_),
-                useLegacyCleanup(true)
+                useLegacyCleanup(true),
+                callbackExecution(CallbackExecution::NewThread),
+                callbackThreads(0)
         {}
 
     };
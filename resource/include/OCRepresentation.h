@@ -63,8 +63,16 @@ namespace OC
 
             void setPayload(const OCRepPayload* rep);
 
+            void setPayload(const OCEncodedRepPayload* rep);
+
             OCRepPayload* getPayload() const;
 
+            /**
+             * Encodes the representations straight to CBOR, the same CBOR as
+             * OCConvertPayload makes of getPayload().
+             */
+            OCEncodedRepPayload* getEncodedPayload() const;
+
             const std::vector<OCRepresentation>& representations() const;
 
             void addRepresentation(const OCRepresentation& rep);
@@ -190,6 +190,16 @@ namespace OC
         friend class InProcServerWrapper;
 
         OCRepPayload* getPayload() const
+        {
+            return getMessageContainer().getPayload();
+        }
+
+        OCEncodedRepPayload* getEncodedPayload() const
+        {
+            return getMessageContainer().getEncodedPayload();
+        }
+
+        MessageContainer getMessageContainer() const
         {
             MessageContainer inf;
             OCRepresentation first(m_representation);
@@ -230,7 +240,7 @@ namespace OC
 
             }
 
-            return inf.getPayload();
+            return inf;
         }
     public:
 
@@ -489,7 +489,7 @@ int main(int argc, char *argv[])
         return res;
     }
 
-    res = ca_thread_pool_add_task(g_threadPoolHandle, userRequests, NULL);
+    res = ca_thread_pool_add_long_running_task(g_threadPoolHandle, userRequests, NULL);
     if (CA_STATUS_OK != res)
     {
         OIC_LOG(ERROR, TAG, "thread pool add task error.");
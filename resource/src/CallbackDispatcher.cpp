@@ -0,0 +1,190 @@
+//******************************************************************
+//
+// Copyright 2017 Samsung Electronics All Rights Reserved.
+//
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+
+#include "iotivity_config.h"
+
+#include "CallbackDispatcher.h"
+#include "experimental/logger.h"
+
+#define TAG "OIC_CALLBACK_DISPATCHER"
+
+namespace OC
+{
+    CallbackDispatcher::CallbackDispatcher(CallbackExecution execution, unsigned int threads,
+                                           CallbackExecutor executor)
+        : m_state(std::make_shared<State>(execution, executor))
+    {
+        if (CallbackExecution::Custom == execution && !executor)
+        {
+            OIC_LOG(ERROR, TAG, "no callback executor given, using a thread per callback");
+            m_state->execution = CallbackExecution::NewThread;
+        }
+
+        if (CallbackExecution::ThreadPool == m_state->execution)
+        {
+            if (0 == threads)
+            {
+                threads = std::thread::hardware_concurrency();
+            }
+            threads = (0 == threads) ? 1 : threads;
+
+            for (unsigned int i = 0; i < threads; i++)
+            {
+                m_threads.push_back(std::thread(&CallbackDispatcher::work, m_state));
+            }
+        }
+    }
+
+    CallbackDispatcher::~CallbackDispatcher()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_state->queueLock);
+            m_state->stopping = true;
+        }
+        m_state->queueCond.notify_all();
+
+        for (auto& thread : m_threads)
+        {
+            // The last reference may be dropped by a callback on a pool thread, which
+            // cannot join itself. It uses only the state it holds, and returns once the
+            // other threads have emptied the queue.
+            if (thread.get_id() == std::this_thread::get_id())
+            {
+                thread.detach();
+            }
+            else
+            {
+                thread.join();
+            }
+        }
+    }
+
+    void CallbackDispatcher::post(const void* key, Task task)
+    {
+        switch (m_state->execution)
+        {
+            case CallbackExecution::Inline:
+                run(task);
+                return;
+            case CallbackExecution::NewThread:
+                std::thread(&CallbackDispatcher::run, std::move(task)).detach();
+                return;
+            default:
+                break;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_state->pendingLock);
+            std::deque<Task>& tasks = m_state->pending[key];
+            tasks.push_back(std::move(task));
+            if (1 < tasks.size())
+            {
+                // the drain of the earlier task runs this one
+                return;
+            }
+        }
+        m_state->schedule(key);
+    }
+
+    CallbackDispatcher::State::State(CallbackExecution execution, CallbackExecutor executor)
+        : execution(execution), executor(executor), stopping(false)
+    {
+    }
+
+    void CallbackDispatcher::State::schedule(const void* key)
+    {
+        auto self = shared_from_this();
+        if (CallbackExecution::ThreadPool == execution)
+        {
+            {
+                std::lock_guard<std::mutex> lock(queueLock);
+                queue.push_back([self, key]{ self->drain(key); });
+            }
+            queueCond.notify_one();
+        }
+        else
+        {
+            executor([self, key]{ self->drain(key); });
+        }
+    }
+
+    void CallbackDispatcher::State::drain(const void* key)
+    {
+        Task task;
+        {
+            std::lock_guard<std::mutex> lock(pendingLock);
+            task = pending[key].front();
+        }
+
+        run(task);
+
+        bool more = false;
+        {
+            std::lock_guard<std::mutex> lock(pendingLock);
+            auto it = pending.find(key);
+            it->second.pop_front();
+            more = !it->second.empty();
+            if (!more)
+            {
+                pending.erase(it);
+            }
+        }
+
+        // one task per drain, so that a busy key does not hold the thread
+        if (more)
+        {
+            schedule(key);
+        }
+    }
+
+    void CallbackDispatcher::work(std::shared_ptr<State> state)
+    {
+        for (;;)
+        {
+            Task task;
+            {
+                std::unique_lock<std::mutex> lock(state->queueLock);
+                state->queueCond.wait(lock, [&state]
+                {
+                    return state->stopping || !state->queue.empty();
+                });
+                if (state->queue.empty())
+                {
+                    return;
+                }
+                task = std::move(state->queue.front());
+                state->queue.pop_front();
+            }
+            task();
+        }
+    }
+
+    void CallbackDispatcher::run(const Task& task)
+    {
+        try
+        {
+            task();
+        }
+        catch (std::exception& e)
+        {
+            OIC_LOG_V(ERROR, TAG, "Exception in callback: %s", e.what());
+        }
+    }
+}
@@ -31,6 +31,10 @@
 
 #define TAG "OIC_CLIENT_WRAPPER"
 
+// Longest wait between OCProcess calls when the stack has nothing to do. Stack timers
+// and stop() end the wait earlier.
+#define PROCESS_WAIT_TIMEOUT_MS (1000)
+
 using namespace std;
 
 namespace OC
@@ -38,7 +42,10 @@ namespace OC
     InProcClientWrapper::InProcClientWrapper(
         std::weak_ptr<std::recursive_mutex> csdkLock, PlatformConfig cfg)
             : m_threadRun(false), m_csdkLock(csdkLock),
-              m_cfg { cfg }
+              m_cfg { cfg },
+              m_dispatcher(std::make_shared<CallbackDispatcher>(cfg.callbackExecution,
+                                                                cfg.callbackThreads,
+                                                                cfg.callbackExecutor))
     {
         // if the config type is server, we ought to never get called.  If the config type
         // is both, we count on the server to run the thread and do the initialize
@@ -79,6 +86,7 @@ namespace OC
         if (m_threadRun && m_listeningThread.joinable())
         {
             m_threadRun = false;
+            OCCancelProcessWait();
             m_listeningThread.join();
         }
         return OC_STACK_OK;
@@ -105,8 +113,11 @@ namespace OC
                 // TODO: do something with result if failed?
             }
 
-            // To minimize CPU utilization we may wish to do this with sleep
-            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            // Wait without the csdk lock so that other threads can call into the stack.
+            if (OC_STACK_OK != OCProcessWait(PROCESS_WAIT_TIMEOUT_MS))
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            }
         }
     }
 
@@ -114,7 +125,8 @@ namespace OC
     {
         if (clientResponse->payload == nullptr ||
                 (
-                    clientResponse->payload->type != PAYLOAD_TYPE_REPRESENTATION
+                    clientResponse->payload->type != PAYLOAD_TYPE_REPRESENTATION &&
+                    clientResponse->payload->type != PAYLOAD_TYPE_ENCODED_REPRESENTATION
                 )
           )
         {
@@ -168,7 +180,7 @@ namespace OC
         }
     }
 
-    OCStackApplicationResult listenCallback(void* ctx, OCDoHandle /*handle*/,
+    OCStackApplicationResult listenCallback(void* ctx, OCDoHandle handle,
         OCClientResponse* clientResponse)
     {
         if (!ctx || !clientResponse)
@@ -215,8 +227,7 @@ namespace OC
 
             for(auto resource : container.Resources())
             {
-                std::thread exec(context->callback, resource);
-                exec.detach();
+                context->dispatcher->post(handle, std::bind(context->callback, resource));
             }
         }
         catch (std::exception &e)
@@ -229,7 +240,7 @@ namespace OC
         return OC_STACK_KEEP_TRANSACTION;
     }
 
-    OCStackApplicationResult listenErrorCallback(void* ctx, OCDoHandle /*handle*/,
+    OCStackApplicationResult listenErrorCallback(void* ctx, OCDoHandle handle,
         OCClientResponse* clientResponse)
     {
         if (!ctx || !clientResponse)
@@ -267,16 +278,14 @@ namespace OC
             // loop to ensure valid construction of all resources
             for (auto resource : container.Resources())
             {
-                std::thread exec(context->callback, resource);
-                exec.detach();
+                context->dispatcher->post(handle, std::bind(context->callback, resource));
             }
             return OC_STACK_KEEP_TRANSACTION;
         }
 
         OIC_LOG_V(DEBUG, TAG, "%s: call response callback", __func__);
         std::string resourceURI = clientResponse->resourceUri;
-        std::thread exec(context->errorCallback, resourceURI, result);
-        exec.detach();
+        context->dispatcher->post(handle, std::bind(context->errorCallback, resourceURI, result));
         return OC_STACK_KEEP_TRANSACTION;
     }
 
@@ -296,7 +305,8 @@ namespace OC
         resourceUri << serviceUrl << resourceType;
 
         ClientCallbackContext::ListenContext* context =
-            new ClientCallbackContext::ListenContext(callback, shared_from_this());
+            new ClientCallbackContext::ListenContext(callback, shared_from_this(),
+                                                     m_dispatcher);
         OCCallbackData cbdata;
         cbdata.context = static_cast<void*>(context),
         cbdata.cb      = listenCallback;
@@ -338,7 +348,7 @@ namespace OC
 
         ClientCallbackContext::ListenErrorContext* context =
             new ClientCallbackContext::ListenErrorContext(callback, errorCallback,
-                                                          shared_from_this());
+                                                          shared_from_this(), m_dispatcher);
         if (!context)
         {
             return OC_STACK_ERROR;
@@ -370,7 +380,7 @@ namespace OC
         return result;
     }
 
-    OCStackApplicationResult listenResListCallback(void* ctx, OCDoHandle /*handle*/,
+    OCStackApplicationResult listenResListCallback(void* ctx, OCDoHandle handle,
         OCClientResponse* clientResponse)
     {
         if (!ctx || !clientResponse)
@@ -415,8 +425,7 @@ namespace OC
                     reinterpret_cast< OCDiscoveryPayload* >(clientResponse->payload));
 
             OIC_LOG_V(DEBUG, TAG, "%s: call response callback", __func__);
-            std::thread exec(context->callback, container.Resources());
-            exec.detach();
+            context->dispatcher->post(handle, std::bind(context->callback, container.Resources()));
         }
         catch (std::exception &e)
         {
@@ -443,7 +452,8 @@ namespace OC
         resourceUri << serviceUrl << resourceType;
 
         ClientCallbackContext::ListenResListContext* context =
-            new ClientCallbackContext::ListenResListContext(callback, shared_from_this());
+            new ClientCallbackContext::ListenResListContext(callback, shared_from_this(),
+                                                            m_dispatcher);
         OCCallbackData cbdata;
         cbdata.context = static_cast<void*>(context),
         cbdata.cb      = listenResListCallback;
@@ -468,7 +478,7 @@ namespace OC
         return result;
     }
 
-    OCStackApplicationResult listenResListWithErrorCallback(void* ctx, OCDoHandle /*handle*/,
+    OCStackApplicationResult listenResListWithErrorCallback(void* ctx, OCDoHandle handle,
         OCClientResponse* clientResponse)
     {
         if (!ctx || !clientResponse)
@@ -487,8 +497,7 @@ namespace OC
 
             //send the error callback
             std::string uri = clientResponse->resourceUri;
-            std::thread exec(context->errorCallback, uri, result);
-            exec.detach();
+            context->dispatcher->post(handle, std::bind(context->errorCallback, uri, result));
             return OC_STACK_KEEP_TRANSACTION;
         }
 
@@ -517,8 +526,7 @@ namespace OC
                     reinterpret_cast< OCDiscoveryPayload* >(clientResponse->payload));
 
             OIC_LOG_V(DEBUG, TAG, "%s: call response callback", __func__);
-            std::thread exec(context->callback, container.Resources());
-            exec.detach();
+            context->dispatcher->post(handle, std::bind(context->callback, container.Resources()));
         }
         catch (std::exception &e)
         {
@@ -547,7 +555,7 @@ namespace OC
 
         ClientCallbackContext::ListenResListWithErrorContext* context =
             new ClientCallbackContext::ListenResListWithErrorContext(callback, errorCallback,
-                                                          shared_from_this());
+                                                          shared_from_this(), m_dispatcher);
         if (!context)
         {
             return OC_STACK_ERROR;
@@ -578,7 +586,7 @@ namespace OC
     }
 
 #ifdef WITH_MQ
-    OCStackApplicationResult listenMQCallback(void* ctx, OCDoHandle /*handle*/,
+    OCStackApplicationResult listenMQCallback(void* ctx, OCDoHandle handle,
                                               OCClientResponse* clientResponse)
     {
         ClientCallbackContext::MQTopicContext* context =
@@ -596,9 +604,8 @@ namespace OC
                     << clientResponse->result
                     << std::flush;
 
-            std::thread exec(context->callback, clientResponse->result,
-                             resourceURI, nullptr);
-            exec.detach();
+            context->dispatcher->post(handle, std::bind(context->callback, clientResponse->result,
+                                                        resourceURI, nullptr));
 
             return OC_STACK_DELETE_TRANSACTION;
         }
@@ -619,9 +626,9 @@ namespace OC
             // loop to ensure valid construction of all resources
             for (auto resource : container.Resources())
             {
-                std::thread exec(context->callback, clientResponse->result,
-                                 resourceURI, resource);
-                exec.detach();
+                context->dispatcher->post(handle, std::bind(context->callback,
+                                                            clientResponse->result, resourceURI,
+                                                            resource));
             }
         }
         catch (std::exception &e)
@@ -648,7 +655,7 @@ namespace OC
         }
 
         ClientCallbackContext::MQTopicContext* context =
-            new ClientCallbackContext::MQTopicContext(callback, shared_from_this());
+            new ClientCallbackContext::MQTopicContext(callback, shared_from_this(), m_dispatcher);
         OCCallbackData cbdata;
         cbdata.context = static_cast<void*>(context),
         cbdata.cb      = listenMQCallback;
@@ -682,7 +689,7 @@ namespace OC
 #endif
 
     OCStackApplicationResult listenDeviceCallback(void* ctx,
-                                                  OCDoHandle /*handle*/,
+                                                  OCDoHandle handle,
             OCClientResponse* clientResponse)
     {
         ClientCallbackContext::DeviceListenContext* context =
@@ -692,8 +699,7 @@ namespace OC
         {
             OIC_LOG_V(DEBUG, TAG, "%s: call response callback", __func__);
             OCRepresentation rep = parseGetSetCallback(clientResponse);
-            std::thread exec(context->callback, rep);
-            exec.detach();
+            context->dispatcher->post(handle, std::bind(context->callback, rep));
         }
         catch(OC::OCException& e)
         {
@@ -720,7 +726,8 @@ namespace OC
         deviceUri << serviceUrl << deviceURI;
 
         ClientCallbackContext::DeviceListenContext* context =
-            new ClientCallbackContext::DeviceListenContext(callback, shared_from_this());
+            new ClientCallbackContext::DeviceListenContext(callback, shared_from_this(),
+                                                           m_dispatcher);
         OCCallbackData cbdata;
 
         cbdata.context = static_cast<void*>(context),
@@ -747,7 +754,7 @@ namespace OC
     }
 
 #ifdef WITH_MQ
-    OCStackApplicationResult createMQTopicCallback(void* ctx, OCDoHandle /*handle*/,
+    OCStackApplicationResult createMQTopicCallback(void* ctx, OCDoHandle handle,
                     OCClientResponse* clientResponse)
     {
         ClientCallbackContext::MQTopicContext* context =
@@ -804,19 +811,15 @@ namespace OC
                                             createdUri);
                 for (auto resource : container.Resources())
                 {
-                    std::thread exec(context->callback, result,
-                                     createdUri,
-                                     resource);
-                    exec.detach();
+                    context->dispatcher->post(handle, std::bind(context->callback, result,
+                                                                createdUri, resource));
                 }
             }
             else
             {
                 OIC_LOG_V(DEBUG, TAG, "%s: call response callback", __func__);
-                std::thread exec(context->callback, result,
-                                 createdUri,
-                                 nullptr);
-                exec.detach();
+                context->dispatcher->post(handle, std::bind(context->callback, result, createdUri,
+                                                            nullptr));
             }
         }
         catch (std::exception &e)
@@ -840,7 +843,7 @@ namespace OC
         }
         OCStackResult result;
         ClientCallbackContext::MQTopicContext* ctx =
-                new ClientCallbackContext::MQTopicContext(callback, shared_from_this());
+                new ClientCallbackContext::MQTopicContext(callback, shared_from_this(), m_dispatcher);
         OCCallbackData cbdata;
         cbdata.context = static_cast<void*>(ctx),
         cbdata.cb      = createMQTopicCallback;
@@ -874,7 +877,7 @@ namespace OC
     }
 #endif
     OCStackApplicationResult getResourceCallback(void* ctx,
-                                                 OCDoHandle /*handle*/,
+                                                 OCDoHandle handle,
         OCClientResponse* clientResponse)
     {
         ClientCallbackContext::GetContext* context =
@@ -894,8 +897,8 @@ namespace OC
         }
 
         OIC_LOG_V(DEBUG, TAG, "%s: call response callback", __func__);
-        std::thread exec(context->callback, serverHeaderOptions, rep, result);
-        exec.detach();
+        context->dispatcher->post(handle, std::bind(context->callback, serverHeaderOptions, rep,
+                                                    result));
         return OC_STACK_DELETE_TRANSACTION;
     }
 
@@ -913,7 +916,7 @@ namespace OC
 
         OCStackResult result;
         ClientCallbackContext::GetContext* ctx =
-            new ClientCallbackContext::GetContext(callback);
+            new ClientCallbackContext::GetContext(callback, m_dispatcher);
 
         OCCallbackData cbdata;
         cbdata.context = static_cast<void*>(ctx);
@@ -927,10 +930,11 @@ namespace OC
         if (cLock)
         {
             std::lock_guard<std::recursive_mutex> lock(*cLock);
+            OCDoHandle handle;
             OCHeaderOption options[MAX_HEADER_OPTIONS];
 
             result = OCDoResource(
-                                  nullptr, OC_REST_GET,
+                                  &handle, OC_REST_GET,
                                   uri.c_str(),
                                   &devAddr, nullptr,
                                   connectivityType,
@@ -938,6 +942,10 @@ namespace OC
                                   &cbdata,
                                   assembleHeaderOptions(options, headerOptions),
                                   (uint8_t)headerOptions.size());
+            if (OC_STACK_OK == result)
+            {
+                OCSetResponsePayloadEncoded(handle, true);
+            }
         }
         else
         {
@@ -949,7 +957,7 @@ namespace OC
 
 
     OCStackApplicationResult setResourceCallback(void* ctx,
-                                                 OCDoHandle /*handle*/,
+                                                 OCDoHandle handle,
         OCClientResponse* clientResponse)
     {
         ClientCallbackContext::SetContext* context =
@@ -970,8 +978,8 @@ namespace OC
         }
 
         OIC_LOG_V(DEBUG, TAG, "%s: call response callback", __func__);
-        std::thread exec(context->callback, serverHeaderOptions, attrs, result);
-        exec.detach();
+        context->dispatcher->post(handle, std::bind(context->callback, serverHeaderOptions, attrs,
+                                                    result));
         return OC_STACK_DELETE_TRANSACTION;
     }
 
@@ -1063,7 +1071,7 @@ namespace OC
             ocInfo.addRepresentation(r);
         }
 
-        return reinterpret_cast<OCPayload*>(ocInfo.getPayload());
+        return reinterpret_cast<OCPayload*>(ocInfo.getEncodedPayload());
     }
 
     OCStackResult InProcClientWrapper::PostResourceRepresentation(
@@ -1080,7 +1088,7 @@ namespace OC
         }
 
         OCStackResult result;
-        ClientCallbackContext::SetContext* ctx = new ClientCallbackContext::SetContext(callback);
+        ClientCallbackContext::SetContext* ctx = new ClientCallbackContext::SetContext(callback, m_dispatcher);
         OCCallbackData cbdata;
         cbdata.context = static_cast<void*>(ctx),
         cbdata.cb      = setResourceCallback;
@@ -1094,9 +1102,10 @@ namespace OC
         if (cLock)
         {
             std::lock_guard<std::recursive_mutex> lock(*cLock);
+            OCDoHandle handle;
             OCHeaderOption options[MAX_HEADER_OPTIONS];
 
-            result = OCDoResource(nullptr, OC_REST_POST,
+            result = OCDoResource(&handle, OC_REST_POST,
                                   url.c_str(), &devAddr,
                                   assembleSetResourcePayload(rep),
                                   connectivityType,
@@ -1104,6 +1113,10 @@ namespace OC
                                   &cbdata,
                                   assembleHeaderOptions(options, headerOptions),
                                   (uint8_t)headerOptions.size());
+            if (OC_STACK_OK == result)
+            {
+                OCSetResponsePayloadEncoded(handle, true);
+            }
         }
         else
         {
@@ -1127,7 +1140,7 @@ namespace OC
         }
 
         OCStackResult result;
-        ClientCallbackContext::SetContext* ctx = new ClientCallbackContext::SetContext(callback);
+        ClientCallbackContext::SetContext* ctx = new ClientCallbackContext::SetContext(callback, m_dispatcher);
         OCCallbackData cbdata;
         cbdata.context = static_cast<void*>(ctx),
         cbdata.cb      = setResourceCallback;
@@ -1152,6 +1165,10 @@ namespace OC
                                   &cbdata,
                                   assembleHeaderOptions(options, headerOptions),
                                   (uint8_t)headerOptions.size());
+            if (OC_STACK_OK == result)
+            {
+                OCSetResponsePayloadEncoded(handle, true);
+            }
         }
         else
         {
@@ -1163,7 +1180,7 @@ namespace OC
     }
 
     OCStackApplicationResult deleteResourceCallback(void* ctx,
-                                                    OCDoHandle /*handle*/,
+                                                    OCDoHandle handle,
         OCClientResponse* clientResponse)
     {
         ClientCallbackContext::DeleteContext* context =
@@ -1173,8 +1190,8 @@ namespace OC
         parseServerHeaderOptions(clientResponse, serverHeaderOptions);
 
         OIC_LOG_V(DEBUG, TAG, "%s: call response callback", __func__);
-        std::thread exec(context->callback, serverHeaderOptions, clientResponse->result);
-        exec.detach();
+        context->dispatcher->post(handle, std::bind(context->callback, serverHeaderOptions,
+                                                    clientResponse->result));
         return OC_STACK_DELETE_TRANSACTION;
     }
 
@@ -1193,7 +1210,7 @@ namespace OC
 
         OCStackResult result;
         ClientCallbackContext::DeleteContext* ctx =
-            new ClientCallbackContext::DeleteContext(callback);
+            new ClientCallbackContext::DeleteContext(callback, m_dispatcher);
         OCCallbackData cbdata;
         cbdata.context = static_cast<void*>(ctx),
         cbdata.cb      = deleteResourceCallback;
@@ -1227,7 +1244,7 @@ namespace OC
     }
 
     OCStackApplicationResult observeResourceCallback(void* ctx,
-                                                     OCDoHandle /*handle*/,
+                                                     OCDoHandle handle,
         OCClientResponse* clientResponse)
     {
         ClientCallbackContext::ObserveContext* context =
@@ -1248,9 +1265,8 @@ namespace OC
         }
 
         OIC_LOG_V(DEBUG, TAG, "%s: call response callback", __func__);
-        std::thread exec(context->callback, serverHeaderOptions, attrs,
-                    result, sequenceNumber);
-        exec.detach();
+        context->dispatcher->post(handle, std::bind(context->callback, serverHeaderOptions, attrs,
+                                                    result, sequenceNumber));
         if (sequenceNumber == MAX_SEQUENCE_NUMBER + 1)
         {
             return OC_STACK_DELETE_TRANSACTION;
@@ -1273,7 +1289,7 @@ namespace OC
         OCStackResult result;
 
         ClientCallbackContext::ObserveContext* ctx =
-            new ClientCallbackContext::ObserveContext(callback);
+            new ClientCallbackContext::ObserveContext(callback, m_dispatcher);
         OCCallbackData cbdata;
         cbdata.context = static_cast<void*>(ctx),
         cbdata.cb      = observeResourceCallback;
@@ -1307,6 +1323,10 @@ namespace OC
                                   &cbdata,
                                   assembleHeaderOptions(options, headerOptions),
                                   (uint8_t)headerOptions.size());
+            if (OC_STACK_OK == result && handle)
+            {
+                OCSetResponsePayloadEncoded(*handle, true);
+            }
         }
         else
         {
@@ -1354,7 +1374,7 @@ namespace OC
     }
 
     OCStackApplicationResult subscribePresenceCallback(void* ctx,
-                                                       OCDoHandle /*handle*/,
+                                                       OCDoHandle handle,
             OCClientResponse* clientResponse)
     {
         ClientCallbackContext::SubscribePresenceContext* context =
@@ -1366,10 +1386,8 @@ namespace OC
         std::string url = clientResponse->devAddr.addr;
 
         OIC_LOG_V(DEBUG, TAG, "%s: call response callback", __func__);
-        std::thread exec(context->callback, clientResponse->result,
-                    clientResponse->sequenceNumber, url);
-
-        exec.detach();
+        context->dispatcher->post(handle, std::bind(context->callback, clientResponse->result,
+                                                    clientResponse->sequenceNumber, url));
 
         return OC_STACK_KEEP_TRANSACTION;
     }
@@ -1384,7 +1402,8 @@ namespace OC
         }
 
         ClientCallbackContext::SubscribePresenceContext* ctx =
-            new ClientCallbackContext::SubscribePresenceContext(presenceHandler);
+            new ClientCallbackContext::SubscribePresenceContext(presenceHandler,
+                                                                m_dispatcher);
         OCCallbackData cbdata;
         cbdata.context = static_cast<void*>(ctx),
         cbdata.cb      = subscribePresenceCallback;
@@ -1445,7 +1464,7 @@ namespace OC
         OCStackResult result;
 
         ClientCallbackContext::ObserveContext* ctx =
-            new ClientCallbackContext::ObserveContext(callback);
+            new ClientCallbackContext::ObserveContext(callback, m_dispatcher);
         OCCallbackData cbdata;
         cbdata.context = static_cast<void*>(ctx),
         cbdata.cb      = observeResourceCallback;
@@ -45,6 +45,10 @@
 
 #define TAG "OIC_SERVER_WRAPPER"
 
+// Longest wait between OCProcess calls when the stack has nothing to do. Stack timers
+// and stop() end the wait earlier.
+#define PROCESS_WAIT_TIMEOUT_MS (1000)
+
 using namespace std;
 using namespace OC;
 
@@ -284,6 +288,7 @@ namespace OC
         if(m_processThread.joinable())
         {
             m_threadRun = false;
+            OCCancelProcessWait();
             m_processThread.join();
         }
 
@@ -308,7 +313,11 @@ namespace OC
                 // ...the value of variable result is simply ignored for now.
             }
 
-            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            // Wait without the csdk lock so that other threads can call into the stack.
+            if (OC_STACK_OK != OCProcessWait(PROCESS_WAIT_TIMEOUT_MS))
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            }
         }
     }
 
@@ -624,7 +633,7 @@ namespace OC
             response.requestHandle = pResponse->getRequestHandle();
             response.ehResult = pResponse->getResponseResult();
 
-            response.payload = reinterpret_cast<OCPayload*>(pResponse->getPayload());
+            response.payload = reinterpret_cast<OCPayload*>(pResponse->getEncodedPayload());
 
             response.persistentBufferFlag = 0;
 
@@ -56,6 +56,9 @@ namespace OC
             case PAYLOAD_TYPE_REPRESENTATION:
                 setPayload(reinterpret_cast<const OCRepPayload*>(rep));
                 break;
+            case PAYLOAD_TYPE_ENCODED_REPRESENTATION:
+                setPayload(reinterpret_cast<const OCEncodedRepPayload*>(rep));
+                break;
             default:
                 throw OC::OCException("Invalid Payload type in setPayload");
                 break;
@@ -0,0 +1,860 @@
+//******************************************************************
+//
+// Copyright 2017 Samsung Electronics All Rights Reserved.
+//
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+
+/**
+ * @file
+ *
+ * This file converts between OCRepresentation and CBOR without going through
+ * OCRepPayload. The CBOR written is the one OCConvertPayload makes of
+ * MessageContainer::getPayload(), and it is read back as OCParsePayload and
+ * MessageContainer::setPayload(const OCRepPayload*) together would.
+ */
+
+#include <OCRepresentation.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include "iotivity_config.h"
+#include "cbor.h"
+#include "ocpayload.h"
+#include "oic_malloc.h"
+
+namespace OC
+{
+    namespace
+    {
+        // Same first guess as the stack uses for its payloads.
+        const size_t INIT_SIZE = 255;
+
+        // Like the stack, errors are or'ed together so that an encoder running out of
+        // buffer keeps counting the bytes it needs.
+        typedef int64_t EncodeResult;
+
+        EncodeResult encodeProperties(CborEncoder* map, const OCRepresentation& rep);
+        EncodeResult encodeItem(CborEncoder* encoder, int value);
+        EncodeResult encodeItem(CborEncoder* encoder, double value);
+        EncodeResult encodeItem(CborEncoder* encoder, bool value);
+        EncodeResult encodeItem(CborEncoder* encoder, const std::string& value);
+        EncodeResult encodeItem(CborEncoder* encoder, const OCByteString& value);
+        EncodeResult encodeItem(CborEncoder* encoder, const OCRepresentation& value);
+
+        EncodeResult encodeText(CborEncoder* encoder, const std::string& value)
+        {
+            // the payload path copies C strings, which end at the first NUL
+            return cbor_encode_text_string(encoder, value.c_str(), strlen(value.c_str()));
+        }
+
+        EncodeResult encodeTextArray(CborEncoder* map, const char* name,
+                                     const std::vector<std::string>& values)
+        {
+            EncodeResult err = CborNoError;
+            if (!values.empty())
+            {
+                CborEncoder array;
+                err |= cbor_encode_text_string(map, name, strlen(name));
+                err |= cbor_encoder_create_array(map, &array, values.size());
+                for (const std::string& value : values)
+                {
+                    err |= encodeText(&array, value);
+                }
+                err |= cbor_encoder_close_container(map, &array);
+            }
+            return err;
+        }
+
+        // Arrays are padded to the longest row, with what a zeroed C array holds.
+        template<typename T>
+        EncodeResult encodePadding(CborEncoder* encoder)
+        {
+            return encodeItem(encoder, T());
+        }
+
+        template<>
+        EncodeResult encodePadding<std::string>(CborEncoder* encoder)
+        {
+            return cbor_encode_null(encoder);
+        }
+
+        template<>
+        EncodeResult encodePadding<OCRepresentation>(CborEncoder* encoder)
+        {
+            return cbor_encode_null(encoder);
+        }
+
+        template<>
+        EncodeResult encodePadding<OCByteString>(CborEncoder* encoder)
+        {
+            return cbor_encode_byte_string(encoder, nullptr, 0);
+        }
+
+        template<typename T>
+        EncodeResult encodeArray(CborEncoder* parent, const std::vector<T>& arr,
+                                 const size_t* dimensions)
+        {
+            CborEncoder array;
+            EncodeResult err = cbor_encoder_create_array(parent, &array, dimensions[0]);
+            for (size_t i = 0; i < dimensions[0]; ++i)
+            {
+                err |= (i < arr.size()) ? encodeItem(&array, arr[i]) : encodePadding<T>(&array);
+            }
+            err |= cbor_encoder_close_container(parent, &array);
+            return err;
+        }
+
+        template<typename T>
+        EncodeResult encodeArray(CborEncoder* parent, const std::vector<std::vector<T>>& arr,
+                                 const size_t* dimensions)
+        {
+            static const std::vector<T> none;
+            CborEncoder array;
+            EncodeResult err = cbor_encoder_create_array(parent, &array, dimensions[0]);
+            for (size_t i = 0; i < dimensions[0]; ++i)
+            {
+                err |= encodeArray(&array, (i < arr.size()) ? arr[i] : none, dimensions + 1);
+            }
+            err |= cbor_encoder_close_container(parent, &array);
+            return err;
+        }
+
+        struct encode_value : boost::static_visitor<EncodeResult>
+        {
+            explicit encode_value(CborEncoder* encoder) : m_encoder(encoder) {}
+
+            EncodeResult operator()(const NullType&) const
+            {
+                return cbor_encode_null(m_encoder);
+            }
+
+            template<typename T>
+            EncodeResult operator()(const T& value) const
+            {
+                return encodeItem(m_encoder, value);
+            }
+
+            template<typename T>
+            EncodeResult operator()(const std::vector<T>& arr) const
+            {
+                size_t dimensions[MAX_REP_ARRAY_DEPTH] = {arr.size(), 0, 0};
+                return encodeArray(m_encoder, arr, dimensions);
+            }
+
+            template<typename T>
+            EncodeResult operator()(const std::vector<std::vector<T>>& arr) const
+            {
+                size_t dimensions[MAX_REP_ARRAY_DEPTH] = {arr.size(), 0, 0};
+                for (const auto& row : arr)
+                {
+                    dimensions[1] = std::max(dimensions[1], row.size());
+                }
+                return encodeArray(m_encoder, arr, dimensions);
+            }
+
+            template<typename T>
+            EncodeResult operator()(const std::vector<std::vector<std::vector<T>>>& arr) const
+            {
+                size_t dimensions[MAX_REP_ARRAY_DEPTH] = {arr.size(), 0, 0};
+                for (const auto& plane : arr)
+                {
+                    dimensions[1] = std::max(dimensions[1], plane.size());
+                    for (const auto& row : plane)
+                    {
+                        dimensions[2] = std::max(dimensions[2], row.size());
+                    }
+                }
+                return encodeArray(m_encoder, arr, dimensions);
+            }
+
+            EncodeResult operator()(const std::vector<uint8_t>& binary) const
+            {
+                return cbor_encode_byte_string(m_encoder, binary.data(), binary.size());
+            }
+
+            CborEncoder* m_encoder;
+        };
+
+        EncodeResult encodeItem(CborEncoder* encoder, int value)
+        {
+            return cbor_encode_int(encoder, value);
+        }
+
+        EncodeResult encodeItem(CborEncoder* encoder, double value)
+        {
+            return cbor_encode_double(encoder, value);
+        }
+
+        EncodeResult encodeItem(CborEncoder* encoder, bool value)
+        {
+            return cbor_encode_boolean(encoder, value);
+        }
+
+        EncodeResult encodeItem(CborEncoder* encoder, const std::string& value)
+        {
+            return encodeText(encoder, value);
+        }
+
+        EncodeResult encodeItem(CborEncoder* encoder, const OCByteString& value)
+        {
+            return cbor_encode_byte_string(encoder, value.bytes, value.len);
+        }
+
+        // A nested representation whose value names are 0, 1, 2, ... is an array.
+        EncodeResult encodeItem(CborEncoder* encoder, const OCRepresentation& value)
+        {
+            const std::map<std::string, AttributeValue>& values = value.getValues();
+            size_t arrayLength = 0;
+            bool isArray = true;
+            for (const auto& item : values)
+            {
+                char* endp = nullptr;
+                long i = strtol(item.first.c_str(), &endp, 0);
+                if (*endp != '\0' || i < 0 || arrayLength != static_cast<size_t>(i))
+                {
+                    isArray = false;
+                    break;
+                }
+                ++arrayLength;
+            }
+
+            CborEncoder container;
+            EncodeResult err = CborNoError;
+            if (isArray)
+            {
+                err |= cbor_encoder_create_array(encoder, &container, arrayLength);
+                encode_value visitor(&container);
+                for (const auto& item : values)
+                {
+                    err |= boost::apply_visitor(visitor, item.second);
+                }
+            }
+            else
+            {
+                err |= cbor_encoder_create_map(encoder, &container, CborIndefiniteLength);
+                err |= encodeProperties(&container, value);
+            }
+            err |= cbor_encoder_close_container(encoder, &container);
+            return err;
+        }
+
+        EncodeResult encodeProperties(CborEncoder* map, const OCRepresentation& rep)
+        {
+            EncodeResult err = CborNoError;
+            const std::string uri = rep.getUri();
+            if (strlen(uri.c_str()) > 0)
+            {
+                err |= cbor_encode_text_string(map, OC_RSRVD_HREF, strlen(OC_RSRVD_HREF));
+                err |= encodeText(map, uri);
+            }
+            err |= encodeTextArray(map, OC_RSRVD_RESOURCE_TYPE, rep.getResourceTypes());
+            err |= encodeTextArray(map, OC_RSRVD_INTERFACE, rep.getResourceInterfaces());
+
+            encode_value visitor(map);
+            for (const auto& item : rep.getValues())
+            {
+                err |= encodeText(map, item.first);
+                err |= boost::apply_visitor(visitor, item.second);
+            }
+            return err;
+        }
+
+        // On CborErrorOutOfMemory, size is updated to the size needed.
+        EncodeResult encodeRepresentations(const std::vector<OCRepresentation>& reps,
+                                           uint8_t* buffer, size_t* size)
+        {
+            CborEncoder encoder;
+            cbor_encoder_init(&encoder, buffer, *size, 0);
+
+            EncodeResult err = CborNoError;
+            CborEncoder rootArray;
+            CborEncoder* parent = &encoder;
+            if (reps.size() > 1)
+            {
+                err |= cbor_encoder_create_array(&encoder, &rootArray, reps.size());
+                parent = &rootArray;
+            }
+
+            for (const OCRepresentation& rep : reps)
+            {
+                CborEncoder rootMap;
+                err |= cbor_encoder_create_map(parent, &rootMap, CborIndefiniteLength);
+                err |= encodeProperties(&rootMap, rep);
+                err |= cbor_encoder_close_container(parent, &rootMap);
+            }
+
+            if (reps.size() > 1)
+            {
+                err |= cbor_encoder_close_container(&encoder, &rootArray);
+            }
+
+            if (CborErrorOutOfMemory == err)
+            {
+                *size += cbor_encoder_get_extra_bytes_needed(&encoder);
+            }
+            else if (CborNoError == err)
+            {
+                *size = cbor_encoder_get_buffer_size(&encoder, buffer);
+            }
+            return err;
+        }
+
+        CborError decodeProperties(CborValue* container, OCRepresentation& rep, bool isRoot);
+
+        CborError decodeText(const CborValue* value, std::string& out)
+        {
+            size_t len = 0;
+            CborError err = cbor_value_calculate_string_length(value, &len);
+            if (CborNoError != err)
+            {
+                return err;
+            }
+
+            // room for the NUL tinycbor appends
+            out.assign(len + 1, '\0');
+            len = out.size();
+            err = cbor_value_copy_text_string(value, &out[0], &len, nullptr);
+
+            // the payload path keeps C strings, which end at the first NUL
+            out.resize(strlen(out.c_str()));
+            return err;
+        }
+
+        // rt and if hold text strings of space separated values.
+        CborError decodeTextList(const CborValue* value, std::vector<std::string>& out)
+        {
+            if (!cbor_value_is_array(value))
+            {
+                return CborNoError;
+            }
+
+            CborValue item;
+            CborError err = cbor_value_enter_container(value, &item);
+            while (CborNoError == err && cbor_value_is_text_string(&item))
+            {
+                std::string text;
+                err = decodeText(&item, text);
+                size_t begin = text.find_first_not_of(' ');
+                while (std::string::npos != begin)
+                {
+                    size_t end = text.find(' ', begin);
+                    out.push_back(text.substr(begin, end - begin));
+                    begin = text.find_first_not_of(' ', end);
+                }
+                if (CborNoError == err)
+                {
+                    err = cbor_value_advance(&item);
+                }
+            }
+            return err;
+        }
+
+        OCRepPayloadPropType decodeType(CborType type)
+        {
+            switch (type)
+            {
+                case CborIntegerType:
+                    return OCREP_PROP_INT;
+                case CborDoubleType:
+                case CborFloatType:
+                    return OCREP_PROP_DOUBLE;
+                case CborBooleanType:
+                    return OCREP_PROP_BOOL;
+                case CborTextStringType:
+                    return OCREP_PROP_STRING;
+                case CborByteStringType:
+                    return OCREP_PROP_BYTE_STRING;
+                case CborMapType:
+                    return OCREP_PROP_OBJECT;
+                case CborArrayType:
+                    return OCREP_PROP_ARRAY;
+                default:
+                    return OCREP_PROP_NULL;
+            }
+        }
+
+        // Finds the size of the array, padded to its longest rows, and the type of its
+        // items. Nulls match any type; other mixed types are an error.
+        CborError findDimensions(const CborValue* value, size_t dimensions[MAX_REP_ARRAY_DEPTH],
+                                 OCRepPayloadPropType* type)
+        {
+            *type = OCREP_PROP_NULL;
+            dimensions[0] = dimensions[1] = dimensions[2] = 0;
+
+            CborValue item;
+            CborError err = cbor_value_enter_container(value, &item);
+            while (CborNoError == err && cbor_value_is_valid(&item))
+            {
+                OCRepPayloadPropType itemType = decodeType(cbor_value_get_type(&item));
+                if (OCREP_PROP_ARRAY == itemType)
+                {
+                    size_t subdimensions[MAX_REP_ARRAY_DEPTH];
+                    err = findDimensions(&item, subdimensions, &itemType);
+                    if (CborNoError != err)
+                    {
+                        return err;
+                    }
+                    if (0 != subdimensions[2])
+                    {
+                        return CborErrorNestingTooDeep;
+                    }
+                    dimensions[1] = std::max(dimensions[1], subdimensions[0]);
+                    dimensions[2] = std::max(dimensions[2], subdimensions[1]);
+                }
+
+                if (OCREP_PROP_NULL == *type)
+                {
+                    *type = itemType;
+                }
+                else if (OCREP_PROP_NULL != itemType && *type != itemType)
+                {
+                    return CborErrorIllegalType;
+                }
+
+                ++dimensions[0];
+                err = cbor_value_advance(&item);
+            }
+            return err;
+        }
+
+        // Array items are read at *value, which is then advanced past them.
+        CborError decodeItem(CborValue* value, int& out)
+        {
+            int64_t i = 0;
+            CborError err = cbor_value_is_integer(value) ?
+                            cbor_value_get_int64(value, &i) : CborErrorIllegalType;
+            out = static_cast<int>(i);
+            return (CborNoError == err) ? cbor_value_advance(value) : err;
+        }
+
+        CborError decodeItem(CborValue* value, double& out)
+        {
+            CborError err = CborErrorIllegalType;
+            if (CborDoubleType == cbor_value_get_type(value))
+            {
+                err = cbor_value_get_double(value, &out);
+            }
+            else if (CborFloatType == cbor_value_get_type(value))
+            {
+                float f = 0;
+                err = cbor_value_get_float(value, &f);
+                out = f;
+            }
+            return (CborNoError == err) ? cbor_value_advance(value) : err;
+        }
+
+        CborError decodeItem(CborValue* value, bool& out)
+        {
+            CborError err = cbor_value_is_boolean(value) ?
+                            cbor_value_get_boolean(value, &out) : CborErrorIllegalType;
+            return (CborNoError == err) ? cbor_value_advance(value) : err;
+        }
+
+        CborError decodeItem(CborValue* value, std::string& out)
+        {
+            CborError err = cbor_value_is_text_string(value) ?
+                            decodeText(value, out) : CborErrorIllegalType;
+            return (CborNoError == err) ? cbor_value_advance(value) : err;
+        }
+
+        // OCByteString does not own its bytes. As with OCRepPayload, they point into
+        // the payload, so the items are only good for as long as it is.
+        CborError decodeItem(CborValue* value, OCByteString& out)
+        {
+            if (!cbor_value_is_byte_string(value) || !cbor_value_is_length_known(value))
+            {
+                return CborErrorIllegalType;
+            }
+
+            size_t len = 0;
+            CborError err = cbor_value_get_string_length(value, &len);
+            if (CborNoError != err)
+            {
+                return err;
+            }
+
+            // skip the head of the item: the initial byte and the length following it
+            uint8_t info = value->ptr[0] & 0x1f;
+            size_t head = 1 + ((info < 24) ? 0 : (1 << (info - 24)));
+            out.bytes = len ? const_cast<uint8_t*>(value->ptr + head) : nullptr;
+            out.len = len;
+            return cbor_value_advance(value);
+        }
+
+        CborError decodeItem(CborValue* value, OCRepresentation& out)
+        {
+            return cbor_value_is_map(value) ?
+                   decodeProperties(value, out, false) : CborErrorIllegalType;
+        }
+
+        template<typename T>
+        void shape(std::vector<T>& arr, const size_t* dimensions)
+        {
+            arr.resize(dimensions[0]);
+        }
+
+        template<typename T>
+        void shape(std::vector<std::vector<T>>& arr, const size_t* dimensions)
+        {
+            arr.resize(dimensions[0]);
+            for (auto& row : arr)
+            {
+                shape(row, dimensions + 1);
+            }
+        }
+
+        // Nulls, and rows missing from a shorter row, keep their default value.
+        template<typename T>
+        CborError fillArray(const CborValue* value, std::vector<T>& arr)
+        {
+            CborValue item;
+            CborError err = cbor_value_enter_container(value, &item);
+            for (size_t i = 0; CborNoError == err && i < arr.size() && cbor_value_is_valid(&item);
+                 ++i)
+            {
+                if (cbor_value_is_null(&item))
+                {
+                    err = cbor_value_advance(&item);
+                    continue;
+                }
+
+                T decoded = T();
+                err = decodeItem(&item, decoded);
+                arr[i] = std::move(decoded);
+            }
+            return err;
+        }
+
+        template<typename T>
+        CborError fillArray(const CborValue* value, std::vector<std::vector<T>>& arr)
+        {
+            CborValue item;
+            CborError err = cbor_value_enter_container(value, &item);
+            for (size_t i = 0; CborNoError == err && i < arr.size() && cbor_value_is_valid(&item);
+                 ++i)
+            {
+                if (cbor_value_is_array(&item))
+                {
+                    err = fillArray(&item, arr[i]);
+                }
+                if (CborNoError == err)
+                {
+                    err = cbor_value_advance(&item);
+                }
+            }
+            return err;
+        }
+
+        template<typename T>
+        CborError decodeArrayOf(const CborValue* value, const size_t* dimensions,
+                                OCRepresentation& rep, const std::string& name)
+        {
+            CborError err = CborNoError;
+            if (0 == dimensions[1])
+            {
+                std::vector<T> arr;
+                shape(arr, dimensions);
+                err = fillArray(value, arr);
+                rep.setValue(name, std::move(arr));
+            }
+            else if (0 == dimensions[2])
+            {
+                std::vector<std::vector<T>> arr;
+                shape(arr, dimensions);
+                err = fillArray(value, arr);
+                rep.setValue(name, std::move(arr));
+            }
+            else
+            {
+                std::vector<std::vector<std::vector<T>>> arr;
+                shape(arr, dimensions);
+                err = fillArray(value, arr);
+                rep.setValue(name, std::move(arr));
+            }
+            return err;
+        }
+
+        // Does not advance *value.
+        CborError decodeArray(const CborValue* value, OCRepresentation& rep,
+                              const std::string& name)
+        {
+            size_t dimensions[MAX_REP_ARRAY_DEPTH];
+            OCRepPayloadPropType type = OCREP_PROP_NULL;
+            CborError err = findDimensions(value, dimensions, &type);
+            if (CborNoError == err)
+            {
+                switch (type)
+                {
+                    case OCREP_PROP_NULL:
+                        rep.setNULL(name);
+                        return CborNoError;
+                    case OCREP_PROP_INT:
+                        return decodeArrayOf<int>(value, dimensions, rep, name);
+                    case OCREP_PROP_DOUBLE:
+                        return decodeArrayOf<double>(value, dimensions, rep, name);
+                    case OCREP_PROP_BOOL:
+                        return decodeArrayOf<bool>(value, dimensions, rep, name);
+                    case OCREP_PROP_STRING:
+                        return decodeArrayOf<std::string>(value, dimensions, rep, name);
+                    case OCREP_PROP_BYTE_STRING:
+                        return decodeArrayOf<OCByteString>(value, dimensions, rep, name);
+                    case OCREP_PROP_OBJECT:
+                        return decodeArrayOf<OCRepresentation>(value, dimensions, rep, name);
+                    default:
+                        return CborErrorUnknownType;
+                }
+            }
+
+            // Not a uniform array; it becomes a representation named by index.
+            OCRepresentation indexed;
+            CborValue array = *value;
+            err = decodeProperties(&array, indexed, false);
+            rep.setValue(name, std::move(indexed));
+            return err;
+        }
+
+        // Advances *value past the value.
+        CborError decodeValue(CborValue* value, OCRepresentation& rep, const std::string& name)
+        {
+            CborError err = CborNoError;
+            switch (cbor_value_get_type(value))
+            {
+                case CborNullType:
+                    rep.setNULL(name);
+                    break;
+                case CborIntegerType:
+                    {
+                        int64_t i = 0;
+                        err = cbor_value_get_int64(value, &i);
+                        rep.setValue<int>(name, static_cast<int>(i));
+                    }
+                    break;
+                case CborDoubleType:
+                    {
+                        double d = 0;
+                        err = cbor_value_get_double(value, &d);
+                        rep.setValue<double>(name, d);
+                    }
+                    break;
+                case CborBooleanType:
+                    {
+                        bool b = false;
+                        err = cbor_value_get_boolean(value, &b);
+                        rep.setValue<bool>(name, b);
+                    }
+                    break;
+                case CborTextStringType:
+                    {
+                        std::string text;
+                        err = decodeText(value, text);
+                        rep.setValue(name, std::move(text));
+                    }
+                    break;
+                case CborByteStringType:
+                    {
+                        size_t len = 0;
+                        err = cbor_value_calculate_string_length(value, &len);
+                        std::vector<uint8_t> binary(len);
+                        if (CborNoError == err && len)
+                        {
+                            err = cbor_value_copy_byte_string(value, binary.data(), &len, nullptr);
+                        }
+                        rep.setValue(name, std::move(binary));
+                    }
+                    break;
+                case CborMapType:
+                    {
+                        OCRepresentation object;
+                        err = decodeProperties(value, object, false);
+                        rep.setValue(name, std::move(object));
+                    }
+                    return err;
+                case CborArrayType:
+                    err = decodeArray(value, rep, name);
+                    break;
+                default:
+                    return CborErrorUnknownType;
+            }
+            return (CborNoError == err) ? cbor_value_advance(value) : err;
+        }
+
+        // Reads a map, or an array as values named by index, and leaves *value past it.
+        // In the root map href, rt and if are the uri, resource types and interfaces.
+        CborError decodeProperties(CborValue* value, OCRepresentation& rep, bool isRoot)
+        {
+            bool isMap = cbor_value_is_map(value);
+            size_t index = 0;
+            CborValue item;
+            CborError err = cbor_value_enter_container(value, &item);
+            while (CborNoError == err && cbor_value_is_valid(&item))
+            {
+                std::string name;
+                if (isMap)
+                {
+                    if (!cbor_value_is_text_string(&item))
+                    {
+                        return CborErrorIllegalType;
+                    }
+                    err = decodeText(&item, name);
+                    if (CborNoError == err)
+                    {
+                        err = cbor_value_advance(&item);
+                    }
+                    if (CborNoError != err)
+                    {
+                        return err;
+                    }
+
+                    if (isRoot && (OC_RSRVD_HREF == name || OC_RSRVD_RESOURCE_TYPE == name ||
+                                   OC_RSRVD_INTERFACE == name))
+                    {
+                        if (OC_RSRVD_HREF == name && cbor_value_is_text_string(&item))
+                        {
+                            std::string uri;
+                            err = decodeText(&item, uri);
+                            rep.setUri(uri);
+                        }
+                        else if (OC_RSRVD_RESOURCE_TYPE == name)
+                        {
+                            std::vector<std::string> types;
+                            err = decodeTextList(&item, types);
+                            rep.setResourceTypes(types);
+                        }
+                        else if (OC_RSRVD_INTERFACE == name)
+                        {
+                            std::vector<std::string> interfaces;
+                            err = decodeTextList(&item, interfaces);
+                            rep.setResourceInterfaces(interfaces);
+                        }
+                        if (CborNoError == err)
+                        {
+                            err = cbor_value_advance(&item);
+                        }
+                        continue;
+                    }
+                }
+                else
+                {
+                    name = std::to_string(index);
+                }
+
+                err = decodeValue(&item, rep, name);
+                ++index;
+            }
+
+            if (CborNoError == err)
+            {
+                err = cbor_value_leave_container(value, &item);
+            }
+            return err;
+        }
+
+        CborError decodeRepresentations(const uint8_t* buffer, size_t size,
+                                        std::vector<OCRepresentation>& reps)
+        {
+            CborParser parser;
+            CborValue root;
+            CborError err = cbor_parser_init(buffer, size, 0, &parser, &root);
+
+            // A list of representations comes as an array of maps.
+            CborValue item = root;
+            if (CborNoError == err && cbor_value_is_array(&root))
+            {
+                err = cbor_value_enter_container(&root, &item);
+            }
+
+            while (CborNoError == err && cbor_value_is_valid(&item))
+            {
+                OCRepresentation rep;
+                if (cbor_value_is_map(&item))
+                {
+                    err = decodeProperties(&item, rep, true);
+                }
+                else if (cbor_value_is_array(&item))
+                {
+                    err = cbor_value_advance(&item);
+                }
+                else
+                {
+                    err = CborErrorIllegalType;
+                }
+                reps.push_back(std::move(rep));
+            }
+            return err;
+        }
+    }
+
+    void MessageContainer::setPayload(const OCEncodedRepPayload* payload)
+    {
+        std::vector<OCRepresentation> reps;
+        if (CborNoError != decodeRepresentations(payload->cborPayload.bytes,
+                                                 payload->cborPayload.len, reps))
+        {
+            throw OC::OCException("Invalid representation in setPayload",
+                                  OC_STACK_MALFORMED_RESPONSE);
+        }
+        m_reps.insert(m_reps.end(), reps.begin(), reps.end());
+    }
+
+    OCEncodedRepPayload* MessageContainer::getEncodedPayload() const
+    {
+        if (m_reps.empty())
+        {
+            return nullptr;
+        }
+
+        // Most representations fit here and are copied out into an exactly sized
+        // buffer. When one does not, the encoder has counted the size it needs.
+        uint8_t scratch[INIT_SIZE];
+        size_t size = sizeof(scratch);
+        uint8_t* out = nullptr;
+        EncodeResult err = encodeRepresentations(m_reps, scratch, &size);
+        if (CborNoError == err)
+        {
+            out = static_cast<uint8_t*>(OICMalloc(size));
+            if (!out)
+            {
+                throw std::bad_alloc();
+            }
+            memcpy(out, scratch, size);
+        }
+        else if (CborErrorOutOfMemory == err)
+        {
+            out = static_cast<uint8_t*>(OICMalloc(size));
+            if (!out)
+            {
+                throw std::bad_alloc();
+            }
+            err = encodeRepresentations(m_reps, out, &size);
+        }
+
+        if (CborNoError != err)
+        {
+            OICFree(out);
+            throw OC::OCException("Failed to encode representation in getEncodedPayload");
+        }
+
+        OCEncodedRepPayload* payload = OCEncodedRepPayloadCreateAsOwner(out, size);
+        if (!payload)
+        {
+            OICFree(out);
+            throw std::bad_alloc();
+        }
+        return payload;
+    }
+}
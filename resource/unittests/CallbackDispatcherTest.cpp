@@ -0,0 +1,193 @@
+//******************************************************************
+//
+// Copyright 2017 Samsung Electronics All Rights Reserved.
+//
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
+
+#include <gtest/gtest.h>
+#include <CallbackDispatcher.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+
+namespace OC
+{
+    namespace test
+    {
+        namespace CallbackDispatcherTests
+        {
+            using namespace OC;
+
+            static const int STORM_HANDLES = 20;
+            static const int STORM_RESPONSES = 25;
+
+            // Keys are handles, never dereferenced.
+            static const void* key(int i)
+            {
+                return reinterpret_cast<const void*>(static_cast<uintptr_t>(i + 1));
+            }
+
+            static bool waitFor(std::atomic<int>& count, int expected)
+            {
+                for (int i = 0; i < 10000 && count < expected; i++)
+                {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                }
+                return count == expected;
+            }
+
+            TEST(CallbackDispatcherTest, InlineRunsOnCaller)
+            {
+                CallbackDispatcher::Ptr dispatcher = std::make_shared<CallbackDispatcher>(
+                        CallbackExecution::Inline, 0, nullptr);
+                std::thread::id id;
+                dispatcher->post(key(0), [&id]{ id = std::this_thread::get_id(); });
+                EXPECT_EQ(std::this_thread::get_id(), id);
+            }
+
+            TEST(CallbackDispatcherTest, ThreadPoolKeepsOrderPerHandle)
+            {
+                std::mutex lock;
+                std::vector<int> order[STORM_HANDLES];
+                std::atomic<int> count(0);
+                {
+                    CallbackDispatcher::Ptr dispatcher = std::make_shared<CallbackDispatcher>(
+                            CallbackExecution::ThreadPool, 4, nullptr);
+                    for (int r = 0; r < STORM_RESPONSES; r++)
+                    {
+                        for (int h = 0; h < STORM_HANDLES; h++)
+                        {
+                            dispatcher->post(key(h), [&, h, r]
+                            {
+                                std::lock_guard<std::mutex> guard(lock);
+                                order[h].push_back(r);
+                                count++;
+                            });
+                        }
+                    }
+                    // the destructor runs what is still queued
+                }
+                EXPECT_EQ(STORM_HANDLES * STORM_RESPONSES, count);
+                for (int h = 0; h < STORM_HANDLES; h++)
+                {
+                    ASSERT_EQ(static_cast<size_t>(STORM_RESPONSES), order[h].size());
+                    for (int r = 0; r < STORM_RESPONSES; r++)
+                    {
+                        EXPECT_EQ(r, order[h][r]);
+                    }
+                }
+            }
+
+            TEST(CallbackDispatcherTest, CustomExecutorRunsTasks)
+            {
+                std::atomic<int> submitted(0);
+                std::atomic<int> count(0);
+                CallbackExecutor executor = [&submitted](std::function<void()> task)
+                {
+                    submitted++;
+                    std::thread(task).detach();
+                };
+                CallbackDispatcher::Ptr dispatcher = std::make_shared<CallbackDispatcher>(
+                        CallbackExecution::Custom, 0, executor);
+                for (int i = 0; i < 10; i++)
+                {
+                    dispatcher->post(key(0), [&count]{ count++; });
+                }
+                EXPECT_TRUE(waitFor(count, 10));
+                EXPECT_EQ(10, submitted);
+            }
+
+            TEST(CallbackDispatcherTest, CallbackExceptionIsContained)
+            {
+                std::atomic<int> count(0);
+                CallbackDispatcher::Ptr dispatcher = std::make_shared<CallbackDispatcher>(
+                        CallbackExecution::ThreadPool, 1, nullptr);
+                dispatcher->post(key(0), []{ throw std::runtime_error("callback"); });
+                dispatcher->post(key(0), [&count]{ count++; });
+                EXPECT_TRUE(waitFor(count, 1));
+            }
+
+            TEST(CallbackDispatcherTest, CallbackDropsLastReference)
+            {
+                std::atomic<int> count(0);
+                std::atomic<bool> released(false);
+                CallbackDispatcher::Ptr dispatcher = std::make_shared<CallbackDispatcher>(
+                        CallbackExecution::ThreadPool, 1, nullptr);
+                // the callback context holds the only reference left, as the contexts of
+                // InProcClientWrapper do once the client is gone
+                auto context = std::make_shared<CallbackDispatcher::Ptr>(dispatcher);
+                dispatcher.reset();
+                (*context)->post(key(0), [&, context]() mutable
+                {
+                    while (!released)
+                    {
+                        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                    }
+                    context->reset();
+                    count++;
+                });
+                context.reset();
+                released = true;
+                EXPECT_TRUE(waitFor(count, 1));
+            }
+
+            // Discovery storm: responses of STORM_HANDLES multicast discoveries, each callback
+            // doing a little work. Prints callbacks per second and the most callbacks that
+            // ran at once, which is the number of callback threads alive at that point.
+            static void storm(CallbackExecution execution, const char* name)
+            {
+                std::atomic<int> count(0);
+                std::atomic<int> running(0);
+                std::atomic<int> peak(0);
+                auto beg = std::chrono::steady_clock::now();
+                {
+                    CallbackDispatcher::Ptr dispatcher = std::make_shared<CallbackDispatcher>(
+                            execution, 4, nullptr);
+                    for (int r = 0; r < STORM_RESPONSES; r++)
+                    {
+                        for (int h = 0; h < STORM_HANDLES; h++)
+                        {
+                            dispatcher->post(key(h), [&]
+                            {
+                                int now = ++running;
+                                int seen = peak;
+                                while (now > seen && !peak.compare_exchange_weak(seen, now))
+                                {
+                                }
+                                std::this_thread::sleep_for(std::chrono::microseconds(200));
+                                --running;
+                                count++;
+                            });
+                        }
+                    }
+                    EXPECT_TRUE(waitFor(count, STORM_HANDLES * STORM_RESPONSES));
+                }
+                auto us = std::chrono::duration_cast<std::chrono::microseconds>(
+                        std::chrono::steady_clock::now() - beg).count();
+                printf("%s: %d callbacks/s, at most %d at once\n", name,
+                       static_cast<int>(1000000LL * count / (us ? us : 1)), peak.load());
+            }
+
+            TEST(CallbackDispatcherTest, DiscoveryStorm)
+            {
+                storm(CallbackExecution::NewThread, "thread per callback");
+                storm(CallbackExecution::ThreadPool, "pool of 4 threads");
+            }
+        }
+    }
+}
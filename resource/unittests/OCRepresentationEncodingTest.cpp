@@ -19,6 +19,8 @@
 //-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=-=
 
 #include <gtest/gtest.h>
+#include <chrono>
+#include <cstdio>
 #include <OCApi.h>
 #include <OCRepresentation.h>
 #include <octypes.h>
@@ -1638,4 +1640,227 @@ namespace OCRepresentationEncodingTest
         OCRepPayloadDestroy(repPayload);
         OCPayloadDestroy(cparsed);
     }
+
+    // Representation with nested objects and arrays of every kind, as a collection
+    static OC::OCRepresentation directCborRep()
+    {
+        OC::OCRepresentation inner;
+        inner.setValue("int", 5);
+        inner.setValue("str", std::string("inner"));
+        inner.setValue("dbls", std::vector<double>{1.5, -2.25, 1e100});
+
+        OC::OCRepresentation rep;
+        rep.setUri("/a/direct");
+        rep.setResourceTypes({"core.direct", "core.light"});
+        rep.setResourceInterfaces({"oic.if.baseline"});
+        rep.setNULL("null");
+        rep.setValue("int", -300000);
+        rep.setValue("double", 0.1);
+        rep.setValue("bool", true);
+        rep.setValue("string", std::string("value"));
+        rep.setValue("binary", std::vector<uint8_t>{0, 1, 2, 255});
+        // OCByteString does not own its bytes
+        static uint8_t bytes[] = {0xde, 0xad, 0xbe, 0xef};
+        rep.setValue("bytes", OCByteString{bytes, sizeof(bytes)});
+        rep.setValue("object", inner);
+        rep.setValue("ints", std::vector<int>{1, 24, 256, 65536});
+        rep.setValue("ragged", std::vector<std::vector<int>>{{1, 2, 3}, {4}});
+        rep.setValue("cube", std::vector<std::vector<std::vector<bool>>>{{{true}, {false, true}}});
+        rep.setValue("strs", std::vector<std::vector<std::string>>{{"a", "b"}, {"c"}});
+        rep.setValue("objs", std::vector<OC::OCRepresentation>{inner, inner});
+
+        OC::OCRepresentation child;
+        child.setUri("/a/direct/child");
+        child.setValue("level", 10);
+        rep.addChild(child);
+        return rep;
+    }
+
+    static OC::MessageContainer directCborContainer(const OC::OCRepresentation& rep)
+    {
+        OC::MessageContainer mc;
+        mc.addRepresentation(rep);
+        for (const OC::OCRepresentation& child : rep.getChildren())
+        {
+            mc.addRepresentation(child);
+        }
+        return mc;
+    }
+
+    TEST(DirectCborEncoding, SameBytesAsPayloadPath)
+    {
+        OC::MessageContainer mc = directCborContainer(directCborRep());
+
+        OCRepPayload *repPayload = mc.getPayload();
+        uint8_t *cborData = NULL;
+        size_t cborSize = 0;
+        EXPECT_EQ(OC_STACK_OK, OCConvertPayload((OCPayload*)repPayload, OC_FORMAT_CBOR,
+                    &cborData, &cborSize));
+
+        OCEncodedRepPayload *encoded = mc.getEncodedPayload();
+        ASSERT_NE((decltype(encoded))NULL, encoded);
+        EXPECT_EQ(PAYLOAD_TYPE_ENCODED_REPRESENTATION, encoded->base.type);
+        ASSERT_EQ(cborSize, encoded->cborPayload.len);
+        EXPECT_EQ(0, memcmp(cborData, encoded->cborPayload.bytes, cborSize));
+
+        // the stack sends it unchanged
+        uint8_t *sentData = NULL;
+        size_t sentSize = 0;
+        EXPECT_EQ(OC_STACK_OK, OCConvertPayload((OCPayload*)encoded, OC_FORMAT_CBOR,
+                    &sentData, &sentSize));
+        ASSERT_EQ(cborSize, sentSize);
+        EXPECT_EQ(0, memcmp(cborData, sentData, cborSize));
+
+        OICFree(sentData);
+        OICFree(cborData);
+        OCRepPayloadDestroy(repPayload);
+        OCPayloadDestroy((OCPayload*)encoded);
+    }
+
+    TEST(DirectCborEncoding, RoundTrip)
+    {
+        OC::OCRepresentation rep = directCborRep();
+        OC::MessageContainer mc = directCborContainer(rep);
+
+        // reference: the OCRepPayload path
+        OCRepPayload *repPayload = mc.getPayload();
+        uint8_t *cborData = NULL;
+        size_t cborSize = 0;
+        EXPECT_EQ(OC_STACK_OK, OCConvertPayload((OCPayload*)repPayload, OC_FORMAT_CBOR,
+                    &cborData, &cborSize));
+        OCPayload *cparsed = NULL;
+        EXPECT_EQ(OC_STACK_OK, OCParsePayload(&cparsed, OC_FORMAT_CBOR,
+                    PAYLOAD_TYPE_REPRESENTATION, cborData, cborSize));
+        OC::MessageContainer viaPayload;
+        viaPayload.setPayload(cparsed);
+
+        OCEncodedRepPayload *encoded = OCEncodedRepPayloadCreate(cborData, cborSize);
+        ASSERT_NE((decltype(encoded))NULL, encoded);
+        OC::MessageContainer direct;
+        direct.setPayload((OCPayload*)encoded);
+
+        ASSERT_EQ(2u, direct.representations().size());
+        ASSERT_EQ(viaPayload.representations().size(), direct.representations().size());
+        for (size_t i = 0; i < direct.representations().size(); i++)
+        {
+            EXPECT_TRUE(viaPayload.representations()[i] == direct.representations()[i]);
+        }
+
+        const OC::OCRepresentation& r = direct.representations()[0];
+        EXPECT_EQ("/a/direct", r.getUri());
+        EXPECT_EQ(2u, r.getResourceTypes().size());
+        EXPECT_TRUE(r.isNULL("null"));
+        EXPECT_EQ(-300000, r.getValue<int>("int"));
+        EXPECT_EQ(0.1, r.getValue<double>("double"));
+        EXPECT_EQ("inner", r.getValue<OC::OCRepresentation>("object").getValue<std::string>("str"));
+        std::vector<std::vector<int>> ragged = r.getValue<std::vector<std::vector<int>>>("ragged");
+        EXPECT_EQ((std::vector<std::vector<int>>{{1, 2, 3}, {4, 0, 0}}), ragged);
+        EXPECT_EQ(10, direct.representations()[1].getValue<int>("level"));
+
+        OCPayloadDestroy((OCPayload*)encoded);
+        OICFree(cborData);
+        OCRepPayloadDestroy(repPayload);
+        OCPayloadDestroy(cparsed);
+    }
+
+    TEST(DirectCborEncoding, ByteStringArray)
+    {
+        // not through OCRepPayload, which takes ownership of the bytes of the array
+        static uint8_t bytes[] = {0xde, 0xad, 0xbe, 0xef};
+        std::vector<OCByteString> byteStrs{{bytes, 2}, {bytes, 4}};
+        OC::OCRepresentation rep;
+        rep.setValue("byteStrs", byteStrs);
+        OC::MessageContainer mc;
+        mc.addRepresentation(rep);
+
+        OCEncodedRepPayload *encoded = mc.getEncodedPayload();
+        ASSERT_NE((decltype(encoded))NULL, encoded);
+        OC::MessageContainer direct;
+        direct.setPayload((OCPayload*)encoded);
+        ASSERT_EQ(1u, direct.representations().size());
+        std::vector<OCByteString> decoded =
+            direct.representations()[0].getValue<std::vector<OCByteString>>("byteStrs");
+        EXPECT_EQ(byteStrs, decoded);
+
+        OCPayloadDestroy((OCPayload*)encoded);
+    }
+
+    TEST(DirectCborEncoding, MalformedThrows)
+    {
+        uint8_t garbage[] = {0xbf, 0x63, 'a', 'b', 'c', 0xfa, 0, 0, 0, 0, 0xff};
+        OCEncodedRepPayload *encoded = OCEncodedRepPayloadCreate(garbage, sizeof(garbage));
+        OC::MessageContainer mc;
+        EXPECT_THROW(mc.setPayload((OCPayload*)encoded), OC::OCException);
+        EXPECT_TRUE(mc.representations().empty());
+        OCPayloadDestroy((OCPayload*)encoded);
+    }
+
+    // Round trips of a representation through CBOR, over the OCRepPayload and directly,
+    // as done by the client and server wrappers. Prints the time per round trip.
+    static void directCborBenchmark(const OC::MessageContainer& mc, const char* name)
+    {
+        const int rounds = 2000;
+
+        auto beg = std::chrono::steady_clock::now();
+        for (int i = 0; i < rounds; i++)
+        {
+            OCRepPayload *repPayload = mc.getPayload();
+            uint8_t *cborData = NULL;
+            size_t cborSize = 0;
+            OCConvertPayload((OCPayload*)repPayload, OC_FORMAT_CBOR, &cborData, &cborSize);
+            OCPayload *cparsed = NULL;
+            OCParsePayload(&cparsed, OC_FORMAT_CBOR, PAYLOAD_TYPE_REPRESENTATION,
+                    cborData, cborSize);
+            OC::MessageContainer out;
+            out.setPayload(cparsed);
+            OCPayloadDestroy(cparsed);
+            OICFree(cborData);
+            OCRepPayloadDestroy(repPayload);
+        }
+        auto viaPayload = std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - beg).count();
+
+        beg = std::chrono::steady_clock::now();
+        for (int i = 0; i < rounds; i++)
+        {
+            OCEncodedRepPayload *encoded = mc.getEncodedPayload();
+            uint8_t *cborData = NULL;
+            size_t cborSize = 0;
+            OCConvertPayload((OCPayload*)encoded, OC_FORMAT_CBOR, &cborData, &cborSize);
+            OCEncodedRepPayload *received = OCEncodedRepPayloadCreateAsOwner(cborData, cborSize);
+            OC::MessageContainer out;
+            out.setPayload((OCPayload*)received);
+            OCPayloadDestroy((OCPayload*)received);
+            OCPayloadDestroy((OCPayload*)encoded);
+        }
+        auto direct = std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - beg).count();
+
+        printf("%s: %.2f us per round trip over OCRepPayload, %.2f us direct\n", name,
+               (double)viaPayload / rounds, (double)direct / rounds);
+    }
+
+    TEST(DirectCborEncoding, Benchmark)
+    {
+        OC::OCRepresentation nested;
+        nested.setValue("leaf", std::string("leaf"));
+        for (int depth = 0; depth < 8; depth++)
+        {
+            OC::OCRepresentation parent;
+            parent.setValue("depth", depth);
+            parent.setValue("name", std::string("level"));
+            parent.setValue("next", nested);
+            nested = parent;
+        }
+        directCborBenchmark(directCborContainer(nested), "nested");
+
+        OC::OCRepresentation arrays;
+        std::vector<std::vector<double>> matrix(32, std::vector<double>(32, 0.5));
+        arrays.setValue("matrix", matrix);
+        arrays.setValue("ints", std::vector<int>(256, 7));
+        arrays.setValue("strs", std::vector<std::string>(64, "element"));
+        directCborBenchmark(directCborContainer(arrays), "arrays");
+
+        directCborBenchmark(directCborContainer(directCborRep()), "mixed");
+    }
 }